@@ -1,4 +1,205 @@
 #include "ast.h"
+#include "../lexer/literal.h"
 
-// All node types are defined via plain structs in ast.h.
-// No additional implementation is required.
+// Node types are plain structs defined in ast.h. This file holds the
+// few whole-tree helpers that are not tied to a particular phase.
+
+void AstNodeDeleter::operator()(AstNode* node) const {
+    if (!node) return;
+    switch (node->kind) {
+        case NodeKind::PROGRAM:          delete static_cast<ProgramNode*>(node); return;
+        case NodeKind::FN_DECL:          delete static_cast<FnDeclNode*>(node); return;
+        case NodeKind::BLOCK:            delete static_cast<BlockNode*>(node); return;
+        case NodeKind::LET_STMT:         delete static_cast<LetStmtNode*>(node); return;
+        case NodeKind::RETURN_STMT:      delete static_cast<ReturnStmtNode*>(node); return;
+        case NodeKind::WHILE_STMT:       delete static_cast<WhileStmtNode*>(node); return;
+        case NodeKind::IF_STMT:          delete static_cast<IfStmtNode*>(node); return;
+        case NodeKind::EXPR_STMT:        delete static_cast<ExprStmtNode*>(node); return;
+        case NodeKind::ASSIGN_EXPR:      delete static_cast<AssignExprNode*>(node); return;
+        case NodeKind::BINARY_EXPR:      delete static_cast<BinaryExprNode*>(node); return;
+        case NodeKind::UNARY_EXPR:       delete static_cast<UnaryExprNode*>(node); return;
+        case NodeKind::CALL_EXPR:        delete static_cast<CallExprNode*>(node); return;
+        case NodeKind::IDENT_EXPR:       delete static_cast<IdentExprNode*>(node); return;
+        case NodeKind::NUMBER_LITERAL:   delete static_cast<NumberLiteralNode*>(node); return;
+        case NodeKind::STRING_LITERAL:   delete static_cast<StringLiteralNode*>(node); return;
+        case NodeKind::STRUCT_DECL:      delete static_cast<StructDeclNode*>(node); return;
+        case NodeKind::IMPL_BLOCK:       delete static_cast<ImplBlockNode*>(node); return;
+        case NodeKind::LOOP_STMT:        delete static_cast<LoopStmtNode*>(node); return;
+        case NodeKind::FOR_STMT:         delete static_cast<ForStmtNode*>(node); return;
+        case NodeKind::BREAK_STMT:       delete static_cast<BreakStmtNode*>(node); return;
+        case NodeKind::CONTINUE_STMT:    delete static_cast<ContinueStmtNode*>(node); return;
+        case NodeKind::FIELD_EXPR:       delete static_cast<FieldExprNode*>(node); return;
+        case NodeKind::METHOD_CALL_EXPR: delete static_cast<MethodCallExprNode*>(node); return;
+        case NodeKind::MATCH_EXPR:       delete static_cast<MatchExprNode*>(node); return;
+        case NodeKind::MATCH_ARM:        delete static_cast<MatchArmNode*>(node); return;
+    }
+}
+
+static bool paramsEqual(const std::vector<ParamNode>& a, const std::vector<ParamNode>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].name != b[i].name || a[i].typeName != b[i].typeName || a[i].line != b[i].line) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool listEqual(const std::vector<AstNodePtr>& a, const std::vector<AstNodePtr>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!astEqual(a[i].get(), b[i].get())) return false;
+    }
+    return true;
+}
+
+bool astEqual(const AstNode* a, const AstNode* b) {
+    if (a == b) return true;
+    if (!a || !b) return false;
+    if (a->kind != b->kind || a->line != b->line) return false;
+
+    switch (a->kind) {
+        case NodeKind::PROGRAM: {
+            auto* x = static_cast<const ProgramNode*>(a);
+            auto* y = static_cast<const ProgramNode*>(b);
+            return listEqual(x->statements, y->statements);
+        }
+        case NodeKind::FN_DECL: {
+            auto* x = static_cast<const FnDeclNode*>(a);
+            auto* y = static_cast<const FnDeclNode*>(b);
+            return x->name == y->name && paramsEqual(x->params, y->params) &&
+                   x->returnType == y->returnType && astEqual(x->body.get(), y->body.get());
+        }
+        case NodeKind::BLOCK: {
+            auto* x = static_cast<const BlockNode*>(a);
+            auto* y = static_cast<const BlockNode*>(b);
+            return listEqual(x->statements, y->statements) &&
+                   astEqual(x->value.get(), y->value.get());
+        }
+        case NodeKind::LET_STMT: {
+            auto* x = static_cast<const LetStmtNode*>(a);
+            auto* y = static_cast<const LetStmtNode*>(b);
+            return x->isMut == y->isMut && x->name == y->name &&
+                   x->typeName == y->typeName && astEqual(x->init.get(), y->init.get());
+        }
+        case NodeKind::RETURN_STMT: {
+            auto* x = static_cast<const ReturnStmtNode*>(a);
+            auto* y = static_cast<const ReturnStmtNode*>(b);
+            return astEqual(x->value.get(), y->value.get());
+        }
+        case NodeKind::WHILE_STMT: {
+            auto* x = static_cast<const WhileStmtNode*>(a);
+            auto* y = static_cast<const WhileStmtNode*>(b);
+            return astEqual(x->condition.get(), y->condition.get()) &&
+                   astEqual(x->body.get(), y->body.get());
+        }
+        case NodeKind::IF_STMT: {
+            auto* x = static_cast<const IfStmtNode*>(a);
+            auto* y = static_cast<const IfStmtNode*>(b);
+            return astEqual(x->condition.get(), y->condition.get()) &&
+                   astEqual(x->thenBranch.get(), y->thenBranch.get()) &&
+                   astEqual(x->elseBranch.get(), y->elseBranch.get());
+        }
+        case NodeKind::EXPR_STMT: {
+            auto* x = static_cast<const ExprStmtNode*>(a);
+            auto* y = static_cast<const ExprStmtNode*>(b);
+            return astEqual(x->expr.get(), y->expr.get());
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto* x = static_cast<const AssignExprNode*>(a);
+            auto* y = static_cast<const AssignExprNode*>(b);
+            return x->target == y->target && astEqual(x->value.get(), y->value.get());
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* x = static_cast<const BinaryExprNode*>(a);
+            auto* y = static_cast<const BinaryExprNode*>(b);
+            return x->op == y->op && astEqual(x->left.get(), y->left.get()) &&
+                   astEqual(x->right.get(), y->right.get());
+        }
+        case NodeKind::UNARY_EXPR: {
+            auto* x = static_cast<const UnaryExprNode*>(a);
+            auto* y = static_cast<const UnaryExprNode*>(b);
+            return x->op == y->op && astEqual(x->operand.get(), y->operand.get());
+        }
+        case NodeKind::CALL_EXPR: {
+            auto* x = static_cast<const CallExprNode*>(a);
+            auto* y = static_cast<const CallExprNode*>(b);
+            return x->callee == y->callee && listEqual(x->args, y->args);
+        }
+        case NodeKind::IDENT_EXPR:
+            return static_cast<const IdentExprNode*>(a)->name ==
+                   static_cast<const IdentExprNode*>(b)->name;
+        case NodeKind::NUMBER_LITERAL:
+            return static_cast<const NumberLiteralNode*>(a)->value ==
+                   static_cast<const NumberLiteralNode*>(b)->value;
+        case NodeKind::STRING_LITERAL:
+            return static_cast<const StringLiteralNode*>(a)->value ==
+                   static_cast<const StringLiteralNode*>(b)->value;
+        case NodeKind::STRUCT_DECL: {
+            auto* x = static_cast<const StructDeclNode*>(a);
+            auto* y = static_cast<const StructDeclNode*>(b);
+            return x->name == y->name && paramsEqual(x->fields, y->fields);
+        }
+        case NodeKind::IMPL_BLOCK: {
+            auto* x = static_cast<const ImplBlockNode*>(a);
+            auto* y = static_cast<const ImplBlockNode*>(b);
+            return x->typeName == y->typeName && listEqual(x->methods, y->methods);
+        }
+        case NodeKind::LOOP_STMT:
+            return astEqual(static_cast<const LoopStmtNode*>(a)->body.get(),
+                            static_cast<const LoopStmtNode*>(b)->body.get());
+        case NodeKind::FOR_STMT: {
+            auto* x = static_cast<const ForStmtNode*>(a);
+            auto* y = static_cast<const ForStmtNode*>(b);
+            return x->name == y->name && astEqual(x->iterable.get(), y->iterable.get()) &&
+                   astEqual(x->body.get(), y->body.get());
+        }
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT:
+            return true;
+        case NodeKind::FIELD_EXPR: {
+            auto* x = static_cast<const FieldExprNode*>(a);
+            auto* y = static_cast<const FieldExprNode*>(b);
+            return x->name == y->name && astEqual(x->object.get(), y->object.get());
+        }
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto* x = static_cast<const MethodCallExprNode*>(a);
+            auto* y = static_cast<const MethodCallExprNode*>(b);
+            return x->method == y->method && astEqual(x->receiver.get(), y->receiver.get()) &&
+                   listEqual(x->args, y->args);
+        }
+        case NodeKind::MATCH_EXPR: {
+            auto* x = static_cast<const MatchExprNode*>(a);
+            auto* y = static_cast<const MatchExprNode*>(b);
+            return astEqual(x->scrutinee.get(), y->scrutinee.get()) && listEqual(x->arms, y->arms);
+        }
+        case NodeKind::MATCH_ARM: {
+            auto* x = static_cast<const MatchArmNode*>(a);
+            auto* y = static_cast<const MatchArmNode*>(b);
+            return listEqual(x->patterns, y->patterns) && astEqual(x->body.get(), y->body.get());
+        }
+    }
+    return false;
+}
+
+// The parser writes literals in decimal; constant folding may turn `-5`
+// into the literal "-5".
+int64_t literalValue(const NumberLiteralNode* node) {
+    std::string_view text = node->value;
+    bool negative = !text.empty() && text[0] == '-';
+    uint64_t bits = 0;
+    if (decodeInteger(text.substr(negative ? 1 : 0), bits) != IntegerStatus::OK) bits = 0;
+    return static_cast<int64_t>(negative ? 0 - bits : bits);
+}
+
+bool patternValue(const AstNode* pattern, int64_t& value) {
+    bool negate = false;
+    if (pattern && pattern->kind == NodeKind::UNARY_EXPR) {
+        negate = true;
+        pattern = static_cast<const UnaryExprNode*>(pattern)->operand.get();
+    }
+    if (!pattern || pattern->kind != NodeKind::NUMBER_LITERAL) return false;
+    uint64_t bits = static_cast<uint64_t>(literalValue(static_cast<const NumberLiteralNode*>(pattern)));
+    value = static_cast<int64_t>(negate ? 0 - bits : bits);
+    return true;
+}
@@ -1,6 +1,8 @@
 #ifndef AST_H
 #define AST_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -8,7 +10,7 @@
 // ============================================================
 // NodeKind — one entry per concrete node type
 // ============================================================
-enum class NodeKind {
+enum class NodeKind : uint8_t {
     // Statements
     PROGRAM,
     FN_DECL,
@@ -26,23 +28,52 @@ enum class NodeKind {
     IDENT_EXPR,
     NUMBER_LITERAL,
     STRING_LITERAL,
+    // Later additions go at the end, so the numbers of the kinds above (the
+    // serializer's tags) stay put.
+    STRUCT_DECL,
+    IMPL_BLOCK,
+    LOOP_STMT,
+    FOR_STMT,
+    BREAK_STMT,
+    CONTINUE_STMT,
+    FIELD_EXPR,
+    METHOD_CALL_EXPR,
+    MATCH_EXPR,
+    MATCH_ARM,
 };
 
+static constexpr size_t NODE_KIND_COUNT = static_cast<size_t>(NodeKind::MATCH_ARM) + 1;
+
 // ============================================================
-// Base node — virtual destructor enables polymorphic deletion
+// Base node — no vtable; `kind` says which concrete struct it is
 // ============================================================
 struct AstNode {
     NodeKind kind;
     int line;
 
     explicit AstNode(NodeKind k, int l = 0) : kind(k), line(l) {}
-    virtual ~AstNode() = default;
 
     AstNode(const AstNode&) = delete;
     AstNode& operator=(const AstNode&) = delete;
 };
 
-using AstNodePtr = std::unique_ptr<AstNode>;
+// Deletes through the concrete type named by `kind`. Converts from
+// std::default_delete<T>, so std::make_unique<T>() results still move into
+// an AstNodePtr.
+struct AstNodeDeleter {
+    AstNodeDeleter() = default;
+    template <typename T>
+    AstNodeDeleter(const std::default_delete<T>&) {}
+
+    void operator()(AstNode* node) const;
+};
+
+using AstNodePtr = std::unique_ptr<AstNode, AstNodeDeleter>;
+
+// Nodes that name something carry a `slot`: an index a resolver pass fills
+// in (frame slot, function or constant index — see src/interp/) so later
+// walks need no name lookups. NO_SLOT until resolved; never serialized.
+static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
 
 // ============================================================
 // Statements
@@ -54,26 +85,57 @@ struct ProgramNode : AstNode {
     ProgramNode() : AstNode(NodeKind::PROGRAM) {}
 };
 
-// Parameter within a function declaration
+// <name>: <type> — a function parameter or a struct field. `self`,
+// `&self` and `&mut self` parameters have the type "Self", "&Self" and
+// "&mut Self".
 struct ParamNode {
     std::string name;
     std::string typeName;
     int line = 0;
 };
 
-// fn <name>(<params>) <body>
+// Longest parameter or field list the parser accepts (as in rustc); the
+// compact tree stores the count in 16 bits.
+static constexpr size_t MAX_PARAMS = 65535;
+
+// fn <name>(<params>) (-> <returnType>)? <body>
 struct FnDeclNode : AstNode {
     std::string name;
     std::vector<ParamNode> params;
-    AstNodePtr body;  // BlockNode
+    std::string returnType;  // empty if there is no `->`
+    AstNodePtr body;         // BlockNode
+    // Frame slots for its locals when their slots were all set while
+    // parsing (see src/opt/parse_passes.h); NO_SLOT otherwise.
+    uint32_t frameSlots = NO_SLOT;
 
     FnDeclNode(std::string n, int l = 0)
         : AstNode(NodeKind::FN_DECL, l), name(std::move(n)) {}
 };
 
-// { statement* }
+// struct <name> { <fields> }  or  struct <name>;
+struct StructDeclNode : AstNode {
+    std::string name;
+    std::vector<ParamNode> fields;
+
+    StructDeclNode(std::string n, int l = 0)
+        : AstNode(NodeKind::STRUCT_DECL, l), name(std::move(n)) {}
+};
+
+// impl <typeName> { <methods> }
+struct ImplBlockNode : AstNode {
+    std::string typeName;
+    std::vector<AstNodePtr> methods;  // FnDeclNodes
+
+    ImplBlockNode(std::string t, int l = 0)
+        : AstNode(NodeKind::IMPL_BLOCK, l), typeName(std::move(t)) {}
+};
+
+// { statement* value? } — `value` is a final expression without `;`, and
+// what the block evaluates to; a block without one is unit. A trailing `if`
+// with a value on every branch that finishes, or a trailing `match`, is the value too.
 struct BlockNode : AstNode {
     std::vector<AstNodePtr> statements;
+    AstNodePtr value;  // nullptr if absent
 
     explicit BlockNode(int l = 0) : AstNode(NodeKind::BLOCK, l) {}
 };
@@ -84,6 +146,7 @@ struct LetStmtNode : AstNode {
     std::string name;
     std::string typeName;  // empty if no type annotation
     AstNodePtr init;
+    uint32_t slot = NO_SLOT;
 
     LetStmtNode(bool m, std::string n, int l = 0)
         : AstNode(NodeKind::LET_STMT, l), isMut(m), name(std::move(n)) {}
@@ -104,7 +167,36 @@ struct WhileStmtNode : AstNode {
     explicit WhileStmtNode(int l = 0) : AstNode(NodeKind::WHILE_STMT, l) {}
 };
 
-// if <condition> <thenBranch> (else <elseBranch>)?
+// loop <body>
+struct LoopStmtNode : AstNode {
+    AstNodePtr body;  // BlockNode
+
+    explicit LoopStmtNode(int l = 0) : AstNode(NodeKind::LOOP_STMT, l) {}
+};
+
+// for <name> in <iterable> <body>
+struct ForStmtNode : AstNode {
+    std::string name;
+    AstNodePtr iterable;  // a range (BinaryExprNode "..", "..=") to run at all
+    AstNodePtr body;      // BlockNode
+    uint32_t slot = NO_SLOT;
+
+    ForStmtNode(std::string n, int l = 0)
+        : AstNode(NodeKind::FOR_STMT, l), name(std::move(n)) {}
+};
+
+// break;
+struct BreakStmtNode : AstNode {
+    explicit BreakStmtNode(int l = 0) : AstNode(NodeKind::BREAK_STMT, l) {}
+};
+
+// continue;
+struct ContinueStmtNode : AstNode {
+    explicit ContinueStmtNode(int l = 0) : AstNode(NodeKind::CONTINUE_STMT, l) {}
+};
+
+// if <condition> <thenBranch> (else <elseBranch>)? — a statement, or an
+// expression whose value is that of the branch taken.
 struct IfStmtNode : AstNode {
     AstNodePtr condition;
     AstNodePtr thenBranch;  // BlockNode
@@ -128,12 +220,14 @@ struct ExprStmtNode : AstNode {
 struct AssignExprNode : AstNode {
     std::string target;
     AstNodePtr value;
+    uint32_t slot = NO_SLOT;
 
     AssignExprNode(std::string t, int l = 0)
         : AstNode(NodeKind::ASSIGN_EXPR, l), target(std::move(t)) {}
 };
 
-// <left> <op> <right>  (op: "+", "-", "*", "/", "==", "!=", "<", ">", "<=", ">=")
+// <left> <op> <right>  (op: "+", "-", "*", "/", "==", "!=", "<", ">", "<=", ">=",
+//                       and the ranges "..", "..=")
 struct BinaryExprNode : AstNode {
     std::string op;
     AstNodePtr left;
@@ -143,6 +237,12 @@ struct BinaryExprNode : AstNode {
         : AstNode(NodeKind::BINARY_EXPR, l), op(std::move(o)) {}
 };
 
+// True for `a..b` and `a..=b`, which only a for loop can consume.
+inline bool isRangeExpr(const AstNode* node) {
+    return node && node->kind == NodeKind::BINARY_EXPR &&
+           static_cast<const BinaryExprNode*>(node)->op[0] == '.';
+}
+
 // -<operand>
 struct UnaryExprNode : AstNode {
     std::string op;  // "-"
@@ -156,14 +256,57 @@ struct UnaryExprNode : AstNode {
 struct CallExprNode : AstNode {
     std::string callee;
     std::vector<AstNodePtr> args;
+    uint32_t slot = NO_SLOT;
 
     CallExprNode(std::string c, int l = 0)
         : AstNode(NodeKind::CALL_EXPR, l), callee(std::move(c)) {}
 };
 
+// <receiver>.<method>(<args>)
+struct MethodCallExprNode : AstNode {
+    AstNodePtr receiver;
+    std::string method;
+    std::vector<AstNodePtr> args;
+
+    MethodCallExprNode(std::string m, int l = 0)
+        : AstNode(NodeKind::METHOD_CALL_EXPR, l), method(std::move(m)) {}
+};
+
+// <object>.<name>
+struct FieldExprNode : AstNode {
+    AstNodePtr object;
+    std::string name;
+
+    FieldExprNode(std::string n, int l = 0)
+        : AstNode(NodeKind::FIELD_EXPR, l), name(std::move(n)) {}
+};
+
+// match <scrutinee> { <arms> }
+struct MatchExprNode : AstNode {
+    AstNodePtr scrutinee;
+    std::vector<AstNodePtr> arms;  // MatchArmNodes
+    uint32_t slot = NO_SLOT;       // the interpreter's dispatch table
+
+    explicit MatchExprNode(int l = 0) : AstNode(NodeKind::MATCH_EXPR, l) {}
+};
+
+// <pattern> (| <pattern>)* => <body>, where a pattern is an integer literal,
+// possibly negated; `_` has no patterns and matches anything.
+struct MatchArmNode : AstNode {
+    std::vector<AstNodePtr> patterns;  // NumberLiteralNode or UnaryExprNode "-"
+    AstNodePtr body;
+
+    explicit MatchArmNode(int l = 0) : AstNode(NodeKind::MATCH_ARM, l) {}
+};
+
+// The value of a match pattern, as literalValue(). False if `pattern` is
+// neither form.
+bool patternValue(const AstNode* pattern, int64_t& value);
+
 // bare identifier reference
 struct IdentExprNode : AstNode {
     std::string name;
+    uint32_t slot = NO_SLOT;
 
     IdentExprNode(std::string n, int l = 0)
         : AstNode(NodeKind::IDENT_EXPR, l), name(std::move(n)) {}
@@ -172,17 +315,31 @@ struct IdentExprNode : AstNode {
 // integer literal stored as string; numeric conversion in semantic phase
 struct NumberLiteralNode : AstNode {
     std::string value;
+    uint32_t slot = NO_SLOT;
 
     NumberLiteralNode(std::string v, int l = 0)
         : AstNode(NodeKind::NUMBER_LITERAL, l), value(std::move(v)) {}
 };
 
+// The i64 a literal evaluates to: its decimal text (which the parser has
+// checked fits in 64 bits, and constant folding may write negative) read
+// through decodeInteger() and wrapped, as the arithmetic wraps.
+int64_t literalValue(const NumberLiteralNode* node);
+
 // string literal (contents without surrounding quotes)
 struct StringLiteralNode : AstNode {
     std::string value;
+    uint32_t slot = NO_SLOT;
 
     StringLiteralNode(std::string v, int l = 0)
         : AstNode(NodeKind::STRING_LITERAL, l), value(std::move(v)) {}
 };
 
+// ============================================================
+// Structural comparison
+// ============================================================
+
+// True if both subtrees have the same shape, payloads and line numbers.
+bool astEqual(const AstNode* a, const AstNode* b);
+
 #endif // AST_H
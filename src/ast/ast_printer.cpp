@@ -4,144 +4,194 @@ static void printIndent(std::ostream& out, int indent) {
     for (int i = 0; i < indent; ++i) out << "  ";
 }
 
-static void printNode(const AstNode* node, std::ostream& out, int indent);
-
-static void printNode(const AstNode* node, std::ostream& out, int indent) {
+// Written against the view API (compact_ast.h), so one printer serves
+// both the pointer tree and the CompactAst.
+template <typename Ref>
+static void printNode(Ref node, std::ostream& out, int indent) {
     if (!node) return;
     printIndent(out, indent);
 
-    switch (node->kind) {
-        case NodeKind::PROGRAM: {
-            auto* n = static_cast<const ProgramNode*>(node);
+    switch (node.kind()) {
+        case NodeKind::PROGRAM:
             out << "ProgramNode\n";
-            for (auto& stmt : n->statements)
-                printNode(stmt.get(), out, indent + 1);
+            for (Ref stmt : node.statements())
+                printNode(stmt, out, indent + 1);
             break;
-        }
-        case NodeKind::FN_DECL: {
-            auto* n = static_cast<const FnDeclNode*>(node);
-            out << "FnDeclNode(\"" << n->name << "\", params=[";
-            for (size_t i = 0; i < n->params.size(); ++i) {
+        case NodeKind::FN_DECL:
+            out << "FnDeclNode(\"" << node.name() << "\", params=[";
+            for (size_t i = 0; i < node.paramCount(); ++i) {
+                if (i > 0) out << ", ";
+                ParamView p = node.param(i);
+                out << p.name << ": " << p.typeName;
+            }
+            out << "]";
+            if (!node.returnType().empty()) out << ", returns=" << node.returnType();
+            out << ")\n";
+            printNode(node.body(), out, indent + 1);
+            break;
+        case NodeKind::STRUCT_DECL:
+            out << "StructDeclNode(\"" << node.name() << "\", fields=[";
+            for (size_t i = 0; i < node.fieldCount(); ++i) {
                 if (i > 0) out << ", ";
-                out << n->params[i].name << ": " << n->params[i].typeName;
+                ParamView f = node.field(i);
+                out << f.name << ": " << f.typeName;
             }
             out << "])\n";
-            printNode(n->body.get(), out, indent + 1);
             break;
-        }
-        case NodeKind::BLOCK: {
-            auto* n = static_cast<const BlockNode*>(node);
+        case NodeKind::IMPL_BLOCK:
+            out << "ImplBlockNode(\"" << node.typeName() << "\")\n";
+            for (Ref method : node.methods())
+                printNode(method, out, indent + 1);
+            break;
+        case NodeKind::BLOCK:
             out << "BlockNode\n";
-            for (auto& stmt : n->statements)
-                printNode(stmt.get(), out, indent + 1);
+            for (Ref stmt : node.statements())
+                printNode(stmt, out, indent + 1);
+            if (node.value()) {
+                printIndent(out, indent + 1);
+                out << "value:\n";
+                printNode(node.value(), out, indent + 2);
+            }
             break;
-        }
-        case NodeKind::LET_STMT: {
-            auto* n = static_cast<const LetStmtNode*>(node);
-            out << "LetStmtNode(mut=" << (n->isMut ? "true" : "false")
-                << ", name=\"" << n->name << "\"";
-            if (!n->typeName.empty()) out << ", type=\"" << n->typeName << "\"";
+        case NodeKind::LET_STMT:
+            out << "LetStmtNode(mut=" << (node.isMut() ? "true" : "false")
+                << ", name=\"" << node.name() << "\"";
+            if (!node.typeName().empty()) out << ", type=\"" << node.typeName() << "\"";
             out << ")\n";
-            if (n->init) {
+            if (node.init()) {
                 printIndent(out, indent + 1);
                 out << "init:\n";
-                printNode(n->init.get(), out, indent + 2);
+                printNode(node.init(), out, indent + 2);
             }
             break;
-        }
-        case NodeKind::RETURN_STMT: {
-            auto* n = static_cast<const ReturnStmtNode*>(node);
+        case NodeKind::RETURN_STMT:
             out << "ReturnStmtNode\n";
-            if (n->value) {
+            if (node.value()) {
                 printIndent(out, indent + 1);
                 out << "value:\n";
-                printNode(n->value.get(), out, indent + 2);
+                printNode(node.value(), out, indent + 2);
             }
             break;
-        }
-        case NodeKind::WHILE_STMT: {
-            auto* n = static_cast<const WhileStmtNode*>(node);
+        case NodeKind::WHILE_STMT:
             out << "WhileStmtNode\n";
             printIndent(out, indent + 1);
             out << "condition:\n";
-            printNode(n->condition.get(), out, indent + 2);
+            printNode(node.condition(), out, indent + 2);
             printIndent(out, indent + 1);
             out << "body:\n";
-            printNode(n->body.get(), out, indent + 2);
+            printNode(node.body(), out, indent + 2);
             break;
-        }
-        case NodeKind::IF_STMT: {
-            auto* n = static_cast<const IfStmtNode*>(node);
+        case NodeKind::LOOP_STMT:
+            out << "LoopStmtNode\n";
+            printNode(node.body(), out, indent + 1);
+            break;
+        case NodeKind::FOR_STMT:
+            out << "ForStmtNode(\"" << node.name() << "\")\n";
+            printIndent(out, indent + 1);
+            out << "iterable:\n";
+            printNode(node.iterable(), out, indent + 2);
+            printIndent(out, indent + 1);
+            out << "body:\n";
+            printNode(node.body(), out, indent + 2);
+            break;
+        case NodeKind::BREAK_STMT:
+            out << "BreakStmtNode\n";
+            break;
+        case NodeKind::CONTINUE_STMT:
+            out << "ContinueStmtNode\n";
+            break;
+        case NodeKind::IF_STMT:
             out << "IfStmtNode\n";
             printIndent(out, indent + 1);
             out << "condition:\n";
-            printNode(n->condition.get(), out, indent + 2);
+            printNode(node.condition(), out, indent + 2);
             printIndent(out, indent + 1);
             out << "thenBranch:\n";
-            printNode(n->thenBranch.get(), out, indent + 2);
-            if (n->elseBranch) {
+            printNode(node.thenBranch(), out, indent + 2);
+            if (node.elseBranch()) {
                 printIndent(out, indent + 1);
                 out << "elseBranch:\n";
-                printNode(n->elseBranch.get(), out, indent + 2);
+                printNode(node.elseBranch(), out, indent + 2);
             }
             break;
-        }
-        case NodeKind::EXPR_STMT: {
-            auto* n = static_cast<const ExprStmtNode*>(node);
+        case NodeKind::EXPR_STMT:
             out << "ExprStmtNode\n";
-            printNode(n->expr.get(), out, indent + 1);
+            printNode(node.expr(), out, indent + 1);
             break;
-        }
-        case NodeKind::ASSIGN_EXPR: {
-            auto* n = static_cast<const AssignExprNode*>(node);
-            out << "AssignExpr(target=\"" << n->target << "\")\n";
+        case NodeKind::ASSIGN_EXPR:
+            out << "AssignExpr(target=\"" << node.target() << "\")\n";
             printIndent(out, indent + 1);
             out << "value:\n";
-            printNode(n->value.get(), out, indent + 2);
+            printNode(node.value(), out, indent + 2);
             break;
-        }
-        case NodeKind::BINARY_EXPR: {
-            auto* n = static_cast<const BinaryExprNode*>(node);
-            out << "BinaryExpr(\"" << n->op << "\")\n";
+        case NodeKind::BINARY_EXPR:
+            out << "BinaryExpr(\"" << node.op() << "\")\n";
             printIndent(out, indent + 1);
             out << "left:\n";
-            printNode(n->left.get(), out, indent + 2);
+            printNode(node.left(), out, indent + 2);
             printIndent(out, indent + 1);
             out << "right:\n";
-            printNode(n->right.get(), out, indent + 2);
+            printNode(node.right(), out, indent + 2);
             break;
-        }
-        case NodeKind::UNARY_EXPR: {
-            auto* n = static_cast<const UnaryExprNode*>(node);
-            out << "UnaryExpr(\"" << n->op << "\")\n";
-            printNode(n->operand.get(), out, indent + 1);
+        case NodeKind::UNARY_EXPR:
+            out << "UnaryExpr(\"" << node.op() << "\")\n";
+            printNode(node.operand(), out, indent + 1);
             break;
-        }
-        case NodeKind::CALL_EXPR: {
-            auto* n = static_cast<const CallExprNode*>(node);
-            out << "CallExpr(\"" << n->callee << "\")\n";
-            for (auto& arg : n->args)
-                printNode(arg.get(), out, indent + 1);
+        case NodeKind::CALL_EXPR:
+            out << "CallExpr(\"" << node.callee() << "\")\n";
+            for (Ref arg : node.args())
+                printNode(arg, out, indent + 1);
             break;
-        }
-        case NodeKind::IDENT_EXPR: {
-            auto* n = static_cast<const IdentExprNode*>(node);
-            out << "IdentExpr(\"" << n->name << "\")\n";
+        case NodeKind::METHOD_CALL_EXPR:
+            out << "MethodCallExpr(\"" << node.method() << "\")\n";
+            printIndent(out, indent + 1);
+            out << "receiver:\n";
+            printNode(node.receiver(), out, indent + 2);
+            for (Ref arg : node.args())
+                printNode(arg, out, indent + 1);
             break;
-        }
-        case NodeKind::NUMBER_LITERAL: {
-            auto* n = static_cast<const NumberLiteralNode*>(node);
-            out << "NumberLiteral(" << n->value << ")\n";
+        case NodeKind::MATCH_EXPR:
+            out << "MatchExpr\n";
+            printIndent(out, indent + 1);
+            out << "scrutinee:\n";
+            printNode(node.scrutinee(), out, indent + 2);
+            for (Ref arm : node.arms())
+                printNode(arm, out, indent + 1);
             break;
-        }
-        case NodeKind::STRING_LITERAL: {
-            auto* n = static_cast<const StringLiteralNode*>(node);
-            out << "StringLiteral(\"" << n->value << "\")\n";
+        case NodeKind::MATCH_ARM: {
+            out << "MatchArm(";
+            bool first = true;
+            for (Ref pattern : node.patterns()) {
+                if (!first) out << " | ";
+                first = false;
+                if (pattern.kind() == NodeKind::UNARY_EXPR) out << "-" << pattern.operand().literal();
+                else out << pattern.literal();
+            }
+            if (first) out << "_";
+            out << ")\n";
+            printNode(node.body(), out, indent + 1);
             break;
         }
+        case NodeKind::FIELD_EXPR:
+            out << "FieldExpr(\"" << node.name() << "\")\n";
+            printNode(node.object(), out, indent + 1);
+            break;
+        case NodeKind::IDENT_EXPR:
+            out << "IdentExpr(\"" << node.name() << "\")\n";
+            break;
+        case NodeKind::NUMBER_LITERAL:
+            out << "NumberLiteral(" << node.literal() << ")\n";
+            break;
+        case NodeKind::STRING_LITERAL:
+            out << "StringLiteral(\"" << node.literal() << "\")\n";
+            break;
     }
 }
 
 void printAst(const AstNode* node, std::ostream& out, int indent) {
-    printNode(node, out, indent);
+    printNode(AstRef(node), out, indent);
+}
+
+void printAst(const CompactAst& ast, std::ostream& out, int indent) {
+    printNode(ast.root(), out, indent);
 }
@@ -2,9 +2,11 @@
 #define AST_PRINTER_H
 
 #include "ast.h"
+#include "compact_ast.h"
 #include <iostream>
 #include <string>
 
 void printAst(const AstNode* node, std::ostream& out = std::cout, int indent = 0);
+void printAst(const CompactAst& ast, std::ostream& out = std::cout, int indent = 0);
 
 #endif // AST_PRINTER_H
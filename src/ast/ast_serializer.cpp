@@ -0,0 +1,395 @@
+#include "ast_serializer.h"
+
+static const unsigned char NULL_NODE = 0xFF;
+
+// ============================================================
+// Encoding
+// ============================================================
+
+static void writeVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+static void writeString(std::string& out, const std::string& s) {
+    writeVarint(out, s.size());
+    out.append(s);
+}
+
+static void writeParams(std::string& out, const std::vector<ParamNode>& params) {
+    writeVarint(out, params.size());
+    for (auto& p : params) {
+        writeString(out, p.name);
+        writeString(out, p.typeName);
+        writeVarint(out, static_cast<uint32_t>(p.line));
+    }
+}
+
+static void writeList(std::string& out, const std::vector<AstNodePtr>& nodes) {
+    writeVarint(out, nodes.size());
+    for (auto& n : nodes) serializeAst(n.get(), out);
+}
+
+void serializeAst(const AstNode* node, std::string& out) {
+    if (!node) {
+        out.push_back(static_cast<char>(NULL_NODE));
+        return;
+    }
+    out.push_back(static_cast<char>(node->kind));
+    writeVarint(out, static_cast<uint32_t>(node->line));
+
+    switch (node->kind) {
+        case NodeKind::PROGRAM:
+            writeList(out, static_cast<const ProgramNode*>(node)->statements);
+            break;
+        case NodeKind::FN_DECL: {
+            auto* n = static_cast<const FnDeclNode*>(node);
+            writeString(out, n->name);
+            writeParams(out, n->params);
+            writeString(out, n->returnType);
+            serializeAst(n->body.get(), out);
+            break;
+        }
+        case NodeKind::BLOCK: {
+            auto* n = static_cast<const BlockNode*>(node);
+            writeList(out, n->statements);
+            serializeAst(n->value.get(), out);
+            break;
+        }
+        case NodeKind::LET_STMT: {
+            auto* n = static_cast<const LetStmtNode*>(node);
+            out.push_back(n->isMut ? 1 : 0);
+            writeString(out, n->name);
+            writeString(out, n->typeName);
+            serializeAst(n->init.get(), out);
+            break;
+        }
+        case NodeKind::RETURN_STMT:
+            serializeAst(static_cast<const ReturnStmtNode*>(node)->value.get(), out);
+            break;
+        case NodeKind::WHILE_STMT: {
+            auto* n = static_cast<const WhileStmtNode*>(node);
+            serializeAst(n->condition.get(), out);
+            serializeAst(n->body.get(), out);
+            break;
+        }
+        case NodeKind::IF_STMT: {
+            auto* n = static_cast<const IfStmtNode*>(node);
+            serializeAst(n->condition.get(), out);
+            serializeAst(n->thenBranch.get(), out);
+            serializeAst(n->elseBranch.get(), out);
+            break;
+        }
+        case NodeKind::EXPR_STMT:
+            serializeAst(static_cast<const ExprStmtNode*>(node)->expr.get(), out);
+            break;
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<const AssignExprNode*>(node);
+            writeString(out, n->target);
+            serializeAst(n->value.get(), out);
+            break;
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<const BinaryExprNode*>(node);
+            writeString(out, n->op);
+            serializeAst(n->left.get(), out);
+            serializeAst(n->right.get(), out);
+            break;
+        }
+        case NodeKind::UNARY_EXPR: {
+            auto* n = static_cast<const UnaryExprNode*>(node);
+            writeString(out, n->op);
+            serializeAst(n->operand.get(), out);
+            break;
+        }
+        case NodeKind::CALL_EXPR: {
+            auto* n = static_cast<const CallExprNode*>(node);
+            writeString(out, n->callee);
+            writeList(out, n->args);
+            break;
+        }
+        case NodeKind::IDENT_EXPR:
+            writeString(out, static_cast<const IdentExprNode*>(node)->name);
+            break;
+        case NodeKind::NUMBER_LITERAL:
+            writeString(out, static_cast<const NumberLiteralNode*>(node)->value);
+            break;
+        case NodeKind::STRING_LITERAL:
+            writeString(out, static_cast<const StringLiteralNode*>(node)->value);
+            break;
+        case NodeKind::STRUCT_DECL: {
+            auto* n = static_cast<const StructDeclNode*>(node);
+            writeString(out, n->name);
+            writeParams(out, n->fields);
+            break;
+        }
+        case NodeKind::IMPL_BLOCK: {
+            auto* n = static_cast<const ImplBlockNode*>(node);
+            writeString(out, n->typeName);
+            writeList(out, n->methods);
+            break;
+        }
+        case NodeKind::LOOP_STMT:
+            serializeAst(static_cast<const LoopStmtNode*>(node)->body.get(), out);
+            break;
+        case NodeKind::FOR_STMT: {
+            auto* n = static_cast<const ForStmtNode*>(node);
+            writeString(out, n->name);
+            serializeAst(n->iterable.get(), out);
+            serializeAst(n->body.get(), out);
+            break;
+        }
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT:
+            break;
+        case NodeKind::FIELD_EXPR: {
+            auto* n = static_cast<const FieldExprNode*>(node);
+            writeString(out, n->name);
+            serializeAst(n->object.get(), out);
+            break;
+        }
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto* n = static_cast<const MethodCallExprNode*>(node);
+            writeString(out, n->method);
+            serializeAst(n->receiver.get(), out);
+            writeList(out, n->args);
+            break;
+        }
+        case NodeKind::MATCH_EXPR: {
+            auto* n = static_cast<const MatchExprNode*>(node);
+            serializeAst(n->scrutinee.get(), out);
+            writeList(out, n->arms);
+            break;
+        }
+        case NodeKind::MATCH_ARM: {
+            auto* n = static_cast<const MatchArmNode*>(node);
+            writeList(out, n->patterns);
+            serializeAst(n->body.get(), out);
+            break;
+        }
+    }
+}
+
+// ============================================================
+// Decoding
+// ============================================================
+
+namespace {
+
+struct Reader {
+    const std::string& data;
+    size_t& pos;
+    bool& ok;
+
+    unsigned char byte() {
+        if (pos >= data.size()) {
+            ok = false;
+            return NULL_NODE;
+        }
+        return static_cast<unsigned char>(data[pos++]);
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64 && ok; shift += 7) {
+            unsigned char b = byte();
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::string string() {
+        uint64_t len = varint();
+        if (!ok || len > data.size() - pos) {
+            ok = false;
+            return std::string();
+        }
+        std::string s = data.substr(pos, len);
+        pos += len;
+        return s;
+    }
+
+    void params(std::vector<ParamNode>& out) {
+        uint64_t count = varint();
+        if (!ok || count > data.size() - pos) {
+            ok = false;
+            return;
+        }
+        for (uint64_t i = 0; i < count && ok; ++i) {
+            ParamNode p;
+            p.name = string();
+            p.typeName = string();
+            p.line = static_cast<int>(varint());
+            out.push_back(std::move(p));
+        }
+    }
+
+    void list(std::vector<AstNodePtr>& nodes) {
+        uint64_t count = varint();
+        // Every node takes at least one byte, which bounds a corrupt count.
+        if (!ok || count > data.size() - pos) {
+            ok = false;
+            return;
+        }
+        nodes.reserve(count);
+        for (uint64_t i = 0; i < count && ok; ++i) {
+            nodes.push_back(node());
+        }
+    }
+
+    AstNodePtr node();
+};
+
+AstNodePtr Reader::node() {
+    unsigned char tag = byte();
+    if (!ok || tag == NULL_NODE) return nullptr;
+    if (tag >= NODE_KIND_COUNT) {
+        ok = false;
+        return nullptr;
+    }
+    int line = static_cast<int>(varint());
+
+    switch (static_cast<NodeKind>(tag)) {
+        case NodeKind::PROGRAM: {
+            auto n = std::make_unique<ProgramNode>();
+            n->line = line;
+            list(n->statements);
+            return n;
+        }
+        case NodeKind::FN_DECL: {
+            auto n = std::make_unique<FnDeclNode>(string(), line);
+            params(n->params);
+            n->returnType = string();
+            n->body = node();
+            return n;
+        }
+        case NodeKind::BLOCK: {
+            auto n = std::make_unique<BlockNode>(line);
+            list(n->statements);
+            n->value = node();
+            return n;
+        }
+        case NodeKind::LET_STMT: {
+            bool isMut = byte() != 0;
+            auto n = std::make_unique<LetStmtNode>(isMut, string(), line);
+            n->typeName = string();
+            n->init = node();
+            return n;
+        }
+        case NodeKind::RETURN_STMT: {
+            auto n = std::make_unique<ReturnStmtNode>(line);
+            n->value = node();
+            return n;
+        }
+        case NodeKind::WHILE_STMT: {
+            auto n = std::make_unique<WhileStmtNode>(line);
+            n->condition = node();
+            n->body = node();
+            return n;
+        }
+        case NodeKind::IF_STMT: {
+            auto n = std::make_unique<IfStmtNode>(line);
+            n->condition = node();
+            n->thenBranch = node();
+            n->elseBranch = node();
+            return n;
+        }
+        case NodeKind::EXPR_STMT: {
+            auto n = std::make_unique<ExprStmtNode>(line);
+            n->expr = node();
+            return n;
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto n = std::make_unique<AssignExprNode>(string(), line);
+            n->value = node();
+            return n;
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto n = std::make_unique<BinaryExprNode>(string(), line);
+            n->left = node();
+            n->right = node();
+            return n;
+        }
+        case NodeKind::UNARY_EXPR: {
+            auto n = std::make_unique<UnaryExprNode>(string(), line);
+            n->operand = node();
+            return n;
+        }
+        case NodeKind::CALL_EXPR: {
+            auto n = std::make_unique<CallExprNode>(string(), line);
+            list(n->args);
+            return n;
+        }
+        case NodeKind::IDENT_EXPR:
+            return std::make_unique<IdentExprNode>(string(), line);
+        case NodeKind::NUMBER_LITERAL:
+            return std::make_unique<NumberLiteralNode>(string(), line);
+        case NodeKind::STRING_LITERAL:
+            return std::make_unique<StringLiteralNode>(string(), line);
+        case NodeKind::STRUCT_DECL: {
+            auto n = std::make_unique<StructDeclNode>(string(), line);
+            params(n->fields);
+            return n;
+        }
+        case NodeKind::IMPL_BLOCK: {
+            auto n = std::make_unique<ImplBlockNode>(string(), line);
+            list(n->methods);
+            return n;
+        }
+        case NodeKind::LOOP_STMT: {
+            auto n = std::make_unique<LoopStmtNode>(line);
+            n->body = node();
+            return n;
+        }
+        case NodeKind::FOR_STMT: {
+            auto n = std::make_unique<ForStmtNode>(string(), line);
+            n->iterable = node();
+            n->body = node();
+            return n;
+        }
+        case NodeKind::BREAK_STMT:
+            return std::make_unique<BreakStmtNode>(line);
+        case NodeKind::CONTINUE_STMT:
+            return std::make_unique<ContinueStmtNode>(line);
+        case NodeKind::FIELD_EXPR: {
+            auto n = std::make_unique<FieldExprNode>(string(), line);
+            n->object = node();
+            return n;
+        }
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto n = std::make_unique<MethodCallExprNode>(string(), line);
+            n->receiver = node();
+            list(n->args);
+            return n;
+        }
+        case NodeKind::MATCH_EXPR: {
+            auto n = std::make_unique<MatchExprNode>(line);
+            n->scrutinee = node();
+            list(n->arms);
+            return n;
+        }
+        case NodeKind::MATCH_ARM: {
+            auto n = std::make_unique<MatchArmNode>(line);
+            list(n->patterns);
+            n->body = node();
+            return n;
+        }
+    }
+    ok = false;
+    return nullptr;
+}
+
+} // namespace
+
+AstNodePtr deserializeAst(const std::string& data, size_t& pos, bool& ok) {
+    ok = true;
+    Reader reader{data, pos, ok};
+    AstNodePtr node = reader.node();
+    if (!ok) return nullptr;
+    return node;
+}
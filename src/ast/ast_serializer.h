@@ -0,0 +1,18 @@
+#ifndef AST_SERIALIZER_H
+#define AST_SERIALIZER_H
+
+#include "ast.h"
+#include <string>
+
+// Compact binary encoding of an AST subtree, used by the parse cache.
+// Layout: one kind byte per node (0xFF for an absent child), varint line,
+// then the node's payload strings and children in declaration order.
+
+// Appends the encoding of `node` (may be null) to `out`.
+void serializeAst(const AstNode* node, std::string& out);
+
+// Decodes one subtree starting at `pos`, advancing `pos` past it.
+// Sets `ok` to false (and returns nullptr) on truncated or malformed input.
+AstNodePtr deserializeAst(const std::string& data, size_t& pos, bool& ok);
+
+#endif // AST_SERIALIZER_H
@@ -1,4 +1,11 @@
 #include "ast.h"
+#include "ast_printer.h"
+#include "ast_serializer.h"
+#include "ast_visitor.h"
+#include "compact_ast.h"
+#include <cstdint>
+#include <sstream>
+#include <type_traits>
 #include <gtest/gtest.h>
 
 // ============================================================
@@ -126,6 +133,11 @@ TEST(Ast, FnDeclHasParams) {
     EXPECT_EQ(fn.params[1].typeName, "i32");
 }
 
+TEST(Ast, NodesHaveNoVtable) {
+    EXPECT_FALSE(std::is_polymorphic<AstNode>::value);
+    EXPECT_EQ(sizeof(AstNode), 8u);
+}
+
 TEST(Ast, DowncastViaKind) {
     AstNodePtr node = std::make_unique<NumberLiteralNode>("99", 5);
     EXPECT_EQ(node->kind, NodeKind::NUMBER_LITERAL);
@@ -133,3 +145,577 @@ TEST(Ast, DowncastViaKind) {
     EXPECT_EQ(numNode->value, "99");
     EXPECT_EQ(numNode->line, 5);
 }
+
+// ============================================================
+// Structural equality and serialization
+// ============================================================
+
+static std::unique_ptr<ProgramNode> sampleTree() {
+    auto prog = std::make_unique<ProgramNode>();
+    auto fn = std::make_unique<FnDeclNode>("add", 1);
+    fn->params.push_back(ParamNode{"a", "i32", 1});
+    auto body = std::make_unique<BlockNode>(1);
+    auto ret = std::make_unique<ReturnStmtNode>(2);
+    auto bin = std::make_unique<BinaryExprNode>("+", 2);
+    bin->left = std::make_unique<IdentExprNode>("a", 2);
+    bin->right = std::make_unique<NumberLiteralNode>("1", 2);
+    ret->value = std::move(bin);
+    body->statements.push_back(std::move(ret));
+    fn->body = std::move(body);
+    prog->statements.push_back(std::move(fn));
+    return prog;
+}
+
+TEST(Ast, EqualTreesCompareEqual) {
+    auto a = sampleTree();
+    auto b = sampleTree();
+    EXPECT_TRUE(astEqual(a.get(), b.get()));
+
+    auto* ret = static_cast<ReturnStmtNode*>(
+        static_cast<BlockNode*>(static_cast<FnDeclNode*>(b->statements[0].get())->body.get())
+            ->statements[0].get());
+    ret->line = 3;
+    EXPECT_FALSE(astEqual(a.get(), b.get()));
+}
+
+TEST(Ast, SerializeRoundTrip) {
+    auto prog = sampleTree();
+    std::string bytes;
+    serializeAst(prog.get(), bytes);
+
+    size_t pos = 0;
+    bool ok = false;
+    AstNodePtr decoded = deserializeAst(bytes, pos, ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(pos, bytes.size());
+    EXPECT_TRUE(astEqual(prog.get(), decoded.get()));
+}
+
+// struct P { x: i64, y: &str }
+// impl P { fn get(&self) -> i64 { for i in 0..=3 { loop { break; } continue; }
+//                                  return self.x.min(1); } }
+static std::unique_ptr<ProgramNode> itemsTree() {
+    auto prog = std::make_unique<ProgramNode>();
+    auto st = std::make_unique<StructDeclNode>("P", 1);
+    st->fields.push_back(ParamNode{"x", "i64", 1});
+    st->fields.push_back(ParamNode{"y", "&str", 1});
+    prog->statements.push_back(std::move(st));
+
+    auto impl = std::make_unique<ImplBlockNode>("P", 2);
+    auto fn = std::make_unique<FnDeclNode>("get", 2);
+    fn->params.push_back(ParamNode{"self", "&Self", 2});
+    fn->returnType = "i64";
+    auto body = std::make_unique<BlockNode>(2);
+
+    auto loop = std::make_unique<ForStmtNode>("i", 3);
+    auto range = std::make_unique<BinaryExprNode>("..=", 3);
+    range->left = std::make_unique<NumberLiteralNode>("0", 3);
+    range->right = std::make_unique<NumberLiteralNode>("3", 3);
+    loop->iterable = std::move(range);
+    auto loopBody = std::make_unique<BlockNode>(3);
+    auto inner = std::make_unique<LoopStmtNode>(4);
+    auto innerBody = std::make_unique<BlockNode>(4);
+    innerBody->statements.push_back(std::make_unique<BreakStmtNode>(4));
+    inner->body = std::move(innerBody);
+    loopBody->statements.push_back(std::move(inner));
+    loopBody->statements.push_back(std::make_unique<ContinueStmtNode>(5));
+    loop->body = std::move(loopBody);
+    body->statements.push_back(std::move(loop));
+
+    auto ret = std::make_unique<ReturnStmtNode>(6);
+    auto call = std::make_unique<MethodCallExprNode>("min", 6);
+    auto field = std::make_unique<FieldExprNode>("x", 6);
+    field->object = std::make_unique<IdentExprNode>("self", 6);
+    call->receiver = std::move(field);
+    call->args.push_back(std::make_unique<NumberLiteralNode>("1", 6));
+    ret->value = std::move(call);
+    body->statements.push_back(std::move(ret));
+
+    fn->body = std::move(body);
+    impl->methods.push_back(std::move(fn));
+    prog->statements.push_back(std::move(impl));
+    return prog;
+}
+
+TEST(Ast, ItemsSerializeRoundTrip) {
+    auto prog = itemsTree();
+    std::string bytes;
+    serializeAst(prog.get(), bytes);
+
+    size_t pos = 0;
+    bool ok = false;
+    AstNodePtr decoded = deserializeAst(bytes, pos, ok);
+    ASSERT_TRUE(ok);
+    EXPECT_TRUE(astEqual(prog.get(), decoded.get()));
+
+    // The return type takes part in equality.
+    auto other = itemsTree();
+    auto* impl = static_cast<ImplBlockNode*>(other->statements[1].get());
+    static_cast<FnDeclNode*>(impl->methods[0].get())->returnType = "i32";
+    EXPECT_FALSE(astEqual(prog.get(), other.get()));
+}
+
+// fn f(x) { let y = 1; match x { 1 | -2 => { y } _ => 0 } }
+static std::unique_ptr<ProgramNode> matchTree() {
+    auto prog = std::make_unique<ProgramNode>();
+    auto fn = std::make_unique<FnDeclNode>("f", 1);
+    fn->params.push_back(ParamNode{"x", "", 1});
+    auto body = std::make_unique<BlockNode>(1);
+    auto let = std::make_unique<LetStmtNode>(false, "y", 1);
+    let->init = std::make_unique<NumberLiteralNode>("1", 1);
+    body->statements.push_back(std::move(let));
+
+    auto match = std::make_unique<MatchExprNode>(2);
+    match->scrutinee = std::make_unique<IdentExprNode>("x", 2);
+    auto arm = std::make_unique<MatchArmNode>(3);
+    arm->patterns.push_back(std::make_unique<NumberLiteralNode>("1", 3));
+    auto negative = std::make_unique<UnaryExprNode>("-", 3);
+    negative->operand = std::make_unique<NumberLiteralNode>("2", 3);
+    arm->patterns.push_back(std::move(negative));
+    auto armBody = std::make_unique<BlockNode>(3);
+    armBody->value = std::make_unique<IdentExprNode>("y", 3);
+    arm->body = std::move(armBody);
+    match->arms.push_back(std::move(arm));
+    auto wildcard = std::make_unique<MatchArmNode>(4);
+    wildcard->body = std::make_unique<NumberLiteralNode>("0", 4);
+    match->arms.push_back(std::move(wildcard));
+    body->value = std::move(match);
+
+    fn->body = std::move(body);
+    prog->statements.push_back(std::move(fn));
+    return prog;
+}
+
+TEST(Ast, MatchSerializeRoundTrip) {
+    auto prog = matchTree();
+    std::string bytes;
+    serializeAst(prog.get(), bytes);
+
+    size_t pos = 0;
+    bool ok = false;
+    AstNodePtr decoded = deserializeAst(bytes, pos, ok);
+    ASSERT_TRUE(ok);
+    EXPECT_TRUE(astEqual(prog.get(), decoded.get()));
+
+    // Patterns and block values take part in equality.
+    auto other = matchTree();
+    auto* fn = static_cast<FnDeclNode*>(other->statements[0].get());
+    auto* body = static_cast<BlockNode*>(fn->body.get());
+    auto* match = static_cast<MatchExprNode*>(body->value.get());
+    static_cast<MatchArmNode*>(match->arms[0].get())->patterns.pop_back();
+    EXPECT_FALSE(astEqual(prog.get(), other.get()));
+    body->value.reset();
+    EXPECT_FALSE(astEqual(prog.get(), other.get()));
+}
+
+TEST(Ast, PatternValue) {
+    int64_t value = 0;
+    NumberLiteralNode folded("-9223372036854775808", 1);
+    EXPECT_TRUE(patternValue(&folded, value));
+    EXPECT_EQ(value, INT64_MIN);
+    UnaryExprNode negative("-", 1);
+    negative.operand = std::make_unique<NumberLiteralNode>("7", 1);
+    EXPECT_TRUE(patternValue(&negative, value));
+    EXPECT_EQ(value, -7);
+    IdentExprNode ident("y", 1);
+    EXPECT_FALSE(patternValue(&ident, value));
+}
+
+TEST(Ast, DeserializeRejectsTruncatedInput) {
+    auto prog = sampleTree();
+    std::string bytes;
+    serializeAst(prog.get(), bytes);
+    bytes.resize(bytes.size() / 2);
+
+    size_t pos = 0;
+    bool ok = true;
+    EXPECT_EQ(deserializeAst(bytes, pos, ok), nullptr);
+    EXPECT_FALSE(ok);
+}
+
+// ============================================================
+// CompactAst
+// ============================================================
+
+// fn main() { let mut x: i32 = -1; while x < 3 { x = x + 1; }
+//             if x == 3 { print("a", x); } else if x > 3 { return; } }
+static std::unique_ptr<ProgramNode> richTree() {
+    auto prog = sampleTree();
+    auto fn = std::make_unique<FnDeclNode>("main", 3);
+    auto body = std::make_unique<BlockNode>(3);
+
+    auto let = std::make_unique<LetStmtNode>(true, "x", 4);
+    let->typeName = "i32";
+    auto neg = std::make_unique<UnaryExprNode>("-", 4);
+    neg->operand = std::make_unique<NumberLiteralNode>("1", 4);
+    let->init = std::move(neg);
+    body->statements.push_back(std::move(let));
+
+    auto loop = std::make_unique<WhileStmtNode>(5);
+    auto cond = std::make_unique<BinaryExprNode>("<", 5);
+    cond->left = std::make_unique<IdentExprNode>("x", 5);
+    cond->right = std::make_unique<NumberLiteralNode>("3", 5);
+    loop->condition = std::move(cond);
+    auto loopBody = std::make_unique<BlockNode>(5);
+    auto assign = std::make_unique<AssignExprNode>("x", 6);
+    auto sum = std::make_unique<BinaryExprNode>("+", 6);
+    sum->left = std::make_unique<IdentExprNode>("x", 6);
+    sum->right = std::make_unique<NumberLiteralNode>("1", 6);
+    assign->value = std::move(sum);
+    auto assignStmt = std::make_unique<ExprStmtNode>(6);
+    assignStmt->expr = std::move(assign);
+    loopBody->statements.push_back(std::move(assignStmt));
+    loop->body = std::move(loopBody);
+    body->statements.push_back(std::move(loop));
+
+    auto ifs = std::make_unique<IfStmtNode>(8);
+    auto eq = std::make_unique<BinaryExprNode>("==", 8);
+    eq->left = std::make_unique<IdentExprNode>("x", 8);
+    eq->right = std::make_unique<NumberLiteralNode>("3", 8);
+    ifs->condition = std::move(eq);
+    auto thenBlock = std::make_unique<BlockNode>(8);
+    auto call = std::make_unique<CallExprNode>("print", 9);
+    call->args.push_back(std::make_unique<StringLiteralNode>("a", 9));
+    call->args.push_back(std::make_unique<IdentExprNode>("x", 9));
+    auto callStmt = std::make_unique<ExprStmtNode>(9);
+    callStmt->expr = std::move(call);
+    thenBlock->statements.push_back(std::move(callStmt));
+    ifs->thenBranch = std::move(thenBlock);
+    auto elseIf = std::make_unique<IfStmtNode>(10);
+    auto gt = std::make_unique<BinaryExprNode>(">", 10);
+    gt->left = std::make_unique<IdentExprNode>("x", 10);
+    gt->right = std::make_unique<NumberLiteralNode>("3", 10);
+    elseIf->condition = std::move(gt);
+    auto elseBlock = std::make_unique<BlockNode>(10);
+    elseBlock->statements.push_back(std::make_unique<ReturnStmtNode>(11));
+    elseIf->thenBranch = std::move(elseBlock);
+    ifs->elseBranch = std::move(elseIf);
+    body->statements.push_back(std::move(ifs));
+
+    fn->body = std::move(body);
+    prog->statements.push_back(std::move(fn));
+    return prog;
+}
+
+static size_t countNodes(AstRef node) {
+    if (!node) return 0;
+    size_t n = 1;
+    for (AstRef child : node.statements()) n += countNodes(child);
+    for (AstRef child : {node.body(), node.init(), node.value(), node.condition(),
+                         node.thenBranch(), node.elseBranch(), node.expr(), node.left(),
+                         node.right(), node.operand(), node.iterable(), node.object(),
+                         node.receiver(), node.scrutinee()}) {
+        n += countNodes(child);
+    }
+    return n;
+}
+
+TEST(CompactAst, PrintsLikePointerTree) {
+    auto prog = richTree();
+    CompactAst compact = CompactAst::build(prog.get());
+    std::ostringstream a, b;
+    printAst(prog.get(), a);
+    printAst(compact, b);
+    EXPECT_EQ(a.str(), b.str());
+    EXPECT_NE(a.str().find("elseBranch:"), std::string::npos);
+}
+
+TEST(CompactAst, ViewMatchesFields) {
+    auto prog = richTree();
+    CompactAst compact = CompactAst::build(prog.get());
+    NodeRef root = compact.root();
+    ASSERT_TRUE(root);
+    EXPECT_EQ(root.kind(), NodeKind::PROGRAM);
+
+    std::vector<NodeRef> fns(root.statements().begin(), root.statements().end());
+    ASSERT_EQ(fns.size(), 2u);
+    EXPECT_EQ(fns[0].name(), "add");
+    ASSERT_EQ(fns[0].paramCount(), 1u);
+    EXPECT_EQ(fns[0].param(0).name, "a");
+    EXPECT_EQ(fns[0].param(0).typeName, "i32");
+    EXPECT_EQ(fns[1].paramCount(), 0u);
+
+    std::vector<NodeRef> stmts(fns[1].body().statements().begin(), fns[1].body().statements().end());
+    ASSERT_EQ(stmts.size(), 3u);
+    EXPECT_TRUE(stmts[0].isMut());
+    EXPECT_EQ(stmts[0].typeName(), "i32");
+    EXPECT_EQ(stmts[0].init().operand().literal(), "1");
+    EXPECT_EQ(stmts[1].kind(), NodeKind::WHILE_STMT);
+    EXPECT_EQ(stmts[1].condition().op(), "<");
+    EXPECT_EQ(stmts[1].body().kind(), NodeKind::BLOCK);
+    EXPECT_EQ(stmts[1].line(), 5);
+
+    NodeRef elseIf = stmts[2].elseBranch();
+    EXPECT_EQ(elseIf.kind(), NodeKind::IF_STMT);
+    EXPECT_FALSE(elseIf.elseBranch());
+    NodeRef bareReturn = *elseIf.thenBranch().statements().begin();
+    EXPECT_EQ(bareReturn.kind(), NodeKind::RETURN_STMT);
+    EXPECT_FALSE(bareReturn.value());
+
+    NodeRef call = (*stmts[2].thenBranch().statements().begin()).expr();
+    EXPECT_EQ(call.callee(), "print");
+    std::vector<NodeRef> args(call.args().begin(), call.args().end());
+    ASSERT_EQ(args.size(), 2u);
+    EXPECT_EQ(args[0].literal(), "a");
+    EXPECT_EQ(args[1].name(), "x");
+}
+
+TEST(CompactAst, NodesAreOneRecordEachInPreOrder) {
+    auto prog = richTree();
+    CompactAst compact = CompactAst::build(prog.get());
+    const std::vector<CompactNode>& nodes = compact.nodes();
+    EXPECT_EQ(nodes.size(), countNodes(prog.get()));
+
+    // A linear scan sees every node; children directly follow their parent.
+    size_t idents = 0;
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].kind == NodeKind::IDENT_EXPR) ++idents;
+        if (nodes[i].firstChild != NO_NODE) {
+            EXPECT_EQ(nodes[i].firstChild, i + 1);
+        }
+    }
+    EXPECT_EQ(idents, 6u);
+
+    // Names are interned once.
+    size_t xs = 0;
+    for (const std::string& s : compact.strings()) xs += s == "x";
+    EXPECT_EQ(xs, 1u);
+}
+
+TEST(CompactAst, BuildHandlesDeepTrees) {
+    // ((1 + 1) + 1) + ... with 65536 terms, left-nested like the parser's.
+    const int terms = 65536;
+    AstNodePtr expr = std::make_unique<NumberLiteralNode>("1", 1);
+    for (int i = 1; i < terms; ++i) {
+        auto add = std::make_unique<BinaryExprNode>("+", 1);
+        add->left = std::move(expr);
+        add->right = std::make_unique<NumberLiteralNode>("1", 1);
+        expr = std::move(add);
+    }
+    CompactAst compact = CompactAst::build(expr.get());
+    const std::vector<CompactNode>& nodes = compact.nodes();
+    ASSERT_EQ(nodes.size(), 2u * terms - 1);
+    // Pre-order: the left spine first, then the right operands innermost first.
+    EXPECT_EQ(nodes[terms - 2].kind, NodeKind::BINARY_EXPR);
+    EXPECT_EQ(nodes[terms - 1].kind, NodeKind::NUMBER_LITERAL);
+    EXPECT_EQ(nodes[0].firstChild, 1u);
+    EXPECT_EQ(nodes[1].nextSibling, static_cast<uint32_t>(nodes.size() - 1));
+    NodeRef spine = compact.root();
+    for (int i = 1; i < terms; ++i) spine = spine.left();
+    EXPECT_EQ(spine.kind(), NodeKind::NUMBER_LITERAL);
+
+    std::vector<AstNodePtr> links;
+    while (expr && expr->kind == NodeKind::BINARY_EXPR) {
+        AstNodePtr next = std::move(static_cast<BinaryExprNode*>(expr.get())->left);
+        links.push_back(std::move(expr));
+        expr = std::move(next);
+    }
+}
+
+TEST(CompactAst, ItemsAndLoops) {
+    auto prog = itemsTree();
+    CompactAst compact = CompactAst::build(prog.get());
+    std::ostringstream a, b;
+    printAst(prog.get(), a);
+    printAst(compact, b);
+    EXPECT_EQ(a.str(), b.str());
+    EXPECT_EQ(compact.nodes().size(), countNodes(prog.get()));
+
+    std::vector<NodeRef> items(compact.root().statements().begin(),
+                               compact.root().statements().end());
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0].kind(), NodeKind::STRUCT_DECL);
+    ASSERT_EQ(items[0].fieldCount(), 2u);
+    EXPECT_EQ(items[0].field(1).name, "y");
+    EXPECT_EQ(items[0].field(1).typeName, "&str");
+
+    EXPECT_EQ(items[1].typeName(), "P");
+    NodeRef get = *items[1].methods().begin();
+    EXPECT_EQ(get.name(), "get");
+    EXPECT_EQ(get.paramCount(), 1u);
+    EXPECT_EQ(get.param(0).typeName, "&Self");
+    EXPECT_EQ(get.returnType(), "i64");
+    EXPECT_EQ(items[0].returnType(), "");
+
+    std::vector<NodeRef> stmts(get.body().statements().begin(), get.body().statements().end());
+    ASSERT_EQ(stmts.size(), 2u);
+    EXPECT_EQ(stmts[0].name(), "i");
+    EXPECT_EQ(stmts[0].iterable().op(), "..=");
+    EXPECT_EQ(stmts[0].body().kind(), NodeKind::BLOCK);
+    NodeRef call = stmts[1].value();
+    EXPECT_EQ(call.method(), "min");
+    EXPECT_EQ(call.receiver().name(), "x");
+    EXPECT_EQ(call.receiver().object().name(), "self");
+    std::vector<NodeRef> args(call.args().begin(), call.args().end());
+    ASSERT_EQ(args.size(), 1u);
+    EXPECT_EQ(args[0].literal(), "1");
+}
+
+TEST(CompactAst, MatchAndBlockValues) {
+    auto prog = matchTree();
+    CompactAst compact = CompactAst::build(prog.get());
+    std::ostringstream a, b;
+    printAst(prog.get(), a);
+    printAst(compact, b);
+    EXPECT_EQ(a.str(), b.str());
+    EXPECT_EQ(compact.nodes().size(), countNodes(prog.get()));
+
+    NodeRef body = (*compact.root().statements().begin()).body();
+    std::vector<NodeRef> stmts(body.statements().begin(), body.statements().end());
+    ASSERT_EQ(stmts.size(), 1u);  // the value is not a statement
+    NodeRef match = body.value();
+    ASSERT_EQ(match.kind(), NodeKind::MATCH_EXPR);
+    EXPECT_EQ(match.scrutinee().name(), "x");
+    std::vector<NodeRef> arms(match.arms().begin(), match.arms().end());
+    ASSERT_EQ(arms.size(), 2u);
+    std::vector<NodeRef> patterns(arms[0].patterns().begin(), arms[0].patterns().end());
+    ASSERT_EQ(patterns.size(), 2u);
+    EXPECT_EQ(patterns[1].operand().literal(), "2");
+    EXPECT_EQ(arms[0].body().value().name(), "y");
+    EXPECT_TRUE(arms[1].patterns().begin() == arms[1].patterns().end());
+    EXPECT_EQ(arms[1].body().literal(), "0");
+}
+
+TEST(CompactAst, EmptyTree) {
+    CompactAst compact = CompactAst::build(nullptr);
+    EXPECT_FALSE(compact.root());
+    EXPECT_TRUE(compact.nodes().empty());
+    std::ostringstream out;
+    printAst(compact, out);
+    EXPECT_EQ(out.str(), "");
+}
+
+// ============================================================
+// AstVisitor
+// ============================================================
+
+// Records "+Kind" / "-Kind" for every hook call; prunes while bodies.
+struct TraceVisitor : AstVisitor<TraceVisitor> {
+    std::string trace;
+    bool pruneWhile = false;
+
+    bool enter(const AstNode* node) {
+        trace += "+" + std::to_string(static_cast<int>(node->kind));
+        return true;
+    }
+    void leave(const AstNode* node) { trace += "-" + std::to_string(static_cast<int>(node->kind)); }
+
+    bool enterWhileStmt(const WhileStmtNode* n) {
+        enter(n);
+        return !pruneWhile;
+    }
+};
+
+struct CallCounter : AstVisitor<CallCounter> {
+    int calls = 0, args = 0;
+
+    bool enterCallExpr(const CallExprNode* n) {
+        ++calls;
+        args += static_cast<int>(n->args.size());
+        return true;
+    }
+};
+
+TEST(AstVisitor, VisitsInSourceOrderWithPrePostHooks) {
+    auto prog = sampleTree();
+    TraceVisitor v;
+    v.walk(prog.get());
+    // Program, FnDecl, Block, Return, Binary, Ident, NumberLiteral.
+    EXPECT_EQ(v.trace, "+0+1+2+4+9+12-12+13-13-9-4-2-1-0");
+}
+
+TEST(AstVisitor, IterativeWalkMakesTheSameCalls) {
+    auto prog = richTree();
+    TraceVisitor recursive, iterative;
+    recursive.walk(prog.get());
+    iterative.walkIterative(prog.get());
+    EXPECT_EQ(recursive.trace, iterative.trace);
+
+    recursive.trace.clear();
+    iterative.trace.clear();
+    recursive.pruneWhile = iterative.pruneWhile = true;
+    recursive.walk(prog.get());
+    iterative.walkIterative(prog.get());
+    EXPECT_EQ(recursive.trace, iterative.trace);
+}
+
+TEST(AstVisitor, FalseFromEnterSkipsChildrenButNotLeave) {
+    auto prog = richTree();
+    TraceVisitor v;
+    v.pruneWhile = true;
+    v.walk(prog.get());
+    // The while (kind 5) is entered and left with nothing in between.
+    EXPECT_NE(v.trace.find("+5-5"), std::string::npos);
+}
+
+TEST(AstVisitor, PerKindHooks) {
+    auto prog = richTree();
+    CallCounter v;
+    v.walk(prog.get());
+    EXPECT_EQ(v.calls, 1);
+    EXPECT_EQ(v.args, 2);
+}
+
+TEST(AstVisitor, MutableVisitorEditsNodes) {
+    struct Renamer : AstVisitor<Renamer, AstNode> {
+        bool enterIdentExpr(IdentExprNode* n) {
+            n->name += "_";
+            return true;
+        }
+    };
+    auto prog = sampleTree();
+    Renamer r;
+    r.walk(prog.get());
+    std::ostringstream out;
+    printAst(prog.get(), out);
+    EXPECT_NE(out.str().find("IdentExpr(\"a_\")"), std::string::npos);
+}
+
+TEST(AstVisitor, FusedPassesSeeWhatTheyWouldAlone) {
+    auto prog = richTree();
+    TraceVisitor alone, pruningAlone;
+    CallCounter callsAlone;
+    pruningAlone.pruneWhile = true;
+    alone.walk(prog.get());
+    pruningAlone.walk(prog.get());
+    callsAlone.walk(prog.get());
+
+    TraceVisitor full, pruning;
+    CallCounter calls;
+    pruning.pruneWhile = true;
+    fuse(full, pruning, calls).walk(prog.get());
+    EXPECT_EQ(full.trace, alone.trace);
+    EXPECT_EQ(pruning.trace, pruningAlone.trace);
+    EXPECT_EQ(calls.calls, callsAlone.calls);
+    EXPECT_EQ(calls.args, callsAlone.args);
+}
+
+TEST(AstVisitor, IterativeWalkHandlesDeepTrees) {
+    // -(-(-(... 1))) nested well past what the recursive walk is meant for.
+    const int depth = 20000;
+    AstNodePtr expr = std::make_unique<NumberLiteralNode>("1", 1);
+    for (int i = 0; i < depth; ++i) {
+        auto neg = std::make_unique<UnaryExprNode>("-", 1);
+        neg->operand = std::move(expr);
+        expr = std::move(neg);
+    }
+    struct Depth : AstVisitor<Depth> {
+        int current = 0, deepest = 0;
+        bool enter(const AstNode*) {
+            deepest = std::max(deepest, ++current);
+            return true;
+        }
+        void leave(const AstNode*) { --current; }
+    } d;
+    d.walkIterative(expr.get());
+    EXPECT_EQ(d.deepest, depth + 1);
+    EXPECT_EQ(d.current, 0);
+
+    // Take the chain apart bottom-up, so destruction does not recurse either.
+    std::vector<AstNodePtr> links;
+    while (expr && expr->kind == NodeKind::UNARY_EXPR) {
+        AstNodePtr next = std::move(static_cast<UnaryExprNode*>(expr.get())->operand);
+        links.push_back(std::move(expr));
+        expr = std::move(next);
+    }
+}
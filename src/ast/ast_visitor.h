@@ -0,0 +1,355 @@
+#ifndef AST_VISITOR_H
+#define AST_VISITOR_H
+
+#include "ast.h"
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// AstVisitor — tree walk with compile-time dispatch (CRTP)
+// ============================================================
+//
+// A pass derives from AstVisitor<Pass> and declares only the hooks it
+// needs. The dispatch switch calls them on the derived type, so they are
+// resolved at compile time and can inline; nothing is virtual.
+//
+//   struct CountCalls : AstVisitor<CountCalls> {
+//       int calls = 0;
+//       bool enterCallExpr(const CallExprNode*) { ++calls; return true; }
+//   };
+//   CountCalls pass;
+//   pass.walk(program.get());
+//
+// For each node, walk() calls enter<Kind>() before its children and
+// leave<Kind>() after them. Returning false from enter<Kind>() skips the
+// children; leave<Kind>() still runs. Unless the pass declares them, the
+// per-kind hooks forward to the generic enter(node) / leave(node), which
+// descend and do nothing. Children come in source order — the node's
+// fields top to bottom — and null ones are skipped.
+//
+// walkIterative() makes the same calls in the same order from an explicit
+// stack, for trees too deep for the native one.
+//
+// AstVisitor<Pass> sees `const XNode*`. AstVisitor<Pass, AstNode> gets
+// mutable nodes; it may change their fields but not the tree's shape
+// while walking it.
+template <typename Derived, typename Node = const AstNode>
+class AstVisitor {
+public:
+    using NodeType = Node;
+    template <typename T>
+    using Ptr = std::conditional_t<std::is_const<Node>::value, const T*, T*>;
+
+    void walk(Node* node) {
+        if (!node) return;
+        if (dispatchEnter(node)) forEachChild(node, [this](Node* child) { walk(child); });
+        dispatchLeave(node);
+    }
+
+    void walkIterative(Node* node) {
+        if (!node) return;
+        struct Pending {
+            Node* node;
+            bool leaving;
+        };
+        std::vector<Pending> stack{{node, false}};
+        while (!stack.empty()) {
+            Pending top = stack.back();
+            stack.pop_back();
+            if (top.leaving) {
+                dispatchLeave(top.node);
+                continue;
+            }
+            stack.push_back({top.node, true});
+            if (!dispatchEnter(top.node)) continue;
+            size_t mark = stack.size();
+            forEachChild(top.node, [&](Node* child) { stack.push_back({child, false}); });
+            std::reverse(stack.begin() + mark, stack.end());
+        }
+    }
+
+    // Calls fn(child) for each non-null child of `node`, in source order.
+    template <typename Fn>
+    static void forEachChild(Node* node, Fn&& fn) {
+        auto one = [&](auto& child) {
+            if (child) fn(child.get());
+        };
+        switch (node->kind) {
+            case NodeKind::PROGRAM:
+                for (auto& s : static_cast<Ptr<ProgramNode>>(node)->statements) one(s);
+                break;
+            case NodeKind::FN_DECL:
+                one(static_cast<Ptr<FnDeclNode>>(node)->body);
+                break;
+            case NodeKind::BLOCK: {
+                auto* n = static_cast<Ptr<BlockNode>>(node);
+                for (auto& s : n->statements) one(s);
+                one(n->value);
+                break;
+            }
+            case NodeKind::LET_STMT:
+                one(static_cast<Ptr<LetStmtNode>>(node)->init);
+                break;
+            case NodeKind::RETURN_STMT:
+                one(static_cast<Ptr<ReturnStmtNode>>(node)->value);
+                break;
+            case NodeKind::WHILE_STMT: {
+                auto* n = static_cast<Ptr<WhileStmtNode>>(node);
+                one(n->condition);
+                one(n->body);
+                break;
+            }
+            case NodeKind::IF_STMT: {
+                auto* n = static_cast<Ptr<IfStmtNode>>(node);
+                one(n->condition);
+                one(n->thenBranch);
+                one(n->elseBranch);
+                break;
+            }
+            case NodeKind::EXPR_STMT:
+                one(static_cast<Ptr<ExprStmtNode>>(node)->expr);
+                break;
+            case NodeKind::ASSIGN_EXPR:
+                one(static_cast<Ptr<AssignExprNode>>(node)->value);
+                break;
+            case NodeKind::BINARY_EXPR: {
+                auto* n = static_cast<Ptr<BinaryExprNode>>(node);
+                one(n->left);
+                one(n->right);
+                break;
+            }
+            case NodeKind::UNARY_EXPR:
+                one(static_cast<Ptr<UnaryExprNode>>(node)->operand);
+                break;
+            case NodeKind::CALL_EXPR:
+                for (auto& a : static_cast<Ptr<CallExprNode>>(node)->args) one(a);
+                break;
+            case NodeKind::IDENT_EXPR:
+            case NodeKind::NUMBER_LITERAL:
+            case NodeKind::STRING_LITERAL:
+            case NodeKind::STRUCT_DECL:
+            case NodeKind::BREAK_STMT:
+            case NodeKind::CONTINUE_STMT:
+                break;
+            case NodeKind::IMPL_BLOCK:
+                for (auto& m : static_cast<Ptr<ImplBlockNode>>(node)->methods) one(m);
+                break;
+            case NodeKind::LOOP_STMT:
+                one(static_cast<Ptr<LoopStmtNode>>(node)->body);
+                break;
+            case NodeKind::FOR_STMT: {
+                auto* n = static_cast<Ptr<ForStmtNode>>(node);
+                one(n->iterable);
+                one(n->body);
+                break;
+            }
+            case NodeKind::FIELD_EXPR:
+                one(static_cast<Ptr<FieldExprNode>>(node)->object);
+                break;
+            case NodeKind::METHOD_CALL_EXPR: {
+                auto* n = static_cast<Ptr<MethodCallExprNode>>(node);
+                one(n->receiver);
+                for (auto& a : n->args) one(a);
+                break;
+            }
+            case NodeKind::MATCH_EXPR: {
+                auto* n = static_cast<Ptr<MatchExprNode>>(node);
+                one(n->scrutinee);
+                for (auto& a : n->arms) one(a);
+                break;
+            }
+            case NodeKind::MATCH_ARM: {
+                auto* n = static_cast<Ptr<MatchArmNode>>(node);
+                for (auto& p : n->patterns) one(p);
+                one(n->body);
+                break;
+            }
+        }
+    }
+
+    // The hook calls walk() makes for one node; public so that drivers
+    // like FusedVisitor can step several passes together.
+    bool dispatchEnter(Node* node) {
+        switch (node->kind) {
+            case NodeKind::PROGRAM:          return self().enterProgram(static_cast<Ptr<ProgramNode>>(node));
+            case NodeKind::FN_DECL:          return self().enterFnDecl(static_cast<Ptr<FnDeclNode>>(node));
+            case NodeKind::BLOCK:            return self().enterBlock(static_cast<Ptr<BlockNode>>(node));
+            case NodeKind::LET_STMT:         return self().enterLetStmt(static_cast<Ptr<LetStmtNode>>(node));
+            case NodeKind::RETURN_STMT:      return self().enterReturnStmt(static_cast<Ptr<ReturnStmtNode>>(node));
+            case NodeKind::WHILE_STMT:       return self().enterWhileStmt(static_cast<Ptr<WhileStmtNode>>(node));
+            case NodeKind::IF_STMT:          return self().enterIfStmt(static_cast<Ptr<IfStmtNode>>(node));
+            case NodeKind::EXPR_STMT:        return self().enterExprStmt(static_cast<Ptr<ExprStmtNode>>(node));
+            case NodeKind::ASSIGN_EXPR:      return self().enterAssignExpr(static_cast<Ptr<AssignExprNode>>(node));
+            case NodeKind::BINARY_EXPR:      return self().enterBinaryExpr(static_cast<Ptr<BinaryExprNode>>(node));
+            case NodeKind::UNARY_EXPR:       return self().enterUnaryExpr(static_cast<Ptr<UnaryExprNode>>(node));
+            case NodeKind::CALL_EXPR:        return self().enterCallExpr(static_cast<Ptr<CallExprNode>>(node));
+            case NodeKind::IDENT_EXPR:       return self().enterIdentExpr(static_cast<Ptr<IdentExprNode>>(node));
+            case NodeKind::NUMBER_LITERAL:   return self().enterNumberLiteral(static_cast<Ptr<NumberLiteralNode>>(node));
+            case NodeKind::STRING_LITERAL:   return self().enterStringLiteral(static_cast<Ptr<StringLiteralNode>>(node));
+            case NodeKind::STRUCT_DECL:      return self().enterStructDecl(static_cast<Ptr<StructDeclNode>>(node));
+            case NodeKind::IMPL_BLOCK:       return self().enterImplBlock(static_cast<Ptr<ImplBlockNode>>(node));
+            case NodeKind::LOOP_STMT:        return self().enterLoopStmt(static_cast<Ptr<LoopStmtNode>>(node));
+            case NodeKind::FOR_STMT:         return self().enterForStmt(static_cast<Ptr<ForStmtNode>>(node));
+            case NodeKind::BREAK_STMT:       return self().enterBreakStmt(static_cast<Ptr<BreakStmtNode>>(node));
+            case NodeKind::CONTINUE_STMT:    return self().enterContinueStmt(static_cast<Ptr<ContinueStmtNode>>(node));
+            case NodeKind::FIELD_EXPR:       return self().enterFieldExpr(static_cast<Ptr<FieldExprNode>>(node));
+            case NodeKind::METHOD_CALL_EXPR: return self().enterMethodCallExpr(static_cast<Ptr<MethodCallExprNode>>(node));
+            case NodeKind::MATCH_EXPR:       return self().enterMatchExpr(static_cast<Ptr<MatchExprNode>>(node));
+            case NodeKind::MATCH_ARM:        return self().enterMatchArm(static_cast<Ptr<MatchArmNode>>(node));
+        }
+        return false;
+    }
+
+    void dispatchLeave(Node* node) {
+        switch (node->kind) {
+            case NodeKind::PROGRAM:          return self().leaveProgram(static_cast<Ptr<ProgramNode>>(node));
+            case NodeKind::FN_DECL:          return self().leaveFnDecl(static_cast<Ptr<FnDeclNode>>(node));
+            case NodeKind::BLOCK:            return self().leaveBlock(static_cast<Ptr<BlockNode>>(node));
+            case NodeKind::LET_STMT:         return self().leaveLetStmt(static_cast<Ptr<LetStmtNode>>(node));
+            case NodeKind::RETURN_STMT:      return self().leaveReturnStmt(static_cast<Ptr<ReturnStmtNode>>(node));
+            case NodeKind::WHILE_STMT:       return self().leaveWhileStmt(static_cast<Ptr<WhileStmtNode>>(node));
+            case NodeKind::IF_STMT:          return self().leaveIfStmt(static_cast<Ptr<IfStmtNode>>(node));
+            case NodeKind::EXPR_STMT:        return self().leaveExprStmt(static_cast<Ptr<ExprStmtNode>>(node));
+            case NodeKind::ASSIGN_EXPR:      return self().leaveAssignExpr(static_cast<Ptr<AssignExprNode>>(node));
+            case NodeKind::BINARY_EXPR:      return self().leaveBinaryExpr(static_cast<Ptr<BinaryExprNode>>(node));
+            case NodeKind::UNARY_EXPR:       return self().leaveUnaryExpr(static_cast<Ptr<UnaryExprNode>>(node));
+            case NodeKind::CALL_EXPR:        return self().leaveCallExpr(static_cast<Ptr<CallExprNode>>(node));
+            case NodeKind::IDENT_EXPR:       return self().leaveIdentExpr(static_cast<Ptr<IdentExprNode>>(node));
+            case NodeKind::NUMBER_LITERAL:   return self().leaveNumberLiteral(static_cast<Ptr<NumberLiteralNode>>(node));
+            case NodeKind::STRING_LITERAL:   return self().leaveStringLiteral(static_cast<Ptr<StringLiteralNode>>(node));
+            case NodeKind::STRUCT_DECL:      return self().leaveStructDecl(static_cast<Ptr<StructDeclNode>>(node));
+            case NodeKind::IMPL_BLOCK:       return self().leaveImplBlock(static_cast<Ptr<ImplBlockNode>>(node));
+            case NodeKind::LOOP_STMT:        return self().leaveLoopStmt(static_cast<Ptr<LoopStmtNode>>(node));
+            case NodeKind::FOR_STMT:         return self().leaveForStmt(static_cast<Ptr<ForStmtNode>>(node));
+            case NodeKind::BREAK_STMT:       return self().leaveBreakStmt(static_cast<Ptr<BreakStmtNode>>(node));
+            case NodeKind::CONTINUE_STMT:    return self().leaveContinueStmt(static_cast<Ptr<ContinueStmtNode>>(node));
+            case NodeKind::FIELD_EXPR:       return self().leaveFieldExpr(static_cast<Ptr<FieldExprNode>>(node));
+            case NodeKind::METHOD_CALL_EXPR: return self().leaveMethodCallExpr(static_cast<Ptr<MethodCallExprNode>>(node));
+            case NodeKind::MATCH_EXPR:       return self().leaveMatchExpr(static_cast<Ptr<MatchExprNode>>(node));
+            case NodeKind::MATCH_ARM:        return self().leaveMatchArm(static_cast<Ptr<MatchArmNode>>(node));
+        }
+    }
+
+    // ---- Hooks: a pass declares the ones it needs ----
+
+    bool enter(Node*) { return true; }
+    void leave(Node*) {}
+
+    bool enterProgram(Ptr<ProgramNode> n) { return self().enter(n); }
+    bool enterFnDecl(Ptr<FnDeclNode> n) { return self().enter(n); }
+    bool enterBlock(Ptr<BlockNode> n) { return self().enter(n); }
+    bool enterLetStmt(Ptr<LetStmtNode> n) { return self().enter(n); }
+    bool enterReturnStmt(Ptr<ReturnStmtNode> n) { return self().enter(n); }
+    bool enterWhileStmt(Ptr<WhileStmtNode> n) { return self().enter(n); }
+    bool enterIfStmt(Ptr<IfStmtNode> n) { return self().enter(n); }
+    bool enterExprStmt(Ptr<ExprStmtNode> n) { return self().enter(n); }
+    bool enterAssignExpr(Ptr<AssignExprNode> n) { return self().enter(n); }
+    bool enterBinaryExpr(Ptr<BinaryExprNode> n) { return self().enter(n); }
+    bool enterUnaryExpr(Ptr<UnaryExprNode> n) { return self().enter(n); }
+    bool enterCallExpr(Ptr<CallExprNode> n) { return self().enter(n); }
+    bool enterIdentExpr(Ptr<IdentExprNode> n) { return self().enter(n); }
+    bool enterNumberLiteral(Ptr<NumberLiteralNode> n) { return self().enter(n); }
+    bool enterStringLiteral(Ptr<StringLiteralNode> n) { return self().enter(n); }
+    bool enterStructDecl(Ptr<StructDeclNode> n) { return self().enter(n); }
+    bool enterImplBlock(Ptr<ImplBlockNode> n) { return self().enter(n); }
+    bool enterLoopStmt(Ptr<LoopStmtNode> n) { return self().enter(n); }
+    bool enterForStmt(Ptr<ForStmtNode> n) { return self().enter(n); }
+    bool enterBreakStmt(Ptr<BreakStmtNode> n) { return self().enter(n); }
+    bool enterContinueStmt(Ptr<ContinueStmtNode> n) { return self().enter(n); }
+    bool enterFieldExpr(Ptr<FieldExprNode> n) { return self().enter(n); }
+    bool enterMethodCallExpr(Ptr<MethodCallExprNode> n) { return self().enter(n); }
+    bool enterMatchExpr(Ptr<MatchExprNode> n) { return self().enter(n); }
+    bool enterMatchArm(Ptr<MatchArmNode> n) { return self().enter(n); }
+
+    void leaveProgram(Ptr<ProgramNode> n) { self().leave(n); }
+    void leaveFnDecl(Ptr<FnDeclNode> n) { self().leave(n); }
+    void leaveBlock(Ptr<BlockNode> n) { self().leave(n); }
+    void leaveLetStmt(Ptr<LetStmtNode> n) { self().leave(n); }
+    void leaveReturnStmt(Ptr<ReturnStmtNode> n) { self().leave(n); }
+    void leaveWhileStmt(Ptr<WhileStmtNode> n) { self().leave(n); }
+    void leaveIfStmt(Ptr<IfStmtNode> n) { self().leave(n); }
+    void leaveExprStmt(Ptr<ExprStmtNode> n) { self().leave(n); }
+    void leaveAssignExpr(Ptr<AssignExprNode> n) { self().leave(n); }
+    void leaveBinaryExpr(Ptr<BinaryExprNode> n) { self().leave(n); }
+    void leaveUnaryExpr(Ptr<UnaryExprNode> n) { self().leave(n); }
+    void leaveCallExpr(Ptr<CallExprNode> n) { self().leave(n); }
+    void leaveIdentExpr(Ptr<IdentExprNode> n) { self().leave(n); }
+    void leaveNumberLiteral(Ptr<NumberLiteralNode> n) { self().leave(n); }
+    void leaveStringLiteral(Ptr<StringLiteralNode> n) { self().leave(n); }
+    void leaveStructDecl(Ptr<StructDeclNode> n) { self().leave(n); }
+    void leaveImplBlock(Ptr<ImplBlockNode> n) { self().leave(n); }
+    void leaveLoopStmt(Ptr<LoopStmtNode> n) { self().leave(n); }
+    void leaveForStmt(Ptr<ForStmtNode> n) { self().leave(n); }
+    void leaveBreakStmt(Ptr<BreakStmtNode> n) { self().leave(n); }
+    void leaveContinueStmt(Ptr<ContinueStmtNode> n) { self().leave(n); }
+    void leaveFieldExpr(Ptr<FieldExprNode> n) { self().leave(n); }
+    void leaveMethodCallExpr(Ptr<MethodCallExprNode> n) { self().leave(n); }
+    void leaveMatchExpr(Ptr<MatchExprNode> n) { self().leave(n); }
+    void leaveMatchArm(Ptr<MatchArmNode> n) { self().leave(n); }
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+// ============================================================
+// FusedVisitor — several passes in one traversal
+// ============================================================
+//
+// Steps each pass through every node in turn, so each one sees exactly the
+// calls it would get from its own walk(): a pass that skips a subtree is
+// left out until that subtree is done, and the walk only descends while
+// some pass still wants to. The passes must agree on const-ness.
+//
+//   fuse(countCalls, findReturns).walk(program.get());
+template <typename... Passes>
+class FusedVisitor
+    : public AstVisitor<FusedVisitor<Passes...>,
+                        typename std::tuple_element_t<0, std::tuple<Passes...>>::NodeType> {
+public:
+    using Node = typename std::tuple_element_t<0, std::tuple<Passes...>>::NodeType;
+
+    explicit FusedVisitor(Passes&... passes) : passes_(passes...) {}
+
+    bool enter(Node* node) {
+        bool descend = false;
+        size_t i = 0;
+        std::apply([&](auto&... pass) { ((descend |= enterOne(pass, pruned_[i++], node)), ...); },
+                   passes_);
+        return descend;
+    }
+
+    void leave(Node* node) {
+        size_t i = 0;
+        std::apply([&](auto&... pass) { (leaveOne(pass, pruned_[i++], node), ...); }, passes_);
+    }
+
+private:
+    std::tuple<Passes&...> passes_;
+    Node* pruned_[sizeof...(Passes)] = {};  // the subtree each pass skips, if any
+
+    template <typename Pass>
+    static bool enterOne(Pass& pass, Node*& pruned, Node* node) {
+        if (pruned) return false;
+        if (pass.dispatchEnter(node)) return true;
+        pruned = node;
+        return false;
+    }
+
+    template <typename Pass>
+    static void leaveOne(Pass& pass, Node*& pruned, Node* node) {
+        if (pruned && pruned != node) return;
+        pruned = nullptr;
+        pass.dispatchLeave(node);
+    }
+};
+
+template <typename... Passes>
+FusedVisitor<Passes...> fuse(Passes&... passes) {
+    return FusedVisitor<Passes...>(passes...);
+}
+
+#endif // AST_VISITOR_H
@@ -0,0 +1,463 @@
+#include "compact_ast.h"
+#include <unordered_map>
+
+static const std::string EMPTY;
+
+// ============================================================
+// Building
+// ============================================================
+
+// Iterative, like AstVisitor::walkIterative(), so the depth of the tree is
+// bounded by memory rather than the native stack.
+struct CompactBuilder {
+    // A node whose children pending[next..end) are still to be emitted;
+    // `previous` is the last child emitted so far.
+    struct Frame {
+        uint32_t parent;
+        size_t from, next, end;
+        uint32_t previous;
+    };
+
+    CompactAst& ast;
+    std::unordered_map<std::string, uint32_t> interned;
+    std::vector<const AstNode*> pending;  // children waiting to be emitted, as a stack
+    std::vector<Frame> frames;
+
+    uint32_t intern(const std::string& s) {
+        auto it = interned.find(s);
+        if (it != interned.end()) return it->second;
+        uint32_t index = static_cast<uint32_t>(ast.strings_.size());
+        ast.strings_.push_back(s);
+        interned.emplace(s, index);
+        return index;
+    }
+
+    // Emits `node` and its subtree.
+    void emit(const AstNode* root);
+
+    // Appends the record of `node` alone, pushes its children onto
+    // `pending` and a frame to emit them.
+    void record(const AstNode* node);
+};
+
+void CompactBuilder::emit(const AstNode* root) {
+    record(root);
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        if (frame.next == frame.end) {
+            pending.resize(frame.from);
+            frames.pop_back();
+            continue;
+        }
+        // Pre-order: the child's record is the next one. Link it before
+        // record() pushes a frame, which may move `frame`.
+        uint32_t index = static_cast<uint32_t>(ast.nodes_.size());
+        if (frame.previous == NO_NODE) ast.nodes_[frame.parent].firstChild = index;
+        else ast.nodes_[frame.previous].nextSibling = index;
+        frame.previous = index;
+        record(pending[frame.next++]);
+    }
+}
+
+void CompactBuilder::record(const AstNode* node) {
+    uint32_t index = static_cast<uint32_t>(ast.nodes_.size());
+    ast.nodes_.push_back(CompactNode{node->kind, 0, 0, node->line, NO_NODE, NO_NODE, 0, 0});
+
+    // Children in role order; null roles are left out and recorded in flags.
+    size_t from = pending.size();
+    uint8_t flags = 0;
+    uint32_t data = 0, extra = 0;
+    uint16_t count = 0;
+    auto roles = [&](std::initializer_list<const AstNode*> list) {
+        int slot = 0;
+        for (const AstNode* child : list) {
+            if (child) {
+                flags |= static_cast<uint8_t>(FLAG_ROLE0 << slot);
+                pending.push_back(child);
+            }
+            ++slot;
+        }
+    };
+    auto list = [&](const std::vector<AstNodePtr>& nodes) {
+        for (const AstNodePtr& child : nodes) {
+            if (child) pending.push_back(child.get());
+        }
+    };
+    auto params = [&](const std::vector<ParamNode>& list) {
+        extra = static_cast<uint32_t>(ast.params_.size());
+        count = static_cast<uint16_t>(list.size());
+        for (const ParamNode& p : list) {
+            ast.params_.push_back(CompactParam{intern(p.name), intern(p.typeName), p.line});
+        }
+    };
+
+    switch (node->kind) {
+        case NodeKind::PROGRAM:
+            list(static_cast<const ProgramNode*>(node)->statements);
+            break;
+        case NodeKind::FN_DECL: {
+            auto* n = static_cast<const FnDeclNode*>(node);
+            data = intern(n->name);
+            params(n->params);
+            if (!n->returnType.empty()) {
+                flags |= FLAG_RETURN_TYPE;
+                ast.params_.push_back(CompactParam{0, intern(n->returnType), n->line});
+            }
+            roles({n->body.get()});
+            break;
+        }
+        case NodeKind::BLOCK: {
+            auto* n = static_cast<const BlockNode*>(node);
+            roles({n->value.get()});
+            list(n->statements);
+            break;
+        }
+        case NodeKind::LET_STMT: {
+            auto* n = static_cast<const LetStmtNode*>(node);
+            data = intern(n->name);
+            extra = intern(n->typeName);
+            if (n->isMut) flags |= FLAG_MUT;
+            roles({n->init.get()});
+            break;
+        }
+        case NodeKind::RETURN_STMT:
+            roles({static_cast<const ReturnStmtNode*>(node)->value.get()});
+            break;
+        case NodeKind::WHILE_STMT: {
+            auto* n = static_cast<const WhileStmtNode*>(node);
+            roles({n->condition.get(), n->body.get()});
+            break;
+        }
+        case NodeKind::IF_STMT: {
+            auto* n = static_cast<const IfStmtNode*>(node);
+            roles({n->condition.get(), n->thenBranch.get(), n->elseBranch.get()});
+            break;
+        }
+        case NodeKind::EXPR_STMT:
+            roles({static_cast<const ExprStmtNode*>(node)->expr.get()});
+            break;
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<const AssignExprNode*>(node);
+            data = intern(n->target);
+            roles({n->value.get()});
+            break;
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<const BinaryExprNode*>(node);
+            data = intern(n->op);
+            roles({n->left.get(), n->right.get()});
+            break;
+        }
+        case NodeKind::UNARY_EXPR: {
+            auto* n = static_cast<const UnaryExprNode*>(node);
+            data = intern(n->op);
+            roles({n->operand.get()});
+            break;
+        }
+        case NodeKind::CALL_EXPR: {
+            auto* n = static_cast<const CallExprNode*>(node);
+            data = intern(n->callee);
+            list(n->args);
+            break;
+        }
+        case NodeKind::IDENT_EXPR:
+            data = intern(static_cast<const IdentExprNode*>(node)->name);
+            break;
+        case NodeKind::NUMBER_LITERAL:
+            data = intern(static_cast<const NumberLiteralNode*>(node)->value);
+            break;
+        case NodeKind::STRING_LITERAL:
+            data = intern(static_cast<const StringLiteralNode*>(node)->value);
+            break;
+        case NodeKind::STRUCT_DECL: {
+            auto* n = static_cast<const StructDeclNode*>(node);
+            data = intern(n->name);
+            params(n->fields);
+            break;
+        }
+        case NodeKind::IMPL_BLOCK: {
+            auto* n = static_cast<const ImplBlockNode*>(node);
+            data = intern(n->typeName);
+            list(n->methods);
+            break;
+        }
+        case NodeKind::LOOP_STMT:
+            roles({static_cast<const LoopStmtNode*>(node)->body.get()});
+            break;
+        case NodeKind::FOR_STMT: {
+            auto* n = static_cast<const ForStmtNode*>(node);
+            data = intern(n->name);
+            roles({n->iterable.get(), n->body.get()});
+            break;
+        }
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT:
+            break;
+        case NodeKind::FIELD_EXPR: {
+            auto* n = static_cast<const FieldExprNode*>(node);
+            data = intern(n->name);
+            roles({n->object.get()});
+            break;
+        }
+        case NodeKind::METHOD_CALL_EXPR: {
+            // The receiver is role 0; the arguments follow it as a list.
+            auto* n = static_cast<const MethodCallExprNode*>(node);
+            data = intern(n->method);
+            roles({n->receiver.get()});
+            list(n->args);
+            break;
+        }
+        case NodeKind::MATCH_EXPR: {
+            auto* n = static_cast<const MatchExprNode*>(node);
+            roles({n->scrutinee.get()});
+            list(n->arms);
+            break;
+        }
+        case NodeKind::MATCH_ARM: {
+            auto* n = static_cast<const MatchArmNode*>(node);
+            roles({n->body.get()});
+            list(n->patterns);
+            break;
+        }
+    }
+
+    ast.nodes_[index].flags = flags;
+    ast.nodes_[index].count = count;
+    ast.nodes_[index].data = data;
+    ast.nodes_[index].extra = extra;
+    // Each child's frame pops what it pushes, so pending[from..end) stays put.
+    frames.push_back(Frame{index, from, from, pending.size(), NO_NODE});
+}
+
+CompactAst CompactAst::build(const AstNode* root) {
+    CompactAst ast;
+    if (!root) return ast;
+    CompactBuilder builder{ast, {}, {}, {}};
+    builder.intern("");  // index 0: the empty string, for absent names
+    builder.emit(root);
+    ast.nodes_.shrink_to_fit();
+    ast.params_.shrink_to_fit();
+    ast.strings_.shrink_to_fit();
+    return ast;
+}
+
+size_t CompactAst::memoryBytes() const {
+    size_t bytes = nodes_.capacity() * sizeof(CompactNode) +
+                   params_.capacity() * sizeof(CompactParam) +
+                   strings_.capacity() * sizeof(std::string);
+    for (const std::string& s : strings_) {
+        if (s.capacity() >= sizeof(std::string)) bytes += s.capacity() + 1;  // not inline
+    }
+    return bytes;
+}
+
+// ============================================================
+// NodeRef
+// ============================================================
+
+NodeRef::Children NodeRef::statements() const {
+    switch (kind()) {
+        case NodeKind::PROGRAM:
+        case NodeKind::CALL_EXPR:
+        case NodeKind::IMPL_BLOCK:
+            return {ChildIterator(ast_, node().firstChild), ChildIterator(ast_, NO_NODE)};
+        case NodeKind::BLOCK:
+        case NodeKind::METHOD_CALL_EXPR:
+        case NodeKind::MATCH_EXPR:
+        case NodeKind::MATCH_ARM: {
+            uint32_t first = node().firstChild;
+            if (node().flags & FLAG_ROLE0) first = ast_->nodes_[first].nextSibling;
+            return {ChildIterator(ast_, first), ChildIterator(ast_, NO_NODE)};
+        }
+        default:
+            return {ChildIterator(ast_, NO_NODE), ChildIterator(ast_, NO_NODE)};
+    }
+}
+
+NodeRef NodeRef::role(int slot) const {
+    uint8_t flags = node().flags;
+    if (!(flags & (FLAG_ROLE0 << slot))) return NodeRef(ast_, NO_NODE);
+    uint32_t child = node().firstChild;
+    for (int s = 0; s < slot; ++s) {
+        if (flags & (FLAG_ROLE0 << s)) child = ast_->nodes_[child].nextSibling;
+    }
+    return NodeRef(ast_, child);
+}
+
+const std::string& NodeRef::text() const {
+    return ast_->strings_[node().data];
+}
+
+const std::string& NodeRef::typeName() const {
+    if (kind() == NodeKind::LET_STMT) return ast_->strings_[node().extra];
+    if (kind() == NodeKind::IMPL_BLOCK) return text();
+    return EMPTY;
+}
+
+const std::string& NodeRef::returnType() const {
+    if (kind() != NodeKind::FN_DECL || !(node().flags & FLAG_RETURN_TYPE)) return EMPTY;
+    return ast_->strings_[ast_->params_[node().extra + node().count].typeName];
+}
+
+ParamView NodeRef::param(size_t i) const {
+    const CompactParam& p = ast_->params_[node().extra + i];
+    return ParamView{ast_->strings_[p.name], ast_->strings_[p.typeName], p.line};
+}
+
+// ============================================================
+// AstRef
+// ============================================================
+
+AstRef::Children AstRef::statements() const {
+    const std::vector<AstNodePtr>* list = nullptr;
+    switch (kind()) {
+        case NodeKind::PROGRAM:    list = &static_cast<const ProgramNode*>(node_)->statements; break;
+        case NodeKind::BLOCK:      list = &static_cast<const BlockNode*>(node_)->statements; break;
+        case NodeKind::CALL_EXPR:  list = &static_cast<const CallExprNode*>(node_)->args; break;
+        case NodeKind::IMPL_BLOCK: list = &static_cast<const ImplBlockNode*>(node_)->methods; break;
+        case NodeKind::METHOD_CALL_EXPR:
+            list = &static_cast<const MethodCallExprNode*>(node_)->args;
+            break;
+        case NodeKind::MATCH_EXPR: list = &static_cast<const MatchExprNode*>(node_)->arms; break;
+        case NodeKind::MATCH_ARM:  list = &static_cast<const MatchArmNode*>(node_)->patterns; break;
+        default: {
+            static const std::vector<AstNodePtr> none;
+            list = &none;
+            break;
+        }
+    }
+    return {ChildIterator(list->begin()), ChildIterator(list->end())};
+}
+
+AstRef AstRef::body() const {
+    if (kind() == NodeKind::FN_DECL) return static_cast<const FnDeclNode*>(node_)->body.get();
+    if (kind() == NodeKind::WHILE_STMT) return static_cast<const WhileStmtNode*>(node_)->body.get();
+    if (kind() == NodeKind::LOOP_STMT) return static_cast<const LoopStmtNode*>(node_)->body.get();
+    if (kind() == NodeKind::FOR_STMT) return static_cast<const ForStmtNode*>(node_)->body.get();
+    if (kind() == NodeKind::MATCH_ARM) return static_cast<const MatchArmNode*>(node_)->body.get();
+    return {};
+}
+
+AstRef AstRef::init() const {
+    if (kind() == NodeKind::LET_STMT) return static_cast<const LetStmtNode*>(node_)->init.get();
+    return {};
+}
+
+AstRef AstRef::value() const {
+    if (kind() == NodeKind::RETURN_STMT) return static_cast<const ReturnStmtNode*>(node_)->value.get();
+    if (kind() == NodeKind::ASSIGN_EXPR) return static_cast<const AssignExprNode*>(node_)->value.get();
+    if (kind() == NodeKind::BLOCK) return static_cast<const BlockNode*>(node_)->value.get();
+    return {};
+}
+
+AstRef AstRef::condition() const {
+    if (kind() == NodeKind::WHILE_STMT) return static_cast<const WhileStmtNode*>(node_)->condition.get();
+    if (kind() == NodeKind::IF_STMT) return static_cast<const IfStmtNode*>(node_)->condition.get();
+    return {};
+}
+
+AstRef AstRef::thenBranch() const {
+    if (kind() == NodeKind::IF_STMT) return static_cast<const IfStmtNode*>(node_)->thenBranch.get();
+    return {};
+}
+
+AstRef AstRef::elseBranch() const {
+    if (kind() == NodeKind::IF_STMT) return static_cast<const IfStmtNode*>(node_)->elseBranch.get();
+    return {};
+}
+
+AstRef AstRef::expr() const {
+    if (kind() == NodeKind::EXPR_STMT) return static_cast<const ExprStmtNode*>(node_)->expr.get();
+    return {};
+}
+
+AstRef AstRef::left() const {
+    if (kind() == NodeKind::BINARY_EXPR) return static_cast<const BinaryExprNode*>(node_)->left.get();
+    return {};
+}
+
+AstRef AstRef::right() const {
+    if (kind() == NodeKind::BINARY_EXPR) return static_cast<const BinaryExprNode*>(node_)->right.get();
+    return {};
+}
+
+AstRef AstRef::operand() const {
+    if (kind() == NodeKind::UNARY_EXPR) return static_cast<const UnaryExprNode*>(node_)->operand.get();
+    return {};
+}
+
+AstRef AstRef::iterable() const {
+    if (kind() == NodeKind::FOR_STMT) return static_cast<const ForStmtNode*>(node_)->iterable.get();
+    return {};
+}
+
+AstRef AstRef::object() const {
+    if (kind() == NodeKind::FIELD_EXPR) return static_cast<const FieldExprNode*>(node_)->object.get();
+    return {};
+}
+
+AstRef AstRef::receiver() const {
+    if (kind() == NodeKind::METHOD_CALL_EXPR) {
+        return static_cast<const MethodCallExprNode*>(node_)->receiver.get();
+    }
+    return {};
+}
+
+AstRef AstRef::scrutinee() const {
+    if (kind() == NodeKind::MATCH_EXPR) return static_cast<const MatchExprNode*>(node_)->scrutinee.get();
+    return {};
+}
+
+const std::string& AstRef::name() const {
+    switch (kind()) {
+        case NodeKind::FN_DECL:          return static_cast<const FnDeclNode*>(node_)->name;
+        case NodeKind::LET_STMT:         return static_cast<const LetStmtNode*>(node_)->name;
+        case NodeKind::ASSIGN_EXPR:      return static_cast<const AssignExprNode*>(node_)->target;
+        case NodeKind::BINARY_EXPR:      return static_cast<const BinaryExprNode*>(node_)->op;
+        case NodeKind::UNARY_EXPR:       return static_cast<const UnaryExprNode*>(node_)->op;
+        case NodeKind::CALL_EXPR:        return static_cast<const CallExprNode*>(node_)->callee;
+        case NodeKind::IDENT_EXPR:       return static_cast<const IdentExprNode*>(node_)->name;
+        case NodeKind::NUMBER_LITERAL:   return static_cast<const NumberLiteralNode*>(node_)->value;
+        case NodeKind::STRING_LITERAL:   return static_cast<const StringLiteralNode*>(node_)->value;
+        case NodeKind::STRUCT_DECL:      return static_cast<const StructDeclNode*>(node_)->name;
+        case NodeKind::FOR_STMT:         return static_cast<const ForStmtNode*>(node_)->name;
+        case NodeKind::FIELD_EXPR:       return static_cast<const FieldExprNode*>(node_)->name;
+        case NodeKind::METHOD_CALL_EXPR: return static_cast<const MethodCallExprNode*>(node_)->method;
+        default:                         return EMPTY;
+    }
+}
+
+const std::string& AstRef::typeName() const {
+    if (kind() == NodeKind::LET_STMT) return static_cast<const LetStmtNode*>(node_)->typeName;
+    if (kind() == NodeKind::IMPL_BLOCK) return static_cast<const ImplBlockNode*>(node_)->typeName;
+    return EMPTY;
+}
+
+const std::string& AstRef::returnType() const {
+    if (kind() == NodeKind::FN_DECL) return static_cast<const FnDeclNode*>(node_)->returnType;
+    return EMPTY;
+}
+
+bool AstRef::isMut() const {
+    return kind() == NodeKind::LET_STMT && static_cast<const LetStmtNode*>(node_)->isMut;
+}
+
+size_t AstRef::paramCount() const {
+    if (kind() == NodeKind::FN_DECL) return static_cast<const FnDeclNode*>(node_)->params.size();
+    return 0;
+}
+
+ParamView AstRef::param(size_t i) const {
+    const ParamNode& p = static_cast<const FnDeclNode*>(node_)->params[i];
+    return ParamView{p.name, p.typeName, p.line};
+}
+
+size_t AstRef::fieldCount() const {
+    if (kind() != NodeKind::STRUCT_DECL) return 0;
+    return static_cast<const StructDeclNode*>(node_)->fields.size();
+}
+
+ParamView AstRef::field(size_t i) const {
+    const ParamNode& p = static_cast<const StructDeclNode*>(node_)->fields[i];
+    return ParamView{p.name, p.typeName, p.line};
+}
@@ -0,0 +1,271 @@
+#ifndef COMPACT_AST_H
+#define COMPACT_AST_H
+
+#include "ast.h"
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// ============================================================
+// CompactNode — one fixed-size record per AST node
+// ============================================================
+//
+// A CompactAst stores the whole tree in one vector of these, in pre-order:
+// a node's first child, when it has one, is the next record, and its
+// remaining children follow their elder sibling's subtree. Strings (names,
+// operators, literal text, type names) are interned into one table and
+// referenced by index.
+static constexpr uint32_t NO_NODE = 0xFFFFFFFFu;
+
+struct CompactNode {
+    NodeKind kind;
+    uint8_t flags;          // FLAG_* below
+    uint16_t count;         // FN_DECL, STRUCT_DECL: parameters / fields (at most MAX_PARAMS)
+    int32_t line;
+    uint32_t firstChild;    // NO_NODE if there are no children
+    uint32_t nextSibling;   // NO_NODE for the last child
+    uint32_t data;          // string index: name, target, callee, op, literal text, field,
+                            // method or (IMPL_BLOCK) type name
+    uint32_t extra;         // LET_STMT: type name string; FN_DECL, STRUCT_DECL: first
+                            // parameter / field
+};
+
+static_assert(sizeof(CompactNode) == 24, "CompactNode must stay 24 bytes");
+static_assert(MAX_PARAMS <= UINT16_MAX, "CompactNode::count holds any list the parser accepts");
+
+// LET_STMT's `mut`.
+static constexpr uint8_t FLAG_MUT = 0x01;
+// FN_DECL has a `-> Type`; its CompactParam follows the parameters' (name
+// unused), so functions without one pay nothing.
+static constexpr uint8_t FLAG_RETURN_TYPE = 0x02;
+// Presence of the fixed child roles, in the order the pointer node declares
+// them (e.g. IF_STMT: condition, thenBranch, elseBranch). Absent roles take
+// no record, so a role's child is found by counting the present ones before it.
+// A node with both a role and a list (BLOCK's value, METHOD_CALL_EXPR's
+// receiver, MATCH_EXPR's scrutinee, MATCH_ARM's body) records the role first.
+static constexpr uint8_t FLAG_ROLE0 = 0x10;
+static constexpr uint8_t FLAG_ROLE1 = 0x20;
+static constexpr uint8_t FLAG_ROLE2 = 0x40;
+
+struct CompactParam {
+    uint32_t name;      // string index
+    uint32_t typeName;  // string index
+    int32_t line;
+};
+
+// What both views hand out for a function parameter or struct field.
+struct ParamView {
+    const std::string& name;
+    const std::string& typeName;
+    int line;
+};
+
+class CompactAst;
+
+// ============================================================
+// NodeRef — read-only view of one node of a CompactAst
+// ============================================================
+//
+// Mirrors the fields of the pointer node structs (see AstRef below), so code
+// written against the view runs on either representation. Accessors that do
+// not apply to the node's kind return an empty ref or string.
+class NodeRef {
+public:
+    NodeRef() = default;
+    NodeRef(const CompactAst* ast, uint32_t index) : ast_(ast), index_(index) {}
+
+    explicit operator bool() const { return index_ != NO_NODE; }
+    uint32_t index() const { return index_; }
+
+    NodeKind kind() const { return node().kind; }
+    int line() const { return node().line; }
+
+    class ChildIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = NodeRef;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = NodeRef;
+
+        ChildIterator(const CompactAst* ast, uint32_t index) : ast_(ast), index_(index) {}
+        NodeRef operator*() const { return NodeRef(ast_, index_); }
+        ChildIterator& operator++();
+        bool operator==(const ChildIterator& o) const { return index_ == o.index_; }
+        bool operator!=(const ChildIterator& o) const { return index_ != o.index_; }
+
+    private:
+        const CompactAst* ast_;
+        uint32_t index_;
+    };
+
+    struct Children {
+        ChildIterator first, last;
+        ChildIterator begin() const { return first; }
+        ChildIterator end() const { return last; }
+    };
+
+    // PROGRAM and BLOCK statements, CALL_EXPR and METHOD_CALL_EXPR
+    // arguments, IMPL_BLOCK methods, MATCH_EXPR arms, MATCH_ARM patterns.
+    Children statements() const;
+    Children args() const { return statements(); }
+    Children methods() const { return statements(); }
+    Children arms() const { return statements(); }
+    Children patterns() const { return statements(); }
+
+    // Fixed child roles.
+    NodeRef body() const {
+        return role(kind() == NodeKind::WHILE_STMT || kind() == NodeKind::FOR_STMT ? 1 : 0);
+    }
+    NodeRef iterable() const { return role(0); }
+    NodeRef object() const { return role(0); }
+    NodeRef receiver() const { return role(0); }
+    NodeRef scrutinee() const { return role(0); }
+    NodeRef init() const { return role(0); }
+    NodeRef value() const { return role(0); }
+    NodeRef condition() const { return role(0); }
+    NodeRef thenBranch() const { return role(1); }
+    NodeRef elseBranch() const { return role(2); }
+    NodeRef expr() const { return role(0); }
+    NodeRef left() const { return role(0); }
+    NodeRef right() const { return role(1); }
+    NodeRef operand() const { return role(0); }
+
+    // Payloads.
+    const std::string& name() const { return text(); }
+    const std::string& target() const { return text(); }
+    const std::string& callee() const { return text(); }
+    const std::string& op() const { return text(); }
+    const std::string& literal() const { return text(); }
+    const std::string& method() const { return text(); }
+    const std::string& typeName() const;
+    const std::string& returnType() const;
+    bool isMut() const { return (node().flags & FLAG_MUT) != 0; }
+    size_t paramCount() const { return kind() == NodeKind::FN_DECL ? node().count : 0; }
+    ParamView param(size_t i) const;
+    size_t fieldCount() const { return kind() == NodeKind::STRUCT_DECL ? node().count : 0; }
+    ParamView field(size_t i) const { return param(i); }
+
+private:
+    const CompactAst* ast_ = nullptr;
+    uint32_t index_ = NO_NODE;
+
+    const CompactNode& node() const;
+    const std::string& text() const;
+    NodeRef role(int slot) const;
+};
+
+// ============================================================
+// CompactAst — the flat tree
+// ============================================================
+class CompactAst {
+public:
+    // Flattens a pointer tree (normally a ProgramNode). A null root gives
+    // an empty CompactAst whose root() is an empty ref.
+    static CompactAst build(const AstNode* root);
+
+    NodeRef root() const { return NodeRef(this, nodes_.empty() ? NO_NODE : 0); }
+
+    // Every node in pre-order, for passes that do not need the tree shape.
+    const std::vector<CompactNode>& nodes() const { return nodes_; }
+    const std::vector<std::string>& strings() const { return strings_; }
+    const std::vector<CompactParam>& params() const { return params_; }
+
+    // Bytes held by the three arrays and the interned string contents.
+    size_t memoryBytes() const;
+
+private:
+    friend class NodeRef;
+    friend struct CompactBuilder;
+
+    std::vector<CompactNode> nodes_;
+    std::vector<std::string> strings_;
+    std::vector<CompactParam> params_;
+};
+
+inline const CompactNode& NodeRef::node() const { return ast_->nodes_[index_]; }
+
+inline NodeRef::ChildIterator& NodeRef::ChildIterator::operator++() {
+    index_ = ast_->nodes()[index_].nextSibling;
+    return *this;
+}
+
+// ============================================================
+// AstRef — the same view over the pointer tree
+// ============================================================
+class AstRef {
+public:
+    AstRef() = default;
+    AstRef(const AstNode* node) : node_(node) {}
+
+    explicit operator bool() const { return node_ != nullptr; }
+    const AstNode* get() const { return node_; }
+
+    NodeKind kind() const { return node_->kind; }
+    int line() const { return node_->line; }
+
+    class ChildIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = AstRef;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = AstRef;
+
+        explicit ChildIterator(std::vector<AstNodePtr>::const_iterator it) : it_(it) {}
+        AstRef operator*() const { return AstRef(it_->get()); }
+        ChildIterator& operator++() { ++it_; return *this; }
+        bool operator==(const ChildIterator& o) const { return it_ == o.it_; }
+        bool operator!=(const ChildIterator& o) const { return it_ != o.it_; }
+
+    private:
+        std::vector<AstNodePtr>::const_iterator it_;
+    };
+
+    struct Children {
+        ChildIterator first, last;
+        ChildIterator begin() const { return first; }
+        ChildIterator end() const { return last; }
+    };
+
+    Children statements() const;
+    Children args() const { return statements(); }
+    Children methods() const { return statements(); }
+    Children arms() const { return statements(); }
+    Children patterns() const { return statements(); }
+
+    AstRef body() const;
+    AstRef init() const;
+    AstRef value() const;
+    AstRef condition() const;
+    AstRef thenBranch() const;
+    AstRef elseBranch() const;
+    AstRef expr() const;
+    AstRef left() const;
+    AstRef right() const;
+    AstRef operand() const;
+    AstRef iterable() const;
+    AstRef object() const;
+    AstRef receiver() const;
+    AstRef scrutinee() const;
+
+    const std::string& name() const;
+    const std::string& target() const { return name(); }
+    const std::string& callee() const { return name(); }
+    const std::string& op() const { return name(); }
+    const std::string& literal() const { return name(); }
+    const std::string& method() const { return name(); }
+    const std::string& typeName() const;
+    const std::string& returnType() const;
+    bool isMut() const;
+    size_t paramCount() const;
+    ParamView param(size_t i) const;
+    size_t fieldCount() const;
+    ParamView field(size_t i) const;
+
+private:
+    const AstNode* node_ = nullptr;
+};
+
+#endif // COMPACT_AST_H
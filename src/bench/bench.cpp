@@ -0,0 +1,1196 @@
+#include "../ast/ast_printer.h"
+#include "../ast/ast_visitor.h"
+#include "../ast/compact_ast.h"
+#include "../codegen/codegen.h"
+#include "../codegen/llvm_emitter.h"
+#include "../codegen/ssa.h"
+#include "../diag/diag.h"
+#include "../interp/interpreter.h"
+#include "../jit/jit.h"
+#include "../json/json_dump.h"
+#include "../opt/const_fold.h"
+#include "../opt/parse_passes.h"
+#include "../parser/parser.h"
+#include "../semantic/semantic.h"
+#include "../util/thread_pool.h"
+#include "../vm/bytecode.h"
+#include "../vm/vm.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <streambuf>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// rustc_bench — timing harness for compiler phases
+// ============================================================
+//
+// Not part of ctest: timings depend on the machine. Each benchmark prints
+// one row per configuration with the best of several runs.
+
+static double bestOfMs(int runs, const std::function<void()>& fn) {
+    double best = 0;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+        if (r == 0 || ms.count() < best) best = ms.count();
+    }
+    return best;
+}
+
+// Returns the value of a `--name=value` argument, or nullptr if `arg` is not one.
+static const char* flagValue(const char* arg, const char* name) {
+    size_t len = std::strlen(name);
+    if (std::strncmp(arg, name, len) == 0 && arg[len] == '=') return arg + len + 1;
+    return nullptr;
+}
+
+// `count` functions with straight-line bodies that call their neighbours.
+// The first let of each body multiplies by `firstFactor`.
+static std::string generateFunctions(int count, int bodyLets, int firstFactor = 1) {
+    std::string src;
+    for (int i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        src += "fn f" + n + "(a: i32, b: i32) {\n";
+        src += "    let mut acc = a;\n";
+        for (int j = 0; j < bodyLets; ++j) {
+            std::string v = "v" + std::to_string(j);
+            src += "    let " + v + " = acc * " + std::to_string(j + firstFactor) + " + b;\n";
+            src += "    if " + v + " > 100 { acc = acc - " + v + "; } else { acc = acc + 1; }\n";
+        }
+        src += "    return f" + std::to_string((i + 1) % count) + "(acc, b);\n";
+        src += "}\n";
+    }
+    return src;
+}
+
+// ============================================================
+// semantic — serial analyze() vs analyzeParallel() at 1..N threads
+// ============================================================
+static int benchSemantic(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--threads")) maxThreads = std::atoi(v);
+    }
+    if (functions < 1) functions = 1;
+    if (maxThreads == 0) maxThreads = 1;
+
+    std::string src = generateFunctions(functions, bodyLets);
+    Parser parser(src);
+    auto program = parser.parseProgram();
+    if (parser.hasErrors()) {
+        std::fprintf(stderr, "generated program did not parse\n");
+        return 1;
+    }
+
+    std::printf("semantic: %d functions, %zu bytes\n", functions, src.size());
+    double serial = bestOfMs(3, [&] {
+        SemanticAnalyzer analyzer(program.get());
+        analyzer.analyze();
+    });
+    std::printf("  %-10s %9.2f ms\n", "serial", serial);
+
+    // Powers of two below the maximum, then the maximum itself.
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned t : threadCounts) {
+        ThreadPool pool(t);
+        double ms = bestOfMs(3, [&] {
+            SemanticAnalyzer analyzer(program.get());
+            analyzer.analyzeParallel(pool);
+        });
+        char label[32];
+        std::snprintf(label, sizeof(label), "%u thread%s", t, t == 1 ? "" : "s");
+        std::printf("  %-10s %9.2f ms  (%.2fx)\n", label, ms, serial / ms);
+    }
+    return 0;
+}
+
+// ============================================================
+// llvm — serial emitLlvm() vs emitLlvmParallel() at 1..N threads
+// ============================================================
+static int benchLlvm(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--threads")) maxThreads = std::atoi(v);
+    }
+    if (functions < 1) functions = 1;
+    if (maxThreads == 0) maxThreads = 1;
+
+    std::string src = generateFunctions(functions, bodyLets);
+    Parser parser(src);
+    auto program = parser.parseProgram();
+    CodeGen codegen(program.get());
+    IrModule module = codegen.lower();
+    if (parser.hasErrors() || codegen.hasErrors()) {
+        std::fprintf(stderr, "generated program did not compile\n");
+        return 1;
+    }
+
+    std::string expected;
+    double serial = bestOfMs(3, [&] { expected = emitLlvm(module); });
+    std::printf("llvm: %d functions, %zu bytes of .ll\n", functions, expected.size());
+    std::printf("  %-10s %9.2f ms\n", "serial", serial);
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned t : threadCounts) {
+        ThreadPool pool(t);
+        std::string out;
+        double ms = bestOfMs(3, [&] { out = emitLlvmParallel(module, pool); });
+        if (out != expected) {
+            std::fprintf(stderr, "llvm: parallel output differs at %u threads\n", t);
+            return 1;
+        }
+        char label[32];
+        std::snprintf(label, sizeof(label), "%u thread%s", t, t == 1 ? "" : "s");
+        std::printf("  %-10s %9.2f ms  (%.2fx)\n", label, ms, serial / ms);
+    }
+    return 0;
+}
+
+// ============================================================
+// ir — TAC instruction counts before and after the SSA passes
+// ============================================================
+static int benchIr(int argc, char* argv[]) {
+    if (argc == 0) {
+        std::fprintf(stderr, "ir: expects .rs files (e.g. tests/corpus/*.rs)\n");
+        return 1;
+    }
+    std::printf("%-28s %8s %8s %8s\n", "file", "before", "after", "change");
+    uint64_t totalBefore = 0, totalAfter = 0;
+    for (int i = 0; i < argc; ++i) {
+        std::ifstream file(argv[i]);
+        if (!file.is_open()) {
+            std::fprintf(stderr, "ir: could not open '%s'\n", argv[i]);
+            return 1;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        Parser parser(buffer.str());
+        auto program = parser.parseProgram();
+        CodeGen codegen(program.get());
+        IrModule module = codegen.lower();
+        if (parser.hasErrors() || codegen.hasErrors()) {
+            std::fprintf(stderr, "ir: '%s' does not compile\n", argv[i]);
+            return 1;
+        }
+
+        IrOptStats stats;
+        optimizeModule(module, stats);
+        totalBefore += stats.instrsBefore;
+        totalAfter += stats.instrsAfter;
+        std::printf("%-28s %8llu %8llu %7.1f%%\n", argv[i],
+                    static_cast<unsigned long long>(stats.instrsBefore),
+                    static_cast<unsigned long long>(stats.instrsAfter),
+                    100.0 * (double(stats.instrsAfter) - double(stats.instrsBefore)) /
+                        double(stats.instrsBefore ? stats.instrsBefore : 1));
+    }
+    std::printf("%-28s %8llu %8llu %7.1f%%\n", "total",
+                static_cast<unsigned long long>(totalBefore),
+                static_cast<unsigned long long>(totalAfter),
+                100.0 * (double(totalAfter) - double(totalBefore)) /
+                    double(totalBefore ? totalBefore : 1));
+    return 0;
+}
+
+// ============================================================
+// vm — bytecode VM and slot-resolved interpreter vs a naive tree walker
+// ============================================================
+
+// The baseline: walks the AST as is, keeping variables in a std::map per
+// block scope, looking functions up by name on every call and trying match
+// arms in order. Integers wrap like the VM's; a failure (division by zero,
+// runaway recursion) sets `failed`.
+class NaiveEvaluator {
+public:
+    explicit NaiveEvaluator(const ProgramNode* program) {
+        for (const auto& stmt : program->statements) declare(stmt.get());
+    }
+
+    bool failed = false;
+
+    int64_t call(const std::string& name, const std::vector<int64_t>& args) {
+        auto it = functions_.find(name);
+        if (it == functions_.end() || depth_ > 10000) {
+            failed = true;
+            return 0;
+        }
+        const FnDeclNode* fn = it->second;
+        std::vector<std::map<std::string, int64_t>> saved;
+        saved.swap(scopes_);
+        scopes_.emplace_back();
+        for (size_t i = 0; i < fn->params.size() && i < args.size(); ++i) {
+            scopes_.back()[fn->params[i].name] = args[i];
+        }
+        ++depth_;
+        returning_ = false;
+        returnValue_ = 0;
+        int64_t value = eval(fn->body.get());
+        if (returning_) value = returnValue_;
+        --depth_;
+        returning_ = false;
+        scopes_.swap(saved);
+        return value;
+    }
+
+private:
+    std::map<std::string, const FnDeclNode*> functions_;
+    std::vector<std::map<std::string, int64_t>> scopes_;
+    bool returning_ = false;
+    int64_t returnValue_ = 0;
+    int depth_ = 0;
+
+    void declare(const AstNode* node) {
+        if (node->kind == NodeKind::FN_DECL) {
+            auto* fn = static_cast<const FnDeclNode*>(node);
+            functions_[fn->name] = fn;
+        }
+    }
+
+    int64_t* lookup(const std::string& name) {
+        for (size_t i = scopes_.size(); i-- > 0;) {
+            auto it = scopes_[i].find(name);
+            if (it != scopes_[i].end()) return &it->second;
+        }
+        return nullptr;
+    }
+
+    int64_t evalBlock(const BlockNode* block) {
+        for (const auto& stmt : block->statements) declare(stmt.get());
+        scopes_.emplace_back();
+        for (const auto& stmt : block->statements) {
+            exec(stmt.get());
+            if (failed || returning_) break;
+        }
+        int64_t value = block->value ? eval(block->value.get()) : 0;
+        scopes_.pop_back();
+        return value;
+    }
+
+    void exec(const AstNode* node) {
+        if (failed || returning_) return;
+        switch (node->kind) {
+            case NodeKind::BLOCK:
+                evalBlock(static_cast<const BlockNode*>(node));
+                break;
+            case NodeKind::LET_STMT: {
+                auto* let = static_cast<const LetStmtNode*>(node);
+                int64_t value = eval(let->init.get());
+                scopes_.back()[let->name] = value;
+                break;
+            }
+            case NodeKind::RETURN_STMT: {
+                auto* ret = static_cast<const ReturnStmtNode*>(node);
+                int64_t value = ret->value ? eval(ret->value.get()) : 0;
+                returnValue_ = value;
+                returning_ = true;
+                break;
+            }
+            case NodeKind::WHILE_STMT: {
+                auto* loop = static_cast<const WhileStmtNode*>(node);
+                while (!failed && !returning_ && eval(loop->condition.get()) != 0) {
+                    exec(loop->body.get());
+                }
+                break;
+            }
+            case NodeKind::IF_STMT: {
+                auto* branch = static_cast<const IfStmtNode*>(node);
+                if (eval(branch->condition.get()) != 0) exec(branch->thenBranch.get());
+                else if (branch->elseBranch) exec(branch->elseBranch.get());
+                break;
+            }
+            case NodeKind::EXPR_STMT:
+                eval(static_cast<const ExprStmtNode*>(node)->expr.get());
+                break;
+            default:
+                break;
+        }
+    }
+
+    int64_t eval(const AstNode* node) {
+        if (failed || returning_) return 0;
+        switch (node->kind) {
+            case NodeKind::NUMBER_LITERAL:
+                return literalValue(static_cast<const NumberLiteralNode*>(node));
+            case NodeKind::STRING_LITERAL:
+                return 0;
+            case NodeKind::IDENT_EXPR: {
+                const std::string& name = static_cast<const IdentExprNode*>(node)->name;
+                if (name == "true") return 1;
+                if (name == "false") return 0;
+                int64_t* slot = lookup(name);
+                return slot ? *slot : 0;
+            }
+            case NodeKind::ASSIGN_EXPR: {
+                auto* assign = static_cast<const AssignExprNode*>(node);
+                int64_t value = eval(assign->value.get());
+                if (int64_t* slot = lookup(assign->target)) *slot = value;
+                return 0;
+            }
+            case NodeKind::UNARY_EXPR:
+                return static_cast<int64_t>(
+                    0 - static_cast<uint64_t>(eval(static_cast<const UnaryExprNode*>(node)->operand.get())));
+            case NodeKind::CALL_EXPR: {
+                auto* call = static_cast<const CallExprNode*>(node);
+                std::vector<int64_t> args;
+                for (const auto& arg : call->args) args.push_back(eval(arg.get()));
+                bool wasReturning = returning_;
+                int64_t saved = returnValue_;
+                int64_t value = this->call(call->callee, args);
+                returning_ = wasReturning;
+                returnValue_ = saved;
+                return value;
+            }
+            case NodeKind::BINARY_EXPR: {
+                auto* bin = static_cast<const BinaryExprNode*>(node);
+                uint64_t x = static_cast<uint64_t>(eval(bin->left.get()));
+                uint64_t y = static_cast<uint64_t>(eval(bin->right.get()));
+                int64_t a = static_cast<int64_t>(x), b = static_cast<int64_t>(y);
+                const std::string& op = bin->op;
+                if (op == "+") return static_cast<int64_t>(x + y);
+                if (op == "-") return static_cast<int64_t>(x - y);
+                if (op == "*") return static_cast<int64_t>(x * y);
+                if (op == "/") {
+                    if (b == 0) {
+                        failed = true;
+                        return 0;
+                    }
+                    return b == -1 ? static_cast<int64_t>(0 - x) : a / b;
+                }
+                if (op == "==") return a == b;
+                if (op == "!=") return a != b;
+                if (op == "<") return a < b;
+                if (op == ">") return a > b;
+                if (op == "<=") return a <= b;
+                return a >= b;
+            }
+            case NodeKind::BLOCK:
+                return evalBlock(static_cast<const BlockNode*>(node));
+            case NodeKind::IF_STMT: {
+                auto* branch = static_cast<const IfStmtNode*>(node);
+                if (eval(branch->condition.get()) != 0) return eval(branch->thenBranch.get());
+                return branch->elseBranch ? eval(branch->elseBranch.get()) : 0;
+            }
+            case NodeKind::MATCH_EXPR: {
+                auto* match = static_cast<const MatchExprNode*>(node);
+                int64_t x = eval(match->scrutinee.get());
+                for (const auto& a : match->arms) {
+                    auto* arm = static_cast<const MatchArmNode*>(a.get());
+                    bool hit = arm->patterns.empty();
+                    for (const auto& pattern : arm->patterns) {
+                        int64_t value;
+                        if (patternValue(pattern.get(), value) && value == x) hit = true;
+                    }
+                    if (hit) return eval(arm->body.get());
+                }
+                return 0;
+            }
+            default:
+                return 0;
+        }
+    }
+};
+
+static bool compileFile(const char* path, bool optimize, std::unique_ptr<ProgramNode>& program,
+                        IrModule& module, BcModule& bytecode) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    Parser parser(buffer.str());
+    program = parser.parseProgram();
+    CodeGen codegen(program.get());
+    module = codegen.lower();
+    if (parser.hasErrors() || codegen.hasErrors()) return false;
+    if (optimize) {
+        IrOptStats stats;
+        optimizeModule(module, stats);
+    }
+    BytecodeCompiler compiler(module);
+    bytecode = compiler.compile();
+    return !compiler.hasErrors();
+}
+
+static int benchVm(int argc, char* argv[]) {
+    if (argc == 0) {
+        std::fprintf(stderr, "vm: expects .rs files with a main() (e.g. tests/corpus/*.rs)\n");
+        return 1;
+    }
+    std::printf("%-28s %10s %10s %10s %10s %10s %8s\n", "file", "tree-walk", "slots", "vm", "vm -O",
+                "jit -O", "speedup");
+    for (int i = 0; i < argc; ++i) {
+        std::unique_ptr<ProgramNode> program, unused;
+        IrModule plainIr, optimizedIr;
+        BcModule plain, optimized;
+        if (!compileFile(argv[i], false, program, plainIr, plain) ||
+            !compileFile(argv[i], true, unused, optimizedIr, optimized) || plain.find("main") == IR_NONE) {
+            std::fprintf(stderr, "vm: '%s' does not compile or has no main()\n", argv[i]);
+            return 1;
+        }
+
+        int64_t expected = 0, got[2] = {0, 0};
+        bool ok = true;
+        double walkMs = bestOfMs(3, [&] {
+            NaiveEvaluator eval(program.get());
+            expected = eval.call("main", {});
+            ok = ok && !eval.failed;
+        });
+        int64_t slotResult = 0;
+        Interpreter interp(program.get());
+        double slotMs = bestOfMs(3, [&] { ok = interp.call("main", {}, slotResult) && ok; });
+        double vmMs[2];
+        const BcModule* modules[2] = {&plain, &optimized};
+        for (int k = 0; k < 2; ++k) {
+            Vm vm(*modules[k]);
+            vmMs[k] = bestOfMs(3, [&] { ok = vm.call(modules[k]->find("main"), {}, got[k]) && ok; });
+        }
+        // Without native code generation the column repeats the VM's.
+        int64_t jitResult = got[1];
+        double jitMs = vmMs[1];
+        Jit jit(optimizedIr);
+        if (jit.compiled()) {
+            jitMs = bestOfMs(3, [&] { ok = jit.call(jit.find("main"), {}, jitResult) && ok; });
+        }
+        if (!ok || slotResult != expected || got[0] != expected || got[1] != expected ||
+            jitResult != expected) {
+            std::fprintf(stderr, "vm: '%s' results differ (%lld, %lld, %lld, %lld, %lld)\n", argv[i],
+                         static_cast<long long>(expected), static_cast<long long>(slotResult),
+                         static_cast<long long>(got[0]), static_cast<long long>(got[1]),
+                         static_cast<long long>(jitResult));
+            return 1;
+        }
+        std::printf("%-28s %7.2f ms %7.2f ms %7.2f ms %7.2f ms %7.2f ms %7.1fx\n", argv[i], walkMs,
+                    slotMs, vmMs[0], vmMs[1], jitMs, walkMs / jitMs);
+    }
+    return 0;
+}
+
+// ============================================================
+// ast — pointer tree vs CompactAst: footprint, traversal, printing
+// ============================================================
+
+static size_t heapBytes(const std::string& s) {
+    return s.capacity() >= sizeof(std::string) ? s.capacity() + 1 : 0;
+}
+
+// Node structs, child vectors and out-of-line strings; allocator overhead
+// not included.
+static size_t pointerTreeBytes(AstRef node) {
+    if (!node) return 0;
+    size_t bytes = heapBytes(node.name()) + heapBytes(node.typeName());
+    switch (node.kind()) {
+        case NodeKind::PROGRAM: {
+            auto* n = static_cast<const ProgramNode*>(node.get());
+            bytes += sizeof(ProgramNode) + n->statements.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::FN_DECL: {
+            auto* n = static_cast<const FnDeclNode*>(node.get());
+            bytes += sizeof(FnDeclNode) + n->params.capacity() * sizeof(ParamNode);
+            for (const ParamNode& p : n->params) bytes += heapBytes(p.name) + heapBytes(p.typeName);
+            bytes += heapBytes(n->returnType);
+            break;
+        }
+        case NodeKind::STRUCT_DECL: {
+            auto* n = static_cast<const StructDeclNode*>(node.get());
+            bytes += sizeof(StructDeclNode) + n->fields.capacity() * sizeof(ParamNode);
+            for (const ParamNode& p : n->fields) bytes += heapBytes(p.name) + heapBytes(p.typeName);
+            break;
+        }
+        case NodeKind::IMPL_BLOCK: {
+            auto* n = static_cast<const ImplBlockNode*>(node.get());
+            bytes += sizeof(ImplBlockNode) + n->methods.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto* n = static_cast<const MethodCallExprNode*>(node.get());
+            bytes += sizeof(MethodCallExprNode) + n->args.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::BLOCK: {
+            auto* n = static_cast<const BlockNode*>(node.get());
+            bytes += sizeof(BlockNode) + n->statements.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::CALL_EXPR: {
+            auto* n = static_cast<const CallExprNode*>(node.get());
+            bytes += sizeof(CallExprNode) + n->args.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::MATCH_EXPR: {
+            auto* n = static_cast<const MatchExprNode*>(node.get());
+            bytes += sizeof(MatchExprNode) + n->arms.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::MATCH_ARM: {
+            auto* n = static_cast<const MatchArmNode*>(node.get());
+            bytes += sizeof(MatchArmNode) + n->patterns.capacity() * sizeof(AstNodePtr);
+            break;
+        }
+        case NodeKind::LET_STMT:       bytes += sizeof(LetStmtNode); break;
+        case NodeKind::RETURN_STMT:    bytes += sizeof(ReturnStmtNode); break;
+        case NodeKind::WHILE_STMT:     bytes += sizeof(WhileStmtNode); break;
+        case NodeKind::IF_STMT:        bytes += sizeof(IfStmtNode); break;
+        case NodeKind::EXPR_STMT:      bytes += sizeof(ExprStmtNode); break;
+        case NodeKind::ASSIGN_EXPR:    bytes += sizeof(AssignExprNode); break;
+        case NodeKind::BINARY_EXPR:    bytes += sizeof(BinaryExprNode); break;
+        case NodeKind::UNARY_EXPR:     bytes += sizeof(UnaryExprNode); break;
+        case NodeKind::IDENT_EXPR:     bytes += sizeof(IdentExprNode); break;
+        case NodeKind::NUMBER_LITERAL: bytes += sizeof(NumberLiteralNode); break;
+        case NodeKind::STRING_LITERAL: bytes += sizeof(StringLiteralNode); break;
+        case NodeKind::LOOP_STMT:      bytes += sizeof(LoopStmtNode); break;
+        case NodeKind::FOR_STMT:       bytes += sizeof(ForStmtNode); break;
+        case NodeKind::BREAK_STMT:     bytes += sizeof(BreakStmtNode); break;
+        case NodeKind::CONTINUE_STMT:  bytes += sizeof(ContinueStmtNode); break;
+        case NodeKind::FIELD_EXPR:     bytes += sizeof(FieldExprNode); break;
+    }
+    for (AstRef child : node.statements()) bytes += pointerTreeBytes(child);
+    for (AstRef child : {node.body(), node.init(), node.value(), node.condition(), node.thenBranch(),
+                         node.elseBranch(), node.expr(), node.left(), node.right(), node.operand(),
+                         node.iterable(), node.object(), node.receiver(), node.scrutinee()}) {
+        bytes += pointerTreeBytes(child);
+    }
+    return bytes;
+}
+
+// The usual shape of an analysis pass: visit everything, look at kinds.
+struct KindCounter : AstVisitor<KindCounter> {
+    size_t* counts;
+
+    explicit KindCounter(size_t* c) : counts(c) {}
+
+    bool enter(const AstNode* node) {
+        counts[static_cast<size_t>(node->kind)]++;
+        return true;
+    }
+};
+
+static int benchAst(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+    }
+    if (functions < 1) functions = 1;
+
+    std::string src = generateFunctions(functions, bodyLets);
+    Parser parser(src);
+    auto program = parser.parseProgram();
+    if (parser.hasErrors()) {
+        std::fprintf(stderr, "generated program did not parse\n");
+        return 1;
+    }
+    CompactAst compact;
+    double buildMs = bestOfMs(3, [&] { compact = CompactAst::build(program.get()); });
+
+    constexpr size_t KINDS = NODE_KIND_COUNT;
+    size_t treeCounts[KINDS] = {}, flatCounts[KINDS] = {};
+    double treeWalkMs = bestOfMs(3, [&] {
+        std::fill(treeCounts, treeCounts + KINDS, 0);
+        KindCounter(treeCounts).walk(program.get());
+    });
+    double flatWalkMs = bestOfMs(3, [&] {
+        std::fill(flatCounts, flatCounts + KINDS, 0);
+        for (const CompactNode& n : compact.nodes()) flatCounts[static_cast<size_t>(n.kind)]++;
+    });
+    std::string treeText, flatText;
+    double treePrintMs = bestOfMs(3, [&] {
+        std::ostringstream out;
+        printAst(program.get(), out);
+        treeText = out.str();
+    });
+    double flatPrintMs = bestOfMs(3, [&] {
+        std::ostringstream out;
+        printAst(compact, out);
+        flatText = out.str();
+    });
+    if (!std::equal(treeCounts, treeCounts + KINDS, flatCounts) || treeText != flatText) {
+        std::fprintf(stderr, "ast: the two representations disagree\n");
+        return 1;
+    }
+
+    std::printf("ast: %d functions, %zu nodes (compact build %.2f ms)\n", functions,
+                compact.nodes().size(), buildMs);
+    std::printf("  %-10s %10s %12s %12s\n", "", "bytes", "walk", "printAst");
+    std::printf("  %-10s %10zu %9.2f ms %9.2f ms\n", "pointer", pointerTreeBytes(program.get()),
+                treeWalkMs, treePrintMs);
+    std::printf("  %-10s %10zu %9.2f ms %9.2f ms\n", "compact", compact.memoryBytes(), flatWalkMs,
+                flatPrintMs);
+    return 0;
+}
+
+// ============================================================
+// fuse — parse, stats, check, fold, resolve as separate passes vs fused
+// ============================================================
+
+// Slots of every name read or assigned, in tree order.
+struct NameSlots : AstVisitor<NameSlots> {
+    std::vector<uint32_t> slots;
+    bool enterIdentExpr(const IdentExprNode* n) {
+        slots.push_back(n->slot);
+        return true;
+    }
+    bool enterAssignExpr(const AssignExprNode* n) {
+        slots.push_back(n->slot);
+        return true;
+    }
+};
+
+static int benchFuse(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    int firstFactor = 1;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+        else if (std::strcmp(argv[i], "--no-identities") == 0) firstFactor = 2;
+    }
+    if (functions < 1) functions = 1;
+    // By default every body starts with `acc * 1`, which is folded after
+    // checking; --no-identities makes that `acc * 2`.
+    std::string src = generateFunctions(functions, bodyLets, firstFactor);
+
+    std::unique_ptr<ProgramNode> separateTree, fusedTree;
+    AstStats separateStats, fusedStats;
+    FoldStats separateFolds, fusedFolds;
+    size_t exprsFolded = 0;
+    bool ok = true;
+    auto separate = [&] {
+        Parser parser(src);
+        separateTree = parser.parseProgram();
+        separateStats = collectAstStats(separateTree.get());
+        SemanticAnalyzer analyzer(separateTree.get());
+        ok = !parser.hasErrors() && analyzer.analyze() && ok;
+        ConstantFolder folder(separateTree.get());
+        folder.run();
+        separateFolds = folder.stats();
+        Interpreter interp(separateTree.get());
+        ok = !interp.hasErrors() && ok;
+    };
+    auto fused = [&] {
+        Parser parser(src);
+        ParseTimePasses passes(true, true);
+        parser.setListener(&passes);
+        fusedTree = parser.parseProgram();
+        fusedStats = passes.stats();
+        SemanticAnalyzer analyzer(fusedTree.get());
+        ok = !parser.hasErrors() && analyzer.analyze() && ok;
+        ConstantFolder folder(fusedTree.get());
+        folder.runExprs(passes.exprsToFold());
+        exprsFolded = passes.exprsToFold().size();
+        fusedFolds = passes.foldStats();
+        fusedFolds.constantsFolded += folder.stats().constantsFolded;
+        fusedFolds.identities += folder.stats().identities;
+        Interpreter interp(fusedTree.get());
+        ok = !interp.hasErrors() && ok;
+    };
+
+    // Alternate the two, and which goes first. Both trees are freed outside
+    // the timed region, so neither run pays for the other's memory; they
+    // are built once more afterwards to be compared.
+    double separateMs = 0, fusedMs = 0;
+    for (int run = 0; run < 10; ++run) {
+        for (int turn = 0; turn < 2; ++turn) {
+            separateTree.reset();
+            fusedTree.reset();
+            if ((run + turn) % 2 == 0) {
+                double ms = bestOfMs(1, separate);
+                if (run == 0 || ms < separateMs) separateMs = ms;
+            } else {
+                double ms = bestOfMs(1, fused);
+                if (run == 0 || ms < fusedMs) fusedMs = ms;
+            }
+        }
+    }
+    separate();
+    fused();
+    NameSlots separateSlots, fusedSlots;
+    separateSlots.walk(separateTree.get());
+    fusedSlots.walk(fusedTree.get());
+    if (!ok || !astEqual(separateTree.get(), fusedTree.get()) ||
+        separateSlots.slots != fusedSlots.slots || separateStats.nodes != fusedStats.nodes ||
+        separateFolds.constantsFolded != fusedFolds.constantsFolded ||
+        separateFolds.identities != fusedFolds.identities) {
+        std::fprintf(stderr, "fuse: the two pipelines disagree\n");
+        return 1;
+    }
+
+    std::printf("fuse: %d functions, %llu nodes, %llu folds, %zu expression(s) refolded after checking\n",
+                functions, static_cast<unsigned long long>(fusedStats.nodes),
+                static_cast<unsigned long long>(fusedFolds.constantsFolded + fusedFolds.identities),
+                exprsFolded);
+    std::printf("  %-10s %9.2f ms\n", "separate", separateMs);
+    std::printf("  %-10s %9.2f ms  (%.2fx)\n", "fused", fusedMs, separateMs / fusedMs);
+    return 0;
+}
+
+// ============================================================
+// recovery — parse time on garbage input must grow linearly with its size
+// ============================================================
+//
+// Two inputs: uniformly random bytes (a binary file passed by mistake) and
+// random tokens of the language (more of the input reaches the parser's
+// recovery paths). No error limit, so every error is reported.
+static std::string randomBytes(size_t size, std::mt19937_64& rng) {
+    std::string s(size, '\0');
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t r = rng();
+        for (size_t k = 0; k < 8 && i + k < size; ++k) s[i + k] = static_cast<char>(r >> (8 * k));
+    }
+    return s;
+}
+
+static std::string randomTokens(size_t size, std::mt19937_64& rng) {
+    static const char* vocabulary[] = {
+        "fn ", "let ", "mut ", "if ", "else ", "while ", "return ", "x ", "f ", "1 ", "\"s\" ",
+        "+ ", "- ", "* ", "/ ", "= ", "== ", "< ", "( ", ") ", "{ ", "} ", "; ", ": ", ", ", "! ",
+        "\n",
+    };
+    const size_t count = sizeof(vocabulary) / sizeof(vocabulary[0]);
+    std::string s;
+    s.reserve(size + 8);
+    while (s.size() < size) s += vocabulary[rng() % count];
+    s.resize(size);
+    return s;
+}
+
+static int benchRecovery(int argc, char* argv[]) {
+    size_t maxMb = 100;
+    uint64_t seed = 1;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--mb")) maxMb = std::strtoull(v, nullptr, 10);
+        else if (const char* v = flagValue(argv[i], "--seed")) seed = std::strtoull(v, nullptr, 10);
+    }
+    if (maxMb < 1) maxMb = 1;
+    std::vector<size_t> sizesMb;
+    for (size_t mb = 1; mb < maxMb; mb *= 2) sizesMb.push_back(mb);
+    sizesMb.push_back(maxMb);
+
+    bool linear = true;
+    for (int kind = 0; kind < 2; ++kind) {
+        std::printf("recovery: random %s\n", kind == 0 ? "bytes" : "tokens");
+        std::printf("  %8s %12s %10s %10s\n", "MB", "errors", "time", "ns/byte");
+        double firstNs = 0;
+        for (size_t mb : sizesMb) {
+            std::mt19937_64 rng(seed);
+            size_t size = mb << 20;
+            std::string src = kind == 0 ? randomBytes(size, rng) : randomTokens(size, rng);
+            size_t errors = 0;
+            double ms = bestOfMs(mb <= 8 ? 3 : 1, [&] {
+                Parser parser(src);
+                auto program = parser.parseProgram();
+                errors = parser.errors().size();
+            });
+            double ns = ms * 1e6 / size;
+            if (mb == sizesMb.front()) firstNs = ns;
+            std::printf("  %8zu %12zu %7.0f ms %10.1f\n", mb, errors, ms, ns);
+            // Allow for cache effects and noise; quadratic growth would
+            // be off by orders of magnitude at these sizes.
+            if (ns > 3 * firstNs) linear = false;
+        }
+    }
+    if (!linear) {
+        std::fprintf(stderr, "recovery: time per byte grows with the input size\n");
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================
+// diag — reporting every error of an error-heavy input
+// ============================================================
+//
+// `eager` is what the driver used to do: a message string per error, built
+// while parsing, and a flushed line per error. `deferred` records
+// Diagnostics and renders the same lines into one buffer and one write;
+// `snippets` adds the source lines and carets. Output goes to /dev/null.
+static int benchDiag(int argc, char* argv[]) {
+    size_t mb = 4;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--mb")) mb = std::strtoull(v, nullptr, 10);
+    }
+    if (mb < 1) mb = 1;
+    std::mt19937_64 rng(1);
+    std::string src = randomTokens(mb << 20, rng);
+    std::FILE* sink = std::fopen("/dev/null", "w");
+    if (!sink) return 1;
+
+    size_t errors = 0;
+    double parseMs = bestOfMs(3, [&] {
+        Parser parser(src);
+        auto program = parser.parseProgram();
+        errors = parser.diagnostics().size();
+    });
+    double eagerMs = bestOfMs(3, [&] {
+        Parser parser(src);
+        auto program = parser.parseProgram();
+        for (const ParseError& err : parser.errors()) {
+            std::fprintf(sink, "Parse error [line %d]: %s\n", err.line, err.message.c_str());
+            std::fflush(sink);
+        }
+    });
+    auto deferred = [&](bool snippets) {
+        return bestOfMs(3, [&] {
+            Parser parser(src);
+            auto program = parser.parseProgram();
+            std::string out = renderDiagnostics(parser.diagnostics(), src, snippets);
+            std::fwrite(out.data(), 1, out.size(), sink);
+            std::fflush(sink);
+        });
+    };
+    double deferredMs = deferred(false);
+    double snippetsMs = deferred(true);
+    std::fclose(sink);
+
+    std::printf("diag: %zu MB of random tokens, %zu errors\n", mb, errors);
+    std::printf("  %-10s %9.2f ms\n", "parse only", parseMs);
+    std::printf("  %-10s %9.2f ms  (+%.2f ms to report)\n", "eager", eagerMs, eagerMs - parseMs);
+    std::printf("  %-10s %9.2f ms  (+%.2f ms to report)\n", "deferred", deferredMs,
+                deferredMs - parseMs);
+    std::printf("  %-10s %9.2f ms  (+%.2f ms to report)\n", "snippets", snippetsMs,
+                snippetsMs - parseMs);
+    return 0;
+}
+
+// ============================================================
+// json — --emit=tokens-json / ast-json throughput
+// ============================================================
+//
+// Output goes to a stream that only counts bytes, so the rows measure the
+// lexer or parser plus the writer, not the disk.
+class CountingBuf : public std::streambuf {
+public:
+    size_t bytes = 0;
+
+protected:
+    int overflow(int c) override {
+        if (c != traits_type::eof()) ++bytes;
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        bytes += static_cast<size_t>(n);
+        return n;
+    }
+};
+
+static int benchJson(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+    }
+    if (functions < 1) functions = 1;
+    std::string src = generateFunctions(functions, bodyLets);
+
+    double lexMs = bestOfMs(3, [&] {
+        Lexer lexer(src);
+        while (lexer.nextToken().type != TokenType::EOF_TOKEN) {}
+    });
+    size_t tokenBytes = 0;
+    double tokensMs = bestOfMs(3, [&] {
+        CountingBuf buf;
+        std::ostream out(&buf);
+        {
+            Lexer lexer(src);
+            JsonWriter json(out);
+            writeTokensJson(lexer, json);
+        }
+        tokenBytes = buf.bytes;
+    });
+    double parseMs = bestOfMs(3, [&] {
+        Parser parser(src);
+        auto program = parser.parseProgram();
+    });
+    size_t astBytes = 0;
+    double astMs = bestOfMs(3, [&] {
+        CountingBuf buf;
+        std::ostream out(&buf);
+        Parser parser(src);
+        auto program = parser.parseProgram();
+        {
+            JsonWriter json(out);
+            writeAstJson(program.get(), json);
+        }
+        astBytes = buf.bytes;
+    });
+
+    auto mbPerSec = [](size_t bytes, double ms) { return bytes / double(1 << 20) / (ms / 1000.0); };
+    std::printf("json: %d functions x %d lets, %.1f MB of source\n", functions, bodyLets,
+                src.size() / double(1 << 20));
+    std::printf("  %-12s %9.2f ms\n", "lex only", lexMs);
+    std::printf("  %-12s %9.2f ms  %8.1f MB out  %7.1f MB/s\n", "tokens-json", tokensMs,
+                tokenBytes / double(1 << 20), mbPerSec(tokenBytes, tokensMs));
+    std::printf("  %-12s %9.2f ms\n", "parse only", parseMs);
+    std::printf("  %-12s %9.2f ms  %8.1f MB out  %7.1f MB/s\n", "ast-json", astMs,
+                astBytes / double(1 << 20), mbPerSec(astBytes, astMs));
+    return 0;
+}
+
+// ============================================================
+// lexer — nextToken() throughput
+// ============================================================
+//
+// Three inputs: the `semantic` program (identifiers and keywords), N MB of
+// operators and punctuation, and N MB of literal-heavy statements.
+static int benchLexer(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    size_t mb = 16;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--mb")) mb = std::strtoull(v, nullptr, 10);
+    }
+    if (functions < 1) functions = 1;
+    if (mb < 1) mb = 1;
+
+    // The operator mix sticks to the original operator set, so runs before
+    // and after the dispatch-table lexer compare like for like.
+    std::mt19937_64 rng(1);
+    static const char* operators[] = {
+        "+ ", "- ", "* ", "/ ", "= ", "== ", "!= ", "< ", "> ", "<= ", ">= ", "(", ")", "{", "}",
+        ";", ":", ",", "+", "-", "==", "<=", "\n",
+    };
+    const size_t count = sizeof(operators) / sizeof(operators[0]);
+    std::string ops;
+    while (ops.size() < (mb << 20)) ops += operators[rng() % count];
+    std::string literals;
+    while (literals.size() < (mb << 20)) {
+        literals += "let count = 1234567890123; "
+                    "let s = \"hello world, this is a string\"; x = y + 42;\n";
+    }
+    std::string unicode;
+    while (unicode.size() < (mb << 20)) {
+        unicode += "let größe_ñ = \"日本語のテキスト, über alles\"; // ü Ω\nlet x = größe_ñ;\n";
+    }
+    struct Input { const char* name; std::string src; };
+    Input inputs[] = {
+        {"program", generateFunctions(functions, bodyLets)},
+        {"operators", std::move(ops)},
+        {"literals", std::move(literals)},
+        {"unicode", std::move(unicode)},
+    };
+
+    std::printf("lexer: nextToken() until EOF\n");
+    std::printf("  %-10s %8s %12s %10s %9s %10s\n", "input", "MB", "tokens", "time", "MB/s",
+                "ns/token");
+    for (const Input& in : inputs) {
+        size_t tokens = 0;
+        double ms = bestOfMs(3, [&] {
+            Lexer lexer(in.src);
+            tokens = 0;
+            while (lexer.nextToken().type != TokenType::EOF_TOKEN) ++tokens;
+        });
+        double mbs = in.src.size() / double(1 << 20);
+        std::printf("  %-10s %8.1f %12zu %7.1f ms %9.1f %10.2f\n", in.name, mbs, tokens, ms,
+                    mbs / (ms / 1000.0), ms * 1e6 / tokens);
+    }
+    return 0;
+}
+
+// ============================================================
+// relex — Lexer::applyEdit() against the size of the file
+// ============================================================
+//
+// A typing session in the middle of the `semantic` program, repeated up to
+// N MB: characters (every tenth a newline) typed into an identifier one
+// edit at a time, then deleted again. The first edit adds a line and a
+// token, so it is the one that places the gaps and grows them — once per
+// session, proportional to the file — and is reported apart.
+static int benchRelex(int argc, char* argv[]) {
+    size_t maxMb = 16;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--mb")) maxMb = std::strtoull(v, nullptr, 10);
+    }
+    if (maxMb < 1) maxMb = 1;
+    std::vector<size_t> sizesMb;
+    for (size_t mb = 1; mb < maxMb; mb *= 2) sizesMb.push_back(mb);
+    sizesMb.push_back(maxMb);
+    const int typed = 500;
+
+    std::printf("relex: %d characters typed and deleted, one applyEdit() each\n", typed);
+    std::printf("  %8s %10s %12s %12s %12s\n", "MB", "tokens", "first edit", "per edit", "relexed");
+    const std::string chunk = generateFunctions(200, 20);
+    double firstUs = 0;
+    bool flat = true;
+    for (size_t mb : sizesMb) {
+        std::string src;
+        while (src.size() < (mb << 20)) src += chunk;
+        size_t at = src.find("acc = acc", src.size() / 2) + 3;
+        std::vector<Token> expected = Lexer(src).tokenize();
+
+        double bestFirst = 0, bestEdit = 0;
+        size_t relexed = 0;
+        for (int r = 0; r < 3; ++r) {
+            Lexer lexer(src);
+            TokenBuffer tokens(lexer.tokenize());
+            auto start = std::chrono::steady_clock::now();
+            lexer.applyEdit(TextEdit{at, at, "x y\n"}, tokens);
+            auto typing = std::chrono::steady_clock::now();
+            relexed = 0;
+            for (int k = 0; k < typed; ++k) {
+                size_t pos = at + 4 + k;
+                relexed += lexer.applyEdit(TextEdit{pos, pos, k % 10 == 9 ? "\n" : "x"}, tokens);
+            }
+            for (int k = typed; k > 0; --k) {
+                size_t pos = at + 4 + k;
+                relexed += lexer.applyEdit(TextEdit{pos - 1, pos, ""}, tokens);
+            }
+            auto done = std::chrono::steady_clock::now();
+            lexer.applyEdit(TextEdit{at, at + 4, ""}, tokens);
+            std::chrono::duration<double, std::micro> first = typing - start;
+            std::chrono::duration<double, std::micro> session = done - typing;
+            double perEdit = session.count() / (2 * typed);
+            if (r == 0 || first.count() < bestFirst) bestFirst = first.count();
+            if (r == 0 || perEdit < bestEdit) bestEdit = perEdit;
+
+            // Back to the original text: the tokens must match a fresh lex.
+            std::vector<Token> now = tokens.toVector();
+            bool same = lexer.text() == src && now.size() == expected.size();
+            for (size_t i = 0; same && i < now.size(); ++i) {
+                same = now[i].type == expected[i].type && now[i].offset == expected[i].offset &&
+                       now[i].line == expected[i].line && now[i].lexeme == expected[i].lexeme;
+            }
+            if (!same) {
+                std::fprintf(stderr, "relex: tokens differ from a fresh lex at %zu MB\n", mb);
+                return 1;
+            }
+        }
+        if (mb == sizesMb.front()) firstUs = bestEdit;
+        std::printf("  %8zu %10zu %9.0f us %9.2f us %12.1f\n", mb, expected.size(), bestFirst,
+                    bestEdit, relexed / double(2 * typed));
+        // A few microseconds per edit; anything proportional to the file
+        // would be thousands of times slower at these sizes.
+        if (bestEdit > 3 * firstUs) flat = false;
+    }
+    if (!flat) {
+        std::fprintf(stderr, "relex: time per edit grows with the file size\n");
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================
+// parser — parseProgram() throughput
+// ============================================================
+//
+// Two inputs: the `semantic` program, which keeps to the grammar every
+// version of the parser accepts so runs compare like for like, and one of
+// structs, impl blocks and loops, which exercises the rest of it.
+static std::string generateItems(int count) {
+    std::string src;
+    for (int i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        src += "struct P" + n + " { x: i64, y: i64, tag: &str }\n";
+        src += "impl P" + n + " {\n";
+        src += "    fn norm(&self) -> i64 { return self.x * self.x + self.y * self.y; }\n";
+        src += "    fn scaled(&self, k: i64) -> i64 { return self.norm().min(k) * k; }\n";
+        src += "}\n";
+        src += "fn g" + n + "(p: &P" + n + ", n: i64) -> i64 {\n";
+        src += "    let mut s = 0;\n";
+        src += "    for i in 0..n {\n";
+        src += "        if i == 7 { continue; }\n";
+        src += "        s = s + p.scaled(i) + p.x;\n";
+        src += "    }\n";
+        src += "    loop { if s > 1000 { break; } s = s + 1; }\n";
+        src += "    return s;\n";
+        src += "}\n";
+    }
+    return src;
+}
+
+static int benchParser(int argc, char* argv[]) {
+    int functions = 5000;
+    int bodyLets = 20;
+    for (int i = 0; i < argc; ++i) {
+        if (const char* v = flagValue(argv[i], "--functions")) functions = std::atoi(v);
+        else if (const char* v = flagValue(argv[i], "--body")) bodyLets = std::atoi(v);
+    }
+    if (functions < 1) functions = 1;
+
+    struct Input { const char* name; std::string src; };
+    Input inputs[] = {
+        {"program", generateFunctions(functions, bodyLets)},
+        {"items", generateItems(functions * 4)},
+    };
+
+    std::printf("parser: parseProgram(), tree included\n");
+    std::printf("  %-10s %8s %10s %9s %8s\n", "input", "MB", "time", "MB/s", "errors");
+    for (const Input& in : inputs) {
+        size_t errors = 0;
+        double ms = bestOfMs(5, [&] {
+            Parser parser(in.src);
+            auto program = parser.parseProgram();
+            errors = parser.errors().size();
+        });
+        double mbs = in.src.size() / double(1 << 20);
+        std::printf("  %-10s %8.1f %7.1f ms %9.1f %8zu\n", in.name, mbs, ms, mbs / (ms / 1000.0),
+                    errors);
+    }
+    return 0;
+}
+
+static void printUsage() {
+    std::fprintf(stderr,
+                 "Usage: rustc_bench <benchmark> [options]\n"
+                 "  semantic [--functions=N] [--body=N] [--threads=N]\n"
+                 "  llvm [--functions=N] [--body=N] [--threads=N]\n"
+                 "  ast [--functions=N] [--body=N]\n"
+                 "  fuse [--functions=N] [--body=N] [--no-identities]\n"
+                 "  recovery [--mb=N] [--seed=N]\n"
+                 "  diag [--mb=N]\n"
+                 "  json [--functions=N] [--body=N]\n"
+                 "  lexer [--functions=N] [--body=N] [--mb=N]\n"
+                 "  relex [--mb=N]\n"
+                 "  parser [--functions=N] [--body=N]\n"
+                 "  ir <file.rs>...\n"
+                 "  vm <file.rs>...\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    std::string which = argv[1];
+    if (which == "semantic") return benchSemantic(argc - 2, argv + 2);
+    if (which == "llvm") return benchLlvm(argc - 2, argv + 2);
+    if (which == "fuse") return benchFuse(argc - 2, argv + 2);
+    if (which == "ast") return benchAst(argc - 2, argv + 2);
+    if (which == "recovery") return benchRecovery(argc - 2, argv + 2);
+    if (which == "diag") return benchDiag(argc - 2, argv + 2);
+    if (which == "json") return benchJson(argc - 2, argv + 2);
+    if (which == "lexer") return benchLexer(argc - 2, argv + 2);
+    if (which == "relex") return benchRelex(argc - 2, argv + 2);
+    if (which == "parser") return benchParser(argc - 2, argv + 2);
+    if (which == "ir") return benchIr(argc - 2, argv + 2);
+    if (which == "vm") return benchVm(argc - 2, argv + 2);
+    printUsage();
+    return 1;
+}
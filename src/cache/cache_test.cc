@@ -0,0 +1,256 @@
+#include "hash.h"
+#include "parse_cache.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// Fresh, empty cache directory unique to this test.
+static std::string tempCacheDir(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() /
+                   ("rustc_cache_test_" + std::to_string(getpid()) + "_" + name);
+    fs::remove_all(dir);
+    return dir.string();
+}
+
+static size_t entryCount(const std::string& dir) {
+    size_t n = 0;
+    for (auto& e : fs::directory_iterator(dir)) {
+        if (e.path().extension() == ".rpc") n++;
+    }
+    return n;
+}
+
+// ============================================================
+// hash64
+// ============================================================
+
+TEST(Hash, MatchesXxh64ReferenceValues) {
+    EXPECT_EQ(hash64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(hash64("a", 1), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(hash64("abc", 3), 0x44BC2CF5AD770999ULL);
+}
+
+TEST(Hash, LongInputUsesAllBytes) {
+    std::string a(1000, 'x');
+    std::string b = a;
+    b[999] = 'y';
+    EXPECT_NE(hash64(a.data(), a.size()), hash64(b.data(), b.size()));
+    EXPECT_NE(hash64(a.data(), a.size(), 0), hash64(a.data(), a.size(), 1));
+}
+
+// ============================================================
+// ParseCache
+// ============================================================
+
+TEST(ParseCache, MissThenHitReturnsSameTree) {
+    std::string dir = tempCacheDir("hit");
+    std::string src = "fn main() {\n    let x = 1 + 2;\n}\n";
+
+    Parser parser(src);
+    auto program = parser.parseProgram();
+
+    ParseCache cache(dir);
+    CachedParse result;
+    EXPECT_FALSE(cache.lookup(src, result));
+    cache.store(src, program.get(), parser.diagnostics());
+
+    ASSERT_TRUE(cache.lookup(src, result));
+    ASSERT_NE(result.program, nullptr);
+    EXPECT_TRUE(result.diagnostics.empty());
+    EXPECT_TRUE(astEqual(result.program.get(), program.get()));
+
+    EXPECT_EQ(cache.stats().hits, 1u);
+    EXPECT_EQ(cache.stats().misses, 1u);
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, StoresDiagnosticsForFailedParse) {
+    std::string dir = tempCacheDir("errors");
+    std::string src = "let = 1;";
+
+    Parser parser(src);
+    auto program = parser.parseProgram();
+    ASSERT_TRUE(parser.hasErrors());
+
+    ParseCache cache(dir);
+    cache.store(src, program.get(), parser.diagnostics());
+
+    CachedParse result;
+    ASSERT_TRUE(cache.lookup(src, result));
+    EXPECT_EQ(result.program, nullptr);
+    ASSERT_EQ(result.diagnostics.size(), parser.diagnostics().size());
+    EXPECT_EQ(formatDiagnostic(result.diagnostics[0], src), parser.errors()[0].message);
+    EXPECT_EQ(result.diagnostics[0].line, parser.errors()[0].line);
+    EXPECT_EQ(result.diagnostics[0].offset, parser.diagnostics()[0].offset);
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, DifferentSourceMisses) {
+    std::string dir = tempCacheDir("different");
+    Parser parser("let x = 1;");
+    auto program = parser.parseProgram();
+
+    ParseCache cache(dir);
+    cache.store("let x = 1;", program.get(), parser.diagnostics());
+
+    CachedParse result;
+    EXPECT_FALSE(cache.lookup("let x = 2;", result));
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, CorruptEntryIsDroppedAsMiss) {
+    std::string dir = tempCacheDir("corrupt");
+    std::string src = "let x = 1;";
+    Parser parser(src);
+    auto program = parser.parseProgram();
+
+    ParseCache cache(dir);
+    cache.store(src, program.get(), parser.diagnostics());
+    ASSERT_EQ(entryCount(dir), 1u);
+
+    // Flip the last byte of the entry
+    fs::path entry = fs::directory_iterator(dir)->path();
+    std::string bytes;
+    {
+        std::ifstream in(entry, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bytes.back() ^= 0x5A;
+    {
+        std::ofstream out(entry, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    CachedParse result;
+    EXPECT_FALSE(cache.lookup(src, result));
+    EXPECT_EQ(entryCount(dir), 0u);
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, EvictsLeastRecentlyUsedBeyondSizeLimit) {
+    std::string dir = tempCacheDir("evict");
+    std::string first = "fn a() { let x = 1; }";
+    std::string second = "fn b() { let y = 2; }";
+    std::string third = "fn c() { let z = 3; }";
+
+    // Size the limit to hold exactly two entries of this shape.
+    uint64_t entrySize;
+    {
+        ParseCache probe(dir, ~0ULL);
+        Parser p(first);
+        auto prog = p.parseProgram();
+        probe.store(first, prog.get(), p.diagnostics());
+        entrySize = fs::file_size(fs::directory_iterator(dir)->path());
+    }
+
+    // Age the first entry so modification times are strictly ordered.
+    fs::last_write_time(fs::directory_iterator(dir)->path(),
+                        fs::file_time_type::clock::now() - std::chrono::hours(1));
+
+    ParseCache cache(dir, entrySize * 2);
+    for (const std::string* src : {&second, &third}) {
+        Parser p(*src);
+        auto prog = p.parseProgram();
+        cache.store(*src, prog.get(), p.diagnostics());
+    }
+
+    CachedParse result;
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(entryCount(dir), 2u);
+    EXPECT_FALSE(cache.lookup(first, result));
+    EXPECT_TRUE(cache.lookup(third, result));
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, HitsCountAsUseAndExistingEntriesAreIndexed) {
+    std::string dir = tempCacheDir("recency");
+    std::string first = "fn a() { let x = 1; }";
+    std::string second = "fn b() { let y = 2; }";
+    std::string third = "fn c() { let z = 3; }";
+    auto storeIn = [](ParseCache& cache, const std::string& src) {
+        Parser p(src);
+        auto prog = p.parseProgram();
+        cache.store(src, prog.get(), p.diagnostics());
+    };
+
+    uint64_t entrySize;
+    {
+        ParseCache probe(dir, ~0ULL);
+        storeIn(probe, first);
+        storeIn(probe, second);
+        entrySize = fs::file_size(fs::directory_iterator(dir)->path());
+    }
+
+    // A new cache over the directory already accounts for both entries, and
+    // the hit on `first` makes `second` the one to go, whatever the mtimes say.
+    ParseCache cache(dir, entrySize * 2);
+    CachedParse result;
+    ASSERT_TRUE(cache.lookup(first, result));
+    storeIn(cache, third);
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(entryCount(dir), 2u);
+    EXPECT_TRUE(cache.lookup(first, result));
+    EXPECT_FALSE(cache.lookup(second, result));
+    EXPECT_TRUE(cache.lookup(third, result));
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, KeepsRecentEntriesInMemory) {
+    std::string dir = tempCacheDir("memory");
+    std::string src = "fn main() {\n    let x = 1 + 2;\n}\n";
+    Parser parser(src);
+    auto program = parser.parseProgram();
+
+    ParseCache cache(dir);
+    cache.keepInMemory(1 << 20);
+    cache.store(src, program.get(), parser.diagnostics());
+
+    // Served from memory even with the file gone.
+    for (auto& e : fs::directory_iterator(dir)) fs::remove(e.path());
+    CachedParse result;
+    ASSERT_TRUE(cache.lookup(src, result));
+    EXPECT_TRUE(astEqual(result.program.get(), program.get()));
+    EXPECT_EQ(cache.stats().memoryHits, 1u);
+
+    // Still checked against the source, and dropped when the limit shrinks.
+    EXPECT_FALSE(cache.lookup(src + " ", result));
+    cache.keepInMemory(0);
+    EXPECT_FALSE(cache.lookup(src, result));
+    EXPECT_EQ(cache.stats().hits, 1u);
+    fs::remove_all(dir);
+}
+
+TEST(ParseCache, ConcurrentLookupsAndStores) {
+    std::string dir = tempCacheDir("threads");
+    ParseCache cache(dir);
+    cache.keepInMemory(1 << 20);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 50; ++i) {
+                std::string src = "let x" + std::to_string((i + t) % 10) + " = 1;";
+                CachedParse result;
+                if (!cache.lookup(src, result)) {
+                    Parser parser(src);
+                    auto program = parser.parseProgram();
+                    cache.store(src, program.get(), parser.diagnostics());
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    CacheStats s = cache.stats();
+    EXPECT_EQ(s.hits + s.misses, 200u);
+    EXPECT_EQ(entryCount(dir), 10u);
+    fs::remove_all(dir);
+}
@@ -0,0 +1,95 @@
+#include "hash.h"
+#include <cstring>
+
+// ============================================================
+// XXH64 — see https://github.com/Cyan4973/xxHash (reference spec)
+// ============================================================
+
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+static inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round(0, val);
+    return acc * PRIME1 + PRIME4;
+}
+
+uint64_t hash64(const void* data, size_t len, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        // Four independent lanes keep the multiplier pipeline busy.
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = round(v1, read64(p));      p += 8;
+            v2 = round(v2, read64(p));      p += 8;
+            v3 = round(v3, read64(p));      p += 8;
+            v4 = round(v4, read64(p));      p += 8;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+
+    h += static_cast<uint64_t>(len);
+
+    // Tail: 8-byte, 4-byte, then single-byte steps
+    while (p + 8 <= end) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+        p++;
+    }
+
+    // Avalanche
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
@@ -0,0 +1,11 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit non-cryptographic hash (XXH64 algorithm). Used to key the parse
+// cache on source bytes — fast, well distributed, not collision resistant.
+uint64_t hash64(const void* data, size_t len, uint64_t seed = 0);
+
+#endif // HASH_H
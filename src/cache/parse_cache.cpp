@@ -0,0 +1,326 @@
+#include "parse_cache.h"
+#include "../ast/ast_serializer.h"
+#include "hash.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// Entry layout (little-endian host order, entries are not portable):
+//   magic[4] | source length u64 | source check hash u64 | payload hash u64 | payload
+// Payload: diagnostic count u32, diagnostics (code, line, offset, length,
+// arg: u32 each), then the serialized ProgramNode (a null node when errors
+// were recorded).
+static const char MAGIC[4] = {'R', 'P', 'C', '4'};
+static const size_t HEADER_SIZE = 4 + 3 * sizeof(uint64_t);
+static const char* ENTRY_EXT = ".rpc";
+
+// Different seeds for the file name and the in-entry check, so a 64-bit
+// collision on the name alone is not enough to load the wrong tree.
+static const uint64_t KEY_SEED = 0;
+static const uint64_t CHECK_SEED = 0x5253504152534531ULL;
+
+static void putU32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putU64(std::string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static bool getU32(const std::string& in, size_t& pos, uint32_t& v) {
+    if (in.size() - pos < sizeof(v)) return false;
+    std::memcpy(&v, in.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+static bool getU64(const std::string& in, size_t& pos, uint64_t& v) {
+    if (in.size() - pos < sizeof(v)) return false;
+    std::memcpy(&v, in.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+// ============================================================
+// Construction
+// ============================================================
+
+ParseCache::ParseCache(std::string dir, uint64_t maxBytes)
+    : dir_(std::move(dir)), maxBytes_(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+
+    // Index the entries already on disk, oldest modification time last.
+    struct DiskEntry {
+        fs::file_time_type mtime;
+        uint64_t key;
+        uint64_t size;
+    };
+    std::vector<DiskEntry> entries;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        const fs::path& p = it->path();
+        if (p.extension() != ENTRY_EXT) continue;
+        std::string stem = p.stem().string();
+        if (stem.size() != 16 || stem.find_first_not_of("0123456789abcdef") != std::string::npos) {
+            continue;
+        }
+        std::error_code sec;
+        uint64_t size = it->file_size(sec);
+        fs::file_time_type mtime = it->last_write_time(sec);
+        if (sec) continue;
+        entries.push_back(DiskEntry{mtime, std::stoull(stem, nullptr, 16), size});
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const DiskEntry& a, const DiskEntry& b) { return a.mtime > b.mtime; });
+    for (const DiskEntry& e : entries) {
+        disk_.emplace_back(e.key, e.size);
+        diskIndex_[e.key] = std::prev(disk_.end());
+        diskUsed_ += e.size;
+    }
+}
+
+CacheStats ParseCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string ParseCache::entryPath(uint64_t key) const {
+    static const char* HEX = "0123456789abcdef";
+    std::string name(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        name[i] = HEX[key & 0xF];
+        key >>= 4;
+    }
+    return (fs::path(dir_) / (name + ENTRY_EXT)).string();
+}
+
+// ============================================================
+// In-memory copies
+// ============================================================
+
+void ParseCache::keepInMemory(uint64_t maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memoryMax_ = maxBytes;
+    while (memoryUsed_ > memoryMax_) {
+        memoryUsed_ -= recent_.back().second->size();
+        recentIndex_.erase(recent_.back().first);
+        recent_.pop_back();
+    }
+}
+
+ParseCache::Entry ParseCache::recall(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = recentIndex_.find(key);
+    if (it == recentIndex_.end()) return nullptr;
+    recent_.splice(recent_.begin(), recent_, it->second);
+    return it->second->second;
+}
+
+void ParseCache::remember(uint64_t key, Entry data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data->size() > memoryMax_) return;
+    auto it = recentIndex_.find(key);
+    if (it != recentIndex_.end()) {
+        memoryUsed_ -= it->second->second->size();
+        recent_.erase(it->second);
+        recentIndex_.erase(it);
+    }
+    memoryUsed_ += data->size();
+    recent_.emplace_front(key, std::move(data));
+    recentIndex_[key] = recent_.begin();
+    while (memoryUsed_ > memoryMax_) {
+        memoryUsed_ -= recent_.back().second->size();
+        recentIndex_.erase(recent_.back().first);
+        recent_.pop_back();
+    }
+}
+
+void ParseCache::forget(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = recentIndex_.find(key);
+    if (it == recentIndex_.end()) return;
+    memoryUsed_ -= it->second->second->size();
+    recent_.erase(it->second);
+    recentIndex_.erase(it);
+}
+
+// ============================================================
+// On-disk index
+// ============================================================
+//
+// Sizes and recency of the entries on disk, so stores never rescan the
+// directory. Another process sharing the directory is only seen when this
+// one reads or misses its entries; eviction then corrects the index.
+
+// Called with mutex_ held. Records `key` as most recently used, `size` bytes.
+void ParseCache::touchOnDisk(uint64_t key, uint64_t size) {
+    auto it = diskIndex_.find(key);
+    if (it != diskIndex_.end()) {
+        diskUsed_ -= it->second->second;
+        it->second->second = size;
+        disk_.splice(disk_.begin(), disk_, it->second);
+    } else {
+        disk_.emplace_front(key, size);
+        diskIndex_[key] = disk_.begin();
+    }
+    diskUsed_ += size;
+}
+
+// Called with mutex_ held.
+void ParseCache::dropOnDisk(uint64_t key) {
+    auto it = diskIndex_.find(key);
+    if (it == diskIndex_.end()) return;
+    diskUsed_ -= it->second->second;
+    disk_.erase(it->second);
+    diskIndex_.erase(it);
+}
+
+// ============================================================
+// Lookup
+// ============================================================
+
+// Decodes the entry `data` into `out` if it is intact and was stored for `source`.
+static bool decodeEntry(const std::string& data, const std::string& source, CachedParse& out) {
+    size_t pos = 4;
+    uint64_t length = 0, check = 0, payloadHash = 0;
+    bool valid = data.size() >= HEADER_SIZE && std::memcmp(data.data(), MAGIC, 4) == 0 &&
+                 getU64(data, pos, length) && getU64(data, pos, check) &&
+                 getU64(data, pos, payloadHash) && length == source.size() &&
+                 check == hash64(source.data(), source.size(), CHECK_SEED) &&
+                 payloadHash == hash64(data.data() + HEADER_SIZE, data.size() - HEADER_SIZE);
+
+    CachedParse result;
+    uint32_t errorCount = 0;
+    valid = valid && getU32(data, pos, errorCount);
+    for (uint32_t i = 0; valid && i < errorCount; ++i) {
+        uint32_t code = 0, line = 0;
+        Diagnostic d{};
+        valid = getU32(data, pos, code) && getU32(data, pos, line) &&
+                getU32(data, pos, d.offset) && getU32(data, pos, d.length) &&
+                getU32(data, pos, d.arg) &&
+                code <= static_cast<uint32_t>(DiagCode::INTEGER_OUT_OF_RANGE);
+        if (valid) {
+            d.code = static_cast<DiagCode>(code);
+            d.line = static_cast<int32_t>(line);
+            result.diagnostics.push_back(d);
+        }
+    }
+    if (!valid) return false;
+    bool ok = false;
+    AstNodePtr root = deserializeAst(data, pos, ok);
+    if (!ok || (root && root->kind != NodeKind::PROGRAM)) return false;
+    if (root) result.program.reset(static_cast<ProgramNode*>(root.release()));
+    out = std::move(result);
+    return true;
+}
+
+bool ParseCache::lookup(const std::string& source, CachedParse& out) {
+    uint64_t key = hash64(source.data(), source.size(), KEY_SEED);
+    std::string path = entryPath(key);
+
+    Entry data = recall(key);
+    bool inMemory = data != nullptr;
+    if (!inMemory) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dropOnDisk(key);
+            stats_.misses++;
+            return false;
+        }
+        data = std::make_shared<const std::string>((std::istreambuf_iterator<char>(file)),
+                                                   std::istreambuf_iterator<char>());
+    }
+
+    if (!decodeEntry(*data, source, out)) {
+        // Stale format or corrupt entry: drop it and treat as a miss.
+        forget(key);
+        std::error_code ec;
+        if (!inMemory) fs::remove(path, ec);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!inMemory) dropOnDisk(key);
+        stats_.misses++;
+        return false;
+    }
+    if (!inMemory) remember(key, data);
+
+    // Bump the modification time so eviction sees this entry as recently used.
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    std::lock_guard<std::mutex> lock(mutex_);
+    touchOnDisk(key, data->size());
+    stats_.hits++;
+    if (inMemory) stats_.memoryHits++;
+    return true;
+}
+
+// ============================================================
+// Store + eviction
+// ============================================================
+
+void ParseCache::store(const std::string& source, const ProgramNode* program,
+                       const std::vector<Diagnostic>& diagnostics) {
+    std::string payload;
+    putU32(payload, static_cast<uint32_t>(diagnostics.size()));
+    for (const Diagnostic& d : diagnostics) {
+        putU32(payload, static_cast<uint32_t>(d.code));
+        putU32(payload, static_cast<uint32_t>(d.line));
+        putU32(payload, d.offset);
+        putU32(payload, d.length);
+        putU32(payload, d.arg);
+    }
+    serializeAst(diagnostics.empty() ? program : nullptr, payload);
+
+    std::string data(MAGIC, 4);
+    putU64(data, source.size());
+    putU64(data, hash64(source.data(), source.size(), CHECK_SEED));
+    putU64(data, hash64(payload.data(), payload.size()));
+    data.append(payload);
+
+    uint64_t key = hash64(source.data(), source.size(), KEY_SEED);
+    std::string path = entryPath(key);
+    static std::atomic<unsigned> counter{0};
+    std::string tmp = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(counter++);
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return;
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    uint64_t size = data.size();
+    remember(key, std::make_shared<const std::string>(std::move(data)));
+    std::lock_guard<std::mutex> lock(mutex_);
+    touchOnDisk(key, size);
+    stats_.stores++;
+    evict();
+}
+
+// Called with mutex_ held. Removes least recently used entries until the
+// indexed total fits; an entry another process already removed still counts
+// as evicted from the index.
+void ParseCache::evict() {
+    while (diskUsed_ > maxBytes_ && !disk_.empty()) {
+        uint64_t key = disk_.back().first;
+        std::error_code ec;
+        if (fs::remove(entryPath(key), ec)) stats_.evictions++;
+        dropOnDisk(key);
+    }
+}
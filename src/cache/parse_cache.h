@@ -0,0 +1,86 @@
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+
+#include "../ast/ast.h"
+#include "../parser/parser.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// CacheStats — counters reported by the driver's --stats output
+// ============================================================
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t memoryHits = 0;  // hits served from the in-memory copies (part of `hits`)
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;
+};
+
+// Result of a parse, as stored in and loaded from the cache.
+// On success `program` is set; when the source had errors only the
+// diagnostics are kept (unformatted: they are rendered against the source).
+struct CachedParse {
+    std::unique_ptr<ProgramNode> program;
+    std::vector<Diagnostic> diagnostics;
+};
+
+// ============================================================
+// ParseCache — on-disk cache keyed on a hash of the source bytes
+// ============================================================
+//
+// Safe to share between threads: lookups and stores may run concurrently.
+class ParseCache {
+public:
+    static constexpr uint64_t DEFAULT_MAX_BYTES = 64ULL * 1024 * 1024;
+
+    // `dir` is created if missing. Entries beyond `maxBytes` in total are
+    // evicted least-recently-used first. The directory is scanned once here;
+    // after that, sizes and recency are tracked in memory.
+    explicit ParseCache(std::string dir, uint64_t maxBytes = DEFAULT_MAX_BYTES);
+
+    // Also keeps up to `maxBytes` of recently used entries in memory, so a
+    // long-lived process (the compile server) skips the file read on a hit.
+    // 0, the default, keeps none.
+    void keepInMemory(uint64_t maxBytes);
+
+    // Returns true and fills `out` if an entry for `source` exists and is intact.
+    bool lookup(const std::string& source, CachedParse& out);
+
+    // Records the result of parsing `source`. Written to a temporary file and
+    // renamed into place, so concurrent readers never see partial entries.
+    void store(const std::string& source, const ProgramNode* program,
+               const std::vector<Diagnostic>& diagnostics);
+
+    CacheStats stats() const;
+
+private:
+    using Entry = std::shared_ptr<const std::string>;
+
+    std::string dir_;
+    uint64_t maxBytes_;
+    mutable std::mutex mutex_;  // guards everything below
+    CacheStats stats_;
+    uint64_t memoryMax_ = 0;
+    uint64_t memoryUsed_ = 0;
+    std::list<std::pair<uint64_t, Entry>> recent_;  // most recently used first
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Entry>>::iterator> recentIndex_;
+    uint64_t diskUsed_ = 0;
+    std::list<std::pair<uint64_t, uint64_t>> disk_;  // (key, file size), most recently used first
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, uint64_t>>::iterator> diskIndex_;
+
+    std::string entryPath(uint64_t key) const;
+    Entry recall(uint64_t key);
+    void remember(uint64_t key, Entry data);
+    void forget(uint64_t key);
+    void touchOnDisk(uint64_t key, uint64_t size);
+    void dropOnDisk(uint64_t key);
+    void evict();
+};
+
+#endif // PARSE_CACHE_H
@@ -0,0 +1,769 @@
+#include "codegen.h"
+#include "tac_printer.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+// ============================================================
+// Opcodes
+// ============================================================
+
+const char* opcodeToString(Opcode op) {
+    switch (op) {
+        case Opcode::CONST: return "CONST";
+        case Opcode::STR:   return "STR";
+        case Opcode::COPY:  return "COPY";
+        case Opcode::ADD:   return "ADD";
+        case Opcode::SUB:   return "SUB";
+        case Opcode::MUL:   return "MUL";
+        case Opcode::DIV:   return "DIV";
+        case Opcode::NEG:   return "NEG";
+        case Opcode::EQ:    return "EQ";
+        case Opcode::NE:    return "NE";
+        case Opcode::LT:    return "LT";
+        case Opcode::GT:    return "GT";
+        case Opcode::LE:    return "LE";
+        case Opcode::GE:    return "GE";
+        case Opcode::ARG:   return "ARG";
+        case Opcode::CALL:  return "CALL";
+        case Opcode::JMP:   return "JMP";
+        case Opcode::BR:    return "BR";
+        case Opcode::RET:   return "RET";
+        case Opcode::PHI:   return "PHI";
+        case Opcode::SWITCH: return "SWITCH";
+    }
+    return "UNKNOWN";
+}
+
+bool isTerminator(Opcode op) {
+    return op == Opcode::JMP || op == Opcode::BR || op == Opcode::SWITCH || op == Opcode::RET;
+}
+
+bool definesValue(Opcode op) {
+    return op != Opcode::ARG && !isTerminator(op);
+}
+
+// Maps a BinaryExprNode operator to its opcode.
+static Opcode binaryOpcode(const std::string& op) {
+    if (op == "+") return Opcode::ADD;
+    if (op == "-") return Opcode::SUB;
+    if (op == "*") return Opcode::MUL;
+    if (op == "/") return Opcode::DIV;
+    if (op == "==") return Opcode::EQ;
+    if (op == "!=") return Opcode::NE;
+    if (op == "<") return Opcode::LT;
+    if (op == ">") return Opcode::GT;
+    if (op == "<=") return Opcode::LE;
+    return Opcode::GE;
+}
+
+static bool containsAssign(const AstNode* node) {
+    if (!node) return false;
+    switch (node->kind) {
+        case NodeKind::ASSIGN_EXPR:
+            return true;
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<const BinaryExprNode*>(node);
+            return containsAssign(n->left.get()) || containsAssign(n->right.get());
+        }
+        case NodeKind::UNARY_EXPR:
+            return containsAssign(static_cast<const UnaryExprNode*>(node)->operand.get());
+        case NodeKind::CALL_EXPR:
+            for (const auto& arg : static_cast<const CallExprNode*>(node)->args) {
+                if (containsAssign(arg.get())) return true;
+            }
+            return false;
+        case NodeKind::BLOCK:
+        case NodeKind::IF_STMT:
+        case NodeKind::MATCH_EXPR:
+            return true;  // may hold any statement; assumed to assign
+        default:
+            return false;
+    }
+}
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+CodeGen::CodeGen(ProgramNode* root)
+    : root_(root) {}
+
+const std::vector<CodeGenError>& CodeGen::errors() const {
+    return errors_;
+}
+
+bool CodeGen::hasErrors() const {
+    return !errors_.empty();
+}
+
+IrModule CodeGen::lower() {
+    module_ = IrModule();
+    errors_.clear();
+    if (!root_) return std::move(module_);
+
+    scopes_.enterScope();
+    declareItems(root_->statements, "");
+    for (const auto& stmt : root_->statements) {
+        if (!stmt || stmt->kind != NodeKind::FN_DECL) continue;
+        auto* fn = static_cast<FnDeclNode*>(stmt.get());
+        uint32_t index = scopes_.lookupInCurrentScope(fn->name);
+        lowerFn(fn, scopes_.binding(index).symbol.id);
+    }
+    scopes_.exitScope();
+    return std::move(module_);
+}
+
+std::string CodeGen::emit() {
+    return emitTac(lower());
+}
+
+void CodeGen::recordError(const std::string& msg, int line) {
+    errors_.push_back(CodeGenError{msg, line});
+}
+
+// ============================================================
+// Function state
+// ============================================================
+
+uint32_t CodeGen::newValue(const std::string& name) {
+    fn_.valueNames.push_back(name);
+    return fn_.numValues++;
+}
+
+// Reserves a block id; its instructions start when startBlock() is called.
+uint32_t CodeGen::newBlock() {
+    fn_.blocks.push_back(IrBlock{0, 0});
+    return static_cast<uint32_t>(fn_.blocks.size() - 1);
+}
+
+// Closes the current block (which must be terminated) and opens `block`.
+void CodeGen::startBlock(uint32_t block) {
+    uint32_t pos = static_cast<uint32_t>(fn_.instrs.size());
+    if (current_ != IR_NONE) fn_.blocks[current_].end = pos;
+    fn_.blocks[block].begin = pos;
+    current_ = block;
+}
+
+bool CodeGen::terminated() const {
+    return fn_.instrs.size() > fn_.blocks[current_].begin && isTerminator(fn_.instrs.back().op);
+}
+
+// Code following a terminator (e.g. after `return`) is unreachable; it gets
+// a block of its own so later passes can drop it.
+void CodeGen::emitInstr(const Instr& instr) {
+    if (terminated()) startBlock(newBlock());
+    fn_.instrs.push_back(instr);
+}
+
+void CodeGen::emitInstr(Opcode op, uint32_t dest, uint32_t src1, uint32_t src2) {
+    emitInstr(Instr{op, dest, src1, src2});
+}
+
+// Closes the last block and renumbers blocks into layout order.
+void CodeGen::finishFunction() {
+    fn_.blocks[current_].end = static_cast<uint32_t>(fn_.instrs.size());
+    current_ = IR_NONE;
+
+    size_t count = fn_.blocks.size();
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return fn_.blocks[a].begin < fn_.blocks[b].begin;
+    });
+    std::vector<uint32_t> renumber(count);
+    std::vector<IrBlock> blocks(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        renumber[order[i]] = i;
+        blocks[i] = fn_.blocks[order[i]];
+    }
+    fn_.blocks.swap(blocks);
+    for (Instr& in : fn_.instrs) {
+        forEachTarget(fn_, in, [&](uint32_t& block) { block = renumber[block]; });
+    }
+}
+
+const CodeGen::Binding* CodeGen::resolve(const std::string& name) const {
+    uint32_t index = scopes_.lookup(name);
+    while (index != ScopeTable<Binding>::NONE) {
+        const auto& b = scopes_.binding(index);
+        if (index >= fnBase_ || b.symbol.isFn) return &b.symbol;
+        index = b.shadowed;
+    }
+    return nullptr;
+}
+
+// ============================================================
+// Items and statements
+// ============================================================
+
+// Functions are bound before the statements of their block are lowered, so
+// calls may precede the declaration. Each gets its module index up front.
+void CodeGen::declareItems(const std::vector<AstNodePtr>& statements, const std::string& prefix) {
+    for (const auto& stmt : statements) {
+        if (!stmt || stmt->kind != NodeKind::FN_DECL) continue;
+        auto* fn = static_cast<FnDeclNode*>(stmt.get());
+        uint32_t index = static_cast<uint32_t>(module_.functions.size());
+        module_.functions.emplace_back();
+        module_.functions.back().name = prefix + fn->name;
+        scopes_.declare(fn->name, Binding{true, index});
+    }
+}
+
+void CodeGen::lowerFn(FnDeclNode* node, uint32_t index) {
+    IrFunction outer = std::move(fn_);
+    uint32_t outerCurrent = current_;
+    uint32_t outerBase = fnBase_;
+    std::vector<LoopTargets> outerLoops = std::move(loops_);
+    loops_.clear();
+
+    fn_ = IrFunction();
+    fn_.name = module_.functions[index].name;
+    current_ = IR_NONE;
+    fnBase_ = scopes_.size();
+    scopes_.enterScope();
+
+    for (const auto& param : node->params) {
+        scopes_.declare(param.name, Binding{false, newValue(param.name)});
+    }
+    fn_.numParams = fn_.numValues;
+    startBlock(newBlock());
+    // Running off the end of the body returns its value.
+    uint32_t value = lowerExpr(node->body.get());
+    if (!terminated()) emitInstr(Opcode::RET, IR_NONE, value, IR_NONE);
+
+    scopes_.exitScope();
+    finishFunction();
+    module_.functions[index] = std::move(fn_);
+
+    fn_ = std::move(outer);
+    current_ = outerCurrent;
+    fnBase_ = outerBase;
+    loops_ = std::move(outerLoops);
+}
+
+void CodeGen::lowerStatements(const std::vector<AstNodePtr>& statements) {
+    for (const auto& stmt : statements) {
+        lowerStmt(stmt.get());
+    }
+}
+
+void CodeGen::lowerStmt(AstNode* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NodeKind::FN_DECL: {
+            auto* fn = static_cast<FnDeclNode*>(node);
+            uint32_t index = scopes_.lookupInCurrentScope(fn->name);
+            lowerFn(fn, scopes_.binding(index).symbol.id);
+            break;
+        }
+        case NodeKind::BLOCK:
+            lowerBlock(static_cast<BlockNode*>(node));
+            break;
+        case NodeKind::LET_STMT: {
+            auto* let = static_cast<LetStmtNode*>(node);
+            uint32_t init = valueOf(let->init.get());
+            uint32_t var = newValue(let->name);
+            emitInstr(Opcode::COPY, var, init, IR_NONE);
+            scopes_.declare(let->name, Binding{false, var});
+            break;
+        }
+        case NodeKind::RETURN_STMT: {
+            auto* ret = static_cast<ReturnStmtNode*>(node);
+            uint32_t value = ret->value ? valueOf(ret->value.get()) : IR_NONE;
+            emitInstr(Opcode::RET, IR_NONE, value, IR_NONE);
+            break;
+        }
+        case NodeKind::WHILE_STMT:
+            lowerWhile(static_cast<WhileStmtNode*>(node));
+            break;
+        case NodeKind::LOOP_STMT:
+            lowerLoop(static_cast<LoopStmtNode*>(node));
+            break;
+        case NodeKind::FOR_STMT:
+            lowerFor(static_cast<ForStmtNode*>(node));
+            break;
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT: {
+            if (loops_.empty()) {
+                recordError("Cannot lower a jump out of no loop", node->line);
+                break;
+            }
+            const LoopTargets& loop = loops_.back();
+            uint32_t target = node->kind == NodeKind::BREAK_STMT ? loop.breakTo : loop.continueTo;
+            emitInstr(Opcode::JMP, IR_NONE, target, IR_NONE);
+            break;
+        }
+        case NodeKind::STRUCT_DECL:
+        case NodeKind::IMPL_BLOCK:
+            break;  // no code of their own; methods are not lowered
+        case NodeKind::IF_STMT:
+            lowerIf(static_cast<IfStmtNode*>(node));
+            break;
+        case NodeKind::EXPR_STMT:
+            lowerExpr(static_cast<ExprStmtNode*>(node)->expr.get());
+            break;
+        default:
+            lowerExpr(node);
+            break;
+    }
+}
+
+// Returns the block's value, or IR_NONE if it has none.
+uint32_t CodeGen::lowerBlock(BlockNode* node) {
+    scopes_.enterScope();
+    declareItems(node->statements, fn_.name + ".");
+    lowerStatements(node->statements);
+    uint32_t value = lowerExpr(node->value.get());
+    scopes_.exitScope();
+    return value;
+}
+
+// The end of an if or match branch: its value, if any, goes to the shared
+// result, made on first use.
+void CodeGen::joinBranch(uint32_t value, uint32_t& result, uint32_t join) {
+    if (terminated()) return;
+    if (value != IR_NONE) {
+        if (result == IR_NONE) result = newValue();
+        emitInstr(Opcode::COPY, result, value, IR_NONE);
+    }
+    emitInstr(Opcode::JMP, IR_NONE, join, IR_NONE);
+}
+
+//        BR cond, then, else        (else = join when there is no else branch)
+// then:  ...; [r = COPY v1]; JMP join
+// else:  ...; [r = COPY v2]; JMP join
+// join:
+// Returns r, or IR_NONE when the branches have no values.
+uint32_t CodeGen::lowerIf(IfStmtNode* node) {
+    uint32_t cond = valueOf(node->condition.get());
+    uint32_t thenBlock = newBlock();
+    uint32_t elseBlock = node->elseBranch ? newBlock() : IR_NONE;
+    uint32_t join = newBlock();
+    emitInstr(Opcode::BR, elseBlock != IR_NONE ? elseBlock : join, cond, thenBlock);
+
+    uint32_t result = IR_NONE;
+    startBlock(thenBlock);
+    joinBranch(lowerExpr(node->thenBranch.get()), result, join);
+
+    if (elseBlock != IR_NONE) {
+        startBlock(elseBlock);
+        joinBranch(lowerExpr(node->elseBranch.get()), result, join);
+    }
+    startBlock(join);
+    return result;
+}
+
+// A SWITCH replaces a run of at least this many ranges whose table would be
+// at most half holes; shorter or sparser runs are tested range by range.
+static constexpr size_t MIN_TABLE_RANGES = 4;
+
+// Number of values in [low, high]; 0 for the full i64 range, as it wraps.
+static uint64_t valuesIn(int64_t low, int64_t high) {
+    return static_cast<uint64_t>(high) - static_cast<uint64_t>(low) + 1;
+}
+
+// The arms' values become ranges of consecutive values going to the same
+// arm. Dense runs of ranges become jump tables, and the rest are searched
+// with a balanced tree of LT tests, so a match costs O(log n) compares at
+// most. Each arm's code follows the tree:
+//        s = scrutinee; <tree>
+// arm0:  ...; [r = COPY v0]; JMP join
+// ...
+// join:
+// A value goes to the first arm listing it; values no range holds go to
+// the `_` arm (the join, in a program without one that did not pass
+// semantic analysis).
+uint32_t CodeGen::lowerMatch(MatchExprNode* node) {
+    uint32_t scrutinee = valueOf(node->scrutinee.get());
+    std::vector<uint32_t> armBlocks;
+    std::vector<std::pair<int64_t, uint32_t>> cases;  // (value, arm block)
+    uint32_t fallback = IR_NONE;
+    for (const auto& a : node->arms) {
+        auto* arm = static_cast<MatchArmNode*>(a.get());
+        armBlocks.push_back(newBlock());
+        if (fallback != IR_NONE) continue;  // unreachable after `_`
+        if (arm->patterns.empty()) fallback = armBlocks.back();
+        for (const auto& pattern : arm->patterns) {
+            int64_t value;
+            if (patternValue(pattern.get(), value)) cases.emplace_back(value, armBlocks.back());
+        }
+    }
+    uint32_t join = newBlock();
+    if (fallback == IR_NONE) fallback = join;
+
+    std::stable_sort(cases.begin(), cases.end(),
+                     [](const std::pair<int64_t, uint32_t>& a,
+                        const std::pair<int64_t, uint32_t>& b) { return a.first < b.first; });
+    CaseTree tree{scrutinee, {}, {}, fallback};
+    std::vector<CaseRange>& ranges = tree.ranges;
+    uint64_t remaining = 0;  // values in ranges[i..]
+    for (const auto& c : cases) {
+        if (!ranges.empty() && ranges.back().high == c.first) continue;  // a later duplicate
+        if (!ranges.empty() && ranges.back().block == c.second &&
+            ranges.back().high != INT64_MAX && ranges.back().high + 1 == c.first) {
+            ranges.back().high = c.first;
+        } else {
+            ranges.push_back(CaseRange{c.first, c.first, c.second});
+        }
+        remaining++;
+    }
+
+    // Greedily, the longest dense run from each range on. A run spanning
+    // more than 2 * remaining values cannot be dense, nor can longer ones.
+    for (size_t i = 0; i < ranges.size();) {
+        size_t end = i + 1;
+        uint64_t values = 0;
+        for (size_t j = i; j < ranges.size(); ++j) {
+            values += valuesIn(ranges[j].low, ranges[j].high);
+            uint64_t span = valuesIn(ranges[i].low, ranges[j].high) - 1;  // cannot wrap
+            if (span >= 2 * remaining) break;
+            if (span < 2 * values && j + 1 - i >= MIN_TABLE_RANGES) end = j + 1;
+        }
+        tree.clusters.push_back(CaseCluster{ranges[i].low, ranges[end - 1].high, i, end});
+        for (size_t j = i; j < end; ++j) remaining -= valuesIn(ranges[j].low, ranges[j].high);
+        i = end;
+    }
+    lowerCases(tree, 0, tree.clusters.size(), INT64_MIN, INT64_MAX);
+
+    uint32_t result = IR_NONE;
+    for (size_t i = 0; i < node->arms.size(); ++i) {
+        startBlock(armBlocks[i]);
+        auto* arm = static_cast<MatchArmNode*>(node->arms[i].get());
+        joinBranch(lowerExpr(arm->body.get()), result, join);
+    }
+    startBlock(join);
+    return result;
+}
+
+// Dispatches on clusters[first, last), knowing low <= scrutinee <= high.
+// Up to three clusters are tried one after another, which is no longer
+// than a tree over them; more split at the middle cluster's first value.
+void CodeGen::lowerCases(const CaseTree& tree, size_t first, size_t last, int64_t low,
+                         int64_t high) {
+    if (last - first > 3) {
+        size_t mid = first + (last - first) / 2;
+        int64_t pivot = tree.clusters[mid].low;
+        uint32_t cond = compare(Opcode::LT, tree.scrutinee, pivot);
+        uint32_t below = newBlock();
+        uint32_t above = newBlock();
+        emitInstr(Opcode::BR, above, cond, below);
+        startBlock(below);
+        lowerCases(tree, first, mid, low, pivot - 1);
+        startBlock(above);
+        lowerCases(tree, mid, last, pivot, high);
+        return;
+    }
+    if (first == last) {
+        emitInstr(Opcode::JMP, IR_NONE, tree.fallback, IR_NONE);
+        return;
+    }
+    for (size_t i = first; i < last; ++i) {
+        const CaseCluster& cluster = tree.clusters[i];
+        uint32_t miss = i + 1 < last ? newBlock() : tree.fallback;
+        if (cluster.last - cluster.first == 1) {
+            branchOnRange(tree.scrutinee, tree.ranges[cluster.first], low, high, miss);
+        } else {
+            jumpTable(tree, cluster, miss);
+        }
+        if (i + 1 < last) startBlock(miss);
+    }
+}
+
+//        [k = CONST low; index = SUB s, k]
+//        SWITCH index, table
+// The table has an entry per value of the cluster: its range's block, or
+// the fallback for a value no range holds. Values outside go to `miss`.
+void CodeGen::jumpTable(const CaseTree& tree, const CaseCluster& cluster, uint32_t miss) {
+    uint32_t index = tree.scrutinee;
+    if (cluster.low != 0) {
+        uint32_t k = newValue();
+        emitInstr(Instr::makeConst(k, cluster.low));
+        index = newValue();
+        emitInstr(Opcode::SUB, index, tree.scrutinee, k);
+    }
+    uint32_t table = static_cast<uint32_t>(fn_.switchTargets.size());
+    std::vector<uint32_t>& targets = fn_.switchTargets;
+    for (size_t r = cluster.first; r < cluster.last; ++r) {
+        const CaseRange& range = tree.ranges[r];
+        if (r > cluster.first) {
+            targets.insert(targets.end(), valuesIn(tree.ranges[r - 1].high, range.low) - 2,
+                           tree.fallback);
+        }
+        targets.insert(targets.end(), valuesIn(range.low, range.high), range.block);
+    }
+    uint32_t count = static_cast<uint32_t>(fn_.switchTargets.size()) - table;
+    fn_.switchTargets.push_back(miss);
+    emitInstr(Opcode::SWITCH, count, index, table);
+}
+
+// Jumps to the range's block if the scrutinee is in it, else to `miss`;
+// a bound the known [low, high] already implies is not tested.
+void CodeGen::branchOnRange(uint32_t scrutinee, const CaseRange& range, int64_t low,
+                            int64_t high, uint32_t miss) {
+    bool testLow = range.low > low;
+    bool testHigh = range.high < high;
+    if (!testLow && !testHigh) {
+        emitInstr(Opcode::JMP, IR_NONE, range.block, IR_NONE);
+        return;
+    }
+    if (testLow && testHigh && range.low == range.high) {
+        uint32_t equal = compare(Opcode::EQ, scrutinee, range.low);
+        emitInstr(Opcode::BR, miss, equal, range.block);
+        return;
+    }
+    if (testLow) {
+        uint32_t below = compare(Opcode::LT, scrutinee, range.low);
+        uint32_t next = testHigh ? newBlock() : range.block;
+        emitInstr(Opcode::BR, next, below, miss);
+        if (!testHigh) return;
+        startBlock(next);
+    }
+    uint32_t above = compare(Opcode::GT, scrutinee, range.high);
+    emitInstr(Opcode::BR, range.block, above, miss);
+}
+
+// cond = op value, constant
+uint32_t CodeGen::compare(Opcode op, uint32_t value, int64_t constant) {
+    uint32_t k = newValue();
+    emitInstr(Instr::makeConst(k, constant));
+    uint32_t cond = newValue();
+    emitInstr(op, cond, value, k);
+    return cond;
+}
+
+//        JMP head
+// head:  BR cond, body, exit
+// body:  ...; JMP head
+// exit:
+void CodeGen::lowerWhile(WhileStmtNode* node) {
+    uint32_t head = newBlock();
+    uint32_t body = newBlock();
+    uint32_t exit = newBlock();
+    if (!terminated()) emitInstr(Opcode::JMP, IR_NONE, head, IR_NONE);
+
+    startBlock(head);
+    uint32_t cond = valueOf(node->condition.get());
+    emitInstr(Opcode::BR, exit, cond, body);
+
+    startBlock(body);
+    loops_.push_back(LoopTargets{exit, head});
+    lowerStmt(node->body.get());
+    loops_.pop_back();
+    if (!terminated()) emitInstr(Opcode::JMP, IR_NONE, head, IR_NONE);
+
+    startBlock(exit);
+}
+
+//        JMP body
+// body:  ...; JMP body
+// exit:                         (reached by `break` only)
+void CodeGen::lowerLoop(LoopStmtNode* node) {
+    uint32_t body = newBlock();
+    uint32_t exit = newBlock();
+    if (!terminated()) emitInstr(Opcode::JMP, IR_NONE, body, IR_NONE);
+
+    startBlock(body);
+    loops_.push_back(LoopTargets{exit, body});
+    lowerStmt(node->body.get());
+    loops_.pop_back();
+    if (!terminated()) emitInstr(Opcode::JMP, IR_NONE, body, IR_NONE);
+
+    startBlock(exit);
+}
+
+// Over `start..end` (LT) or `start..=end` (LE); the bounds are evaluated
+// once, and an inclusive range stops at `end` instead of stepping past it:
+//        i = COPY start; end' = COPY end; JMP head
+// head:  c = LT i, end'; BR c, body, exit
+// body:  ...; JMP step
+// step:  [d = EQ i, end'; BR d, exit, next    next:]  (..= only)
+//        i = ADD i, 1; JMP head
+// exit:
+void CodeGen::lowerFor(ForStmtNode* node) {
+    if (!isRangeExpr(node->iterable.get())) {
+        recordError("Cannot lower 'for' over anything but a range", node->line);
+        return;
+    }
+    auto* range = static_cast<BinaryExprNode*>(node->iterable.get());
+    bool inclusive = range->op.size() == 3;
+    uint32_t start = valueOf(range->left.get());
+    uint32_t limit = valueOf(range->right.get());
+    uint32_t var = newValue(node->name);
+    emitInstr(Opcode::COPY, var, start, IR_NONE);
+    // A variable bound would otherwise be re-read at every test.
+    uint32_t end = newValue();
+    emitInstr(Opcode::COPY, end, limit, IR_NONE);
+
+    uint32_t head = newBlock();
+    uint32_t body = newBlock();
+    uint32_t step = newBlock();
+    uint32_t exit = newBlock();
+    emitInstr(Opcode::JMP, IR_NONE, head, IR_NONE);
+
+    startBlock(head);
+    uint32_t cond = newValue();
+    emitInstr(inclusive ? Opcode::LE : Opcode::LT, cond, var, end);
+    emitInstr(Opcode::BR, exit, cond, body);
+
+    startBlock(body);
+    scopes_.enterScope();
+    scopes_.declare(node->name, Binding{false, var});
+    loops_.push_back(LoopTargets{exit, step});
+    lowerStmt(node->body.get());
+    loops_.pop_back();
+    scopes_.exitScope();
+    if (!terminated()) emitInstr(Opcode::JMP, IR_NONE, step, IR_NONE);
+
+    startBlock(step);
+    if (inclusive) {
+        uint32_t next = newBlock();
+        uint32_t done = newValue();
+        emitInstr(Opcode::EQ, done, var, end);
+        emitInstr(Opcode::BR, next, done, exit);
+        startBlock(next);
+    }
+    uint32_t one = newValue();
+    emitInstr(Instr::makeConst(one, 1));
+    uint32_t sum = newValue();
+    emitInstr(Opcode::ADD, sum, var, one);
+    emitInstr(Opcode::COPY, var, sum, IR_NONE);
+    emitInstr(Opcode::JMP, IR_NONE, head, IR_NONE);
+
+    startBlock(exit);
+}
+
+// ============================================================
+// Expressions
+// ============================================================
+
+// Like lowerExpr(), for operand positions: a unit result is materialized
+// as the constant 0 so instruction operands always name a value.
+uint32_t CodeGen::valueOf(AstNode* node) {
+    uint32_t value = lowerExpr(node);
+    if (value != IR_NONE) return value;
+    value = newValue();
+    emitInstr(Instr::makeConst(value, 0));
+    return value;
+}
+
+// Returns the value holding the result, or IR_NONE for unit.
+uint32_t CodeGen::lowerExpr(AstNode* node) {
+    if (!node) return IR_NONE;
+
+    switch (node->kind) {
+        case NodeKind::NUMBER_LITERAL: {
+            auto* n = static_cast<NumberLiteralNode*>(node);
+            uint32_t dest = newValue();
+            emitInstr(Instr::makeConst(dest, literalValue(n)));
+            return dest;
+        }
+        case NodeKind::STRING_LITERAL: {
+            auto* n = static_cast<StringLiteralNode*>(node);
+            uint32_t dest = newValue();
+            emitInstr(Opcode::STR, dest, static_cast<uint32_t>(module_.strings.size()), IR_NONE);
+            module_.strings.push_back(n->value);
+            return dest;
+        }
+        case NodeKind::IDENT_EXPR: {
+            auto* n = static_cast<IdentExprNode*>(node);
+            if (n->name == "true" || n->name == "false") {
+                uint32_t dest = newValue();
+                emitInstr(Instr::makeConst(dest, n->name == "true" ? 1 : 0));
+                return dest;
+            }
+            const Binding* b = resolve(n->name);
+            if (!b || b->isFn) {
+                recordError("Cannot lower use of '" + n->name + "' as a value", n->line);
+                return IR_NONE;
+            }
+            return b->id;
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<AssignExprNode*>(node);
+            uint32_t value = valueOf(n->value.get());
+            const Binding* b = resolve(n->target);
+            if (!b || b->isFn) {
+                recordError("Cannot lower assignment to '" + n->target + "'", n->line);
+                return IR_NONE;
+            }
+            emitInstr(Opcode::COPY, b->id, value, IR_NONE);
+            return IR_NONE;
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<BinaryExprNode*>(node);
+            if (isRangeExpr(n)) {
+                recordError("Cannot lower a range outside a 'for' loop", n->line);
+                return IR_NONE;
+            }
+            uint32_t left = valueOf(n->left.get());
+            uint32_t right = valueOf(n->right.get());
+            uint32_t dest = newValue();
+            emitInstr(binaryOpcode(n->op), dest, left, right);
+            return dest;
+        }
+        case NodeKind::UNARY_EXPR: {
+            auto* n = static_cast<UnaryExprNode*>(node);
+            uint32_t operand = valueOf(n->operand.get());
+            uint32_t dest = newValue();
+            emitInstr(Opcode::NEG, dest, operand, IR_NONE);
+            return dest;
+        }
+        case NodeKind::CALL_EXPR: {
+            auto* n = static_cast<CallExprNode*>(node);
+            const Binding* b = resolve(n->callee);
+            if (!b || !b->isFn) {
+                recordError("Cannot lower call to '" + n->callee + "'", n->line);
+                return IR_NONE;
+            }
+            uint32_t callee = b->id;
+
+            // All arguments are evaluated before the first ARG, so ARGs of
+            // nested calls never interleave. A variable read directly as an
+            // argument is snapshotted if a later argument assigns.
+            size_t base = argStack_.size();
+            size_t count = n->args.size();
+            size_t lastAssign = count;
+            for (size_t i = count; i-- > 0;) {
+                if (containsAssign(n->args[i].get())) {
+                    lastAssign = i;
+                    break;
+                }
+            }
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t value = valueOf(n->args[i].get());
+                if (i < lastAssign && lastAssign != count && !fn_.valueNames[value].empty()) {
+                    uint32_t copy = newValue();
+                    emitInstr(Opcode::COPY, copy, value, IR_NONE);
+                    value = copy;
+                }
+                argStack_.push_back(value);
+            }
+            for (size_t i = base; i < argStack_.size(); ++i) {
+                emitInstr(Opcode::ARG, IR_NONE, argStack_[i], IR_NONE);
+            }
+            argStack_.resize(base);
+
+            uint32_t dest = newValue();
+            emitInstr(Opcode::CALL, dest, callee, static_cast<uint32_t>(count));
+            return dest;
+        }
+        case NodeKind::FIELD_EXPR:
+            recordError("Cannot lower field access '." +
+                        static_cast<FieldExprNode*>(node)->name + "'", node->line);
+            return IR_NONE;
+        case NodeKind::METHOD_CALL_EXPR:
+            recordError("Cannot lower method call '." +
+                        static_cast<MethodCallExprNode*>(node)->method + "()'", node->line);
+            return IR_NONE;
+        case NodeKind::BLOCK:
+            return lowerBlock(static_cast<BlockNode*>(node));
+        case NodeKind::IF_STMT:
+            return lowerIf(static_cast<IfStmtNode*>(node));
+        case NodeKind::MATCH_EXPR:
+            return lowerMatch(static_cast<MatchExprNode*>(node));
+        default:
+            return IR_NONE;
+    }
+}
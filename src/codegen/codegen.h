@@ -0,0 +1,116 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include "../ast/ast.h"
+#include "../semantic/scope_table.h"
+#include "ir.h"
+#include <string>
+#include <vector>
+
+// ============================================================
+// CodeGenError
+// ============================================================
+struct CodeGenError {
+    std::string message;
+    int line;
+};
+
+// ============================================================
+// CodeGen — lowers a checked AST to the TAC IR in ir.h
+// ============================================================
+//
+// Expects a program that passed semantic analysis. Every function,
+// including nested ones, becomes an IrFunction; top-level statements that
+// are not items are not lowered.
+class CodeGen {
+public:
+    explicit CodeGen(ProgramNode* root);
+
+    IrModule lower();
+
+    // lower() followed by emitTac().
+    std::string emit();
+
+    // Constructs lower() could not translate (functions used as values,
+    // field accesses, method calls, ranges outside a for loop, and names a
+    // checked program would not leave unresolved).
+    bool hasErrors() const;
+    const std::vector<CodeGenError>& errors() const;
+
+private:
+    struct Binding {
+        bool isFn;
+        uint32_t id;  // function index or value id
+    };
+
+    // Where `break` and `continue` jump to in an enclosing loop.
+    struct LoopTargets {
+        uint32_t breakTo;
+        uint32_t continueTo;
+    };
+
+    // Consecutive match values [low, high] that go to the same arm block.
+    struct CaseRange {
+        int64_t low;
+        int64_t high;
+        uint32_t block;
+    };
+
+    // ranges[first, last), covering [low, high]: one range is tested on its
+    // own, several dense ones become a SWITCH.
+    struct CaseCluster {
+        int64_t low;
+        int64_t high;
+        size_t first;
+        size_t last;
+    };
+
+    // What a match dispatches on; values in no range go to `fallback`.
+    struct CaseTree {
+        uint32_t scrutinee;
+        std::vector<CaseRange> ranges;
+        std::vector<CaseCluster> clusters;
+        uint32_t fallback;
+    };
+
+    ProgramNode* root_;
+    IrModule module_;
+    std::vector<CodeGenError> errors_;
+    IrFunction fn_;                 // function being lowered
+    uint32_t current_ = IR_NONE;    // block receiving instructions
+    ScopeTable<Binding> scopes_;
+    uint32_t fnBase_ = 0;           // see SemanticAnalyzer::fnBase_
+    std::vector<uint32_t> argStack_;  // argument values of calls being lowered
+    std::vector<LoopTargets> loops_;  // loops of fn_ around the current statement
+
+    uint32_t newValue(const std::string& name = std::string());
+    uint32_t newBlock();
+    void startBlock(uint32_t block);
+    void emitInstr(const Instr& instr);
+    void emitInstr(Opcode op, uint32_t dest, uint32_t src1, uint32_t src2);
+    bool terminated() const;
+    void finishFunction();
+    const Binding* resolve(const std::string& name) const;
+    void recordError(const std::string& msg, int line);
+
+    void declareItems(const std::vector<AstNodePtr>& statements, const std::string& prefix);
+    void lowerFn(FnDeclNode* node, uint32_t index);
+    void lowerStatements(const std::vector<AstNodePtr>& statements);
+    void lowerStmt(AstNode* node);
+    uint32_t lowerBlock(BlockNode* node);
+    uint32_t lowerIf(IfStmtNode* node);
+    uint32_t lowerMatch(MatchExprNode* node);
+    void lowerCases(const CaseTree& tree, size_t first, size_t last, int64_t low, int64_t high);
+    void jumpTable(const CaseTree& tree, const CaseCluster& cluster, uint32_t miss);
+    void branchOnRange(uint32_t scrutinee, const CaseRange& range, int64_t low, int64_t high,
+                       uint32_t miss);
+    uint32_t compare(Opcode op, uint32_t value, int64_t constant);
+    void joinBranch(uint32_t value, uint32_t& result, uint32_t join);
+    void lowerWhile(WhileStmtNode* node);
+    void lowerLoop(LoopStmtNode* node);
+    void lowerFor(ForStmtNode* node);
+    uint32_t valueOf(AstNode* node);
+    uint32_t lowerExpr(AstNode* node);
+};
+
+#endif // CODEGEN_H
@@ -0,0 +1,147 @@
+#ifndef IR_H
+#define IR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Opcode — one entry per TAC instruction
+// ============================================================
+//
+// Operand use per opcode (unused fields are IR_NONE):
+//   CONST  dest = imm                 imm split across src1 (low) / src2 (high 32 bits)
+//   STR    dest = strings[src1]
+//   COPY   dest = src1
+//   ADD .. DIV, EQ .. GE   dest = src1 <op> src2
+//   NEG    dest = -src1
+//   ARG    src1 is the next argument of the following CALL
+//   CALL   dest = functions[src1](<src2 preceding ARGs>)
+//   JMP    goto block src1
+//   BR     if src1 != 0 goto block src2 else goto block dest
+//   SWITCH goto block switchTargets[src2 + src1] if src1 < dest (unsigned),
+//          else goto block switchTargets[src2 + dest]: a jump table of dest
+//          entries followed by its default
+//   RET    return src1 (IR_NONE for unit)
+//   PHI    dest = the phiArgs[src1 .. src1+src2) entry whose block was the
+//          predecessor taken; only in SSA form, only at the start of a block
+enum class Opcode : uint8_t {
+    CONST,
+    STR,
+    COPY,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    NEG,
+    EQ,
+    NE,
+    LT,
+    GT,
+    LE,
+    GE,
+    ARG,
+    CALL,
+    JMP,
+    BR,
+    RET,
+    PHI,
+    SWITCH,
+};
+
+const char* opcodeToString(Opcode op);
+
+// EQ .. GE, whose result is 1 or 0.
+inline bool isComparison(Opcode op) {
+    return op >= Opcode::EQ && op <= Opcode::GE;
+}
+
+static constexpr uint32_t IR_NONE = 0xFFFFFFFFu;
+
+// ============================================================
+// Instr — fixed-size record; operands are value, block or table ids
+// ============================================================
+struct Instr {
+    Opcode op;
+    uint32_t dest;
+    uint32_t src1;
+    uint32_t src2;
+
+    int64_t imm() const {
+        return static_cast<int64_t>((static_cast<uint64_t>(src2) << 32) | src1);
+    }
+
+    static Instr makeConst(uint32_t dest, int64_t value) {
+        uint64_t bits = static_cast<uint64_t>(value);
+        return Instr{Opcode::CONST, dest, static_cast<uint32_t>(bits),
+                     static_cast<uint32_t>(bits >> 32)};
+    }
+};
+
+static_assert(sizeof(Instr) == 16, "Instr must stay a 16-byte record");
+
+// Incoming value of a PHI along the edge from `block`. IR_NONE when the
+// value is undefined on that path.
+struct PhiArg {
+    uint32_t block;
+    uint32_t value;
+};
+
+// Instructions [begin, end) of the owning function. The last one is always
+// a terminator (JMP, BR, SWITCH or RET).
+struct IrBlock {
+    uint32_t begin;
+    uint32_t end;
+};
+
+// ============================================================
+// IrFunction / IrModule
+// ============================================================
+//
+// Values are numbered densely from 0; the first `numParams` are the
+// parameters. Variables are values that may be assigned more than once
+// (COPY into them); temporaries are assigned exactly once. Blocks are
+// numbered in layout order and block 0 is the entry.
+struct IrFunction {
+    std::string name;  // unique within the module ("outer.inner" for nested fns)
+    uint32_t numParams = 0;
+    uint32_t numValues = 0;
+    std::vector<Instr> instrs;
+    std::vector<IrBlock> blocks;
+    std::vector<std::string> valueNames;  // source name of variables, "" for temporaries
+    std::vector<PhiArg> phiArgs;          // operands of PHI instructions (SSA form only)
+    std::vector<uint32_t> switchTargets;  // SWITCH tables, each followed by its default block
+};
+
+struct IrModule {
+    std::vector<IrFunction> functions;
+    std::vector<std::string> strings;  // contents of STR constants
+};
+
+bool isTerminator(Opcode op);
+
+// True for opcodes whose `dest` names a value (not ARG or a terminator).
+bool definesValue(Opcode op);
+
+// Calls f(block) for each jump target of `in`, by reference when `fn` and
+// `in` are mutable. A SWITCH passes every table entry and its default, so
+// a block may come more than once.
+template <typename Function, typename Instruction, typename F>
+void forEachTarget(Function& fn, Instruction& in, F&& f) {
+    switch (in.op) {
+        case Opcode::JMP:
+            f(in.src1);
+            return;
+        case Opcode::BR:
+            f(in.src2);
+            f(in.dest);
+            return;
+        case Opcode::SWITCH:
+            for (uint32_t k = 0; k <= in.dest; ++k) f(fn.switchTargets[in.src2 + k]);
+            return;
+        default:
+            return;
+    }
+}
+
+#endif // IR_H
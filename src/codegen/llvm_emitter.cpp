@@ -0,0 +1,349 @@
+#include "llvm_emitter.h"
+#include "../util/thread_pool.h"
+#include <unordered_map>
+#include <vector>
+
+// Division helper: LLVM's sdiv is undefined for both cases the VM defines.
+// The leading '.' keeps it apart from every source function name.
+static const char* DIV_HELPER = R"(define internal i64 @.sdiv(i64 %a, i64 %b) {
+entry:
+  %zero = icmp eq i64 %b, 0
+  br i1 %zero, label %fail, label %check
+check:
+  %minus1 = icmp eq i64 %b, -1
+  br i1 %minus1, label %negate, label %divide
+negate:
+  %n = sub i64 0, %a
+  ret i64 %n
+divide:
+  %q = sdiv i64 %a, %b
+  ret i64 %q
+fail:
+  call void @llvm.trap()
+  unreachable
+}
+
+declare void @llvm.trap()
+)";
+
+// `sigil` and `name`, in quotes unless the name is a plain LLVM identifier:
+// source identifiers may have any XID character (`@"café"`), and never
+// contain the '"' or '\\' that would need escaping.
+static std::string llvmName(char sigil, const std::string& name) {
+    bool plain = !name.empty() && !(name[0] >= '0' && name[0] <= '9');
+    for (char c : name) {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                  c == '_' || c == '.' || c == '$' || c == '-';
+        if (!ok) plain = false;
+    }
+    return plain ? sigil + name : sigil + ("\"" + name + "\"");
+}
+
+static const char* icmpPredicate(Opcode op) {
+    switch (op) {
+        case Opcode::EQ: return "eq";
+        case Opcode::NE: return "ne";
+        case Opcode::LT: return "slt";
+        case Opcode::GT: return "sgt";
+        case Opcode::LE: return "sle";
+        default:         return "sge";
+    }
+}
+
+static const char* arithmetic(Opcode op) {
+    switch (op) {
+        case Opcode::ADD: return "add";
+        case Opcode::SUB: return "sub";
+        default:          return "mul";
+    }
+}
+
+// ============================================================
+// Functions
+// ============================================================
+//
+// Names: parameters keep their source name, variable allocas are
+// `%name.addr` (`%name.1.addr` for a second variable of the same name),
+// blocks are `%bb.N`; since identifiers contain no '.', none of these can
+// collide. Everything else is numbered (%0, %1, ...) in order.
+
+namespace {
+
+class FunctionWriter {
+public:
+    FunctionWriter(const IrModule& module, const IrFunction& fn, std::string& out)
+        : module_(module), fn_(fn), out_(out), inSlot_(fn.numValues, false),
+          slotName_(fn.numValues), text_(fn.numValues) {}
+
+    void write();
+
+private:
+    const IrModule& module_;
+    const IrFunction& fn_;
+    std::string& out_;
+    std::vector<bool> inSlot_;             // lives in an alloca
+    std::vector<std::string> slotName_;
+    std::vector<std::string> text_;        // operand text of a register value
+    uint32_t next_ = 0;                    // next numbered value
+
+    void classify();
+    std::string fresh() { return "%" + std::to_string(next_++); }
+    std::string read(uint32_t v);
+    void define(uint32_t v, const std::string& value);
+    static std::string block(uint32_t b) { return "%bb." + std::to_string(b); }
+};
+
+// A value can stay a register if it is assigned once and only used later
+// in the same block; parameters can if they are never re-assigned.
+void FunctionWriter::classify() {
+    std::vector<uint32_t> defs(fn_.numValues, 0), defBlock(fn_.numValues, IR_NONE),
+        defIndex(fn_.numValues, 0);
+    for (uint32_t b = 0; b < fn_.blocks.size(); ++b) {
+        for (uint32_t i = fn_.blocks[b].begin; i < fn_.blocks[b].end; ++i) {
+            const Instr& in = fn_.instrs[i];
+            if (!definesValue(in.op)) continue;
+            defs[in.dest]++;
+            defBlock[in.dest] = b;
+            defIndex[in.dest] = i;
+        }
+    }
+    for (uint32_t v = 0; v < fn_.numValues; ++v) {
+        if (v < fn_.numParams ? defs[v] > 0 : defs[v] != 1) inSlot_[v] = true;
+    }
+    auto use = [&](uint32_t v, uint32_t b, uint32_t i) {
+        if (v >= fn_.numParams && (defBlock[v] != b || defIndex[v] >= i)) inSlot_[v] = true;
+    };
+    for (uint32_t b = 0; b < fn_.blocks.size(); ++b) {
+        for (uint32_t i = fn_.blocks[b].begin; i < fn_.blocks[b].end; ++i) {
+            const Instr& in = fn_.instrs[i];
+            switch (in.op) {
+                case Opcode::CONST: case Opcode::STR: case Opcode::CALL: case Opcode::JMP:
+                case Opcode::PHI:
+                    break;
+                case Opcode::COPY: case Opcode::NEG: case Opcode::ARG: case Opcode::BR:
+                case Opcode::SWITCH:
+                    use(in.src1, b, i);
+                    break;
+                case Opcode::RET:
+                    if (in.src1 != IR_NONE) use(in.src1, b, i);
+                    break;
+                default:
+                    use(in.src1, b, i);
+                    use(in.src2, b, i);
+                    break;
+            }
+        }
+    }
+
+    std::unordered_map<std::string, int> seen;
+    for (uint32_t v = 0; v < fn_.numValues; ++v) {
+        const std::string& name = v < fn_.valueNames.size() ? fn_.valueNames[v] : std::string();
+        std::string label = name;
+        if (!name.empty()) {
+            int n = seen[name]++;
+            if (n) label += "." + std::to_string(n);
+        } else if (v < fn_.numParams) {
+            label = "arg" + std::to_string(v);
+        }
+        if (v < fn_.numParams) text_[v] = llvmName('%', label);
+        if (inSlot_[v] && !label.empty()) slotName_[v] = llvmName('%', label + ".addr");
+    }
+}
+
+std::string FunctionWriter::read(uint32_t v) {
+    if (!inSlot_[v]) return text_[v];
+    std::string r = fresh();
+    out_ += "  " + r + " = load i64, i64* " + slotName_[v] + "\n";
+    return r;
+}
+
+void FunctionWriter::define(uint32_t v, const std::string& value) {
+    if (inSlot_[v]) out_ += "  store i64 " + value + ", i64* " + slotName_[v] + "\n";
+    else text_[v] = value;
+}
+
+void FunctionWriter::write() {
+    classify();
+
+    out_ += "define i64 " + llvmName('@', fn_.name) + "(";
+    for (uint32_t p = 0; p < fn_.numParams; ++p) {
+        if (p) out_ += ", ";
+        out_ += "i64 " + text_[p];
+    }
+    out_ += ") {\n";
+
+    // Uses per value, to spot comparisons that only feed the next branch.
+    std::vector<uint32_t> uses(fn_.numValues, 0);
+    for (const Instr& in : fn_.instrs) {
+        if (in.op == Opcode::BR || in.op == Opcode::SWITCH || in.op == Opcode::COPY ||
+            in.op == Opcode::NEG || in.op == Opcode::ARG) {
+            uses[in.src1]++;
+        } else if (in.op == Opcode::RET) {
+            if (in.src1 != IR_NONE) uses[in.src1]++;
+        } else if (in.op >= Opcode::ADD && in.op <= Opcode::GE) {
+            uses[in.src1]++;
+            uses[in.src2]++;
+        }
+    }
+
+    out_ += "bb.entry:\n";
+    for (uint32_t v = 0; v < fn_.numValues; ++v) {
+        if (!inSlot_[v]) continue;
+        if (slotName_[v].empty()) slotName_[v] = fresh();
+        out_ += "  " + slotName_[v] + " = alloca i64\n";
+        if (v < fn_.numParams) out_ += "  store i64 " + text_[v] + ", i64* " + slotName_[v] + "\n";
+    }
+    out_ += "  br label " + block(0) + "\n";
+
+    std::vector<std::string> args;
+    for (uint32_t b = 0; b < fn_.blocks.size(); ++b) {
+        out_ += "bb." + std::to_string(b) + ":\n";
+        const IrBlock& range = fn_.blocks[b];
+        std::string fusedCond;  // i1 of a comparison only the terminator reads
+        for (uint32_t i = range.begin; i < range.end; ++i) {
+            const Instr& in = fn_.instrs[i];
+            switch (in.op) {
+                case Opcode::CONST:
+                    define(in.dest, std::to_string(in.imm()));
+                    break;
+                case Opcode::STR:
+                    define(in.dest, std::to_string(in.src1));
+                    break;
+                case Opcode::COPY:
+                    if (in.dest != in.src1) define(in.dest, read(in.src1));
+                    break;
+                case Opcode::NEG: {
+                    std::string x = read(in.src1);
+                    std::string r = fresh();
+                    out_ += "  " + r + " = sub i64 0, " + x + "\n";
+                    define(in.dest, r);
+                    break;
+                }
+                case Opcode::ADD: case Opcode::SUB: case Opcode::MUL: case Opcode::DIV: {
+                    std::string x = read(in.src1), y = read(in.src2);
+                    std::string r = fresh();
+                    if (in.op == Opcode::DIV) {
+                        out_ += "  " + r + " = call i64 @.sdiv(i64 " + x + ", i64 " + y + ")\n";
+                    } else {
+                        out_ += "  " + r + " = " + arithmetic(in.op) + " i64 " + x + ", " + y + "\n";
+                    }
+                    define(in.dest, r);
+                    break;
+                }
+                case Opcode::ARG:
+                    args.push_back(read(in.src1));
+                    break;
+                case Opcode::CALL: {
+                    std::string r = fresh();
+                    out_ += "  " + r + " = call i64 " +
+                            llvmName('@', module_.functions[in.src1].name) + "(";
+                    for (size_t k = 0; k < args.size(); ++k) {
+                        if (k) out_ += ", ";
+                        out_ += "i64 " + args[k];
+                    }
+                    out_ += ")\n";
+                    args.clear();
+                    define(in.dest, r);
+                    break;
+                }
+                case Opcode::JMP:
+                    out_ += "  br label " + block(in.src1) + "\n";
+                    break;
+                case Opcode::BR: {
+                    std::string cond = fusedCond;
+                    if (cond.empty()) {
+                        std::string x = read(in.src1);
+                        cond = fresh();
+                        out_ += "  " + cond + " = icmp ne i64 " + x + ", 0\n";
+                    }
+                    out_ += "  br i1 " + cond + ", label " + block(in.src2) + ", label " +
+                            block(in.dest) + "\n";
+                    break;
+                }
+                case Opcode::SWITCH: {
+                    std::string x = read(in.src1);
+                    out_ += "  switch i64 " + x + ", label " +
+                            block(fn_.switchTargets[in.src2 + in.dest]) + " [";
+                    for (uint32_t k = 0; k < in.dest; ++k) {
+                        out_ += "\n    i64 " + std::to_string(k) + ", label " +
+                                block(fn_.switchTargets[in.src2 + k]);
+                    }
+                    out_ += "\n  ]\n";
+                    break;
+                }
+                case Opcode::RET:
+                    out_ += "  ret i64 " + (in.src1 == IR_NONE ? std::string("0") : read(in.src1)) + "\n";
+                    break;
+                case Opcode::PHI:
+                    // Not expected (see llvm_emitter.h); keep the output well-formed.
+                    out_ += "  ; PHI left in the input\n";
+                    define(in.dest, "undef");
+                    break;
+                default: {
+                    // EQ .. GE
+                    std::string x = read(in.src1), y = read(in.src2);
+                    std::string c = fresh();
+                    out_ += "  " + c + " = icmp " + icmpPredicate(in.op) + " i64 " + x + ", " + y + "\n";
+                    const Instr& nextInstr = fn_.instrs[i + 1];
+                    if (i + 2 == range.end && nextInstr.op == Opcode::BR && nextInstr.src1 == in.dest &&
+                        uses[in.dest] == 1 && !inSlot_[in.dest]) {
+                        fusedCond = c;
+                        break;
+                    }
+                    std::string r = fresh();
+                    out_ += "  " + r + " = zext i1 " + c + " to i64\n";
+                    define(in.dest, r);
+                    break;
+                }
+            }
+        }
+    }
+    out_ += "}\n";
+}
+
+}  // namespace
+
+void emitLlvmFunction(const IrModule& module, const IrFunction& fn, std::string& out) {
+    FunctionWriter(module, fn, out).write();
+}
+
+// ============================================================
+// Modules
+// ============================================================
+
+static std::string assemble(const IrModule& module, const std::vector<std::string>& functions) {
+    bool divides = false;
+    for (const IrFunction& fn : module.functions) {
+        for (const Instr& in : fn.instrs) divides = divides || in.op == Opcode::DIV;
+    }
+    size_t size = 0;
+    for (const std::string& f : functions) size += f.size() + 1;
+    std::string out;
+    out.reserve(size + 64);
+    out += "; generated by rustc --emit=llvm\n";
+    for (const std::string& f : functions) {
+        out += "\n";
+        out += f;
+    }
+    if (divides) {
+        out += "\n";
+        out += DIV_HELPER;
+    }
+    return out;
+}
+
+std::string emitLlvm(const IrModule& module) {
+    std::vector<std::string> functions(module.functions.size());
+    for (size_t i = 0; i < functions.size(); ++i) {
+        emitLlvmFunction(module, module.functions[i], functions[i]);
+    }
+    return assemble(module, functions);
+}
+
+std::string emitLlvmParallel(const IrModule& module, ThreadPool& pool) {
+    std::vector<std::string> functions(module.functions.size());
+    pool.parallelFor(functions.size(), [&](size_t i, unsigned) {
+        emitLlvmFunction(module, module.functions[i], functions[i]);
+    });
+    return assemble(module, functions);
+}
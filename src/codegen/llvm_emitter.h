@@ -0,0 +1,30 @@
+#ifndef LLVM_EMITTER_H
+#define LLVM_EMITTER_H
+
+#include "ir.h"
+#include <string>
+
+class ThreadPool;
+
+// ============================================================
+// LLVM IR text (.ll) — no LLVM library needed
+// ============================================================
+//
+// Every IrFunction becomes a `define i64`, every IR block a basic block
+// (`bb.0`, `bb.1`, ...) behind a fresh `bb.entry` block that holds the
+// allocas.
+// Values re-assigned with COPY, or used outside the block that defines
+// them, live in an alloca (mem2reg turns them back into registers); the
+// rest stay SSA registers, and constants and copies are folded into their
+// uses. Arithmetic wraps like the VM's; division goes through a helper
+// that traps on zero and wraps INT64_MIN / -1. Expects IR not in SSA form.
+std::string emitLlvm(const IrModule& module);
+
+// Same output, with the functions emitted concurrently into separate
+// buffers and concatenated in module order.
+std::string emitLlvmParallel(const IrModule& module, ThreadPool& pool);
+
+// Renders a single function; `module` supplies callee names.
+void emitLlvmFunction(const IrModule& module, const IrFunction& fn, std::string& out);
+
+#endif // LLVM_EMITTER_H
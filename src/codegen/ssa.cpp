@@ -0,0 +1,873 @@
+#include "ssa.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// Writes the distinct successor blocks of `block` to `out`: a BR's in
+// then / else order, a SWITCH's sorted.
+static void successors(const IrFunction& fn, uint32_t block, std::vector<uint32_t>& out) {
+    out.clear();
+    forEachTarget(fn, fn.instrs[fn.blocks[block].end - 1],
+                  [&](uint32_t target) { out.push_back(target); });
+    if (out.size() == 2 && out[0] == out[1]) {
+        out.pop_back();
+    } else if (out.size() > 2) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+static std::vector<std::vector<uint32_t>> successorLists(const IrFunction& fn) {
+    std::vector<std::vector<uint32_t>> succs(fn.blocks.size());
+    for (uint32_t b = 0; b < fn.blocks.size(); ++b) successors(fn, b, succs[b]);
+    return succs;
+}
+
+static std::vector<std::vector<uint32_t>> predecessors(const IrFunction& fn) {
+    std::vector<std::vector<uint32_t>> preds(fn.blocks.size());
+    std::vector<uint32_t> succ;
+    for (uint32_t b = 0; b < fn.blocks.size(); ++b) {
+        successors(fn, b, succ);
+        for (uint32_t s : succ) preds[s].push_back(b);
+    }
+    return preds;
+}
+
+// Calls f(operand) for every value operand of `in`, by reference.
+template <typename F>
+static void forEachUse(IrFunction& fn, Instr& in, F&& f) {
+    switch (in.op) {
+        case Opcode::CONST:
+        case Opcode::STR:
+        case Opcode::CALL:
+        case Opcode::JMP:
+            return;
+        case Opcode::COPY:
+        case Opcode::NEG:
+        case Opcode::ARG:
+        case Opcode::BR:
+        case Opcode::SWITCH:
+            f(in.src1);
+            return;
+        case Opcode::RET:
+            if (in.src1 != IR_NONE) f(in.src1);
+            return;
+        case Opcode::PHI:
+            for (uint32_t k = 0; k < in.src2; ++k) {
+                uint32_t& value = fn.phiArgs[in.src1 + k].value;
+                if (value != IR_NONE) f(value);
+            }
+            return;
+        default:
+            f(in.src1);
+            f(in.src2);
+            return;
+    }
+}
+
+static uint32_t addValue(IrFunction& fn, std::string name) {
+    fn.valueNames.push_back(std::move(name));
+    return fn.numValues++;
+}
+
+// Drops the instructions with keep[i] == 0 and shrinks the block ranges.
+static void keepInstrs(IrFunction& fn, const std::vector<char>& keep) {
+    uint32_t out = 0;
+    for (IrBlock& block : fn.blocks) {
+        uint32_t begin = out;
+        for (uint32_t i = block.begin; i < block.end; ++i) {
+            if (keep[i]) fn.instrs[out++] = fn.instrs[i];
+        }
+        block.begin = begin;
+        block.end = out;
+    }
+    fn.instrs.resize(out);
+}
+
+// Renumbers values so that only defined or used ones remain; parameters keep 0..numParams-1.
+static void compactValues(IrFunction& fn) {
+    std::vector<uint32_t> remap(fn.numValues, IR_NONE);
+    for (uint32_t p = 0; p < fn.numParams; ++p) remap[p] = 0;
+    for (Instr& in : fn.instrs) {
+        if (definesValue(in.op)) remap[in.dest] = 0;
+        forEachUse(fn, in, [&](uint32_t& v) { remap[v] = 0; });
+    }
+    std::vector<std::string> names;
+    for (uint32_t v = 0; v < fn.numValues; ++v) {
+        if (remap[v] == IR_NONE) continue;
+        remap[v] = static_cast<uint32_t>(names.size());
+        names.push_back(std::move(fn.valueNames[v]));
+    }
+    for (Instr& in : fn.instrs) {
+        if (definesValue(in.op)) in.dest = remap[in.dest];
+        forEachUse(fn, in, [&](uint32_t& v) { v = remap[v]; });
+    }
+    fn.numValues = static_cast<uint32_t>(names.size());
+    fn.valueNames.swap(names);
+}
+
+// ============================================================
+// Unreachable blocks
+// ============================================================
+
+uint32_t removeUnreachableBlocks(IrFunction& fn) {
+    uint32_t n = static_cast<uint32_t>(fn.blocks.size());
+    std::vector<char> reached(n, 0);
+    std::vector<uint32_t> work{0};
+    reached[0] = 1;
+    std::vector<uint32_t> succ;
+    while (!work.empty()) {
+        uint32_t b = work.back();
+        work.pop_back();
+        successors(fn, b, succ);
+        for (uint32_t s : succ) {
+            if (!reached[s]) {
+                reached[s] = 1;
+                work.push_back(s);
+            }
+        }
+    }
+
+    // Compact the surviving blocks, keeping their layout order.
+    std::vector<uint32_t> remap(n, IR_NONE);
+    std::vector<Instr> instrs;
+    std::vector<IrBlock> blocks;
+    instrs.reserve(fn.instrs.size());
+    for (uint32_t b = 0; b < n; ++b) {
+        if (!reached[b]) continue;
+        remap[b] = static_cast<uint32_t>(blocks.size());
+        uint32_t begin = static_cast<uint32_t>(instrs.size());
+        instrs.insert(instrs.end(), fn.instrs.begin() + fn.blocks[b].begin,
+                      fn.instrs.begin() + fn.blocks[b].end);
+        blocks.push_back(IrBlock{begin, static_cast<uint32_t>(instrs.size())});
+    }
+    uint32_t removed = n - static_cast<uint32_t>(blocks.size());
+    fn.instrs.swap(instrs);
+    fn.blocks.swap(blocks);
+
+    for (Instr& in : fn.instrs) {
+        forEachTarget(fn, in, [&](uint32_t& block) { block = remap[block]; });
+    }
+
+    // PHI operands must match the remaining incoming edges exactly.
+    if (fn.phiArgs.empty()) return removed;
+    auto preds = predecessors(fn);
+    std::vector<PhiArg> args;
+    for (uint32_t b = 0; b < fn.blocks.size(); ++b) {
+        for (uint32_t i = fn.blocks[b].begin; i < fn.blocks[b].end; ++i) {
+            Instr& in = fn.instrs[i];
+            if (in.op != Opcode::PHI) continue;
+            uint32_t first = static_cast<uint32_t>(args.size());
+            for (uint32_t k = 0; k < in.src2; ++k) {
+                PhiArg arg = fn.phiArgs[in.src1 + k];
+                arg.block = remap[arg.block];
+                if (arg.block == IR_NONE) continue;
+                if (std::find(preds[b].begin(), preds[b].end(), arg.block) == preds[b].end()) {
+                    continue;
+                }
+                args.push_back(arg);
+            }
+            in.src1 = first;
+            in.src2 = static_cast<uint32_t>(args.size()) - first;
+        }
+    }
+    fn.phiArgs.swap(args);
+    return removed;
+}
+
+// ============================================================
+// SSA construction
+// ============================================================
+
+namespace {
+
+// Dominator tree and dominance frontiers of a function whose blocks are all reachable.
+struct Dominance {
+    std::vector<uint32_t> idom;
+    std::vector<std::vector<uint32_t>> children;
+    std::vector<std::vector<uint32_t>> frontier;
+};
+
+}  // namespace
+
+// Cooper, Harvey & Kennedy, "A Simple, Fast Dominance Algorithm".
+static Dominance computeDominance(const IrFunction& fn,
+                                  const std::vector<std::vector<uint32_t>>& preds) {
+    uint32_t n = static_cast<uint32_t>(fn.blocks.size());
+
+    // Reverse postorder by iterative DFS.
+    std::vector<uint32_t> postorder;
+    std::vector<char> visited(n, 0);
+    std::vector<std::pair<uint32_t, size_t>> stack{{0, 0}};
+    visited[0] = 1;
+    std::vector<std::vector<uint32_t>> succs = successorLists(fn);
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second < succs[top.first].size()) {
+            uint32_t s = succs[top.first][top.second++];
+            if (!visited[s]) {
+                visited[s] = 1;
+                stack.push_back({s, 0});
+            }
+        } else {
+            postorder.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+    std::vector<uint32_t> rpoIndex(n);
+    for (uint32_t i = 0; i < postorder.size(); ++i) {
+        rpoIndex[postorder[i]] = static_cast<uint32_t>(postorder.size()) - 1 - i;
+    }
+
+    Dominance dom;
+    dom.idom.assign(n, IR_NONE);
+    dom.idom[0] = 0;
+    auto intersect = [&](uint32_t a, uint32_t b) {
+        while (a != b) {
+            while (rpoIndex[a] > rpoIndex[b]) a = dom.idom[a];
+            while (rpoIndex[b] > rpoIndex[a]) b = dom.idom[b];
+        }
+        return a;
+    };
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto it = postorder.rbegin(); it != postorder.rend(); ++it) {
+            uint32_t b = *it;
+            if (b == 0) continue;
+            uint32_t newIdom = IR_NONE;
+            for (uint32_t p : preds[b]) {
+                if (dom.idom[p] == IR_NONE) continue;
+                newIdom = newIdom == IR_NONE ? p : intersect(p, newIdom);
+            }
+            if (dom.idom[b] != newIdom) {
+                dom.idom[b] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    dom.children.resize(n);
+    dom.frontier.resize(n);
+    for (uint32_t b = 1; b < n; ++b) dom.children[dom.idom[b]].push_back(b);
+    for (uint32_t b = 0; b < n; ++b) {
+        if (preds[b].size() < 2) continue;
+        for (uint32_t p : preds[b]) {
+            for (uint32_t runner = p; runner != dom.idom[b]; runner = dom.idom[runner]) {
+                auto& df = dom.frontier[runner];
+                if (df.empty() || df.back() != b) df.push_back(b);
+            }
+        }
+    }
+    return dom;
+}
+
+void buildSsa(IrFunction& fn) {
+    removeUnreachableBlocks(fn);
+    uint32_t n = static_cast<uint32_t>(fn.blocks.size());
+    uint32_t originalValues = fn.numValues;
+    auto preds = predecessors(fn);
+    Dominance dom = computeDominance(fn, preds);
+
+    // Only values assigned more than once need renaming. Parameters count
+    // as assigned on entry.
+    std::vector<uint32_t> defCount(originalValues, 0);
+    for (uint32_t p = 0; p < fn.numParams; ++p) defCount[p] = 1;
+    for (const Instr& in : fn.instrs) {
+        if (definesValue(in.op)) defCount[in.dest]++;
+    }
+    std::vector<char> multi(originalValues, 0);
+    for (uint32_t v = 0; v < originalValues; ++v) multi[v] = defCount[v] > 1;
+
+    // Semi-pruned SSA: a PHI is only needed for values read in some block
+    // before being assigned there.
+    std::vector<char> global(originalValues, 0);
+    std::vector<std::vector<uint32_t>> defBlocks(originalValues);
+    std::vector<uint32_t> stamp(originalValues, IR_NONE);
+    for (uint32_t p = 0; p < fn.numParams; ++p) {
+        if (multi[p]) defBlocks[p].push_back(0);
+    }
+    for (uint32_t b = 0; b < n; ++b) {
+        for (uint32_t i = fn.blocks[b].begin; i < fn.blocks[b].end; ++i) {
+            Instr& in = fn.instrs[i];
+            forEachUse(fn, in, [&](uint32_t& v) {
+                if (stamp[v] != b) global[v] = 1;
+            });
+            if (definesValue(in.op) && multi[in.dest]) {
+                stamp[in.dest] = b;
+                auto& blocks = defBlocks[in.dest];
+                if (blocks.empty() || blocks.back() != b) blocks.push_back(b);
+            }
+        }
+    }
+
+    // PHI placement on the iterated dominance frontier.
+    std::vector<std::vector<uint32_t>> phis(n);  // original value per PHI
+    std::vector<uint32_t> hasPhi(n, IR_NONE), queued(n, IR_NONE);
+    std::vector<uint32_t> work;
+    for (uint32_t v = 0; v < originalValues; ++v) {
+        if (!multi[v] || !global[v]) continue;
+        work = defBlocks[v];
+        for (uint32_t b : work) queued[b] = v;
+        while (!work.empty()) {
+            uint32_t b = work.back();
+            work.pop_back();
+            for (uint32_t d : dom.frontier[b]) {
+                if (hasPhi[d] == v) continue;
+                hasPhi[d] = v;
+                phis[d].push_back(v);
+                if (queued[d] != v) {
+                    queued[d] = v;
+                    work.push_back(d);
+                }
+            }
+        }
+    }
+
+    // Renaming: a preorder walk of the dominator tree with a stack of
+    // current names per original value. `pushed` logs which stacks grew so
+    // they can be popped when the walk leaves a block.
+    std::vector<std::vector<uint32_t>> current(originalValues);
+    for (uint32_t p = 0; p < fn.numParams; ++p) {
+        if (multi[p]) current[p].push_back(p);
+    }
+    std::vector<std::vector<uint32_t>> phiDest(n);
+    std::vector<std::vector<std::vector<PhiArg>>> phiIn(n);
+    for (uint32_t b = 0; b < n; ++b) {
+        phiDest[b].resize(phis[b].size());
+        phiIn[b].resize(phis[b].size());
+    }
+    auto top = [&](uint32_t v) { return current[v].empty() ? IR_NONE : current[v].back(); };
+
+    std::vector<uint32_t> pushed;
+    std::vector<std::pair<uint32_t, size_t>> walk{{0, 0}};  // (block, pushed mark)
+    std::vector<char> entered(n, 0);
+    std::vector<uint32_t> succ;
+    while (!walk.empty()) {
+        uint32_t b = walk.back().first;
+        if (entered[b]) {
+            size_t mark = walk.back().second;
+            while (pushed.size() > mark) {
+                current[pushed.back()].pop_back();
+                pushed.pop_back();
+            }
+            walk.pop_back();
+            continue;
+        }
+        entered[b] = 1;
+        walk.back().second = pushed.size();
+
+        for (size_t k = 0; k < phis[b].size(); ++k) {
+            uint32_t v = phis[b][k];
+            uint32_t fresh = addValue(fn, fn.valueNames[v]);
+            current[v].push_back(fresh);
+            pushed.push_back(v);
+            phiDest[b][k] = fresh;
+        }
+        for (uint32_t i = fn.blocks[b].begin; i < fn.blocks[b].end; ++i) {
+            Instr& in = fn.instrs[i];
+            forEachUse(fn, in, [&](uint32_t& v) {
+                if (v < originalValues && multi[v] && top(v) != IR_NONE) v = top(v);
+            });
+            if (definesValue(in.op) && multi[in.dest]) {
+                uint32_t v = in.dest;
+                in.dest = addValue(fn, fn.valueNames[v]);
+                current[v].push_back(in.dest);
+                pushed.push_back(v);
+            }
+        }
+        successors(fn, b, succ);
+        for (uint32_t s : succ) {
+            for (size_t k = 0; k < phis[s].size(); ++k) {
+                phiIn[s][k].push_back(PhiArg{b, top(phis[s][k])});
+            }
+        }
+        for (uint32_t child : dom.children[b]) walk.push_back({child, 0});
+    }
+
+    // Reassemble with the PHIs at the head of each block.
+    std::vector<Instr> instrs;
+    instrs.reserve(fn.instrs.size());
+    fn.phiArgs.clear();
+    for (uint32_t b = 0; b < n; ++b) {
+        uint32_t begin = static_cast<uint32_t>(instrs.size());
+        for (size_t k = 0; k < phis[b].size(); ++k) {
+            uint32_t first = static_cast<uint32_t>(fn.phiArgs.size());
+            fn.phiArgs.insert(fn.phiArgs.end(), phiIn[b][k].begin(), phiIn[b][k].end());
+            instrs.push_back(Instr{Opcode::PHI, phiDest[b][k], first,
+                                   static_cast<uint32_t>(phiIn[b][k].size())});
+        }
+        instrs.insert(instrs.end(), fn.instrs.begin() + fn.blocks[b].begin,
+                      fn.instrs.begin() + fn.blocks[b].end);
+        fn.blocks[b] = IrBlock{begin, static_cast<uint32_t>(instrs.size())};
+    }
+    fn.instrs.swap(instrs);
+}
+
+// ============================================================
+// Copy propagation / constant branches / dead code (SSA)
+// ============================================================
+
+void propagateCopies(IrFunction& fn) {
+    std::vector<uint32_t> alias(fn.numValues);
+    for (uint32_t v = 0; v < fn.numValues; ++v) alias[v] = v;
+    auto find = [&](uint32_t v) {
+        while (alias[v] != v) {
+            alias[v] = alias[alias[v]];
+            v = alias[v];
+        }
+        return v;
+    };
+
+    std::vector<char> keep(fn.instrs.size(), 1);
+    for (uint32_t i = 0; i < fn.instrs.size(); ++i) {
+        const Instr& in = fn.instrs[i];
+        if (in.op == Opcode::COPY) {
+            alias[in.dest] = in.src1;
+            keep[i] = 0;
+        }
+    }
+
+    // A PHI whose operands are all one value (or the PHI itself) is a copy.
+    // Removing one can make another trivial, so repeat until stable.
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (uint32_t i = 0; i < fn.instrs.size(); ++i) {
+            const Instr& in = fn.instrs[i];
+            if (in.op != Opcode::PHI || !keep[i]) continue;
+            uint32_t self = find(in.dest);
+            uint32_t unique = IR_NONE;
+            bool trivial = true;
+            for (uint32_t k = 0; k < in.src2 && trivial; ++k) {
+                uint32_t value = fn.phiArgs[in.src1 + k].value;
+                if (value == IR_NONE) continue;
+                value = find(value);
+                if (value == self) continue;
+                if (unique == IR_NONE) unique = value;
+                else if (value != unique) trivial = false;
+            }
+            if (trivial && unique != IR_NONE) {
+                alias[self] = unique;
+                keep[i] = 0;
+                changed = true;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < fn.instrs.size(); ++i) {
+        if (keep[i]) forEachUse(fn, fn.instrs[i], [&](uint32_t& v) { v = find(v); });
+    }
+    keepInstrs(fn, keep);
+}
+
+uint32_t foldConstantBranches(IrFunction& fn) {
+    std::vector<uint32_t> constDef(fn.numValues, IR_NONE);
+    for (uint32_t i = 0; i < fn.instrs.size(); ++i) {
+        if (fn.instrs[i].op == Opcode::CONST) constDef[fn.instrs[i].dest] = i;
+    }
+    uint32_t folded = 0;
+    for (Instr& in : fn.instrs) {
+        if ((in.op != Opcode::BR && in.op != Opcode::SWITCH) || constDef[in.src1] == IR_NONE) {
+            continue;
+        }
+        int64_t value = fn.instrs[constDef[in.src1]].imm();
+        uint32_t target;
+        if (in.op == Opcode::BR) {
+            target = value != 0 ? in.src2 : in.dest;
+        } else {
+            uint64_t index = std::min(static_cast<uint64_t>(value), static_cast<uint64_t>(in.dest));
+            target = fn.switchTargets[in.src2 + index];
+        }
+        in = Instr{Opcode::JMP, IR_NONE, target, IR_NONE};
+        folded++;
+    }
+    return folded;
+}
+
+void eliminateDeadCode(IrFunction& fn) {
+    std::vector<uint32_t> defAt(fn.numValues, IR_NONE);
+    for (uint32_t i = 0; i < fn.instrs.size(); ++i) {
+        if (definesValue(fn.instrs[i].op)) defAt[fn.instrs[i].dest] = i;
+    }
+
+    std::vector<char> live(fn.instrs.size(), 0);
+    std::vector<uint32_t> work;
+    for (uint32_t i = 0; i < fn.instrs.size(); ++i) {
+        Opcode op = fn.instrs[i].op;
+        if (op == Opcode::ARG || op == Opcode::CALL || op == Opcode::DIV || isTerminator(op)) {
+            live[i] = 1;
+            work.push_back(i);
+        }
+    }
+    while (!work.empty()) {
+        uint32_t i = work.back();
+        work.pop_back();
+        forEachUse(fn, fn.instrs[i], [&](uint32_t& v) {
+            uint32_t def = defAt[v];
+            if (def != IR_NONE && !live[def]) {
+                live[def] = 1;
+                work.push_back(def);
+            }
+        });
+    }
+    keepInstrs(fn, live);
+}
+
+// ============================================================
+// SSA destruction
+// ============================================================
+
+// Appends copies performing all of `copies` (dest <- src) simultaneously.
+// A copy is emitted once no pending copy still reads its destination; a
+// cycle is broken by saving one destination in a temporary.
+static void sequentializeCopies(IrFunction& fn, std::vector<std::pair<uint32_t, uint32_t>>& copies,
+                                std::vector<Instr>& out) {
+    copies.erase(std::remove_if(copies.begin(), copies.end(),
+                                [](const std::pair<uint32_t, uint32_t>& c) {
+                                    return c.first == c.second;
+                                }),
+                 copies.end());
+    while (!copies.empty()) {
+        bool emitted = false;
+        for (size_t i = 0; i < copies.size(); ++i) {
+            uint32_t dest = copies[i].first;
+            bool read = false;
+            for (const auto& c : copies) read = read || c.second == dest;
+            if (read) continue;
+            out.push_back(Instr{Opcode::COPY, dest, copies[i].second, IR_NONE});
+            copies.erase(copies.begin() + i);
+            emitted = true;
+            break;
+        }
+        if (emitted) continue;
+
+        uint32_t saved = copies[0].first;
+        uint32_t temp = addValue(fn, "");
+        out.push_back(Instr{Opcode::COPY, temp, saved, IR_NONE});
+        for (auto& c : copies) {
+            if (c.second == saved) c.second = temp;
+        }
+    }
+}
+
+namespace {
+
+// Decides which PHI-related values can share one name out of SSA. Two
+// values may share a name unless they interfere: one is live where the
+// other is defined. Liveness is computed only for values that appear in
+// PHIs.
+class PhiCoalescer {
+public:
+    explicit PhiCoalescer(IrFunction& fn) : fn_(fn) {}
+
+    // Returns the name for every value: itself, or the representative of
+    // the class it was coalesced into.
+    std::vector<uint32_t> run() {
+        std::vector<uint32_t> rep(fn_.numValues);
+        for (uint32_t v = 0; v < fn_.numValues; ++v) rep[v] = v;
+        if (fn_.phiArgs.empty()) return rep;
+
+        analyze();
+        members_.resize(fn_.numValues);
+        for (uint32_t v = 0; v < fn_.numValues; ++v) parent_.push_back(v);
+
+        for (const Instr& in : fn_.instrs) {
+            if (in.op != Opcode::PHI) continue;
+            for (uint32_t k = 0; k < in.src2; ++k) {
+                uint32_t arg = fn_.phiArgs[in.src1 + k].value;
+                if (arg != IR_NONE) tryUnion(in.dest, arg);
+            }
+        }
+        for (uint32_t v = 0; v < fn_.numValues; ++v) rep[v] = find(v);
+        return rep;
+    }
+
+private:
+    IrFunction& fn_;
+    std::vector<uint32_t> candidate_;              // value -> bit index, or IR_NONE
+    size_t words_ = 0;
+    std::vector<std::vector<uint64_t>> liveOut_;   // per block, over candidates
+    std::vector<uint32_t> defBlock_;
+    std::vector<int64_t> defIndex_;                // -1 for parameters
+    std::vector<uint32_t> pre_, post_;             // dominator-tree numbering
+    std::vector<uint32_t> parent_;
+    std::vector<std::vector<uint32_t>> members_;
+
+    bool isPhiDef(uint32_t v) const {
+        return defIndex_[v] >= 0 && fn_.instrs[defIndex_[v]].op == Opcode::PHI;
+    }
+
+    void analyze() {
+        uint32_t n = static_cast<uint32_t>(fn_.blocks.size());
+        auto preds = predecessors(fn_);
+        Dominance dom = computeDominance(fn_, preds);
+
+        pre_.assign(n, 0);
+        post_.assign(n, 0);
+        uint32_t clock = 0;
+        std::vector<std::pair<uint32_t, size_t>> stack{{0, 0}};
+        pre_[0] = clock++;
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            if (top.second < dom.children[top.first].size()) {
+                uint32_t child = dom.children[top.first][top.second++];
+                pre_[child] = clock++;
+                stack.push_back({child, 0});
+            } else {
+                post_[top.first] = clock++;
+                stack.pop_back();
+            }
+        }
+
+        defBlock_.assign(fn_.numValues, 0);
+        defIndex_.assign(fn_.numValues, -1);
+        for (uint32_t b = 0; b < n; ++b) {
+            for (uint32_t i = fn_.blocks[b].begin; i < fn_.blocks[b].end; ++i) {
+                if (!definesValue(fn_.instrs[i].op)) continue;
+                defBlock_[fn_.instrs[i].dest] = b;
+                defIndex_[fn_.instrs[i].dest] = i;
+            }
+        }
+
+        candidate_.assign(fn_.numValues, IR_NONE);
+        uint32_t count = 0;
+        for (const Instr& in : fn_.instrs) {
+            if (in.op != Opcode::PHI) continue;
+            if (candidate_[in.dest] == IR_NONE) candidate_[in.dest] = count++;
+            for (uint32_t k = 0; k < in.src2; ++k) {
+                uint32_t v = fn_.phiArgs[in.src1 + k].value;
+                if (v != IR_NONE && candidate_[v] == IR_NONE) candidate_[v] = count++;
+            }
+        }
+        words_ = (count + 63) / 64;
+
+        // use: read by a non-PHI instruction before any definition in the
+        // block; def: defined in the block; phiUse: PHI operand on an edge
+        // leaving the block.
+        std::vector<std::vector<uint64_t>> use(n, std::vector<uint64_t>(words_, 0));
+        std::vector<std::vector<uint64_t>> def(n, std::vector<uint64_t>(words_, 0));
+        std::vector<std::vector<uint64_t>> liveIn(n, std::vector<uint64_t>(words_, 0));
+        liveOut_.assign(n, std::vector<uint64_t>(words_, 0));
+        auto set = [](std::vector<uint64_t>& bits, uint32_t i) { bits[i / 64] |= 1ULL << (i % 64); };
+        auto test = [](const std::vector<uint64_t>& bits, uint32_t i) {
+            return (bits[i / 64] >> (i % 64)) & 1;
+        };
+        for (uint32_t b = 0; b < n; ++b) {
+            for (uint32_t i = fn_.blocks[b].begin; i < fn_.blocks[b].end; ++i) {
+                Instr& in = fn_.instrs[i];
+                if (in.op == Opcode::PHI) {
+                    for (uint32_t k = 0; k < in.src2; ++k) {
+                        const PhiArg& arg = fn_.phiArgs[in.src1 + k];
+                        if (arg.value != IR_NONE) set(liveOut_[arg.block], candidate_[arg.value]);
+                    }
+                } else {
+                    forEachUse(fn_, in, [&](uint32_t& v) {
+                        uint32_t c = candidate_[v];
+                        if (c != IR_NONE && !test(def[b], c)) set(use[b], c);
+                    });
+                }
+                if (definesValue(in.op) && candidate_[in.dest] != IR_NONE) {
+                    set(def[b], candidate_[in.dest]);
+                }
+            }
+        }
+        // Parameters are defined on entry.
+        for (uint32_t p = 0; p < fn_.numParams; ++p) {
+            if (candidate_[p] != IR_NONE) set(def[0], candidate_[p]);
+        }
+
+        std::vector<std::vector<uint64_t>> phiUse = liveOut_;
+        std::vector<std::vector<uint32_t>> succs = successorLists(fn_);
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (uint32_t b = n; b-- > 0;) {
+                std::vector<uint64_t>& out = liveOut_[b];
+                for (size_t w = 0; w < words_; ++w) {
+                    uint64_t bits = phiUse[b][w];
+                    for (uint32_t s : succs[b]) bits |= liveIn[s][w];
+                    uint64_t in = use[b][w] | (bits & ~def[b][w]);
+                    if (bits != out[w] || in != liveIn[b][w]) {
+                        out[w] = bits;
+                        liveIn[b][w] = in;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // True if the definition of x comes before (dominates) that of y. PHIs
+    // of one block are defined simultaneously, so each precedes the other.
+    bool defDominates(uint32_t x, uint32_t y) const {
+        uint32_t bx = defBlock_[x], by = defBlock_[y];
+        if (bx != by) return pre_[bx] <= pre_[by] && post_[by] <= post_[bx];
+        if (isPhiDef(x) && isPhiDef(y)) return true;
+        return defIndex_[x] < defIndex_[y];
+    }
+
+    // True if x is live just after y is defined (x's definition dominating y's).
+    bool liveAtDef(uint32_t x, uint32_t y) {
+        uint32_t b = defBlock_[y];
+        uint32_t c = candidate_[x];
+        if ((liveOut_[b][c / 64] >> (c % 64)) & 1) return true;
+        uint32_t from = defIndex_[y] < 0 ? fn_.blocks[b].begin : static_cast<uint32_t>(defIndex_[y]) + 1;
+        for (uint32_t i = from; i < fn_.blocks[b].end; ++i) {
+            Instr& in = fn_.instrs[i];
+            if (in.op == Opcode::PHI) continue;
+            bool used = false;
+            forEachUse(fn_, in, [&](uint32_t& v) { used = used || v == x; });
+            if (used) return true;
+        }
+        return false;
+    }
+
+    bool interfere(uint32_t x, uint32_t y) {
+        if (defDominates(x, y) && liveAtDef(x, y)) return true;
+        if (defDominates(y, x) && liveAtDef(y, x)) return true;
+        return false;
+    }
+
+    uint32_t find(uint32_t v) {
+        while (parent_[v] != v) {
+            parent_[v] = parent_[parent_[v]];
+            v = parent_[v];
+        }
+        return v;
+    }
+
+    void tryUnion(uint32_t a, uint32_t b) {
+        uint32_t ra = find(a), rb = find(b);
+        if (ra == rb) return;
+        // Parameters arrive in their own values: a class keeps at most one,
+        // and it names the class.
+        if (ra < fn_.numParams && rb < fn_.numParams) return;
+        if (members_[ra].empty()) members_[ra].push_back(ra);
+        if (members_[rb].empty()) members_[rb].push_back(rb);
+        for (uint32_t x : members_[ra]) {
+            for (uint32_t y : members_[rb]) {
+                if (interfere(x, y)) return;
+            }
+        }
+        if (rb < fn_.numParams || (ra >= fn_.numParams && members_[ra].size() < members_[rb].size())) {
+            std::swap(ra, rb);
+        }
+        parent_[rb] = ra;
+        members_[ra].insert(members_[ra].end(), members_[rb].begin(), members_[rb].end());
+        members_[rb].clear();
+        members_[rb].shrink_to_fit();
+    }
+};
+
+}  // namespace
+
+void destroySsa(IrFunction& fn) {
+    if (fn.phiArgs.empty()) {
+        std::vector<char> keep(fn.instrs.size(), 1);
+        for (uint32_t i = 0; i < fn.instrs.size(); ++i) keep[i] = fn.instrs[i].op != Opcode::PHI;
+        keepInstrs(fn, keep);
+        compactValues(fn);
+        return;
+    }
+
+    // Values that do not interfere with a PHI they feed share its name, so
+    // the copy on that edge disappears.
+    std::vector<uint32_t> rep = PhiCoalescer(fn).run();
+    for (Instr& in : fn.instrs) {
+        if (definesValue(in.op)) in.dest = rep[in.dest];
+        forEachUse(fn, in, [&](uint32_t& v) { v = rep[v]; });
+    }
+
+    uint32_t n = static_cast<uint32_t>(fn.blocks.size());
+    // Copies to place at the end of each block (before its terminator);
+    // split blocks are appended after the original ones.
+    std::vector<std::vector<Instr>> tail(n);
+    std::vector<std::vector<Instr>> splitBlocks;
+    std::vector<std::pair<uint32_t, uint32_t>> copies;
+    std::vector<uint32_t> succ;
+
+    for (uint32_t s = 0; s < n; ++s) {
+        const IrBlock range = fn.blocks[s];
+        if (range.begin == range.end || fn.instrs[range.begin].op != Opcode::PHI) continue;
+
+        // Incoming predecessors, in the order they appear in the first PHI.
+        const Instr& first = fn.instrs[range.begin];
+        std::vector<uint32_t> incoming;
+        for (uint32_t k = 0; k < first.src2; ++k) incoming.push_back(fn.phiArgs[first.src1 + k].block);
+
+        for (uint32_t p : incoming) {
+            copies.clear();
+            for (uint32_t i = range.begin; i < range.end && fn.instrs[i].op == Opcode::PHI; ++i) {
+                const Instr& phi = fn.instrs[i];
+                for (uint32_t k = 0; k < phi.src2; ++k) {
+                    const PhiArg& arg = fn.phiArgs[phi.src1 + k];
+                    if (arg.block == p && arg.value != IR_NONE) copies.push_back({phi.dest, arg.value});
+                }
+            }
+
+            // A predecessor with another successor cannot hold the copies:
+            // split the edge with a block of its own.
+            successors(fn, p, succ);
+            if (succ.size() > 1) {
+                uint32_t split = n + static_cast<uint32_t>(splitBlocks.size());
+                splitBlocks.emplace_back();
+                sequentializeCopies(fn, copies, splitBlocks.back());
+                splitBlocks.back().push_back(Instr{Opcode::JMP, IR_NONE, s, IR_NONE});
+                forEachTarget(fn, fn.instrs[fn.blocks[p].end - 1], [&](uint32_t& block) {
+                    if (block == s) block = split;
+                });
+            } else {
+                sequentializeCopies(fn, copies, tail[p]);
+            }
+        }
+    }
+
+    std::vector<Instr> instrs;
+    instrs.reserve(fn.instrs.size());
+    std::vector<IrBlock> blocks;
+    for (uint32_t b = 0; b < n; ++b) {
+        uint32_t begin = static_cast<uint32_t>(instrs.size());
+        for (uint32_t i = fn.blocks[b].begin; i + 1 < fn.blocks[b].end; ++i) {
+            if (fn.instrs[i].op != Opcode::PHI) instrs.push_back(fn.instrs[i]);
+        }
+        instrs.insert(instrs.end(), tail[b].begin(), tail[b].end());
+        instrs.push_back(fn.instrs[fn.blocks[b].end - 1]);
+        blocks.push_back(IrBlock{begin, static_cast<uint32_t>(instrs.size())});
+    }
+    for (const auto& split : splitBlocks) {
+        uint32_t begin = static_cast<uint32_t>(instrs.size());
+        instrs.insert(instrs.end(), split.begin(), split.end());
+        blocks.push_back(IrBlock{begin, static_cast<uint32_t>(instrs.size())});
+    }
+    fn.instrs.swap(instrs);
+    fn.blocks.swap(blocks);
+    fn.phiArgs.clear();
+    compactValues(fn);
+}
+
+// ============================================================
+// Pipeline
+// ============================================================
+
+void optimizeFunction(IrFunction& fn, IrOptStats& stats) {
+    stats.instrsBefore += fn.instrs.size();
+    stats.blocksRemoved += removeUnreachableBlocks(fn);
+    buildSsa(fn);
+    propagateCopies(fn);
+    if (foldConstantBranches(fn) > 0) {
+        stats.blocksRemoved += removeUnreachableBlocks(fn);
+        propagateCopies(fn);  // PHIs that lost an operand may now be copies
+    }
+    eliminateDeadCode(fn);
+    destroySsa(fn);
+    stats.instrsAfter += fn.instrs.size();
+}
+
+void optimizeModule(IrModule& module, IrOptStats& stats) {
+    for (IrFunction& fn : module.functions) {
+        optimizeFunction(fn, stats);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include "ir.h"
+#include <cstdint>
+
+// ============================================================
+// IrOptStats — counters reported by the driver's --stats output
+// ============================================================
+struct IrOptStats {
+    uint64_t instrsBefore = 0;
+    uint64_t instrsAfter = 0;
+    uint64_t blocksRemoved = 0;  // unreachable blocks dropped
+};
+
+// ============================================================
+// SSA construction, cleanup passes and SSA destruction
+// ============================================================
+//
+// All passes rewrite an IrFunction in place. Passes marked "SSA" expect
+// the function to be in SSA form (every value defined once).
+
+// Drops blocks not reachable from the entry and PHI operands for edges
+// that no longer exist. Returns the number of blocks removed.
+uint32_t removeUnreachableBlocks(IrFunction& fn);
+
+// Converts to SSA: PHIs are placed on the dominance frontiers of the
+// blocks that assign a variable (Cytron et al., with dominators from
+// Cooper, Harvey & Kennedy), and each assignment gets a fresh value.
+void buildSsa(IrFunction& fn);
+
+// SSA: replaces every use of a COPY's destination by its source and
+// removes the COPY; PHIs whose operands are all the same value too.
+void propagateCopies(IrFunction& fn);
+
+// SSA: turns a BR or SWITCH on a constant into a JMP. Returns the number changed;
+// follow with removeUnreachableBlocks().
+uint32_t foldConstantBranches(IrFunction& fn);
+
+// SSA: removes instructions whose values are never used. Calls, ARGs,
+// terminators and divisions (which may fault) always stay.
+void eliminateDeadCode(IrFunction& fn);
+
+// Leaves SSA: PHI operands that do not interfere with the PHI share its
+// name; the rest become copies on the incoming edges, splitting critical
+// edges and ordering each edge's copies as a parallel copy. Also
+// renumbers values densely.
+void destroySsa(IrFunction& fn);
+
+// The whole pipeline: unreachable-block removal, SSA construction, copy
+// propagation, constant-branch folding, dead-code elimination and
+// destruction of SSA.
+void optimizeFunction(IrFunction& fn, IrOptStats& stats);
+void optimizeModule(IrModule& module, IrOptStats& stats);
+
+#endif // SSA_H
@@ -0,0 +1,129 @@
+#include "tac_printer.h"
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// Value names
+// ============================================================
+
+// Variables print under their source name, with ".N" appended to the
+// second and later variables of the same name; temporaries print as t0, t1, ...
+static std::vector<std::string> valueLabels(const IrFunction& fn) {
+    std::vector<std::string> labels(fn.numValues);
+    std::unordered_map<std::string, int> seen;
+    int temps = 0;
+    for (uint32_t v = 0; v < fn.numValues; ++v) {
+        const std::string& name = v < fn.valueNames.size() ? fn.valueNames[v] : std::string();
+        if (name.empty()) {
+            labels[v] = "t" + std::to_string(temps++);
+            continue;
+        }
+        int n = seen[name]++;
+        labels[v] = n == 0 ? name : name + "." + std::to_string(n);
+    }
+    return labels;
+}
+
+static const char* binarySymbol(Opcode op) {
+    switch (op) {
+        case Opcode::ADD: return "+";
+        case Opcode::SUB: return "-";
+        case Opcode::MUL: return "*";
+        case Opcode::DIV: return "/";
+        case Opcode::EQ:  return "==";
+        case Opcode::NE:  return "!=";
+        case Opcode::LT:  return "<";
+        case Opcode::GT:  return ">";
+        case Opcode::LE:  return "<=";
+        case Opcode::GE:  return ">=";
+        default:          return "?";
+    }
+}
+
+// ============================================================
+// Emission
+// ============================================================
+
+void emitTacFunction(const IrModule& module, const IrFunction& fn, std::string& out) {
+    std::vector<std::string> labels = valueLabels(fn);
+    auto value = [&](uint32_t v) -> const std::string& { return labels[v]; };
+    auto block = [](uint32_t b) { return "B" + std::to_string(b); };
+
+    out += "fn " + fn.name + "(";
+    for (uint32_t p = 0; p < fn.numParams; ++p) {
+        if (p) out += ", ";
+        out += value(p);
+    }
+    out += ") {\n";
+
+    for (uint32_t b = 0; b < fn.blocks.size(); ++b) {
+        out += block(b) + ":\n";
+        for (uint32_t i = fn.blocks[b].begin; i < fn.blocks[b].end; ++i) {
+            const Instr& in = fn.instrs[i];
+            out += "    ";
+            switch (in.op) {
+                case Opcode::CONST:
+                    out += value(in.dest) + " = " + std::to_string(in.imm());
+                    break;
+                case Opcode::STR:
+                    out += value(in.dest) + " = \"" + module.strings[in.src1] + "\"";
+                    break;
+                case Opcode::COPY:
+                    out += value(in.dest) + " = " + value(in.src1);
+                    break;
+                case Opcode::NEG:
+                    out += value(in.dest) + " = -" + value(in.src1);
+                    break;
+                case Opcode::ARG:
+                    out += "arg " + value(in.src1);
+                    break;
+                case Opcode::CALL:
+                    out += value(in.dest) + " = call " + module.functions[in.src1].name + ", " +
+                           std::to_string(in.src2);
+                    break;
+                case Opcode::JMP:
+                    out += "goto " + block(in.src1);
+                    break;
+                case Opcode::BR:
+                    out += "if " + value(in.src1) + " goto " + block(in.src2) + " else " +
+                           block(in.dest);
+                    break;
+                case Opcode::SWITCH:
+                    out += "switch " + value(in.src1) + " [";
+                    for (uint32_t k = 0; k < in.dest; ++k) {
+                        out += (k ? ", " : "") + block(fn.switchTargets[in.src2 + k]);
+                    }
+                    out += "] else " + block(fn.switchTargets[in.src2 + in.dest]);
+                    break;
+                case Opcode::RET:
+                    out += in.src1 == IR_NONE ? "ret" : "ret " + value(in.src1);
+                    break;
+                case Opcode::PHI:
+                    out += value(in.dest) + " = phi";
+                    for (uint32_t k = 0; k < in.src2; ++k) {
+                        const PhiArg& arg = fn.phiArgs[in.src1 + k];
+                        out += k ? ", [" : " [";
+                        out += block(arg.block) + ": " +
+                               (arg.value == IR_NONE ? std::string("undef") : value(arg.value)) +
+                               "]";
+                    }
+                    break;
+                default:
+                    out += value(in.dest) + " = " + value(in.src1) + " " + binarySymbol(in.op) +
+                           " " + value(in.src2);
+                    break;
+            }
+            out += "\n";
+        }
+    }
+    out += "}\n";
+}
+
+std::string emitTac(const IrModule& module) {
+    std::string out;
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        if (i) out += "\n";
+        emitTacFunction(module, module.functions[i], out);
+    }
+    return out;
+}
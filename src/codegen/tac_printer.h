@@ -0,0 +1,13 @@
+#ifndef TAC_PRINTER_H
+#define TAC_PRINTER_H
+
+#include "ir.h"
+#include <string>
+
+// Renders `module` as three-address code text, one function after another.
+std::string emitTac(const IrModule& module);
+
+// Renders a single function; `module` supplies callee names and strings.
+void emitTacFunction(const IrModule& module, const IrFunction& fn, std::string& out);
+
+#endif // TAC_PRINTER_H
@@ -0,0 +1,179 @@
+#include "diag.h"
+
+// ============================================================
+// Messages
+// ============================================================
+
+// Text of each code; "%t" stands for the token text, "%n" for `arg`.
+static const char* messageTemplate(DiagCode code) {
+    switch (code) {
+        case DiagCode::EXPECTED_FN_NAME:             return "Expected function name after 'fn'";
+        case DiagCode::EXPECTED_LPAREN_AFTER_NAME:   return "Expected '(' after function name";
+        case DiagCode::EXPECTED_PARAM_NAME:          return "Expected parameter name";
+        case DiagCode::EXPECTED_PARAM_COLON:         return "Expected ':' after parameter name";
+        case DiagCode::EXPECTED_PARAM_TYPE:          return "Expected parameter type";
+        case DiagCode::EXPECTED_RPAREN_AFTER_PARAMS: return "Expected ')' after parameters";
+        case DiagCode::EXPECTED_LBRACE:              return "Expected '{'";
+        case DiagCode::EXPECTED_RBRACE:              return "Expected '}'";
+        case DiagCode::EXPECTED_LET_NAME:            return "Expected variable name after 'let'";
+        case DiagCode::EXPECTED_TYPE_NAME:           return "Expected type name after ':'";
+        case DiagCode::EXPECTED_LET_ASSIGN:          return "Expected '=' in let statement";
+        case DiagCode::EXPECTED_LET_SEMICOLON:       return "Expected ';' after let statement";
+        case DiagCode::EXPECTED_RETURN_SEMICOLON:    return "Expected ';' after return statement";
+        case DiagCode::EXPECTED_EXPR_SEMICOLON:      return "Expected ';' after expression statement";
+        case DiagCode::EXPECTED_CALL_RPAREN:         return "Expected ')' after call arguments";
+        case DiagCode::EXPECTED_GROUP_RPAREN:        return "Expected ')' after grouped expression";
+        case DiagCode::UNEXPECTED_TOKEN:             return "Unexpected token '%t' in expression";
+        case DiagCode::NESTING_TOO_DEEP:             return "Nesting deeper than %n levels";
+        case DiagCode::INVALID_LITERAL:              return "Invalid literal '%t'";
+        case DiagCode::UNSUPPORTED_LITERAL:
+            return "Unsupported literal '%t': only integers and strings have a type";
+        case DiagCode::INVALID_UTF8:                 return "Invalid UTF-8 '%t'";
+        case DiagCode::EXPECTED_RETURN_TYPE:         return "Expected return type after '->'";
+        case DiagCode::EXPECTED_STRUCT_NAME:         return "Expected struct name after 'struct'";
+        case DiagCode::EXPECTED_FIELD_NAME:          return "Expected field name";
+        case DiagCode::EXPECTED_FIELD_COLON:         return "Expected ':' after field name";
+        case DiagCode::EXPECTED_IMPL_TYPE:           return "Expected type name after 'impl'";
+        case DiagCode::EXPECTED_IMPL_FN:             return "Expected 'fn' in impl block";
+        case DiagCode::EXPECTED_FOR_VARIABLE:        return "Expected loop variable after 'for'";
+        case DiagCode::EXPECTED_FOR_IN:              return "Expected 'in' after loop variable";
+        case DiagCode::EXPECTED_BREAK_SEMICOLON:     return "Expected ';' after 'break'";
+        case DiagCode::EXPECTED_CONTINUE_SEMICOLON:  return "Expected ';' after 'continue'";
+        case DiagCode::EXPECTED_MEMBER_NAME:
+            return "Expected field or method name after '.'";
+        case DiagCode::EXPECTED_MATCH_LBRACE:        return "Expected '{' after match scrutinee";
+        case DiagCode::EXPECTED_MATCH_PATTERN:
+            return "Expected an integer or '_' pattern, found '%t'";
+        case DiagCode::EXPECTED_FAT_ARROW:           return "Expected '=>' after match pattern";
+        case DiagCode::EXPECTED_ARM_COMMA:           return "Expected ',' or '}' after match arm";
+        case DiagCode::TOO_MANY_PARAMS:              return "More than %n parameters or fields";
+        case DiagCode::INTEGER_OUT_OF_RANGE:
+            return "Integer literal out of range: '%t' does not fit in 64 bits";
+    }
+    return "Unknown error";
+}
+
+static const char* HEX = "0123456789abcdef";
+
+static void appendTokenText(const Diagnostic& d, const std::string& source, std::string& out) {
+    size_t begin = d.offset < source.size() ? d.offset : source.size();
+    size_t end = begin + d.length < source.size() ? begin + d.length : source.size();
+    for (size_t i = begin; i < end; ++i) {
+        if (i - begin == 32) {
+            out += "...";
+            break;
+        }
+        unsigned char u = static_cast<unsigned char>(source[i]);
+        if (u >= 0x20 && u < 0x7F) {
+            out += static_cast<char>(u);
+        } else {
+            out += "\\x";
+            out += HEX[u >> 4];
+            out += HEX[u & 15];
+        }
+    }
+}
+
+static void appendMessage(const Diagnostic& d, const std::string& source, std::string& out) {
+    for (const char* p = messageTemplate(d.code); *p; ++p) {
+        if (p[0] == '%' && p[1] == 't') {
+            appendTokenText(d, source, out);
+            ++p;
+        } else if (p[0] == '%' && p[1] == 'n') {
+            out += std::to_string(d.arg);
+            ++p;
+        } else {
+            out += *p;
+        }
+    }
+}
+
+std::string formatDiagnostic(const Diagnostic& d, const std::string& source) {
+    std::string message;
+    appendMessage(d, source, message);
+    return message;
+}
+
+// ============================================================
+// Rendering
+// ============================================================
+
+// Bytes of the line shown on each side of the token. Bounding the scan keeps
+// rendering linear even when the input has no newlines at all.
+static const size_t CONTEXT_BEFORE = 40;
+static const size_t CONTEXT_AFTER = 40;
+
+void renderDiagnostic(const Diagnostic& d, const std::string& source, std::string& out,
+                      bool snippet) {
+    out += "Parse error [line ";
+    out += std::to_string(d.line);
+    out += "]: ";
+    appendMessage(d, source, out);
+    out += '\n';
+    if (!snippet) return;
+
+    size_t at = d.offset < source.size() ? d.offset : source.size();
+    size_t begin = at;
+    while (begin > 0 && at - begin < CONTEXT_BEFORE && source[begin - 1] != '\n') --begin;
+    size_t end = at;
+    size_t limit = at + d.length + CONTEXT_AFTER;
+    while (end < source.size() && end < limit && source[end] != '\n') ++end;
+    bool cutBefore = begin > 0 && source[begin - 1] != '\n';
+    bool cutAfter = end < source.size() && source[end] != '\n';
+
+    std::string number = std::to_string(d.line);
+    std::string gutter(number.size() + 2, ' ');
+    out += ' ';
+    out += number;
+    out += " | ";
+    if (cutBefore) out += "...";
+    size_t from = out.size();
+    out.append(source, begin, end - begin);
+    for (size_t i = from; i < out.size(); ++i) {
+        unsigned char u = static_cast<unsigned char>(out[i]);
+        if ((u < 0x20 && u != '\t') || u == 0x7F) out[i] = '?';
+    }
+    if (cutAfter) out += "...";
+    out += '\n';
+
+    // Columns as a terminal shows them: tabs are kept, UTF-8 continuation
+    // bytes take none.
+    out += gutter;
+    out += "| ";
+    if (cutBefore) out += "   ";
+    for (size_t i = begin; i < at; ++i) {
+        unsigned char u = static_cast<unsigned char>(source[i]);
+        if (u == '\t') out += '\t';
+        else if ((u & 0xC0) != 0x80) out += ' ';
+    }
+    size_t carets = 1;
+    if (d.length > 1) carets = (at + d.length < end ? at + d.length : end) - at;
+    out.append(carets ? carets : 1, '^');
+    out += '\n';
+}
+
+std::string renderDiagnostics(const std::vector<Diagnostic>& diagnostics,
+                              const std::string& source, bool snippets) {
+    std::string out;
+    for (const Diagnostic& d : diagnostics) renderDiagnostic(d, source, out, snippets);
+    return out;
+}
+
+void renderLineError(const char* stage, int line, const std::string& message, std::string& out) {
+    out += stage;
+    out += " error [line ";
+    out += std::to_string(line);
+    out += "]: ";
+    out += message;
+    out += '\n';
+}
+
+void renderFunctionError(const char* stage, const std::string& function,
+                         const std::string& message, std::string& out) {
+    out += stage;
+    out += " error in '";
+    out += function;
+    out += "': ";
+    out += message;
+    out += '\n';
+}
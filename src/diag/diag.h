@@ -0,0 +1,103 @@
+#ifndef DIAG_H
+#define DIAG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// DiagCode — one per message the front end can report
+// ============================================================
+//
+// Values are stable (tools may match on them); add new codes at the end.
+enum class DiagCode : uint16_t {
+    EXPECTED_FN_NAME,
+    EXPECTED_LPAREN_AFTER_NAME,
+    EXPECTED_PARAM_NAME,
+    EXPECTED_PARAM_COLON,
+    EXPECTED_PARAM_TYPE,
+    EXPECTED_RPAREN_AFTER_PARAMS,
+    EXPECTED_LBRACE,
+    EXPECTED_RBRACE,
+    EXPECTED_LET_NAME,
+    EXPECTED_TYPE_NAME,
+    EXPECTED_LET_ASSIGN,
+    EXPECTED_LET_SEMICOLON,
+    EXPECTED_RETURN_SEMICOLON,
+    EXPECTED_EXPR_SEMICOLON,
+    EXPECTED_CALL_RPAREN,
+    EXPECTED_GROUP_RPAREN,
+    UNEXPECTED_TOKEN,     // shows the token's source text
+    NESTING_TOO_DEEP,     // arg: the nesting limit
+    INVALID_LITERAL,      // malformed number, escape or suffix
+    UNSUPPORTED_LITERAL,  // float or char: nothing after the parser has a type for it
+    INVALID_UTF8,         // at the bad bytes themselves, not a whole token
+    EXPECTED_RETURN_TYPE,
+    EXPECTED_STRUCT_NAME,
+    EXPECTED_FIELD_NAME,
+    EXPECTED_FIELD_COLON,
+    EXPECTED_IMPL_TYPE,
+    EXPECTED_IMPL_FN,
+    EXPECTED_FOR_VARIABLE,
+    EXPECTED_FOR_IN,
+    EXPECTED_BREAK_SEMICOLON,
+    EXPECTED_CONTINUE_SEMICOLON,
+    EXPECTED_MEMBER_NAME,
+    EXPECTED_MATCH_LBRACE,
+    EXPECTED_MATCH_PATTERN,  // shows the token's source text
+    EXPECTED_FAT_ARROW,
+    EXPECTED_ARM_COMMA,
+    TOO_MANY_PARAMS,       // arg: the limit
+    INTEGER_OUT_OF_RANGE,  // more than 64 bits
+};
+
+// ============================================================
+// Diagnostic — an unformatted error
+// ============================================================
+//
+// Recording one is a push of 20 bytes: the message is only built when the
+// diagnostic is formatted or rendered, from the code, the numeric argument
+// and the source text at [offset, offset + length).
+struct Diagnostic {
+    DiagCode code;
+    int32_t line;
+    uint32_t offset;  // byte offset of the token it is reported at
+    uint32_t length;  // source bytes of that token (0 at end of file)
+    uint32_t arg;     // numeric argument, if the message has one
+};
+
+// The message alone, e.g. "Unexpected token ';' in expression". Token text
+// longer than 32 bytes is cut short and non-printable bytes show as \xNN.
+std::string formatDiagnostic(const Diagnostic& d, const std::string& source);
+
+// Appends "Parse error [line N]: <message>" followed by the source line
+// (at most 80 bytes of it around the token) with carets under the token:
+//
+//     Parse error [line 3]: Unexpected token ';' in expression
+//      3 | let z = 1 + ;
+//        |             ^
+//
+// Without `snippet`, only the first line.
+void renderDiagnostic(const Diagnostic& d, const std::string& source, std::string& out,
+                      bool snippet = true);
+
+// All of `diagnostics`, in order, in one string — for a single write.
+std::string renderDiagnostics(const std::vector<Diagnostic>& diagnostics,
+                              const std::string& source, bool snippets = true);
+
+// ============================================================
+// Errors of the later stages
+// ============================================================
+//
+// Checking, code generation and execution keep built messages. These append
+// them in the driver's formats, so that a run renders all its errors into
+// one buffer and writes it once, as it does parse errors.
+
+// "<stage> error [line N]: <message>"
+void renderLineError(const char* stage, int line, const std::string& message, std::string& out);
+
+// "<stage> error in '<function>': <message>"
+void renderFunctionError(const char* stage, const std::string& function,
+                         const std::string& message, std::string& out);
+
+#endif // DIAG_H
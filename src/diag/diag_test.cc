@@ -0,0 +1,130 @@
+#include "diag.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// A diagnostic at the first occurrence of `token` in `source`.
+static Diagnostic at(DiagCode code, const std::string& source, const std::string& token,
+                     int line = 1) {
+    size_t offset = source.find(token);
+    return Diagnostic{code, line, static_cast<uint32_t>(offset),
+                      static_cast<uint32_t>(token.size()), 0};
+}
+
+// ============================================================
+// Messages
+// ============================================================
+
+TEST(Diag, RecordIsSmall) {
+    EXPECT_EQ(sizeof(Diagnostic), 20u);
+}
+
+TEST(Diag, FixedMessages) {
+    std::string src = "let = 1;";
+    EXPECT_EQ(formatDiagnostic(at(DiagCode::EXPECTED_LET_NAME, src, "="), src),
+              "Expected variable name after 'let'");
+    EXPECT_EQ(formatDiagnostic(at(DiagCode::EXPECTED_LBRACE, src, "="), src), "Expected '{'");
+}
+
+TEST(Diag, TokenTextComesFromTheSource) {
+    std::string src = "let x = ;";
+    EXPECT_EQ(formatDiagnostic(at(DiagCode::UNEXPECTED_TOKEN, src, ";"), src),
+              "Unexpected token ';' in expression");
+    Diagnostic eof{DiagCode::UNEXPECTED_TOKEN, 1, static_cast<uint32_t>(src.size()), 0, 0};
+    EXPECT_EQ(formatDiagnostic(eof, src), "Unexpected token '' in expression");
+}
+
+TEST(Diag, NumericArgument) {
+    Diagnostic d{DiagCode::NESTING_TOO_DEEP, 1, 0, 1, 256};
+    EXPECT_EQ(formatDiagnostic(d, "("), "Nesting deeper than 256 levels");
+}
+
+TEST(Diag, TokenTextIsEscapedAndCut) {
+    std::string src = std::string("x = \x01\xff;");
+    EXPECT_EQ(formatDiagnostic(at(DiagCode::UNEXPECTED_TOKEN, src, "\x01"), src),
+              "Unexpected token '\\x01' in expression");
+    std::string longName(100, 'a');
+    std::string message = formatDiagnostic(at(DiagCode::UNEXPECTED_TOKEN, longName, longName),
+                                           longName);
+    EXPECT_EQ(message, "Unexpected token '" + std::string(32, 'a') + "...' in expression");
+}
+
+// ============================================================
+// Rendering
+// ============================================================
+
+TEST(Diag, SnippetWithCaret) {
+    std::string src = "fn main() {\n    let z = 1 + ;\n}\n";
+    std::string out;
+    renderDiagnostic(at(DiagCode::UNEXPECTED_TOKEN, src, ";", 2), src, out);
+    EXPECT_EQ(out,
+              "Parse error [line 2]: Unexpected token ';' in expression\n"
+              " 2 |     let z = 1 + ;\n"
+              "   |                 ^\n");
+}
+
+TEST(Diag, CaretsSpanTheToken) {
+    std::string src = "let x = 1 foo;";
+    std::string out;
+    renderDiagnostic(at(DiagCode::EXPECTED_LET_SEMICOLON, src, "foo"), src, out);
+    EXPECT_NE(out.find("\n   |           ^^^\n"), std::string::npos) << out;
+}
+
+TEST(Diag, TabsAreKeptInThePadding) {
+    std::string src = "\tx y;";
+    std::string out;
+    renderDiagnostic(at(DiagCode::EXPECTED_EXPR_SEMICOLON, src, "y"), src, out);
+    EXPECT_NE(out.find("\n   | \t  ^\n"), std::string::npos) << out;
+}
+
+TEST(Diag, EndOfFileCaret) {
+    std::string src = "let x = 1";
+    Diagnostic d{DiagCode::EXPECTED_LET_SEMICOLON, 1, static_cast<uint32_t>(src.size()), 0, 0};
+    std::string out;
+    renderDiagnostic(d, src, out);
+    EXPECT_EQ(out,
+              "Parse error [line 1]: Expected ';' after let statement\n"
+              " 1 | let x = 1\n"
+              "   |          ^\n");
+}
+
+TEST(Diag, LongLinesShowAWindow) {
+    std::string src = std::string(200, 'a') + " ; " + std::string(200, 'b');
+    std::string out;
+    renderDiagnostic(at(DiagCode::UNEXPECTED_TOKEN, src, ";"), src, out);
+    std::string snippet = out.substr(out.find('\n') + 1);
+    EXPECT_EQ(snippet.find(" 1 | ..."), 0u) << out;
+    EXPECT_NE(snippet.find("...\n"), std::string::npos) << out;
+    EXPECT_LT(snippet.size(), 2 * 100u) << out;
+}
+
+TEST(Diag, ControlBytesInTheSnippet) {
+    std::string src = std::string("\x02 ;");
+    std::string out;
+    renderDiagnostic(at(DiagCode::UNEXPECTED_TOKEN, src, ";"), src, out);
+    EXPECT_NE(out.find(" 1 | ? ;\n"), std::string::npos) << out;
+}
+
+TEST(Diag, LaterStageErrors) {
+    std::string out;
+    renderLineError("Semantic", 3, "Undefined variable 'x'", out);
+    renderFunctionError("Runtime", "div", "division by zero", out);
+    EXPECT_EQ(out,
+              "Semantic error [line 3]: Undefined variable 'x'\n"
+              "Runtime error in 'div': division by zero\n");
+}
+
+TEST(Diag, RenderingStaysLinearWithoutNewlines) {
+    // One 1 MB line with an error every 100 bytes: each rendering must only
+    // look at the bytes around its token.
+    std::string src(1 << 20, 'x');
+    std::vector<Diagnostic> diagnostics;
+    for (uint32_t offset = 0; offset < src.size(); offset += 100) {
+        diagnostics.push_back(Diagnostic{DiagCode::UNEXPECTED_TOKEN, 1, offset, 1, 0});
+    }
+    std::string out = renderDiagnostics(diagnostics, src);
+    EXPECT_LT(out.size(), diagnostics.size() * 200);
+}
@@ -0,0 +1,3 @@
+fn main() {
+    let x = 1 * 1 - 2 < 3 / 4 == 5 + 6 + 7 * 8 - 9 < 0 / 1 == 2 + 3 + 4 * 5 - 6 < 7 / 8 == 9 + 0 + 1 * 2 - 3 < 4 / 5 == 6 + 7 + 8 * 9 - 0 < 1 / 2 == 3 + 4 + 5 * 6 - 7 < 8 / 9 == 0 + 1 + 2 * 3 - 4 < 5 / 6 == 7 + 8 + 9 * 0 - 1 < 2 / 3 == 4 + 5 + 6 * 7 - 8 < 9 / 0 == 1 + 2 + 3 * 4 - 5 < 6 / 7 == 8 + 9 + 0 * 1 - 2 < 3 / 4 == 5 + 6 + 7 * 8 - 9 < 0 / 1 == 2 + 3 + 4 * 5 - 6 < 7 / 8 == 9 + 0 + 1 * 2 - 3 < 4 / 5 == 6 + 7 + 8 * 9 - 0 < 1 / 2 == 3 + 4 + 5 * 6 - 7 < 8 / 9 == 0 + 1 + 2 * 3 - 4 < 5 / 6 == 7 + 8 + 9;
+}
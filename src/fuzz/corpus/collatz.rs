@@ -0,0 +1,30 @@
+// Longest Collatz chain below a bound.
+fn steps(start: i64) {
+    let mut n = start;
+    let mut count = 0;
+    while n != 1 {
+        let half = n / 2;
+        if half * 2 == n {
+            n = half;
+        } else {
+            n = 3 * n + 1;
+        }
+        count = count + 1;
+    }
+    return count;
+}
+
+fn main() {
+    let mut best = 0;
+    let mut arg = 0;
+    let mut i = 1;
+    while i < 3000 {
+        let s = steps(i);
+        if s > best {
+            best = s;
+            arg = i;
+        }
+        i = i + 1;
+    }
+    return arg * 1000 + best;
+}
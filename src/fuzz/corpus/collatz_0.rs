@@ -0,0 +1,16 @@
+// Longest Collatz chain below a bound.
+fn steps(start: i64) {
+    let mut n = start;
+    let mut count = 0;
+    while n != 1 {
+        let half = n / 2;
+        if half * 2 == n {
+            n = half;
+        } else {
+            n = 3 * n + 1;
+        }
+        count = count + 1;
+    }
+    return count;
+}
+
@@ -0,0 +1,14 @@
+fn main() {
+    let mut best = 0;
+    let mut arg = 0;
+    let mut i = 1;
+    while i < 3000 {
+        let s = steps(i);
+        if s > best {
+            best = s;
+            arg = i;
+        }
+        i = i + 1;
+    }
+    return arg * 1000 + best;
+}
@@ -0,0 +1,26 @@
+// Recursive and iterative Fibonacci.
+fn fib_rec(n: i64) {
+    if n < 2 {
+        return n;
+    }
+    return fib_rec(n - 1) + fib_rec(n - 2);
+}
+
+fn fib_iter(n: i64) {
+    let mut a = 0;
+    let mut b = 1;
+    let mut i = 0;
+    while i < n {
+        let next = a + b;
+        a = b;
+        b = next;
+        i = i + 1;
+    }
+    return a;
+}
+
+fn main() {
+    let r = fib_rec(20);
+    let s = fib_iter(50);
+    return r + s;
+}
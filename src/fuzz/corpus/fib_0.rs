@@ -0,0 +1,8 @@
+// Recursive and iterative Fibonacci.
+fn fib_rec(n: i64) {
+    if n < 2 {
+        return n;
+    }
+    return fib_rec(n - 1) + fib_rec(n - 2);
+}
+
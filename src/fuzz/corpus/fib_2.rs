@@ -0,0 +1,5 @@
+fn main() {
+    let r = fib_rec(20);
+    let s = fib_iter(50);
+    return r + s;
+}
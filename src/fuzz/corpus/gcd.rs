@@ -0,0 +1,27 @@
+// Euclid's algorithm by repeated subtraction, summed over a grid of inputs.
+fn gcd(x: i64, y: i64) {
+    let mut a = x;
+    let mut b = y;
+    while a != b {
+        if a > b {
+            a = a - b;
+        } else {
+            b = b - a;
+        }
+    }
+    return a;
+}
+
+fn main() {
+    let mut total = 0;
+    let mut i = 1;
+    while i <= 60 {
+        let mut j = 1;
+        while j <= 60 {
+            total = total + gcd(i, j);
+            j = j + 1;
+        }
+        i = i + 1;
+    }
+    return total;
+}
@@ -0,0 +1,14 @@
+// Euclid's algorithm by repeated subtraction, summed over a grid of inputs.
+fn gcd(x: i64, y: i64) {
+    let mut a = x;
+    let mut b = y;
+    while a != b {
+        if a > b {
+            a = a - b;
+        } else {
+            b = b - a;
+        }
+    }
+    return a;
+}
+
@@ -0,0 +1,13 @@
+fn main() {
+    let mut total = 0;
+    let mut i = 1;
+    while i <= 60 {
+        let mut j = 1;
+        while j <= 60 {
+            total = total + gcd(i, j);
+            j = j + 1;
+        }
+        i = i + 1;
+    }
+    return total;
+}
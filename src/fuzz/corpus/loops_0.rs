@@ -0,0 +1,12 @@
+// Nested loops with redundant temporaries and reassignments.
+fn weight(i: i64, j: i64) {
+    let a = i * 3;
+    let b = a + 0;
+    let c = b;
+    let unused = c * j;
+    if c > j {
+        return c - j;
+    }
+    return j - c;
+}
+
@@ -0,0 +1,16 @@
+fn main() {
+    let mut sum = 0;
+    let mut i = 0;
+    while i < 200 {
+        let mut j = 0;
+        let mut row = 0;
+        while j < 200 {
+            let w = weight(i, j);
+            row = row + w;
+            j = j + 1;
+        }
+        sum = sum + row / 200;
+        i = i + 1;
+    }
+    return sum;
+}
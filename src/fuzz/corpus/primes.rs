@@ -0,0 +1,25 @@
+// Counts primes by trial division.
+fn is_prime(n: i64) {
+    if n < 2 {
+        return 0;
+    }
+    let mut d = 2;
+    while d * d <= n {
+        let q = n / d;
+        if q * d == n {
+            return 0;
+        }
+        d = d + 1;
+    }
+    return 1;
+}
+
+fn main() {
+    let mut count = 0;
+    let mut n = 0;
+    while n < 20000 {
+        count = count + is_prime(n);
+        n = n + 1;
+    }
+    return count;
+}
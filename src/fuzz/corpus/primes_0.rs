@@ -0,0 +1,16 @@
+// Counts primes by trial division.
+fn is_prime(n: i64) {
+    if n < 2 {
+        return 0;
+    }
+    let mut d = 2;
+    while d * d <= n {
+        let q = n / d;
+        if q * d == n {
+            return 0;
+        }
+        d = d + 1;
+    }
+    return 1;
+}
+
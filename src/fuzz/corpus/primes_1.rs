@@ -0,0 +1,9 @@
+fn main() {
+    let mut count = 0;
+    let mut n = 0;
+    while n < 20000 {
+        count = count + is_prime(n);
+        n = n + 1;
+    }
+    return count;
+}
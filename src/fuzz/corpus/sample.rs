@@ -0,0 +1,14 @@
+fn main() {
+    let x = 42;
+    let mut y = 0;
+    if x == y {
+        return;
+    } else {
+        y = x + 1;
+    }
+    fn_name;
+    // this is a comment
+    while y > 0 {
+        y = y - 1;
+    }
+}
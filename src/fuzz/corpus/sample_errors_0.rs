@@ -0,0 +1,2 @@
+// Missing semicolons
+let x = 42
@@ -0,0 +1,12 @@
+let mut y = 10
+
+// Missing expression after operator
+let z = 1 + ;
+
+// Incomplete function declaration
+fn {}
+
+// Missing closing brace
+fn broken() {
+    let a = 1;
+
@@ -0,0 +1,97 @@
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// ============================================================
+// Time budget — flags inputs that take more than linear time
+// ============================================================
+//
+// The lexer and the parser (error recovery included) are linear in the
+// input size. runWithBudget() times one run of a fuzz target and aborts,
+// as a crash would, if it took longer than
+//
+//     fixed + perByte * size
+//
+// so that libFuzzer saves the input alongside its crashes. A run over
+// budget is repeated twice and the fastest of the three is what counts,
+// which keeps a scheduling hiccup from being reported as a cliff.
+//
+// The defaults leave room for an unoptimized build under ASan and UBSan;
+// RUSTC_FUZZ_BUDGET_FIXED_NS and RUSTC_FUZZ_BUDGET_NS_PER_BYTE override
+// them (0 turns the check off). With RUSTC_FUZZ_TIMES=FILE every input's
+// size and time in nanoseconds are appended to FILE, one per line.
+struct TimeBudget {
+    static constexpr uint64_t DEFAULT_FIXED_NS = 20'000'000;  // 20 ms
+    static constexpr uint64_t DEFAULT_NS_PER_BYTE = 10'000;
+
+    uint64_t fixedNs = DEFAULT_FIXED_NS;
+    uint64_t nsPerByte = DEFAULT_NS_PER_BYTE;
+    std::FILE* times = nullptr;
+
+    static TimeBudget fromEnvironment() {
+        TimeBudget budget;
+        if (const char* v = std::getenv("RUSTC_FUZZ_BUDGET_FIXED_NS")) {
+            budget.fixedNs = std::strtoull(v, nullptr, 10);
+        }
+        if (const char* v = std::getenv("RUSTC_FUZZ_BUDGET_NS_PER_BYTE")) {
+            budget.nsPerByte = std::strtoull(v, nullptr, 10);
+        }
+        if (const char* v = std::getenv("RUSTC_FUZZ_TIMES")) budget.times = std::fopen(v, "a");
+        return budget;
+    }
+
+    bool enabled() const { return nsPerByte != 0 || fixedNs != 0; }
+    uint64_t limitNs(size_t size) const { return fixedNs + nsPerByte * size; }
+};
+
+template <typename Fn>
+uint64_t timeNs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+// Runs `fn` on an input of `size` bytes under the process-wide budget.
+template <typename Fn>
+void runWithBudget(const char* target, size_t size, Fn&& fn) {
+    static const TimeBudget budget = TimeBudget::fromEnvironment();
+    uint64_t ns = timeNs(fn);
+    if (budget.enabled() && ns > budget.limitNs(size)) {
+        for (int retry = 0; retry < 2; ++retry) {
+            uint64_t again = timeNs(fn);
+            if (again < ns) ns = again;
+        }
+    }
+    if (budget.times) {
+        std::fprintf(budget.times, "%zu\t%llu\n", size, static_cast<unsigned long long>(ns));
+        std::fflush(budget.times);
+    }
+    if (budget.enabled() && ns > budget.limitNs(size)) {
+        std::fprintf(stderr,
+                     "%s: %zu-byte input took %.3f ms, over its linear-time budget of %.3f ms "
+                     "(%.0f ns/byte)\n",
+                     target, size, ns / 1e6, budget.limitNs(size) / 1e6,
+                     size ? static_cast<double>(ns) / size : 0.0);
+        std::abort();
+    }
+}
+
+// ============================================================
+// FUZZ_CHECK — an invariant of the target; a violation is a crash
+// ============================================================
+#define FUZZ_CHECK(cond)                                                                 \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::abort();                                                                \
+        }                                                                                \
+    } while (0)
+
+#endif // FUZZ_H
@@ -0,0 +1,70 @@
+#include "fuzz.h"
+#include "../lexer/lexer.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// lexer_fuzz — Lexer::tokenize() and Lexer::applyEdit()
+// ============================================================
+//
+// Besides not crashing, the token stream must cover the input in order:
+// every token lies inside the source, starts at or after the end of the
+// one before it, and lines never go back. Exactly one EOF, at the end.
+// Operator, keyword, identifier and number lexemes are the source bytes
+// they cover.
+//
+// The middle third of the input is then deleted with applyEdit(), which
+// must give the same tokens as lexing the edited source from scratch.
+static void checkTokens(const std::string& source, const std::vector<Token>& tokens) {
+    FUZZ_CHECK(!tokens.empty());
+    FUZZ_CHECK(tokens.back().type == TokenType::EOF_TOKEN);
+    FUZZ_CHECK(tokens.back().offset == source.size() || tokens.back().length == 0);
+    size_t end = 0;
+    int line = 1;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& t = tokens[i];
+        FUZZ_CHECK(t.type != TokenType::EOF_TOKEN || i + 1 == tokens.size());
+        FUZZ_CHECK(t.offset >= end);
+        FUZZ_CHECK(t.offset + t.length <= source.size());
+        FUZZ_CHECK(t.line >= line);
+        if (t.type != TokenType::STRING && t.type != TokenType::CHAR &&
+            t.type != TokenType::ILLEGAL && t.type != TokenType::EOF_TOKEN) {
+            FUZZ_CHECK(source.compare(t.offset, t.length, t.lexeme) == 0);
+        }
+        end = t.offset + t.length;
+        line = t.line;
+    }
+}
+
+static bool sameTokens(const std::vector<Token>& a, const std::vector<Token>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].lexeme != b[i].lexeme || a[i].line != b[i].line ||
+            a[i].offset != b[i].offset || a[i].length != b[i].length ||
+            a[i].flags != b[i].flags) {
+            return false;
+        }
+    }
+    return true;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string source(reinterpret_cast<const char*>(data), size);
+    runWithBudget("lexer_fuzz", size, [&] {
+        Lexer lexer(source);
+        std::vector<Token> tokens = lexer.tokenize();
+        checkTokens(source, tokens);
+
+        TextEdit edit{size / 3, size - size / 3, ""};
+        std::string edited = source;
+        edited.erase(edit.begin, edit.end - edit.begin);
+        TokenBuffer buffer(std::move(tokens));
+        lexer.applyEdit(edit, buffer);
+        FUZZ_CHECK(sameTokens(buffer.toVector(), Lexer(edited).tokenize()));
+        FUZZ_CHECK(lexer.text() == edited);
+    });
+    return 0;
+}
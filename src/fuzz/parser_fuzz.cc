@@ -0,0 +1,55 @@
+#include "fuzz.h"
+#include "../ast/ast_visitor.h"
+#include "../ast/compact_ast.h"
+#include "../parser/parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ============================================================
+// parser_fuzz — Parser::parseProgram() and its diagnostics
+// ============================================================
+//
+// Any input must parse without crashing, within the nesting limit and in
+// linear time, error recovery included. Every diagnostic points inside
+// the source and renders; item offsets are increasing. A program that
+// parsed cleanly must also flatten into a CompactAst with one record per
+// node of the pointer tree.
+struct NodeCounter : AstVisitor<NodeCounter> {
+    size_t nodes = 0;
+    bool enter(const AstNode*) {
+        ++nodes;
+        return true;
+    }
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string source(reinterpret_cast<const char*>(data), size);
+    runWithBudget("parser_fuzz", size, [&] {
+        Parser parser(source);
+        auto program = parser.parseProgram();
+        FUZZ_CHECK(program != nullptr);
+
+        for (const Diagnostic& d : parser.diagnostics()) {
+            FUZZ_CHECK(static_cast<size_t>(d.offset) + d.length <= size);
+        }
+        FUZZ_CHECK(parser.hasErrors() == !parser.diagnostics().empty());
+        FUZZ_CHECK(!parser.stoppedEarly() || parser.hasErrors());
+        std::string rendered = renderDiagnostics(parser.diagnostics(), source);
+        FUZZ_CHECK(parser.hasErrors() == !rendered.empty());
+
+        const std::vector<size_t>& offsets = parser.itemOffsets();
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            FUZZ_CHECK(offsets[i] < size);
+            FUZZ_CHECK(i == 0 || offsets[i - 1] < offsets[i]);
+        }
+
+        if (!parser.hasErrors()) {
+            NodeCounter counter;
+            counter.walkIterative(program.get());
+            CompactAst compact = CompactAst::build(program.get());
+            FUZZ_CHECK(compact.nodes().size() == counter.nodes);
+        }
+    });
+    return 0;
+}
@@ -0,0 +1,2000 @@
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
+let = ;
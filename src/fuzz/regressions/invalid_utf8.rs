@@ -0,0 +1,1136 @@
+/*  */ let s = "😀";
+x́ + €;
+r#""#;
+let s = "😀";
+let s = "😀";
+//  
+変数 = 2;
+let s = "😀";
+変数 = 2;
+let café = 1;
+//  
+r#""#;
+//  
+let s = "😀";
+変数 = 2;
+let s = "😀";
+let s = "😀";
+let café = 1;
+x́ + €;
+/*  */ /*  */ //  
+x́ + €;
+x́ + €;
+let café = 1;
+x́ + €;
+let s = "😀";
+/*  */ r#""#;
+let s = "😀";
+r#""#;
+x́ + €;
+let café = 1;
+/*  */ //  
+x́ + €;
+x́ + €;
+変数 = 2;
+//  
+//  
+let s = "😀";
+/*  */ 変数 = 2;
+/*  */ r#""#;
+//  
+let café = 1;
+/*  */ r#""#;
+r#""#;
+/*  */ let café = 1;
+r#""#;
+変数 = 2;
+r#""#;
+x́ + €;
+let s = "😀";
+/*  */ 変数 = 2;
+let s = "😀";
+let s = "😀";
+let s = "😀";
+x́ + €;
+r#""#;
+r#""#;
+r#""#;
+let café = 1;
+変数 = 2;
+x́ + €;
+let café = 1;
+//  
+let café = 1;
+let café = 1;
+let café = 1;
+/*  */ /*  */ //  
+変数 = 2;
+変数 = 2;
+//  
+変数 = 2;
+//  
+変数 = 2;
+let s = "😀";
+//  
+/*  */ let café = 1;
+r#""#;
+r#""#;
+let café = 1;
+x́ + €;
+let café = 1;
+/*  */ r#""#;
+r#""#;
+//  
+変数 = 2;
+/*  */ //  
+let café = 1;
+//  
+let s = "😀";
+//  
+let s = "😀";
+x́ + €;
+/*  */ let s = "😀";
+r#""#;
+let café = 1;
+//  
+//  
+r#""#;
+let café = 1;
+x́ + €;
+let s = "😀";
+//  
+let s = "😀";
+//  
+//  
+r#""#;
+変数 = 2;
+/*  */ 変数 = 2;
+r#""#;
+x́ + €;
+x́ + €;
+変数 = 2;
+let s = "😀";
+let café = 1;
+変数 = 2;
+r#""#;
+x́ + €;
+//  
+let café = 1;
+let s = "😀";
+r#""#;
+//  
+/*  */ r#""#;
+let café = 1;
+/*  */ let s = "😀";
+/*  */ let s = "😀";
+let café = 1;
+let café = 1;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+/*  */ //  
+let café = 1;
+let café = 1;
+//  
+let café = 1;
+let s = "😀";
+r#""#;
+//  
+let café = 1;
+変数 = 2;
+変数 = 2;
+let s = "😀";
+//  
+//  
+x́ + €;
+//  
+r#""#;
+x́ + €;
+/*  */ //  
+x́ + €;
+let s = "😀";
+/*  */ r#""#;
+r#""#;
+/*  */ /*  */ /*  */ let s = "😀";
+変数 = 2;
+//  
+let s = "😀";
+x́ + €;
+r#""#;
+//  
+x́ + €;
+変数 = 2;
+r#""#;
+x́ + €;
+変数 = 2;
+//  
+r#""#;
+//  
+x́ + €;
+x́ + €;
+let café = 1;
+r#""#;
+/*  */ r#""#;
+let s = "😀";
+x́ + €;
+/*  */ let s = "😀";
+r#""#;
+//  
+let café = 1;
+let café = 1;
+//  
+/*  */ r#""#;
+let s = "😀";
+x́ + €;
+x́ + €;
+r#""#;
+let s = "😀";
+x́ + €;
+let s = "😀";
+/*  */ /*  */ 変数 = 2;
+//  
+r#""#;
+let café = 1;
+let café = 1;
+変数 = 2;
+/*  */ x́ + €;
+r#""#;
+/*  */ /*  */ let s = "😀";
+let café = 1;
+変数 = 2;
+r#""#;
+r#""#;
+//  
+let café = 1;
+変数 = 2;
+let s = "😀";
+x́ + €;
+let café = 1;
+r#""#;
+x́ + €;
+r#""#;
+//  
+変数 = 2;
+let café = 1;
+/*  */ //  
+let s = "😀";
+let s = "😀";
+r#""#;
+//  
+let café = 1;
+/*  */ //  
+変数 = 2;
+//  
+変数 = 2;
+x́ + €;
+//  
+let café = 1;
+変数 = 2;
+変数 = 2;
+//  
+/*  */ 変数 = 2;
+r#""#;
+変数 = 2;
+//  
+let s = "😀";
+//  
+変数 = 2;
+let s = "😀";
+/*  */ 変数 = 2;
+let café = 1;
+//  
+変数 = 2;
+let café = 1;
+//  
+x́ + €;
+変数 = 2;
+//  
+変数 = 2;
+//  
+x́ + €;
+x́ + €;
+/*  */ let s = "😀";
+変数 = 2;
+let café = 1;
+let café = 1;
+//  
+//  
+//  
+/*  */ 変数 = 2;
+let café = 1;
+let s = "😀";
+//  
+x́ + €;
+/*  */ r#""#;
+let s = "😀";
+let café = 1;
+//  
+let s = "😀";
+let café = 1;
+let café = 1;
+r#""#;
+r#""#;
+let café = 1;
+変数 = 2;
+//  
+let café = 1;
+r#""#;
+let s = "😀";
+変数 = 2;
+/*  */ r#""#;
+/*  */ r#""#;
+//  
+//  
+//  
+変数 = 2;
+/*  */ //  
+x́ + €;
+x́ + €;
+r#""#;
+x́ + €;
+/*  */ let café = 1;
+r#""#;
+let s = "😀";
+r#""#;
+r#""#;
+r#""#;
+x́ + €;
+x́ + €;
+x́ + €;
+x́ + €;
+r#""#;
+/*  */ let café = 1;
+変数 = 2;
+/*  */ 変数 = 2;
+//  
+/*  */ r#""#;
+r#""#;
+let s = "😀";
+let s = "😀";
+/*  */ /*  */ r#""#;
+/*  */ //  
+let s = "😀";
+//  
+/*  */ let café = 1;
+x́ + €;
+r#""#;
+let s = "😀";
+let s = "😀";
+//  
+//  
+let café = 1;
+r#""#;
+x́ + €;
+let s = "😀";
+let café = 1;
+変数 = 2;
+//  
+x́ + €;
+//  
+let café = 1;
+変数 = 2;
+r#""#;
+x́ + €;
+変数 = 2;
+変数 = 2;
+let s = "😀";
+let s = "😀";
+x́ + €;
+x́ + €;
+r#""#;
+変数 = 2;
+/*  */ x́ + €;
+let café = 1;
+let café = 1;
+r#""#;
+変数 = 2;
+/*  */ r#""#;
+r#""#;
+変数 = 2;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+変数 = 2;
+変数 = 2;
+x́ + €;
+r#""#;
+//  
+//  
+x́ + €;
+let café = 1;
+let s = "😀";
+let s = "😀";
+let café = 1;
+r#""#;
+x́ + €;
+変数 = 2;
+x́ + €;
+変数 = 2;
+let s = "😀";
+let s = "😀";
+/*  */ let s = "😀";
+変数 = 2;
+let s = "😀";
+//  
+//  
+変数 = 2;
+r#""#;
+let s = "😀";
+let s = "😀";
+//  
+let s = "😀";
+/*  */ 変数 = 2;
+let café = 1;
+let s = "😀";
+変数 = 2;
+r#""#;
+x́ + €;
+x́ + €;
+let café = 1;
+r#""#;
+//  
+変数 = 2;
+x́ + €;
+let s = "😀";
+x́ + €;
+r#""#;
+/*  */ let s = "😀";
+/*  */ x́ + €;
+//  
+let café = 1;
+//  
+let café = 1;
+r#""#;
+//  
+//  
+/*  */ /*  */ /*  */ r#""#;
+変数 = 2;
+r#""#;
+x́ + €;
+//  
+let s = "😀";
+変数 = 2;
+x́ + €;
+r#""#;
+変数 = 2;
+let s = "😀";
+/*  */ let s = "😀";
+let s = "😀";
+変数 = 2;
+x́ + €;
+//  
+let s = "😀";
+/*  */ let s = "😀";
+let café = 1;
+変数 = 2;
+/*  */ r#""#;
+let s = "😀";
+x́ + €;
+//  
+r#""#;
+let s = "😀";
+//  
+r#""#;
+x́ + €;
+変数 = 2;
+let s = "😀";
+//  
+//  
+//  
+let s = "😀";
+/*  */ r#""#;
+変数 = 2;
+x́ + €;
+変数 = 2;
+x́ + €;
+/*  */ let café = 1;
+r#""#;
+/*  */ //  
+r#""#;
+let café = 1;
+r#""#;
+/*  */ let café = 1;
+let café = 1;
+変数 = 2;
+let café = 1;
+let café = 1;
+/*  */ //  
+let café = 1;
+変数 = 2;
+/*  */ let café = 1;
+let café = 1;
+変数 = 2;
+//  
+/*  */ let café = 1;
+//  
+x́ + €;
+/*  */ //  
+変数 = 2;
+//  
+//  
+変数 = 2;
+r#""#;
+/*  */ /*  */ let s = "😀";
+let café = 1;
+//  
+//  
+r#""#;
+//  
+変数 = 2;
+let s = "😀";
+r#""#;
+let café = 1;
+変数 = 2;
+r#""#;
+r#""#;
+/*  */ let café = 1;
+let s = "😀";
+let café = 1;
+//  
+//  
+let café = 1;
+let s = "😀";
+let café = 1;
+//  
+/*  */ let café = 1;
+//  
+let café = 1;
+/*  */ //  
+変数 = 2;
+/*  */ r#""#;
+r#""#;
+/*  */ 変数 = 2;
+let s = "😀";
+let café = 1;
+x́ + €;
+let s = "😀";
+let café = 1;
+r#""#;
+変数 = 2;
+/*  */ let café = 1;
+変数 = 2;
+//  
+/*  */ //  
+x́ + €;
+//  
+let café = 1;
+変数 = 2;
+r#""#;
+r#""#;
+r#""#;
+let s = "😀";
+r#""#;
+/*  */ x́ + €;
+x́ + €;
+r#""#;
+x́ + €;
+//  
+let café = 1;
+変数 = 2;
+r#""#;
+x́ + €;
+変数 = 2;
+/*  */ let café = 1;
+let s = "😀";
+/*  */ let café = 1;
+let café = 1;
+r#""#;
+//  
+x́ + €;
+let s = "😀";
+r#""#;
+//  
+r#""#;
+//  
+/*  */ let café = 1;
+let s = "😀";
+r#""#;
+let s = "😀";
+変数 = 2;
+let s = "😀";
+let café = 1;
+x́ + €;
+/*  */ r#""#;
+x́ + €;
+/*  */ let s = "😀";
+let café = 1;
+/*  */ let s = "😀";
+let s = "😀";
+/*  */ 変数 = 2;
+let café = 1;
+let café = 1;
+let s = "😀";
+/*  */ /*  */ /*  */ /*  */ let café = 1;
+x́ + €;
+let s = "😀";
+//  
+/*  */ let s = "😀";
+let café = 1;
+//  
+x́ + €;
+変数 = 2;
+r#""#;
+let café = 1;
+変数 = 2;
+/*  */ //  
+変数 = 2;
+/*  */ let café = 1;
+x́ + €;
+変数 = 2;
+/*  */ /*  */ 変数 = 2;
+/*  */ /*  */ r#""#;
+/*  */ let café = 1;
+変数 = 2;
+//  
+/*  */ r#""#;
+変数 = 2;
+let café = 1;
+x́ + €;
+x́ + €;
+let café = 1;
+let café = 1;
+x́ + €;
+let café = 1;
+//  
+x́ + €;
+//  
+/*  */ let s = "😀";
+let s = "😀";
+//  
+let café = 1;
+x́ + €;
+x́ + €;
+/*  */ 変数 = 2;
+x́ + €;
+let café = 1;
+x́ + €;
+//  
+let café = 1;
+変数 = 2;
+/*  */ //  
+x́ + €;
+x́ + €;
+let s = "😀";
+r#""#;
+r#""#;
+/*  */ 変数 = 2;
+/*  */ 変数 = 2;
+/*  */ /*  */ let café = 1;
+r#""#;
+let s = "😀";
+変数 = 2;
+変数 = 2;
+//  
+let café = 1;
+x́ + €;
+r#""#;
+変数 = 2;
+//  
+/*  */ r#""#;
+x́ + €;
+変数 = 2;
+x́ + €;
+変数 = 2;
+//  
+変数 = 2;
+let s = "😀";
+let s = "😀";
+//  
+let s = "😀";
+let s = "😀";
+x́ + €;
+let café = 1;
+変数 = 2;
+r#""#;
+let s = "😀";
+//  
+/*  */ x́ + €;
+/*  */ /*  */ 変数 = 2;
+変数 = 2;
+x́ + €;
+let s = "😀";
+let s = "😀";
+//  
+r#""#;
+/*  */ let s = "😀";
+r#""#;
+変数 = 2;
+let s = "😀";
+let café = 1;
+//  
+r#""#;
+r#""#;
+変数 = 2;
+x́ + €;
+let s = "😀";
+r#""#;
+/*  */ //  
+x́ + €;
+let s = "😀";
+/*  */ let s = "😀";
+変数 = 2;
+x́ + €;
+x́ + €;
+//  
+/*  */ //  
+変数 = 2;
+変数 = 2;
+変数 = 2;
+x́ + €;
+変数 = 2;
+//  
+変数 = 2;
+//  
+変数 = 2;
+let café = 1;
+//  
+/*  */ x́ + €;
+x́ + €;
+//  
+x́ + €;
+r#""#;
+let café = 1;
+let s = "😀";
+let s = "😀";
+let s = "😀";
+/*  */ let s = "😀";
+r#""#;
+/*  */ x́ + €;
+let café = 1;
+//  
+let s = "😀";
+変数 = 2;
+let café = 1;
+let s = "😀";
+変数 = 2;
+//  
+/*  */ let s = "😀";
+変数 = 2;
+let café = 1;
+x́ + €;
+r#""#;
+x́ + €;
+/*  */ //  
+r#""#;
+let café = 1;
+let s = "😀";
+//  
+let s = "😀";
+let café = 1;
+let café = 1;
+変数 = 2;
+/*  */ x́ + €;
+x́ + €;
+r#""#;
+x́ + €;
+変数 = 2;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+x́ + €;
+変数 = 2;
+r#""#;
+変数 = 2;
+let café = 1;
+/*  */ let s = "😀";
+let café = 1;
+let s = "😀";
+x́ + €;
+変数 = 2;
+/*  */ 変数 = 2;
+/*  */ 変数 = 2;
+let café = 1;
+//  
+let s = "😀";
+/*  */ r#""#;
+/*  */ let s = "😀";
+/*  */ let café = 1;
+let café = 1;
+変数 = 2;
+let s = "😀";
+x́ + €;
+let café = 1;
+/*  */ /*  */ let s = "😀";
+x́ + €;
+変数 = 2;
+変数 = 2;
+//  
+r#""#;
+x́ + €;
+x́ + €;
+変数 = 2;
+let s = "😀";
+let café = 1;
+変数 = 2;
+let café = 1;
+/*  */ r#""#;
+r#""#;
+//  
+let café = 1;
+/*  */ x́ + €;
+x́ + €;
+r#""#;
+let s = "😀";
+/*  */ let s = "😀";
+let s = "😀";
+r#""#;
+/*  */ let café = 1;
+//  
+/*  */ 変数 = 2;
+let café = 1;
+/*  */ /*  */ let s = "😀";
+//  
+let s = "😀";
+/*  */ //  
+//  
+x́ + €;
+x́ + €;
+//  
+x́ + €;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+変数 = 2;
+let s = "😀";
+/*  */ let café = 1;
+let s = "😀";
+r#""#;
+変数 = 2;
+//  
+r#""#;
+//  
+変数 = 2;
+変数 = 2;
+x́ + €;
+x́ + €;
+let café = 1;
+let s = "😀";
+/*  */ x́ + €;
+r#""#;
+/*  */ let café = 1;
+変数 = 2;
+/*  */ r#""#;
+/*  */ 変数 = 2;
+let café = 1;
+//  
+変数 = 2;
+変数 = 2;
+let café = 1;
+r#""#;
+let s = "😀";
+let café = 1;
+変数 = 2;
+x́ + €;
+変数 = 2;
+変数 = 2;
+let s = "😀";
+//  
+変数 = 2;
+/*  */ /*  */ x́ + €;
+//  
+r#""#;
+let café = 1;
+let s = "😀";
+変数 = 2;
+x́ + €;
+変数 = 2;
+let café = 1;
+r#""#;
+r#""#;
+x́ + €;
+変数 = 2;
+let s = "😀";
+let s = "😀";
+x́ + €;
+r#""#;
+let café = 1;
+//  
+/*  */ r#""#;
+x́ + €;
+x́ + €;
+変数 = 2;
+/*  */ /*  */ //  
+r#""#;
+変数 = 2;
+x́ + €;
+/*  */ let s = "😀";
+r#""#;
+x́ + €;
+let café = 1;
+変数 = 2;
+x́ + €;
+//  
+x́ + €;
+let café = 1;
+変数 = 2;
+let s = "😀";
+/*  */ let café = 1;
+let s = "😀";
+r#""#;
+let café = 1;
+//  
+let s = "😀";
+//  
+let café = 1;
+r#""#;
+//  
+r#""#;
+/*  */ let café = 1;
+r#""#;
+let s = "😀";
+/*  */ r#""#;
+x́ + €;
+/*  */ r#""#;
+x́ + €;
+r#""#;
+x́ + €;
+変数 = 2;
+変数 = 2;
+let café = 1;
+/*  */ //  
+let café = 1;
+/*  */ r#""#;
+変数 = 2;
+let café = 1;
+r#""#;
+let café = 1;
+x́ + €;
+r#""#;
+let café = 1;
+r#""#;
+変数 = 2;
+/*  */ let café = 1;
+//  
+r#""#;
+x́ + €;
+変数 = 2;
+/*  */ /*  */ let s = "😀";
+//  
+/*  */ let café = 1;
+let café = 1;
+x́ + €;
+let café = 1;
+x́ + €;
+x́ + €;
+x́ + €;
+/*  */ //  
+x́ + €;
+変数 = 2;
+let s = "😀";
+let s = "😀";
+変数 = 2;
+変数 = 2;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+let s = "😀";
+変数 = 2;
+x́ + €;
+let café = 1;
+/*  */ x́ + €;
+変数 = 2;
+/*  */ /*  */ let s = "😀";
+x́ + €;
+/*  */ 変数 = 2;
+let s = "😀";
+//  
+let s = "😀";
+let café = 1;
+/*  */ 変数 = 2;
+変数 = 2;
+let s = "😀";
+/*  */ let café = 1;
+/*  */ let café = 1;
+let s = "😀";
+/*  */ //  
+//  
+x́ + €;
+x́ + €;
+//  
+//  
+x́ + €;
+r#""#;
+r#""#;
+変数 = 2;
+/*  */ let s = "😀";
+let s = "😀";
+let s = "😀";
+let café = 1;
+let café = 1;
+r#""#;
+変数 = 2;
+x́ + €;
+r#""#;
+r#""#;
+let s = "😀";
+r#""#;
+x́ + €;
+変数 = 2;
+x́ + €;
+let café = 1;
+//  
+x́ + €;
+/*  */ let café = 1;
+x́ + €;
+変数 = 2;
+r#""#;
+r#""#;
+let café = 1;
+let café = 1;
+変数 = 2;
+//  
+let s = "😀";
+let café = 1;
+x́ + €;
+r#""#;
+let s = "😀";
+let café = 1;
+r#""#;
+//  
+let s = "😀";
+let café = 1;
+x́ + €;
+x́ + €;
+//  
+/*  */ //  
+変数 = 2;
+x́ + €;
+x́ + €;
+let s = "😀";
+x́ + €;
+let s = "😀";
+/*  */ r#""#;
+let café = 1;
+/*  */ 変数 = 2;
+let café = 1;
+/*  */ //  
+let café = 1;
+r#""#;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+/*  */ /*  */ r#""#;
+//  
+let café = 1;
+let s = "😀";
+r#""#;
+//  
+r#""#;
+let s = "😀";
+r#""#;
+変数 = 2;
+let s = "😀";
+変数 = 2;
+r#""#;
+変数 = 2;
+変数 = 2;
+let café = 1;
+//  
+x́ + €;
+let s = "😀";
+変数 = 2;
+変数 = 2;
+let café = 1;
+let café = 1;
+let café = 1;
+/*  */ r#""#;
+let s = "😀";
+変数 = 2;
+x́ + €;
+x́ + €;
+let s = "😀";
+//  
+//  
+let café = 1;
+x́ + €;
+//  
+let café = 1;
+/*  */ //  
+let s = "😀";
+変数 = 2;
+let café = 1;
+//  
+r#""#;
+/*  */ r#""#;
+r#""#;
+x́ + €;
+r#""#;
+let café = 1;
+x́ + €;
+let café = 1;
+変数 = 2;
+let s = "😀";
+/*  */ x́ + €;
+変数 = 2;
+r#""#;
+/*  */ /*  */ /*  */ r#""#;
+//  
+r#""#;
+/*  */ 変数 = 2;
+let s = "😀";
+let café = 1;
+/*  */ x́ + €;
+//  
+x́ + €;
+変数 = 2;
+/*  */ 変数 = 2;
+//  
+r#""#;
+変数 = 2;
+r#""#;
+変数 = 2;
+let s = "😀";
+x́ + €;
+let s = "😀";
+let s = "😀";
+/*  */ let s = "😀";
+x́ + €;
+let café = 1;
+let s = "😀";
+let café = 1;
+x́ + €;
+//  
+変数 = 2;
+//  
+/*  */ let s = "😀";
+変数 = 2;
+let s = "😀";
+変数 = 2;
+//  
+変数 = 2;
+/*  */ let café = 1;
+変数 = 2;
+x́ + €;
+r#""#;
+/*  */ /*  */ let s = "😀";
+r#""#;
+let s = "😀";
+/*  */ //  
+x́ + €;
+x́ + €;
+r#""#;
+let s = "😀";
+let café = 1;
+//  
+変数 = 2;
+x́ + €;
+let s = "😀";
+let café = 1;
+変数 = 2;
+let café = 1;
+let s = "😀";
+x́ + €;
+/*  */ x́ + €;
+r#""#;
+let café = 1;
+r#""#;
+r#""#;
+//  
+//  
+変数 = 2;
+変数 = 2;
+let café = 1;
+x́ + €;
+x́ + €;
+let s = "😀";
+r#""#;
@@ -0,0 +1,85 @@
+#include "fuzz.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+// ============================================================
+// Replay main — a fuzz target without libFuzzer
+// ============================================================
+//
+// Linked in place of libFuzzer when RUSTC_FUZZ is off: runs the target
+// once on each file named on the command line (directories are walked
+// recursively, in sorted order) and prints the time each took, so that a
+// corpus and its crash or timeout reproducers can be replayed by ctest and
+// with any compiler. A failed check or an input over its time budget
+// aborts, as under libFuzzer; the replay then names the input and exits
+// with status 1.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace fs = std::filesystem;
+
+static const char* currentInput = "";
+
+static void onAbort(int) {
+    const char* prefix = "aborted on input ";
+    ssize_t ignored = ::write(STDERR_FILENO, prefix, std::strlen(prefix));
+    ignored = ::write(STDERR_FILENO, currentInput, std::strlen(currentInput));
+    ignored = ::write(STDERR_FILENO, "\n", 1);
+    (void)ignored;
+    ::_exit(1);
+}
+
+static void collect(const fs::path& path, std::vector<fs::path>& inputs) {
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) {
+        inputs.push_back(path);
+        return;
+    }
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(path, ec)) {
+        if (entry.is_regular_file(ec)) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    inputs.insert(inputs.end(), files.begin(), files.end());
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; ++i) collect(argv[i], inputs);
+    if (inputs.empty()) {
+        std::fprintf(stderr, "Usage: %s <input file | corpus directory>...\n", argv[0]);
+        return 1;
+    }
+
+    std::signal(SIGABRT, onAbort);
+    uint64_t totalNs = 0;
+    size_t totalBytes = 0;
+    for (const fs::path& path : inputs) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "Error: could not open file '%s'\n", path.c_str());
+            return 1;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        currentInput = path.c_str();
+        uint64_t ns = timeNs([&] {
+            LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        });
+        totalNs += ns;
+        totalBytes += data.size();
+        std::printf("%10.3f ms %9zu bytes %9.1f ns/byte  %s\n", ns / 1e6, data.size(),
+                    data.empty() ? 0.0 : static_cast<double>(ns) / data.size(), path.c_str());
+    }
+    std::printf("%10.3f ms %9zu bytes in %zu input(s)\n", totalNs / 1e6, totalBytes,
+                inputs.size());
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include "interpreter.h"
+#include "../parser/parser.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static std::unique_ptr<ProgramNode> parse(const std::string& src) {
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << "Unexpected parse error in: " << src;
+    return prog;
+}
+
+static int64_t runMain(const std::string& src) {
+    auto prog = parse(src);
+    Interpreter interp(prog.get());
+    int64_t result = 0;
+    EXPECT_TRUE(interp.call("main", {}, result))
+        << (interp.hasErrors() ? interp.errors()[0].message : "");
+    return result;
+}
+
+// ============================================================
+// Slot resolution
+// ============================================================
+
+TEST(Interp, NamesResolveToSlots) {
+    auto prog = parse("fn f(a: i32, b: i32) { let c = a + b; c = c * 2; return c; }");
+    Interpreter interp(prog.get());
+    auto* fn = static_cast<FnDeclNode*>(prog->statements[0].get());
+    auto* body = static_cast<BlockNode*>(fn->body.get());
+    auto* let = static_cast<LetStmtNode*>(body->statements[0].get());
+    auto* sum = static_cast<BinaryExprNode*>(let->init.get());
+    EXPECT_EQ(static_cast<IdentExprNode*>(sum->left.get())->slot, 0u);
+    EXPECT_EQ(static_cast<IdentExprNode*>(sum->right.get())->slot, 1u);
+    EXPECT_EQ(let->slot, 2u);
+    auto* assign = static_cast<AssignExprNode*>(
+        static_cast<ExprStmtNode*>(body->statements[1].get())->expr.get());
+    EXPECT_EQ(assign->slot, 2u);
+}
+
+TEST(Interp, SiblingBlocksShareSlots) {
+    auto prog = parse("fn f() { { let a = 1; } { let b = 2; } let c = 3; }");
+    Interpreter interp(prog.get());
+    auto* body = static_cast<BlockNode*>(static_cast<FnDeclNode*>(prog->statements[0].get())->body.get());
+    auto letIn = [&](size_t i) {
+        auto* block = static_cast<BlockNode*>(body->statements[i].get());
+        return static_cast<LetStmtNode*>(block->statements[0].get())->slot;
+    };
+    EXPECT_EQ(letIn(0), 0u);
+    EXPECT_EQ(letIn(1), 0u);
+    EXPECT_EQ(static_cast<LetStmtNode*>(body->statements[2].get())->slot, 0u);
+}
+
+TEST(Interp, UnresolvedNamesPreventRunning) {
+    // Not a checked program: `y` is never declared.
+    auto prog = parse("fn main() { return y; }");
+    Interpreter interp(prog.get());
+    ASSERT_EQ(interp.errors().size(), 1u);
+    EXPECT_EQ(interp.errors()[0].line, 1);
+    int64_t result = 0;
+    EXPECT_FALSE(interp.call("main", {}, result));
+}
+
+// ============================================================
+// Statements and expressions
+// ============================================================
+
+TEST(Interp, LetArithmeticAndWhile) {
+    EXPECT_EQ(runMain(R"(
+fn main() {
+    let mut i = 0;
+    let mut sum = 0;
+    while i < 10 { sum = sum + i * i; i = i + 1; }
+    return sum - -1;
+}
+)"), 286);
+}
+
+TEST(Interp, ForLoopBreakAndContinue) {
+    EXPECT_EQ(runMain(R"(
+fn main() {
+    let mut sum = 0;
+    for i in 0..10 {
+        if i == 3 { continue; }
+        if i == 8 { break; }
+        sum = sum + i;
+    }
+    for j in 1..=3 { sum = sum * 10 + j; }
+    for k in 5..5 { return 0; }
+    let mut n = 0;
+    loop {
+        n = n + 1;
+        while true { break; }
+        if n < 4 { continue; }
+        break;
+    }
+    return sum * 10 + n;
+}
+)"), 251234);
+}
+
+TEST(Interp, InclusiveRangeEndsAtTheMaximum) {
+    EXPECT_EQ(runMain(R"(
+fn main() {
+    let max = 9223372036854775807;
+    let mut count = 0;
+    for i in max - 2..=max { count = count + 1; }
+    return count;
+}
+)"), 3);
+}
+
+TEST(Interp, ForVariableGetsItsOwnSlot) {
+    auto prog = parse("fn f(a: i32) { for i in 0..a { let x = i; } let y = 1; }");
+    Interpreter interp(prog.get());
+    auto* body = static_cast<BlockNode*>(static_cast<FnDeclNode*>(prog->statements[0].get())->body.get());
+    auto* loop = static_cast<ForStmtNode*>(body->statements[0].get());
+    EXPECT_EQ(loop->slot, 1u);
+    auto* inner = static_cast<BlockNode*>(loop->body.get());
+    EXPECT_EQ(static_cast<LetStmtNode*>(inner->statements[0].get())->slot, 2u);
+    EXPECT_EQ(static_cast<LetStmtNode*>(body->statements[1].get())->slot, 1u);
+}
+
+TEST(Interp, FieldsAndMethodsAreNotEvaluated) {
+    auto prog = parse("struct P { x: i64 } fn main() { let p = 1; return p.x + p.len(); }");
+    Interpreter interp(prog.get());
+    ASSERT_EQ(interp.errors().size(), 2u);
+    EXPECT_EQ(interp.errors()[0].message, "Cannot evaluate field access '.x'");
+    EXPECT_EQ(interp.errors()[1].message, "Cannot call method 'len'");
+}
+
+TEST(Interp, IfElseChains) {
+    EXPECT_EQ(runMain(R"(
+fn sign(x: i64) {
+    if x < 0 { return -1; } else if x == 0 { return 0; } else { return 1; }
+}
+fn main() { return sign(-5) * 100 + sign(0) * 10 + sign(7); }
+)"), -99);
+}
+
+TEST(Interp, ShadowingAndLetInitializers) {
+    EXPECT_EQ(runMain("fn main() { let x = 1; { let x = x + 10; x = x + 1; } let x = x * 5; return x; }"),
+              5);
+}
+
+TEST(Interp, ComparisonsAndBooleans) {
+    EXPECT_EQ(runMain("fn main() { let a = 3 <= 3; let b = 2 >= 3; if true { return a * 10 + b; } return 9; }"),
+              10);
+}
+
+TEST(Interp, StringsCompareByLiteral) {
+    EXPECT_EQ(runMain("fn main() { let s = \"a\"; let t = \"a\"; return (s == s) * 10 + (s == t); }"), 10);
+}
+
+TEST(Interp, ArithmeticWraps) {
+    EXPECT_EQ(runMain("fn main() { let big = 9223372036854775807; return big + 1; }"), INT64_MIN);
+}
+
+// ============================================================
+// Block values, if and match
+// ============================================================
+
+TEST(Interp, TailValuesAndIfExpressions) {
+    EXPECT_EQ(runMain(R"(
+fn sign(x: i64) -> i64 { if x < 0 { -1 } else if x == 0 { 0 } else { 1 } }
+fn pos(x: i64) -> i64 { if x > 0 { x } else { return 50; } }
+fn main() -> i64 {
+    let y = { let t = 4; t * 2 } + 1;
+    sign(-5) * 100 + sign(0) * 10 + sign(7) + y * 1000 + pos(3) * pos(-3)
+}
+)"), 9000 - 99 + 150);
+}
+
+// break / continue / return inside a block expression leave the enclosing
+// loop or function, not just the expression.
+TEST(Interp, ControlFlowLeavesBlockExpressions) {
+    EXPECT_EQ(runMain(R"(
+fn first(limit: i64) -> i64 {
+    let mut i = 0;
+    let mut sum = 0;
+    loop {
+        i = i + 1;
+        let v = if i > limit { break; } else if i == 2 { continue; } else { i };
+        sum = sum + v;
+    }
+    let r = { if sum > 100 { return -1; } sum };
+    r
+}
+fn main() -> i64 { first(5) * 10 + first(50) }
+)"), (1 + 3 + 4 + 5) * 10 - 1);
+}
+
+TEST(Interp, MatchDenseAndSparse) {
+    EXPECT_EQ(runMain(R"(
+fn dense(x: i64) -> i64 { match x { 0 => 1, 1 | 2 => 2, 3 => 3, -1 => 4, _ => 9 } }
+fn sparse(x: i64) -> i64 { match x { -1000000 => 1, 7 => 2, 9223372036854775807 => 3, _ => 0 } }
+fn main() -> i64 {
+    let mut d = 0;
+    for i in -2..5 { d = d * 10 + dense(i); }
+    let s = sparse(-1000000) * 100 + sparse(7) * 10 + sparse(9223372036854775807);
+    d * 1000 + s + sparse(8)
+}
+)"), INT64_C(9412239) * 1000 + 123);
+}
+
+TEST(Interp, MatchTakesTheFirstArm) {
+    auto prog = parse("fn f(x: i64) -> i64 { match x { 1 => 10, 1 | 2 => 20, _ => 30, 2 => 40 } }");
+    Interpreter interp(prog.get());
+    int64_t a = 0, b = 0, c = 0;
+    ASSERT_TRUE(interp.call("f", {1}, a));
+    ASSERT_TRUE(interp.call("f", {2}, b));
+    ASSERT_TRUE(interp.call("f", {3}, c));
+    EXPECT_EQ(a, 10);
+    EXPECT_EQ(b, 20);
+    EXPECT_EQ(c, 30);
+}
+
+TEST(Interp, MatchWithoutWildcardFailsOnAMiss) {
+    auto prog = parse("fn f(x: i64) -> i64 { match x { 1 => 10 } }");
+    Interpreter interp(prog.get());
+    int64_t result = 0;
+    EXPECT_TRUE(interp.call("f", {1}, result));
+    EXPECT_FALSE(interp.call("f", {2}, result));
+    ASSERT_TRUE(interp.hasErrors());
+    EXPECT_EQ(interp.errors()[0].message, "no match arm for 2");
+}
+
+// ============================================================
+// Calls
+// ============================================================
+
+TEST(Interp, RecursionAndHoistedFunctions) {
+    EXPECT_EQ(runMain(R"(
+fn main() { return fib(20) + helper(); fn helper() { return 1; } }
+fn fib(n: i64) {
+    if n < 2 { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+)"), 6766);
+}
+
+TEST(Interp, ArgumentsAreReadBeforeLaterAssignments) {
+    EXPECT_EQ(runMain(R"(
+fn pair(a: i64, b: i64) { return a * 10 + b; }
+fn main() { let mut x = 1; let r = pair(x, pair(x = 2, x)); return r * 100 + x; }
+)"), 1 * 1000 + 2 * 100 + 2);
+}
+
+TEST(Interp, CallWithArguments) {
+    auto prog = parse("fn add3(a: i64, b: i64, c: i64) { return a * 100 + b * 10 + c; }");
+    Interpreter interp(prog.get());
+    int64_t result = 0;
+    ASSERT_TRUE(interp.call("add3", {1, 2, 3}, result));
+    EXPECT_EQ(result, 123);
+    // Runs again on the same resolved tree.
+    ASSERT_TRUE(interp.call("add3", {4, 5, 6}, result));
+    EXPECT_EQ(result, 456);
+    EXPECT_FALSE(interp.call("add3", {1}, result));
+    EXPECT_FALSE(interp.call("missing", {}, result));
+}
+
+// ============================================================
+// Runtime errors and limits
+// ============================================================
+
+TEST(Interp, DivisionByZeroReportsLine) {
+    auto prog = parse("fn div(a: i64, b: i64) {\n    return a / b;\n}\nfn main() { return div(1, 0); }");
+    Interpreter interp(prog.get());
+    int64_t result = 0;
+    EXPECT_FALSE(interp.call("main", {}, result));
+    ASSERT_EQ(interp.errors().size(), 1u);
+    EXPECT_EQ(interp.errors()[0].message, "division by zero");
+    EXPECT_EQ(interp.errors()[0].line, 2);
+}
+
+TEST(Interp, FuelBoundsRunawayLoops) {
+    auto prog = parse("fn main() { let mut i = 0; while true { i = i + 1; } }");
+    InterpLimits limits;
+    limits.fuel = 10000;
+    Interpreter interp(prog.get(), limits);
+    int64_t result = 0;
+    EXPECT_FALSE(interp.call("main", {}, result));
+    ASSERT_EQ(interp.errors().size(), 1u);
+    EXPECT_NE(interp.errors()[0].message.find("out of fuel"), std::string::npos);
+    EXPECT_EQ(interp.fuelUsed(), 10000u);
+}
+
+TEST(Interp, FuelIsEnoughForFiniteWork) {
+    auto prog = parse("fn main() { let mut i = 0; while i < 100 { i = i + 1; } return i; }");
+    InterpLimits limits;
+    limits.fuel = 1000;
+    Interpreter interp(prog.get(), limits);
+    int64_t result = 0;
+    ASSERT_TRUE(interp.call("main", {}, result));
+    EXPECT_EQ(result, 100);
+    EXPECT_LT(interp.fuelUsed(), 1000u);
+}
+
+TEST(Interp, RunawayRecursionHitsDepthLimit) {
+    auto prog = parse("fn f(n: i64) { return f(n + 1); } fn main() { return f(0); }");
+    Interpreter interp(prog.get());
+    int64_t result = 0;
+    EXPECT_FALSE(interp.call("main", {}, result));
+    ASSERT_EQ(interp.errors().size(), 1u);
+    EXPECT_EQ(interp.errors()[0].message, "stack overflow");
+}
+
+TEST(Interp, FrameArenaBoundsSlots) {
+    auto prog = parse("fn f(n: i64) { let a = n; let b = n; if n == 0 { return 0; } return f(n - 1); } "
+                      "fn main() { return f(100); }");
+    InterpLimits limits;
+    limits.stackSlots = 64;  // 3 slots per frame: room for about 20 calls
+    Interpreter interp(prog.get(), limits);
+    int64_t result = 0;
+    EXPECT_FALSE(interp.call("main", {}, result));
+    EXPECT_EQ(interp.errors()[0].message, "stack overflow");
+
+    limits.stackSlots = 1024;
+    Interpreter roomy(prog.get(), limits);
+    EXPECT_TRUE(roomy.call("main", {}, result));
+}
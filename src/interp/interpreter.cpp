@@ -0,0 +1,614 @@
+#include "interpreter.h"
+#include <algorithm>
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+Interpreter::Interpreter(ProgramNode* root, const InterpLimits& limits)
+    : root_(root), limits_(limits) {
+    if (!root_) return;
+    scopes_.enterScope();
+    declareItems(root_->statements, true);
+    for (const auto& stmt : root_->statements) {
+        if (!stmt || stmt->kind != NodeKind::FN_DECL) continue;
+        auto* fn = static_cast<FnDeclNode*>(stmt.get());
+        uint32_t index = scopes_.lookupInCurrentScope(fn->name);
+        resolveFn(fn, scopes_.binding(index).symbol.id);
+    }
+    scopes_.exitScope();
+    resolved_ = errors_.empty();
+}
+
+bool Interpreter::call(const std::string& name, const std::vector<int64_t>& args, int64_t& result) {
+    if (!resolved_) return false;
+    errors_.clear();
+    fuel_ = limits_.fuel;
+
+    const Function* entry = nullptr;
+    for (const Function& fn : functions_) {
+        if (fn.topLevel && fn.decl->name == name) entry = &fn;
+    }
+    if (!entry) {
+        recordError("no function '" + name + "'", 0);
+        return false;
+    }
+    if (args.size() != entry->decl->params.size()) {
+        recordError("'" + name + "' expects " + std::to_string(entry->decl->params.size()) +
+                        " argument(s), got " + std::to_string(args.size()),
+                    entry->decl->line);
+        return false;
+    }
+    if (stack_.size() != limits_.stackSlots) stack_.assign(limits_.stackSlots, 0);
+    if (entry->numSlots > stack_.size()) {
+        recordError("stack overflow", entry->decl->line);
+        return false;
+    }
+
+    top_ = entry->numSlots;
+    frame_ = stack_.data();
+    for (size_t i = 0; i < args.size(); ++i) frame_[i] = args[i];
+    depth_ = 1;
+    aborted_ = false;
+    escape_ = Flow::ABORT;
+    int64_t value = runBody(entry->decl->body.get());
+    depth_ = 0;
+    top_ = 0;
+    if (aborted_) return false;
+    result = value;
+    return true;
+}
+
+uint64_t Interpreter::fuelUsed() const {
+    return limits_.fuel - fuel_;
+}
+
+bool Interpreter::hasErrors() const {
+    return !errors_.empty();
+}
+
+const std::vector<InterpError>& Interpreter::errors() const {
+    return errors_;
+}
+
+void Interpreter::recordError(const std::string& msg, int line) {
+    errors_.push_back(InterpError{msg, line});
+}
+
+// ============================================================
+// Resolution
+// ============================================================
+//
+// Mirrors CodeGen: functions are bound at the start of their block, a
+// function body sees items and its own locals only, and a `let` is bound
+// after its initializer. Slots of a block are released when it ends, so
+// sibling blocks share them.
+
+const Interpreter::Binding* Interpreter::resolve(const std::string& name) const {
+    uint32_t index = scopes_.lookup(name);
+    while (index != ScopeTable<Binding>::NONE) {
+        const auto& b = scopes_.binding(index);
+        if (index >= fnBase_ || b.symbol.isFn) return &b.symbol;
+        index = b.shadowed;
+    }
+    return nullptr;
+}
+
+void Interpreter::declareItems(const std::vector<AstNodePtr>& statements, bool topLevel) {
+    for (const auto& stmt : statements) {
+        if (!stmt || stmt->kind != NodeKind::FN_DECL) continue;
+        auto* fn = static_cast<FnDeclNode*>(stmt.get());
+        uint32_t index = static_cast<uint32_t>(functions_.size());
+        functions_.push_back(Function{fn, 0, topLevel});
+        scopes_.declare(fn->name, Binding{true, index});
+    }
+}
+
+void Interpreter::resolveFn(FnDeclNode* node, uint32_t index) {
+    uint32_t outerBase = fnBase_, outerNext = nextSlot_, outerMax = maxSlots_;
+    uint32_t outerLoops = loopDepth_;
+    bool outerParsed = parsedSlots_;
+    fnBase_ = scopes_.size();
+    nextSlot_ = 0;
+    loopDepth_ = 0;
+    parsedSlots_ = node->frameSlots != NO_SLOT;
+    scopes_.enterScope();
+
+    if (!parsedSlots_) {
+        for (const auto& param : node->params) {
+            scopes_.declare(param.name, Binding{false, nextSlot_++});
+        }
+    }
+    maxSlots_ = nextSlot_;
+    resolveStmt(node->body.get());
+    functions_[index].numSlots = parsedSlots_ ? node->frameSlots : maxSlots_;
+
+    scopes_.exitScope();
+    fnBase_ = outerBase;
+    nextSlot_ = outerNext;
+    maxSlots_ = outerMax;
+    loopDepth_ = outerLoops;
+    parsedSlots_ = outerParsed;
+}
+
+uint32_t Interpreter::newSlot() {
+    uint32_t slot = nextSlot_++;
+    if (nextSlot_ > maxSlots_) maxSlots_ = nextSlot_;
+    return slot;
+}
+
+void Interpreter::resolveStmt(AstNode* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NodeKind::FN_DECL: {
+            auto* fn = static_cast<FnDeclNode*>(node);
+            uint32_t index = scopes_.lookupInCurrentScope(fn->name);
+            resolveFn(fn, scopes_.binding(index).symbol.id);
+            break;
+        }
+        case NodeKind::BLOCK:
+            resolveBlock(static_cast<BlockNode*>(node));
+            break;
+        case NodeKind::LET_STMT: {
+            auto* let = static_cast<LetStmtNode*>(node);
+            resolveExpr(let->init.get());
+            if (parsedSlots_) break;
+            let->slot = newSlot();
+            scopes_.declare(let->name, Binding{false, let->slot});
+            break;
+        }
+        case NodeKind::RETURN_STMT:
+            resolveExpr(static_cast<ReturnStmtNode*>(node)->value.get());
+            break;
+        case NodeKind::WHILE_STMT: {
+            auto* loop = static_cast<WhileStmtNode*>(node);
+            resolveExpr(loop->condition.get());
+            resolveLoopBody(loop->body.get());
+            break;
+        }
+        case NodeKind::LOOP_STMT:
+            resolveLoopBody(static_cast<LoopStmtNode*>(node)->body.get());
+            break;
+        case NodeKind::FOR_STMT:
+            resolveFor(static_cast<ForStmtNode*>(node));
+            break;
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT:
+            if (loopDepth_ == 0) recordError("Cannot leave a loop from outside one", node->line);
+            break;
+        case NodeKind::STRUCT_DECL:
+        case NodeKind::IMPL_BLOCK:
+            break;  // no code of their own; methods are never called by name
+        case NodeKind::EXPR_STMT:
+            resolveExpr(static_cast<ExprStmtNode*>(node)->expr.get());
+            break;
+        default:
+            resolveExpr(node);
+            break;
+    }
+}
+
+void Interpreter::resolveBlock(BlockNode* node) {
+    uint32_t mark = nextSlot_;
+    scopes_.enterScope();
+    declareItems(node->statements, false);
+    for (const auto& stmt : node->statements) resolveStmt(stmt.get());
+    resolveExpr(node->value.get());
+    scopes_.exitScope();
+    nextSlot_ = mark;
+}
+
+// Builds the match's table. A value goes to the first arm that lists it,
+// and nothing after a `_` arm is reachable. The table is direct-indexed
+// when the values span at most twice as many integers as there are
+// patterns, so it stays within a small multiple of the sorted form.
+void Interpreter::resolveMatch(MatchExprNode* node) {
+    resolveExpr(node->scrutinee.get());
+    MatchTable table;
+    for (uint32_t i = 0; i < node->arms.size() && table.fallback == NO_ARM; ++i) {
+        auto* arm = static_cast<MatchArmNode*>(node->arms[i].get());
+        if (arm->patterns.empty()) table.fallback = i;
+        for (const auto& pattern : arm->patterns) {
+            int64_t value;
+            if (patternValue(pattern.get(), value)) table.sparse.emplace_back(value, i);
+        }
+    }
+    for (const auto& arm : node->arms) {
+        resolveExpr(static_cast<MatchArmNode*>(arm.get())->body.get());
+    }
+
+    auto byValue = [](const std::pair<int64_t, uint32_t>& a,
+                      const std::pair<int64_t, uint32_t>& b) { return a.first < b.first; };
+    auto sameValue = [](const std::pair<int64_t, uint32_t>& a,
+                        const std::pair<int64_t, uint32_t>& b) { return a.first == b.first; };
+    std::stable_sort(table.sparse.begin(), table.sparse.end(), byValue);
+    table.sparse.erase(std::unique(table.sparse.begin(), table.sparse.end(), sameValue),
+                       table.sparse.end());
+    if (!table.sparse.empty()) {
+        uint64_t span = static_cast<uint64_t>(table.sparse.back().first) -
+                        static_cast<uint64_t>(table.sparse.front().first);
+        if (span < 2 * table.sparse.size()) {
+            table.base = table.sparse.front().first;
+            table.dense.assign(span + 1, table.fallback);
+            for (const auto& entry : table.sparse) {
+                table.dense[static_cast<uint64_t>(entry.first) -
+                            static_cast<uint64_t>(table.base)] = entry.second;
+            }
+            table.sparse.clear();
+        }
+    }
+    node->slot = static_cast<uint32_t>(matches_.size());
+    matches_.push_back(std::move(table));
+}
+
+// Only integer ranges are iterated: the loop variable gets a slot, and the
+// bounds are evaluated once, before the first iteration.
+void Interpreter::resolveFor(ForStmtNode* node) {
+    if (!isRangeExpr(node->iterable.get())) {
+        recordError("Cannot iterate over anything but a range", node->line);
+        return;
+    }
+    auto* range = static_cast<BinaryExprNode*>(node->iterable.get());
+    resolveExpr(range->left.get());
+    resolveExpr(range->right.get());
+    uint32_t mark = nextSlot_;
+    scopes_.enterScope();
+    if (!parsedSlots_) {
+        node->slot = newSlot();
+        scopes_.declare(node->name, Binding{false, node->slot});
+    }
+    resolveLoopBody(node->body.get());
+    scopes_.exitScope();
+    nextSlot_ = mark;
+}
+
+void Interpreter::resolveLoopBody(AstNode* body) {
+    ++loopDepth_;
+    resolveStmt(body);
+    --loopDepth_;
+}
+
+void Interpreter::resolveExpr(AstNode* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NodeKind::NUMBER_LITERAL: {
+            auto* n = static_cast<NumberLiteralNode*>(node);
+            n->slot = static_cast<uint32_t>(constants_.size());
+            constants_.push_back(literalValue(n));
+            break;
+        }
+        case NodeKind::STRING_LITERAL:
+            static_cast<StringLiteralNode*>(node)->slot = strings_++;
+            break;
+        case NodeKind::IDENT_EXPR: {
+            auto* n = static_cast<IdentExprNode*>(node);
+            if (n->name == "true" || n->name == "false") {
+                n->slot = n->name == "true" ? SLOT_TRUE : SLOT_FALSE;
+                break;
+            }
+            if (parsedSlots_ && n->slot != NO_SLOT) break;
+            const Binding* b = resolve(n->name);
+            if (!b || b->isFn) {
+                recordError("Cannot evaluate '" + n->name + "' as a value", n->line);
+                break;
+            }
+            n->slot = b->id;
+            break;
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<AssignExprNode*>(node);
+            resolveExpr(n->value.get());
+            if (parsedSlots_ && n->slot != NO_SLOT) break;
+            const Binding* b = resolve(n->target);
+            if (!b || b->isFn) {
+                recordError("Cannot assign to '" + n->target + "'", n->line);
+                break;
+            }
+            n->slot = b->id;
+            break;
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<BinaryExprNode*>(node);
+            if (isRangeExpr(n)) {
+                recordError("Cannot evaluate a range outside a 'for' loop", n->line);
+                break;
+            }
+            resolveExpr(n->left.get());
+            resolveExpr(n->right.get());
+            break;
+        }
+        case NodeKind::FIELD_EXPR:
+            recordError("Cannot evaluate field access '." +
+                        static_cast<FieldExprNode*>(node)->name + "'", node->line);
+            break;
+        case NodeKind::METHOD_CALL_EXPR:
+            recordError("Cannot call method '" +
+                        static_cast<MethodCallExprNode*>(node)->method + "'", node->line);
+            break;
+        case NodeKind::UNARY_EXPR:
+            resolveExpr(static_cast<UnaryExprNode*>(node)->operand.get());
+            break;
+        case NodeKind::BLOCK:
+            resolveBlock(static_cast<BlockNode*>(node));
+            break;
+        case NodeKind::IF_STMT: {
+            auto* branch = static_cast<IfStmtNode*>(node);
+            resolveExpr(branch->condition.get());
+            resolveExpr(branch->thenBranch.get());
+            resolveExpr(branch->elseBranch.get());
+            break;
+        }
+        case NodeKind::MATCH_EXPR:
+            resolveMatch(static_cast<MatchExprNode*>(node));
+            break;
+        case NodeKind::CALL_EXPR: {
+            auto* n = static_cast<CallExprNode*>(node);
+            for (const auto& arg : n->args) resolveExpr(arg.get());
+            const Binding* b = resolve(n->callee);
+            if (!b || !b->isFn) {
+                recordError("Cannot call '" + n->callee + "'", n->line);
+                break;
+            }
+            if (functions_[b->id].decl->params.size() != n->args.size()) {
+                recordError("Wrong number of arguments to '" + n->callee + "'", n->line);
+                break;
+            }
+            n->slot = b->id;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// ============================================================
+// Execution
+// ============================================================
+
+Interpreter::Flow Interpreter::exec(AstNode* node) {
+    if (fuel_ == 0) {
+        recordError("out of fuel after " + std::to_string(limits_.fuel) + " step(s)", node->line);
+        aborted_ = true;
+        return Flow::ABORT;
+    }
+    --fuel_;
+
+    switch (node->kind) {
+        case NodeKind::BLOCK:
+            evalBlock(static_cast<BlockNode*>(node));
+            return aborted_ ? unwind() : Flow::NEXT;
+        case NodeKind::LET_STMT: {
+            auto* let = static_cast<LetStmtNode*>(node);
+            int64_t value = eval(let->init.get());
+            if (aborted_) return unwind();
+            frame_[let->slot] = value;
+            return Flow::NEXT;
+        }
+        case NodeKind::RETURN_STMT: {
+            auto* ret = static_cast<ReturnStmtNode*>(node);
+            int64_t value = ret->value ? eval(ret->value.get()) : 0;
+            if (aborted_) return unwind();
+            returnValue_ = value;
+            return Flow::RETURN;
+        }
+        case NodeKind::WHILE_STMT: {
+            auto* loop = static_cast<WhileStmtNode*>(node);
+            for (;;) {
+                int64_t cond = eval(loop->condition.get());
+                if (aborted_) return unwind();
+                if (cond == 0) return Flow::NEXT;
+                Flow flow = exec(loop->body.get());
+                if (flow == Flow::BREAK) return Flow::NEXT;
+                if (flow != Flow::NEXT && flow != Flow::CONTINUE) return flow;
+            }
+        }
+        case NodeKind::LOOP_STMT:
+            for (;;) {
+                Flow flow = exec(static_cast<LoopStmtNode*>(node)->body.get());
+                if (flow == Flow::BREAK) return Flow::NEXT;
+                if (flow != Flow::NEXT && flow != Flow::CONTINUE) return flow;
+            }
+        case NodeKind::FOR_STMT:
+            return execFor(static_cast<ForStmtNode*>(node));
+        case NodeKind::BREAK_STMT:
+            return Flow::BREAK;
+        case NodeKind::CONTINUE_STMT:
+            return Flow::CONTINUE;
+        case NodeKind::IF_STMT: {
+            auto* branch = static_cast<IfStmtNode*>(node);
+            int64_t cond = eval(branch->condition.get());
+            if (aborted_) return unwind();
+            if (cond != 0) return exec(branch->thenBranch.get());
+            return branch->elseBranch ? exec(branch->elseBranch.get()) : Flow::NEXT;
+        }
+        case NodeKind::EXPR_STMT:
+            eval(static_cast<ExprStmtNode*>(node)->expr.get());
+            return aborted_ ? unwind() : Flow::NEXT;
+        case NodeKind::FN_DECL:
+        case NodeKind::STRUCT_DECL:
+        case NodeKind::IMPL_BLOCK:
+            return Flow::NEXT;
+        default:
+            eval(node);
+            return aborted_ ? unwind() : Flow::NEXT;
+    }
+}
+
+// Stops after the last value rather than stepping past it, so `..=i64::MAX`
+// does not overflow.
+Interpreter::Flow Interpreter::execFor(ForStmtNode* node) {
+    auto* range = static_cast<BinaryExprNode*>(node->iterable.get());
+    int64_t i = eval(range->left.get());
+    int64_t end = eval(range->right.get());
+    if (aborted_) return unwind();
+    bool inclusive = range->op.size() == 3;
+    if (inclusive ? i > end : i >= end) return Flow::NEXT;
+    int64_t last = inclusive ? end : end - 1;
+    for (;; ++i) {
+        frame_[node->slot] = i;
+        Flow flow = exec(node->body.get());
+        if (flow == Flow::BREAK) return Flow::NEXT;
+        if (flow != Flow::NEXT && flow != Flow::CONTINUE) return flow;
+        if (i == last) return Flow::NEXT;
+    }
+}
+
+// The flow of a statement whose expression stopped early: ABORT after an
+// error, or the break / continue / return that left a block expression
+// inside it, which carries on from the statement as if it were its own.
+Interpreter::Flow Interpreter::unwind() {
+    Flow flow = escape_;
+    if (flow != Flow::ABORT) {
+        aborted_ = false;
+        escape_ = Flow::ABORT;
+    }
+    return flow;
+}
+
+// After an error eval() returns 0 with aborted_ set; callers check the flag
+// before any effect. A break / continue / return inside a block expression
+// stops evaluation the same way, with escape_ saying which, until unwind().
+int64_t Interpreter::eval(AstNode* node) {
+    switch (node->kind) {
+        case NodeKind::NUMBER_LITERAL:
+            return constants_[static_cast<NumberLiteralNode*>(node)->slot];
+        case NodeKind::STRING_LITERAL:
+            return static_cast<StringLiteralNode*>(node)->slot;
+        case NodeKind::IDENT_EXPR: {
+            uint32_t slot = static_cast<IdentExprNode*>(node)->slot;
+            if (slot < SLOT_FALSE) return frame_[slot];
+            return slot == SLOT_TRUE;
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<AssignExprNode*>(node);
+            int64_t value = eval(n->value.get());
+            if (!aborted_) frame_[n->slot] = value;
+            return 0;
+        }
+        case NodeKind::UNARY_EXPR: {
+            uint64_t x = static_cast<uint64_t>(eval(static_cast<UnaryExprNode*>(node)->operand.get()));
+            return static_cast<int64_t>(0 - x);
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<BinaryExprNode*>(node);
+            int64_t a = eval(n->left.get());
+            int64_t b = eval(n->right.get());
+            if (aborted_) return 0;
+            uint64_t x = static_cast<uint64_t>(a), y = static_cast<uint64_t>(b);
+            const std::string& op = n->op;
+            bool wide = op.size() == 2;  // ==, !=, <=, >=
+            switch (op[0]) {
+                case '+': return static_cast<int64_t>(x + y);
+                case '-': return static_cast<int64_t>(x - y);
+                case '*': return static_cast<int64_t>(x * y);
+                case '/':
+                    if (b == 0) {
+                        recordError("division by zero", n->line);
+                        aborted_ = true;
+                        return 0;
+                    }
+                    // INT64_MIN / -1 wraps like the other operators.
+                    return b == -1 ? static_cast<int64_t>(0 - x) : a / b;
+                case '=': return a == b;
+                case '!': return a != b;
+                case '<': return wide ? a <= b : a < b;
+                default:  return wide ? a >= b : a > b;
+            }
+        }
+        case NodeKind::CALL_EXPR:
+            return callFunction(static_cast<CallExprNode*>(node));
+        case NodeKind::BLOCK:
+            return evalBlock(static_cast<BlockNode*>(node));
+        case NodeKind::IF_STMT: {
+            auto* branch = static_cast<IfStmtNode*>(node);
+            int64_t cond = eval(branch->condition.get());
+            if (aborted_) return 0;
+            if (cond != 0) return eval(branch->thenBranch.get());
+            return branch->elseBranch ? eval(branch->elseBranch.get()) : 0;
+        }
+        case NodeKind::MATCH_EXPR:
+            return evalMatch(static_cast<MatchExprNode*>(node));
+        default:
+            return 0;
+    }
+}
+
+int64_t Interpreter::evalBlock(BlockNode* node) {
+    for (const auto& stmt : node->statements) {
+        Flow flow = exec(stmt.get());
+        if (flow != Flow::NEXT) {
+            if (flow != Flow::ABORT) escape_ = flow;
+            aborted_ = true;
+            return 0;
+        }
+    }
+    return node->value ? eval(node->value.get()) : 0;
+}
+
+int64_t Interpreter::evalMatch(MatchExprNode* node) {
+    int64_t value = eval(node->scrutinee.get());
+    if (aborted_) return 0;
+    const MatchTable& table = matches_[node->slot];
+    uint32_t arm = table.fallback;
+    if (!table.dense.empty()) {
+        uint64_t index = static_cast<uint64_t>(value) - static_cast<uint64_t>(table.base);
+        if (index < table.dense.size()) arm = table.dense[index];
+    } else {
+        auto it = std::lower_bound(table.sparse.begin(), table.sparse.end(), value,
+                                   [](const std::pair<int64_t, uint32_t>& entry, int64_t v) {
+                                       return entry.first < v;
+                                   });
+        if (it != table.sparse.end() && it->first == value) arm = it->second;
+    }
+    if (arm == NO_ARM) {
+        recordError("no match arm for " + std::to_string(value), node->line);
+        aborted_ = true;
+        return 0;
+    }
+    return eval(static_cast<MatchArmNode*>(node->arms[arm].get())->body.get());
+}
+
+// A function's result: the value of the `return` that left it, else the
+// value of its body.
+int64_t Interpreter::runBody(AstNode* body) {
+    int64_t value = eval(body);
+    if (aborted_ && escape_ == Flow::RETURN) {
+        aborted_ = false;
+        escape_ = Flow::ABORT;
+        return returnValue_;
+    }
+    return value;
+}
+
+// The callee's frame is reserved before its arguments are evaluated, which
+// write straight into its parameter slots; calls made while evaluating
+// them get frames above it.
+int64_t Interpreter::callFunction(CallExprNode* node) {
+    const Function& fn = functions_[node->slot];
+    if (depth_ >= limits_.maxDepth || fn.numSlots > stack_.size() - top_) {
+        recordError("stack overflow", node->line);
+        aborted_ = true;
+        return 0;
+    }
+    size_t savedTop = top_;
+    int64_t* frame = stack_.data() + top_;
+    top_ += fn.numSlots;
+    for (size_t i = 0; i < node->args.size(); ++i) {
+        frame[i] = eval(node->args[i].get());
+        if (aborted_) {
+            top_ = savedTop;
+            return 0;
+        }
+    }
+
+    int64_t* savedFrame = frame_;
+    frame_ = frame;
+    ++depth_;
+    int64_t value = runBody(fn.decl->body.get());
+    --depth_;
+    frame_ = savedFrame;
+    top_ = savedTop;
+    return value;
+}
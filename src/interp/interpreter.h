@@ -0,0 +1,140 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "../ast/ast.h"
+#include "../semantic/scope_table.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// InterpError
+// ============================================================
+struct InterpError {
+    std::string message;
+    int line;
+};
+
+// Bounds for running untrusted programs. Fuel is spent on every statement
+// executed (a loop spends at least one per iteration on its body block).
+struct InterpLimits {
+    uint64_t fuel = 1000000000;
+    uint32_t maxDepth = 2000;        // nested calls; each one also uses native stack
+    uint32_t stackSlots = 1u << 20;  // frame slots for all active calls together
+};
+
+// ============================================================
+// Interpreter — walks the AST with pre-resolved variable slots
+// ============================================================
+//
+// The constructor resolves every name once and writes the result into the
+// nodes' `slot` fields: locals and parameters get frame slot indices,
+// calls the index of their function, literals an index into a constant
+// table. Running then never looks anything up by name. Frames are carved
+// from one preallocated slot array, so a call costs a bump of its top.
+// A function whose locals got their slots while parsing (FnDeclNode::
+// frameSlots, see ParseTimePasses) keeps them; only its calls, literals and
+// matches are resolved here.
+//
+// Values follow the VM: i64 wrapping arithmetic, 0 / 1 for booleans,
+// 0 for unit; a string is the index of its literal. A match dispatches
+// through a table built during resolution, so choosing an arm costs one
+// index or one binary search however many arms there are. Expects a program that
+// passed semantic analysis; names that do not resolve are reported and
+// nothing runs.
+class Interpreter {
+public:
+    explicit Interpreter(ProgramNode* root, const InterpLimits& limits = InterpLimits());
+
+    // Runs the top-level function `name`. Returns false, with the reason in
+    // errors(), on unresolved names, a wrong argument count, division by
+    // zero, exceeding a limit, or if there is no such function.
+    bool call(const std::string& name, const std::vector<int64_t>& args, int64_t& result);
+
+    // Fuel spent by the last call().
+    uint64_t fuelUsed() const;
+
+    bool hasErrors() const;
+    const std::vector<InterpError>& errors() const;
+
+private:
+    enum class Flow : uint8_t { NEXT, BREAK, CONTINUE, RETURN, ABORT };
+
+    struct Function {
+        FnDeclNode* decl;
+        uint32_t numSlots;  // parameters first, then every let in the body
+        bool topLevel;
+    };
+
+    struct Binding {
+        bool isFn;
+        uint32_t id;  // function index or frame slot
+    };
+
+    static constexpr uint32_t NO_ARM = 0xFFFFFFFFu;
+
+    // Arms of one match by pattern value: indexed directly when the values
+    // are dense, else sorted for binary search.
+    struct MatchTable {
+        int64_t base = 0;                                  // smallest value, for `dense`
+        std::vector<uint32_t> dense;                       // arm per value - base
+        std::vector<std::pair<int64_t, uint32_t>> sparse;  // (value, arm), by value
+        uint32_t fallback = NO_ARM;                        // the `_` arm
+    };
+
+    // Reserved IdentExprNode slots for the boolean literals.
+    static constexpr uint32_t SLOT_FALSE = 0xFFFFFFFDu;
+    static constexpr uint32_t SLOT_TRUE = 0xFFFFFFFEu;
+
+    ProgramNode* root_;
+    InterpLimits limits_;
+    std::vector<InterpError> errors_;
+    bool resolved_ = false;
+
+    // Resolution
+    std::vector<Function> functions_;
+    std::vector<int64_t> constants_;
+    std::vector<MatchTable> matches_;  // by MatchExprNode::slot
+    uint32_t strings_ = 0;
+    ScopeTable<Binding> scopes_;
+    uint32_t fnBase_ = 0;    // see SemanticAnalyzer::fnBase_
+    uint32_t nextSlot_ = 0;  // first free slot of the function being resolved
+    uint32_t maxSlots_ = 0;
+    uint32_t loopDepth_ = 0;  // loops around the statement being resolved
+    bool parsedSlots_ = false;  // the current function's locals were resolved while parsing
+
+    // Execution
+    std::vector<int64_t> stack_;
+    size_t top_ = 0;            // first free slot in stack_
+    int64_t* frame_ = nullptr;  // slots of the running function
+    uint32_t depth_ = 0;
+    uint64_t fuel_ = 0;
+    int64_t returnValue_ = 0;
+    bool aborted_ = false;      // an error stopped execution, or see escape_
+    Flow escape_ = Flow::ABORT; // break / continue / return leaving a block expression
+
+    void recordError(const std::string& msg, int line);
+
+    const Binding* resolve(const std::string& name) const;
+    void declareItems(const std::vector<AstNodePtr>& statements, bool topLevel);
+    void resolveFn(FnDeclNode* node, uint32_t index);
+    void resolveStmt(AstNode* node);
+    void resolveBlock(BlockNode* node);
+    void resolveMatch(MatchExprNode* node);
+    void resolveFor(ForStmtNode* node);
+    void resolveLoopBody(AstNode* body);
+    void resolveExpr(AstNode* node);
+    uint32_t newSlot();
+
+    Flow exec(AstNode* node);
+    Flow execFor(ForStmtNode* node);
+    Flow unwind();
+    int64_t eval(AstNode* node);
+    int64_t evalBlock(BlockNode* node);
+    int64_t evalMatch(MatchExprNode* node);
+    int64_t runBody(AstNode* body);
+    int64_t callFunction(CallExprNode* node);
+};
+
+#endif // INTERPRETER_H
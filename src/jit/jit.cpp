@@ -0,0 +1,522 @@
+#include "jit.h"
+#include "regalloc.h"
+#include "x86_emitter.h"
+#include <cstring>
+#include <utility>
+#if JIT_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Context::error is function index * 4 + one of these.
+static constexpr uint32_t ERROR_DIVISION = 1;
+static constexpr uint32_t ERROR_STACK = 2;
+
+// Extra stack kept below the largest frame for the call that overflows.
+static constexpr size_t STACK_SLACK = 256;
+
+static Cond condFor(Opcode cmp) {
+    switch (cmp) {
+        case Opcode::EQ: return Cond::E;
+        case Opcode::NE: return Cond::NE;
+        case Opcode::LT: return Cond::L;
+        case Opcode::GT: return Cond::G;
+        case Opcode::LE: return Cond::LE;
+        default:         return Cond::GE;
+    }
+}
+
+static int64_t address(const void* p) {
+    return static_cast<int64_t>(reinterpret_cast<uintptr_t>(p));
+}
+
+// ============================================================
+// FunctionEmitter — one IrFunction to machine code
+// ============================================================
+//
+// Frame, from the caller's side down:
+//
+//   [rbp + 16 + 8i]        parameter i (written by the caller)
+//   [rbp + 8]              return address
+//   [rbp]                  caller's rbp
+//   [rbp - 8 .. ]          callee-saved registers the function uses
+//   below them             spill slots
+//   [rsp + 8k]             argument k of the next call
+//
+// RAX, RCX and RDX are scratch; every other register belongs to a value
+// for its whole interval. Block order is kept, so jumps to the next block
+// are dropped, and a comparison whose only use is the BR right after it
+// becomes a cmp + jcc, as in the bytecode compiler.
+
+namespace {
+
+class FunctionEmitter {
+public:
+    FunctionEmitter(X86Emitter& as, const IrFunction& fn, uint32_t index, Jit::Context* context,
+                    uint32_t resume, std::vector<std::pair<uint32_t, uint32_t>>& callFixups)
+        : as_(as), fn_(fn), index_(index), context_(context), resume_(resume),
+          callFixups_(callFixups), alloc_(allocateRegisters(fn)) {}
+
+    // Emits the function and returns its frame size in bytes below the
+    // return address.
+    size_t emit();
+
+private:
+    X86Emitter& as_;
+    const IrFunction& fn_;
+    uint32_t index_;
+    Jit::Context* context_;
+    uint32_t resume_;  // trampoline code that unwinds after an error
+    std::vector<std::pair<uint32_t, uint32_t>>& callFixups_;  // rel32, function
+    RegAllocation alloc_;
+    std::vector<std::pair<uint32_t, uint32_t>> blockFixups_;  // rel32, block
+    struct TableEntry {
+        uint32_t at, table, block;
+    };
+    std::vector<TableEntry> tableFixups_;
+    std::vector<uint32_t> divisionFixups_;
+    std::vector<uint32_t> stackFixups_;
+
+    bool inReg(uint32_t v) const { return alloc_.inReg[v]; }
+    Reg reg(uint32_t v) const { return alloc_.reg[v]; }
+    Mem mem(uint32_t v) const;
+    void load(Reg dst, uint32_t v);
+    void store(uint32_t v, Reg src);
+    Reg source(uint32_t v, Reg scratch);
+    void alu(AluOp op, Reg dst, uint32_t v);
+
+    void emitInstr(const Instr& in, uint32_t& argSlot);
+    void emitArithmetic(const Instr& in);
+    void emitDivision(const Instr& in);
+    void emitCompare(uint32_t a, uint32_t b);
+    void emitEpilogue();
+    void jumpTo(uint32_t block);
+    void emitSwitch(const Instr& term);
+    void emitErrorStub(const std::vector<uint32_t>& fixups, uint32_t kind);
+};
+
+Mem FunctionEmitter::mem(uint32_t v) const {
+    if (alloc_.slot[v] != NO_SLOT_INDEX) {
+        int32_t saved = static_cast<int32_t>(alloc_.calleeSaved.size()) * 8;
+        return Mem{Reg::RBP, -saved - 8 * (alloc_.slot[v] + 1)};
+    }
+    return Mem{Reg::RBP, 16 + 8 * static_cast<int32_t>(v)};
+}
+
+void FunctionEmitter::load(Reg dst, uint32_t v) {
+    if (!inReg(v)) as_.movRM(dst, mem(v));
+    else if (reg(v) != dst) as_.movRR(dst, reg(v));
+}
+
+void FunctionEmitter::store(uint32_t v, Reg src) {
+    if (!inReg(v)) as_.movMR(mem(v), src);
+    else if (reg(v) != src) as_.movRR(reg(v), src);
+}
+
+// The register holding `v`, loading it into `scratch` if it is spilled.
+Reg FunctionEmitter::source(uint32_t v, Reg scratch) {
+    if (inReg(v)) return reg(v);
+    as_.movRM(scratch, mem(v));
+    return scratch;
+}
+
+void FunctionEmitter::alu(AluOp op, Reg dst, uint32_t v) {
+    if (inReg(v)) as_.aluRR(op, dst, reg(v));
+    else as_.aluRM(op, dst, mem(v));
+}
+
+size_t FunctionEmitter::emit() {
+    std::vector<uint32_t> uses(fn_.numValues, 0);
+    uint32_t maxArgs = 0, args = 0;
+    for (const Instr& in : fn_.instrs) {
+        switch (in.op) {
+            case Opcode::CONST: case Opcode::STR: case Opcode::JMP: break;
+            case Opcode::CALL: args = 0; break;
+            case Opcode::COPY: case Opcode::NEG: case Opcode::BR: case Opcode::SWITCH:
+                uses[in.src1]++;
+                break;
+            case Opcode::ARG:
+                uses[in.src1]++;
+                if (++args > maxArgs) maxArgs = args;
+                break;
+            case Opcode::RET: if (in.src1 != IR_NONE) uses[in.src1]++; break;
+            default: uses[in.src1]++; uses[in.src2]++; break;
+        }
+    }
+
+    // Keep RSP 16-byte aligned at calls: entry RSP is 8 past a multiple of 16,
+    // and pushing RBP makes up for it.
+    size_t saved = alloc_.calleeSaved.size() * 8;
+    size_t locals = (alloc_.numSlots + maxArgs) * 8;
+    if ((saved + locals) % 16 != 0) locals += 8;
+
+    // Prologue
+    as_.push(Reg::RBP);
+    as_.movRR(Reg::RBP, Reg::RSP);
+    as_.movRI(Reg::RAX, address(&context_->stackLimit));
+    as_.aluRM(AluOp::CMP, Reg::RSP, Mem{Reg::RAX, 0});
+    stackFixups_.push_back(as_.jcc32(Cond::B));
+    for (Reg r : alloc_.calleeSaved) as_.push(r);
+    if (locals) as_.subRI(Reg::RSP, static_cast<int32_t>(locals));
+    for (uint32_t p = 0; p < fn_.numParams; ++p) {
+        if (inReg(p)) as_.movRM(reg(p), Mem{Reg::RBP, 16 + 8 * static_cast<int32_t>(p)});
+    }
+
+    std::vector<uint32_t> blockStart(fn_.blocks.size(), 0);
+    uint32_t argSlot = 0;
+    for (uint32_t b = 0; b < fn_.blocks.size(); ++b) {
+        blockStart[b] = as_.size();
+        const IrBlock& range = fn_.blocks[b];
+        const Instr& term = fn_.instrs[range.end - 1];
+        uint32_t next = b + 1;
+
+        bool fused = false;
+        if (term.op == Opcode::BR && range.end - range.begin >= 2) {
+            const Instr& prev = fn_.instrs[range.end - 2];
+            fused = isComparison(prev.op) && prev.dest == term.src1 && uses[prev.dest] == 1;
+        }
+        uint32_t bodyEnd = range.end - (fused ? 2 : 1);
+        for (uint32_t i = range.begin; i < bodyEnd; ++i) emitInstr(fn_.instrs[i], argSlot);
+
+        switch (term.op) {
+            case Opcode::JMP:
+                if (term.src1 != next) jumpTo(term.src1);
+                break;
+            case Opcode::BR: {
+                Cond cond = Cond::NE;
+                if (fused) {
+                    const Instr& cmp = fn_.instrs[range.end - 2];
+                    emitCompare(cmp.src1, cmp.src2);
+                    cond = condFor(cmp.op);
+                } else if (inReg(term.src1)) {
+                    as_.testRR(reg(term.src1), reg(term.src1));
+                } else {
+                    as_.cmpMI(mem(term.src1), 0);
+                }
+                uint32_t thenBlock = term.src2, elseBlock = term.dest;
+                if (thenBlock == next) {
+                    blockFixups_.push_back({as_.jcc32(negate(cond)), elseBlock});
+                } else {
+                    blockFixups_.push_back({as_.jcc32(cond), thenBlock});
+                    if (elseBlock != next) jumpTo(elseBlock);
+                }
+                break;
+            }
+            case Opcode::SWITCH:
+                emitSwitch(term);
+                break;
+            default:
+                if (term.src1 == IR_NONE) as_.movRI(Reg::RAX, 0);
+                else load(Reg::RAX, term.src1);
+                emitEpilogue();
+                break;
+        }
+    }
+
+    for (const auto& fix : blockFixups_) as_.patchRel32(fix.first, blockStart[fix.second]);
+    for (const auto& fix : tableFixups_) as_.patch32(fix.at, blockStart[fix.block] - fix.table);
+    emitErrorStub(divisionFixups_, ERROR_DIVISION);
+    emitErrorStub(stackFixups_, ERROR_STACK);
+    return 16 + saved + locals;
+}
+
+void FunctionEmitter::emitInstr(const Instr& in, uint32_t& argSlot) {
+    switch (in.op) {
+        case Opcode::CONST:
+        case Opcode::STR: {
+            int64_t v = in.op == Opcode::CONST ? in.imm() : in.src1;
+            if (inReg(in.dest)) {
+                as_.movRI(reg(in.dest), v);
+            } else if (v >= INT32_MIN && v <= INT32_MAX) {
+                as_.movMI(mem(in.dest), static_cast<int32_t>(v));
+            } else {
+                as_.movRI(Reg::RAX, v);
+                store(in.dest, Reg::RAX);
+            }
+            break;
+        }
+        case Opcode::COPY:
+            if (in.dest == in.src1) break;
+            if (inReg(in.dest)) load(reg(in.dest), in.src1);
+            else store(in.dest, source(in.src1, Reg::RAX));
+            break;
+        case Opcode::NEG: {
+            Reg r = inReg(in.dest) ? reg(in.dest) : Reg::RAX;
+            load(r, in.src1);
+            as_.neg(r);
+            store(in.dest, r);
+            break;
+        }
+        case Opcode::DIV:
+            emitDivision(in);
+            break;
+        case Opcode::ARG:
+            as_.movMR(Mem{Reg::RSP, 8 * static_cast<int32_t>(argSlot++)}, source(in.src1, Reg::RAX));
+            break;
+        case Opcode::CALL:
+            callFixups_.push_back({as_.call32(), in.src1});
+            argSlot = 0;
+            store(in.dest, Reg::RAX);
+            break;
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+            emitArithmetic(in);
+            break;
+        default:
+            // EQ .. GE
+            emitCompare(in.src1, in.src2);
+            as_.setcc(condFor(in.op), Reg::RAX);
+            as_.movzxByte(Reg::RAX, Reg::RAX);
+            store(in.dest, Reg::RAX);
+            break;
+    }
+}
+
+// dest = a <op> b, computed in dest's register when that does not clobber b.
+void FunctionEmitter::emitArithmetic(const Instr& in) {
+    uint32_t a = in.src1, b = in.src2;
+    Reg target = Reg::RAX;
+    if (inReg(in.dest)) {
+        target = reg(in.dest);
+        if (a != b && inReg(b) && reg(b) == target) {
+            if (in.op == Opcode::SUB) target = Reg::RAX;
+            else std::swap(a, b);
+        }
+    }
+    load(target, a);
+    if (in.op == Opcode::MUL) {
+        if (inReg(b)) as_.imulRR(target, reg(b));
+        else as_.imulRM(target, mem(b));
+    } else {
+        alu(in.op == Opcode::ADD ? AluOp::ADD : AluOp::SUB, target, b);
+    }
+    store(in.dest, target);
+}
+
+// idiv faults on a zero divisor and on INT64_MIN / -1, so both are checked
+// first; the latter wraps like the other operators.
+void FunctionEmitter::emitDivision(const Instr& in) {
+    load(Reg::RAX, in.src1);
+    load(Reg::RCX, in.src2);
+    as_.testRR(Reg::RCX, Reg::RCX);
+    divisionFixups_.push_back(as_.jcc32(Cond::E));
+    as_.cmpRI(Reg::RCX, -1);
+    uint32_t divide = as_.jcc32(Cond::NE);
+    as_.neg(Reg::RAX);
+    uint32_t done = as_.jmp32();
+    as_.patchRel32(divide, as_.size());
+    as_.cqo();
+    as_.idiv(Reg::RCX);
+    as_.patchRel32(done, as_.size());
+    store(in.dest, Reg::RAX);
+}
+
+void FunctionEmitter::emitCompare(uint32_t a, uint32_t b) {
+    alu(AluOp::CMP, source(a, Reg::RAX), b);
+}
+
+void FunctionEmitter::emitEpilogue() {
+    int32_t saved = static_cast<int32_t>(alloc_.calleeSaved.size()) * 8;
+    as_.lea(Reg::RSP, Mem{Reg::RBP, -saved});
+    for (size_t i = alloc_.calleeSaved.size(); i-- > 0;) as_.pop(alloc_.calleeSaved[i]);
+    as_.pop(Reg::RBP);
+    as_.ret();
+}
+
+void FunctionEmitter::jumpTo(uint32_t block) {
+    blockFixups_.push_back({as_.jmp32(), block});
+}
+
+// An unsigned compare sends out-of-range indices to the default; the rest
+// jump through an inline table of int32 offsets from the table's start.
+void FunctionEmitter::emitSwitch(const Instr& term) {
+    const uint32_t* targets = &fn_.switchTargets[term.src2];
+    load(Reg::RAX, term.src1);
+    as_.cmpRI32(Reg::RAX, static_cast<int32_t>(term.dest));
+    blockFixups_.push_back({as_.jcc32(Cond::AE), targets[term.dest]});
+    uint32_t lea = as_.leaRip(Reg::RCX);
+    as_.movsxdScaled(Reg::RAX, Reg::RCX, Reg::RAX);
+    as_.aluRR(AluOp::ADD, Reg::RAX, Reg::RCX);
+    as_.jmpR(Reg::RAX);
+    uint32_t table = as_.size();
+    as_.patchRel32(lea, table);
+    for (uint32_t k = 0; k < term.dest; ++k) {
+        tableFixups_.push_back({as_.size(), table, targets[k]});
+        as_.data32(0);
+    }
+}
+
+// Records the error for call() and unwinds through the trampoline.
+void FunctionEmitter::emitErrorStub(const std::vector<uint32_t>& fixups, uint32_t kind) {
+    if (fixups.empty()) return;
+    for (uint32_t at : fixups) as_.patchRel32(at, as_.size());
+    as_.movRI(Reg::RCX, address(&context_->error));
+    as_.movMI(Mem{Reg::RCX, 0}, static_cast<int32_t>(index_ * 4 + kind));
+    as_.patchRel32(as_.jmp32(), resume_);
+}
+
+}  // namespace
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+Jit::Jit(const IrModule& module, size_t stackBytes)
+    : module_(module), context_(new Context{0, 0, 0}), stackBytes_(stackBytes) {
+    compile();
+}
+
+Jit::~Jit() {
+#if JIT_SUPPORTED
+    if (code_) munmap(code_, codeBytes_);
+    if (stack_) munmap(stack_, stackBytes_);
+#endif
+}
+
+bool Jit::compiled() const {
+    return compiled_;
+}
+
+uint32_t Jit::find(const std::string& name) const {
+    for (uint32_t i = 0; i < module_.functions.size(); ++i) {
+        if (module_.functions[i].name == name) return i;
+    }
+    return IR_NONE;
+}
+
+size_t Jit::codeSize() const {
+    return codeSize_;
+}
+
+bool Jit::hasErrors() const {
+    return !errors_.empty();
+}
+
+const std::vector<JitError>& Jit::errors() const {
+    return errors_;
+}
+
+// ============================================================
+// Compilation
+// ============================================================
+//
+// The buffer starts with the trampoline that call() enters through, as
+// `int64_t (*)(int64_t* stack, const void* function)`. It saves the
+// callee-saved registers and the native RSP, switches to the JIT stack
+// (already holding the arguments) and calls the function. Error stubs jump
+// to its second half, which restores the native RSP and returns.
+
+void Jit::compile() {
+#if !JIT_SUPPORTED
+    errors_.push_back({"native code generation needs x86-64 Linux", ""});
+#else
+    for (const IrFunction& fn : module_.functions) {
+        for (const Instr& in : fn.instrs) {
+            if (in.op == Opcode::PHI) {
+                errors_.push_back({"PHI in input; leave SSA form first", fn.name});
+                return;
+            }
+        }
+    }
+
+    static const Reg SAVED[] = {Reg::RBX, Reg::RBP, Reg::R12, Reg::R13, Reg::R14, Reg::R15};
+    X86Emitter as;
+    trampoline_ = as.size();
+    for (Reg r : SAVED) as.push(r);
+    as.movRI(Reg::RAX, address(&context_->savedRsp));
+    as.movMR(Mem{Reg::RAX, 0}, Reg::RSP);
+    as.movRR(Reg::RSP, Reg::RDI);
+    as.callR(Reg::RSI);
+    uint32_t resume = as.size();
+    as.movRI(Reg::RCX, address(&context_->savedRsp));
+    as.movRM(Reg::RSP, Mem{Reg::RCX, 0});
+    for (size_t i = sizeof(SAVED) / sizeof(SAVED[0]); i-- > 0;) as.pop(SAVED[i]);
+    as.ret();
+
+    std::vector<std::pair<uint32_t, uint32_t>> callFixups;
+    size_t maxFrame = 0;
+    entry_.resize(module_.functions.size());
+    for (uint32_t i = 0; i < module_.functions.size(); ++i) {
+        entry_[i] = as.size();
+        FunctionEmitter emitter(as, module_.functions[i], i, context_.get(), resume, callFixups);
+        size_t frame = emitter.emit();
+        if (frame > maxFrame) maxFrame = frame;
+    }
+    for (const auto& fix : callFixups) as.patchRel32(fix.first, entry_[fix.second]);
+
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    codeSize_ = as.size();
+    codeBytes_ = (codeSize_ + page - 1) / page * page;
+    void* code = mmap(nullptr, codeBytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        errors_.push_back({"could not map memory for code", ""});
+        return;
+    }
+    code_ = static_cast<uint8_t*>(code);
+    std::memcpy(code_, as.code().data(), codeSize_);
+    if (mprotect(code_, codeBytes_, PROT_READ | PROT_EXEC) != 0) {
+        errors_.push_back({"could not make code executable", ""});
+        return;
+    }
+
+    void* stack = mmap(nullptr, stackBytes_, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (stack == MAP_FAILED) {
+        stack_ = nullptr;
+        errors_.push_back({"could not map memory for the stack", ""});
+        return;
+    }
+    stack_ = static_cast<uint8_t*>(stack);
+    context_->stackLimit = static_cast<uint64_t>(address(stack_)) + maxFrame + STACK_SLACK;
+    compiled_ = true;
+#endif
+}
+
+// ============================================================
+// Running
+// ============================================================
+
+bool Jit::call(uint32_t fn, const std::vector<int64_t>& args, int64_t& result) {
+    if (!compiled_) return false;
+    errors_.clear();
+    if (fn >= module_.functions.size()) {
+        errors_.push_back({"no such function", ""});
+        return false;
+    }
+    const IrFunction& callee = module_.functions[fn];
+    if (args.size() != callee.numParams) {
+        errors_.push_back({"expected " + std::to_string(callee.numParams) + " argument(s), got " +
+                               std::to_string(args.size()),
+                           callee.name});
+        return false;
+    }
+
+#if JIT_SUPPORTED
+    // The arguments go at the top of the JIT stack, where the callee finds
+    // its parameters; RSP must be 16-byte aligned at the call.
+    uintptr_t top = reinterpret_cast<uintptr_t>(stack_ + stackBytes_);
+    uintptr_t sp = (top - args.size() * 8) & ~uintptr_t(15);
+    if (sp < context_->stackLimit) {
+        errors_.push_back({"stack overflow", callee.name});
+        return false;
+    }
+    int64_t* slots = reinterpret_cast<int64_t*>(sp);
+    for (size_t i = 0; i < args.size(); ++i) slots[i] = args[i];
+
+    using Trampoline = int64_t (*)(int64_t*, const void*);
+    auto enter = reinterpret_cast<Trampoline>(code_ + trampoline_);
+    context_->error = 0;
+    int64_t value = enter(slots, code_ + entry_[fn]);
+    if (context_->error != 0) {
+        uint64_t failed = context_->error / 4;
+        const char* message = context_->error % 4 == ERROR_DIVISION ? "division by zero" : "stack overflow";
+        errors_.push_back({message, module_.functions[failed].name});
+        return false;
+    }
+    result = value;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,94 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "../codegen/ir.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Native code generation is available on x86-64 Linux only; elsewhere the
+// Jit reports itself unsupported and callers fall back to an interpreter.
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_SUPPORTED 1
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+// ============================================================
+// JitError — compile-time or run-time failure, tagged with its function
+// ============================================================
+struct JitError {
+    std::string message;
+    std::string function;
+};
+
+// ============================================================
+// Jit — IR (not in SSA form) to x86-64 machine code in memory
+// ============================================================
+//
+// The constructor compiles every function of the module into one mmap'ed
+// buffer, which is made executable (and no longer writable) before
+// anything runs. Values live in registers chosen by linear scan (see
+// regalloc.h) or in stack slots. Functions pass arguments on the stack and
+// return in RAX; they preserve the System V callee-saved registers.
+//
+// Generated code runs on its own mmap'ed stack, so deep recursion cannot
+// reach the native one: every function checks the remaining space on
+// entry. Division by zero and running out of stack unwind straight back
+// to call() with an error. Values follow the VM: i64 wrapping arithmetic,
+// 0 / 1 for comparisons, 0 for unit, a string is the index of its literal.
+//
+// Not thread-safe: one call() at a time per Jit.
+class Jit {
+public:
+    static constexpr size_t DEFAULT_STACK_BYTES = size_t(64) << 20;
+
+    explicit Jit(const IrModule& module, size_t stackBytes = DEFAULT_STACK_BYTES);
+    ~Jit();
+    Jit(const Jit&) = delete;
+    Jit& operator=(const Jit&) = delete;
+
+    // False when the module could not be compiled (PHI in the input, an
+    // unsupported platform, no executable memory); errors() says why.
+    bool compiled() const;
+
+    // Index of the function called `name`, or IR_NONE.
+    uint32_t find(const std::string& name) const;
+
+    // Runs function `fn`. Returns false, with the reason in errors(), if
+    // nothing was compiled, on a wrong argument count, on division by zero
+    // or when the stack runs out.
+    bool call(uint32_t fn, const std::vector<int64_t>& args, int64_t& result);
+
+    // Bytes of machine code generated.
+    size_t codeSize() const;
+
+    bool hasErrors() const;
+    const std::vector<JitError>& errors() const;
+
+    // Shared with the generated code, which addresses it absolutely.
+    struct Context {
+        uint64_t savedRsp;    // native stack pointer while generated code runs
+        uint64_t stackLimit;  // lowest RSP a function may start its frame at
+        uint64_t error;       // 0, or function index * 4 + error kind
+    };
+
+private:
+    const IrModule& module_;
+    std::vector<JitError> errors_;
+    std::unique_ptr<Context> context_;
+    uint8_t* code_ = nullptr;
+    size_t codeBytes_ = 0;   // mapped
+    size_t codeSize_ = 0;    // used
+    uint8_t* stack_ = nullptr;
+    size_t stackBytes_ = 0;
+    std::vector<uint32_t> entry_;  // code offset of each function
+    uint32_t trampoline_ = 0;
+    bool compiled_ = false;
+
+    void compile();
+};
+
+#endif // JIT_H
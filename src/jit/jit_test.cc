@@ -0,0 +1,398 @@
+#include "jit.h"
+#include "regalloc.h"
+#include "x86_emitter.h"
+#include "../codegen/codegen.h"
+#include "../codegen/ssa.h"
+#include "../interp/interpreter.h"
+#include "../parser/parser.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static IrModule lowerSource(const std::string& src, bool optimize) {
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << "Unexpected parse error in: " << src;
+    CodeGen gen(prog.get());
+    IrModule module = gen.lower();
+    EXPECT_FALSE(gen.hasErrors());
+    if (optimize) {
+        IrOptStats stats;
+        optimizeModule(module, stats);
+    }
+    return module;
+}
+
+struct Outcome {
+    bool ok;
+    int64_t value;
+};
+
+static Outcome interpret(const std::string& src) {
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    Interpreter interp(prog.get());
+    int64_t value = 0;
+    bool ok = interp.call("main", {}, value);
+    return {ok, value};
+}
+
+// Runs main() natively on plain and optimized IR and checks both against
+// the interpreter: same result, or both failing.
+static void expectSameAsInterpreter(const std::string& src) {
+    Outcome expected = interpret(src);
+    for (bool optimize : {false, true}) {
+        IrModule module = lowerSource(src, optimize);
+        Jit jit(module);
+        ASSERT_TRUE(jit.compiled()) << jit.errors()[0].message;
+        int64_t value = 0;
+        bool ok = jit.call(jit.find("main"), {}, value);
+        EXPECT_EQ(ok, expected.ok) << (optimize ? "-O: " : "") << src;
+        if (ok && expected.ok) {
+            EXPECT_EQ(value, expected.value) << (optimize ? "-O: " : "") << src;
+        }
+    }
+}
+
+static int64_t runMain(const std::string& src) {
+    IrModule module = lowerSource(src, false);
+    Jit jit(module);
+    int64_t result = 0;
+    EXPECT_TRUE(jit.call(jit.find("main"), {}, result))
+        << (jit.hasErrors() ? jit.errors()[0].message : "");
+    return result;
+}
+
+static std::vector<uint8_t> bytes(std::initializer_list<int> list) {
+    std::vector<uint8_t> out;
+    for (int b : list) out.push_back(static_cast<uint8_t>(b));
+    return out;
+}
+
+#define REQUIRE_JIT() \
+    if (!JIT_SUPPORTED) GTEST_SKIP() << "no native code generation on this platform"
+
+// ============================================================
+// Encoding
+// ============================================================
+
+TEST(X86Emitter, RegisterAndMemoryForms) {
+    X86Emitter as;
+    as.movRR(Reg::RAX, Reg::RBX);
+    as.movRM(Reg::RAX, Mem{Reg::RBP, -8});
+    as.movMR(Mem{Reg::RSP, 8}, Reg::RSI);
+    as.push(Reg::R12);
+    as.aluRR(AluOp::ADD, Reg::R9, Reg::R10);
+    as.imulRM(Reg::R11, Mem{Reg::RBP, 256});
+    EXPECT_EQ(as.code(), bytes({0x48, 0x89, 0xD8,                       // mov rax, rbx
+                                0x48, 0x8B, 0x45, 0xF8,                 // mov rax, [rbp-8]
+                                0x48, 0x89, 0x74, 0x24, 0x08,           // mov [rsp+8], rsi
+                                0x41, 0x54,                             // push r12
+                                0x4D, 0x01, 0xD1,                       // add r9, r10
+                                0x4C, 0x0F, 0xAF, 0x9D, 0x00, 0x01, 0x00, 0x00}));  // imul r11, [rbp+256]
+}
+
+TEST(X86Emitter, ImmediatesUseTheShortestForm) {
+    X86Emitter as;
+    as.movRI(Reg::RAX, 0);
+    as.movRI(Reg::R8, 7);
+    as.movRI(Reg::RCX, -1);
+    as.movRI(Reg::RDX, INT64_MIN);
+    EXPECT_EQ(as.code(), bytes({0x31, 0xC0,                                // xor eax, eax
+                                0x41, 0xB8, 7, 0, 0, 0,                    // mov r8d, 7
+                                0x48, 0xC7, 0xC1, 0xFF, 0xFF, 0xFF, 0xFF,  // mov rcx, -1
+                                0x48, 0xBA, 0, 0, 0, 0, 0, 0, 0, 0x80}));  // movabs rdx, INT64_MIN
+}
+
+TEST(X86Emitter, BranchesArePatched) {
+    X86Emitter as;
+    uint32_t forward = as.jcc32(Cond::L);
+    as.ret();
+    as.patchRel32(forward, as.size());
+    uint32_t back = as.jmp32();
+    as.patchRel32(back, 0);
+    EXPECT_EQ(as.code(), bytes({0x0F, 0x8C, 1, 0, 0, 0, 0xC3, 0xE9, 0xF4, 0xFF, 0xFF, 0xFF}));
+}
+
+TEST(X86Emitter, JumpTableForms) {
+    X86Emitter as;
+    as.cmpRI32(Reg::RAX, 8);
+    uint32_t lea = as.leaRip(Reg::RCX);
+    as.movsxdScaled(Reg::RAX, Reg::RCX, Reg::R9);
+    as.jmpR(Reg::R11);
+    as.patchRel32(lea, as.size());
+    as.data32(0);
+    as.patch32(as.size() - 4, 0xFFFFFFF0);
+    EXPECT_EQ(as.code(), bytes({0x48, 0x81, 0xF8, 8, 0, 0, 0,    // cmp rax, 8
+                                0x48, 0x8D, 0x0D, 7, 0, 0, 0,    // lea rcx, [rip+7]
+                                0x4A, 0x63, 0x04, 0x89,          // movsxd rax, [rcx+r9*4]
+                                0x41, 0xFF, 0xE3,                // jmp r11
+                                0xF0, 0xFF, 0xFF, 0xFF}));
+}
+
+// ============================================================
+// Register allocation
+// ============================================================
+
+TEST(RegAlloc, LoopValuesStayInRegisters) {
+    IrModule m = lowerSource("fn f(n: i64) { let mut i = 0; let mut s = 0; "
+                             "while i < n { s = s + i; i = i + 1; } return s; }", true);
+    RegAllocation alloc = allocateRegisters(m.functions[0]);
+    EXPECT_EQ(alloc.numSlots, 0u);
+    for (const LiveInterval& iv : computeLiveIntervals(m.functions[0])) {
+        EXPECT_TRUE(alloc.inReg[iv.value]) << "value " << iv.value;
+    }
+    EXPECT_TRUE(alloc.calleeSaved.empty());
+}
+
+TEST(RegAlloc, ValuesLiveAcrossCallsGetCalleeSavedRegisters) {
+    IrModule m = lowerSource("fn g() { return 1; } fn f(a: i64) { let b = g(); return a + b; }", false);
+    const IrFunction& f = m.functions[m.functions[0].name == "f" ? 0 : 1];
+    bool found = false;
+    for (const LiveInterval& iv : computeLiveIntervals(f)) {
+        if (iv.value != 0) continue;
+        found = true;
+        EXPECT_TRUE(iv.crossesCall);
+    }
+    ASSERT_TRUE(found);
+    RegAllocation alloc = allocateRegisters(f);
+    ASSERT_TRUE(alloc.inReg[0]);
+    EXPECT_EQ(alloc.calleeSaved.size(), 1u);
+    EXPECT_EQ(alloc.reg[0], alloc.calleeSaved[0]);
+}
+
+TEST(RegAlloc, PressureSpillsTheLongestInterval) {
+    // Sixteen values live at once, more than the eleven allocatable registers.
+    std::string src = "fn f() { ";
+    for (int i = 0; i < 16; ++i) src += "let v" + std::to_string(i) + " = f2(" + std::to_string(i) + "); ";
+    src += "return v0";
+    for (int i = 1; i < 16; ++i) src += " + v" + std::to_string(i);
+    src += "; } fn f2(x: i64) { return x; }";
+    IrModule m = lowerSource(src, false);
+    RegAllocation alloc = allocateRegisters(m.functions[0]);
+    EXPECT_GT(alloc.numSlots, 0u);
+    EXPECT_EQ(alloc.calleeSaved.size(), 5u);
+}
+
+// ============================================================
+// Running native code
+// ============================================================
+
+TEST(Jit, ArithmeticAndLoops) {
+    REQUIRE_JIT();
+    EXPECT_EQ(runMain("fn main() { let mut i = 0; let mut s = 0; "
+                      "while i < 100 { s = s + i * i - i / 2; i = i + 1; } return -s; }"),
+              -(328350 - 2450));
+}
+
+TEST(Jit, RecursionAndArguments) {
+    REQUIRE_JIT();
+    EXPECT_EQ(runMain(R"(
+fn fib(n: i64) {
+    if n < 2 { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+fn mix(a: i64, b: i64, c: i64, d: i64, e: i64, f: i64, g: i64, h: i64) {
+    return a - b * 2 + c * 3 - d * 4 + e * 5 - f * 6 + g * 7 - h * 8;
+}
+fn main() { return fib(25) + mix(1, 2, 3, 4, 5, 6, 7, 8); }
+)"), 75025 - 36);
+}
+
+TEST(Jit, CallWithArguments) {
+    REQUIRE_JIT();
+    IrModule m = lowerSource("fn add3(a: i64, b: i64, c: i64) { return a * 100 + b * 10 + c; }", true);
+    Jit jit(m);
+    int64_t result = 0;
+    ASSERT_TRUE(jit.call(jit.find("add3"), {1, 2, 3}, result));
+    EXPECT_EQ(result, 123);
+    EXPECT_FALSE(jit.call(jit.find("add3"), {1}, result));
+    EXPECT_EQ(jit.find("missing"), IR_NONE);
+    EXPECT_GT(jit.codeSize(), 0u);
+}
+
+TEST(Jit, DeepRecursionUsesItsOwnStack) {
+    REQUIRE_JIT();
+    EXPECT_EQ(runMain(R"(
+fn down(n: i64) {
+    if n == 0 { return 0; }
+    return down(n - 1) + 1;
+}
+fn main() { return down(200000); }
+)"), 200000);
+}
+
+TEST(Jit, DivisionByZeroStopsExecution) {
+    REQUIRE_JIT();
+    IrModule m = lowerSource("fn div(a: i64, b: i64) { return a / b; } fn main() { return div(1, 0); }", false);
+    Jit jit(m);
+    int64_t result = 0;
+    EXPECT_FALSE(jit.call(jit.find("main"), {}, result));
+    ASSERT_EQ(jit.errors().size(), 1u);
+    EXPECT_EQ(jit.errors()[0].message, "division by zero");
+    EXPECT_EQ(jit.errors()[0].function, "div");
+
+    // The stack is unwound, so the next call starts clean.
+    ASSERT_TRUE(jit.call(jit.find("div"), {-9, 2}, result));
+    EXPECT_EQ(result, -4);
+    ASSERT_TRUE(jit.call(jit.find("div"), {INT64_MIN, -1}, result));
+    EXPECT_EQ(result, INT64_MIN);
+}
+
+TEST(Jit, RunawayRecursionOverflows) {
+    REQUIRE_JIT();
+    IrModule m = lowerSource("fn f(n: i64) { return f(n + 1); } fn main() { return f(0); }", false);
+    Jit jit(m, 1 << 16);
+    int64_t result = 0;
+    EXPECT_FALSE(jit.call(jit.find("main"), {}, result));
+    ASSERT_EQ(jit.errors().size(), 1u);
+    EXPECT_EQ(jit.errors()[0].message, "stack overflow");
+    EXPECT_EQ(jit.errors()[0].function, "f");
+}
+
+TEST(Jit, SsaFormIsNotCompiled) {
+    IrModule m = lowerSource("fn f(n: i64) { let mut i = 0; while i < n { i = i + 1; } return i; }", false);
+    buildSsa(m.functions[0]);
+    Jit jit(m);
+    EXPECT_FALSE(jit.compiled());
+    ASSERT_TRUE(jit.hasErrors());
+    int64_t result = 0;
+    EXPECT_FALSE(jit.call(0, {5}, result));
+}
+
+// ============================================================
+// Differential tests against the interpreter
+// ============================================================
+
+TEST(JitDifferential, HandWrittenPrograms) {
+    REQUIRE_JIT();
+    const char* programs[] = {
+        "fn main() { let big = 9223372036854775807; return big + 1; }",
+        "fn main() { let a = 3 <= 3; let b = 2 >= 3; let c = 4 != 4; return a * 100 + b * 10 + c; }",
+        "fn main() { let s = \"a\"; let t = \"a\"; return (s == s) * 10 + (s == t); }",
+        "fn main() { let x = 1; { let x = x + 10; x = x + 1; } let x = x * 5; return x; }",
+        "fn sign(x: i64) { if x < 0 { return -1; } else if x == 0 { return 0; } else { return 1; } } "
+        "fn main() { return sign(-5) * 100 + sign(0) * 10 + sign(7); }",
+        "fn pair(a: i64, b: i64) { return a * 10 + b; } "
+        "fn main() { let mut x = 1; let r = pair(x, pair(x = 2, x)); return r * 100 + x; }",
+        "fn gcd(a: i64, b: i64) { let mut x = a; let mut y = b; "
+        "while y != 0 { let t = y; y = x - x / y * y; x = t; } return x; } "
+        "fn main() { return gcd(1071, 462) * 1000 + gcd(-48, 18); }",
+        "fn g() { let x = 1; } fn main() { g(); return 5; }",
+        "fn main() { let mut n = 27; let mut steps = 0; "
+        "while n != 1 { if n - n / 2 * 2 == 0 { n = n / 2; } else { n = 3 * n + 1; } steps = steps + 1; } "
+        "return steps; }",
+        "fn main() { return 1 / (2 - 2); }",
+        "fn main() { return main2(); fn main2() { return 4294967296 * 3 + -4294967297; } }",
+        "fn f(x: i64) -> i64 { match x { 0 => 5, 1 => 3, 2 | 3 => 8, 5 => 1, 6 => 9, _ => -1 } } "
+        "fn main() -> i64 { let mut s = 0; for i in -2..9 { s = s * 10 + f(i) + 1; } "
+        "s + f(-9223372036854775807 - 1) }",
+        "fn f(x: i64, y: i64) -> i64 { match x + y { 100 => x, 101 => y, 102 => 7, 103 => 8, "
+        "104 => 9, 9000 => 1, _ => 0 } } "
+        "fn main() -> i64 { f(50, 50) * 100000 + f(1, 100) * 1000 + f(100, 3) * 10 + f(4000, 5000) }",
+    };
+    for (const char* src : programs) expectSameAsInterpreter(src);
+}
+
+TEST(JitDifferential, ManyValuesLiveAcrossCalls) {
+    REQUIRE_JIT();
+    std::string src = "fn id(x: i64) { return x; } fn main() { ";
+    for (int i = 0; i < 20; ++i) src += "let v" + std::to_string(i) + " = id(" + std::to_string(i * 7 - 30) + "); ";
+    src += "let mut s = 0; let mut k = 0; while k < 3 { ";
+    for (int i = 0; i < 20; ++i) src += "s = s * 3 + v" + std::to_string(i) + " - id(k); ";
+    src += "k = k + 1; } return s; }";
+    expectSameAsInterpreter(src);
+}
+
+// Random straight-line and looping functions over i64, with calls between
+// them; divisions may hit zero, in which case both sides must fail.
+class ProgramGenerator {
+public:
+    explicit ProgramGenerator(uint32_t seed) : rng_(seed) {}
+
+    std::string program() {
+        std::string src;
+        int fns = 1 + pick(3);
+        for (int f = 0; f < fns; ++f) {
+            vars_ = {"a", "b"};
+            callable_ = f;
+            src += "fn f" + std::to_string(f) + "(a: i64, b: i64) {\n";
+            int stmts = 2 + pick(5);
+            for (int s = 0; s < stmts; ++s) src += statement(1);
+            src += "    return " + expr(3) + ";\n}\n";
+        }
+        vars_ = {};
+        callable_ = fns;
+        src += "fn main() { return " + expr(3) + "; }\n";
+        return src;
+    }
+
+private:
+    std::mt19937 rng_;
+    std::vector<std::string> vars_;
+    int callable_ = 0;  // functions f0 .. f(callable_ - 1) may be called
+    int loops_ = 0;
+
+    int pick(int n) { return static_cast<int>(rng_() % static_cast<uint32_t>(n)); }
+
+    std::string expr(int depth) {
+        int choice = pick(depth > 0 ? 7 : 2);
+        if (choice == 0 || (choice == 1 && vars_.empty())) {
+            int64_t v = pick(4) == 0 ? static_cast<int64_t>(rng_()) * 977 : pick(20) - 5;
+            return std::to_string(v);
+        }
+        if (choice == 1) return vars_[pick(static_cast<int>(vars_.size()))];
+        if (choice == 2 && callable_ > 0) {
+            return "f" + std::to_string(pick(callable_)) + "(" + expr(depth - 1) + ", " + expr(depth - 1) + ")";
+        }
+        static const char* ops[] = {"+", "-", "*", "/", "<", "==", ">=", "!="};
+        return "(" + expr(depth - 1) + " " + ops[pick(8)] + " " + expr(depth - 1) + ")";
+    }
+
+    std::string statement(int depth) {
+        std::string pad(4 * depth, ' ');
+        int choice = pick(depth < 3 ? 4 : 2);
+        if (choice == 0 || vars_.size() < 3) {
+            std::string name = "v" + std::to_string(vars_.size());
+            std::string s = pad + "let mut " + name + " = " + expr(2) + ";\n";
+            vars_.push_back(name);
+            return s;
+        }
+        if (choice == 1) return pad + vars_[pick(static_cast<int>(vars_.size()))] + " = " + expr(2) + ";\n";
+        if (choice == 2) {
+            std::string cond = expr(2);
+            return pad + "if " + cond + " {\n" + block(depth + 1, 1) + pad + "} else {\n" +
+                   block(depth + 1, 1) + pad + "}\n";
+        }
+        std::string counter = "k" + std::to_string(loops_++);
+        std::string bound = std::to_string(1 + pick(6));
+        return pad + "let mut " + counter + " = 0;\n" + pad + "while " + counter + " < " + bound +
+               " {\n" + block(depth + 1, 2) + pad + "    " + counter + " = " + counter + " + 1;\n" +
+               pad + "}\n";
+    }
+
+    // Statements of a nested block; its lets go out of scope at the end.
+    std::string block(int depth, int count) {
+        size_t scope = vars_.size();
+        std::string s;
+        for (int i = 0; i < count; ++i) s += statement(depth);
+        vars_.resize(scope);
+        return s;
+    }
+};
+
+TEST(JitDifferential, RandomPrograms) {
+    REQUIRE_JIT();
+    for (uint32_t seed = 1; seed <= 300; ++seed) {
+        ProgramGenerator gen(seed);
+        expectSameAsInterpreter(gen.program());
+        if (HasFailure()) {
+            ADD_FAILURE() << "seed " << seed;
+            return;
+        }
+    }
+}
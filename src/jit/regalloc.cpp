@@ -0,0 +1,203 @@
+#include "regalloc.h"
+#include <algorithm>
+
+// Allocation order: caller-saved first for short-lived values, then
+// callee-saved. RAX, RCX and RDX are scratch for instruction selection,
+// RSP and RBP hold the frame.
+static const Reg CALLER_SAVED[] = {Reg::RSI, Reg::RDI, Reg::R8, Reg::R9, Reg::R10, Reg::R11};
+static const Reg CALLEE_SAVED[] = {Reg::RBX, Reg::R12, Reg::R13, Reg::R14, Reg::R15};
+
+static bool isCalleeSaved(Reg r) {
+    return std::find(std::begin(CALLEE_SAVED), std::end(CALLEE_SAVED), r) != std::end(CALLEE_SAVED);
+}
+
+template <typename F>
+static void forEachUse(const Instr& in, F f) {
+    switch (in.op) {
+        case Opcode::CONST: case Opcode::STR: case Opcode::CALL: case Opcode::JMP: case Opcode::PHI:
+            break;
+        case Opcode::COPY: case Opcode::NEG: case Opcode::ARG: case Opcode::BR:
+        case Opcode::SWITCH:
+            f(in.src1);
+            break;
+        case Opcode::RET:
+            if (in.src1 != IR_NONE) f(in.src1);
+            break;
+        default:
+            f(in.src1);
+            f(in.src2);
+            break;
+    }
+}
+
+// ============================================================
+// Liveness and intervals
+// ============================================================
+
+namespace {
+
+struct BitSet {
+    std::vector<uint64_t> words;
+
+    explicit BitSet(uint32_t n = 0) : words((n + 63) / 64, 0) {}
+    bool test(uint32_t i) const { return words[i / 64] >> (i % 64) & 1; }
+    void set(uint32_t i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+};
+
+}  // namespace
+
+std::vector<LiveInterval> computeLiveIntervals(const IrFunction& fn) {
+    const uint32_t numBlocks = static_cast<uint32_t>(fn.blocks.size());
+    std::vector<BitSet> use(numBlocks, BitSet(fn.numValues));
+    std::vector<BitSet> def(numBlocks, BitSet(fn.numValues));
+    std::vector<BitSet> liveIn(numBlocks, BitSet(fn.numValues));
+    std::vector<BitSet> liveOut(numBlocks, BitSet(fn.numValues));
+    std::vector<uint32_t> firstPos(numBlocks), lastPos(numBlocks);
+    std::vector<uint32_t> calls;
+
+    uint32_t pos = 1;
+    for (uint32_t b = 0; b < numBlocks; ++b) {
+        firstPos[b] = pos;
+        for (uint32_t i = fn.blocks[b].begin; i < fn.blocks[b].end; ++i, ++pos) {
+            const Instr& in = fn.instrs[i];
+            forEachUse(in, [&](uint32_t v) {
+                if (!def[b].test(v)) use[b].set(v);
+            });
+            if (definesValue(in.op)) def[b].set(in.dest);
+            if (in.op == Opcode::CALL) calls.push_back(pos);
+        }
+        lastPos[b] = pos - 1;
+    }
+
+    // live-out(b) = union of live-in(successors); live-in(b) = use(b) + (live-out(b) - def(b))
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t b = numBlocks; b-- > 0;) {
+            const Instr& term = fn.instrs[fn.blocks[b].end - 1];
+            BitSet out(fn.numValues);
+            auto merge = [&](uint32_t succ) {
+                for (size_t w = 0; w < out.words.size(); ++w) out.words[w] |= liveIn[succ].words[w];
+            };
+            forEachTarget(fn, term, merge);
+            for (size_t w = 0; w < out.words.size(); ++w) {
+                uint64_t in = use[b].words[w] | (out.words[w] & ~def[b].words[w]);
+                if (in != liveIn[b].words[w]) {
+                    liveIn[b].words[w] = in;
+                    changed = true;
+                }
+            }
+            liveOut[b] = std::move(out);
+        }
+    }
+
+    std::vector<uint32_t> start(fn.numValues, UINT32_MAX), end(fn.numValues, 0);
+    auto touch = [&](uint32_t v, uint32_t p) {
+        start[v] = std::min(start[v], p);
+        end[v] = std::max(end[v], p);
+    };
+    for (uint32_t v = 0; v < fn.numParams; ++v) touch(v, 0);
+    pos = 1;
+    for (uint32_t b = 0; b < numBlocks; ++b) {
+        for (uint32_t v = 0; v < fn.numValues; ++v) {
+            if (liveIn[b].test(v)) touch(v, firstPos[b]);
+            if (liveOut[b].test(v)) touch(v, lastPos[b]);
+        }
+        for (uint32_t i = fn.blocks[b].begin; i < fn.blocks[b].end; ++i, ++pos) {
+            const Instr& in = fn.instrs[i];
+            forEachUse(in, [&](uint32_t v) { touch(v, pos); });
+            if (definesValue(in.op)) touch(in.dest, pos);
+        }
+    }
+
+    std::vector<LiveInterval> intervals;
+    for (uint32_t v = 0; v < fn.numValues; ++v) {
+        if (start[v] == UINT32_MAX) continue;
+        auto call = std::upper_bound(calls.begin(), calls.end(), start[v]);
+        intervals.push_back({v, start[v], end[v], call != calls.end() && *call < end[v]});
+    }
+    std::stable_sort(intervals.begin(), intervals.end(),
+                     [](const LiveInterval& a, const LiveInterval& b) { return a.start < b.start; });
+    return intervals;
+}
+
+// ============================================================
+// Linear scan
+// ============================================================
+//
+// An interval may take over a register at the position where the previous
+// holder's interval ends: instruction selection reads every source before
+// writing the destination.
+
+RegAllocation allocateRegisters(const IrFunction& fn) {
+    RegAllocation out;
+    out.inReg.assign(fn.numValues, false);
+    out.reg.assign(fn.numValues, Reg::RAX);
+    out.slot.assign(fn.numValues, NO_SLOT_INDEX);
+
+    std::vector<Reg> freeCaller(std::begin(CALLER_SAVED), std::end(CALLER_SAVED));
+    std::vector<Reg> freeCallee(std::begin(CALLEE_SAVED), std::end(CALLEE_SAVED));
+    std::vector<LiveInterval> active;  // intervals holding a register
+    std::vector<uint32_t> slotFreeAt;  // per spill slot: end of its last occupant
+    bool calleeUsed[16] = {};
+
+    auto take = [](std::vector<Reg>& pool) {
+        Reg r = pool.front();
+        pool.erase(pool.begin());
+        return r;
+    };
+    auto give = [&](uint32_t value, Reg r) {
+        out.inReg[value] = true;
+        out.reg[value] = r;
+        if (isCalleeSaved(r)) calleeUsed[static_cast<unsigned>(r)] = true;
+    };
+    auto spill = [&](const LiveInterval& iv) {
+        out.inReg[iv.value] = false;
+        if (iv.value < fn.numParams) return;  // stays in its argument slot
+        uint32_t s = 0;
+        while (s < slotFreeAt.size() && slotFreeAt[s] > iv.start) ++s;
+        if (s == slotFreeAt.size()) slotFreeAt.push_back(0);
+        slotFreeAt[s] = iv.end;
+        out.slot[iv.value] = static_cast<int32_t>(s);
+    };
+
+    for (const LiveInterval& iv : computeLiveIntervals(fn)) {
+        for (size_t i = 0; i < active.size();) {
+            if (active[i].end <= iv.start) {
+                Reg r = out.reg[active[i].value];
+                (isCalleeSaved(r) ? freeCallee : freeCaller).push_back(r);
+                active.erase(active.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+
+        if (!iv.crossesCall && !freeCaller.empty()) {
+            give(iv.value, take(freeCaller));
+        } else if (!freeCallee.empty()) {
+            give(iv.value, take(freeCallee));
+        } else {
+            // Spill whichever usable interval ends last, this one included.
+            size_t victim = active.size();
+            for (size_t i = 0; i < active.size(); ++i) {
+                if (iv.crossesCall && !isCalleeSaved(out.reg[active[i].value])) continue;
+                if (victim == active.size() || active[i].end > active[victim].end) victim = i;
+            }
+            if (victim == active.size() || active[victim].end <= iv.end) {
+                spill(iv);
+                continue;
+            }
+            LiveInterval old = active[victim];
+            active.erase(active.begin() + victim);
+            give(iv.value, out.reg[old.value]);
+            spill(old);
+        }
+        active.push_back(iv);
+    }
+
+    out.numSlots = static_cast<uint32_t>(slotFreeAt.size());
+    for (Reg r : CALLEE_SAVED) {
+        if (calleeUsed[static_cast<unsigned>(r)]) out.calleeSaved.push_back(r);
+    }
+    return out;
+}
@@ -0,0 +1,49 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "../codegen/ir.h"
+#include "x86_emitter.h"
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// LiveInterval — first and last position a value is live at
+// ============================================================
+//
+// Positions number the instructions in block layout order from 1;
+// position 0 is function entry, where the parameters are defined. One
+// interval per value, without holes: a value live into or out of a block
+// covers the whole block.
+struct LiveInterval {
+    uint32_t value;
+    uint32_t start;
+    uint32_t end;
+    bool crossesCall;  // live across a CALL, so it cannot sit in a caller-saved register
+};
+
+// Intervals of every value that is defined or used, sorted by start.
+std::vector<LiveInterval> computeLiveIntervals(const IrFunction& fn);
+
+// ============================================================
+// RegAllocation — linear scan (Poletto & Sarkar) over the intervals
+// ============================================================
+//
+// A value either keeps one register for its whole interval or lives in a
+// stack slot. Intervals live across a call only get callee-saved
+// registers; the rest prefer caller-saved ones, which the function does
+// not have to preserve. When registers run out, the interval that ends
+// last is spilled. Parameters that are spilled stay in their incoming
+// argument slot, so they get no spill slot.
+static constexpr int32_t NO_SLOT_INDEX = -1;
+
+struct RegAllocation {
+    std::vector<bool> inReg;       // per value
+    std::vector<Reg> reg;          // per value, meaningful when inReg
+    std::vector<int32_t> slot;     // per value: spill slot, or NO_SLOT_INDEX
+    uint32_t numSlots = 0;
+    std::vector<Reg> calleeSaved;  // callee-saved registers the function uses
+};
+
+RegAllocation allocateRegisters(const IrFunction& fn);
+
+#endif // REGALLOC_H
@@ -0,0 +1,255 @@
+#include "x86_emitter.h"
+
+static unsigned num(Reg r) {
+    return static_cast<unsigned>(r);
+}
+
+// ============================================================
+// Encoding helpers
+// ============================================================
+
+void X86Emitter::imm32(uint32_t v) {
+    for (int i = 0; i < 4; ++i) byte(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+// REX with W, R (reg field) and B (r/m or base) bits; omitted when empty.
+void X86Emitter::rex(bool w, unsigned reg, unsigned rm) {
+    uint8_t r = 0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0);
+    if (r != 0x40) byte(r);
+}
+
+void X86Emitter::modrmReg(unsigned reg, unsigned rm) {
+    byte(static_cast<uint8_t>(0xC0 | (reg & 7) << 3 | (rm & 7)));
+}
+
+// Always mod 01 (disp8) or 10 (disp32), so RBP / R13 need no special case;
+// RSP / R12 as base need a SIB byte.
+void X86Emitter::modrmMem(unsigned reg, Mem m) {
+    bool short8 = m.disp >= -128 && m.disp <= 127;
+    unsigned base = num(m.base);
+    byte(static_cast<uint8_t>((short8 ? 0x40 : 0x80) | (reg & 7) << 3 | (base & 7)));
+    if ((base & 7) == 4) byte(0x24);
+    if (short8) byte(static_cast<uint8_t>(m.disp));
+    else imm32(static_cast<uint32_t>(m.disp));
+}
+
+void X86Emitter::opRR(uint8_t opcode, unsigned reg, Reg rm) {
+    rex(true, reg, num(rm));
+    byte(opcode);
+    modrmReg(reg, num(rm));
+}
+
+void X86Emitter::opRM(uint8_t opcode, unsigned reg, Mem m) {
+    rex(true, reg, num(m.base));
+    byte(opcode);
+    modrmMem(reg, m);
+}
+
+// ============================================================
+// Moves
+// ============================================================
+
+void X86Emitter::movRR(Reg dst, Reg src) {
+    opRR(0x89, num(src), dst);
+}
+
+void X86Emitter::movRM(Reg dst, Mem src) {
+    opRM(0x8B, num(dst), src);
+}
+
+void X86Emitter::movMR(Mem dst, Reg src) {
+    opRM(0x89, num(src), dst);
+}
+
+void X86Emitter::movRI(Reg dst, int64_t imm) {
+    if (imm == 0) {
+        // xor r32, r32 clears the whole register.
+        rex(false, num(dst), num(dst));
+        byte(0x31);
+        modrmReg(num(dst), num(dst));
+    } else if (imm > 0 && imm <= UINT32_MAX) {
+        rex(false, 0, num(dst));
+        byte(static_cast<uint8_t>(0xB8 + (num(dst) & 7)));
+        imm32(static_cast<uint32_t>(imm));
+    } else if (imm >= INT32_MIN && imm <= INT32_MAX) {
+        rex(true, 0, num(dst));
+        byte(0xC7);
+        modrmReg(0, num(dst));
+        imm32(static_cast<uint32_t>(imm));
+    } else {
+        rex(true, 0, num(dst));
+        byte(static_cast<uint8_t>(0xB8 + (num(dst) & 7)));
+        uint64_t bits = static_cast<uint64_t>(imm);
+        imm32(static_cast<uint32_t>(bits));
+        imm32(static_cast<uint32_t>(bits >> 32));
+    }
+}
+
+void X86Emitter::movMI(Mem dst, int32_t imm) {
+    opRM(0xC7, 0, dst);
+    imm32(static_cast<uint32_t>(imm));
+}
+
+void X86Emitter::lea(Reg dst, Mem src) {
+    opRM(0x8D, num(dst), src);
+}
+
+uint32_t X86Emitter::leaRip(Reg dst) {
+    rex(true, num(dst), 0);
+    byte(0x8D);
+    byte(static_cast<uint8_t>(0x05 | (num(dst) & 7) << 3));  // mod 00, r/m 101: rip + disp32
+    uint32_t at = size();
+    imm32(0);
+    return at;
+}
+
+// mod 00 with a SIB byte: scale 4, no displacement.
+void X86Emitter::movsxdScaled(Reg dst, Reg base, Reg index) {
+    byte(static_cast<uint8_t>(0x48 | ((num(dst) & 8) ? 4 : 0) | ((num(index) & 8) ? 2 : 0) |
+                              ((num(base) & 8) ? 1 : 0)));
+    byte(0x63);
+    byte(static_cast<uint8_t>(0x04 | (num(dst) & 7) << 3));
+    byte(static_cast<uint8_t>(0x80 | (num(index) & 7) << 3 | (num(base) & 7)));
+}
+
+// ============================================================
+// Arithmetic
+// ============================================================
+
+void X86Emitter::aluRR(AluOp op, Reg dst, Reg src) {
+    opRR(static_cast<uint8_t>(op), num(src), dst);
+}
+
+void X86Emitter::aluRM(AluOp op, Reg dst, Mem src) {
+    // The `reg, r/m` form is the `r/m, reg` opcode + 2.
+    opRM(static_cast<uint8_t>(static_cast<uint8_t>(op) + 2), num(dst), src);
+}
+
+void X86Emitter::cmpMI(Mem dst, int8_t imm) {
+    opRM(0x83, 7, dst);
+    byte(static_cast<uint8_t>(imm));
+}
+
+void X86Emitter::addRI(Reg dst, int32_t imm) {
+    opRR(0x81, 0, dst);
+    imm32(static_cast<uint32_t>(imm));
+}
+
+void X86Emitter::subRI(Reg dst, int32_t imm) {
+    opRR(0x81, 5, dst);
+    imm32(static_cast<uint32_t>(imm));
+}
+
+void X86Emitter::cmpRI(Reg dst, int8_t imm) {
+    opRR(0x83, 7, dst);
+    byte(static_cast<uint8_t>(imm));
+}
+
+void X86Emitter::cmpRI32(Reg dst, int32_t imm) {
+    opRR(0x81, 7, dst);
+    imm32(static_cast<uint32_t>(imm));
+}
+
+void X86Emitter::testRR(Reg a, Reg b) {
+    opRR(0x85, num(b), a);
+}
+
+void X86Emitter::imulRR(Reg dst, Reg src) {
+    rex(true, num(dst), num(src));
+    byte(0x0F);
+    byte(0xAF);
+    modrmReg(num(dst), num(src));
+}
+
+void X86Emitter::imulRM(Reg dst, Mem src) {
+    rex(true, num(dst), num(src.base));
+    byte(0x0F);
+    byte(0xAF);
+    modrmMem(num(dst), src);
+}
+
+void X86Emitter::neg(Reg r) {
+    opRR(0xF7, 3, r);
+}
+
+void X86Emitter::cqo() {
+    byte(0x48);
+    byte(0x99);
+}
+
+void X86Emitter::idiv(Reg divisor) {
+    opRR(0xF7, 7, divisor);
+}
+
+void X86Emitter::setcc(Cond c, Reg dst) {
+    byte(0x0F);
+    byte(static_cast<uint8_t>(0x90 | static_cast<uint8_t>(c)));
+    modrmReg(0, num(dst));
+}
+
+void X86Emitter::movzxByte(Reg dst, Reg src) {
+    rex(false, num(dst), 0);
+    byte(0x0F);
+    byte(0xB6);
+    modrmReg(num(dst), num(src));
+}
+
+// ============================================================
+// Stack and control flow
+// ============================================================
+
+void X86Emitter::push(Reg r) {
+    rex(false, 0, num(r));
+    byte(static_cast<uint8_t>(0x50 + (num(r) & 7)));
+}
+
+void X86Emitter::pop(Reg r) {
+    rex(false, 0, num(r));
+    byte(static_cast<uint8_t>(0x58 + (num(r) & 7)));
+}
+
+void X86Emitter::ret() {
+    byte(0xC3);
+}
+
+void X86Emitter::callR(Reg target) {
+    rex(false, 0, num(target));
+    byte(0xFF);
+    modrmReg(2, num(target));
+}
+
+void X86Emitter::jmpR(Reg target) {
+    rex(false, 0, num(target));
+    byte(0xFF);
+    modrmReg(4, num(target));
+}
+
+uint32_t X86Emitter::jmp32() {
+    byte(0xE9);
+    uint32_t at = size();
+    imm32(0);
+    return at;
+}
+
+uint32_t X86Emitter::jcc32(Cond c) {
+    byte(0x0F);
+    byte(static_cast<uint8_t>(0x80 | static_cast<uint8_t>(c)));
+    uint32_t at = size();
+    imm32(0);
+    return at;
+}
+
+uint32_t X86Emitter::call32() {
+    byte(0xE8);
+    uint32_t at = size();
+    imm32(0);
+    return at;
+}
+
+void X86Emitter::patchRel32(uint32_t at, uint32_t target) {
+    patch32(at, target - (at + 4));
+}
+
+void X86Emitter::patch32(uint32_t at, uint32_t v) {
+    for (int i = 0; i < 4; ++i) code_[at + i] = static_cast<uint8_t>(v >> (8 * i));
+}
@@ -0,0 +1,113 @@
+#ifndef X86_EMITTER_H
+#define X86_EMITTER_H
+
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// Reg / Cond — x86-64 general-purpose registers and condition codes
+// ============================================================
+enum class Reg : uint8_t {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15,
+};
+
+// Values are the low nibble of the Jcc / SETcc opcodes; `cond ^ 1` negates.
+enum class Cond : uint8_t {
+    B = 0x2,
+    AE = 0x3,
+    E = 0x4,
+    NE = 0x5,
+    L = 0xC,
+    GE = 0xD,
+    LE = 0xE,
+    G = 0xF,
+};
+
+inline Cond negate(Cond c) {
+    return static_cast<Cond>(static_cast<uint8_t>(c) ^ 1);
+}
+
+// [base + disp]
+struct Mem {
+    Reg base;
+    int32_t disp;
+};
+
+// Two-operand ALU instructions sharing the 0x01 / 0x03 opcode pattern;
+// the value is the opcode of the `r/m, reg` form.
+enum class AluOp : uint8_t {
+    ADD = 0x01,
+    SUB = 0x29,
+    XOR = 0x31,
+    CMP = 0x39,
+};
+
+// ============================================================
+// X86Emitter — appends 64-bit instructions to a byte buffer
+// ============================================================
+//
+// Only the forms the JIT needs. Every operation is 64-bit (REX.W) unless
+// its name says otherwise. Branches take a rel32 that is patched once the
+// target is known: jmp32() / jcc32() / call32() return the offset of the
+// rel32 field for patchRel32().
+class X86Emitter {
+public:
+    std::vector<uint8_t>& code() { return code_; }
+    const std::vector<uint8_t>& code() const { return code_; }
+    uint32_t size() const { return static_cast<uint32_t>(code_.size()); }
+
+    void movRR(Reg dst, Reg src);
+    void movRM(Reg dst, Mem src);
+    void movMR(Mem dst, Reg src);
+    void movRI(Reg dst, int64_t imm);       // shortest form for the value
+    void movMI(Mem dst, int32_t imm);       // sign-extended
+    void lea(Reg dst, Mem src);
+    uint32_t leaRip(Reg dst);               // lea dst, [rip + rel32]; returns the rel32 field
+    void movsxdScaled(Reg dst, Reg base, Reg index);  // dword [base + index*4]; base not RBP / R13
+
+    void aluRR(AluOp op, Reg dst, Reg src);
+    void aluRM(AluOp op, Reg dst, Mem src);
+    void cmpMI(Mem dst, int8_t imm);
+    void addRI(Reg dst, int32_t imm);
+    void subRI(Reg dst, int32_t imm);
+    void cmpRI(Reg dst, int8_t imm);
+    void cmpRI32(Reg dst, int32_t imm);
+    void testRR(Reg a, Reg b);
+    void imulRR(Reg dst, Reg src);
+    void imulRM(Reg dst, Mem src);
+    void neg(Reg r);
+    void cqo();
+    void idiv(Reg divisor);
+    void setcc(Cond c, Reg dst);            // low byte only: RAX .. RBX
+    void movzxByte(Reg dst, Reg src);       // src low byte: RAX .. RBX
+
+    void push(Reg r);
+    void pop(Reg r);
+    void ret();
+    void callR(Reg target);
+    void jmpR(Reg target);
+
+    uint32_t jmp32();
+    uint32_t jcc32(Cond c);
+    uint32_t call32();
+    // Points the rel32 field at `at` to `target` (both buffer offsets).
+    void patchRel32(uint32_t at, uint32_t target);
+
+    // Raw 32-bit words in the code, for jump tables.
+    void data32(uint32_t v) { imm32(v); }
+    void patch32(uint32_t at, uint32_t v);
+
+private:
+    std::vector<uint8_t> code_;
+
+    void byte(uint8_t b) { code_.push_back(b); }
+    void imm32(uint32_t v);
+    void rex(bool w, unsigned reg, unsigned rm);
+    void modrmReg(unsigned reg, unsigned rm);
+    void modrmMem(unsigned reg, Mem m);
+    void opRR(uint8_t opcode, unsigned reg, Reg rm);
+    void opRM(uint8_t opcode, unsigned reg, Mem m);
+};
+
+#endif // X86_EMITTER_H
@@ -0,0 +1,257 @@
+#include "json_dump.h"
+
+// ============================================================
+// Tokens
+// ============================================================
+
+void writeTokensJson(Lexer& lexer, JsonWriter& out) {
+    out.beginArray();
+    while (true) {
+        Token tok = lexer.nextToken();
+        out.newline();
+        out.beginObject();
+        out.key("type");
+        out.value(tokenTypeToString(tok.type));
+        out.key("lexeme");
+        out.value(tok.lexeme);
+        out.key("line");
+        out.value(static_cast<int64_t>(tok.line));
+        out.key("offset");
+        out.value(static_cast<int64_t>(tok.offset));
+        out.key("length");
+        out.value(static_cast<int64_t>(tok.length));
+        out.endObject();
+        if (tok.type == TokenType::EOF_TOKEN) break;
+    }
+    out.newline();
+    out.endArray();
+    out.newline();
+}
+
+// ============================================================
+// AST
+// ============================================================
+
+static const char* kindName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::PROGRAM:          return "Program";
+        case NodeKind::FN_DECL:          return "FnDecl";
+        case NodeKind::BLOCK:            return "Block";
+        case NodeKind::LET_STMT:         return "LetStmt";
+        case NodeKind::RETURN_STMT:      return "ReturnStmt";
+        case NodeKind::WHILE_STMT:       return "WhileStmt";
+        case NodeKind::IF_STMT:          return "IfStmt";
+        case NodeKind::EXPR_STMT:        return "ExprStmt";
+        case NodeKind::ASSIGN_EXPR:      return "AssignExpr";
+        case NodeKind::BINARY_EXPR:      return "BinaryExpr";
+        case NodeKind::UNARY_EXPR:       return "UnaryExpr";
+        case NodeKind::CALL_EXPR:        return "CallExpr";
+        case NodeKind::IDENT_EXPR:       return "IdentExpr";
+        case NodeKind::NUMBER_LITERAL:   return "NumberLiteral";
+        case NodeKind::STRING_LITERAL:   return "StringLiteral";
+        case NodeKind::STRUCT_DECL:      return "StructDecl";
+        case NodeKind::IMPL_BLOCK:       return "ImplBlock";
+        case NodeKind::LOOP_STMT:        return "LoopStmt";
+        case NodeKind::FOR_STMT:         return "ForStmt";
+        case NodeKind::BREAK_STMT:       return "BreakStmt";
+        case NodeKind::CONTINUE_STMT:    return "ContinueStmt";
+        case NodeKind::FIELD_EXPR:       return "FieldExpr";
+        case NodeKind::METHOD_CALL_EXPR: return "MethodCallExpr";
+        case NodeKind::MATCH_EXPR:       return "MatchExpr";
+        case NodeKind::MATCH_ARM:        return "MatchArm";
+    }
+    return "Unknown";
+}
+
+// Written against the view API (compact_ast.h), like printAst(). Recursion
+// depth follows the tree's, which the parser bounds (Parser::MAX_NESTING).
+template <typename Ref>
+static void writeNode(Ref node, JsonWriter& out);
+
+template <typename Ref>
+static void writeChild(const char* key, Ref child, JsonWriter& out) {
+    out.key(key);
+    if (child) writeNode(child, out);
+    else out.null();
+}
+
+template <typename Ref>
+static void writeList(const char* key, Ref node, JsonWriter& out, bool lines) {
+    out.key(key);
+    out.beginArray();
+    for (Ref child : node.statements()) {
+        if (lines) out.newline();
+        writeNode(child, out);
+    }
+    if (lines) out.newline();
+    out.endArray();
+}
+
+template <typename Ref>
+static void writeParams(const char* key, Ref node, size_t count, ParamView (Ref::*get)(size_t) const,
+                        JsonWriter& out) {
+    out.key(key);
+    out.beginArray();
+    for (size_t i = 0; i < count; ++i) {
+        ParamView p = (node.*get)(i);
+        out.beginObject();
+        out.key("name");
+        out.value(p.name);
+        out.key("type");
+        out.value(p.typeName);
+        out.key("line");
+        out.value(static_cast<int64_t>(p.line));
+        out.endObject();
+    }
+    out.endArray();
+}
+
+template <typename Ref>
+static void writeNode(Ref node, JsonWriter& out) {
+    out.beginObject();
+    out.key("kind");
+    out.value(kindName(node.kind()));
+    out.key("line");
+    out.value(static_cast<int64_t>(node.line()));
+
+    switch (node.kind()) {
+        case NodeKind::PROGRAM:
+            writeList("statements", node, out, true);
+            break;
+        case NodeKind::FN_DECL:
+            out.key("name");
+            out.value(node.name());
+            writeParams("params", node, node.paramCount(), &Ref::param, out);
+            out.key("returnType");
+            if (node.returnType().empty()) out.null();
+            else out.value(node.returnType());
+            writeChild("body", node.body(), out);
+            break;
+        case NodeKind::STRUCT_DECL:
+            out.key("name");
+            out.value(node.name());
+            writeParams("fields", node, node.fieldCount(), &Ref::field, out);
+            break;
+        case NodeKind::IMPL_BLOCK:
+            out.key("type");
+            out.value(node.typeName());
+            writeList("methods", node, out, true);
+            break;
+        case NodeKind::BLOCK:
+            writeList("statements", node, out, false);
+            writeChild("value", node.value(), out);
+            break;
+        case NodeKind::LET_STMT:
+            out.key("mut");
+            out.value(node.isMut());
+            out.key("name");
+            out.value(node.name());
+            out.key("type");
+            if (node.typeName().empty()) out.null();
+            else out.value(node.typeName());
+            writeChild("init", node.init(), out);
+            break;
+        case NodeKind::RETURN_STMT:
+            writeChild("value", node.value(), out);
+            break;
+        case NodeKind::WHILE_STMT:
+            writeChild("condition", node.condition(), out);
+            writeChild("body", node.body(), out);
+            break;
+        case NodeKind::LOOP_STMT:
+            writeChild("body", node.body(), out);
+            break;
+        case NodeKind::FOR_STMT:
+            out.key("name");
+            out.value(node.name());
+            writeChild("iterable", node.iterable(), out);
+            writeChild("body", node.body(), out);
+            break;
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT:
+            break;
+        case NodeKind::IF_STMT:
+            writeChild("condition", node.condition(), out);
+            writeChild("thenBranch", node.thenBranch(), out);
+            writeChild("elseBranch", node.elseBranch(), out);
+            break;
+        case NodeKind::EXPR_STMT:
+            writeChild("expr", node.expr(), out);
+            break;
+        case NodeKind::ASSIGN_EXPR:
+            out.key("target");
+            out.value(node.target());
+            writeChild("value", node.value(), out);
+            break;
+        case NodeKind::BINARY_EXPR:
+            out.key("op");
+            out.value(node.op());
+            writeChild("left", node.left(), out);
+            writeChild("right", node.right(), out);
+            break;
+        case NodeKind::UNARY_EXPR:
+            out.key("op");
+            out.value(node.op());
+            writeChild("operand", node.operand(), out);
+            break;
+        case NodeKind::CALL_EXPR:
+            out.key("callee");
+            out.value(node.callee());
+            out.key("args");
+            out.beginArray();
+            for (Ref arg : node.args()) writeNode(arg, out);
+            out.endArray();
+            break;
+        case NodeKind::METHOD_CALL_EXPR:
+            writeChild("receiver", node.receiver(), out);
+            out.key("method");
+            out.value(node.method());
+            out.key("args");
+            out.beginArray();
+            for (Ref arg : node.args()) writeNode(arg, out);
+            out.endArray();
+            break;
+        case NodeKind::MATCH_EXPR:
+            writeChild("scrutinee", node.scrutinee(), out);
+            out.key("arms");
+            out.beginArray();
+            for (Ref arm : node.arms()) writeNode(arm, out);
+            out.endArray();
+            break;
+        case NodeKind::MATCH_ARM:
+            // An empty list is the `_` arm.
+            out.key("patterns");
+            out.beginArray();
+            for (Ref pattern : node.patterns()) writeNode(pattern, out);
+            out.endArray();
+            writeChild("body", node.body(), out);
+            break;
+        case NodeKind::FIELD_EXPR:
+            writeChild("object", node.object(), out);
+            out.key("name");
+            out.value(node.name());
+            break;
+        case NodeKind::IDENT_EXPR:
+            out.key("name");
+            out.value(node.name());
+            break;
+        case NodeKind::NUMBER_LITERAL:
+        case NodeKind::STRING_LITERAL:
+            out.key("value");
+            out.value(node.literal());
+            break;
+    }
+    out.endObject();
+}
+
+void writeAstJson(const AstNode* root, JsonWriter& out) {
+    if (root) writeNode(AstRef(root), out);
+    else out.null();
+    out.newline();
+}
+
+void writeAstJson(const CompactAst& ast, JsonWriter& out) {
+    if (ast.root()) writeNode(ast.root(), out);
+    else out.null();
+    out.newline();
+}
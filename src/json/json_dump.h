@@ -0,0 +1,26 @@
+#ifndef JSON_DUMP_H
+#define JSON_DUMP_H
+
+#include "../ast/ast.h"
+#include "../ast/compact_ast.h"
+#include "../lexer/lexer.h"
+#include "json_writer.h"
+
+// ============================================================
+// Token and AST dumps (--emit=tokens-json / --emit=ast-json)
+// ============================================================
+
+// An array with one object per token, straight from lexer.nextToken() up to
+// and including EOF, one per line:
+//   {"type":"LET","lexeme":"let","line":1,"offset":0,"length":3}
+void writeTokensJson(Lexer& lexer, JsonWriter& out);
+
+// The tree as nested objects. Every node has "kind" (the node struct's name
+// without "Node": "FnDecl", "BinaryExpr", ...) and "line", then its fields
+// and children by their member names; absent children are null, number
+// literals keep their source text as a string. Top-level statements are
+// written one per line.
+void writeAstJson(const AstNode* root, JsonWriter& out);
+void writeAstJson(const CompactAst& ast, JsonWriter& out);
+
+#endif // JSON_DUMP_H
@@ -0,0 +1,205 @@
+#include "json_dump.h"
+#include "json_writer.h"
+#include "../parser/parser.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// `s` written as a JSON string.
+static std::string escaped(const std::string& s) {
+    std::ostringstream out;
+    {
+        JsonWriter json(out);
+        json.value(s);
+    }
+    return out.str();
+}
+
+static std::string tokensJson(const std::string& source) {
+    std::ostringstream out;
+    Lexer lexer(source);
+    JsonWriter json(out);
+    writeTokensJson(lexer, json);
+    json.flush();
+    return out.str();
+}
+
+static std::string astJson(const std::string& source) {
+    Parser parser(source);
+    auto prog = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors());
+    std::ostringstream out;
+    JsonWriter json(out);
+    writeAstJson(prog.get(), json);
+    json.flush();
+    return out.str();
+}
+
+// ============================================================
+// Strings
+// ============================================================
+
+TEST(JsonWriter, PlainAscii) {
+    EXPECT_EQ(escaped("hello world"), "\"hello world\"");
+    EXPECT_EQ(escaped(""), "\"\"");
+}
+
+TEST(JsonWriter, Escapes) {
+    EXPECT_EQ(escaped("a\"b\\c"), "\"a\\\"b\\\\c\"");
+    EXPECT_EQ(escaped("\n\t\r\b\f"), "\"\\n\\t\\r\\b\\f\"");
+    EXPECT_EQ(escaped(std::string("\x01\x1f", 2)), "\"\\u0001\\u001f\"");
+    EXPECT_EQ(escaped(std::string("\0", 1)), "\"\\u0000\"");
+}
+
+TEST(JsonWriter, Utf8PassesThrough) {
+    EXPECT_EQ(escaped("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80"),
+              "\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"");
+}
+
+TEST(JsonWriter, InvalidUtf8BecomesReplacement) {
+    EXPECT_EQ(escaped("a\xff" "b"), "\"a\\ufffdb\"");
+    EXPECT_EQ(escaped("\xc3"), "\"\\ufffd\"");                // truncated
+    EXPECT_EQ(escaped("\xc0\xaf"), "\"\\ufffd\\ufffd\"");     // overlong '/'
+    EXPECT_EQ(escaped("\xed\xa0\x80"), "\"\\ufffd\\ufffd\\ufffd\"");  // surrogate
+}
+
+// ============================================================
+// Structure
+// ============================================================
+
+TEST(JsonWriter, CommasAndNesting) {
+    std::ostringstream out;
+    {
+        JsonWriter json(out);
+        json.beginObject();
+        json.key("a");
+        json.value(int64_t{1});
+        json.key("b");
+        json.beginArray();
+        json.value(true);
+        json.null();
+        json.beginObject();
+        json.endObject();
+        json.beginArray();
+        json.endArray();
+        json.endArray();
+        json.key("c");
+        json.value("x");
+        json.key("d");
+        json.value(int64_t{-9});
+        json.endObject();
+    }
+    EXPECT_EQ(out.str(), "{\"a\":1,\"b\":[true,null,{},[]],\"c\":\"x\",\"d\":-9}");
+}
+
+TEST(JsonWriter, StringsLargerThanTheBuffer) {
+    std::string big(3 * JsonWriter::BUFFER_SIZE + 7, 'x');
+    big[JsonWriter::BUFFER_SIZE] = '"';
+    std::string expected = "\"" + big + "\"";
+    expected.insert(1 + JsonWriter::BUFFER_SIZE, "\\");
+    EXPECT_EQ(escaped(big), expected);
+}
+
+TEST(JsonWriter, NothingIsWrittenBeforeTheBufferFills) {
+    std::ostringstream out;
+    JsonWriter json(out);
+    json.value("small");
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_TRUE(json.flush());
+    EXPECT_EQ(out.str(), "\"small\"");
+}
+
+// ============================================================
+// Token and AST dumps
+// ============================================================
+
+TEST(JsonDump, Tokens) {
+    EXPECT_EQ(tokensJson("let x;"),
+              "[\n"
+              "{\"type\":\"LET\",\"lexeme\":\"let\",\"line\":1,\"offset\":0,\"length\":3},\n"
+              "{\"type\":\"IDENT\",\"lexeme\":\"x\",\"line\":1,\"offset\":4,\"length\":1},\n"
+              "{\"type\":\"SEMICOLON\",\"lexeme\":\";\",\"line\":1,\"offset\":5,\"length\":1},\n"
+              "{\"type\":\"EOF\",\"lexeme\":\"\",\"line\":1,\"offset\":6,\"length\":0}\n"
+              "]\n");
+}
+
+TEST(JsonDump, StringTokensAreEscaped) {
+    // The lexeme is the string's source text, tabs and undecoded escapes included.
+    std::string json = tokensJson("\"a\tb\\\\\"");
+    EXPECT_NE(json.find("{\"type\":\"STRING\",\"lexeme\":\"a\\tb\\\\\\\\\","),
+              std::string::npos);
+}
+
+TEST(JsonDump, Ast) {
+    EXPECT_EQ(astJson("let mut x: i32 = -1 + 2;"),
+              "{\"kind\":\"Program\",\"line\":0,\"statements\":[\n"
+              "{\"kind\":\"LetStmt\",\"line\":1,\"mut\":true,\"name\":\"x\",\"type\":\"i32\","
+              "\"init\":{\"kind\":\"BinaryExpr\",\"line\":1,\"op\":\"+\","
+              "\"left\":{\"kind\":\"UnaryExpr\",\"line\":1,\"op\":\"-\","
+              "\"operand\":{\"kind\":\"NumberLiteral\",\"line\":1,\"value\":\"1\"}},"
+              "\"right\":{\"kind\":\"NumberLiteral\",\"line\":1,\"value\":\"2\"}}}\n"
+              "]}\n");
+}
+
+TEST(JsonDump, AbsentChildrenAreNull) {
+    std::string json = astJson("fn f(a: i32) { if a { return; } }");
+    EXPECT_NE(json.find("\"params\":[{\"name\":\"a\",\"type\":\"i32\",\"line\":1}]"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"elseBranch\":null"), std::string::npos);
+    EXPECT_NE(json.find("{\"kind\":\"ReturnStmt\",\"line\":1,\"value\":null}"),
+              std::string::npos);
+}
+
+TEST(JsonDump, ItemsAndLoops) {
+    std::string json = astJson("struct P { x: i64 } impl P { fn f(&self) -> i64 { return 1; } }");
+    EXPECT_NE(json.find("{\"kind\":\"StructDecl\",\"line\":1,\"name\":\"P\","
+                        "\"fields\":[{\"name\":\"x\",\"type\":\"i64\",\"line\":1}]}"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"kind\":\"ImplBlock\",\"line\":1,\"type\":\"P\",\"methods\":["),
+              std::string::npos);
+    EXPECT_NE(json.find("\"returnType\":\"i64\""), std::string::npos);
+    EXPECT_NE(astJson("fn f() { }").find("\"returnType\":null"), std::string::npos);
+}
+
+TEST(JsonDump, MatchAndBlockValue) {
+    std::string json = astJson("fn f(x: i64) { match x { 1 | -2 => 3, _ => { x } } }");
+    EXPECT_NE(json.find("\"statements\":[],\"value\":{\"kind\":\"MatchExpr\",\"line\":1,"
+                        "\"scrutinee\":{\"kind\":\"IdentExpr\",\"line\":1,\"name\":\"x\"},"
+                        "\"arms\":[{\"kind\":\"MatchArm\",\"line\":1,\"patterns\":["),
+              std::string::npos);
+    EXPECT_NE(json.find("{\"kind\":\"MatchArm\",\"line\":1,\"patterns\":[],\"body\":"),
+              std::string::npos);
+    EXPECT_NE(astJson("fn f() { }").find("\"statements\":[],\"value\":null"), std::string::npos);
+}
+
+TEST(JsonDump, CompactTreeGivesTheSameOutput) {
+    std::string src =
+        "fn add(a: i32, b: i32) -> i32 { return a + b; }\n"
+        "let x = add(1, 2);\n"
+        "while x > 0 { x = x - 1; print(\"tab\\there\"); }\n"
+        "struct S { a: i32, b: &str } impl S { fn m(&mut self) { } }\n"
+        "for i in 0..=x { loop { break; } continue; } x.y.z(1);\n"
+        "fn g(n: i32) -> i32 { let k = if n > 0 { n } else { 0 };\n"
+        "    match k { 0 | -1 => 1, _ => k } }\n";
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    ASSERT_FALSE(parser.hasErrors());
+    CompactAst compact = CompactAst::build(prog.get());
+
+    std::ostringstream a, b;
+    {
+        JsonWriter json(a);
+        writeAstJson(prog.get(), json);
+    }
+    {
+        JsonWriter json(b);
+        writeAstJson(compact, json);
+    }
+    EXPECT_EQ(a.str(), b.str());
+    EXPECT_NE(a.str().find("\"kind\":\"CallExpr\",\"line\":2,\"callee\":\"add\",\"args\":["),
+              std::string::npos);
+}
@@ -0,0 +1,184 @@
+#include "json_writer.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+JsonWriter::JsonWriter(std::ostream& out) : out_(out), buf_(BUFFER_SIZE) {}
+
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+bool JsonWriter::flush() {
+    if (newline_ && outer_.empty()) {
+        newline_ = false;
+        put('\n');
+    }
+    if (used_) out_.write(buf_.data(), static_cast<std::streamsize>(used_));
+    used_ = 0;
+    return static_cast<bool>(out_);
+}
+
+void JsonWriter::put(const char* s, size_t n) {
+    while (n) {
+        if (used_ == buf_.size()) flush();
+        size_t chunk = std::min(n, buf_.size() - used_);
+        std::memcpy(buf_.data() + used_, s, chunk);
+        used_ += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+// ============================================================
+// Structure
+// ============================================================
+
+void JsonWriter::separate() {
+    if (afterKey_) {
+        afterKey_ = false;
+    } else if (!first_) {
+        put(',');
+    }
+    if (newline_) {
+        newline_ = false;
+        put('\n');
+    }
+    first_ = false;
+}
+
+void JsonWriter::close(char bracket) {
+    if (newline_) {
+        newline_ = false;
+        put('\n');
+    }
+    put(bracket);
+    first_ = outer_.back();
+    outer_.pop_back();
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    put('{');
+    outer_.push_back(first_);
+    first_ = true;
+}
+
+void JsonWriter::endObject() {
+    close('}');
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    put('[');
+    outer_.push_back(first_);
+    first_ = true;
+}
+
+void JsonWriter::endArray() {
+    close(']');
+}
+
+void JsonWriter::key(const char* name) {
+    separate();
+    putEscaped(name, std::strlen(name));
+    put(':');
+    afterKey_ = true;
+}
+
+// ============================================================
+// Values
+// ============================================================
+
+void JsonWriter::value(const char* s, size_t length) {
+    separate();
+    putEscaped(s, length);
+}
+
+void JsonWriter::value(const char* s) {
+    value(s, std::strlen(s));
+}
+
+void JsonWriter::value(int64_t n) {
+    separate();
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), n);
+    put(text, static_cast<size_t>(result.ptr - text));
+}
+
+void JsonWriter::value(bool b) {
+    separate();
+    if (b) put("true", 4);
+    else put("false", 5);
+}
+
+void JsonWriter::null() {
+    separate();
+    put("null", 4);
+}
+
+// Length of the valid UTF-8 sequence starting at s[0] (a byte >= 0x80), or 0.
+static size_t utf8Length(const unsigned char* s, size_t n) {
+    size_t len;
+    uint32_t min;
+    if ((s[0] & 0xE0) == 0xC0) { len = 2; min = 0x80; }
+    else if ((s[0] & 0xF0) == 0xE0) { len = 3; min = 0x800; }
+    else if ((s[0] & 0xF8) == 0xF0) { len = 4; min = 0x10000; }
+    else return 0;
+    if (n < len) return 0;
+    uint32_t cp = s[0] & (0x7F >> len);
+    for (size_t i = 1; i < len; ++i) {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    // Overlong forms, surrogates and values past U+10FFFF are not valid.
+    if (cp < min || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) return 0;
+    return len;
+}
+
+void JsonWriter::putEscaped(const char* s, size_t n) {
+    static const char* HEX = "0123456789abcdef";
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    put('"');
+    size_t i = 0;
+    while (i < n) {
+        // Fast path: a run of printable ASCII that needs no escaping.
+        size_t run = i;
+        while (run < n && p[run] >= 0x20 && p[run] < 0x80 && p[run] != '"' && p[run] != '\\') {
+            ++run;
+        }
+        if (run > i) {
+            put(s + i, run - i);
+            i = run;
+            continue;
+        }
+        unsigned char c = p[i];
+        if (c >= 0x80) {
+            size_t len = utf8Length(p + i, n - i);
+            if (len) {
+                put(s + i, len);
+                i += len;
+            } else {
+                put("\\ufffd", 6);
+                ++i;
+            }
+            continue;
+        }
+        switch (c) {
+            case '"':  put("\\\"", 2); break;
+            case '\\': put("\\\\", 2); break;
+            case '\n': put("\\n", 2); break;
+            case '\t': put("\\t", 2); break;
+            case '\r': put("\\r", 2); break;
+            case '\b': put("\\b", 2); break;
+            case '\f': put("\\f", 2); break;
+            default: {
+                char esc[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 15]};
+                put(esc, 6);
+                break;
+            }
+        }
+        ++i;
+    }
+    put('"');
+}
@@ -0,0 +1,73 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================
+// JsonWriter — streaming JSON output through a fixed buffer
+// ============================================================
+//
+// Values are written as they are produced; nothing is kept but the output
+// buffer (BUFFER_SIZE bytes, written to `out` whenever it fills) and one
+// flag per open object or array, so output of any size takes the same
+// memory. The caller is responsible for the shape: key() only inside
+// objects, one value after each key, balanced begin/end calls.
+//
+// Strings are escaped as they are copied. Runs of printable ASCII are
+// copied in bulk; valid UTF-8 passes through; bytes that are not valid
+// UTF-8 become U+FFFD, so the output is always valid JSON.
+class JsonWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    explicit JsonWriter(std::ostream& out);
+    ~JsonWriter();  // flush()es
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(const char* name);
+    void value(const std::string& s) { value(s.data(), s.size()); }
+    void value(const char* s, size_t length);
+    void value(const char* s);  // NUL-terminated; without it a literal would pick value(bool)
+    void value(int64_t n);
+    void value(bool b);
+    void null();
+
+    // A line break before the next element, after its comma (or before the
+    // closing bracket), to keep huge arrays line-oriented.
+    void newline() { newline_ = true; }
+
+    // Writes out the buffer, and a pending newline at the top level. False
+    // if the stream has failed.
+    bool flush();
+
+private:
+    std::ostream& out_;
+    std::vector<char> buf_;
+    size_t used_ = 0;
+    bool first_ = true;         // nothing written yet in the current container
+    bool afterKey_ = false;     // a key was written, its value is next
+    bool newline_ = false;      // newline() was called, nothing written since
+    std::vector<bool> outer_;   // first_ of each enclosing container
+
+    void separate();  // ',' before every element but the first
+    void close(char bracket);
+    void put(char c) {
+        if (used_ == buf_.size()) flush();
+        buf_[used_++] = c;
+    }
+    void put(const char* s, size_t n);
+    void putEscaped(const char* s, size_t n);
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+# Writes xid_tables.inc: the XID_Start / XID_Continue classes of every code
+# point from U+0080 up, from the Unicode database bundled with Python
+# (str.isidentifier() is defined by those two properties).
+#
+#     python3 src/lexer/gen_xid_tables.py > src/lexer/xid_tables.inc
+#
+# The table is run-length: entry = (first code point << 2) | class, where the
+# class holds from that code point up to the next entry. Class bits:
+# 1 = XID_Continue, 2 = XID_Start (every XID_Start is also XID_Continue).
+import sys
+import unicodedata
+
+
+def char_class(cp):
+    c = chr(cp)
+    if c.isidentifier():
+        return 3
+    if ("a" + c).isidentifier():
+        return 1
+    return 0
+
+
+def main():
+    entries = []
+    current = None
+    for cp in range(0x80, 0x110000):
+        if 0xD800 <= cp <= 0xDFFF:
+            cls = 0
+        else:
+            cls = char_class(cp)
+        if cls != current:
+            entries.append((cp << 2) | cls)
+            current = cls
+    out = sys.stdout
+    out.write("// Generated by gen_xid_tables.py from Unicode %s; do not edit.\n"
+              % unicodedata.unidata_version)
+    out.write("// (first code point << 2) | class, sorted; class bits: 1 XID_Continue,"
+              " 2 XID_Start.\n")
+    for i in range(0, len(entries), 6):
+        row = ", ".join("0x%08X" % e for e in entries[i:i + 6])
+        out.write("    %s,\n" % row)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,18 +1,212 @@
 #include "lexer.h"
+#include "unicode.h"
+#include <utility>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-Lexer::Lexer(const std::string& source)
-    : source(source), pos(0), line(1) {}
+// ============================================================
+// Word-at-a-time scans
+// ============================================================
+//
+// The common literals — a run of decimal digits, a string without escapes —
+// are scanned eight bytes per step with plain 64-bit arithmetic (SWAR). A
+// word that fails the test is finished a byte at a time, so byte order does
+// not matter.
+static constexpr uint64_t ONES = 0x0101010101010101ULL;
+static constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+
+static inline uint64_t loadWord(const char* p) {
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+// True if every byte of `w` is '0'..'9': the high nibble is 3 and adding 6
+// does not carry out of the low one.
+static inline bool allDigits(uint64_t w) {
+    const uint64_t nibbles = 0xF0F0F0F0F0F0F0F0ULL;
+    const uint64_t threes = 0x3030303030303030ULL;
+    return (w & nibbles) == threes && ((w + 0x0606060606060606ULL) & nibbles) == threes;
+}
+
+// True if some byte of `w` is `c`.
+static inline bool hasByte(uint64_t w, unsigned char c) {
+    uint64_t x = w ^ (ONES * c);
+    return ((x - ONES) & ~x & HIGHS) != 0;
+}
+
+// Bytes of [p, p + n) before the first '"', '\\', '\n' or non-ASCII byte:
+// the part of a string literal that needs no attention. SSE2 tests sixteen
+// bytes per step; without it, SWAR tests eight.
+static inline size_t plainStringRun(const char* p, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(b, quote),
+                                                 _mm_cmpeq_epi8(b, backslash)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(b, newline), b));
+        int mask = _mm_movemask_epi8(stop);  // the sign bit: a match, or a byte >= 0x80
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w = loadWord(p + i);
+        if ((w & HIGHS) || hasByte(w, '"') || hasByte(w, '\\') || hasByte(w, '\n')) break;
+    }
+    while (i < n && p[i] != '"' && p[i] != '\\' && p[i] != '\n' &&
+           static_cast<unsigned char>(p[i]) < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// ============================================================
+// Dispatch tables
+// ============================================================
+//
+// scanToken() picks a reader with one lookup on the token's first byte
+// instead of a chain of character tests. Operators and punctuation are
+// matched by maximal munch against OPERATORS, grouped by first byte with the
+// longest spelling first, so the first spelling that matches is the
+// longest. The set is prefix-closed — `..=` implies `..` and `.` — so the
+// last spelling of each group is its single character and always matches.
+struct Operator {
+    char text[4];
+    uint8_t length;
+    TokenType type;
+};
+
+static constexpr Operator OPERATORS[] = {
+    {"!=", 2, TokenType::NEQ},         {"!", 1, TokenType::BANG},
+    {"#", 1, TokenType::POUND},
+    {"$", 1, TokenType::DOLLAR},
+    {"%=", 2, TokenType::PERCENT_ASSIGN}, {"%", 1, TokenType::PERCENT},
+    {"&&", 2, TokenType::AND},         {"&=", 2, TokenType::AMP_ASSIGN},
+    {"&", 1, TokenType::AMP},
+    {"(", 1, TokenType::LPAREN},
+    {")", 1, TokenType::RPAREN},
+    {"*=", 2, TokenType::STAR_ASSIGN}, {"*", 1, TokenType::STAR},
+    {"+=", 2, TokenType::PLUS_ASSIGN}, {"+", 1, TokenType::PLUS},
+    {",", 1, TokenType::COMMA},
+    {"->", 2, TokenType::ARROW},       {"-=", 2, TokenType::MINUS_ASSIGN},
+    {"-", 1, TokenType::MINUS},
+    {"...", 3, TokenType::ELLIPSIS},   {"..=", 3, TokenType::DOT_DOT_EQ},
+    {"..", 2, TokenType::DOT_DOT},     {".", 1, TokenType::DOT},
+    {"/=", 2, TokenType::SLASH_ASSIGN}, {"/", 1, TokenType::SLASH},
+    {"::", 2, TokenType::COLON_COLON}, {":", 1, TokenType::COLON},
+    {";", 1, TokenType::SEMICOLON},
+    {"<<=", 3, TokenType::SHL_ASSIGN}, {"<=", 2, TokenType::LTE},
+    {"<<", 2, TokenType::SHL},         {"<", 1, TokenType::LT},
+    {"==", 2, TokenType::EQ},          {"=>", 2, TokenType::FAT_ARROW},
+    {"=", 1, TokenType::ASSIGN},
+    {">>=", 3, TokenType::SHR_ASSIGN}, {">=", 2, TokenType::GTE},
+    {">>", 2, TokenType::SHR},         {">", 1, TokenType::GT},
+    {"?", 1, TokenType::QUESTION},
+    {"@", 1, TokenType::AT},
+    {"[", 1, TokenType::LBRACKET},
+    {"]", 1, TokenType::RBRACKET},
+    {"^=", 2, TokenType::CARET_ASSIGN}, {"^", 1, TokenType::CARET},
+    {"{", 1, TokenType::LBRACE},
+    {"|=", 2, TokenType::PIPE_ASSIGN}, {"||", 2, TokenType::OR},
+    {"|", 1, TokenType::PIPE},
+    {"}", 1, TokenType::RBRACE},
+    {"~", 1, TokenType::TILDE},
+};
+
+enum ByteClass : uint8_t {
+    BYTE_ILLEGAL,     // not the start of any token
+    BYTE_IDENT,       // [A-Za-z_]; `r` may also start a raw string
+    BYTE_DIGIT,       // [0-9]
+    BYTE_QUOTE,       // "
+    BYTE_APOSTROPHE,  // '
+    BYTE_OPERATOR,    // first byte of an OPERATORS group
+    BYTE_UTF8,        // >= 0x80: part of a multi-byte character, see unicode.h
+};
+
+// For each byte: its class and, for BYTE_OPERATOR, the index of its first
+// spelling in OPERATORS and how many there are.
+struct DispatchTable {
+    uint8_t kind[256];
+    uint8_t first[256];
+    uint8_t count[256];
+
+    constexpr DispatchTable() : kind(), first(), count() {
+        for (int c = 'a'; c <= 'z'; ++c) kind[c] = BYTE_IDENT;
+        for (int c = 'A'; c <= 'Z'; ++c) kind[c] = BYTE_IDENT;
+        kind[static_cast<unsigned char>('_')] = BYTE_IDENT;
+        for (int c = '0'; c <= '9'; ++c) kind[c] = BYTE_DIGIT;
+        kind[static_cast<unsigned char>('"')] = BYTE_QUOTE;
+        kind[static_cast<unsigned char>('\'')] = BYTE_APOSTROPHE;
+        for (int c = 0x80; c <= 0xFF; ++c) kind[c] = BYTE_UTF8;
+        for (size_t i = 0; i < sizeof(OPERATORS) / sizeof(OPERATORS[0]); ++i) {
+            unsigned char c = static_cast<unsigned char>(OPERATORS[i].text[0]);
+            if (count[c] == 0) first[c] = static_cast<uint8_t>(i);
+            kind[c] = BYTE_OPERATOR;
+            count[c]++;
+        }
+    }
+};
+
+static constexpr DispatchTable DISPATCH;
+
+static inline uint8_t byteClass(char c) { return DISPATCH.kind[static_cast<unsigned char>(c)]; }
+
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+static inline bool isIdentStart(char c) { return byteClass(c) == BYTE_IDENT; }
+
+static inline bool isIdentChar(char c) {
+    uint8_t k = byteClass(c);
+    return k == BYTE_IDENT || k == BYTE_DIGIT;
+}
+
+Lexer::Lexer(const std::string& source, int line)
+    : source(source), chars(this->source.data()), textSize(this->source.size()), pos(0),
+      line(line), firstLine(line), triviaFlags(0) {}
+
+Lexer::Lexer(std::string&& source, int line)
+    : source(std::move(source)), chars(this->source.data()), textSize(this->source.size()),
+      pos(0), line(line), firstLine(line), triviaFlags(0) {}
+
+const std::string& Lexer::text() const {
+    if (gapSize > 0) {
+        source.erase(gapBegin, gapSize);
+        gapSize = 0;
+        chars = source.data();
+    }
+    return source;
+}
+
+// Moves the gap to byte `to` of the text; costs the bytes in between.
+void Lexer::moveGap(size_t to) const {
+    char* data = &source[0];
+    if (to < gapBegin) {
+        std::memmove(data + to + gapSize, data + to, gapBegin - to);
+    } else if (to > gapBegin) {
+        std::memmove(data + gapBegin, data + gapBegin + gapSize, to - gapBegin);
+    }
+    gapBegin = to;
+}
 
 char Lexer::peekChar() const {
-    if (pos < source.length()) {
-        return source[pos];
+    if (pos < textSize) {
+        return chars[pos];
     }
     return '\0';
 }
 
 char Lexer::advance() {
-    if (pos < source.length()) {
-        char c = source[pos];
+    if (pos < textSize) {
+        char c = chars[pos];
         pos++;
         return c;
     }
@@ -20,38 +214,40 @@ char Lexer::advance() {
 }
 
 void Lexer::skipWhitespace() {
-    while (pos < source.length()) {
-        char c = peekChar();
-        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
-            if (c == '\n') {
-                line++;
-            }
-            advance();
-        } else {
+    const size_t n = textSize;
+    while (pos < n) {
+        char c = chars[pos];
+        if (c == '\n') {
+            line++;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
             break;
         }
+        pos++;
     }
 }
 
+// Comments may hold any UTF-8; invalid bytes in one set TOKEN_BAD_UTF8 on
+// the token after it.
 void Lexer::skipComments() {
-    if (pos + 1 < source.length() && source[pos] == '/') {
-        if (source[pos + 1] == '/') {
+    if (pos + 1 < textSize && chars[pos] == '/') {
+        size_t start = pos;
+        if (chars[pos + 1] == '/') {
             // Single-line comment
-            while (pos < source.length() && peekChar() != '\n') {
-                advance();
-            }
-        } else if (source[pos + 1] == '*') {
+            const char* newline = static_cast<const char*>(
+                std::memchr(chars + pos, '\n', textSize - pos));
+            pos = newline ? static_cast<size_t>(newline - chars) : textSize;
+        } else if (chars[pos + 1] == '*') {
             // Multi-line comment
             advance(); // skip /
             advance(); // skip *
-            while (pos + 1 <= source.length()) {
+            while (pos + 1 <= textSize) {
                 if (peekChar() == '\0') {
                     break;
                 }
                 if (peekChar() == '\n') {
                     line++;
                 }
-                if (peekChar() == '*' && pos + 1 < source.length() && source[pos + 1] == '/') {
+                if (peekChar() == '*' && pos + 1 < textSize && chars[pos + 1] == '/') {
                     advance(); // skip *
                     advance(); // skip /
                     break;
@@ -59,115 +255,307 @@ void Lexer::skipComments() {
                 advance();
             }
         }
+        size_t length;
+        std::string_view text(chars + start, pos - start);
+        if (findInvalidUtf8(text, length) != text.size()) triviaFlags |= TOKEN_BAD_UTF8;
     }
 }
 
+// Bytes that are not UTF-8 at all are dropped like trivia, so they do not
+// disturb the token stream; the next token carries TOKEN_BAD_UTF8 and the
+// parser reports them.
+void Lexer::skipInvalidUtf8() {
+    if (pos >= textSize || static_cast<unsigned char>(chars[pos]) < 0x80) return;
+    uint32_t cp;
+    if (decodeUtf8(chars + pos, textSize - pos, cp) == 0) {
+        pos += invalidUtf8Length(chars + pos, textSize - pos);
+        triviaFlags |= TOKEN_BAD_UTF8;
+    }
+}
+
+// ASCII identifier characters are a table lookup each; at a byte >= 0x80
+// the character is decoded and must be XID_Continue.
 Token Lexer::readIdentifier() {
     size_t start = pos;
-    while (pos < source.length() && (std::isalnum(peekChar()) || peekChar() == '_')) {
-        advance();
+    const size_t n = textSize;
+    while (pos < n) {
+        if (isIdentChar(chars[pos])) {
+            pos++;
+            continue;
+        }
+        uint32_t cp;
+        size_t length = byteClass(chars[pos]) == BYTE_UTF8
+                            ? decodeUtf8(chars + pos, n - pos, cp) : 0;
+        if (length == 0 || !isXidContinue(cp)) break;
+        pos += length;
     }
-    std::string lexeme = source.substr(start, pos - start);
+    std::string lexeme(chars + start, pos - start);
     TokenType type = lookupKeyword(lexeme);
     return Token{type, lexeme, line};
 }
 
+// True if the '.' at `dot`, after a number's digits, is its decimal point:
+// `1.5` and `1.` are floats, but `1..2` is a range and `1.max(2)` a method
+// call on an integer. Looking past the '.' — at a whole UTF-8 sequence, for
+// `1.é` — is where a token reads furthest beyond its end (MAX_LOOKAHEAD).
+bool Lexer::startsFraction(size_t dot) const {
+    if (dot + 1 >= textSize) return true;
+    char next = chars[dot + 1];
+    uint32_t cp;
+    if (byteClass(next) == BYTE_UTF8 &&
+        decodeUtf8(chars + dot + 1, textSize - dot - 1, cp) != 0) {
+        return !isXidStart(cp);
+    }
+    return next != '.' && !isIdentStart(next);
+}
+
+// Plain decimal digits take the fast path and come back with no flags; a
+// `_`, fraction, base prefix, exponent or suffix moves to readNumberTail().
 Token Lexer::readNumber() {
     size_t start = pos;
-    while (pos < source.length() && std::isdigit(peekChar())) {
-        advance();
+    const size_t n = textSize;
+    while (pos + 8 <= n && allDigits(loadWord(chars + pos))) pos += 8;
+    while (pos < n && isDigit(chars[pos])) pos++;
+    char c = peekChar();
+    if (c == '_' || isIdentStart(c) || (c == '.' && startsFraction(pos))) {
+        return readNumberTail(start);
     }
-    std::string lexeme = source.substr(start, pos - start);
-    return Token{TokenType::NUMBER, lexeme, line};
+    return Token{TokenType::NUMBER, std::string(chars + start, pos - start), line};
 }
 
+// The rest of a number after its leading digits. Every other character
+// looked at is taken into the token (`1e` is a float missing its exponent);
+// only the character after a '.' may be left, see startsFraction().
+// Validation is left to decodeInteger() / decodeFloat().
+Token Lexer::readNumberTail(size_t start) {
+    const size_t n = textSize;
+    TokenType type = TokenType::NUMBER;
+    char c = peekChar();
+    bool prefixed = pos == start + 1 && chars[start] == '0' && (c == 'x' || c == 'o' || c == 'b');
+    if (prefixed) {
+        pos++;
+        bool hex = c == 'x';
+        while (pos < n && (chars[pos] == '_' || isDigit(chars[pos]) ||
+                           (hex && std::isxdigit(static_cast<unsigned char>(chars[pos]))))) {
+            pos++;
+        }
+    } else {
+        while (pos < n && (chars[pos] == '_' || isDigit(chars[pos]))) pos++;
+        if (peekChar() == '.' && startsFraction(pos)) {
+            type = TokenType::FLOAT;
+            pos++;
+            while (pos < n && (chars[pos] == '_' || isDigit(chars[pos]))) pos++;
+        }
+        if (peekChar() == 'e' || peekChar() == 'E') {
+            type = TokenType::FLOAT;
+            pos++;
+            if (peekChar() == '+' || peekChar() == '-') pos++;
+            while (pos < n && (chars[pos] == '_' || isDigit(chars[pos]))) pos++;
+        }
+    }
+    if (isIdentStart(peekChar())) {
+        // Suffix: `u64`, `f32`, ... A float suffix on a decimal integer makes it a float.
+        if (type == TokenType::NUMBER && !prefixed && chars[pos] == 'f') {
+            type = TokenType::FLOAT;
+        }
+        while (pos < n && isIdentChar(chars[pos])) pos++;
+    }
+    return Token{type, std::string(chars + start, pos - start), line, TOKEN_COMPLEX};
+}
+
+// Contents without the quotes. Escapes are only skipped over (so `\"` does
+// not end the string) and flagged with TOKEN_ESCAPES; decodeString() turns
+// them into characters when the value is needed. Multi-byte characters are
+// checked as they are passed; invalid ones stay in the lexeme and set
+// TOKEN_BAD_UTF8.
 Token Lexer::readString() {
     advance(); // skip opening "
     size_t start = pos;
-    while (pos < source.length() && peekChar() != '"') {
-        if (peekChar() == '\n') {
+    const size_t n = textSize;
+    uint8_t flags = 0;
+    while (pos < n) {
+        pos += plainStringRun(chars + pos, n - pos);
+        if (pos >= n) break;
+        char c = chars[pos];
+        if (byteClass(c) == BYTE_UTF8) {
+            uint32_t cp;
+            size_t length = decodeUtf8(chars + pos, n - pos, cp);
+            if (length == 0) {
+                flags |= TOKEN_BAD_UTF8;
+                length = invalidUtf8Length(chars + pos, n - pos);
+            }
+            pos += length;
+            continue;
+        }
+        if (c == '"') {
+            std::string lexeme(chars + start, pos - start);
+            pos++; // skip closing "
+            return Token{TokenType::STRING, lexeme, line, flags};
+        }
+        if (c == '\n') {
             line++;
+        } else if (c == '\\' && pos + 1 < n) {
+            flags |= TOKEN_ESCAPES;
+            pos++;
+            if (chars[pos] == '\n') line++;
+            if (byteClass(chars[pos]) == BYTE_UTF8) continue;  // checked as a character
         }
+        pos++;
+    }
+    // Unterminated string
+    return Token{TokenType::ILLEGAL, std::string(chars + start, pos - start), line};
+}
+
+// r"..." or r#"..."# with up to 255 '#'s: the contents are the value as they
+// are, backslashes included. An `r` followed by '#'s but no quote is
+// ILLEGAL, '#'s and all.
+Token Lexer::readRawString() {
+    size_t start = pos;
+    const size_t n = textSize;
+    advance(); // skip r
+    size_t hashes = 0;
+    while (peekChar() == '#') {
         advance();
+        hashes++;
     }
-    if (pos >= source.length()) {
-        // Unterminated string
-        return Token{TokenType::ILLEGAL, source.substr(start, pos - start), line};
+    if (peekChar() != '"' || hashes > 255) {
+        return Token{TokenType::ILLEGAL, std::string(chars + start, pos - start), line};
+    }
+    advance(); // skip opening "
+    size_t body = pos;
+    while (pos < n) {
+        const char* quote = static_cast<const char*>(
+            std::memchr(chars + pos, '"', n - pos));
+        size_t end = quote ? static_cast<size_t>(quote - chars) : n;
+        line += static_cast<int>(std::count(chars + pos, chars + end, '\n'));
+        pos = end;
+        if (pos >= n) break;
+        size_t closing = 1;
+        while (closing <= hashes && pos + closing < n && chars[pos + closing] == '#') closing++;
+        if (closing == hashes + 1) {
+            std::string lexeme(chars + body, pos - body);
+            pos += closing;
+            uint8_t flags = TOKEN_RAW;
+            size_t length;
+            if (findInvalidUtf8(lexeme, length) != lexeme.size()) flags |= TOKEN_BAD_UTF8;
+            return Token{TokenType::STRING, lexeme, line, flags};
+        }
+        pos++;
     }
-    std::string lexeme = source.substr(start, pos - start);
-    advance(); // skip closing "
-    return Token{TokenType::STRING, lexeme, line};
+    return Token{TokenType::ILLEGAL, std::string(chars + body, pos - body), line};
+}
+
+// 'c', '\n', '\x41', '\u{1F600}'. Each step takes what it looks at, as in
+// readNumberTail(); a literal without its closing quote on the same line is
+// ILLEGAL and covers what was read. The contents are checked by
+// decodeChar().
+Token Lexer::readChar() {
+    size_t start = pos;
+    const size_t n = textSize;
+    advance(); // skip opening '
+    uint8_t flags = 0;
+    char c = peekChar();
+    if (c == '\\' && pos + 1 < n && chars[pos + 1] != '\n') {
+        flags |= TOKEN_ESCAPES;
+        pos += 2;
+        if (chars[pos - 1] == 'u' && peekChar() == '{') {
+            pos++;
+            while (pos < n && (chars[pos] == '_' ||
+                               std::isxdigit(static_cast<unsigned char>(chars[pos])))) {
+                pos++;
+            }
+            if (peekChar() == '}') pos++;
+        } else if (chars[pos - 1] == 'x') {
+            for (int k = 0; k < 2 && std::isxdigit(static_cast<unsigned char>(peekChar())); ++k) {
+                pos++;
+            }
+        }
+    } else if (pos < n && c != '\'' && c != '\n' && c != '\\') {
+        // One character: a UTF-8 lead byte and its continuation bytes.
+        pos++;
+        for (int k = 0; k < 3 && pos < n &&
+                        (static_cast<unsigned char>(chars[pos]) & 0xC0) == 0x80; ++k) {
+            pos++;
+        }
+    }
+    if (peekChar() != '\'') {
+        return Token{TokenType::ILLEGAL, std::string(chars + start, pos - start), line};
+    }
+    std::string lexeme(chars + start + 1, pos - start - 1);
+    pos++; // skip closing '
+    return Token{TokenType::CHAR, lexeme, line, flags};
 }
 
 Token Lexer::nextToken() {
-    // Skip whitespace and comments in a loop
+    // Skip whitespace, comments and invalid UTF-8 in a loop
+    triviaFlags = 0;
     while (true) {
         skipWhitespace();
         size_t before = pos;
         skipComments();
+        skipInvalidUtf8();
         if (pos == before) {
             break;
         }
     }
 
-    if (pos >= source.length()) {
-        return Token{TokenType::EOF_TOKEN, "", line};
-    }
-
-    char c = peekChar();
+    size_t start = pos;
+    Token tok = scanToken();
+    tok.offset = start;
+    tok.length = pos - start;
+    tok.flags |= triviaFlags;
+    return tok;
+}
 
-    if (std::isalpha(c) || c == '_') {
-        return readIdentifier();
-    }
-    if (std::isdigit(c)) {
-        return readNumber();
-    }
-    if (c == '"') {
-        return readString();
+Token Lexer::scanToken() {
+    if (pos >= textSize) {
+        return Token{TokenType::EOF_TOKEN, "", line};
     }
 
-    advance();
-    switch (c) {
-        case '+': return Token{TokenType::PLUS, "+", line};
-        case '-': return Token{TokenType::MINUS, "-", line};
-        case '*': return Token{TokenType::STAR, "*", line};
-        case '/': return Token{TokenType::SLASH, "/", line};
-        case '=':
-            if (peekChar() == '=') {
-                advance();
-                return Token{TokenType::EQ, "==", line};
-            }
-            return Token{TokenType::ASSIGN, "=", line};
-        case '!':
-            if (peekChar() == '=') {
-                advance();
-                return Token{TokenType::NEQ, "!=", line};
-            }
-            return Token{TokenType::ILLEGAL, "!", line};
-        case '<':
-            if (peekChar() == '=') {
-                advance();
-                return Token{TokenType::LTE, "<=", line};
-            }
-            return Token{TokenType::LT, "<", line};
-        case '>':
-            if (peekChar() == '=') {
-                advance();
-                return Token{TokenType::GTE, ">=", line};
+    char c = chars[pos];
+    switch (byteClass(c)) {
+        case BYTE_IDENT:
+            if (c == 'r' && pos + 1 < textSize &&
+                (chars[pos + 1] == '"' || chars[pos + 1] == '#')) {
+                return readRawString();
             }
-            return Token{TokenType::GT, ">", line};
-        case '(': return Token{TokenType::LPAREN, "(", line};
-        case ')': return Token{TokenType::RPAREN, ")", line};
-        case '{': return Token{TokenType::LBRACE, "{", line};
-        case '}': return Token{TokenType::RBRACE, "}", line};
-        case ';': return Token{TokenType::SEMICOLON, ";", line};
-        case ':': return Token{TokenType::COLON, ":", line};
-        case ',': return Token{TokenType::COMMA, ",", line};
+            return readIdentifier();
+        case BYTE_DIGIT:      return readNumber();
+        case BYTE_QUOTE:      return readString();
+        case BYTE_APOSTROPHE: return readChar();
+        case BYTE_OPERATOR:   return readOperator();
+        case BYTE_UTF8: {
+            // A valid character: skipInvalidUtf8() has run.
+            uint32_t cp;
+            size_t length = decodeUtf8(chars + pos, textSize - pos, cp);
+            if (isXidStart(cp)) return readIdentifier();
+            pos += length;
+            return Token{TokenType::ILLEGAL, std::string(chars + pos - length, length), line};
+        }
         default:
+            advance();
             return Token{TokenType::ILLEGAL, std::string(1, c), line};
     }
 }
 
+// Maximal munch over the first byte's OPERATORS group. Only the longer
+// spellings are tried; the last one is the single character.
+Token Lexer::readOperator() {
+    unsigned char c = static_cast<unsigned char>(chars[pos]);
+    const Operator* op = OPERATORS + DISPATCH.first[c];
+    const Operator* last = op + DISPATCH.count[c] - 1;
+    const char* p = chars + pos;
+    size_t left = textSize - pos;
+    for (; op != last; ++op) {
+        if (op->length <= left && p[1] == op->text[1] &&
+            (op->length == 2 || p[2] == op->text[2])) {
+            break;
+        }
+    }
+    pos += op->length;
+    return Token{op->type, std::string(op->text, op->length), line};
+}
+
 std::vector<Token> Lexer::tokenize() {
     std::vector<Token> tokens;
     while (true) {
@@ -179,3 +567,149 @@ std::vector<Token> Lexer::tokenize() {
     }
     return tokens;
 }
+
+TokenBuffer::TokenBuffer(std::vector<Token> tokens)
+    : tokens_(std::move(tokens)), gapBegin_(tokens_.size()), gapEnd_(tokens_.size()) {}
+
+size_t TokenBuffer::offsetOf(size_t i) const {
+    return raw(i).offset + (i < gapBegin_ ? 0 : static_cast<size_t>(offsetShift_));
+}
+
+Token TokenBuffer::operator[](size_t i) const {
+    Token tok = raw(i);
+    tok.offset = offsetOf(i);
+    tok.line = lineOf(i);
+    return tok;
+}
+
+std::vector<Token> TokenBuffer::toVector() const {
+    std::vector<Token> out;
+    out.reserve(size());
+    for (size_t i = 0; i < size(); ++i) out.push_back((*this)[i]);
+    return out;
+}
+
+// Moves the gap to before token `i`. Tokens that cross it take on or give
+// up the pending shift; offsets past the gap may wrap, which the unsigned
+// arithmetic undoes when they come back.
+void TokenBuffer::moveGap(size_t i) {
+    if (gapBegin_ == gapEnd_ && offsetShift_ == 0 && lineShift_ == 0) {
+        gapBegin_ = gapEnd_ = i;  // nothing pending: both sides read the same
+        return;
+    }
+    size_t shift = static_cast<size_t>(offsetShift_);
+    while (gapBegin_ > i) {
+        Token& tok = tokens_[--gapBegin_];
+        tok.offset -= shift;
+        tok.line -= lineShift_;
+        if (--gapEnd_ != gapBegin_) tokens_[gapEnd_] = std::move(tok);
+    }
+    while (gapBegin_ < i) {
+        Token& tok = tokens_[gapEnd_];
+        tok.offset += shift;
+        tok.line += lineShift_;
+        if (gapEnd_++ != gapBegin_) tokens_[gapBegin_] = std::move(tok);
+        gapBegin_++;
+    }
+}
+
+// Replaces tokens [first, last) with `with`; every later token moves by
+// `offsetDelta` bytes and `lineDelta` lines, recorded in the pending shift.
+void TokenBuffer::replace(size_t first, size_t last, std::vector<Token>&& with,
+                          long long offsetDelta, int lineDelta) {
+    moveGap(last);
+    gapBegin_ = first;
+    offsetShift_ += offsetDelta;
+    lineShift_ += lineDelta;
+    if (gapEnd_ - gapBegin_ < with.size()) {
+        // Grow by a share of the size, so growing is amortized over the edits.
+        size_t grow = with.size() - (gapEnd_ - gapBegin_) + size() / 8 + 16;
+        tokens_.insert(tokens_.begin() + static_cast<std::ptrdiff_t>(gapEnd_), grow, Token{});
+        gapEnd_ += grow;
+    }
+    for (Token& tok : with) tokens_[gapBegin_++] = std::move(tok);
+}
+
+size_t Lexer::applyEdit(const TextEdit& edit, TokenBuffer& tokens) {
+    size_t end = std::min(edit.end, textSize);
+    size_t begin = std::min(edit.begin, end);
+
+    // Keep the tokens that cannot see the edit and relex from the end of the
+    // last of them. A token reads at most MAX_LOOKAHEAD bytes past its end,
+    // so those ending at least that far before the edit stay; starting at a
+    // token end rather than a token start
+    // also rescans the trivia in front of the first relexed token, whose
+    // TOKEN_BAD_UTF8 depends on it.
+    size_t restart = 0;
+    for (size_t hi = tokens.size(); restart < hi;) {
+        size_t mid = restart + (hi - restart) / 2;
+        if (tokens.endOf(mid) + MAX_LOOKAHEAD <= begin) {
+            restart = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t restartPos = 0;
+    int restartLine = firstLine;
+    if (restart > 0) {
+        // A token's line is taken after it is read, so it is the line at its end.
+        restartPos = tokens.endOf(restart - 1);
+        restartLine = tokens.lineOf(restart - 1);
+    }
+
+    // Edit the text at the gap, then move the gap back to the restart point,
+    // past which the text is contiguous for the relexing.
+    moveGap(begin);
+    int removedLines = static_cast<int>(std::count(chars + begin, chars + end, '\n'));
+    int lineDelta = static_cast<int>(
+        std::count(edit.replacement.begin(), edit.replacement.end(), '\n')) - removedLines;
+    long long delta = static_cast<long long>(edit.replacement.size()) -
+                      static_cast<long long>(end - begin);
+    size_t editedEnd = begin + edit.replacement.size();
+
+    gapSize += end - begin;
+    if (gapSize < edit.replacement.size()) {
+        // Grow by a share of the size, so growing is amortized over the edits.
+        size_t grow = edit.replacement.size() - gapSize + textSize / 8 + 64;
+        source.insert(gapBegin, grow, '\0');
+        gapSize += grow;
+    }
+    std::memcpy(&source[gapBegin], edit.replacement.data(), edit.replacement.size());
+    gapBegin += edit.replacement.size();
+    gapSize -= edit.replacement.size();
+    textSize = editedEnd + (textSize - end);
+    chars = source.data() + gapSize;
+    moveGap(restartPos);
+    pos = restartPos;
+    line = restartLine;
+
+    // Relex until a token past the edited text ends where an old token did
+    // (offset-shifted). The next token is lexed from a token end, over
+    // identical text, in both streams, so the old tail is kept.
+    std::vector<Token> fresh;
+    size_t sync = restart;
+    while (true) {
+        Token tok = nextToken();
+        fresh.push_back(tok);
+        if (tok.type == TokenType::EOF_TOKEN) {
+            sync = tokens.size();
+            break;
+        }
+        size_t tokEnd = tok.offset + tok.length;
+        if (tokEnd >= editedEnd) {
+            size_t oldEnd = static_cast<size_t>(static_cast<long long>(tokEnd) - delta);
+            while (sync < tokens.size() && tokens.endOf(sync) < oldEnd) {
+                sync++;
+            }
+            if (sync < tokens.size() && tokens.raw(sync).type != TokenType::EOF_TOKEN &&
+                tokens.endOf(sync) == oldEnd) {
+                sync++;  // the old token that ends there is replaced too
+                break;
+            }
+        }
+    }
+
+    size_t relexed = fresh.size();
+    tokens.replace(restart, sync, std::move(fresh), delta, lineDelta);
+    return relexed;
+}
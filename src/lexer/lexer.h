@@ -5,24 +5,104 @@
 #include <string>
 #include <vector>
 
+// A replacement of the source bytes [begin, end) with `replacement`.
+struct TextEdit {
+    size_t begin;
+    size_t end;
+    std::string replacement;
+};
+
+// The tokenize() output of a source that is being edited, for
+// Lexer::applyEdit(). Held in a gap buffer: an edit replaces tokens at the
+// gap, and the offset and line changes it makes are kept as a pending shift
+// for the tokens past the gap, so the tail is never rewritten. Moving the
+// gap costs the tokens it passes over — a run of edits in one place costs
+// only the tokens each one relexes.
+class TokenBuffer {
+public:
+    TokenBuffer() = default;
+    explicit TokenBuffer(std::vector<Token> tokens);
+
+    size_t size() const { return tokens_.size() - (gapEnd_ - gapBegin_); }
+    // A copy of the i-th token with its offset and line up to date.
+    Token operator[](size_t i) const;
+    std::vector<Token> toVector() const;
+
+private:
+    friend class Lexer;
+
+    std::vector<Token> tokens_;  // the gap, [gapBegin_, gapEnd_), holds moved-from tokens
+    size_t gapBegin_ = 0;
+    size_t gapEnd_ = 0;
+    long long offsetShift_ = 0;  // pending for every token past the gap
+    int lineShift_ = 0;
+
+    const Token& raw(size_t i) const {
+        return tokens_[i < gapBegin_ ? i : i + (gapEnd_ - gapBegin_)];
+    }
+    size_t offsetOf(size_t i) const;
+    size_t endOf(size_t i) const { return offsetOf(i) + raw(i).length; }
+    int lineOf(size_t i) const { return raw(i).line + (i < gapBegin_ ? 0 : lineShift_); }
+    void moveGap(size_t i);
+    void replace(size_t first, size_t last, std::vector<Token>&& with,
+                 long long offsetDelta, int lineDelta);
+};
+
 class Lexer {
 public:
-    explicit Lexer(const std::string& source);
+    // `line` is the line number of the first character, for lexing a
+    // fragment that starts partway through a file.
+    explicit Lexer(const std::string& source, int line = 1);
+    explicit Lexer(std::string&& source, int line = 1);
+
+    // How far past its end a token's lexing can read: a number's '.' and the
+    // up to four-byte UTF-8 sequence after it (see startsFraction()).
+    static constexpr size_t MAX_LOOKAHEAD = 5;
+
     Token nextToken();
+    // The source as one string; closes the gap an applyEdit() left, which
+    // costs a pass over the text.
+    const std::string& text() const;
     std::vector<Token> tokenize();
 
+    // Applies `edit` to the source and updates `tokens` — the tokenize()
+    // output for the pre-edit source — in place. Lexing restarts at the end
+    // of the last token that cannot see the edit and stops once a new token
+    // past the edit ends where an old token did (shifted); the relexed run
+    // replaces the old one and later tokens are shifted lazily. The source
+    // keeps a gap at the edit too, so neither the text nor the tokens past
+    // it are moved. Returns the number of tokens that were lexed again.
+    size_t applyEdit(const TextEdit& edit, TokenBuffer& tokens);
+
 private:
-    std::string source;
+    // The text is source[0, gapBegin) followed by source[gapBegin + gapSize,
+    // end). Lexing only reads from gapBegin on, where chars[i] is byte i of
+    // the text; applyEdit() leaves the gap where relexing starts.
+    mutable std::string source;
+    mutable size_t gapBegin = 0;
+    mutable size_t gapSize = 0;
+    mutable const char* chars;
+    size_t textSize;
     size_t pos;
     int line;
+    int firstLine;
+    uint8_t triviaFlags;  // TOKEN_BAD_UTF8 if the trivia before this token had invalid UTF-8
 
+    void moveGap(size_t to) const;
     char peekChar() const;
     char advance();
     void skipWhitespace();
     void skipComments();
+    void skipInvalidUtf8();
+    Token scanToken();
     Token readIdentifier();
     Token readNumber();
+    Token readNumberTail(size_t start);
+    bool startsFraction(size_t dot) const;
     Token readString();
+    Token readRawString();
+    Token readChar();
+    Token readOperator();
 };
 
 #endif // LEXER_H
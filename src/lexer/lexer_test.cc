@@ -1,5 +1,10 @@
 #include "lexer.h"
+#include "literal.h"
+#include "unicode.h"
 #include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <utility>
 
 // Helper: tokenize a string and return the token types (excluding EOF)
 static std::vector<TokenType> types(const std::string& src) {
@@ -41,6 +46,20 @@ TEST(Lexer, TokenizesKeywords) {
     EXPECT_EQ(t[6], TokenType::RETURN);
 }
 
+TEST(Lexer, TokenizesItemAndLoopKeywords) {
+    auto t = types("struct impl loop for in break continue match inner");
+    ASSERT_EQ(t.size(), 9u);
+    EXPECT_EQ(t[0], TokenType::STRUCT);
+    EXPECT_EQ(t[1], TokenType::IMPL);
+    EXPECT_EQ(t[2], TokenType::LOOP);
+    EXPECT_EQ(t[3], TokenType::FOR);
+    EXPECT_EQ(t[4], TokenType::IN);
+    EXPECT_EQ(t[5], TokenType::BREAK);
+    EXPECT_EQ(t[6], TokenType::CONTINUE);
+    EXPECT_EQ(t[7], TokenType::MATCH);
+    EXPECT_EQ(t[8], TokenType::IDENT);
+}
+
 // --- Identifiers ---
 
 TEST(Lexer, TokenizesIdentifiers) {
@@ -103,6 +122,280 @@ TEST(Lexer, UnterminatedStringIsIllegal) {
     EXPECT_EQ(t[0], TokenType::ILLEGAL);
 }
 
+// --- Literal forms ---
+
+// Helper: the only token of `src` (besides EOF)
+static Token single(const std::string& src) {
+    Lexer lexer(src);
+    auto tokens = lexer.tokenize();
+    EXPECT_EQ(tokens.size(), 2u) << src;
+    return tokens[0];
+}
+
+TEST(Lexer, PlainDigitsTakeTheFastPath) {
+    std::string digits = "12345678901234567890123";  // crosses the 8-byte words
+    for (size_t n = 1; n <= digits.size(); ++n) {
+        Token t = single(digits.substr(0, n));
+        EXPECT_EQ(t.type, TokenType::NUMBER);
+        EXPECT_EQ(t.lexeme, digits.substr(0, n));
+        EXPECT_EQ(t.flags, 0);
+    }
+    auto l = lexemes("1234567890+1");
+    ASSERT_EQ(l.size(), 3u);
+    EXPECT_EQ(l[0], "1234567890");
+}
+
+TEST(Lexer, NumberForms) {
+    struct Case { const char* src; TokenType type; };
+    const Case cases[] = {
+        {"0xFF", TokenType::NUMBER},   {"0o17", TokenType::NUMBER},
+        {"0b1010", TokenType::NUMBER}, {"1_000_000", TokenType::NUMBER},
+        {"42u64", TokenType::NUMBER},  {"0xffu8", TokenType::NUMBER},
+        {"3.14", TokenType::FLOAT},    {"1e9", TokenType::FLOAT},
+        {"2.5E-3f32", TokenType::FLOAT}, {"1f64", TokenType::FLOAT},
+        {"7.", TokenType::FLOAT},      {"0x", TokenType::NUMBER},
+        {"1e", TokenType::FLOAT},
+    };
+    for (const Case& c : cases) {
+        Token t = single(c.src);
+        EXPECT_EQ(t.type, c.type) << c.src;
+        EXPECT_EQ(t.lexeme, c.src);
+        EXPECT_EQ(t.flags, TOKEN_COMPLEX) << c.src;
+    }
+}
+
+TEST(Lexer, StringEscapesAreFlaggedNotDecoded) {
+    Token t = single("\"say \\\"hi\\\"\\n\"");
+    EXPECT_EQ(t.type, TokenType::STRING);
+    EXPECT_EQ(t.lexeme, "say \\\"hi\\\"\\n");
+    EXPECT_EQ(t.flags, TOKEN_ESCAPES);
+
+    // Without a backslash the lexeme is the value; long runs take the word-at-a-time scan.
+    std::string body(37, 'x');
+    for (size_t quote = 0; quote < body.size(); ++quote) {
+        Token u = single("\"" + body.substr(0, quote) + "\"");
+        EXPECT_EQ(u.lexeme, body.substr(0, quote));
+        EXPECT_EQ(u.flags, 0);
+    }
+
+    Lexer lexer("\"a\nbcdefghijkl\\\nm\" x");
+    auto tokens = lexer.tokenize();
+    EXPECT_EQ(tokens[0].line, 3);
+    EXPECT_EQ(tokens[1].line, 3);
+}
+
+TEST(Lexer, RawStrings) {
+    Token t = single("r\"a\\b\"");
+    EXPECT_EQ(t.type, TokenType::STRING);
+    EXPECT_EQ(t.lexeme, "a\\b");
+    EXPECT_EQ(t.flags, TOKEN_RAW);
+
+    t = single("r##\"say \"#hi\"#\"##");
+    EXPECT_EQ(t.type, TokenType::STRING);
+    EXPECT_EQ(t.lexeme, "say \"#hi\"#");
+    EXPECT_EQ(t.length, 17u);
+
+    EXPECT_EQ(single("r#\"open\"").type, TokenType::ILLEGAL);
+    auto l = lexemes("r#x raw");
+    ASSERT_EQ(l.size(), 3u);
+    EXPECT_EQ(l[0], "r#");
+    EXPECT_EQ(l[1], "x");
+    EXPECT_EQ(l[2], "raw");
+}
+
+TEST(Lexer, CharLiterals) {
+    const char* chars[] = {"'c'", "'\\n'", "'\\''", "'\\x41'", "'\\u{1F600}'", "'\xc3\xa9'"};
+    for (const char* src : chars) {
+        Token t = single(src);
+        EXPECT_EQ(t.type, TokenType::CHAR) << src;
+        EXPECT_EQ(t.lexeme, std::string(src + 1, std::strlen(src) - 2));
+    }
+    EXPECT_EQ(single("'\\n'").flags, TOKEN_ESCAPES);
+
+    auto t = types("'ab'");
+    ASSERT_EQ(t.size(), 3u);
+    EXPECT_EQ(t[0], TokenType::ILLEGAL);  // 'a
+    EXPECT_EQ(t[1], TokenType::IDENT);
+    EXPECT_EQ(t[2], TokenType::ILLEGAL);  // '
+}
+
+// --- Literal decoding ---
+
+TEST(Literal, DecodeInteger) {
+    struct Case { const char* text; uint64_t value; };
+    const Case ok[] = {
+        {"0", 0}, {"42", 42}, {"0xFF", 255}, {"0o17", 15}, {"0b1010", 10}, {"1_000_000", 1000000},
+        {"42u64", 42}, {"0xffu8", 255}, {"0x_ff_i32", 255}, {"18446744073709551615", UINT64_MAX},
+        {"0xFFFF_FFFF_FFFF_FFFF", UINT64_MAX}, {"0000000000000000000000001", 1},
+    };
+    for (const Case& c : ok) {
+        uint64_t v = 1;
+        EXPECT_EQ(decodeInteger(c.text, v), IntegerStatus::OK) << c.text;
+        EXPECT_EQ(v, c.value) << c.text;
+    }
+    const char* bad[] = {"0x", "0b2", "0o8", "42u7", "1_f32", "0b_", "99999999999999999999u7"};
+    for (const char* text : bad) {
+        uint64_t v;
+        EXPECT_EQ(decodeInteger(text, v), IntegerStatus::INVALID) << text;
+    }
+    const char* wide[] = {"18446744073709551616", "0x1_0000_0000_0000_0000",
+                          "0o2000000000000000000000", "99999999999999999999999999999999u128"};
+    for (const char* text : wide) {
+        uint64_t v = 7;
+        EXPECT_EQ(decodeInteger(text, v), IntegerStatus::OUT_OF_RANGE) << text;
+        EXPECT_EQ(v, 7u) << text;
+    }
+}
+
+TEST(Literal, DecodeFloat) {
+    double v = 0;
+    EXPECT_TRUE(decodeFloat("3.14", v));
+    EXPECT_DOUBLE_EQ(v, 3.14);
+    EXPECT_TRUE(decodeFloat("1_000.5e-1_0f64", v));
+    EXPECT_DOUBLE_EQ(v, 1000.5e-10);
+    EXPECT_TRUE(decodeFloat("7.", v));
+    EXPECT_DOUBLE_EQ(v, 7.0);
+    EXPECT_TRUE(decodeFloat("2f32", v));
+    EXPECT_FALSE(decodeFloat("1e", v));
+    EXPECT_FALSE(decodeFloat("1.5u8", v));
+}
+
+TEST(Literal, DecodeString) {
+    std::string out;
+    EXPECT_TRUE(decodeString("a\\tb\\\\c\\\"\\'\\0\\x41\\u{e9}\\u{1F_600}", out));
+    EXPECT_EQ(out, std::string("a\tb\\c\"'\0A\xc3\xa9\xf0\x9f\x98\x80", 15));
+
+    out.clear();
+    EXPECT_TRUE(decodeString("one \\\n    two", out));
+    EXPECT_EQ(out, "one two");
+
+    const char* bad[] = {"\\q", "\\x80", "\\x4", "\\u{}", "\\u{D800}", "\\u{110000}",
+                         "\\u{1234567}", "\\u41", "\\"};
+    for (const char* body : bad) {
+        out.clear();
+        EXPECT_FALSE(decodeString(body, out)) << body;
+    }
+}
+
+TEST(Literal, DecodeChar) {
+    uint32_t c = 0;
+    EXPECT_TRUE(decodeChar("c", c));
+    EXPECT_EQ(c, uint32_t('c'));
+    EXPECT_TRUE(decodeChar("\\n", c));
+    EXPECT_EQ(c, uint32_t('\n'));
+    EXPECT_TRUE(decodeChar("\xf0\x9f\x98\x80", c));
+    EXPECT_EQ(c, 0x1F600u);
+    EXPECT_TRUE(decodeChar("\\u{1F600}", c));
+    EXPECT_EQ(c, 0x1F600u);
+    EXPECT_FALSE(decodeChar("", c));
+    EXPECT_FALSE(decodeChar("ab", c));
+    EXPECT_FALSE(decodeChar("\xc0\xaf", c));  // overlong
+    EXPECT_FALSE(decodeChar("\\n\\n", c));
+}
+
+// --- UTF-8 ---
+
+TEST(Lexer, UnicodeIdentifiers) {
+    auto l = lexemes("let café = ñandú + Δx + 変数 + a\u0301b;");
+    std::vector<std::string> expected = {
+        "let", "café", "=", "ñandú", "+", "Δx", "+", "変数", "+", "a\u0301b", ";",
+    };
+    EXPECT_EQ(l, expected);
+    for (const Token& t : Lexer("café ñandú 変数").tokenize()) EXPECT_EQ(t.flags, 0) << t.lexeme;
+}
+
+TEST(Lexer, NonIdentifierCharacterIsOneIllegalToken) {
+    Lexer lexer("a€b \u0301");
+    auto tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), 5u);
+    EXPECT_EQ(tokens[1].type, TokenType::ILLEGAL);
+    EXPECT_EQ(tokens[1].lexeme, "€");
+    EXPECT_EQ(tokens[1].length, 3u);
+    EXPECT_EQ(tokens[2].lexeme, "b");
+    EXPECT_EQ(tokens[3].type, TokenType::ILLEGAL);  // combining mark: XID_Continue, not XID_Start
+    EXPECT_EQ(tokens[3].lexeme, "\u0301");
+}
+
+TEST(Lexer, InvalidUtf8IsSkippedAndFlagged) {
+    Lexer lexer(std::string("a \xff\xfe b // \xc3(\nc \"x\xe2\x82y\" r\"\x80\" \"ü\"\xf0"));
+    auto tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), 7u);
+    EXPECT_EQ(tokens[0].flags, 0);
+    EXPECT_EQ(tokens[1].lexeme, "b");                      // the bytes are dropped
+    EXPECT_EQ(tokens[1].flags, TOKEN_BAD_UTF8);
+    EXPECT_EQ(tokens[2].lexeme, "c");                      // after a bad comment
+    EXPECT_EQ(tokens[2].flags, TOKEN_BAD_UTF8);
+    EXPECT_EQ(tokens[3].lexeme, "x\xe2\x82y");              // kept in a string
+    EXPECT_EQ(tokens[3].flags, TOKEN_BAD_UTF8);
+    EXPECT_EQ(tokens[4].flags, TOKEN_RAW | TOKEN_BAD_UTF8);
+    EXPECT_EQ(tokens[5].lexeme, "ü");
+    EXPECT_EQ(tokens[5].flags, 0);
+    EXPECT_EQ(tokens[6].type, TokenType::EOF_TOKEN);       // a truncated sequence at the end
+    EXPECT_EQ(tokens[6].flags, TOKEN_BAD_UTF8);
+}
+
+TEST(Lexer, LongStringsWithMultibyteText) {
+    std::string body;
+    for (int i = 0; i < 40; ++i) body += i % 7 ? "abcdefghij" : "añb€c日";
+    Lexer lexer("\"" + body + "\" x");
+    Token t = lexer.nextToken();
+    EXPECT_EQ(t.type, TokenType::STRING);
+    EXPECT_EQ(t.lexeme, body);
+    EXPECT_EQ(t.flags, 0);
+    EXPECT_EQ(lexer.nextToken().lexeme, "x");
+}
+
+TEST(Unicode, DecodeUtf8) {
+    uint32_t cp = 0;
+    EXPECT_EQ(decodeUtf8("A", 1, cp), 1u);
+    EXPECT_EQ(cp, 0x41u);
+    EXPECT_EQ(decodeUtf8("\xc3\xa9", 2, cp), 2u);
+    EXPECT_EQ(cp, 0xE9u);
+    EXPECT_EQ(decodeUtf8("\xe2\x82\xac", 3, cp), 3u);
+    EXPECT_EQ(cp, 0x20ACu);
+    EXPECT_EQ(decodeUtf8("\xf4\x8f\xbf\xbf", 4, cp), 4u);
+    EXPECT_EQ(cp, 0x10FFFFu);
+    EXPECT_EQ(decodeUtf8("\x80", 1, cp), 0u);              // stray continuation
+    EXPECT_EQ(decodeUtf8("\xc0\x80", 2, cp), 0u);          // overlong
+    EXPECT_EQ(decodeUtf8("\xe0\x9f\xbf", 3, cp), 0u);      // overlong
+    EXPECT_EQ(decodeUtf8("\xed\xa0\x80", 3, cp), 0u);      // surrogate
+    EXPECT_EQ(decodeUtf8("\xf4\x90\x80\x80", 4, cp), 0u);  // past U+10FFFF
+    EXPECT_EQ(decodeUtf8("\xe2\x82", 2, cp), 0u);          // truncated
+    EXPECT_EQ(decodeUtf8("\xe2\x82x", 3, cp), 0u);
+    EXPECT_EQ(invalidUtf8Length("\xe2\x82x", 3), 2u);     // maximal subpart
+    EXPECT_EQ(invalidUtf8Length("\xed\xa0\x80", 3), 1u);
+    EXPECT_EQ(invalidUtf8Length("\xff\x80", 2), 1u);
+}
+
+TEST(Unicode, FindInvalidUtf8AndAsciiPrefix) {
+    for (size_t at = 0; at < 70; ++at) {
+        std::string s(70, 'a');
+        s.replace(at, 1, "\xe2");
+        EXPECT_EQ(asciiPrefix(s.data(), s.size()), at);
+        size_t length = 0;
+        EXPECT_EQ(findInvalidUtf8(s, length), at);
+        EXPECT_EQ(length, 1u);
+        s.replace(at, 1, "\xe2\x82\xac");
+        EXPECT_EQ(findInvalidUtf8(s, length), s.size());
+    }
+}
+
+TEST(Unicode, XidClasses) {
+    EXPECT_TRUE(isXidStart(0xE9));      // é
+    EXPECT_TRUE(isXidStart(0x0394));    // Δ
+    EXPECT_TRUE(isXidStart(0x5909));    // 変
+    EXPECT_FALSE(isXidStart(0x0301));   // combining acute accent
+    EXPECT_TRUE(isXidContinue(0x0301));
+    EXPECT_TRUE(isXidContinue(0x0663));  // Arabic-Indic digit three
+    EXPECT_FALSE(isXidStart(0x0663));
+    EXPECT_FALSE(isXidContinue(0x20AC)); // €
+    EXPECT_FALSE(isXidContinue(0x1F600));
+    EXPECT_FALSE(isXidStart(0x10FFFF));
+    EXPECT_TRUE(isXidStart('a'));
+    EXPECT_FALSE(isXidStart('_'));
+    EXPECT_TRUE(isXidContinue('_'));
+}
+
 // --- Operators ---
 
 TEST(Lexer, TokenizesSingleCharOperators) {
@@ -126,6 +419,62 @@ TEST(Lexer, TokenizesDoubleCharOperators) {
     EXPECT_EQ(t[3], TokenType::GTE);
 }
 
+TEST(Lexer, TokenizesEveryOperatorSpelling) {
+    static const std::pair<const char*, TokenType> SPELLINGS[] = {
+        {"%", TokenType::PERCENT},       {"^", TokenType::CARET},
+        {"!", TokenType::BANG},          {"&", TokenType::AMP},
+        {"|", TokenType::PIPE},          {"&&", TokenType::AND},
+        {"||", TokenType::OR},           {"<<", TokenType::SHL},
+        {">>", TokenType::SHR},          {"+=", TokenType::PLUS_ASSIGN},
+        {"-=", TokenType::MINUS_ASSIGN}, {"*=", TokenType::STAR_ASSIGN},
+        {"/=", TokenType::SLASH_ASSIGN}, {"%=", TokenType::PERCENT_ASSIGN},
+        {"^=", TokenType::CARET_ASSIGN}, {"&=", TokenType::AMP_ASSIGN},
+        {"|=", TokenType::PIPE_ASSIGN},  {"<<=", TokenType::SHL_ASSIGN},
+        {">>=", TokenType::SHR_ASSIGN},  {".", TokenType::DOT},
+        {"..", TokenType::DOT_DOT},      {"..=", TokenType::DOT_DOT_EQ},
+        {"...", TokenType::ELLIPSIS},    {"::", TokenType::COLON_COLON},
+        {"->", TokenType::ARROW},        {"=>", TokenType::FAT_ARROW},
+        {"[", TokenType::LBRACKET},      {"]", TokenType::RBRACKET},
+        {"#", TokenType::POUND},         {"$", TokenType::DOLLAR},
+        {"?", TokenType::QUESTION},      {"~", TokenType::TILDE},
+        {"@", TokenType::AT},
+    };
+    for (const auto& [text, type] : SPELLINGS) {
+        Lexer lexer(text);
+        Token tok = lexer.nextToken();
+        EXPECT_EQ(tok.type, type) << text;
+        EXPECT_EQ(tok.lexeme, text);
+        EXPECT_EQ(tok.length, std::strlen(text));
+        EXPECT_EQ(lexer.nextToken().type, TokenType::EOF_TOKEN) << text;
+    }
+}
+
+TEST(Lexer, OperatorsAreMaximalMunch) {
+    EXPECT_EQ(lexemes("a<<=b>>c"), (std::vector<std::string>{"a", "<<=", "b", ">>", "c"}));
+    EXPECT_EQ(lexemes("&&&"), (std::vector<std::string>{"&&", "&"}));
+    EXPECT_EQ(lexemes("|||="), (std::vector<std::string>{"||", "|="}));
+    EXPECT_EQ(lexemes("....="), (std::vector<std::string>{"...", ".", "="}));
+    EXPECT_EQ(lexemes(".. =..="), (std::vector<std::string>{"..", "=", "..="}));
+    EXPECT_EQ(lexemes(":::"), (std::vector<std::string>{"::", ":"}));
+    EXPECT_EQ(lexemes("-->=>"), (std::vector<std::string>{"-", "->", "=>"}));
+    EXPECT_EQ(lexemes("!==="), (std::vector<std::string>{"!=", "=="}));
+    EXPECT_EQ(lexemes("<<"), (std::vector<std::string>{"<<"}));  // ends at EOF
+}
+
+TEST(Lexer, NumberBeforeDotIsNotAlwaysAFloat) {
+    auto t = types("1..2 1..=2 1.max(2) 1.e5 x.0 1. 1.5");
+    std::vector<TokenType> expected = {
+        TokenType::NUMBER, TokenType::DOT_DOT, TokenType::NUMBER,
+        TokenType::NUMBER, TokenType::DOT_DOT_EQ, TokenType::NUMBER,
+        TokenType::NUMBER, TokenType::DOT, TokenType::IDENT, TokenType::LPAREN,
+        TokenType::NUMBER, TokenType::RPAREN,
+        TokenType::NUMBER, TokenType::DOT, TokenType::IDENT,
+        TokenType::IDENT, TokenType::DOT, TokenType::NUMBER,
+        TokenType::FLOAT, TokenType::FLOAT,
+    };
+    EXPECT_EQ(t, expected);
+}
+
 // --- Edge case: == is EQ, not two ASSIGNs ---
 
 TEST(Lexer, DoubleEqualsIsOneToken) {
@@ -222,7 +571,123 @@ TEST(Lexer, TokenizesSimpleFunction) {
 // --- Illegal characters ---
 
 TEST(Lexer, IllegalCharacterProducesIllegalToken) {
-    auto t = types("@");
-    ASSERT_EQ(t.size(), 1u);
+    auto t = types("` \x01");
+    ASSERT_EQ(t.size(), 2u);
     EXPECT_EQ(t[0], TokenType::ILLEGAL);
+    EXPECT_EQ(t[1], TokenType::ILLEGAL);
+}
+
+// --- Source offsets ---
+
+TEST(Lexer, RecordsTokenOffsetsAndLengths) {
+    Lexer lexer("let  s = \"ab\"; // c\n==");
+    auto tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), 7u);
+    EXPECT_EQ(tokens[0].offset, 0u);   // let
+    EXPECT_EQ(tokens[0].length, 3u);
+    EXPECT_EQ(tokens[1].offset, 5u);   // s
+    EXPECT_EQ(tokens[3].offset, 9u);   // "ab" — length includes the quotes
+    EXPECT_EQ(tokens[3].length, 4u);
+    EXPECT_EQ(tokens[5].offset, 20u);  // ==
+    EXPECT_EQ(tokens[5].length, 2u);
+    EXPECT_EQ(tokens[6].type, TokenType::EOF_TOKEN);
+    EXPECT_EQ(tokens[6].offset, 22u);
+}
+
+TEST(Lexer, StartingLineIsConfigurable) {
+    Lexer lexer("a\nb", 10);
+    auto tokens = lexer.tokenize();
+    EXPECT_EQ(tokens[0].line, 10);
+    EXPECT_EQ(tokens[1].line, 11);
+}
+
+// --- Incremental relexing ---
+
+static void expectSameTokens(const std::vector<Token>& a, const std::vector<Token>& b,
+                             const std::string& src) {
+    ASSERT_EQ(a.size(), b.size()) << "Source:\n" << src;
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].type, b[i].type) << "token " << i << " in:\n" << src;
+        EXPECT_EQ(a[i].lexeme, b[i].lexeme) << "token " << i;
+        EXPECT_EQ(a[i].line, b[i].line) << "token " << i;
+        EXPECT_EQ(a[i].offset, b[i].offset) << "token " << i;
+        EXPECT_EQ(a[i].length, b[i].length) << "token " << i;
+        EXPECT_EQ(a[i].flags, b[i].flags) << "token " << i;
+    }
+}
+
+TEST(Lexer, ApplyEditRelexesOnlyNearTheEdit) {
+    std::string src;
+    for (int i = 0; i < 1000; ++i) {
+        src += "let x" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+    }
+    Lexer lexer(src);
+    TokenBuffer tokens(lexer.tokenize());
+
+    // Rename x500 -> x500abc
+    size_t pos = src.find("x500") + 4;
+    size_t relexed = lexer.applyEdit(TextEdit{pos, pos, "abc\n"}, tokens);
+    EXPECT_LE(relexed, 3u);
+
+    src.insert(pos, "abc\n");
+    expectSameTokens(tokens.toVector(), Lexer(src).tokenize(), src);
+}
+
+TEST(Lexer, ApplyEditHandlesCommentOpeningAndClosing) {
+    std::string src = "a /* b */ c\nd";
+    Lexer lexer(src);
+    TokenBuffer tokens(lexer.tokenize());
+
+    lexer.applyEdit(TextEdit{7, 9, ""}, tokens);  // drop "*/": comment runs to EOF
+    src = "a /* b  c\nd";
+    expectSameTokens(tokens.toVector(), Lexer(src).tokenize(), src);
+
+    lexer.applyEdit(TextEdit{0, 0, "x\n"}, tokens);
+    src = "x\n" + src;
+    expectSameTokens(tokens.toVector(), Lexer(src).tokenize(), src);
+}
+
+TEST(Lexer, ApplyEditRelexesANumberThatLookedPastItsDot) {
+    // `1` stops before the '.' because `é` follows it; breaking the second
+    // byte of `é`, three bytes past the end of `1`, makes it the float `1.`.
+    std::string src = "x = 1.\xc3\xa9;";
+    Lexer lexer(src);
+    TokenBuffer tokens(lexer.tokenize());
+
+    lexer.applyEdit(TextEdit{7, 8, "z"}, tokens);
+    src.replace(7, 1, "z");
+    expectSameTokens(tokens.toVector(), Lexer(src).tokenize(), src);
+}
+
+TEST(Lexer, ApplyEditDifferentialFuzz) {
+    static const char* FRAGMENTS[] = {
+        " ", "\n", "a", "b2", "fn", "=", "==", "!", "<", "/", "*", "//", "/*", "*/",
+        "\"", "\"s\n\"", "1", "23", "{", "}", ";", "@",
+        "0x", ".", "e", "_", "u8", "'", "\\", "r", "#", "r#\"",
+        "..", "=>", "<<", ">", "&", "|", "-", "::",
+        "\xc3\xa9", "\xe2\x82\xac", "\xff", "\xe2\x82", "\xcc\x81",
+    };
+    std::mt19937 rng(777);
+    std::string base = "fn main() {\n    let x = \"hi\"; // note\n    /* c */ y == 2;\n}\n";
+
+    for (int session = 0; session < 300; ++session) {
+        std::string src = base;
+        Lexer lexer(src);
+        TokenBuffer tokens(lexer.tokenize());
+        for (int step = 0; step < 10; ++step) {
+            size_t begin = rng() % (src.size() + 1);
+            size_t end = std::min(src.size(), begin + rng() % 4);
+            std::string text;
+            for (unsigned k = rng() % 3; k > 0; --k) {
+                text += FRAGMENTS[rng() % (sizeof(FRAGMENTS) / sizeof(FRAGMENTS[0]))];
+            }
+            lexer.applyEdit(TextEdit{begin, end, text}, tokens);
+            src.replace(begin, end - begin, text);
+            expectSameTokens(tokens.toVector(), Lexer(src).tokenize(), src);
+            if (step % 3 == 2) {
+                EXPECT_EQ(lexer.text(), src);  // closes the gap
+            }
+            if (::testing::Test::HasFailure()) return;
+        }
+    }
 }
@@ -0,0 +1,194 @@
+#include "literal.h"
+#include <cstdlib>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool isIntegerSuffix(std::string_view s) {
+    static const char* suffixes[] = {"i8", "i16", "i32", "i64", "i128", "isize",
+                                     "u8", "u16", "u32", "u64", "u128", "usize"};
+    for (const char* suffix : suffixes) {
+        if (s == suffix) return true;
+    }
+    return false;
+}
+
+static void appendUtf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Decodes the escape at s[i] == '\\' and moves `i` past it. A line
+// continuation yields no character (`cp` is left unset and `none` true).
+static bool decodeEscape(std::string_view s, size_t& i, uint32_t& cp, bool& none) {
+    none = false;
+    if (++i >= s.size()) return false;
+    char c = s[i++];
+    switch (c) {
+        case 'n':  cp = '\n'; return true;
+        case 'r':  cp = '\r'; return true;
+        case 't':  cp = '\t'; return true;
+        case '\\': cp = '\\'; return true;
+        case '0':  cp = 0;    return true;
+        case '\'': cp = '\''; return true;
+        case '"':  cp = '"';  return true;
+        case 'x': {
+            if (i + 2 > s.size()) return false;
+            int hi = digitValue(s[i]);
+            int lo = digitValue(s[i + 1]);
+            if (hi < 0 || hi > 7 || lo < 0) return false;
+            cp = static_cast<uint32_t>(hi * 16 + lo);
+            i += 2;
+            return true;
+        }
+        case 'u': {
+            if (i >= s.size() || s[i] != '{') return false;
+            ++i;
+            uint32_t value = 0;
+            int digits = 0;
+            for (; i < s.size() && s[i] != '}'; ++i) {
+                if (s[i] == '_' && digits > 0) continue;
+                int d = digitValue(s[i]);
+                if (d < 0 || ++digits > 6) return false;
+                value = value * 16 + static_cast<uint32_t>(d);
+            }
+            if (i >= s.size() || digits == 0) return false;
+            ++i;  // '}'
+            if (value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) return false;
+            cp = value;
+            return true;
+        }
+        case '\n':
+            while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) {
+                ++i;
+            }
+            none = true;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ============================================================
+// Numbers
+// ============================================================
+
+IntegerStatus decodeInteger(std::string_view text, uint64_t& value) {
+    unsigned base = 10;
+    size_t i = 0;
+    if (text.size() >= 2 && text[0] == '0') {
+        if (text[1] == 'x') base = 16;
+        else if (text[1] == 'o') base = 8;
+        else if (text[1] == 'b') base = 2;
+        if (base != 10) i = 2;
+    }
+    uint64_t v = 0;
+    bool digits = false, overflow = false;
+    for (; i < text.size(); ++i) {
+        if (text[i] == '_') continue;
+        int d = digitValue(text[i]);
+        if (d < 0 || static_cast<unsigned>(d) >= base) break;
+        overflow |= __builtin_mul_overflow(v, base, &v);
+        overflow |= __builtin_add_overflow(v, static_cast<unsigned>(d), &v);
+        digits = true;
+    }
+    if (!digits) return IntegerStatus::INVALID;
+    if (i < text.size() && !isIntegerSuffix(text.substr(i))) return IntegerStatus::INVALID;
+    if (overflow) return IntegerStatus::OUT_OF_RANGE;
+    value = v;
+    return IntegerStatus::OK;
+}
+
+bool decodeFloat(std::string_view text, double& value) {
+    std::string plain;
+    plain.reserve(text.size());
+    size_t i = 0;
+    auto digits = [&] {
+        size_t count = 0;
+        for (; i < text.size() && (text[i] == '_' || (text[i] >= '0' && text[i] <= '9')); ++i) {
+            if (text[i] == '_') continue;
+            plain += text[i];
+            ++count;
+        }
+        return count;
+    };
+    if (digits() == 0) return false;
+    if (i < text.size() && text[i] == '.') {
+        plain += text[i++];
+        digits();
+    }
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        plain += text[i++];
+        if (i < text.size() && (text[i] == '+' || text[i] == '-')) plain += text[i++];
+        if (digits() == 0) return false;
+    }
+    std::string_view suffix = text.substr(i);
+    if (!suffix.empty() && suffix != "f32" && suffix != "f64") return false;
+    value = std::strtod(plain.c_str(), nullptr);
+    return true;
+}
+
+// ============================================================
+// Strings and characters
+// ============================================================
+
+bool decodeString(std::string_view body, std::string& out) {
+    out.reserve(out.size() + body.size());
+    size_t i = 0;
+    while (i < body.size()) {
+        size_t run = i;
+        while (run < body.size() && body[run] != '\\') ++run;
+        out.append(body.data() + i, run - i);
+        i = run;
+        if (i == body.size()) break;
+        uint32_t cp = 0;
+        bool none = false;
+        if (!decodeEscape(body, i, cp, none)) return false;
+        if (!none) appendUtf8(cp, out);
+    }
+    return true;
+}
+
+bool decodeChar(std::string_view body, uint32_t& codePoint) {
+    if (body.empty()) return false;
+    size_t i = 0;
+    if (body[0] == '\\') {
+        bool none = false;
+        if (!decodeEscape(body, i, codePoint, none) || none) return false;
+        return i == body.size();
+    }
+    unsigned char lead = static_cast<unsigned char>(body[0]);
+    size_t length = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+    if (length == 0 || length != body.size() || lead > 0xF4) return false;
+    uint32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t k = 1; k < length; ++k) {
+        unsigned char c = static_cast<unsigned char>(body[k]);
+        if ((c & 0xC0) != 0x80) return false;
+        cp = (cp << 6) | (c & 0x3F);
+    }
+    static const uint32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < minimum[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+    codePoint = cp;
+    return true;
+}
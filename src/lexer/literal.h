@@ -0,0 +1,45 @@
+#ifndef LITERAL_H
+#define LITERAL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ============================================================
+// Literal decoding — on demand, from a token's lexeme
+// ============================================================
+//
+// The lexer only finds where a literal ends and sets Token::flags on the
+// ones whose lexeme is not already their value; nothing is converted while
+// lexing. These functions produce the value when a later phase asks for
+// it, and are where malformed literals (`0x`, `1e`, `"\q"`, `42u7`) are
+// caught.
+
+enum class IntegerStatus {
+    OK,
+    INVALID,       // no digits, a digit out of range for the base, or a bad suffix
+    OUT_OF_RANGE,  // more than 64 bits
+};
+
+// A NUMBER lexeme: decimal, `0x` / `0o` / `0b`, `_` separators and an
+// optional integer-type suffix (`i8` … `i128`, `isize`, `u8` … `u128`,
+// `usize`). Any value up to 2^64 - 1 is accepted: the back ends read it as
+// a wrapping i64, so `9223372036854775808` can be negated into i64::MIN.
+IntegerStatus decodeInteger(std::string_view text, uint64_t& value);
+
+// A FLOAT lexeme: digits, `.`, fraction, exponent, `_` separators and an
+// optional `f32` / `f64` suffix. False if the exponent has no digits or
+// the suffix is not a float type.
+bool decodeFloat(std::string_view text, double& value);
+
+// The contents of a STRING or CHAR token with TOKEN_ESCAPES, appended to
+// `out` with escapes replaced: `\n \r \t \\ \0 \' \"`, `\x00`–`\x7F`,
+// `\u{...}` (1–6 hex digits, a Unicode scalar value, written as UTF-8) and
+// a backslash before a newline, which drops the newline and the
+// whitespace after it. False at an unknown or malformed escape.
+bool decodeString(std::string_view body, std::string& out);
+
+// The contents of a CHAR token: exactly one character, escaped or UTF-8.
+bool decodeChar(std::string_view body, uint32_t& codePoint);
+
+#endif // LITERAL_H
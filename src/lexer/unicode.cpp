@@ -0,0 +1,118 @@
+#include "unicode.h"
+#include <algorithm>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ============================================================
+// UTF-8
+// ============================================================
+
+// Bytes in the sequence a lead byte starts, or 0 if it cannot start one
+// (continuation bytes, C0/C1, F5 and up).
+static size_t sequenceLength(unsigned char lead) {
+    if (lead >= 0xC2 && lead <= 0xDF) return 2;
+    if (lead >= 0xE0 && lead <= 0xEF) return 3;
+    if (lead >= 0xF0 && lead <= 0xF4) return 4;
+    return 0;
+}
+
+// The second byte's range depends on the lead (Unicode table 3-7); this is
+// what rules out overlong forms, surrogates and values past U+10FFFF. Later
+// bytes are any continuation byte.
+static bool validSecondByte(unsigned char lead, unsigned char b) {
+    switch (lead) {
+        case 0xE0: return b >= 0xA0 && b <= 0xBF;
+        case 0xED: return b >= 0x80 && b <= 0x9F;
+        case 0xF0: return b >= 0x90 && b <= 0xBF;
+        case 0xF4: return b >= 0x80 && b <= 0x8F;
+        default:   return (b & 0xC0) == 0x80;
+    }
+}
+
+size_t decodeUtf8(const char* p, size_t n, uint32_t& cp) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(p);
+    if (n == 0) return 0;
+    if (s[0] < 0x80) {
+        cp = s[0];
+        return 1;
+    }
+    size_t length = sequenceLength(s[0]);
+    if (length == 0 || n < length || !validSecondByte(s[0], s[1])) return 0;
+    uint32_t value = s[0] & (0x7F >> length);
+    for (size_t k = 1; k < length; ++k) {
+        if (k > 1 && (s[k] & 0xC0) != 0x80) return 0;
+        value = (value << 6) | (s[k] & 0x3F);
+    }
+    cp = value;
+    return length;
+}
+
+size_t invalidUtf8Length(const char* p, size_t n) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(p);
+    size_t length = sequenceLength(s[0]);
+    if (length == 0 || n < 2 || !validSecondByte(s[0], s[1])) return 1;
+    size_t k = 2;
+    while (k < length && k < n && (s[k] & 0xC0) == 0x80) ++k;
+    return k;
+}
+
+size_t findInvalidUtf8(std::string_view text, size_t& length) {
+    size_t i = 0;
+    while (i < text.size()) {
+        i += asciiPrefix(text.data() + i, text.size() - i);
+        if (i == text.size()) break;
+        uint32_t cp;
+        size_t step = decodeUtf8(text.data() + i, text.size() - i, cp);
+        if (step == 0) {
+            length = invalidUtf8Length(text.data() + i, text.size() - i);
+            return i;
+        }
+        i += step;
+    }
+    length = 0;
+    return text.size();
+}
+
+size_t asciiPrefix(const char* p, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        int high = _mm_movemask_epi8(block);  // one bit per byte >= 0x80
+        if (high) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(high)));
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, sizeof(w));
+        if (w & 0x8080808080808080ULL) break;
+    }
+    while (i < n && static_cast<unsigned char>(p[i]) < 0x80) ++i;
+    return i;
+}
+
+// ============================================================
+// XID_Start / XID_Continue
+// ============================================================
+
+static const uint32_t XID_TABLE[] = {
+#include "xid_tables.inc"
+};
+
+// Class bits of `cp`: 1 XID_Continue, 2 XID_Start.
+static unsigned xidClass(uint32_t cp) {
+    if (cp < 0x80) {
+        bool alpha = (cp | 0x20) >= 'a' && (cp | 0x20) <= 'z';
+        if (alpha) return 3;
+        return (cp >= '0' && cp <= '9') || cp == '_' ? 1 : 0;
+    }
+    const uint32_t* end = XID_TABLE + sizeof(XID_TABLE) / sizeof(XID_TABLE[0]);
+    const uint32_t* it = std::upper_bound(XID_TABLE, end, (cp << 2) | 3);
+    return it == XID_TABLE ? 0 : it[-1] & 3;
+}
+
+bool isXidStart(uint32_t cp) { return (xidClass(cp) & 2) != 0; }
+
+bool isXidContinue(uint32_t cp) { return (xidClass(cp) & 1) != 0; }
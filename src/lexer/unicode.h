@@ -0,0 +1,38 @@
+#ifndef UNICODE_H
+#define UNICODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// ============================================================
+// UTF-8 and identifier classes
+// ============================================================
+//
+// Source text is UTF-8. The lexer handles ASCII itself, byte by byte or a
+// block at a time, and only comes here at a byte >= 0x80.
+
+// Length of the well-formed UTF-8 sequence at p[0] (1–4), with its code
+// point in `cp`; 0 if the bytes there are not one (stray continuation
+// byte, truncated sequence, overlong form, surrogate, past U+10FFFF).
+size_t decodeUtf8(const char* p, size_t n, uint32_t& cp);
+
+// Bytes to skip at an invalid p[0]: the lead byte and the continuation
+// bytes that agree with it, at least 1 — the maximal subpart, so one bad
+// sequence is one error.
+size_t invalidUtf8Length(const char* p, size_t n);
+
+// Offset of the first invalid sequence in `text` and its length in
+// `length`, or text.size() if it is all valid UTF-8.
+size_t findInvalidUtf8(std::string_view text, size_t& length);
+
+// Number of leading ASCII bytes of [p, p + n): 16 per step with SSE2, 8 per
+// step elsewhere.
+size_t asciiPrefix(const char* p, size_t n);
+
+// Unicode XID_Start / XID_Continue (UAX #31), for code points >= 0x80;
+// tables generated by gen_xid_tables.py.
+bool isXidStart(uint32_t cp);
+bool isXidContinue(uint32_t cp);
+
+#endif // UNICODE_H
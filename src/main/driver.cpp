@@ -0,0 +1,347 @@
+#include "driver.h"
+#include "../parser/parser.h"
+#include "../ast/ast_printer.h"
+#include "../codegen/codegen.h"
+#include "../codegen/llvm_emitter.h"
+#include "../codegen/ssa.h"
+#include "../codegen/tac_printer.h"
+#include "../jit/jit.h"
+#include "../json/json_dump.h"
+#include "../opt/const_fold.h"
+#include "../opt/parse_passes.h"
+#include "../semantic/semantic.h"
+#include "../util/thread_pool.h"
+#include "../vm/bytecode.h"
+#include "../vm/vm.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+// ============================================================
+// Command line
+// ============================================================
+
+void printUsage(std::ostream& err) {
+    err << "Usage: rustc [--check] [-O] [--fuse] [--jobs=N] [--emit=tac|llvm|bytecode|tokens-json|ast-json] [--run[=vm|ast|jit]] [--jit] [--fuel=N] [--max-errors=N] [--error-format=full|short] [--cache-dir=DIR] [--cache-size=BYTES] [--stats] "
+           "<source_file>\n"
+           "       rustc --server=SOCKET [--workers=N] [--cache-dir=DIR] [--cache-size=BYTES]\n"
+           "       rustc --client=SOCKET <options as above> <source_file | ->\n"
+           "       rustc --client=SOCKET --shutdown\n";
+}
+
+// Returns the value of a `--name=value` argument, or nullptr if `arg` is not one.
+static const char* flagValue(const std::string& arg, const char* name) {
+    std::string prefix = std::string(name) + "=";
+    if (arg.compare(0, prefix.size(), prefix) == 0) {
+        return arg.c_str() + prefix.size();
+    }
+    return nullptr;
+}
+
+bool parseArgs(const std::vector<std::string>& args, Options& opts) {
+    for (const std::string& arg : args) {
+        if (const char* v = flagValue(arg, "--cache-dir")) {
+            opts.cacheDir = v;
+        } else if (const char* v = flagValue(arg, "--cache-size")) {
+            char* end = nullptr;
+            opts.cacheSize = std::strtoull(v, &end, 10);
+            if (*v == '\0' || *end != '\0') return false;
+        } else if (const char* v = flagValue(arg, "--jobs")) {
+            char* end = nullptr;
+            opts.jobs = static_cast<unsigned>(std::strtoul(v, &end, 10));
+            if (*v == '\0' || *end != '\0') return false;
+        } else if (const char* v = flagValue(arg, "--emit")) {
+            opts.emit = v;
+            if (opts.emit != "tac" && opts.emit != "llvm" && opts.emit != "bytecode" &&
+                opts.emit != "tokens-json" && opts.emit != "ast-json") {
+                return false;
+            }
+        } else if (arg == "--stats") {
+            opts.stats = true;
+        } else if (arg == "--check") {
+            opts.check = true;
+        } else if (arg == "-O") {
+            opts.optimize = true;
+        } else if (arg == "--fuse") {
+            opts.fuse = true;
+        } else if (arg == "--run") {
+            // Keeps a backend chosen by an earlier --jit or --run=...
+            if (opts.run.empty()) opts.run = "vm";
+        } else if (const char* v = flagValue(arg, "--run")) {
+            opts.run = v;
+            if (opts.run != "vm" && opts.run != "ast" && opts.run != "jit") return false;
+        } else if (arg == "--jit") {
+            opts.run = "jit";
+        } else if (const char* v = flagValue(arg, "--fuel")) {
+            char* end = nullptr;
+            opts.fuel = std::strtoull(v, &end, 10);
+            if (*v == '\0' || *end != '\0') return false;
+        } else if (const char* v = flagValue(arg, "--max-errors")) {
+            char* end = nullptr;
+            opts.maxErrors = std::strtoull(v, &end, 10);
+            if (*v == '\0' || *end != '\0') return false;
+        } else if (const char* v = flagValue(arg, "--error-format")) {
+            std::string format = v;
+            if (format != "full" && format != "short") return false;
+            opts.shortErrors = format == "short";
+        } else if (const char* v = flagValue(arg, "--server")) {
+            opts.server = v;
+        } else if (const char* v = flagValue(arg, "--client")) {
+            opts.client = v;
+        } else if (const char* v = flagValue(arg, "--workers")) {
+            char* end = nullptr;
+            opts.workers = static_cast<unsigned>(std::strtoul(v, &end, 10));
+            if (*v == '\0' || *end != '\0') return false;
+        } else if (arg == "--shutdown") {
+            opts.shutdown = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            return false;
+        } else if (opts.sourcePath.empty()) {
+            opts.sourcePath = arg;
+        } else {
+            return false;
+        }
+    }
+    if (!opts.server.empty()) return opts.client.empty() && opts.sourcePath.empty();
+    if (opts.shutdown) return !opts.client.empty() && opts.sourcePath.empty();
+    return !opts.sourcePath.empty();
+}
+
+bool readSource(const std::string& path, std::string& source) {
+    std::stringstream buffer;
+    if (path == "-") {
+        buffer << std::cin.rdbuf();
+    } else {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        buffer << file.rdbuf();
+    }
+    source = buffer.str();
+    return true;
+}
+
+// ============================================================
+// The pipeline
+// ============================================================
+
+// Writes a run's rendered errors in one go. Returns the exit status.
+static int fail(std::ostream& err, const std::string& text) {
+    err.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return 1;
+}
+
+int compileSource(Options opts, std::string source, ParseCache* cache, std::ostream& out,
+                  std::ostream& err) {
+    // Straight from the lexer to `out`; nothing is parsed or kept.
+    if (opts.emit == "tokens-json") {
+        Lexer lexer(std::move(source));
+        JsonWriter json(out);
+        writeTokensJson(lexer, json);
+        return json.flush() ? 0 : 1;
+    }
+    bool jsonEmit = opts.emit == "ast-json";
+    bool codeEmit = !opts.emit.empty() && !jsonEmit;
+
+    // Parse, or load the stored result for identical source bytes.
+    //
+    // --fuse counts nodes, folds literal operations and, for --run=ast,
+    // resolves locals as they are built. Cached trees must stay unfolded,
+    // so with a cache folding is not fused (slots are never stored).
+    CachedParse result;
+    ParseTimePasses passes(opts.optimize && !cache, opts.run == "ast");
+    bool fused = false;
+    bool stoppedEarly = false;
+    if (!cache || !cache->lookup(source, result)) {
+        Parser parser(source);
+        parser.setMaxErrors(opts.maxErrors);
+        if (opts.fuse) parser.setListener(&passes);
+        result.program = parser.parseProgram();
+        result.diagnostics = parser.diagnostics();
+        fused = opts.fuse;
+        stoppedEarly = parser.stoppedEarly();
+        // A truncated error list depends on --max-errors, not just the source.
+        if (cache && !stoppedEarly) {
+            cache->store(source, result.program.get(), result.diagnostics);
+        }
+    }
+
+    if (opts.stats && cache) {
+        const CacheStats& s = cache->stats();
+        err << "[stats] cache: " << s.hits << " hit(s), " << s.misses << " miss(es), "
+            << s.evictions << " eviction(s)\n";
+    }
+
+    if (opts.stats) {
+        AstStats s = fused ? passes.stats() : collectAstStats(result.program.get());
+        err << "[stats] ast: " << s.nodes << " node(s), " << s.functions << " function(s), "
+            << s.calls << " call(s)\n";
+    }
+
+    // Messages are only built here, and written in one go.
+    if (!result.diagnostics.empty()) {
+        std::string text = renderDiagnostics(result.diagnostics, source, !opts.shortErrors);
+        if (stoppedEarly) {
+            text += "Parsing stopped after " + std::to_string(result.diagnostics.size()) +
+                    " error(s)\n";
+        }
+        return fail(err, text);
+    }
+
+    // Optimization and code generation assume a checked program.
+    if (opts.check || opts.optimize || !opts.run.empty() || codeEmit) {
+        SemanticAnalyzer analyzer(result.program.get());
+        bool ok;
+        if (opts.jobs == 1) {
+            ok = analyzer.analyze();
+        } else {
+            ThreadPool pool(opts.jobs);
+            ok = analyzer.analyzeParallel(pool);
+        }
+        if (!ok) {
+            std::string text;
+            for (const auto& e : analyzer.errors()) {
+                renderLineError("Semantic", e.line, e.message, text);
+            }
+            return fail(err, text);
+        }
+    }
+
+    if (opts.optimize) {
+        ConstantFolder folder(result.program.get());
+        FoldStats s;
+        if (fused && !cache) {
+            folder.runExprs(passes.exprsToFold());
+            s = passes.foldStats();
+        } else {
+            folder.run();
+        }
+        if (opts.stats) {
+            s.constantsFolded += folder.stats().constantsFolded;
+            s.identities += folder.stats().identities;
+            err << "[stats] fold: " << s.constantsFolded << " constant(s) folded, "
+                << s.identities << " identity simplification(s)\n";
+        }
+    }
+
+    if (jsonEmit) {
+        JsonWriter json(out);
+        writeAstJson(result.program.get(), json);
+        return json.flush() ? 0 : 1;
+    }
+
+    IrModule module;
+    if (codeEmit || opts.run == "vm" || opts.run == "jit") {
+        CodeGen codegen(result.program.get());
+        module = codegen.lower();
+        if (codegen.hasErrors()) {
+            std::string text;
+            for (const auto& e : codegen.errors()) {
+                renderLineError("Codegen", e.line, e.message, text);
+            }
+            return fail(err, text);
+        }
+        if (opts.optimize) {
+            IrOptStats stats;
+            optimizeModule(module, stats);
+            if (opts.stats) {
+                err << "[stats] ir: " << stats.instrsBefore << " -> " << stats.instrsAfter
+                    << " instruction(s), " << stats.blocksRemoved
+                    << " unreachable block(s) removed\n";
+            }
+        }
+        if (opts.emit == "tac") out << emitTac(module);
+        if (opts.emit == "llvm") {
+            if (opts.jobs == 1) {
+                out << emitLlvm(module);
+            } else {
+                ThreadPool pool(opts.jobs);
+                out << emitLlvmParallel(module, pool);
+            }
+        }
+    }
+
+    if (opts.emit == "bytecode" || opts.run == "vm") {
+        BytecodeCompiler compiler(module);
+        BcModule bytecode = compiler.compile();
+        if (compiler.hasErrors()) {
+            std::string text;
+            for (const auto& e : compiler.errors()) {
+                renderFunctionError("Bytecode", e.function, e.message, text);
+            }
+            return fail(err, text);
+        }
+        if (opts.emit == "bytecode") out << disassemble(bytecode);
+
+        if (opts.run == "vm") {
+            uint32_t entry = bytecode.find("main");
+            if (entry == IR_NONE || bytecode.functions[entry].numParams != 0) {
+                err << "Error: --run needs a function 'main' without parameters" << '\n';
+                return 1;
+            }
+            Vm vm(bytecode);
+            vm.setFuel(opts.vmFuel);
+            int64_t value = 0;
+            if (!vm.call(entry, {}, value)) {
+                std::string text;
+                for (const auto& e : vm.errors()) {
+                    renderFunctionError("Runtime", e.function, e.message, text);
+                }
+                return fail(err, text);
+            }
+            out << value << '\n';
+        }
+    }
+
+    if (opts.run == "jit") {
+        Jit jit(module);
+        if (jit.compiled()) {
+            uint32_t entry = jit.find("main");
+            if (entry == IR_NONE || module.functions[entry].numParams != 0) {
+                err << "Error: --run needs a function 'main' without parameters" << '\n';
+                return 1;
+            }
+            if (opts.stats) err << "[stats] jit: " << jit.codeSize() << " byte(s) of code\n";
+            int64_t value = 0;
+            if (!jit.call(entry, {}, value)) {
+                std::string text;
+                for (const auto& e : jit.errors()) {
+                    renderFunctionError("Runtime", e.function, e.message, text);
+                }
+                return fail(err, text);
+            }
+            out << value << '\n';
+        } else {
+            err << "[jit] " << jit.errors()[0].message << "; using the interpreter" << '\n';
+            opts.run = "ast";
+        }
+    }
+
+    if (opts.run == "ast") {
+        InterpLimits limits;
+        limits.fuel = opts.fuel;
+        Interpreter interp(result.program.get(), limits);
+        int64_t value = 0;
+        bool ok = interp.call("main", {}, value);
+        if (opts.stats) {
+            err << "[stats] interp: " << interp.fuelUsed() << " step(s)\n";
+        }
+        if (!ok) {
+            std::string text;
+            for (const auto& e : interp.errors()) {
+                renderLineError("Runtime", e.line, e.message, text);
+            }
+            return fail(err, text);
+        }
+        out << value << '\n';
+    }
+
+    if (!opts.emit.empty() || !opts.run.empty()) return 0;
+
+    out << "Parsed successfully: "
+        << result.program->statements.size() << " top-level statement(s).\n\n";
+    printAst(result.program.get(), out);
+    return 0;
+}
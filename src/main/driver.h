@@ -0,0 +1,58 @@
+#ifndef DRIVER_H
+#define DRIVER_H
+
+#include "../cache/parse_cache.h"
+#include "../interp/interpreter.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Command-line options
+// ============================================================
+struct Options {
+    std::string sourcePath;
+    std::string cacheDir;   // empty = no parse cache
+    uint64_t cacheSize = ParseCache::DEFAULT_MAX_BYTES;
+    bool stats = false;
+    bool check = false;     // run semantic analysis after parsing
+    unsigned jobs = 1;      // threads for --check; 0 = one per core
+    std::string emit;       // "tac" / "llvm" / "bytecode" print generated code instead of the AST;
+                            // "tokens-json" / "ast-json" stream the tokens or the tree as JSON
+    bool optimize = false;  // -O: fold constants after checking
+    bool fuse = false;      // run per-node passes while parsing
+    std::string run;        // "vm" / "ast" / "jit": how to execute main()
+    uint64_t fuel = InterpLimits().fuel;  // step limit for --run=ast
+    uint64_t vmFuel = 0;    // jump and call limit for --run=vm; 0 = none (the server sets one)
+    size_t maxErrors = 100; // parse errors before giving up; 0 = no limit
+    bool shortErrors = false;  // --error-format=short: no source snippets
+    std::string server;     // --server=SOCKET: serve compile requests on a Unix socket
+    std::string client;     // --client=SOCKET: send this compilation to a server
+    unsigned workers = 0;   // --server: worker threads; 0 = one per core
+    bool shutdown = false;  // --client: ask the server to exit
+};
+
+// Fills `opts` from the arguments (without the program name). False on an
+// unknown flag, a bad value or a missing source file.
+bool parseArgs(const std::vector<std::string>& args, Options& opts);
+
+void printUsage(std::ostream& err);
+
+// Reads `path` (standard input for "-") into `source`. False if it cannot
+// be opened.
+bool readSource(const std::string& path, std::string& source);
+
+// ============================================================
+// One compilation
+// ============================================================
+//
+// Runs the pipeline the options ask for on `source`: parse (through `cache`
+// when it is not null), check, fold, then print the AST, emit code or run
+// main(). Results go to `out`, diagnostics and --stats counters to `err`.
+// Returns the process exit status. Reentrant: the server calls it from
+// several threads at once, sharing `cache`.
+int compileSource(Options opts, std::string source, ParseCache* cache, std::ostream& out,
+                  std::ostream& err);
+
+#endif // DRIVER_H
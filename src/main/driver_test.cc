@@ -0,0 +1,35 @@
+#include "driver.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Command line
+// ============================================================
+
+static Options parsed(const std::vector<std::string>& args) {
+    Options opts;
+    EXPECT_TRUE(parseArgs(args, opts));
+    return opts;
+}
+
+TEST(ParseArgs, RunDefaultsToTheVm) {
+    EXPECT_EQ(parsed({"--run", "f.rs"}).run, "vm");
+    EXPECT_EQ(parsed({"f.rs"}).run, "");
+}
+
+TEST(ParseArgs, BareRunKeepsAChosenBackend) {
+    // --jit and --run together pick the JIT in either order.
+    EXPECT_EQ(parsed({"--jit", "--run", "f.rs"}).run, "jit");
+    EXPECT_EQ(parsed({"--run", "--jit", "f.rs"}).run, "jit");
+    EXPECT_EQ(parsed({"--run=ast", "--run", "f.rs"}).run, "ast");
+    // A backend named later still wins.
+    EXPECT_EQ(parsed({"--jit", "--run=vm", "f.rs"}).run, "vm");
+}
+
+TEST(ParseArgs, BadValuesAreRejected) {
+    Options opts;
+    EXPECT_FALSE(parseArgs({"--run=wasm", "f.rs"}, opts));
+    EXPECT_FALSE(parseArgs({"--jobs=x", "f.rs"}, opts));
+    EXPECT_FALSE(parseArgs({"--run"}, opts));
+}
@@ -1,37 +1,43 @@
-#include "../parser/parser.h"
-#include "../ast/ast_printer.h"
-#include <fstream>
+#include "driver.h"
+#include "../server/client.h"
+#include "../server/server.h"
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: rustc <source_file>" << std::endl;
+    std::vector<std::string> args(argv + 1, argv + argc);
+    Options opts;
+    if (!parseArgs(args, opts)) {
+        printUsage(std::cerr);
         return 1;
     }
 
-    std::ifstream file(argv[1]);
-    if (!file.is_open()) {
-        std::cerr << "Error: could not open file '" << argv[1] << "'" << std::endl;
-        return 1;
+    if (!opts.server.empty()) {
+        CompileServer server(opts.workers, opts.cacheDir, opts.cacheSize);
+        std::string error;
+        if (!server.listen(opts.server, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        server.serve();
+        return 0;
+    }
+    if (!opts.client.empty()) {
+        return runClient(opts.client, args, std::cout, std::cerr);
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string source = buffer.str();
-
-    Parser parser(source);
-    auto program = parser.parseProgram();
-
-    if (parser.hasErrors()) {
-        for (const auto& err : parser.errors()) {
-            std::cerr << "Parse error [line " << err.line << "]: " << err.message << std::endl;
-        }
+    std::string source;
+    if (!readSource(opts.sourcePath, source)) {
+        std::cerr << "Error: could not open file '" << opts.sourcePath << "'" << std::endl;
         return 1;
     }
 
-    std::cout << "Parsed successfully: "
-              << program->statements.size() << " top-level statement(s).\n\n";
-    printAst(program.get());
-    return 0;
+    std::unique_ptr<ParseCache> cache;
+    if (!opts.cacheDir.empty()) {
+        cache = std::make_unique<ParseCache>(opts.cacheDir, opts.cacheSize);
+    }
+    return compileSource(opts, std::move(source), cache.get(), std::cout, std::cerr);
 }
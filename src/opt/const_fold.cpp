@@ -0,0 +1,290 @@
+#include "const_fold.h"
+#include <cstdio>
+#include <limits>
+
+// ============================================================
+// Literal values
+// ============================================================
+
+// The value of `node` if it is a literal, read as the back ends read it
+// (literalValue() in ast.h). False for anything else.
+static bool asLiteral(const AstNode* node, int64_t& out) {
+    if (!node || node->kind != NodeKind::NUMBER_LITERAL) return false;
+    out = literalValue(static_cast<const NumberLiteralNode*>(node));
+    return true;
+}
+
+static bool isNumber(const AstNode* node) {
+    return node && node->kind == NodeKind::NUMBER_LITERAL;
+}
+
+// Turns the literal in `slot` into `value`, keeping the node and its string buffer.
+static void setLiteral(AstNodePtr& slot, int64_t value, int line) {
+    auto* lit = static_cast<NumberLiteralNode*>(slot.get());
+    char buf[24];
+    int len = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+    lit->value.assign(buf, static_cast<size_t>(len));
+    lit->line = line;
+}
+
+// True if evaluating `node` has no effect besides producing its value, so
+// it can be dropped. Calls, assignments and divisions (which may fault on
+// zero) are not.
+static bool isPure(const AstNode* node) {
+    if (!node) return true;
+    switch (node->kind) {
+        case NodeKind::NUMBER_LITERAL:
+        case NodeKind::STRING_LITERAL:
+        case NodeKind::IDENT_EXPR:
+            return true;
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<const BinaryExprNode*>(node);
+            if (n->op == "/") return false;
+            return isPure(n->left.get()) && isPure(n->right.get());
+        }
+        case NodeKind::UNARY_EXPR:
+            return isPure(static_cast<const UnaryExprNode*>(node)->operand.get());
+        default:
+            return false;
+    }
+}
+
+// Evaluates `a op b`. False if the operator is unknown or the result is not
+// defined in i64 (overflow, division by zero).
+static bool evalArithmetic(const std::string& op, int64_t a, int64_t b, int64_t& out) {
+    if (op == "+") return !__builtin_add_overflow(a, b, &out);
+    if (op == "-") return !__builtin_sub_overflow(a, b, &out);
+    if (op == "*") return !__builtin_mul_overflow(a, b, &out);
+    if (op == "/") {
+        if (b == 0 || (a == std::numeric_limits<int64_t>::min() && b == -1)) return false;
+        out = a / b;
+        return true;
+    }
+    return false;
+}
+
+static bool evalComparison(const std::string& op, int64_t a, int64_t b, bool& out) {
+    if (op == "==") out = a == b;
+    else if (op == "!=") out = a != b;
+    else if (op == "<") out = a < b;
+    else if (op == ">") out = a > b;
+    else if (op == "<=") out = a <= b;
+    else if (op == ">=") out = a >= b;
+    else return false;
+    return true;
+}
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+ConstantFolder::ConstantFolder(ProgramNode* root)
+    : root_(root) {}
+
+void ConstantFolder::run() {
+    if (!root_) return;
+    for (auto& stmt : root_->statements) {
+        foldStmt(stmt.get());
+    }
+}
+
+void ConstantFolder::runExprs(const std::vector<AstNodePtr*>& slots) {
+    for (AstNodePtr* slot : slots) foldExpr(*slot);
+}
+
+void ConstantFolder::foldLiterals(AstNodePtr& slot) {
+    if (!slot) return;
+    if (slot->kind == NodeKind::BINARY_EXPR) {
+        auto* n = static_cast<BinaryExprNode*>(slot.get());
+        if (isNumber(n->left.get()) && isNumber(n->right.get())) foldBinary(slot);
+    } else if (slot->kind == NodeKind::UNARY_EXPR) {
+        if (isNumber(static_cast<UnaryExprNode*>(slot.get())->operand.get())) foldUnary(slot);
+    }
+}
+
+static bool isLiteral(const AstNode* node, int64_t expected) {
+    int64_t value;
+    return asLiteral(node, value) && value == expected;
+}
+
+// The identity cases of foldBinary, without the purity check on x * 0.
+bool ConstantFolder::mayFoldIdentity(const AstNode* node) {
+    if (!node || node->kind != NodeKind::BINARY_EXPR) return false;
+    auto* n = static_cast<const BinaryExprNode*>(node);
+    const AstNode* l = n->left.get();
+    const AstNode* r = n->right.get();
+    if (!isNumber(l) && !isNumber(r)) return false;
+    if (n->op == "+") return isLiteral(l, 0) || isLiteral(r, 0);
+    if (n->op == "-") return isLiteral(r, 0);
+    if (n->op == "*") return isLiteral(l, 0) || isLiteral(r, 0) || isLiteral(l, 1) || isLiteral(r, 1);
+    if (n->op == "/") return isLiteral(r, 1);
+    return false;
+}
+
+const FoldStats& ConstantFolder::stats() const {
+    return stats_;
+}
+
+// ============================================================
+// Statements
+// ============================================================
+
+void ConstantFolder::foldStmt(AstNode* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NodeKind::FN_DECL:
+            foldStmt(static_cast<FnDeclNode*>(node)->body.get());
+            break;
+        case NodeKind::IMPL_BLOCK:
+            for (auto& method : static_cast<ImplBlockNode*>(node)->methods) {
+                foldStmt(method.get());
+            }
+            break;
+        case NodeKind::BLOCK: {
+            auto* n = static_cast<BlockNode*>(node);
+            for (auto& stmt : n->statements) foldStmt(stmt.get());
+            foldExpr(n->value);
+            break;
+        }
+        case NodeKind::LET_STMT:
+            foldExpr(static_cast<LetStmtNode*>(node)->init);
+            break;
+        case NodeKind::RETURN_STMT:
+            foldExpr(static_cast<ReturnStmtNode*>(node)->value);
+            break;
+        case NodeKind::WHILE_STMT: {
+            auto* n = static_cast<WhileStmtNode*>(node);
+            foldExpr(n->condition);
+            foldStmt(n->body.get());
+            break;
+        }
+        case NodeKind::LOOP_STMT:
+            foldStmt(static_cast<LoopStmtNode*>(node)->body.get());
+            break;
+        case NodeKind::FOR_STMT: {
+            auto* n = static_cast<ForStmtNode*>(node);
+            foldExpr(n->iterable);
+            foldStmt(n->body.get());
+            break;
+        }
+        case NodeKind::IF_STMT: {
+            auto* n = static_cast<IfStmtNode*>(node);
+            foldExpr(n->condition);
+            foldStmt(n->thenBranch.get());
+            foldStmt(n->elseBranch.get());
+            break;
+        }
+        case NodeKind::EXPR_STMT:
+            foldExpr(static_cast<ExprStmtNode*>(node)->expr);
+            break;
+        default:
+            break;
+    }
+}
+
+// ============================================================
+// Expressions
+// ============================================================
+
+// Folds the children first, then `slot` itself, replacing it if it simplifies.
+void ConstantFolder::foldExpr(AstNodePtr& slot) {
+    if (!slot) return;
+
+    switch (slot->kind) {
+        case NodeKind::BINARY_EXPR:
+            foldBinary(slot);
+            break;
+        case NodeKind::UNARY_EXPR:
+            foldUnary(slot);
+            break;
+        case NodeKind::ASSIGN_EXPR:
+            foldExpr(static_cast<AssignExprNode*>(slot.get())->value);
+            break;
+        case NodeKind::CALL_EXPR:
+            for (auto& arg : static_cast<CallExprNode*>(slot.get())->args) {
+                foldExpr(arg);
+            }
+            break;
+        case NodeKind::FIELD_EXPR:
+            foldExpr(static_cast<FieldExprNode*>(slot.get())->object);
+            break;
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto* n = static_cast<MethodCallExprNode*>(slot.get());
+            foldExpr(n->receiver);
+            for (auto& arg : n->args) foldExpr(arg);
+            break;
+        }
+        case NodeKind::BLOCK:
+        case NodeKind::IF_STMT:
+            foldStmt(slot.get());
+            break;
+        case NodeKind::MATCH_EXPR: {
+            // Patterns are literals already.
+            auto* n = static_cast<MatchExprNode*>(slot.get());
+            foldExpr(n->scrutinee);
+            for (auto& arm : n->arms) foldExpr(static_cast<MatchArmNode*>(arm.get())->body);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ConstantFolder::foldBinary(AstNodePtr& slot) {
+    auto* n = static_cast<BinaryExprNode*>(slot.get());
+    foldExpr(n->left);
+    foldExpr(n->right);
+
+    int64_t a = 0, b = 0;
+    bool leftConst = asLiteral(n->left.get(), a);
+    bool rightConst = asLiteral(n->right.get(), b);
+    int line = n->line;
+
+    if (leftConst && rightConst) {
+        int64_t value;
+        bool truth;
+        if (evalArithmetic(n->op, a, b, value)) {
+            AstNodePtr lit = std::move(n->left);
+            slot = std::move(lit);
+            setLiteral(slot, value, line);
+            stats_.constantsFolded++;
+        } else if (evalComparison(n->op, a, b, truth)) {
+            slot = std::make_unique<IdentExprNode>(truth ? "true" : "false", line);
+            stats_.constantsFolded++;
+        }
+        return;
+    }
+
+    // Identities that keep the other operand (so it is still evaluated).
+    AstNodePtr* keep = nullptr;
+    if ((n->op == "+" || n->op == "-") && rightConst && b == 0) keep = &n->left;
+    else if (n->op == "+" && leftConst && a == 0) keep = &n->right;
+    else if ((n->op == "*" || n->op == "/") && rightConst && b == 1) keep = &n->left;
+    else if (n->op == "*" && leftConst && a == 1) keep = &n->right;
+    // x * 0 drops x, so x must have no effects.
+    else if (n->op == "*" && rightConst && b == 0 && isPure(n->left.get())) keep = &n->right;
+    else if (n->op == "*" && leftConst && a == 0 && isPure(n->right.get())) keep = &n->left;
+
+    if (keep) {
+        AstNodePtr kept = std::move(*keep);
+        slot = std::move(kept);
+        stats_.identities++;
+    }
+}
+
+void ConstantFolder::foldUnary(AstNodePtr& slot) {
+    auto* n = static_cast<UnaryExprNode*>(slot.get());
+    foldExpr(n->operand);
+
+    int64_t value;
+    if (n->op != "-" || !asLiteral(n->operand.get(), value) ||
+        value == std::numeric_limits<int64_t>::min()) {
+        return;
+    }
+    int line = n->line;
+    AstNodePtr lit = std::move(n->operand);
+    slot = std::move(lit);
+    setLiteral(slot, -value, line);
+    stats_.constantsFolded++;
+}
@@ -0,0 +1,59 @@
+#ifndef CONST_FOLD_H
+#define CONST_FOLD_H
+
+#include "../ast/ast.h"
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// FoldStats — counters reported by the driver's --stats output
+// ============================================================
+struct FoldStats {
+    uint64_t constantsFolded = 0;  // operator nodes replaced by a literal
+    uint64_t identities = 0;       // x+0, x-0, x*1, x/1, x*0 simplifications
+};
+
+// ============================================================
+// ConstantFolder — rewrites constant subexpressions in place
+// ============================================================
+//
+// Run on a program that passed semantic analysis (folding "a" * 1 to "a"
+// would hide a type error). Arithmetic is i64: a fold that would overflow,
+// or divide by zero, is left for run time. Folded literals reuse the node
+// and string storage of an operand and may carry a leading '-'.
+// Comparisons fold to the identifiers `true` / `false`.
+class ConstantFolder {
+public:
+    explicit ConstantFolder(ProgramNode* root);
+
+    void run();
+
+    // Folds the expressions in the given slots as run() would fold them
+    // where they are. Slots may be nested in one another: folding is
+    // idempotent, so nothing is counted twice.
+    void runExprs(const std::vector<AstNodePtr*>& slots);
+
+    // Folds `slot` if it is an operator whose operands are all number
+    // literals. Those folds do not depend on types, so unlike run() this
+    // is safe before semantic analysis. Children are not visited: apply it
+    // bottom-up (e.g. from a ParseListener) to get everything run() would
+    // fold between literals.
+    void foldLiterals(AstNodePtr& slot);
+
+    // True if run() could still rewrite `node` itself once its operands
+    // are folded: a binary operator with a 0 or 1 operand it can drop.
+    static bool mayFoldIdentity(const AstNode* node);
+
+    const FoldStats& stats() const;
+
+private:
+    ProgramNode* root_;
+    FoldStats stats_;
+
+    void foldStmt(AstNode* node);
+    void foldExpr(AstNodePtr& slot);
+    void foldBinary(AstNodePtr& slot);
+    void foldUnary(AstNodePtr& slot);
+};
+
+#endif // CONST_FOLD_H
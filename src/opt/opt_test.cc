@@ -0,0 +1,364 @@
+#include "const_fold.h"
+#include "parse_passes.h"
+#include "../semantic/semantic.h"
+#include "../ast/ast_printer.h"
+#include "../ast/ast_visitor.h"
+#include "../interp/interpreter.h"
+#include "../parser/parser.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// Parses `src`, folds it and returns the initializer of the first `let`
+// in the first function.
+struct Folded {
+    std::unique_ptr<ProgramNode> program;
+    FoldStats stats;
+
+    AstNode* firstInit() const {
+        auto* fn = static_cast<FnDeclNode*>(program->statements[0].get());
+        auto* body = static_cast<BlockNode*>(fn->body.get());
+        return static_cast<LetStmtNode*>(body->statements[0].get())->init.get();
+    }
+};
+
+static Folded fold(const std::string& src) {
+    Parser parser(src);
+    Folded result{parser.parseProgram(), FoldStats()};
+    EXPECT_FALSE(parser.hasErrors()) << "Unexpected parse error in: " << src;
+    ConstantFolder folder(result.program.get());
+    folder.run();
+    result.stats = folder.stats();
+    return result;
+}
+
+static std::string literal(const AstNode* node) {
+    if (!node || node->kind != NodeKind::NUMBER_LITERAL) return "<not a literal>";
+    return static_cast<const NumberLiteralNode*>(node)->value;
+}
+
+static std::string dump(const AstNode* node) {
+    std::ostringstream out;
+    printAst(node, out);
+    return out.str();
+}
+
+// ============================================================
+// Constant folding
+// ============================================================
+
+TEST(ConstantFolder, FoldsNestedArithmetic) {
+    auto f = fold("fn f() { let x = 2 * 3 + 4 - 10 / 5; }");
+    EXPECT_EQ(literal(f.firstInit()), "8");
+    EXPECT_EQ(f.stats.constantsFolded, 4u);
+}
+
+TEST(ConstantFolder, FoldsUnaryMinusToNegativeLiteral) {
+    auto f = fold("fn f() { let x = -(3 * 4); }");
+    EXPECT_EQ(literal(f.firstInit()), "-12");
+}
+
+TEST(ConstantFolder, ComparisonsFoldToBooleanIdentifiers) {
+    auto f = fold("fn f() { let x = 1 + 1 == 2; }");
+    ASSERT_EQ(f.firstInit()->kind, NodeKind::IDENT_EXPR);
+    EXPECT_EQ(static_cast<IdentExprNode*>(f.firstInit())->name, "true");
+}
+
+TEST(ConstantFolder, FoldedLiteralKeepsLineOfOperator) {
+    auto f = fold("fn f() {\n let x = 1\n + 2; }");
+    EXPECT_EQ(f.firstInit()->line, 3);
+}
+
+TEST(ConstantFolder, OverflowIsLeftForRunTime) {
+    auto f = fold("fn f() { let x = 9223372036854775807 + 1; }");
+    EXPECT_EQ(f.firstInit()->kind, NodeKind::BINARY_EXPR);
+    EXPECT_EQ(f.stats.constantsFolded, 0u);
+
+    auto g = fold("fn f() { let x = 3037000500 * 3037000500; }");
+    EXPECT_EQ(g.firstInit()->kind, NodeKind::BINARY_EXPR);
+}
+
+TEST(ConstantFolder, MinimumValueIsRepresentable) {
+    auto f = fold("fn f() { let x = 0 - 9223372036854775807 - 1; }");
+    EXPECT_EQ(literal(f.firstInit()), "-9223372036854775808");
+    // Negating it overflows, so it stays a unary expression.
+    auto g = fold("fn f() { let x = -(0 - 9223372036854775807 - 1); }");
+    EXPECT_EQ(g.firstInit()->kind, NodeKind::UNARY_EXPR);
+}
+
+TEST(ConstantFolder, LiteralsReadAsTheBackEndsReadThem) {
+    // Base prefixes, separators and suffixes are decoded...
+    auto f = fold("fn f() { let x = 0x10 + 1_000i64; }");
+    EXPECT_EQ(literal(f.firstInit()), "1016");
+    // ...and a literal past i64::MAX wraps, as it does at run time.
+    auto g = fold("fn f() { let x = 18446744073709551615 + 1; }");
+    EXPECT_EQ(literal(g.firstInit()), "0");
+}
+
+TEST(ConstantFolder, DivisionByZeroIsLeftForRunTime) {
+    auto f = fold("fn f() { let x = 1 / 0; }");
+    EXPECT_EQ(f.firstInit()->kind, NodeKind::BINARY_EXPR);
+}
+
+// ============================================================
+// Identities
+// ============================================================
+
+TEST(ConstantFolder, AdditiveAndMultiplicativeIdentities) {
+    for (const char* expr : {"y + 0", "0 + y", "y - 0", "y * 1", "1 * y", "y / 1"}) {
+        auto f = fold(std::string("fn f(y: i32) { let x = ") + expr + "; }");
+        ASSERT_EQ(f.firstInit()->kind, NodeKind::IDENT_EXPR) << expr;
+        EXPECT_EQ(f.stats.identities, 1u) << expr;
+    }
+}
+
+TEST(ConstantFolder, TimesZeroDropsPureOperand) {
+    auto f = fold("fn f(y: i32) { let x = (y + 2) * 0; }");
+    EXPECT_EQ(literal(f.firstInit()), "0");
+}
+
+TEST(ConstantFolder, TimesZeroKeepsCallsAndDivisions) {
+    auto f = fold("fn g() { return 1; } fn f(y: i32) { let x = g() * 0; let z = (1 / y) * 0; }");
+    auto* fn = static_cast<FnDeclNode*>(f.program->statements[1].get());
+    auto* body = static_cast<BlockNode*>(fn->body.get());
+    for (auto& stmt : body->statements) {
+        EXPECT_EQ(static_cast<LetStmtNode*>(stmt.get())->init->kind, NodeKind::BINARY_EXPR);
+    }
+}
+
+TEST(ConstantFolder, RequestExample) {
+    auto f = fold("fn f(y: i32) { let mut x = 0; x = 2 * 3 + y - 0; }");
+    auto* fn = static_cast<FnDeclNode*>(f.program->statements[0].get());
+    auto* body = static_cast<BlockNode*>(fn->body.get());
+    auto* stmt = static_cast<ExprStmtNode*>(body->statements[1].get());
+    auto* assign = static_cast<AssignExprNode*>(stmt->expr.get());
+    EXPECT_EQ(dump(assign->value.get()),
+              "BinaryExpr(\"+\")\n"
+              "  left:\n"
+              "    NumberLiteral(6)\n"
+              "  right:\n"
+              "    IdentExpr(\"y\")\n");
+    EXPECT_EQ(f.stats.constantsFolded, 1u);
+    EXPECT_EQ(f.stats.identities, 1u);
+}
+
+TEST(ConstantFolder, FoldsEverywhereInStatements) {
+    auto f = fold(R"(
+fn f(a: i32) {
+    while a < 1 + 1 { if 2 > 3 { return 4 * 5; } }
+    f(6 - 6);
+}
+)");
+    EXPECT_EQ(f.stats.constantsFolded, 4u);
+}
+
+// ============================================================
+// Passes fused into parsing
+// ============================================================
+
+struct PipelineResult {
+    std::unique_ptr<ProgramNode> program;
+    AstStats ast;
+    FoldStats folds;
+    std::vector<SemanticError> errors;
+    size_t exprsFolded = 0;  // fused only
+};
+
+// parse, count, check, fold (the fold only if the check passed).
+static PipelineResult separatePipeline(const std::string& src) {
+    PipelineResult r;
+    Parser parser(src);
+    r.program = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << src;
+    r.ast = collectAstStats(r.program.get());
+    SemanticAnalyzer analyzer(r.program.get());
+    if (!analyzer.analyze()) {
+        r.errors = analyzer.errors();
+        return r;
+    }
+    ConstantFolder folder(r.program.get());
+    folder.run();
+    r.folds = folder.stats();
+    return r;
+}
+
+static PipelineResult fusedPipeline(const std::string& src) {
+    PipelineResult r;
+    Parser parser(src);
+    ParseTimePasses passes(true);
+    parser.setListener(&passes);
+    r.program = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << src;
+    r.ast = passes.stats();
+    SemanticAnalyzer analyzer(r.program.get());
+    if (!analyzer.analyze()) {
+        r.errors = analyzer.errors();
+        return r;
+    }
+    ConstantFolder folder(r.program.get());
+    folder.runExprs(passes.exprsToFold());
+    r.folds = passes.foldStats();
+    r.folds.constantsFolded += folder.stats().constantsFolded;
+    r.folds.identities += folder.stats().identities;
+    r.exprsFolded = passes.exprsToFold().size();
+    return r;
+}
+
+static void expectSamePipelines(const std::string& src) {
+    PipelineResult a = separatePipeline(src);
+    PipelineResult b = fusedPipeline(src);
+    EXPECT_EQ(a.ast.nodes, b.ast.nodes) << src;
+    EXPECT_EQ(a.ast.functions, b.ast.functions) << src;
+    EXPECT_EQ(a.ast.calls, b.ast.calls) << src;
+    ASSERT_EQ(a.errors.size(), b.errors.size()) << src;
+    for (size_t i = 0; i < a.errors.size(); ++i) {
+        EXPECT_EQ(a.errors[i].message, b.errors[i].message) << src;
+        EXPECT_EQ(a.errors[i].line, b.errors[i].line) << src;
+    }
+    if (!a.errors.empty()) return;  // the trees only matter once checked
+    EXPECT_TRUE(astEqual(a.program.get(), b.program.get())) << src << "\n"
+        << dump(a.program.get()) << "---\n" << dump(b.program.get());
+    EXPECT_EQ(a.folds.constantsFolded, b.folds.constantsFolded) << src;
+    EXPECT_EQ(a.folds.identities, b.folds.identities) << src;
+}
+
+TEST(ParseTimePasses, SameResultsAsSeparatePasses) {
+    const char* programs[] = {
+        "fn f() { let x = 2 * 3 + 4 - 10 / 5; }",
+        "fn f() { let x = -(3 * 4); let y = --5; }",
+        "fn f() { return 1 < 2; }",
+        "fn f(y: i32) { let mut x = 0; x = 2 * 3 + y - 0; }",
+        "fn f(y: i32) { return (y * 0 + 1) * (7 - 7 + y); }",
+        "fn f(y: i32) { return (y + 1) * (2 * 1); }",
+        "fn g(a: i32) { return a / 1; } fn f() { g(9223372036854775807 + 1); g(1 / 0); }",
+        "fn f(a: i32) { while a < 1 + 1 { if 2 > 3 { return 4 * 5; } else { f(6 - 6); } } }",
+        "fn f() { fn g(x: i32) { return x * 1; } let z = g(2 + 2) * 0; }",
+        "let top = 10 * 10; fn f() { return top + 0; }",
+        "fn f(x: i32) -> i32 { let y = { x * 1 } + 0; -(y * 0) + (1 + 0) }",
+        "fn f(x: i32) -> i32 { match x - 0 { 1 => x * 1, _ => { 0 + x } } }",
+        "fn f(x: i32) { for i in 0 + 0..x * 1 { f(i / 1); } loop { return x + 0 * 2; } }",
+    };
+    for (const char* src : programs) expectSamePipelines(src);
+}
+
+TEST(ParseTimePasses, SameErrorsWhenAFoldWouldHideOne) {
+    // Folding "a" * 1 to "a" before checking would accept this program.
+    expectSamePipelines("fn f() { let s = \"a\" * 1; let t: bool = 1 + 2; }");
+    PipelineResult r = fusedPipeline("fn f() { let s = \"a\" * 1; }");
+    EXPECT_FALSE(r.errors.empty());
+}
+
+TEST(ParseTimePasses, OnlyExpressionsWithIdentitiesAreFoldedAfterChecking) {
+    PipelineResult r = fusedPipeline(
+        "fn a() { return 2 * 3; }\n"
+        "fn b(x: i32) { let y = x + 2; return y * 1; }\n"
+        "fn c(x: i32) { return x + 2; }\n");
+    ASSERT_TRUE(r.errors.empty());
+    EXPECT_EQ(r.exprsFolded, 1u);
+    EXPECT_EQ(r.folds.constantsFolded, 1u);
+    EXPECT_EQ(r.folds.identities, 1u);
+}
+
+TEST(ParseTimePasses, CountsWithoutFolding) {
+    Parser parser("fn f() { g(1 + 2); } fn g(x: i32) {}");
+    ParseTimePasses passes(false);
+    parser.setListener(&passes);
+    auto program = parser.parseProgram();
+    AstStats separate = collectAstStats(program.get());
+    EXPECT_EQ(passes.stats().nodes, separate.nodes);
+    EXPECT_EQ(passes.stats().functions, 2u);
+    EXPECT_EQ(passes.stats().calls, 1u);
+    EXPECT_EQ(passes.foldStats().constantsFolded, 0u);
+    EXPECT_TRUE(passes.exprsToFold().empty());
+}
+
+// Frame slots of every local declared, read or assigned, in tree order.
+static std::vector<uint32_t> localSlots(const ProgramNode* program) {
+    struct Collector : AstVisitor<Collector> {
+        std::vector<uint32_t> slots;
+        bool enterLetStmt(const LetStmtNode* n) {
+            slots.push_back(n->slot);
+            return true;
+        }
+        bool enterForStmt(const ForStmtNode* n) {
+            slots.push_back(n->slot);
+            return true;
+        }
+        bool enterIdentExpr(const IdentExprNode* n) {
+            slots.push_back(n->slot);
+            return true;
+        }
+        bool enterAssignExpr(const AssignExprNode* n) {
+            slots.push_back(n->slot);
+            return true;
+        }
+    } collector;
+    collector.walk(program);
+    return collector.slots;
+}
+
+TEST(ParseTimePasses, ResolvesLocalsAsTheInterpreterDoes) {
+    const char* programs[] = {
+        "fn f(a: i64, b: i64) -> i64 { let c = a + b; c = c * 2; { let d = c; c = d + a; } "
+        "let e = c; for i in 0..e { c = c + i; } match c { 1 => a, _ => { let g = b; g } } }",
+        "fn f(x: i64, y: i64) -> i64 { let x = x + 1; let x = x * y; x }",
+        "fn f(x: i64, y: i64) -> i64 { let y = x; fn g(x: i64) -> i64 { x + 1 } g(y) }",
+    };
+    for (const char* src : programs) {
+        Parser plain(src);
+        auto separate = plain.parseProgram();
+        Interpreter separateInterp(separate.get());
+        ASSERT_FALSE(separateInterp.hasErrors()) << src;
+
+        Parser parser(src);
+        ParseTimePasses passes(false, true);
+        parser.setListener(&passes);
+        auto fused = parser.parseProgram();
+        ASSERT_FALSE(parser.hasErrors()) << src;
+        EXPECT_EQ(localSlots(fused.get()), localSlots(separate.get())) << src;
+
+        Interpreter fusedInterp(fused.get());
+        EXPECT_FALSE(fusedInterp.hasErrors()) << src;
+        int64_t expected = 0, actual = 0;
+        ASSERT_TRUE(separateInterp.call("f", {3, 4}, expected)) << src;
+        ASSERT_TRUE(fusedInterp.call("f", {3, 4}, actual)) << src;
+        EXPECT_EQ(actual, expected) << src;
+    }
+
+    // `a`, `b`, `c`, then `e` (after `d` is released) and `i`; `g` reuses
+    // the slot of `i`.
+    Parser parser(programs[0]);
+    ParseTimePasses passes(false, true);
+    parser.setListener(&passes);
+    auto program = parser.parseProgram();
+    EXPECT_EQ(static_cast<FnDeclNode*>(program->statements[0].get())->frameSlots, 5u);
+}
+
+TEST(ParseTimePasses, FramesTheInterpreterMustResolveAreLeftUnset) {
+    struct Case {
+        const char* src;
+        const char* error;
+    };
+    const Case cases[] = {
+        // `g` in the inner block is the function declared there, not the parameter.
+        {"fn f(g: i64) -> i64 { { fn g() -> i64 { 2 } g } }", "Cannot evaluate 'g' as a value"},
+        // Calling a local.
+        {"fn g() -> i64 { 1 } fn f(g: i64) -> i64 { g() }", "Cannot call 'g'"},
+    };
+    for (const Case& c : cases) {
+        Parser parser(c.src);
+        ParseTimePasses passes(false, true);
+        parser.setListener(&passes);
+        auto program = parser.parseProgram();
+        ASSERT_FALSE(parser.hasErrors()) << c.src;
+        auto* f = static_cast<FnDeclNode*>(program->statements.back().get());
+        EXPECT_EQ(f->frameSlots, NO_SLOT) << c.src;
+        Interpreter interp(program.get());
+        ASSERT_TRUE(interp.hasErrors()) << c.src;
+        EXPECT_EQ(interp.errors()[0].message, c.error) << c.src;
+    }
+}
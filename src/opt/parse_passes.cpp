@@ -0,0 +1,242 @@
+#include "parse_passes.h"
+#include "../ast/ast_visitor.h"
+
+// ============================================================
+// AstStats
+// ============================================================
+
+void AstStats::count(const AstNode* node) {
+    nodes++;
+    if (node->kind == NodeKind::FN_DECL) functions++;
+    else if (node->kind == NodeKind::CALL_EXPR) calls++;
+}
+
+namespace {
+
+struct StatsCollector : AstVisitor<StatsCollector> {
+    AstStats stats;
+
+    bool enter(const AstNode* node) {
+        stats.count(node);
+        return true;
+    }
+};
+
+}  // namespace
+
+AstStats collectAstStats(const AstNode* root) {
+    StatsCollector collector;
+    collector.walk(root);
+    return collector.stats;
+}
+
+// ============================================================
+// ParseTimePasses
+// ============================================================
+
+ParseTimePasses::ParseTimePasses(bool fold, bool resolve)
+    : fold_(fold), resolve_(resolve), folder_(nullptr) {}
+
+void ParseTimePasses::onNodeBuilt(AstNodePtr& node) {
+    stats_.count(node.get());
+    // Literals are the commonest nodes and none of the passes acts on them.
+    if (node->kind == NodeKind::NUMBER_LITERAL || node->kind == NodeKind::STRING_LITERAL) return;
+    if (fold_) {
+        folder_.foldLiterals(node);
+        noteIdentities(node.get());
+    }
+    if (resolve_) resolve(node.get());
+}
+
+void ParseTimePasses::onScopeEntered(AstNode& node) {
+    if (!resolve_) return;
+    switch (node.kind) {
+        case NodeKind::FN_DECL:
+            frames_.push_back(Frame{fnBase_, nextSlot_, maxSlots_, complete_});
+            fnBase_ = scopes_.size();
+            nextSlot_ = 0;
+            maxSlots_ = 0;
+            complete_ = true;
+            scopes_.enterScope();
+            for (const auto& param : static_cast<FnDeclNode&>(node).params) {
+                scopes_.declare(param.name, newSlot());
+            }
+            break;
+        case NodeKind::BLOCK:
+            marks_.push_back(nextSlot_);
+            scopes_.enterScope();
+            break;
+        case NodeKind::FOR_STMT: {
+            auto& loop = static_cast<ForStmtNode&>(node);
+            marks_.push_back(nextSlot_);
+            scopes_.enterScope();
+            if (!frames_.empty()) {
+                loop.slot = newSlot();
+                scopes_.declare(loop.name, loop.slot);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+const AstStats& ParseTimePasses::stats() const {
+    return stats_;
+}
+
+const FoldStats& ParseTimePasses::foldStats() const {
+    return folder_.stats();
+}
+
+const std::vector<AstNodePtr*>& ParseTimePasses::exprsToFold() const {
+    return exprsToFold_;
+}
+
+// ============================================================
+// Identities left for after checking
+// ============================================================
+
+// True if an operator in the chain rooted at `node` (binary and unary
+// operators down to their first other operand) may fold as an identity.
+static bool chainMayFoldIdentity(const AstNode* node) {
+    if (!node) return false;
+    if (node->kind == NodeKind::UNARY_EXPR) {
+        return chainMayFoldIdentity(static_cast<const UnaryExprNode*>(node)->operand.get());
+    }
+    if (node->kind != NodeKind::BINARY_EXPR) return false;
+    auto* n = static_cast<const BinaryExprNode*>(node);
+    return ConstantFolder::mayFoldIdentity(n) || chainMayFoldIdentity(n->left.get()) ||
+           chainMayFoldIdentity(n->right.get());
+}
+
+void ParseTimePasses::noteIdentity(AstNodePtr& slot) {
+    if (chainMayFoldIdentity(slot.get())) exprsToFold_.push_back(&slot);
+}
+
+// Checks the expression slots of `node` that ConstantFolder::run() folds.
+// Every slot the parser fills is one run() reaches, and the operator nodes
+// between them are complete (their literals folded) once a node that is
+// not an operator holds them, so that is where a chain is checked. Its
+// slot stays put: the holder is a heap node, already final.
+void ParseTimePasses::noteIdentities(AstNode* node) {
+    switch (node->kind) {
+        case NodeKind::BLOCK:
+            noteIdentity(static_cast<BlockNode*>(node)->value);
+            break;
+        case NodeKind::LET_STMT:
+            noteIdentity(static_cast<LetStmtNode*>(node)->init);
+            break;
+        case NodeKind::RETURN_STMT:
+            noteIdentity(static_cast<ReturnStmtNode*>(node)->value);
+            break;
+        case NodeKind::WHILE_STMT:
+            noteIdentity(static_cast<WhileStmtNode*>(node)->condition);
+            break;
+        case NodeKind::FOR_STMT:
+            noteIdentity(static_cast<ForStmtNode*>(node)->iterable);
+            break;
+        case NodeKind::IF_STMT:
+            noteIdentity(static_cast<IfStmtNode*>(node)->condition);
+            break;
+        case NodeKind::EXPR_STMT:
+            noteIdentity(static_cast<ExprStmtNode*>(node)->expr);
+            break;
+        case NodeKind::ASSIGN_EXPR:
+            noteIdentity(static_cast<AssignExprNode*>(node)->value);
+            break;
+        case NodeKind::CALL_EXPR:
+            for (auto& arg : static_cast<CallExprNode*>(node)->args) noteIdentity(arg);
+            break;
+        case NodeKind::FIELD_EXPR:
+            noteIdentity(static_cast<FieldExprNode*>(node)->object);
+            break;
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto* n = static_cast<MethodCallExprNode*>(node);
+            noteIdentity(n->receiver);
+            for (auto& arg : n->args) noteIdentity(arg);
+            break;
+        }
+        case NodeKind::MATCH_EXPR:
+            noteIdentity(static_cast<MatchExprNode*>(node)->scrutinee);
+            break;
+        case NodeKind::MATCH_ARM:
+            noteIdentity(static_cast<MatchArmNode*>(node)->body);
+            break;
+        default:
+            break;
+    }
+}
+
+// ============================================================
+// Local slots
+// ============================================================
+//
+// Mirrors Interpreter's resolution of locals: parameters take the first
+// slots, a `let` is bound after its initializer, and the slots of a block
+// or `for` loop are released when it ends. Outside a function nothing is
+// bound.
+
+void ParseTimePasses::resolve(AstNode* node) {
+    switch (node->kind) {
+        case NodeKind::FN_DECL: {
+            if (complete_) static_cast<FnDeclNode*>(node)->frameSlots = maxSlots_;
+            scopes_.exitScope();
+            const Frame& outer = frames_.back();
+            fnBase_ = outer.fnBase;
+            nextSlot_ = outer.nextSlot;
+            maxSlots_ = outer.maxSlots;
+            complete_ = outer.complete;
+            frames_.pop_back();
+            // The Interpreter binds a nested function at the start of its
+            // block, ahead of locals declared before it.
+            if (!frames_.empty()) complete_ = false;
+            break;
+        }
+        case NodeKind::BLOCK:
+        case NodeKind::FOR_STMT:
+            scopes_.exitScope();
+            nextSlot_ = marks_.back();
+            marks_.pop_back();
+            break;
+        case NodeKind::LET_STMT:
+            if (!frames_.empty()) {
+                auto* let = static_cast<LetStmtNode*>(node);
+                let->slot = newSlot();
+                scopes_.declare(let->name, let->slot);
+            }
+            break;
+        case NodeKind::IDENT_EXPR: {
+            auto* n = static_cast<IdentExprNode*>(node);
+            uint32_t slot = findLocal(n->name);
+            if (slot != NO_SLOT) n->slot = slot;
+            break;
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<AssignExprNode*>(node);
+            uint32_t slot = findLocal(n->target);
+            if (slot != NO_SLOT) n->slot = slot;
+            break;
+        }
+        case NodeKind::CALL_EXPR:
+            // Rejected by the Interpreter, which needs the locals for that.
+            if (findLocal(static_cast<CallExprNode*>(node)->callee) != NO_SLOT) complete_ = false;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t ParseTimePasses::newSlot() {
+    uint32_t slot = nextSlot_++;
+    if (nextSlot_ > maxSlots_) maxSlots_ = nextSlot_;
+    return slot;
+}
+
+// The slot of `name` if it is a local of the function being parsed, else NO_SLOT.
+uint32_t ParseTimePasses::findLocal(const std::string& name) const {
+    if (frames_.empty()) return NO_SLOT;
+    uint32_t index = scopes_.lookup(name);
+    if (index == ScopeTable<uint32_t>::NONE || index < fnBase_) return NO_SLOT;
+    return scopes_.binding(index).symbol;
+}
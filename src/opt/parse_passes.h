@@ -0,0 +1,99 @@
+#ifndef PARSE_PASSES_H
+#define PARSE_PASSES_H
+
+#include "../ast/ast.h"
+#include "../parser/parser.h"
+#include "../semantic/scope_table.h"
+#include "const_fold.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// AstStats — node counts of the tree as parsed (--stats)
+// ============================================================
+struct AstStats {
+    uint64_t nodes = 0;
+    uint64_t functions = 0;
+    uint64_t calls = 0;
+
+    void count(const AstNode* node);
+};
+
+// Counts a whole tree in a separate walk.
+AstStats collectAstStats(const AstNode* root);
+
+// ============================================================
+// ParseTimePasses — per-node passes fused into parsing
+// ============================================================
+//
+// A ParseListener that runs, on each node as the parser finishes it:
+//   - AstStats counting, which needs nothing but the node;
+//   - with `fold`, ConstantFolder::foldLiterals(), the folds that are safe
+//     before semantic analysis, and a note of each expression slot whose
+//     operator chain still holds an identity fold
+//     (ConstantFolder::mayFoldIdentity) that needs checked types;
+//   - with `resolve`, the Interpreter's frame slots for locals: parameters
+//     and `let`s are declared in source order, so a `let`, a `for` loop
+//     and a name read or assigned inside a function get their slot as soon
+//     as they are built, and the function its frame size
+//     (FnDeclNode::frameSlots). The Interpreter then only resolves its
+//     calls, literals and matches.
+//
+// After semantic analysis, ConstantFolder::runExprs(exprsToFold()) finishes
+// the folding. The tree, the fold counts (foldStats() plus the folder's) and
+// stats() are then the same as parsing, collectAstStats() and
+// ConstantFolder::run() separately, and the analyzer reports the same
+// errors: the folds done early only turn an int operation on literals into
+// an int literal, or a comparison into `true` / `false`.
+//
+// Calls are not resolved: a function item is visible throughout its block,
+// before its declaration too. A function with a nested function, or a call
+// to a name that is one of its locals, gets no frameSlots, and the
+// Interpreter resolves it as if nothing had been set.
+class ParseTimePasses : public ParseListener {
+public:
+    explicit ParseTimePasses(bool fold, bool resolve = false);
+
+    void onNodeBuilt(AstNodePtr& node) override;
+    void onScopeEntered(AstNode& node) override;
+
+    const AstStats& stats() const;
+    const FoldStats& foldStats() const;
+
+    // Expression slots ConstantFolder::runExprs() still has work in, in the
+    // nodes of the tree being built.
+    const std::vector<AstNodePtr*>& exprsToFold() const;
+
+private:
+    struct Frame {
+        uint32_t fnBase;
+        uint32_t nextSlot;
+        uint32_t maxSlots;
+        bool complete;
+    };
+
+    bool fold_;
+    bool resolve_;
+    AstStats stats_;
+    ConstantFolder folder_;
+    std::vector<AstNodePtr*> exprsToFold_;
+
+    // Resolution; as in Interpreter, bindings from fnBase_ on are the
+    // current function's locals, each symbol its frame slot.
+    ScopeTable<uint32_t> scopes_;
+    std::vector<Frame> frames_;    // the enclosing functions'
+    std::vector<uint32_t> marks_;  // nextSlot_ at each open block or `for`
+    uint32_t fnBase_ = 0;
+    uint32_t nextSlot_ = 0;
+    uint32_t maxSlots_ = 0;
+    bool complete_ = false;        // the current function can keep its slots
+
+    void noteIdentities(AstNode* node);
+    void noteIdentity(AstNodePtr& slot);
+    void resolve(AstNode* node);
+    uint32_t newSlot();
+    uint32_t findLocal(const std::string& name) const;
+};
+
+#endif // PARSE_PASSES_H
@@ -0,0 +1,241 @@
+#include "incremental.h"
+#include "../ast/ast_visitor.h"
+#include <algorithm>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// How much of an item's start firstTokenEndsBefore() lexes; a longer first
+// token counts as reaching the edit, which only makes the region bigger.
+static constexpr size_t FIRST_TOKEN_WINDOW = 256;
+
+// True if lexing the token at `begin` reads nothing at or past `pos`.
+static bool firstTokenEndsBefore(const std::string& source, size_t begin, size_t pos) {
+    Lexer lexer(source.substr(begin, std::min(pos - begin, FIRST_TOKEN_WINDOW)));
+    Token tok = lexer.nextToken();
+    return tok.offset + tok.length + Lexer::MAX_LOOKAHEAD <= lexer.text().size();
+}
+
+// Line of each of `offsets` (ascending, relative to `base`), where `base`
+// is on line `line`.
+static std::vector<int> linesAt(const std::string& source, size_t base, int line,
+                                const std::vector<size_t>& offsets) {
+    std::vector<int> lines;
+    lines.reserve(offsets.size());
+    size_t pos = base;
+    for (size_t off : offsets) {
+        line += static_cast<int>(
+            std::count(source.begin() + pos, source.begin() + base + off, '\n'));
+        pos = base + off;
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// Replaces [first, last) of `v` with `with`.
+template <typename T>
+static void splice(std::vector<T>& v, size_t first, size_t last, std::vector<T>&& with) {
+    v.erase(v.begin() + first, v.begin() + last);
+    v.insert(v.begin() + first, std::make_move_iterator(with.begin()),
+             std::make_move_iterator(with.end()));
+}
+
+namespace {
+
+// Adds `delta` to the line of every node (and parameter or field) in a subtree.
+struct LineShifter : AstVisitor<LineShifter, AstNode> {
+    int delta;
+
+    explicit LineShifter(int d) : delta(d) {}
+
+    bool enter(AstNode* node) {
+        node->line += delta;
+        return true;
+    }
+
+    bool enterFnDecl(FnDeclNode* n) {
+        for (auto& p : n->params) p.line += delta;
+        return enter(n);
+    }
+
+    bool enterStructDecl(StructDeclNode* n) {
+        for (auto& f : n->fields) f.line += delta;
+        return enter(n);
+    }
+};
+
+}  // namespace
+
+// ============================================================
+// Public API
+// ============================================================
+
+IncrementalParser::IncrementalParser(std::string source)
+    : source_(std::move(source)) {
+    fullParse();
+}
+
+const std::string& IncrementalParser::source() const {
+    return source_;
+}
+
+ProgramNode* IncrementalParser::program() const {
+    for (size_t i = 0; i < pendingLines_.size(); ++i) item(i);
+    return program_.get();
+}
+
+size_t IncrementalParser::itemCount() const {
+    return program_->statements.size();
+}
+
+AstNode* IncrementalParser::item(size_t index) const {
+    AstNode* node = program_->statements[index].get();
+    if (pendingLines_[index] != 0) {
+        LineShifter(pendingLines_[index]).walk(node);
+        pendingLines_[index] = 0;
+    }
+    return node;
+}
+
+bool IncrementalParser::hasErrors() const {
+    return !errors_.empty();
+}
+
+const std::vector<ParseError>& IncrementalParser::errors() const {
+    return errors_;
+}
+
+bool IncrementalParser::lastEditWasIncremental() const {
+    return lastIncremental_;
+}
+
+size_t IncrementalParser::lastReparsedItems() const {
+    return lastReparsed_;
+}
+
+void IncrementalParser::applyEdit(const TextEdit& edit) {
+    TextEdit e = edit;
+    e.end = std::min(e.end, source_.size());
+    e.begin = std::min(e.begin, e.end);
+
+    size_t removedNewlines = static_cast<size_t>(
+        std::count(source_.begin() + e.begin, source_.begin() + e.end, '\n'));
+    source_.replace(e.begin, e.end - e.begin, e.replacement);
+
+    // A parse cut short at a limit has no items for the rest of the source.
+    lastIncremental_ = !stoppedEarly_ && !itemOffsets_.empty() &&
+                       reparseRegion(e, removedNewlines);
+    if (!lastIncremental_) {
+        fullParse();
+    }
+}
+
+// ============================================================
+// Reparsing
+// ============================================================
+
+void IncrementalParser::fullParse() {
+    Parser parser(source_);
+    program_ = parser.parseProgram();
+    errors_ = parser.errors();
+    itemOffsets_ = parser.itemOffsets();
+    itemLines_ = linesAt(source_, 0, 1, itemOffsets_);
+    itemErrors_ = parser.itemDiagnostics();
+    pendingLines_.assign(itemOffsets_.size(), 0);
+    stoppedEarly_ = parser.stoppedEarly();
+    lastReparsed_ = program_->statements.size();
+}
+
+// `source_` already holds the edited text; the per-item state and program_
+// still describe the old one. Returns false (leaving them untouched) if the
+// region reparse cannot be guaranteed to match a full parse.
+bool IncrementalParser::reparseRegion(const TextEdit& edit, size_t removedNewlines) {
+    const size_t count = itemOffsets_.size();
+    const long long delta = static_cast<long long>(edit.replacement.size()) -
+                            static_cast<long long>(edit.end - edit.begin);
+    const int lineDelta =
+        static_cast<int>(std::count(edit.replacement.begin(), edit.replacement.end(), '\n')) -
+        static_cast<int>(removedNewlines);
+
+    // The region starts at the last item starting at or before the edit. The
+    // items ahead of it must parse as they did, so the edit has to stay clear
+    // of all they read: up to and including the region's first token, plus
+    // the lexer's lookahead. Back up an item at a time until it does; with
+    // none left the region starts at offset 0, taking the leading errors.
+    size_t first = static_cast<size_t>(
+        std::upper_bound(itemOffsets_.begin(), itemOffsets_.end(), edit.begin) -
+        itemOffsets_.begin());
+    while (first > 0 && !firstTokenEndsBefore(source_, itemOffsets_[first - 1], edit.begin)) {
+        --first;
+    }
+    const bool atItem = first > 0;
+    size_t regionBegin = 0;
+    int firstLine = 1;
+    size_t errorsBegin = 0;
+    if (atItem) {
+        --first;
+        regionBegin = itemOffsets_[first];
+        firstLine = itemLines_[first];
+        errorsBegin = itemErrors_[first];
+    }
+
+    // The first item starting past the edit, where the reparse should stop.
+    // The text from there on is unchanged, so once the parser is about to
+    // start a statement at that token, the rest parses as it did. The region
+    // takes in that item and the lookahead after it to lex its first token.
+    size_t last = static_cast<size_t>(
+        std::upper_bound(itemOffsets_.begin() + first, itemOffsets_.end(), edit.end) -
+        itemOffsets_.begin());
+    size_t regionEnd = source_.size();
+    if (last + 1 < count) {
+        size_t guardEnd = static_cast<size_t>(
+            static_cast<long long>(itemOffsets_[last + 1]) + delta) + Lexer::MAX_LOOKAHEAD;
+        regionEnd = std::min(regionEnd, guardEnd);
+    }
+
+    Parser parser(source_.substr(regionBegin, regionEnd - regionBegin), firstLine);
+    if (last < count) parser.setStopOffset(itemOffsets_[last] + delta - regionBegin);
+    // Invalid UTF-8 in the region's first token is reported as the parser
+    // reads it, before the first statement. When the region starts at an
+    // item, the full parse reported it (or an earlier sequence in the trivia
+    // before it) ahead of that item, where the error is kept.
+    size_t leading = atItem ? parser.diagnostics().size() : 0;
+    auto region = parser.parseProgram();
+    if (parser.stoppedEarly()) return false;
+    if (last < count && !parser.reachedStopOffset()) return false;
+
+    // Shift the kept items after the region; their nodes catch up on access.
+    size_t errorsEnd = (last < count) ? itemErrors_[last] : errors_.size();
+    std::vector<ParseError> regionErrors(parser.errors().begin() + leading,
+                                         parser.errors().end());
+    long long errorDelta = static_cast<long long>(regionErrors.size()) -
+                           static_cast<long long>(errorsEnd - errorsBegin);
+    for (size_t i = last; i < count; ++i) {
+        itemOffsets_[i] += delta;
+        itemLines_[i] += lineDelta;
+        itemErrors_[i] += errorDelta;
+        pendingLines_[i] += lineDelta;
+    }
+    if (lineDelta != 0) {
+        for (size_t i = errorsEnd; i < errors_.size(); ++i) errors_[i].line += lineDelta;
+    }
+
+    // Splice the reparsed items and their errors in place of [first, last).
+    std::vector<size_t> offsets = parser.itemOffsets();
+    std::vector<int> lines = linesAt(source_, regionBegin, firstLine, offsets);
+    std::vector<size_t> itemErrors = parser.itemDiagnostics();
+    for (auto& off : offsets) off += regionBegin;
+    for (auto& index : itemErrors) index = index - leading + errorsBegin;
+    const size_t reparsed = offsets.size();
+
+    splice(program_->statements, first, last, std::move(region->statements));
+    splice(errors_, errorsBegin, errorsEnd, std::move(regionErrors));
+    splice(itemOffsets_, first, last, std::move(offsets));
+    splice(itemLines_, first, last, std::move(lines));
+    splice(itemErrors_, first, last, std::move(itemErrors));
+    splice(pendingLines_, first, last, std::vector<int>(reparsed, 0));
+
+    lastReparsed_ = reparsed;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "../ast/ast.h"
+#include "../lexer/lexer.h"
+#include "parser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================
+// IncrementalParser — keeps a ProgramNode in sync with a source
+// buffer under text edits, reparsing only the affected items
+// ============================================================
+//
+// Each top-level item owns the source from its first token up to the next
+// item's first token, and the errors recorded while parsing that span. An
+// edit reparses from the item it lands in until the parser is about to start
+// a statement exactly where an untouched later item starts: a top-level
+// statement starts in the same state wherever it is, so everything from there
+// on parses as before and is kept with its offsets shifted. That holds whether
+// or not the items involved have errors. Kept items record the line shift owed
+// to their nodes and apply it when next accessed. When the reparse never lines
+// up with a later item (a new unterminated comment, ...) it falls back to a
+// full parse, so the result always equals Parser(source()).parseProgram().
+class IncrementalParser {
+public:
+    explicit IncrementalParser(std::string source);
+
+    // Replaces [edit.begin, edit.end) of source() with edit.replacement
+    // and updates the tree. Out-of-range edits are clamped to the source.
+    void applyEdit(const TextEdit& edit);
+
+    const std::string& source() const;
+    // The whole tree, with every item's line numbers brought up to date.
+    ProgramNode* program() const;
+    // One top-level item, with only its line numbers brought up to date.
+    size_t itemCount() const;
+    AstNode* item(size_t index) const;
+    bool hasErrors() const;
+    const std::vector<ParseError>& errors() const;
+
+    // True if the last applyEdit() reparsed only the touched items.
+    bool lastEditWasIncremental() const;
+    // Number of top-level items reparsed by the last applyEdit().
+    size_t lastReparsedItems() const;
+
+private:
+    std::string source_;
+    std::unique_ptr<ProgramNode> program_;
+    std::vector<ParseError> errors_;
+    // Per item, in step with program_->statements:
+    std::vector<size_t> itemOffsets_;        // offset of its first token
+    std::vector<int> itemLines_;             // line of its first token
+    std::vector<size_t> itemErrors_;         // index of its first error in errors_
+    mutable std::vector<int> pendingLines_;  // line shift not yet applied to its nodes
+    bool stoppedEarly_ = false;
+    bool lastIncremental_ = false;
+    size_t lastReparsed_ = 0;
+
+    void fullParse();
+    bool reparseRegion(const TextEdit& edit, size_t removedNewlines);
+};
+
+#endif // INCREMENTAL_H
@@ -1,11 +1,14 @@
 #include "parser.h"
+#include "../lexer/literal.h"
+#include "../lexer/unicode.h"
+#include <algorithm>
 #include <stdexcept>
 
 // ============================================================
 // Constructor — prime the two-token lookahead
 // ============================================================
-Parser::Parser(const std::string& source)
-    : lexer_(source),
+Parser::Parser(const std::string& source, int firstLine)
+    : lexer_(source, firstLine),
       current_(Token{TokenType::EOF_TOKEN, "", 0}),
       peek_(Token{TokenType::EOF_TOKEN, "", 0}) {
     // Call advance() twice to fill current_ and peek_.
@@ -18,8 +21,13 @@ Parser::Parser(const std::string& source)
 // ============================================================
 
 void Parser::advance() {
+    if (stopped_) return;
+    if (current_.type != TokenType::EOF_TOKEN) {
+        lastTokenEnd_ = current_.offset + current_.length;
+    }
     current_ = peek_;
     peek_ = lexer_.nextToken();
+    if (current_.flags & TOKEN_BAD_UTF8) reportInvalidUtf8();
 }
 
 bool Parser::check(TokenType type) const {
@@ -34,13 +42,13 @@ bool Parser::match(TokenType type) {
     return false;
 }
 
-Token Parser::expect(TokenType type, const std::string& errorMsg) {
+Token Parser::expect(TokenType type, DiagCode error) {
     if (check(type)) {
         Token tok = current_;
         advance();
         return tok;
     }
-    recordError(errorMsg, current_.line);
+    recordError(error);
     return current_;  // Return current so parsing can attempt to continue
 }
 
@@ -48,11 +56,40 @@ Token Parser::expect(TokenType type, const std::string& errorMsg) {
 // Error handling
 // ============================================================
 
-void Parser::recordError(const std::string& msg, int line) {
-    errors_.push_back(ParseError{msg, line});
+// Only the first error of a statement is kept: the parser's later
+// complaints until the next statement starts (a missing ')', then a missing
+// ';', ...) are usually consequences of it.
+void Parser::recordError(DiagCode code, uint32_t arg) {
+    if (stopped_ || recovering_) return;
+    recovering_ = true;
+    needsSync_ = true;
+    diagnostics_.push_back(Diagnostic{code, current_.line, static_cast<uint32_t>(current_.offset),
+                                      static_cast<uint32_t>(current_.length), arg});
+    if (maxErrors_ && diagnostics_.size() >= maxErrors_) stop();
+}
+
+// Invalid UTF-8 is a lexical error outside the grammar: the lexer drops the
+// bytes (or keeps them in a string) and parsing goes on undisturbed, so it
+// is reported however the statement fares. The token only says there is
+// some between the previous token's end and its own; find the first.
+void Parser::reportInvalidUtf8() {
+    if (stopped_) return;
+    const std::string& source = lexer_.text();
+    size_t tokenEnd = current_.offset + current_.length;
+    size_t from = std::min(lastTokenEnd_, current_.offset);
+    size_t length = 0;
+    size_t at = from + findInvalidUtf8(std::string_view(source).substr(from, tokenEnd - from),
+                                       length);
+    if (at >= tokenEnd) return;
+    int line = current_.line - static_cast<int>(
+        std::count(source.begin() + at, source.begin() + tokenEnd, '\n'));
+    diagnostics_.push_back(Diagnostic{DiagCode::INVALID_UTF8, line, static_cast<uint32_t>(at),
+                                      static_cast<uint32_t>(length), 0});
+    if (maxErrors_ && diagnostics_.size() >= maxErrors_) stop();
 }
 
 void Parser::synchronize() {
+    needsSync_ = false;
     // Skip tokens until we find a likely statement boundary
     while (!check(TokenType::EOF_TOKEN)) {
         if (check(TokenType::SEMICOLON)) {
@@ -63,27 +100,102 @@ void Parser::synchronize() {
             return;  // do NOT consume — let the enclosing block handle it
         }
         // Statement-keyword boundaries
-        if (check(TokenType::FN) || check(TokenType::LET) ||
-            check(TokenType::RETURN) || check(TokenType::WHILE) ||
-            check(TokenType::IF)) {
-            return;
+        switch (current_.type) {
+            case TokenType::FN:
+            case TokenType::STRUCT:
+            case TokenType::IMPL:
+            case TokenType::LET:
+            case TokenType::RETURN:
+            case TokenType::WHILE:
+            case TokenType::LOOP:
+            case TokenType::FOR:
+            case TokenType::BREAK:
+            case TokenType::CONTINUE:
+            case TokenType::IF:
+            case TokenType::MATCH:
+                return;
+            default:
+                break;
         }
         advance();
     }
 }
 
+// Called by statement lists after each statement. One that stopped at an
+// error without synchronizing would otherwise leave its tail to be parsed
+// (and reported) as more statements.
+void Parser::endStatement() {
+    if (needsSync_) synchronize();
+}
+
+// Ends the parse: the rest of the input reads as end of file, so every
+// loop and recursion unwinds without consuming or reporting anything more.
+void Parser::stop() {
+    stopped_ = true;
+    current_ = Token{TokenType::EOF_TOKEN, "", current_.line, 0, current_.offset, 0};
+    peek_ = current_;
+}
+
+bool Parser::enter() {
+    if (++depth_ <= MAX_NESTING) return true;
+    recordError(DiagCode::NESTING_TOO_DEEP, MAX_NESTING);
+    stop();
+    return false;
+}
+
 // ============================================================
 // Public API
 // ============================================================
 
 bool Parser::hasErrors() const {
-    return !errors_.empty();
+    return !diagnostics_.empty();
+}
+
+const std::vector<Diagnostic>& Parser::diagnostics() const {
+    return diagnostics_;
 }
 
 const std::vector<ParseError>& Parser::errors() const {
+    for (; formatted_ < diagnostics_.size(); ++formatted_) {
+        const Diagnostic& d = diagnostics_[formatted_];
+        errors_.push_back(ParseError{formatDiagnostic(d, lexer_.text()), d.line});
+    }
     return errors_;
 }
 
+bool Parser::stoppedEarly() const {
+    return stopped_;
+}
+
+void Parser::setMaxErrors(size_t max) {
+    maxErrors_ = max;
+}
+
+const std::vector<size_t>& Parser::itemOffsets() const {
+    return itemOffsets_;
+}
+
+const std::vector<size_t>& Parser::itemDiagnostics() const {
+    return itemDiagnostics_;
+}
+
+void Parser::setStopOffset(size_t offset) {
+    stopOffset_ = offset;
+}
+
+bool Parser::reachedStopOffset() const {
+    return reachedStop_;
+}
+
+void Parser::setListener(ParseListener* listener) {
+    listener_ = listener;
+}
+
+AstNodePtr Parser::built(AstNodePtr node) {
+    if (listener_ && node) listener_->onNodeBuilt(node);
+    return node;
+}
+
 // ============================================================
 // Top-level
 // ============================================================
@@ -91,11 +203,32 @@ const std::vector<ParseError>& Parser::errors() const {
 std::unique_ptr<ProgramNode> Parser::parseProgram() {
     auto program = std::make_unique<ProgramNode>();
     while (!check(TokenType::EOF_TOKEN)) {
+        size_t offset = current_.offset;
+        if (offset == stopOffset_) {
+            reachedStop_ = true;
+            break;
+        }
+        size_t diagnostics = diagnostics_.size();
         auto stmt = parseStatement();
         if (stmt) {
             program->statements.push_back(std::move(stmt));
+            itemOffsets_.push_back(offset);
+            itemDiagnostics_.push_back(diagnostics);
+            if (listener_) listener_->onItemBuilt(program->statements.size() - 1);
+        }
+        endStatement();
+        // synchronize() stops at '}' without consuming it; at top level no
+        // block will. Skipping any token a statement left unconsumed keeps
+        // the loop linear in the input.
+        if (current_.offset == offset) {
+            advance();
         }
     }
+    if (listener_) {
+        AstNodePtr root(program.release());
+        listener_->onNodeBuilt(root);
+        program.reset(static_cast<ProgramNode*>(root.release()));
+    }
     return program;
 }
 
@@ -104,57 +237,245 @@ std::unique_ptr<ProgramNode> Parser::parseProgram() {
 // ============================================================
 
 AstNodePtr Parser::parseStatement() {
-    if (check(TokenType::FN))     return parseFnDecl();
-    if (check(TokenType::LET))    return parseLetStmt();
-    if (check(TokenType::RETURN)) return parseReturnStmt();
-    if (check(TokenType::WHILE))  return parseWhileStmt();
-    if (check(TokenType::IF))     return parseIfStmt();
-    if (check(TokenType::LBRACE)) return parseBlock();
-    return parseExprStmt();
+    if (!enter()) return nullptr;
+    recovering_ = false;
+    needsSync_ = false;
+    AstNodePtr stmt;
+    switch (current_.type) {
+        case TokenType::FN:       stmt = parseFnDecl(); break;
+        case TokenType::STRUCT:   stmt = parseStructDecl(); break;
+        case TokenType::IMPL:     stmt = parseImplBlock(); break;
+        case TokenType::LET:      stmt = parseLetStmt(); break;
+        case TokenType::RETURN:   stmt = parseReturnStmt(); break;
+        case TokenType::WHILE:    stmt = parseWhileStmt(); break;
+        case TokenType::LOOP:     stmt = parseLoopStmt(); break;
+        case TokenType::FOR:      stmt = parseForStmt(); break;
+        case TokenType::BREAK:
+        case TokenType::CONTINUE: stmt = parseBreakOrContinue(); break;
+        case TokenType::IF:       stmt = parseIf(); break;
+        case TokenType::LBRACE:   stmt = parseBlock(); break;
+        default:                  stmt = parseExprStmt(); break;
+    }
+    leave();
+    return stmt;
 }
 
 AstNodePtr Parser::parseFnDecl() {
     int line = current_.line;
     advance();  // consume FN
 
-    Token nameTok = expect(TokenType::IDENT, "Expected function name after 'fn'");
+    Token nameTok = expect(TokenType::IDENT, DiagCode::EXPECTED_FN_NAME);
     auto node = std::make_unique<FnDeclNode>(nameTok.lexeme, line);
 
-    expect(TokenType::LPAREN, "Expected '(' after function name");
+    expect(TokenType::LPAREN, DiagCode::EXPECTED_LPAREN_AFTER_NAME);
 
-    // Parse parameter list: (ident: ident, ident: ident, ...)
+    // Parse parameter list: (param, param, ...)
     if (!check(TokenType::RPAREN)) {
+        bool tooMany = false;
         do {
-            Token paramName = expect(TokenType::IDENT, "Expected parameter name");
-            expect(TokenType::COLON, "Expected ':' after parameter name");
-            Token paramType = expect(TokenType::IDENT, "Expected parameter type");
-            node->params.push_back(ParamNode{paramName.lexeme, paramType.lexeme, paramName.line});
+            parseParam(node->params);
+            limitParams(node->params, tooMany);
         } while (match(TokenType::COMMA));
     }
 
-    expect(TokenType::RPAREN, "Expected ')' after parameters");
+    expect(TokenType::RPAREN, DiagCode::EXPECTED_RPAREN_AFTER_PARAMS);
+
+    if (match(TokenType::ARROW)) {
+        node->returnType = parseType(DiagCode::EXPECTED_RETURN_TYPE);
+    }
 
+    if (listener_) listener_->onScopeEntered(*node);
     auto body = parseBlock();
     if (body) {
         node->body = std::move(body);
     }
-    return node;
+    return built(std::move(node));
 }
 
-AstNodePtr Parser::parseBlock() {
+// <name>: <type>, or a method's `self`, `&self` or `&mut self`.
+void Parser::parseParam(std::vector<ParamNode>& params) {
     int line = current_.line;
-    expect(TokenType::LBRACE, "Expected '{'");
+    bool selfParam = check(TokenType::AMP) || (check(TokenType::IDENT) &&
+                                               current_.lexeme == "self" &&
+                                               peek_.type != TokenType::COLON);
+    if (selfParam) {
+        const char* type = "Self";
+        if (match(TokenType::AMP)) type = match(TokenType::MUT) ? "&mut Self" : "&Self";
+        if (!check(TokenType::IDENT) || current_.lexeme != "self") {
+            recordError(DiagCode::EXPECTED_PARAM_NAME);
+            return;
+        }
+        advance();
+        params.push_back(ParamNode{"self", type, line});
+        return;
+    }
+    Token name = expect(TokenType::IDENT, DiagCode::EXPECTED_PARAM_NAME);
+    expect(TokenType::COLON, DiagCode::EXPECTED_PARAM_COLON);
+    std::string type = parseType(DiagCode::EXPECTED_PARAM_TYPE);
+    params.push_back(ParamNode{name.lexeme, std::move(type), name.line});
+}
+
+// Drops an entry added past MAX_PARAMS; the first one dropped is reported.
+void Parser::limitParams(std::vector<ParamNode>& params, bool& reported) {
+    if (params.size() <= MAX_PARAMS) return;
+    params.pop_back();
+    if (!reported) recordError(DiagCode::TOO_MANY_PARAMS, MAX_PARAMS);
+    reported = true;
+}
+
+// A type name, optionally behind `&` or `&mut`, kept as written ("&mut T").
+std::string Parser::parseType(DiagCode error) {
+    if (!match(TokenType::AMP)) return expect(TokenType::IDENT, error).lexeme;
+    std::string type = match(TokenType::MUT) ? "&mut " : "&";
+    return type + expect(TokenType::IDENT, error).lexeme;
+}
+
+AstNodePtr Parser::parseStructDecl() {
+    int line = current_.line;
+    advance();  // consume STRUCT
+
+    Token nameTok = expect(TokenType::IDENT, DiagCode::EXPECTED_STRUCT_NAME);
+    auto node = std::make_unique<StructDeclNode>(nameTok.lexeme, line);
+    if (match(TokenType::SEMICOLON)) return built(std::move(node));  // unit struct
+    if (!check(TokenType::LBRACE)) {
+        recordError(DiagCode::EXPECTED_LBRACE);
+        return built(std::move(node));
+    }
+    advance();
+
+    // Fields: name: type, separated by commas, with an optional trailing one.
+    // Every iteration but the last consumes a comma, so this stays linear.
+    bool tooMany = false;
+    while (!check(TokenType::RBRACE) && !check(TokenType::EOF_TOKEN)) {
+        Token field = expect(TokenType::IDENT, DiagCode::EXPECTED_FIELD_NAME);
+        expect(TokenType::COLON, DiagCode::EXPECTED_FIELD_COLON);
+        std::string type = parseType(DiagCode::EXPECTED_TYPE_NAME);
+        node->fields.push_back(ParamNode{field.lexeme, std::move(type), field.line});
+        limitParams(node->fields, tooMany);
+        if (!match(TokenType::COMMA)) break;
+    }
+    expect(TokenType::RBRACE, DiagCode::EXPECTED_RBRACE);
+    return built(std::move(node));
+}
+
+// Each method is a statement of its own for error recovery, as in a block.
+AstNodePtr Parser::parseImplBlock() {
+    int line = current_.line;
+    advance();  // consume IMPL
+
+    Token typeTok = expect(TokenType::IDENT, DiagCode::EXPECTED_IMPL_TYPE);
+    auto node = std::make_unique<ImplBlockNode>(typeTok.lexeme, line);
+    if (!check(TokenType::LBRACE)) {
+        recordError(DiagCode::EXPECTED_LBRACE);
+        return built(std::move(node));
+    }
+    advance();
 
+    while (!check(TokenType::RBRACE) && !check(TokenType::EOF_TOKEN)) {
+        size_t offset = current_.offset;
+        if (check(TokenType::FN)) {
+            auto method = parseStatement();
+            if (method) node->methods.push_back(std::move(method));
+        } else {
+            recovering_ = false;
+            recordError(DiagCode::EXPECTED_IMPL_FN);
+            advance();  // a statement keyword here would stop synchronize() at once
+        }
+        endStatement();
+        if (current_.offset == offset) {
+            advance();
+        }
+    }
+
+    expect(TokenType::RBRACE, DiagCode::EXPECTED_RBRACE);
+    return built(std::move(node));
+}
+
+enum class BranchEnd { VALUE, LEAVES, NONE };
+
+// How an `if` branch ends: with a value, by leaving (its block ends in
+// return, break or continue) or neither. An `if` has a value if every
+// branch ends in one or leaves, and at least one has a value.
+static BranchEnd branchEnd(const AstNode* branch) {
+    if (!branch) return BranchEnd::NONE;
+    if (branch->kind == NodeKind::BLOCK) {
+        auto* block = static_cast<const BlockNode*>(branch);
+        if (block->value) return BranchEnd::VALUE;
+        if (block->statements.empty() || !block->statements.back()) return BranchEnd::NONE;
+        NodeKind last = block->statements.back()->kind;
+        return last == NodeKind::RETURN_STMT || last == NodeKind::BREAK_STMT ||
+                       last == NodeKind::CONTINUE_STMT
+                   ? BranchEnd::LEAVES : BranchEnd::NONE;
+    }
+    if (branch->kind != NodeKind::IF_STMT) return BranchEnd::NONE;
+    auto* n = static_cast<const IfStmtNode*>(branch);
+    BranchEnd thenEnd = branchEnd(n->thenBranch.get());
+    BranchEnd elseEnd = branchEnd(n->elseBranch.get());
+    if (thenEnd == BranchEnd::NONE || elseEnd == BranchEnd::NONE) return BranchEnd::NONE;
+    return thenEnd == BranchEnd::VALUE || elseEnd == BranchEnd::VALUE ? BranchEnd::VALUE
+                                                                      : BranchEnd::LEAVES;
+}
+
+// True if `stmt`, the last of its block, is the block's value: an
+// expression left without `;` (see parseExprStmt()), a block with a value,
+// or an `if` with a value (see branchEnd()).
+static bool isBlockValue(const AstNode* stmt) {
+    switch (stmt->kind) {
+        case NodeKind::BLOCK:
+            return static_cast<const BlockNode*>(stmt)->value != nullptr;
+        case NodeKind::IF_STMT:
+            return branchEnd(stmt) == BranchEnd::VALUE;
+        case NodeKind::PROGRAM:
+        case NodeKind::FN_DECL:
+        case NodeKind::LET_STMT:
+        case NodeKind::RETURN_STMT:
+        case NodeKind::WHILE_STMT:
+        case NodeKind::EXPR_STMT:
+        case NodeKind::STRUCT_DECL:
+        case NodeKind::IMPL_BLOCK:
+        case NodeKind::LOOP_STMT:
+        case NodeKind::FOR_STMT:
+        case NodeKind::BREAK_STMT:
+        case NodeKind::CONTINUE_STMT:
+            return false;
+        default:
+            return true;
+    }
+}
+
+AstNodePtr Parser::parseBlock() {
+    int line = current_.line;
     auto block = std::make_unique<BlockNode>(line);
+    if (listener_) listener_->onScopeEntered(*block);
+    // Without its '{' the block is left empty: reading statements up to the
+    // next '}' would swallow the rest of the input, one nesting level per
+    // `fn`, `while` or `if` in it.
+    if (!check(TokenType::LBRACE)) {
+        recordError(DiagCode::EXPECTED_LBRACE);
+        return built(std::move(block));
+    }
+    advance();
+
+    ++blocks_;
     while (!check(TokenType::RBRACE) && !check(TokenType::EOF_TOKEN)) {
+        size_t offset = current_.offset;
         auto stmt = parseStatement();
         if (stmt) {
-            block->statements.push_back(std::move(stmt));
+            if (check(TokenType::RBRACE) && isBlockValue(stmt.get())) {
+                block->value = std::move(stmt);
+            } else {
+                block->statements.push_back(std::move(stmt));
+            }
+        }
+        endStatement();
+        if (current_.offset == offset) {
+            advance();
         }
     }
+    --blocks_;
 
-    expect(TokenType::RBRACE, "Expected '}'");
-    return block;
+    expect(TokenType::RBRACE, DiagCode::EXPECTED_RBRACE);
+    return built(std::move(block));
 }
 
 AstNodePtr Parser::parseLetStmt() {
@@ -162,20 +483,19 @@ AstNodePtr Parser::parseLetStmt() {
     advance();  // consume LET
 
     bool isMut = match(TokenType::MUT);
-    Token nameTok = expect(TokenType::IDENT, "Expected variable name after 'let'");
+    Token nameTok = expect(TokenType::IDENT, DiagCode::EXPECTED_LET_NAME);
 
     auto node = std::make_unique<LetStmtNode>(isMut, nameTok.lexeme, line);
 
     // Optional type annotation: : typename
     if (match(TokenType::COLON)) {
-        Token typeTok = expect(TokenType::IDENT, "Expected type name after ':'");
-        node->typeName = typeTok.lexeme;
+        node->typeName = parseType(DiagCode::EXPECTED_TYPE_NAME);
     }
 
-    expect(TokenType::ASSIGN, "Expected '=' in let statement");
+    expect(TokenType::ASSIGN, DiagCode::EXPECTED_LET_ASSIGN);
     node->init = parseExpression();
-    expect(TokenType::SEMICOLON, "Expected ';' after let statement");
-    return node;
+    expect(TokenType::SEMICOLON, DiagCode::EXPECTED_LET_SEMICOLON);
+    return built(std::move(node));
 }
 
 AstNodePtr Parser::parseReturnStmt() {
@@ -189,8 +509,8 @@ AstNodePtr Parser::parseReturnStmt() {
         node->value = parseExpression();
     }
 
-    expect(TokenType::SEMICOLON, "Expected ';' after return statement");
-    return node;
+    expect(TokenType::SEMICOLON, DiagCode::EXPECTED_RETURN_SEMICOLON);
+    return built(std::move(node));
 }
 
 AstNodePtr Parser::parseWhileStmt() {
@@ -200,10 +520,66 @@ AstNodePtr Parser::parseWhileStmt() {
     auto node = std::make_unique<WhileStmtNode>(line);
     node->condition = parseExpression();
     node->body = parseBlock();
-    return node;
+    return built(std::move(node));
 }
 
-AstNodePtr Parser::parseIfStmt() {
+AstNodePtr Parser::parseLoopStmt() {
+    int line = current_.line;
+    advance();  // consume LOOP
+
+    auto node = std::make_unique<LoopStmtNode>(line);
+    node->body = parseBlock();
+    return built(std::move(node));
+}
+
+AstNodePtr Parser::parseForStmt() {
+    int line = current_.line;
+    advance();  // consume FOR
+
+    Token nameTok = expect(TokenType::IDENT, DiagCode::EXPECTED_FOR_VARIABLE);
+    auto node = std::make_unique<ForStmtNode>(nameTok.lexeme, line);
+    expect(TokenType::IN, DiagCode::EXPECTED_FOR_IN);
+    node->iterable = parseExpression();
+    if (listener_) listener_->onScopeEntered(*node);
+    node->body = parseBlock();
+    return built(std::move(node));
+}
+
+AstNodePtr Parser::parseBreakOrContinue() {
+    int line = current_.line;
+    bool isBreak = check(TokenType::BREAK);
+    advance();  // consume BREAK / CONTINUE
+
+    AstNodePtr node;
+    if (isBreak) node = std::make_unique<BreakStmtNode>(line);
+    else node = std::make_unique<ContinueStmtNode>(line);
+    expect(TokenType::SEMICOLON, isBreak ? DiagCode::EXPECTED_BREAK_SEMICOLON
+                                         : DiagCode::EXPECTED_CONTINUE_SEMICOLON);
+    return built(std::move(node));
+}
+
+// A statement `match`, like an `if`, ends at its `}`: it needs no `;` and
+// takes no operator after it.
+AstNodePtr Parser::parseExprStmt() {
+    int line = current_.line;
+    bool isMatch = check(TokenType::MATCH);
+    AstNodePtr expr = isMatch ? parseMatch() : parseExpression();
+    // The last expression of a block, left without `;`, is the block's
+    // value; parseBlock() takes it as is.
+    if (expr && blocks_ > 0 && check(TokenType::RBRACE)) return expr;
+
+    auto node = std::make_unique<ExprStmtNode>(line);
+    node->expr = std::move(expr);
+    if (isMatch) match(TokenType::SEMICOLON);
+    else expect(TokenType::SEMICOLON, DiagCode::EXPECTED_EXPR_SEMICOLON);
+    return built(std::move(node));
+}
+
+// ============================================================
+// Block-like expressions
+// ============================================================
+
+AstNodePtr Parser::parseIf() {
     int line = current_.line;
     advance();  // consume IF
 
@@ -213,26 +589,84 @@ AstNodePtr Parser::parseIfStmt() {
 
     if (match(TokenType::ELSE)) {
         if (check(TokenType::IF)) {
-            node->elseBranch = parseIfStmt();  // else if chain
+            if (enter()) node->elseBranch = parseIf();  // else if chain
+            leave();
         } else {
             node->elseBranch = parseBlock();
         }
     }
 
-    return node;
+    return built(std::move(node));
 }
 
-AstNodePtr Parser::parseExprStmt() {
+// match <scrutinee> { <arm>, ... }. The comma after an arm may be left out
+// after the last one and after a block-like body. Arms stop at the first
+// error; the statement's recovery skips the rest.
+AstNodePtr Parser::parseMatch() {
     int line = current_.line;
-    auto node = std::make_unique<ExprStmtNode>(line);
-    node->expr = parseExpression();
-    expect(TokenType::SEMICOLON, "Expected ';' after expression statement");
-    return node;
+    advance();  // consume MATCH
+
+    auto node = std::make_unique<MatchExprNode>(line);
+    node->scrutinee = parseExpression();
+    if (!check(TokenType::LBRACE)) {
+        recordError(DiagCode::EXPECTED_MATCH_LBRACE);
+        return built(std::move(node));
+    }
+    advance();
+
+    // Every iteration consumes a comma or ends a block-like body, so this
+    // stays linear.
+    while (!check(TokenType::RBRACE) && !check(TokenType::EOF_TOKEN)) {
+        auto arm = parseMatchArm();
+        const AstNode* body = static_cast<MatchArmNode*>(arm.get())->body.get();
+        node->arms.push_back(std::move(arm));
+        if (recovering_) break;
+        bool blockLike = body && (body->kind == NodeKind::BLOCK ||
+                                  body->kind == NodeKind::IF_STMT ||
+                                  body->kind == NodeKind::MATCH_EXPR);
+        if (!match(TokenType::COMMA) && !blockLike) break;
+    }
+    expect(TokenType::RBRACE, DiagCode::EXPECTED_ARM_COMMA);
+    return built(std::move(node));
+}
+
+// <pattern> (| <pattern>)* => <expression>, or _ => <expression>.
+AstNodePtr Parser::parseMatchArm() {
+    auto arm = std::make_unique<MatchArmNode>(current_.line);
+    if (check(TokenType::IDENT) && current_.lexeme == "_") {
+        advance();
+    } else {
+        do {
+            AstNodePtr pattern = parsePattern();
+            if (!pattern) return built(std::move(arm));
+            arm->patterns.push_back(std::move(pattern));
+        } while (match(TokenType::PIPE));
+    }
+    expect(TokenType::FAT_ARROW, DiagCode::EXPECTED_FAT_ARROW);
+    arm->body = parseExpression();
+    return built(std::move(arm));
+}
+
+// An integer literal, possibly negated: a NumberLiteralNode, or one under
+// a UnaryExprNode "-" as in expressions.
+AstNodePtr Parser::parsePattern() {
+    int line = current_.line;
+    bool negative = match(TokenType::MINUS);
+    if (!check(TokenType::NUMBER)) {
+        recordError(DiagCode::EXPECTED_MATCH_PATTERN);
+        return nullptr;
+    }
+    AstNodePtr literal = parsePrimary();
+    if (!negative || !literal) return literal;
+    auto node = std::make_unique<UnaryExprNode>("-", line);
+    node->operand = std::move(literal);
+    return built(std::move(node));
 }
 
 // ============================================================
-// Expressions (precedence: assignment < comparison < additive
-//              < multiplicative < unary < primary)
+// Expressions (precedence: assignment < range < comparison < additive
+//              < multiplicative < unary < postfix < primary; `if`, `match`
+//              and blocks are primaries)
 // ============================================================
 
 AstNodePtr Parser::parseExpression() {
@@ -247,59 +681,91 @@ AstNodePtr Parser::parseAssignment() {
         advance();  // consume IDENT
         advance();  // consume ASSIGN
         auto node = std::make_unique<AssignExprNode>(target, line);
-        node->value = parseAssignment();  // right-associative
-        return node;
+        if (enter()) node->value = parseAssignment();  // right-associative
+        leave();
+        return built(std::move(node));
+    }
+    // Ranges are rare; keep them out of the path every expression takes.
+    auto left = parseComparison();
+    if (check(TokenType::DOT_DOT) || check(TokenType::DOT_DOT_EQ)) {
+        return parseRange(std::move(left));
     }
-    return parseComparison();
+    return left;
+}
+
+// <left>..<b> and <left>..=<b>, as BinaryExprNodes, at a `..` / `..=`. Not
+// associative: `a..b..c` stops after `a..b`.
+AstNodePtr Parser::parseRange(AstNodePtr left) {
+    std::string op = current_.lexeme;
+    int line = current_.line;
+    advance();
+    auto node = std::make_unique<BinaryExprNode>(op, line);
+    node->left = std::move(left);
+    if (enter()) node->right = parseComparison();
+    leave();
+    return built(std::move(node));
 }
 
+// The binary levels build their chains in loops, but each operator nests
+// the tree one level deeper (`a + b + c` is `(a + b) + c`), and later passes
+// recurse over it: every link counts towards MAX_NESTING, as in
+// parsePostfix().
 AstNodePtr Parser::parseComparison() {
     auto left = parseAdditive();
+    int links = 0;
 
     while (check(TokenType::EQ) || check(TokenType::NEQ) ||
            check(TokenType::LT) || check(TokenType::GT) ||
            check(TokenType::LTE) || check(TokenType::GTE)) {
+        ++links;
+        if (!enter()) break;
         std::string op = current_.lexeme;
         int line = current_.line;
         advance();
         auto node = std::make_unique<BinaryExprNode>(op, line);
         node->left = std::move(left);
         node->right = parseAdditive();
-        left = std::move(node);
+        left = built(std::move(node));
     }
-
+    for (; links > 0; --links) leave();
     return left;
 }
 
 AstNodePtr Parser::parseAdditive() {
     auto left = parseMultiplicative();
+    int links = 0;
 
     while (check(TokenType::PLUS) || check(TokenType::MINUS)) {
+        ++links;
+        if (!enter()) break;
         std::string op = current_.lexeme;
         int line = current_.line;
         advance();
         auto node = std::make_unique<BinaryExprNode>(op, line);
         node->left = std::move(left);
         node->right = parseMultiplicative();
-        left = std::move(node);
+        left = built(std::move(node));
     }
-
+    for (; links > 0; --links) leave();
     return left;
 }
 
 AstNodePtr Parser::parseMultiplicative() {
     auto left = parseUnary();
+    int links = 0;
 
     while (check(TokenType::STAR) || check(TokenType::SLASH)) {
+        ++links;
+        if (!enter()) break;
         std::string op = current_.lexeme;
         int line = current_.line;
         advance();
         auto node = std::make_unique<BinaryExprNode>(op, line);
         node->left = std::move(left);
         node->right = parseUnary();
-        left = std::move(node);
+        left = built(std::move(node));
     }
-
+    for (; links > 0; --links) leave();
     return left;
 }
 
@@ -309,25 +775,105 @@ AstNodePtr Parser::parseUnary() {
         int line = current_.line;
         advance();
         auto node = std::make_unique<UnaryExprNode>(op, line);
-        node->operand = parseUnary();  // right-recursive for e.g. --x
-        return node;
+        if (enter()) node->operand = parseUnary();  // right-recursive for e.g. --x
+        leave();
+        return built(std::move(node));
+    }
+    auto expr = parsePrimary();
+    if (check(TokenType::DOT)) return parsePostfix(std::move(expr));
+    return expr;
+}
+
+// Field accesses and method calls after a primary, at its first `.`:
+// (.name | .name(args))*. The chain is built in a loop, but each link nests
+// the tree one level deeper, so links count towards MAX_NESTING like any
+// other nesting.
+AstNodePtr Parser::parsePostfix(AstNodePtr expr) {
+    int links = 0;
+    while (check(TokenType::DOT)) {
+        ++links;
+        if (!enter()) break;
+        int line = current_.line;
+        advance();  // consume DOT
+        if (!check(TokenType::IDENT)) {
+            recordError(DiagCode::EXPECTED_MEMBER_NAME);
+            break;
+        }
+        std::string name = current_.lexeme;
+        advance();
+        if (match(TokenType::LPAREN)) {
+            auto call = std::make_unique<MethodCallExprNode>(std::move(name), line);
+            call->receiver = std::move(expr);
+            parseArgs(call->args);
+            expr = built(std::move(call));
+        } else {
+            auto field = std::make_unique<FieldExprNode>(std::move(name), line);
+            field->object = std::move(expr);
+            expr = built(std::move(field));
+        }
+    }
+    for (; links > 0; --links) leave();
+    return expr;
+}
+
+// The arguments after a call's '(', and the ')'.
+void Parser::parseArgs(std::vector<AstNodePtr>& args) {
+    if (!check(TokenType::RPAREN)) {
+        do {
+            args.push_back(parseExpression());
+        } while (match(TokenType::COMMA));
     }
-    return parsePrimary();
+    expect(TokenType::RPAREN, DiagCode::EXPECTED_CALL_RPAREN);
 }
 
 AstNodePtr Parser::parsePrimary() {
-    // Number literal
+    // Number literal. Plain digits short of 20 (below 10^19 < 2^64) are the
+    // value already; other forms (0xFF, 1_000, 42u64) and longer ones are
+    // decoded here, checked to fit in 64 bits and stored in decimal.
     if (check(TokenType::NUMBER)) {
-        auto node = std::make_unique<NumberLiteralNode>(current_.lexeme, current_.line);
+        std::string value = current_.lexeme;
+        if ((current_.flags & TOKEN_COMPLEX) || value.size() >= 20) {
+            uint64_t decoded = 0;
+            IntegerStatus status = decodeInteger(current_.lexeme, decoded);
+            if (status != IntegerStatus::OK) {
+                recordError(status == IntegerStatus::OUT_OF_RANGE ? DiagCode::INTEGER_OUT_OF_RANGE
+                                                                  : DiagCode::INVALID_LITERAL);
+                synchronize();
+                return nullptr;
+            }
+            value = std::to_string(decoded);
+        }
+        auto node = std::make_unique<NumberLiteralNode>(std::move(value), current_.line);
         advance();
-        return node;
+        return built(std::move(node));
     }
 
-    // String literal
+    // String literal, with its escapes decoded if it has any
     if (check(TokenType::STRING)) {
-        auto node = std::make_unique<StringLiteralNode>(current_.lexeme, current_.line);
+        std::string value;
+        if (current_.flags & TOKEN_ESCAPES) {
+            if (!decodeString(current_.lexeme, value)) {
+                recordError(DiagCode::INVALID_LITERAL);
+                synchronize();
+                return nullptr;
+            }
+        } else {
+            value = current_.lexeme;
+        }
+        auto node = std::make_unique<StringLiteralNode>(std::move(value), current_.line);
         advance();
-        return node;
+        return built(std::move(node));
+    }
+
+    // Float and char literals lex, but nothing past the parser has a type for them
+    if (check(TokenType::FLOAT) || check(TokenType::CHAR)) {
+        double f = 0;
+        uint32_t c = 0;
+        bool valid = check(TokenType::FLOAT) ? decodeFloat(current_.lexeme, f)
+                                             : decodeChar(current_.lexeme, c);
+        recordError(valid ? DiagCode::UNSUPPORTED_LITERAL : DiagCode::INVALID_LITERAL);
+        synchronize();
+        return nullptr;
     }
 
     // Identifier or function call
@@ -340,28 +886,38 @@ AstNodePtr Parser::parsePrimary() {
         if (check(TokenType::LPAREN)) {
             advance();  // consume LPAREN
             auto node = std::make_unique<CallExprNode>(name, line);
-            if (!check(TokenType::RPAREN)) {
-                do {
-                    node->args.push_back(parseExpression());
-                } while (match(TokenType::COMMA));
-            }
-            expect(TokenType::RPAREN, "Expected ')' after call arguments");
-            return node;
+            parseArgs(node->args);
+            return built(std::move(node));
         }
 
-        return std::make_unique<IdentExprNode>(name, line);
+        return built(std::make_unique<IdentExprNode>(name, line));
+    }
+
+    // Block-like expressions: their value is that of the branch, arm or
+    // block tail taken.
+    if (check(TokenType::IF) || check(TokenType::MATCH) || check(TokenType::LBRACE)) {
+        AstNodePtr expr;
+        if (enter()) {
+            if (check(TokenType::IF)) expr = parseIf();
+            else if (check(TokenType::MATCH)) expr = parseMatch();
+            else expr = parseBlock();
+        }
+        leave();
+        return expr;
     }
 
     // Grouped expression: (expr)
     if (check(TokenType::LPAREN)) {
         advance();  // consume LPAREN
-        auto expr = parseExpression();
-        expect(TokenType::RPAREN, "Expected ')' after grouped expression");
+        AstNodePtr expr;
+        if (enter()) expr = parseExpression();
+        leave();
+        expect(TokenType::RPAREN, DiagCode::EXPECTED_GROUP_RPAREN);
         return expr;
     }
 
     // Unexpected token
-    recordError("Unexpected token '" + current_.lexeme + "' in expression", current_.line);
+    recordError(DiagCode::UNEXPECTED_TOKEN);
     synchronize();
     return nullptr;
 }
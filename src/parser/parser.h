@@ -2,67 +2,171 @@
 #define PARSER_H
 
 #include "../ast/ast.h"
+#include "../diag/diag.h"
 #include "../lexer/lexer.h"
 #include "../token/token.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 // ============================================================
-// ParseError
+// ParseError — a formatted Diagnostic
 // ============================================================
 struct ParseError {
     std::string message;
     int line;
 };
 
+// ============================================================
+// ParseListener — hooks called while the tree is being built
+// ============================================================
+//
+// onNodeBuilt() runs once per node, children before their parent, as soon
+// as the parser has finished the node and before it is attached to the
+// parent, so per-node passes can run while the node is still in cache. A
+// listener may replace an expression node by assigning to `node`; the
+// parser attaches whatever it leaves there. The ProgramNode comes last and
+// must not be replaced. onItemBuilt() follows the onNodeBuilt() of each
+// top-level statement, with its index in ProgramNode::statements.
+//
+// onScopeEntered() opens the scope of a FnDeclNode once its parameters are
+// read, of a BlockNode before its `{`, and of a ForStmtNode once its
+// iterable is built; the node's own onNodeBuilt() closes it. Nodes built in
+// between are the ones inside the scope.
+class ParseListener {
+public:
+    virtual ~ParseListener() = default;
+    virtual void onNodeBuilt(AstNodePtr& node) = 0;
+    virtual void onScopeEntered(AstNode& node) { (void)node; }
+    virtual void onItemBuilt(size_t index) { (void)index; }
+};
+
 // ============================================================
 // Parser — recursive descent, one-token lookahead
 // ============================================================
 class Parser {
 public:
-    explicit Parser(const std::string& source);
+    // `firstLine` numbers the first line of `source`, for parsing a fragment
+    // cut out of a larger file.
+    explicit Parser(const std::string& source, int firstLine = 1);
+
+    // Calls `listener` (not owned; may be null) for every node built by
+    // parseProgram().
+    void setListener(ParseListener* listener);
+
+    // Stops parsing once `max` errors have been recorded (0 = no limit).
+    void setMaxErrors(size_t max);
+
+    // Nesting depth (blocks, statements, parentheses, unary and binary
+    // operators, assignment chains, member accesses, `if` / `match` / block
+    // expressions) beyond which parsing stops with an error, so that neither
+    // the parser nor later passes run out of stack.
+    static constexpr int MAX_NESTING = 256;
 
     // Entry point. Returns the AST root. May be partial if hasErrors().
     std::unique_ptr<ProgramNode> parseProgram();
 
     bool hasErrors() const;
+
+    // Errors as recorded, unformatted; render with renderDiagnostics() and
+    // the source passed to the constructor.
+    const std::vector<Diagnostic>& diagnostics() const;
+
+    // The same errors with their messages built, formatted on first use.
     const std::vector<ParseError>& errors() const;
 
+    // True if parsing stopped before the end of the input, at the error
+    // limit or the nesting limit; errors() then misses later problems.
+    bool stoppedEarly() const;
+
+    // Source offset of the first token of each top-level statement returned
+    // by parseProgram(), in order.
+    const std::vector<size_t>& itemOffsets() const;
+
+    // Index into diagnostics() of the first error recorded from each item's
+    // first token on, in step with itemOffsets(); errors before the first
+    // item's index came from input ahead of it.
+    const std::vector<size_t>& itemDiagnostics() const;
+
+    // Makes parseProgram() return, without parsing it, before a top-level
+    // statement that would start at `offset`. reachedStopOffset() tells
+    // whether it did; parsing runs on to the end of the input otherwise.
+    void setStopOffset(size_t offset);
+    bool reachedStopOffset() const;
+
 private:
     Lexer lexer_;
     Token current_;
     Token peek_;
-    std::vector<ParseError> errors_;
+    std::vector<Diagnostic> diagnostics_;
+    mutable std::vector<ParseError> errors_;
+    mutable size_t formatted_ = 0;  // diagnostics_ already in errors_
+    std::vector<size_t> itemOffsets_;
+    std::vector<size_t> itemDiagnostics_;
+    size_t stopOffset_ = SIZE_MAX;
+    bool reachedStop_ = false;
+    size_t lastTokenEnd_ = 0;
+    ParseListener* listener_ = nullptr;
+    size_t maxErrors_ = 0;
+    bool recovering_ = false;  // an error was recorded in the current statement
+    bool needsSync_ = false;   // ...and synchronize() has not run since it
+    int depth_ = 0;
+    int blocks_ = 0;  // open blocks; outside any, an expression always needs its `;`
+    bool stopped_ = false;
 
     // Token navigation
     void advance();
     bool check(TokenType type) const;
     bool match(TokenType type);
-    Token expect(TokenType type, const std::string& errorMsg);
+    Token expect(TokenType type, DiagCode error);
+
+    // Hands a finished node to the listener.
+    AstNodePtr built(AstNodePtr node);
 
     // Error handling
-    void recordError(const std::string& msg, int line);
+    void recordError(DiagCode code, uint32_t arg = 0);  // at current_
+    void reportInvalidUtf8();  // in or before current_
     void synchronize();
+    void endStatement();
+    void stop();
+    bool enter();  // false (and stop()) past MAX_NESTING; pair with leave()
+    void leave() { --depth_; }
 
     // Statement parsers
     AstNodePtr parseStatement();
     AstNodePtr parseFnDecl();
+    void parseParam(std::vector<ParamNode>& params);
+    void limitParams(std::vector<ParamNode>& params, bool& reported);
+    std::string parseType(DiagCode error);
+    AstNodePtr parseStructDecl();
+    AstNodePtr parseImplBlock();
     AstNodePtr parseBlock();
     AstNodePtr parseLetStmt();
     AstNodePtr parseReturnStmt();
     AstNodePtr parseWhileStmt();
-    AstNodePtr parseIfStmt();
+    AstNodePtr parseLoopStmt();
+    AstNodePtr parseForStmt();
+    AstNodePtr parseBreakOrContinue();
     AstNodePtr parseExprStmt();
 
+    // Block-like expressions, which are also statements
+    AstNodePtr parseIf();
+    AstNodePtr parseMatch();
+    AstNodePtr parseMatchArm();
+    AstNodePtr parsePattern();
+
     // Expression parsers (precedence climbing, bottom-up by binding strength)
     AstNodePtr parseExpression();
     AstNodePtr parseAssignment();
+    AstNodePtr parseRange(AstNodePtr left);
     AstNodePtr parseComparison();
     AstNodePtr parseAdditive();
     AstNodePtr parseMultiplicative();
     AstNodePtr parseUnary();
+    AstNodePtr parsePostfix(AstNodePtr expr);
     AstNodePtr parsePrimary();
+    void parseArgs(std::vector<AstNodePtr>& args);
 };
 
 #endif // PARSER_H
@@ -1,6 +1,8 @@
 #include "parser.h"
+#include "incremental.h"
 #include "../ast/ast.h"
 #include <gtest/gtest.h>
+#include <random>
 #include <string>
 
 // ============================================================
@@ -56,6 +58,48 @@ TEST(Parser, StringLiteral) {
     EXPECT_EQ(as<StringLiteralNode>(stmt->expr.get())->value, "hello");
 }
 
+TEST(Parser, NumberLiteralFormsAreStoredInDecimal) {
+    auto prog = parseOk("0xFF; 1_000_000; 42u64; 0b1010; 7; 18446744073709551615; "
+                        "000000000000000000000000042;");
+    const char* expected[] = {"255", "1000000", "42", "10", "7", "18446744073709551615", "42"};
+    ASSERT_EQ(prog->statements.size(), 7u);
+    for (size_t i = 0; i < 7; ++i) {
+        auto* stmt = as<ExprStmtNode>(prog->statements[i].get());
+        ASSERT_EQ(stmt->expr->kind, NodeKind::NUMBER_LITERAL);
+        EXPECT_EQ(as<NumberLiteralNode>(stmt->expr.get())->value, expected[i]);
+    }
+}
+
+TEST(Parser, StringEscapesAreDecoded) {
+    auto prog = parseOk("\"a\\tb\\\"c\\u{e9}\"; r\"raw\\n\";");
+    auto* first = as<ExprStmtNode>(prog->statements[0].get());
+    EXPECT_EQ(as<StringLiteralNode>(first->expr.get())->value, "a\tb\"c\xc3\xa9");
+    auto* second = as<ExprStmtNode>(prog->statements[1].get());
+    EXPECT_EQ(as<StringLiteralNode>(second->expr.get())->value, "raw\\n");
+}
+
+TEST(Parser, InvalidAndUnsupportedLiterals) {
+    struct Case { const char* src; const char* message; };
+    const Case cases[] = {
+        {"let x = 0x;", "Invalid literal '0x'"},
+        {"let x = 42u7;", "Invalid literal '42u7'"},
+        {"let s = \"\\q\";", "Invalid literal '\"\\q\"'"},
+        {"let x = 1e;", "Invalid literal '1e'"},
+        {"let x = 0x1_0000_0000_0000_0000;",
+         "Integer literal out of range: '0x1_0000_0000_0000_0000' does not fit in 64 bits"},
+        {"let x = 18446744073709551616;",
+         "Integer literal out of range: '18446744073709551616' does not fit in 64 bits"},
+        {"let x = 3.14;", "Unsupported literal '3.14': only integers and strings have a type"},
+        {"let c = 'c';", "Unsupported literal ''c'': only integers and strings have a type"},
+    };
+    for (const Case& c : cases) {
+        Parser p(c.src);
+        p.parseProgram();
+        ASSERT_EQ(p.errors().size(), 1u) << c.src;
+        EXPECT_EQ(p.errors()[0].message, c.message);
+    }
+}
+
 TEST(Parser, IdentExpression) {
     auto prog = parseOk("foo;");
     auto* stmt = as<ExprStmtNode>(prog->statements[0].get());
@@ -297,6 +341,253 @@ TEST(Parser, FnDeclWithParams) {
     EXPECT_EQ(fn->params[1].name, "b");
 }
 
+TEST(Parser, FnDeclReturnType) {
+    auto prog = parseOk("fn f(s: &str, t: &mut Vec) -> i64 { return 1; } fn g() {}");
+    auto* fn = as<FnDeclNode>(prog->statements[0].get());
+    EXPECT_EQ(fn->returnType, "i64");
+    EXPECT_EQ(fn->params[0].typeName, "&str");
+    EXPECT_EQ(fn->params[1].typeName, "&mut Vec");
+    EXPECT_EQ(as<FnDeclNode>(prog->statements[1].get())->returnType, "");
+}
+
+TEST(Parser, SelfParams) {
+    auto prog = parseOk("fn a(self) {} fn b(&self, x: i32) {} fn c(&mut self) {} "
+                        "fn d(self: Box) {}");
+    const char* types[] = {"Self", "&Self", "&mut Self", "Box"};
+    for (size_t i = 0; i < 4; ++i) {
+        auto* fn = as<FnDeclNode>(prog->statements[i].get());
+        ASSERT_FALSE(fn->params.empty());
+        EXPECT_EQ(fn->params[0].name, "self");
+        EXPECT_EQ(fn->params[0].typeName, types[i]);
+    }
+}
+
+// ============================================================
+// Structs and impl blocks
+// ============================================================
+
+TEST(Parser, StructDecl) {
+    auto prog = parseOk("struct P { x: i64, name: &str, } struct Unit; struct E {}");
+    ASSERT_EQ(prog->statements.size(), 3u);
+    ASSERT_EQ(prog->statements[0]->kind, NodeKind::STRUCT_DECL);
+    auto* p = as<StructDeclNode>(prog->statements[0].get());
+    EXPECT_EQ(p->name, "P");
+    ASSERT_EQ(p->fields.size(), 2u);
+    EXPECT_EQ(p->fields[1].name, "name");
+    EXPECT_EQ(p->fields[1].typeName, "&str");
+    EXPECT_TRUE(as<StructDeclNode>(prog->statements[1].get())->fields.empty());
+    EXPECT_TRUE(as<StructDeclNode>(prog->statements[2].get())->fields.empty());
+}
+
+TEST(Parser, ParameterAndFieldListsAreBounded) {
+    for (size_t n : {MAX_PARAMS, MAX_PARAMS + 2}) {
+        std::string fn = "fn f(", st = "struct S { ";
+        for (size_t i = 0; i < n; ++i) {
+            fn += (i ? ", a" : "a") + std::to_string(i) + ": i64";
+            st += "f" + std::to_string(i) + ": i64, ";
+        }
+        Parser p(fn + ") { } " + st + "}");
+        auto prog = p.parseProgram();
+        ASSERT_EQ(prog->statements.size(), 2u);
+        EXPECT_EQ(as<FnDeclNode>(prog->statements[0].get())->params.size(), MAX_PARAMS);
+        EXPECT_EQ(as<StructDeclNode>(prog->statements[1].get())->fields.size(), MAX_PARAMS);
+        if (n == MAX_PARAMS) {
+            EXPECT_FALSE(p.hasErrors());
+        } else {
+            ASSERT_EQ(p.errors().size(), 2u);  // once per list
+            EXPECT_EQ(p.errors()[0].message, "More than 65535 parameters or fields");
+        }
+    }
+}
+
+TEST(Parser, ImplBlock) {
+    auto prog = parseOk("impl P { fn get(&self) -> i64 { return self.x; } fn new() {} }");
+    ASSERT_EQ(prog->statements[0]->kind, NodeKind::IMPL_BLOCK);
+    auto* impl = as<ImplBlockNode>(prog->statements[0].get());
+    EXPECT_EQ(impl->typeName, "P");
+    ASSERT_EQ(impl->methods.size(), 2u);
+    EXPECT_EQ(as<FnDeclNode>(impl->methods[0].get())->name, "get");
+    EXPECT_EQ(as<FnDeclNode>(impl->methods[1].get())->name, "new");
+}
+
+TEST(Parser, ImplBlockAcceptsOnlyFunctions) {
+    Parser p("impl P { let x = 1; fn f() {} }");
+    auto prog = p.parseProgram();
+    ASSERT_EQ(p.errors().size(), 1u);
+    EXPECT_EQ(p.errors()[0].message, "Expected 'fn' in impl block");
+    auto* impl = as<ImplBlockNode>(prog->statements[0].get());
+    ASSERT_EQ(impl->methods.size(), 1u);
+    EXPECT_EQ(as<FnDeclNode>(impl->methods[0].get())->name, "f");
+}
+
+// ============================================================
+// loop / for / break / continue
+// ============================================================
+
+TEST(Parser, LoopBreakContinue) {
+    auto prog = parseOk("loop { if x { break; } continue; }");
+    ASSERT_EQ(prog->statements[0]->kind, NodeKind::LOOP_STMT);
+    auto* body = as<BlockNode>(as<LoopStmtNode>(prog->statements[0].get())->body.get());
+    ASSERT_EQ(body->statements.size(), 2u);
+    auto* then = as<BlockNode>(as<IfStmtNode>(body->statements[0].get())->thenBranch.get());
+    EXPECT_EQ(then->statements[0]->kind, NodeKind::BREAK_STMT);
+    EXPECT_EQ(body->statements[1]->kind, NodeKind::CONTINUE_STMT);
+}
+
+TEST(Parser, ForOverRange) {
+    auto prog = parseOk("for i in 0..n + 1 { } for j in a..=b { }");
+    ASSERT_EQ(prog->statements[0]->kind, NodeKind::FOR_STMT);
+    auto* f = as<ForStmtNode>(prog->statements[0].get());
+    EXPECT_EQ(f->name, "i");
+    ASSERT_EQ(f->iterable->kind, NodeKind::BINARY_EXPR);
+    auto* range = as<BinaryExprNode>(f->iterable.get());
+    EXPECT_EQ(range->op, "..");
+    EXPECT_EQ(range->right->kind, NodeKind::BINARY_EXPR);  // `..` binds looser than `+`
+    EXPECT_EQ(f->body->kind, NodeKind::BLOCK);
+    auto* g = as<ForStmtNode>(prog->statements[1].get());
+    EXPECT_EQ(as<BinaryExprNode>(g->iterable.get())->op, "..=");
+}
+
+TEST(Parser, LoopErrors) {
+    struct Case { const char* src; const char* message; };
+    Case cases[] = {
+        {"for in 0..1 {}", "Expected loop variable after 'for'"},
+        {"for i 0..1 {}", "Expected 'in' after loop variable"},
+        {"loop { break }", "Expected ';' after 'break'"},
+        {"loop { continue }", "Expected ';' after 'continue'"},
+        {"fn f() -> { }", "Expected return type after '->'"},
+        {"struct { }", "Expected struct name after 'struct'"},
+        {"struct S { x i64 }", "Expected ':' after field name"},
+        {"impl { }", "Expected type name after 'impl'"},
+        {"x.;", "Expected field or method name after '.'"},
+    };
+    for (const Case& c : cases) {
+        Parser p(c.src);
+        p.parseProgram();
+        ASSERT_FALSE(p.errors().empty()) << c.src;
+        EXPECT_EQ(p.errors()[0].message, c.message) << c.src;
+    }
+}
+
+// ============================================================
+// Field access and method calls
+// ============================================================
+
+TEST(Parser, FieldAndMethodChain) {
+    auto prog = parseOk("a.b.len(1, x.y) * 2;");
+    auto* mul = as<BinaryExprNode>(as<ExprStmtNode>(prog->statements[0].get())->expr.get());
+    ASSERT_EQ(mul->left->kind, NodeKind::METHOD_CALL_EXPR);
+    auto* call = as<MethodCallExprNode>(mul->left.get());
+    EXPECT_EQ(call->method, "len");
+    ASSERT_EQ(call->args.size(), 2u);
+    EXPECT_EQ(call->args[1]->kind, NodeKind::FIELD_EXPR);
+    ASSERT_EQ(call->receiver->kind, NodeKind::FIELD_EXPR);
+    auto* field = as<FieldExprNode>(call->receiver.get());
+    EXPECT_EQ(field->name, "b");
+    EXPECT_EQ(field->object->kind, NodeKind::IDENT_EXPR);
+}
+
+TEST(Parser, MemberChainsCountTowardsNesting) {
+    std::string src = "a";
+    for (int i = 0; i < 100000; ++i) src += ".x";
+    src += ";";
+    Parser p(src);
+    p.parseProgram();
+    ASSERT_FALSE(p.errors().empty());
+    EXPECT_EQ(p.errors().back().message, "Nesting deeper than 256 levels");
+}
+
+// ============================================================
+// Block values, if and match expressions
+// ============================================================
+
+TEST(Parser, BlockTailIsItsValue) {
+    auto prog = parseOk("fn f() { let y = 1; y + 1 } fn g() { h(); }");
+    auto* body = as<BlockNode>(as<FnDeclNode>(prog->statements[0].get())->body.get());
+    ASSERT_EQ(body->statements.size(), 1u);
+    ASSERT_TRUE(body->value);
+    EXPECT_EQ(body->value->kind, NodeKind::BINARY_EXPR);
+    auto* g = as<BlockNode>(as<FnDeclNode>(prog->statements[1].get())->body.get());
+    EXPECT_FALSE(g->value);
+    EXPECT_EQ(g->statements.size(), 1u);
+}
+
+TEST(Parser, IfAndBlockInExpressionPosition) {
+    auto prog = parseOk("let x = if c { 1 } else if d { 2 } else { 3 }; "
+                        "let y = { let t = 2; t } * 2;");
+    auto* x = as<LetStmtNode>(prog->statements[0].get());
+    ASSERT_EQ(x->init->kind, NodeKind::IF_STMT);
+    auto* branch = as<IfStmtNode>(x->init.get());
+    EXPECT_TRUE(as<BlockNode>(branch->thenBranch.get())->value);
+    EXPECT_EQ(branch->elseBranch->kind, NodeKind::IF_STMT);
+    auto* mul = as<BinaryExprNode>(as<LetStmtNode>(prog->statements[1].get())->init.get());
+    ASSERT_EQ(mul->left->kind, NodeKind::BLOCK);
+    EXPECT_EQ(as<BlockNode>(mul->left.get())->statements.size(), 1u);
+}
+
+// A trailing if is the block's value only when every branch has one.
+TEST(Parser, TrailingIfWithValuesIsTheValue) {
+    auto prog = parseOk("fn f() { if a { 1 } else { 2 } } fn g() { if a { h(); } }");
+    auto* f = as<BlockNode>(as<FnDeclNode>(prog->statements[0].get())->body.get());
+    ASSERT_TRUE(f->value);
+    EXPECT_EQ(f->value->kind, NodeKind::IF_STMT);
+    auto* g = as<BlockNode>(as<FnDeclNode>(prog->statements[1].get())->body.get());
+    EXPECT_FALSE(g->value);
+    EXPECT_EQ(g->statements[0]->kind, NodeKind::IF_STMT);
+}
+
+TEST(Parser, TrailingIfWithALeavingBranchIsTheValue) {
+    // A branch that returns needs no value; one of them must have one.
+    auto prog = parseOk("fn f() { if a { 1 } else if b { return 2; } else { 3 } } "
+                        "fn g() { if a { return 1; } else { return 2; } }");
+    auto* f = as<BlockNode>(as<FnDeclNode>(prog->statements[0].get())->body.get());
+    ASSERT_TRUE(f->value);
+    EXPECT_EQ(f->value->kind, NodeKind::IF_STMT);
+    auto* g = as<BlockNode>(as<FnDeclNode>(prog->statements[1].get())->body.get());
+    EXPECT_FALSE(g->value);
+}
+
+TEST(Parser, MatchArms) {
+    auto prog = parseOk("fn f() { match x + 1 { 0 => a, 1 | -2 => { b } 3 => c, _ => d } }");
+    auto* body = as<BlockNode>(as<FnDeclNode>(prog->statements[0].get())->body.get());
+    ASSERT_TRUE(body->value);
+    ASSERT_EQ(body->value->kind, NodeKind::MATCH_EXPR);
+    auto* m = as<MatchExprNode>(body->value.get());
+    EXPECT_EQ(m->scrutinee->kind, NodeKind::BINARY_EXPR);
+    ASSERT_EQ(m->arms.size(), 4u);
+    auto* second = as<MatchArmNode>(m->arms[1].get());
+    ASSERT_EQ(second->patterns.size(), 2u);
+    int64_t value = 0;
+    EXPECT_TRUE(patternValue(second->patterns[1].get(), value));
+    EXPECT_EQ(value, -2);
+    EXPECT_EQ(second->body->kind, NodeKind::BLOCK);  // no ',' needed after a block
+    EXPECT_TRUE(as<MatchArmNode>(m->arms[3].get())->patterns.empty());  // `_`
+}
+
+TEST(Parser, MatchStatementNeedsNoSemicolon) {
+    auto prog = parseOk("fn f() { match x { _ => g(), } h(); let y = match x { _ => 1 }; }");
+    auto* body = as<BlockNode>(as<FnDeclNode>(prog->statements[0].get())->body.get());
+    ASSERT_EQ(body->statements.size(), 3u);
+    EXPECT_EQ(as<ExprStmtNode>(body->statements[0].get())->expr->kind, NodeKind::MATCH_EXPR);
+    EXPECT_EQ(as<LetStmtNode>(body->statements[2].get())->init->kind, NodeKind::MATCH_EXPR);
+}
+
+TEST(Parser, MatchErrors) {
+    struct Case { const char* src; const char* message; };
+    Case cases[] = {
+        {"match x 1 => 2 }", "Expected '{' after match scrutinee"},
+        {"match x { y => 1 }", "Expected an integer or '_' pattern, found 'y'"},
+        {"match x { 1 2 }", "Expected '=>' after match pattern"},
+        {"match x { 1 => 2 3 => 4 }", "Expected ',' or '}' after match arm"},
+    };
+    for (const Case& c : cases) {
+        Parser p(c.src);
+        p.parseProgram();
+        ASSERT_FALSE(p.errors().empty()) << c.src;
+        EXPECT_EQ(p.errors()[0].message, c.message) << c.src;
+    }
+}
+
 // ============================================================
 // Full program (integration)
 // ============================================================
@@ -361,3 +652,357 @@ TEST(Parser, ErrorContainsLineNumber) {
     ASSERT_FALSE(p.errors().empty());
     EXPECT_EQ(p.errors()[0].line, 1);
 }
+
+TEST(Parser, StrayClosingBraceAtTopLevelTerminates) {
+    Parser p("} let x = 1;");
+    auto prog = p.parseProgram();
+    EXPECT_TRUE(p.hasErrors());
+    ASSERT_FALSE(prog->statements.empty());
+    EXPECT_EQ(prog->statements.back()->kind, NodeKind::LET_STMT);
+}
+
+TEST(Parser, OneErrorPerStatement) {
+    Parser p("fn main() {\n"
+             "  let x = ;\n"
+             "  let y = (1 + ;\n"
+             "  foo(1 2);\n"
+             "  let z = 3;\n"
+             "}\n");
+    auto prog = p.parseProgram();
+    ASSERT_EQ(p.errors().size(), 3u);
+    EXPECT_EQ(p.errors()[0].line, 2);
+    EXPECT_EQ(p.errors()[1].line, 3);
+    EXPECT_EQ(p.errors()[2].line, 4);
+    EXPECT_EQ(p.errors()[2].message, "Expected ')' after call arguments");
+    // Recovery resumes at the next statement.
+    auto* body = as<BlockNode>(as<FnDeclNode>(prog->statements[0].get())->body.get());
+    EXPECT_EQ(body->statements.back()->kind, NodeKind::LET_STMT);
+    EXPECT_EQ(as<LetStmtNode>(body->statements.back().get())->name, "z");
+}
+
+TEST(Parser, MissingBraceLeavesBlockEmpty) {
+    Parser p("fn f() let x = 1; fn g() {}");
+    auto prog = p.parseProgram();
+    ASSERT_EQ(p.errors().size(), 1u);
+    EXPECT_EQ(p.errors()[0].message, "Expected '{'");
+    ASSERT_EQ(prog->statements.size(), 3u);
+    EXPECT_EQ(prog->statements[1]->kind, NodeKind::LET_STMT);
+    EXPECT_EQ(prog->statements[2]->kind, NodeKind::FN_DECL);
+}
+
+TEST(Parser, MaxErrorsStopsParsing) {
+    std::string src;
+    for (int i = 0; i < 50; ++i) src += "let = 1;\n";
+    Parser p(src);
+    p.setMaxErrors(5);
+    p.parseProgram();
+    EXPECT_EQ(p.errors().size(), 5u);
+    EXPECT_TRUE(p.stoppedEarly());
+
+    Parser unlimited(src);
+    unlimited.parseProgram();
+    EXPECT_EQ(unlimited.errors().size(), 50u);
+    EXPECT_FALSE(unlimited.stoppedEarly());
+}
+
+TEST(Parser, DeepNestingStopsWithAnError) {
+    for (const char* open : {"(", "{", "-", "while x { ", "fn "}) {
+        std::string src;
+        for (int i = 0; i < 100000; ++i) src += open;
+        Parser p(src);
+        p.parseProgram();
+        ASSERT_FALSE(p.errors().empty()) << open;
+        if (std::string(open) != "fn ") {
+            EXPECT_TRUE(p.stoppedEarly()) << open;
+            EXPECT_EQ(p.errors().back().message, "Nesting deeper than 256 levels") << open;
+        }
+    }
+}
+
+// `1 + 1 + ...` is built in a loop but is as deep as it is long.
+TEST(Parser, OperatorChainsCountTowardsNesting) {
+    for (const char* op : {" + ", " * ", " < ", " - 2 * "}) {
+        std::string chain = "1";
+        for (int i = 1; i < 100000; ++i) chain += op + std::string("1");
+        Parser p("fn main() { let x = " + chain + "; }");
+        p.parseProgram();
+        EXPECT_TRUE(p.stoppedEarly()) << op;
+        ASSERT_FALSE(p.errors().empty()) << op;
+        EXPECT_EQ(p.errors().back().message, "Nesting deeper than 256 levels") << op;
+    }
+    std::string chain = "1";
+    for (int i = 1; i < 200; ++i) chain += " + 1";
+    parseOk("fn main() { let x = " + chain + "; }");
+}
+
+TEST(Parser, BinaryLexemesAreEscapedInMessages) {
+    Parser p(std::string("let x = \x01\x7f;"));
+    p.parseProgram();
+    ASSERT_EQ(p.errors().size(), 1u);
+    EXPECT_EQ(p.errors()[0].message, "Unexpected token '\\x01' in expression");
+}
+
+TEST(Parser, DiagnosticsPointAtTheToken) {
+    std::string src = "let x = 1;\nlet y = ;";
+    Parser p(src);
+    p.parseProgram();
+    ASSERT_EQ(p.diagnostics().size(), 1u);
+    const Diagnostic& d = p.diagnostics()[0];
+    EXPECT_EQ(d.code, DiagCode::UNEXPECTED_TOKEN);
+    EXPECT_EQ(d.line, 2);
+    EXPECT_EQ(d.offset, src.find(';', 10));
+    EXPECT_EQ(d.length, 1u);
+    EXPECT_EQ(p.errors()[0].message, formatDiagnostic(d, src));
+}
+
+TEST(Parser, InvalidUtf8IsReportedWhereItIs) {
+    std::string src = "let s = \"a\xff" "b\";\n// \xe2\x82\nlet café = 1;\nlet y = café \xc0;";
+    Parser p(src);
+    auto program = p.parseProgram();
+    ASSERT_EQ(p.diagnostics().size(), 3u);
+    for (const Diagnostic& d : p.diagnostics()) EXPECT_EQ(d.code, DiagCode::INVALID_UTF8);
+    EXPECT_EQ(p.diagnostics()[0].offset, src.find('\xff'));
+    EXPECT_EQ(p.diagnostics()[0].line, 1);
+    EXPECT_EQ(p.diagnostics()[1].offset, src.find('\xe2'));
+    EXPECT_EQ(p.diagnostics()[1].length, 2u);
+    EXPECT_EQ(p.diagnostics()[1].line, 2);
+    EXPECT_EQ(p.diagnostics()[2].line, 4);
+    EXPECT_EQ(p.errors()[0].message, "Invalid UTF-8 '\\xff'");
+    EXPECT_EQ(p.errors()[1].message, "Invalid UTF-8 '\\xe2\\x82'");
+    // Parsing goes on as if the bytes were not there.
+    ASSERT_EQ(program->statements.size(), 3u);
+}
+
+TEST(Parser, RandomBytesTerminate) {
+    std::mt19937 rng(7);
+    for (int round = 0; round < 20; ++round) {
+        std::string src(4096, '\0');
+        for (char& c : src) c = static_cast<char>(rng());
+        Parser p(src);
+        auto prog = p.parseProgram();
+        EXPECT_TRUE(p.hasErrors());
+        EXPECT_FALSE(p.stoppedEarly());
+    }
+}
+
+// ============================================================
+// Incremental reparsing
+// ============================================================
+
+// The incremental tree must always equal a from-scratch parse.
+static void expectMatchesFullParse(const IncrementalParser& inc) {
+    Parser full(inc.source());
+    auto prog = full.parseProgram();
+    ASSERT_TRUE(astEqual(inc.program(), prog.get())) << "Source:\n" << inc.source();
+    ASSERT_EQ(inc.errors().size(), full.errors().size()) << "Source:\n" << inc.source();
+    for (size_t i = 0; i < full.errors().size(); ++i) {
+        EXPECT_EQ(inc.errors()[i].message, full.errors()[i].message);
+        EXPECT_EQ(inc.errors()[i].line, full.errors()[i].line);
+    }
+}
+
+static const char* INCREMENTAL_SRC =
+    "fn a(x: i32) {\n"
+    "    let y = x + 1;\n"
+    "    return y;\n"
+    "}\n"
+    "\n"
+    "fn b() {\n"
+    "    while 1 < 2 { b(); }\n"
+    "}\n"
+    "\n"
+    "fn c() {\n"
+    "    if a(1) == 2 { return; } else { c(); }\n"
+    "}\n";
+
+TEST(IncrementalParser, EditInsideOneFunctionReparsesOnlyIt) {
+    IncrementalParser inc(INCREMENTAL_SRC);
+    ASSERT_FALSE(inc.hasErrors());
+
+    // "x + 1" -> "x + 42"
+    size_t pos = inc.source().find("1;");
+    inc.applyEdit(TextEdit{pos, pos + 1, "42"});
+    EXPECT_TRUE(inc.lastEditWasIncremental());
+    EXPECT_EQ(inc.lastReparsedItems(), 1u);
+    expectMatchesFullParse(inc);
+}
+
+TEST(IncrementalParser, InsertedLinesShiftLaterItems) {
+    IncrementalParser inc(INCREMENTAL_SRC);
+    size_t pos = inc.source().find("    return y;");
+    inc.applyEdit(TextEdit{pos, pos, "    let z = 2;\n    let w = 3;\n"});
+    EXPECT_TRUE(inc.lastEditWasIncremental());
+    expectMatchesFullParse(inc);
+    EXPECT_EQ(inc.program()->statements[2]->line, 12);
+}
+
+TEST(IncrementalParser, LaterItemsCatchUpOnLinesWhenAccessed) {
+    IncrementalParser inc(INCREMENTAL_SRC);
+    AstNode* c = inc.item(2);
+    ASSERT_EQ(c->line, 10);
+
+    size_t pos = inc.source().find("    return y;");
+    inc.applyEdit(TextEdit{pos, pos, "\n\n"});
+    ASSERT_TRUE(inc.lastEditWasIncremental());
+    // The edit itself leaves the kept item alone...
+    EXPECT_EQ(c->line, 10);
+    // ...and accessing it brings the same node up to date.
+    EXPECT_EQ(inc.item(2), c);
+    EXPECT_EQ(c->line, 12);
+    expectMatchesFullParse(inc);
+}
+
+TEST(IncrementalParser, EditsStayLocalAroundItemsWithErrors) {
+    IncrementalParser inc(INCREMENTAL_SRC);
+
+    // Break `b`; only `b` is reparsed and the error is its own.
+    size_t pos = inc.source().find("b(); }");
+    inc.applyEdit(TextEdit{pos + 1, pos + 2, ""});
+    EXPECT_TRUE(inc.lastEditWasIncremental());
+    EXPECT_EQ(inc.lastReparsedItems(), 1u);
+    ASSERT_EQ(inc.errors().size(), 1u);
+    EXPECT_EQ(inc.errors()[0].line, 7);
+    expectMatchesFullParse(inc);
+
+    // An edit in `a` shifts `b`'s error along with it...
+    pos = inc.source().find("    return y;");
+    inc.applyEdit(TextEdit{pos, pos, "    let z = 2;\n"});
+    EXPECT_TRUE(inc.lastEditWasIncremental());
+    EXPECT_EQ(inc.lastReparsedItems(), 1u);
+    ASSERT_EQ(inc.errors().size(), 1u);
+    EXPECT_EQ(inc.errors()[0].line, 8);
+    expectMatchesFullParse(inc);
+
+    // ...and fixing `b` again clears it, still without a full parse.
+    pos = inc.source().find("b); }");
+    inc.applyEdit(TextEdit{pos + 1, pos + 1, "("});
+    EXPECT_TRUE(inc.lastEditWasIncremental());
+    EXPECT_FALSE(inc.hasErrors());
+    expectMatchesFullParse(inc);
+}
+
+TEST(IncrementalParser, OpeningBlockCommentFallsBackToFullParse) {
+    IncrementalParser inc(INCREMENTAL_SRC);
+    size_t pos = inc.source().find("fn b");
+    inc.applyEdit(TextEdit{pos - 1, pos - 1, "/*"});
+    EXPECT_FALSE(inc.lastEditWasIncremental());
+    expectMatchesFullParse(inc);
+}
+
+TEST(IncrementalParser, DifferentialFuzzAgainstFullParse) {
+    static const char* FRAGMENTS[] = {
+        " ", "\n", "x", "y1", "fn", "let", "mut", "if", "else", "while", "return",
+        "{", "}", "(", ")", ";", ":", ",", "=", "==", "+", "-", "*", "/", "<", ">=",
+        "0", "42", "\"s\"", "\"", "//", "/*", "*/", "f(1)", "let z = 3;", "\n}\n",
+        "struct", "impl", "match", "=>", "..", ".", "1.", "'a'", "r#\"", "\xff", "fn q() {",
+    };
+    std::mt19937 rng(12345);
+    size_t incremental = 0;
+    size_t incrementalWithErrors = 0;
+
+    auto inc = std::make_unique<IncrementalParser>(INCREMENTAL_SRC);
+    for (int step = 0; step < 5000; ++step) {
+        // Errors pile up as edits go on; start over now and then so that edits
+        // keep landing on both clean and broken trees.
+        if (step % 50 == 0) {
+            inc = std::make_unique<IncrementalParser>(INCREMENTAL_SRC);
+        }
+        bool hadErrors = inc->hasErrors();
+        const std::string& src = inc->source();
+
+        // Half the edits land on a line break, where item boundaries are.
+        size_t begin = rng() % (src.size() + 1);
+        if (rng() % 2) begin = std::min(src.size(), src.find('\n', begin));
+        size_t end = std::min(src.size(), begin + rng() % 4);
+        std::string text;
+        for (unsigned k = rng() % 3; k > 0; --k) {
+            text += FRAGMENTS[rng() % (sizeof(FRAGMENTS) / sizeof(FRAGMENTS[0]))];
+        }
+
+        inc->applyEdit(TextEdit{begin, end, text});
+        if (inc->lastEditWasIncremental()) {
+            incremental++;
+            if (hadErrors) incrementalWithErrors++;
+        }
+        expectMatchesFullParse(*inc);
+        if (::testing::Test::HasFatalFailure()) return;
+    }
+    // Make sure the fast path was actually exercised, errors or not.
+    EXPECT_GT(incremental, 500u);
+    EXPECT_GT(incrementalWithErrors, 500u);
+}
+
+// ============================================================
+// ParseListener
+// ============================================================
+
+struct RecordingListener : ParseListener {
+    std::vector<NodeKind> built;
+    std::vector<size_t> items;
+
+    void onNodeBuilt(AstNodePtr& node) override { built.push_back(node->kind); }
+    void onItemBuilt(size_t index) override { items.push_back(index); }
+};
+
+TEST(ParseListener, SeesEveryNodeChildrenFirst) {
+    Parser parser("fn f() { return (1 + 2); } let x = f();");
+    RecordingListener listener;
+    parser.setListener(&listener);
+    auto program = parser.parseProgram();
+    ASSERT_FALSE(parser.hasErrors());
+    std::vector<NodeKind> expected = {
+        NodeKind::NUMBER_LITERAL, NodeKind::NUMBER_LITERAL, NodeKind::BINARY_EXPR,
+        NodeKind::RETURN_STMT,    NodeKind::BLOCK,          NodeKind::FN_DECL,
+        NodeKind::CALL_EXPR,      NodeKind::LET_STMT,       NodeKind::PROGRAM,
+    };
+    EXPECT_EQ(listener.built, expected);
+    EXPECT_EQ(listener.items, (std::vector<size_t>{0, 1}));
+}
+
+TEST(ParseListener, MayReplaceExpressions) {
+    // Replaces every binary expression with its left operand.
+    struct KeepLeft : ParseListener {
+        void onNodeBuilt(AstNodePtr& node) override {
+            if (node->kind != NodeKind::BINARY_EXPR) return;
+            AstNodePtr left = std::move(static_cast<BinaryExprNode*>(node.get())->left);
+            node = std::move(left);
+        }
+    } listener;
+    Parser parser("let x = a * b + c;");
+    parser.setListener(&listener);
+    auto program = parser.parseProgram();
+    auto* let = as<LetStmtNode>(program->statements[0].get());
+    ASSERT_EQ(let->init->kind, NodeKind::IDENT_EXPR);
+    EXPECT_EQ(as<IdentExprNode>(let->init.get())->name, "a");
+}
+
+static const char* scopeName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::FN_DECL: return "fn";
+        case NodeKind::BLOCK: return "block";
+        case NodeKind::FOR_STMT: return "for";
+        default: return nullptr;
+    }
+}
+
+TEST(ParseListener, ScopesCloseWithTheirNode) {
+    struct Scopes : ParseListener {
+        std::string trace;
+        void onScopeEntered(AstNode& node) override {
+            trace += std::string("<") + scopeName(node.kind) + " ";
+        }
+        void onNodeBuilt(AstNodePtr& node) override {
+            if (const char* name = scopeName(node->kind)) {
+                trace += std::string(name) + "> ";
+            } else if (node->kind == NodeKind::IDENT_EXPR) {
+                trace += static_cast<IdentExprNode*>(node.get())->name + " ";
+            }
+        }
+    } listener;
+    // The second block has no '{' and is left empty.
+    Parser parser("fn f(a: i32) { for i in a..b { c } } fn g()");
+    parser.setListener(&listener);
+    parser.parseProgram();
+    EXPECT_EQ(listener.trace,
+              "<fn <block a b <for <block c block> for> block> fn> <fn <block block> fn> ");
+}
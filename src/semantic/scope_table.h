@@ -0,0 +1,149 @@
+#ifndef SCOPE_TABLE_H
+#define SCOPE_TABLE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// ============================================================
+// ScopeTable — flat, scoped symbol table
+// ============================================================
+//
+// All bindings live in one contiguous array; entering a scope records the
+// array size and leaving it truncates back to that mark. Names map to their
+// innermost binding through a single open-addressing table, and each binding
+// links to the binding it shadows, so leaving a scope only touches the
+// bindings declared in it and nothing is allocated per scope.
+//
+// Names are held as string_views: the strings (normally AST payloads) must
+// outlive the table.
+template <typename Symbol>
+class ScopeTable {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Binding {
+        std::string_view name;
+        uint32_t shadowed;  // previous binding of the same name, or NONE
+        uint32_t slot;      // index into the name table
+        Symbol symbol;
+    };
+
+    ScopeTable() : slots_(16), used_(0) {}
+
+    void enterScope() {
+        marks_.push_back(static_cast<uint32_t>(bindings_.size()));
+    }
+
+    // Pops every binding declared since the matching enterScope().
+    void exitScope() {
+        uint32_t mark = marks_.back();
+        marks_.pop_back();
+        while (bindings_.size() > mark) {
+            const Binding& b = bindings_.back();
+            slots_[b.slot].top = b.shadowed;
+            bindings_.pop_back();
+        }
+    }
+
+    // Adds a binding to the innermost scope and returns its index.
+    uint32_t declare(std::string_view name, const Symbol& symbol) {
+        uint32_t slot = findOrInsert(name);
+        uint32_t index = static_cast<uint32_t>(bindings_.size());
+        bindings_.push_back(Binding{name, slots_[slot].top, slot, symbol});
+        slots_[slot].top = index;
+        return index;
+    }
+
+    // Innermost binding of `name`, or NONE. Follow binding(i).shadowed for outer ones.
+    uint32_t lookup(std::string_view name) const {
+        uint32_t slot = find(name);
+        return slot == NONE ? NONE : slots_[slot].top;
+    }
+
+    // Binding of `name` declared in the innermost scope, or NONE.
+    uint32_t lookupInCurrentScope(std::string_view name) const {
+        uint32_t index = lookup(name);
+        return (index != NONE && index >= scopeStart()) ? index : NONE;
+    }
+
+    Binding& binding(uint32_t index) { return bindings_[index]; }
+    const Binding& binding(uint32_t index) const { return bindings_[index]; }
+
+    // Index of the first binding of the innermost scope.
+    uint32_t scopeStart() const { return marks_.empty() ? 0 : marks_.back(); }
+    uint32_t size() const { return static_cast<uint32_t>(bindings_.size()); }
+    size_t depth() const { return marks_.size(); }
+
+private:
+    // Distinct names stay in the table once seen (with top = NONE when out of
+    // scope), so there is never a deletion to handle.
+    struct Slot {
+        std::string_view name;
+        uint32_t hash = 0;
+        uint32_t top = NONE;
+        bool used = false;
+    };
+
+    std::vector<Binding> bindings_;
+    std::vector<uint32_t> marks_;
+    std::vector<Slot> slots_;  // power-of-two capacity, linear probing
+    size_t used_;
+
+    static uint32_t hashName(std::string_view name) {
+        uint32_t h = 2166136261u;  // FNV-1a
+        for (char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    uint32_t find(std::string_view name) const {
+        uint32_t hash = hashName(name);
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& s = slots_[i];
+            if (!s.used) return NONE;
+            if (s.hash == hash && s.name == name) return static_cast<uint32_t>(i);
+        }
+    }
+
+    uint32_t findOrInsert(std::string_view name) {
+        uint32_t hash = hashName(name);
+        size_t mask = slots_.size() - 1;
+        size_t i = hash & mask;
+        for (;; i = (i + 1) & mask) {
+            Slot& s = slots_[i];
+            if (!s.used) break;
+            if (s.hash == hash && s.name == name) return static_cast<uint32_t>(i);
+        }
+        if ((used_ + 1) * 2 > slots_.size()) {
+            grow();
+            return findOrInsert(name);
+        }
+        slots_[i].name = name;
+        slots_[i].hash = hash;
+        slots_[i].used = true;
+        used_++;
+        return static_cast<uint32_t>(i);
+    }
+
+    // Doubles the name table; bindings are re-pointed at their new slots.
+    void grow() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        std::vector<uint32_t> moved(old.size(), NONE);
+        size_t mask = slots_.size() - 1;
+        for (size_t j = 0; j < old.size(); ++j) {
+            if (!old[j].used) continue;
+            size_t i = old[j].hash & mask;
+            while (slots_[i].used) i = (i + 1) & mask;
+            slots_[i] = old[j];
+            moved[j] = static_cast<uint32_t>(i);
+        }
+        for (auto& b : bindings_) b.slot = moved[b.slot];
+    }
+};
+
+#endif // SCOPE_TABLE_H
@@ -0,0 +1,576 @@
+#include "semantic.h"
+#include "../util/thread_pool.h"
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+
+// ============================================================
+// Types
+// ============================================================
+
+const char* typeInfoToString(TypeInfo type) {
+    switch (type) {
+        case TypeInfo::UNKNOWN: return "{unknown}";
+        case TypeInfo::INT:     return "integer";
+        case TypeInfo::BOOL:    return "bool";
+        case TypeInfo::STR:     return "string";
+        case TypeInfo::UNIT:    return "()";
+    }
+    return "{unknown}";
+}
+
+TypeInfo typeFromName(const std::string& name) {
+    static const char* const INTEGER_TYPES[] = {
+        "i8", "i16", "i32", "i64", "i128", "isize",
+        "u8", "u16", "u32", "u64", "u128", "usize",
+    };
+    for (const char* t : INTEGER_TYPES) {
+        if (name == t) return TypeInfo::INT;
+    }
+    if (name == "bool") return TypeInfo::BOOL;
+    if (name == "String" || name == "str") return TypeInfo::STR;
+    return TypeInfo::UNKNOWN;
+}
+
+// Two types conflict only if both are known and differ.
+static bool mismatched(TypeInfo a, TypeInfo b) {
+    return a != TypeInfo::UNKNOWN && b != TypeInfo::UNKNOWN && a != b;
+}
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+SemanticAnalyzer::SemanticAnalyzer(ProgramNode* root)
+    : root_(root) {}
+
+SemanticAnalyzer::SemanticAnalyzer(const ScopeTable<Symbol>* globals)
+    : root_(nullptr), globals_(globals) {}
+
+bool SemanticAnalyzer::hasErrors() const {
+    return !errors_.empty();
+}
+
+const std::vector<SemanticError>& SemanticAnalyzer::errors() const {
+    return errors_;
+}
+
+void SemanticAnalyzer::recordError(const std::string& msg, int line) {
+    errors_.push_back(SemanticError{msg, line});
+}
+
+bool SemanticAnalyzer::analyze() {
+    if (!root_) return true;
+    scopes_.enterScope();
+    declareItems(root_->statements);
+    analyzeStatements(root_->statements);
+    scopes_.exitScope();
+    return errors_.empty();
+}
+
+bool SemanticAnalyzer::analyzeParallel(ThreadPool& pool) {
+    if (!root_) return true;
+    const auto& statements = root_->statements;
+
+    // Phase 1 (serial): bind the top-level items. scopes_ is read-only from
+    // here on and shared by every worker as its globals_ table.
+    scopes_.enterScope();
+    declareItems(statements);
+
+    // Phase 2: each top-level function is one unit. The other top-level
+    // statements see each other's bindings in order, so together they form
+    // a single unit.
+    static constexpr size_t TOP_LEVEL = static_cast<size_t>(-1);
+    std::vector<size_t> units;
+    bool hasTopLevelCode = false;
+    for (size_t i = 0; i < statements.size(); ++i) {
+        if (!statements[i]) continue;
+        if (statements[i]->kind == NodeKind::FN_DECL) {
+            units.push_back(i);
+        } else {
+            hasTopLevelCode = true;
+        }
+    }
+    if (hasTopLevelCode) units.insert(units.begin(), TOP_LEVEL);
+
+    // Errors of statement `item` are errors[begin, end) of the worker that ran it.
+    struct Span {
+        size_t item;
+        unsigned worker;
+        size_t begin, end;
+    };
+    std::vector<std::unique_ptr<SemanticAnalyzer>> workers(pool.size());
+    std::vector<std::vector<Span>> spans(pool.size());
+
+    pool.parallelFor(units.size(), [&](size_t u, unsigned w) {
+        if (!workers[w]) workers[w].reset(new SemanticAnalyzer(&scopes_));
+        SemanticAnalyzer& a = *workers[w];
+        a.scopes_.enterScope();  // the program scope, minus the items in globals_
+        auto run = [&](size_t i) {
+            size_t begin = a.errors_.size();
+            a.analyzeStmt(statements[i].get());
+            if (a.errors_.size() > begin) spans[w].push_back(Span{i, w, begin, a.errors_.size()});
+        };
+        if (units[u] != TOP_LEVEL) {
+            run(units[u]);
+        } else {
+            for (size_t i = 0; i < statements.size(); ++i) {
+                if (statements[i] && statements[i]->kind != NodeKind::FN_DECL) run(i);
+            }
+        }
+        a.scopes_.exitScope();
+    });
+    scopes_.exitScope();
+
+    // Merge in source order; phase-1 errors come first, as in analyze().
+    std::vector<Span> all;
+    for (const auto& s : spans) all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end(),
+              [](const Span& a, const Span& b) { return a.item < b.item; });
+    for (const auto& s : all) {
+        const auto& src = workers[s.worker]->errors_;
+        errors_.insert(errors_.end(), src.begin() + s.begin, src.begin() + s.end);
+    }
+    return errors_.empty();
+}
+
+// Innermost symbol named `name` visible from the current function, or nullptr.
+const Symbol* SemanticAnalyzer::resolve(const std::string& name) const {
+    uint32_t index = scopes_.lookup(name);
+    while (index != ScopeTable<Symbol>::NONE) {
+        const auto& b = scopes_.binding(index);
+        if (index >= fnBase_ || b.symbol.kind == Symbol::FUNCTION) return &b.symbol;
+        index = b.shadowed;
+    }
+    if (globals_) {
+        index = globals_->lookup(name);
+        if (index != ScopeTable<Symbol>::NONE) return &globals_->binding(index).symbol;
+    }
+    return nullptr;
+}
+
+// True if `name` is bound in the innermost scope. In a parallel worker the
+// program scope is split between globals_ and the bottom scope of scopes_.
+bool SemanticAnalyzer::declaredInCurrentScope(const std::string& name) const {
+    if (scopes_.lookupInCurrentScope(name) != ScopeTable<Symbol>::NONE) return true;
+    return globals_ && scopes_.depth() == 1 &&
+           globals_->lookup(name) != ScopeTable<Symbol>::NONE;
+}
+
+// ============================================================
+// Statements
+// ============================================================
+
+// Items are visible throughout their enclosing block, before and after the
+// declaration, so they are bound before any statement is checked.
+void SemanticAnalyzer::declareItems(const std::vector<AstNodePtr>& statements) {
+    for (const auto& stmt : statements) {
+        if (!stmt || stmt->kind != NodeKind::FN_DECL) continue;
+        auto* fn = static_cast<FnDeclNode*>(stmt.get());
+        if (declaredInCurrentScope(fn->name)) {
+            recordError("Function '" + fn->name + "' is already defined in this scope", fn->line);
+            continue;
+        }
+        Symbol sym{Symbol::FUNCTION, false, TypeInfo::UNKNOWN,
+                   static_cast<uint32_t>(fn->params.size())};
+        scopes_.declare(fn->name, sym);
+    }
+}
+
+void SemanticAnalyzer::analyzeStatements(const std::vector<AstNodePtr>& statements) {
+    for (const auto& stmt : statements) {
+        analyzeStmt(stmt.get());
+    }
+}
+
+void SemanticAnalyzer::analyzeStmt(AstNode* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NodeKind::FN_DECL:
+            analyzeFnDecl(static_cast<FnDeclNode*>(node));
+            break;
+        case NodeKind::STRUCT_DECL:
+            analyzeStructDecl(static_cast<StructDeclNode*>(node));
+            break;
+        case NodeKind::IMPL_BLOCK:
+            // Methods are reached through their receiver, never by name, so
+            // they are not bound; each is checked like a function.
+            for (auto& method : static_cast<ImplBlockNode*>(node)->methods) {
+                analyzeStmt(method.get());
+            }
+            break;
+        case NodeKind::BLOCK:
+            analyzeBlock(static_cast<BlockNode*>(node));
+            break;
+        case NodeKind::LET_STMT:
+            analyzeLet(static_cast<LetStmtNode*>(node));
+            break;
+        case NodeKind::RETURN_STMT: {
+            auto* n = static_cast<ReturnStmtNode*>(node);
+            TypeInfo type = n->value ? analyzeExpr(n->value.get()) : TypeInfo::UNIT;
+            if (mismatched(returnType_, type)) {
+                recordError(std::string("Mismatched return type: expected ") +
+                            typeInfoToString(returnType_) + ", found " + typeInfoToString(type),
+                            n->line);
+            }
+            break;
+        }
+        case NodeKind::WHILE_STMT: {
+            auto* n = static_cast<WhileStmtNode*>(node);
+            analyzeCondition(n->condition.get());
+            analyzeLoopBody(n->body.get());
+            break;
+        }
+        case NodeKind::LOOP_STMT:
+            if (!analyzeLoopBody(static_cast<LoopStmtNode*>(node)->body.get())) {
+                diverging_ = node;
+            }
+            break;
+        case NodeKind::FOR_STMT:
+            analyzeFor(static_cast<ForStmtNode*>(node));
+            break;
+        case NodeKind::BREAK_STMT:
+            if (loopDepth_ == 0) recordError("'break' outside of a loop", node->line);
+            loopBroken_ = true;
+            break;
+        case NodeKind::CONTINUE_STMT:
+            if (loopDepth_ == 0) recordError("'continue' outside of a loop", node->line);
+            break;
+        case NodeKind::IF_STMT:
+            // Branches without values are UNIT; UNKNOWN means none finishes.
+            if (analyzeIf(static_cast<IfStmtNode*>(node)) == TypeInfo::UNKNOWN) {
+                diverging_ = node;
+            }
+            break;
+        case NodeKind::EXPR_STMT:
+            analyzeExpr(static_cast<ExprStmtNode*>(node)->expr.get());
+            break;
+        default:
+            analyzeExpr(node);
+            break;
+    }
+}
+
+void SemanticAnalyzer::analyzeFnDecl(FnDeclNode* node) {
+    uint32_t savedBase = fnBase_, savedLoops = loopDepth_;
+    TypeInfo savedReturn = returnType_;
+    bool savedBroken = loopBroken_;
+    fnBase_ = scopes_.size();
+    loopDepth_ = 0;
+    returnType_ = typeFromName(node->returnType);
+    scopes_.enterScope();
+
+    for (const auto& param : node->params) {
+        if (declaredInCurrentScope(param.name)) {
+            recordError("Duplicate parameter '" + param.name + "' in function '" +
+                        node->name + "'", param.line);
+            continue;
+        }
+        Symbol sym{Symbol::VARIABLE, false, typeFromName(param.typeName), 0};
+        scopes_.declare(param.name, sym);
+    }
+    // A body's value is what the function returns when it runs off the end.
+    TypeInfo result = analyzeExpr(node->body.get());
+    const AstNode* tail = node->body && node->body->kind == NodeKind::BLOCK
+                              ? static_cast<BlockNode*>(node->body.get())->value.get()
+                              : nullptr;
+    if (tail && mismatched(returnType_, result)) {
+        recordError(std::string("Mismatched return type: expected ") +
+                    typeInfoToString(returnType_) + ", found " + typeInfoToString(result),
+                    tail->line);
+    } else if (!tail && mismatched(returnType_, result)) {
+        recordError("Function '" + node->name + "' must return " +
+                    typeInfoToString(returnType_) + " but can reach the end of its body",
+                    node->line);
+    }
+
+    scopes_.exitScope();
+    fnBase_ = savedBase;
+    loopDepth_ = savedLoops;
+    returnType_ = savedReturn;
+    loopBroken_ = savedBroken;
+}
+
+void SemanticAnalyzer::analyzeStructDecl(StructDeclNode* node) {
+    const auto& fields = node->fields;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (fields[j].name == fields[i].name) {
+                recordError("Duplicate field '" + fields[i].name + "' in struct '" +
+                            node->name + "'", fields[i].line);
+                break;
+            }
+        }
+    }
+}
+
+// The loop variable takes the integer type of a range and is immutable.
+void SemanticAnalyzer::analyzeFor(ForStmtNode* node) {
+    bool range = isRangeExpr(node->iterable.get());
+    if (range) {
+        analyzeRange(static_cast<BinaryExprNode*>(node->iterable.get()));
+    } else {
+        TypeInfo iterable = analyzeExpr(node->iterable.get());
+        if (iterable != TypeInfo::UNKNOWN) {
+            recordError(std::string("Cannot iterate over ") + typeInfoToString(iterable),
+                        node->iterable->line);
+        }
+    }
+    scopes_.enterScope();
+    TypeInfo type = range ? TypeInfo::INT : TypeInfo::UNKNOWN;
+    scopes_.declare(node->name, Symbol{Symbol::VARIABLE, false, type, 0});
+    analyzeLoopBody(node->body.get());
+    scopes_.exitScope();
+}
+
+// A for loop's iterable is the only place a range may appear: it has no
+// value of its own.
+void SemanticAnalyzer::analyzeRange(BinaryExprNode* node) {
+    TypeInfo left = analyzeExpr(node->left.get());
+    TypeInfo right = analyzeExpr(node->right.get());
+    if (mismatched(left, TypeInfo::INT) || mismatched(right, TypeInfo::INT)) {
+        recordError("Range bounds must be integers, found " + std::string(typeInfoToString(left)) +
+                    " and " + typeInfoToString(right), node->line);
+    }
+}
+
+// True if the body has a `break` for this loop.
+bool SemanticAnalyzer::analyzeLoopBody(AstNode* body) {
+    bool savedBroken = loopBroken_;
+    loopBroken_ = false;
+    ++loopDepth_;
+    analyzeStmt(body);
+    --loopDepth_;
+    bool broken = loopBroken_;
+    loopBroken_ = savedBroken;
+    return broken;
+}
+
+// The type of the block's value, or () without one. A block that ends in
+// return, break or continue, or in a statement that never finishes, never
+// yields a value; it gets UNKNOWN, so that `if c { 1 } else { return 0; }`
+// checks.
+TypeInfo SemanticAnalyzer::analyzeBlock(BlockNode* node) {
+    scopes_.enterScope();
+    declareItems(node->statements);
+    analyzeStatements(node->statements);
+    TypeInfo type = TypeInfo::UNIT;
+    if (node->value) {
+        type = analyzeExpr(node->value.get());
+    } else if (!node->statements.empty() && node->statements.back()) {
+        NodeKind last = node->statements.back()->kind;
+        if (last == NodeKind::RETURN_STMT || last == NodeKind::BREAK_STMT ||
+            last == NodeKind::CONTINUE_STMT || node->statements.back().get() == diverging_) {
+            type = TypeInfo::UNKNOWN;
+        }
+    }
+    scopes_.exitScope();
+    return type;
+}
+
+void SemanticAnalyzer::analyzeLet(LetStmtNode* node) {
+    // The initializer is checked before the name is bound: `let x = x;`
+    // refers to an outer x.
+    TypeInfo initType = analyzeExpr(node->init.get());
+    TypeInfo type = initType;
+
+    if (!node->typeName.empty()) {
+        TypeInfo declared = typeFromName(node->typeName);
+        if (mismatched(declared, initType)) {
+            recordError("Mismatched types in let '" + node->name + "': expected " +
+                        typeInfoToString(declared) + ", found " + typeInfoToString(initType),
+                        node->line);
+        }
+        type = declared;
+    }
+
+    if (declaredInCurrentScope(node->name)) {
+        recordError("Variable '" + node->name + "' is already declared in this scope", node->line);
+        return;
+    }
+    scopes_.declare(node->name, Symbol{Symbol::VARIABLE, node->isMut, type, 0});
+}
+
+void SemanticAnalyzer::analyzeCondition(AstNode* condition) {
+    TypeInfo type = analyzeExpr(condition);
+    if (mismatched(type, TypeInfo::BOOL)) {
+        recordError(std::string("Condition must be bool, found ") + typeInfoToString(type),
+                    condition->line);
+    }
+}
+
+// ============================================================
+// Expressions
+// ============================================================
+
+TypeInfo SemanticAnalyzer::analyzeExpr(AstNode* node) {
+    if (!node) return TypeInfo::UNKNOWN;
+
+    switch (node->kind) {
+        case NodeKind::NUMBER_LITERAL:
+            return TypeInfo::INT;
+        case NodeKind::STRING_LITERAL:
+            return TypeInfo::STR;
+        case NodeKind::IDENT_EXPR: {
+            auto* n = static_cast<IdentExprNode*>(node);
+            if (n->name == "true" || n->name == "false") return TypeInfo::BOOL;
+            const Symbol* sym = resolve(n->name);
+            if (!sym) {
+                recordError("Use of undeclared variable '" + n->name + "'", n->line);
+                return TypeInfo::UNKNOWN;
+            }
+            return sym->type;
+        }
+        case NodeKind::ASSIGN_EXPR: {
+            auto* n = static_cast<AssignExprNode*>(node);
+            TypeInfo valueType = analyzeExpr(n->value.get());
+            const Symbol* sym = resolve(n->target);
+            if (!sym) {
+                recordError("Assignment to undeclared variable '" + n->target + "'", n->line);
+                return TypeInfo::UNIT;
+            }
+            if (sym->kind == Symbol::FUNCTION) {
+                recordError("Cannot assign to function '" + n->target + "'", n->line);
+            } else if (!sym->isMut) {
+                recordError("Cannot assign twice to immutable variable '" + n->target + "'",
+                            n->line);
+            } else if (mismatched(sym->type, valueType)) {
+                recordError("Mismatched types in assignment to '" + n->target + "': expected " +
+                            typeInfoToString(sym->type) + ", found " +
+                            typeInfoToString(valueType), n->line);
+            }
+            return TypeInfo::UNIT;
+        }
+        case NodeKind::BINARY_EXPR: {
+            auto* n = static_cast<BinaryExprNode*>(node);
+            if (isRangeExpr(n)) {
+                analyzeRange(n);
+                recordError("Range '" + n->op + "' is only allowed as a 'for' loop iterable",
+                            n->line);
+                return TypeInfo::UNKNOWN;
+            }
+            TypeInfo left = analyzeExpr(n->left.get());
+            TypeInfo right = analyzeExpr(n->right.get());
+            bool arithmetic = n->op == "+" || n->op == "-" || n->op == "*" || n->op == "/";
+            if (arithmetic) {
+                if (mismatched(left, TypeInfo::INT) || mismatched(right, TypeInfo::INT)) {
+                    recordError("Operator '" + n->op + "' cannot be applied to " +
+                                typeInfoToString(left) + " and " + typeInfoToString(right),
+                                n->line);
+                    return TypeInfo::UNKNOWN;
+                }
+                return TypeInfo::INT;
+            }
+            if (mismatched(left, right)) {
+                recordError("Cannot compare " + std::string(typeInfoToString(left)) + " with " +
+                            typeInfoToString(right), n->line);
+            }
+            return TypeInfo::BOOL;
+        }
+        case NodeKind::UNARY_EXPR: {
+            auto* n = static_cast<UnaryExprNode*>(node);
+            TypeInfo operand = analyzeExpr(n->operand.get());
+            if (mismatched(operand, TypeInfo::INT)) {
+                recordError("Operator '" + n->op + "' cannot be applied to " +
+                            typeInfoToString(operand), n->line);
+                return TypeInfo::UNKNOWN;
+            }
+            return TypeInfo::INT;
+        }
+        case NodeKind::CALL_EXPR: {
+            auto* n = static_cast<CallExprNode*>(node);
+            for (auto& arg : n->args) analyzeExpr(arg.get());
+            const Symbol* sym = resolve(n->callee);
+            if (!sym) {
+                recordError("Call to undeclared function '" + n->callee + "'", n->line);
+                return TypeInfo::UNKNOWN;
+            }
+            if (sym->kind != Symbol::FUNCTION) {
+                recordError("'" + n->callee + "' is not a function", n->line);
+            } else if (sym->arity != n->args.size()) {
+                recordError("Function '" + n->callee + "' expects " + std::to_string(sym->arity) +
+                            " argument(s) but " + std::to_string(n->args.size()) +
+                            " were given", n->line);
+            }
+            return TypeInfo::UNKNOWN;
+        }
+        case NodeKind::FIELD_EXPR:
+            analyzeExpr(static_cast<FieldExprNode*>(node)->object.get());
+            return TypeInfo::UNKNOWN;
+        case NodeKind::METHOD_CALL_EXPR: {
+            auto* n = static_cast<MethodCallExprNode*>(node);
+            analyzeExpr(n->receiver.get());
+            for (auto& arg : n->args) analyzeExpr(arg.get());
+            return TypeInfo::UNKNOWN;
+        }
+        case NodeKind::BLOCK:
+            return analyzeBlock(static_cast<BlockNode*>(node));
+        case NodeKind::IF_STMT:
+            return analyzeIf(static_cast<IfStmtNode*>(node));
+        case NodeKind::MATCH_EXPR:
+            return analyzeMatch(static_cast<MatchExprNode*>(node));
+        default:
+            // Other statement kinds never appear in expression position.
+            return TypeInfo::UNIT;
+    }
+}
+
+// The branches must agree. Without an `else` the `if` is (), so its block
+// must be too.
+TypeInfo SemanticAnalyzer::analyzeIf(IfStmtNode* node) {
+    analyzeCondition(node->condition.get());
+    TypeInfo thenType = analyzeExpr(node->thenBranch.get());
+    if (!node->elseBranch) {
+        if (mismatched(thenType, TypeInfo::UNIT)) {
+            recordError(std::string("'if' without 'else' must be (), found ") +
+                        typeInfoToString(thenType), node->line);
+        }
+        return TypeInfo::UNIT;
+    }
+    TypeInfo elseType = analyzeExpr(node->elseBranch.get());
+    if (mismatched(thenType, elseType)) {
+        recordError(std::string("Mismatched types in if branches: ") +
+                    typeInfoToString(thenType) + " and " + typeInfoToString(elseType),
+                    node->line);
+        return TypeInfo::UNKNOWN;
+    }
+    return thenType != TypeInfo::UNKNOWN ? thenType : elseType;
+}
+
+// Patterns are integers, so the scrutinee must be one. Each value may
+// appear once, and integer patterns never cover every value, so a final
+// `_` arm is required. The arms' values must agree.
+TypeInfo SemanticAnalyzer::analyzeMatch(MatchExprNode* node) {
+    TypeInfo scrutinee = analyzeExpr(node->scrutinee.get());
+    if (mismatched(scrutinee, TypeInfo::INT)) {
+        recordError(std::string("Cannot match on ") + typeInfoToString(scrutinee) +
+                    ": patterns are integers", node->line);
+    }
+
+    std::unordered_set<int64_t> seen;
+    bool wildcard = false;
+    TypeInfo result = TypeInfo::UNKNOWN;
+    for (auto& a : node->arms) {
+        auto* arm = static_cast<MatchArmNode*>(a.get());
+        if (wildcard) recordError("Unreachable match arm after '_'", arm->line);
+        if (arm->patterns.empty()) wildcard = true;
+        for (auto& pattern : arm->patterns) {
+            int64_t value;
+            if (patternValue(pattern.get(), value) && !seen.insert(value).second) {
+                recordError("Unreachable pattern " + std::to_string(value) +
+                            ": matched by an earlier arm", pattern->line);
+            }
+        }
+        TypeInfo type = analyzeExpr(arm->body.get());
+        if (mismatched(result, type)) {
+            recordError(std::string("Mismatched types in match arms: expected ") +
+                        typeInfoToString(result) + ", found " + typeInfoToString(type),
+                        arm->line);
+        } else if (result == TypeInfo::UNKNOWN) {
+            result = type;
+        }
+    }
+    if (!wildcard) recordError("Non-exhaustive match: integer patterns need a '_' arm", node->line);
+    return result;
+}
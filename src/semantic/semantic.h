@@ -0,0 +1,108 @@
+#ifndef SEMANTIC_H
+#define SEMANTIC_H
+
+#include "../ast/ast.h"
+#include "scope_table.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// ============================================================
+// SemanticError
+// ============================================================
+struct SemanticError {
+    std::string message;
+    int line;
+};
+
+// ============================================================
+// Types and symbols
+// ============================================================
+
+// Inferred type of an expression or binding. UNKNOWN never produces an
+// error, so a single mistake does not cascade.
+enum class TypeInfo : uint8_t {
+    UNKNOWN,
+    INT,
+    BOOL,
+    STR,
+    UNIT,
+};
+
+const char* typeInfoToString(TypeInfo type);
+
+// Maps a written type name ("i32", "bool", "String", ...) to a TypeInfo.
+TypeInfo typeFromName(const std::string& name);
+
+struct Symbol {
+    enum Kind : uint8_t { VARIABLE, FUNCTION };
+
+    Kind kind;
+    bool isMut;
+    TypeInfo type;
+    uint32_t arity;  // parameter count, functions only
+};
+
+// ============================================================
+// SemanticAnalyzer — name resolution and type checking
+// ============================================================
+class SemanticAnalyzer {
+public:
+    explicit SemanticAnalyzer(ProgramNode* root);
+
+    // Runs all checks. Returns true if no errors were found.
+    bool analyze();
+
+    // Same checks and the same errors, in the same order, as analyze().
+    // Top-level function signatures are collected serially into a read-only
+    // table; function bodies are then checked on `pool`.
+    bool analyzeParallel(ThreadPool& pool);
+
+    bool hasErrors() const;
+    const std::vector<SemanticError>& errors() const;
+
+private:
+    ProgramNode* root_;
+    ScopeTable<Symbol> scopes_;
+    // Top-level items, shared by parallel workers. Consulted after scopes_,
+    // whose bottom scope then stands for the program scope.
+    const ScopeTable<Symbol>* globals_ = nullptr;
+    std::vector<SemanticError> errors_;
+    // First binding of the function being checked; locals below it belong
+    // to enclosing functions and are not visible (only items are).
+    uint32_t fnBase_ = 0;
+    // Loops enclosing the current statement within its function.
+    uint32_t loopDepth_ = 0;
+    // Declared return type of the function being checked; UNKNOWN if none.
+    TypeInfo returnType_ = TypeInfo::UNKNOWN;
+    // Whether the innermost loop being checked has a `break`.
+    bool loopBroken_ = false;
+    // The last statement found never to finish: a `loop` without `break`,
+    // or an `if` all of whose branches return, break or continue.
+    const AstNode* diverging_ = nullptr;
+
+    explicit SemanticAnalyzer(const ScopeTable<Symbol>* globals);
+
+    void recordError(const std::string& msg, int line);
+    const Symbol* resolve(const std::string& name) const;
+    bool declaredInCurrentScope(const std::string& name) const;
+
+    void declareItems(const std::vector<AstNodePtr>& statements);
+    void analyzeStatements(const std::vector<AstNodePtr>& statements);
+    void analyzeStmt(AstNode* node);
+    void analyzeFnDecl(FnDeclNode* node);
+    void analyzeStructDecl(StructDeclNode* node);
+    void analyzeFor(ForStmtNode* node);
+    void analyzeRange(BinaryExprNode* node);
+    bool analyzeLoopBody(AstNode* body);
+    TypeInfo analyzeBlock(BlockNode* node);
+    void analyzeLet(LetStmtNode* node);
+    void analyzeCondition(AstNode* condition);
+    TypeInfo analyzeExpr(AstNode* node);
+    TypeInfo analyzeIf(IfStmtNode* node);
+    TypeInfo analyzeMatch(MatchExprNode* node);
+};
+
+#endif // SEMANTIC_H
@@ -0,0 +1,372 @@
+#include "semantic.h"
+#include "scope_table.h"
+#include "../parser/parser.h"
+#include "../util/thread_pool.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+// Parses `src` (which must be syntactically valid) and returns the
+// semantic errors found in it.
+static std::vector<SemanticError> check(const std::string& src) {
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << "Unexpected parse error in: " << src;
+    SemanticAnalyzer analyzer(prog.get());
+    analyzer.analyze();
+    return analyzer.errors();
+}
+
+static bool hasError(const std::vector<SemanticError>& errors, const std::string& needle) {
+    for (const auto& e : errors) {
+        if (e.message.find(needle) != std::string::npos) return true;
+    }
+    return false;
+}
+
+// ============================================================
+// ScopeTable
+// ============================================================
+
+TEST(ScopeTable, ShadowingAndScopeExit) {
+    ScopeTable<int> table;
+    table.enterScope();
+    table.declare("x", 1);
+    table.enterScope();
+    table.declare("x", 2);
+    EXPECT_EQ(table.binding(table.lookup("x")).symbol, 2);
+    EXPECT_NE(table.lookupInCurrentScope("x"), ScopeTable<int>::NONE);
+    table.exitScope();
+    EXPECT_EQ(table.binding(table.lookup("x")).symbol, 1);
+    table.exitScope();
+    EXPECT_EQ(table.lookup("x"), ScopeTable<int>::NONE);
+}
+
+TEST(ScopeTable, LookupInCurrentScopeIgnoresOuterBindings) {
+    ScopeTable<int> table;
+    table.enterScope();
+    table.declare("a", 1);
+    table.enterScope();
+    EXPECT_EQ(table.lookupInCurrentScope("a"), ScopeTable<int>::NONE);
+    EXPECT_NE(table.lookup("a"), ScopeTable<int>::NONE);
+}
+
+TEST(ScopeTable, SurvivesGrowthWithManyNames) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; ++i) names.push_back("v" + std::to_string(i));
+
+    ScopeTable<int> table;
+    table.enterScope();
+    for (int i = 0; i < 5000; ++i) {
+        table.enterScope();
+        table.declare(names[i], i);
+    }
+    for (int i = 4999; i >= 0; --i) {
+        ASSERT_EQ(table.binding(table.lookup(names[i])).symbol, i);
+        table.exitScope();
+        ASSERT_EQ(table.lookup(names[i]), ScopeTable<int>::NONE);
+    }
+}
+
+// ============================================================
+// Name resolution
+// ============================================================
+
+TEST(Semantic, ValidProgramHasNoErrors) {
+    auto errors = check(R"(
+fn add(a: i32, b: i32) {
+    return a + b;
+}
+fn main() {
+    let x = 42;
+    let mut y = 0;
+    if x == y { return; } else { y = add(x, 1); }
+    while y > 0 { y = y - 1; }
+}
+)");
+    EXPECT_TRUE(errors.empty()) << errors[0].message;
+}
+
+TEST(Semantic, UndeclaredVariable) {
+    auto errors = check("fn main() { let x = y + 1; }");
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_TRUE(hasError(errors, "undeclared variable 'y'"));
+    EXPECT_EQ(errors[0].line, 1);
+}
+
+TEST(Semantic, VariableOutOfScopeAfterBlock) {
+    auto errors = check("fn main() { { let x = 1; } x; }");
+    EXPECT_TRUE(hasError(errors, "undeclared variable 'x'"));
+}
+
+TEST(Semantic, FunctionsCannotSeeEnclosingLocals) {
+    auto errors = check("fn outer() { let x = 1; fn inner() { x; } inner(); }");
+    EXPECT_TRUE(hasError(errors, "undeclared variable 'x'"));
+}
+
+TEST(Semantic, ItemsAreVisibleBeforeDeclaration) {
+    auto errors = check("fn main() { helper(); } fn helper() { }");
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST(Semantic, LetInitializerSeesOuterBinding) {
+    auto errors = check("fn main() { let x = 1; { let x = x + 1; } }");
+    EXPECT_TRUE(errors.empty());
+}
+
+// ============================================================
+// Redeclaration
+// ============================================================
+
+TEST(Semantic, RedeclaredVariableInSameScope) {
+    auto errors = check("fn main() { let x = 1; let x = 2; }");
+    EXPECT_TRUE(hasError(errors, "'x' is already declared"));
+}
+
+TEST(Semantic, ShadowingInNestedScopeIsAllowed) {
+    auto errors = check("fn main() { let x = 1; { let x = 2; } }");
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST(Semantic, DuplicateFunction) {
+    auto errors = check("fn f() { } fn f() { }");
+    EXPECT_TRUE(hasError(errors, "Function 'f' is already defined"));
+}
+
+TEST(Semantic, DuplicateParameter) {
+    auto errors = check("fn f(a: i32, a: i32) { }");
+    EXPECT_TRUE(hasError(errors, "Duplicate parameter 'a'"));
+}
+
+// ============================================================
+// Calls and assignments
+// ============================================================
+
+TEST(Semantic, ArityMismatch) {
+    auto errors = check("fn f(a: i32) { } fn main() { f(1, 2); }");
+    EXPECT_TRUE(hasError(errors, "expects 1 argument(s) but 2 were given"));
+}
+
+TEST(Semantic, CallToUndeclaredFunction) {
+    auto errors = check("fn main() { g(); }");
+    EXPECT_TRUE(hasError(errors, "undeclared function 'g'"));
+}
+
+TEST(Semantic, CallingAVariable) {
+    auto errors = check("fn main() { let x = 1; x(); }");
+    EXPECT_TRUE(hasError(errors, "'x' is not a function"));
+}
+
+TEST(Semantic, AssignToImmutable) {
+    auto errors = check("fn main() { let x = 1; x = 2; }");
+    EXPECT_TRUE(hasError(errors, "immutable variable 'x'"));
+}
+
+// ============================================================
+// Types
+// ============================================================
+
+TEST(Semantic, ArithmeticOnString) {
+    auto errors = check("fn main() { let s = \"a\" + 1; }");
+    EXPECT_TRUE(hasError(errors, "Operator '+'"));
+}
+
+TEST(Semantic, LetAnnotationMismatch) {
+    auto errors = check("fn main() { let x: bool = 1; }");
+    EXPECT_TRUE(hasError(errors, "expected bool, found integer"));
+}
+
+TEST(Semantic, ConditionMustBeBool) {
+    auto errors = check("fn main() { let x = 1; while x { } }");
+    EXPECT_TRUE(hasError(errors, "Condition must be bool"));
+}
+
+TEST(Semantic, ReturnTypeMismatch) {
+    auto errors = check("fn f() -> bool { return 1; } fn g() -> i64 { return 2; }");
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_TRUE(hasError(errors, "Mismatched return type: expected bool, found integer"));
+}
+
+TEST(Semantic, RangeBoundsMustBeIntegers) {
+    auto errors = check("fn main() { for i in 0..\"a\" { } }");
+    EXPECT_TRUE(hasError(errors, "Range bounds must be integers"));
+    EXPECT_TRUE(hasError(check("fn main() { let n = 3; for i in n { } }"),
+                         "Cannot iterate over integer"));
+}
+
+TEST(Semantic, RangesOnlyAppearAsForIterables) {
+    EXPECT_TRUE(check("fn main() { for i in 0..=3 { for j in i..4 { } } }").empty());
+    for (const char* src : {"fn main() { let r = 0..3; }",
+                            "fn f() -> i64 { 1..=2 }",
+                            "fn main() { while 0..3 { } }",
+                            "fn g(x: i64) { } fn main() { g(1..2); }"}) {
+        auto errors = check(src);
+        ASSERT_EQ(errors.size(), 1u) << src;
+        EXPECT_TRUE(hasError(errors, "is only allowed as a 'for' loop iterable")) << src;
+    }
+}
+
+TEST(Semantic, UnknownTypesDoNotCascade) {
+    // The undeclared name is reported once; its use in `+` is not.
+    auto errors = check("fn main() { let x = y + 1; let z = x * 2; }");
+    EXPECT_EQ(errors.size(), 1u);
+}
+
+// ============================================================
+// Loops and items
+// ============================================================
+
+TEST(Semantic, ForVariableIsAnImmutableInteger) {
+    EXPECT_TRUE(check("fn main() { let mut s = 0; for i in 0..10 { s = s + i; } }").empty());
+    EXPECT_TRUE(hasError(check("fn main() { for i in 0..10 { i = 1; } }"),
+                         "immutable variable 'i'"));
+    EXPECT_TRUE(hasError(check("fn main() { for i in 0..10 { } return i; }"),
+                         "undeclared variable 'i'"));
+    EXPECT_TRUE(hasError(check("fn main() { for b in 0..2 { let x: bool = b; } }"),
+                         "expected bool, found integer"));
+}
+
+TEST(Semantic, BreakAndContinueNeedALoop) {
+    EXPECT_TRUE(check("fn main() { loop { break; } while true { continue; } }").empty());
+    auto errors = check("fn main() { break; continue; }");
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_EQ(errors[0].message, "'break' outside of a loop");
+    EXPECT_EQ(errors[1].message, "'continue' outside of a loop");
+    // A function nested in a loop starts outside any loop.
+    EXPECT_TRUE(hasError(check("fn main() { loop { fn f() { break; } break; } }"),
+                         "'break' outside of a loop"));
+}
+
+TEST(Semantic, StructsAndImplBlocks) {
+    EXPECT_TRUE(hasError(check("struct P { x: i64, x: bool }"), "Duplicate field 'x' in struct 'P'"));
+    // Methods are checked like functions but not bound by name.
+    auto errors = check("impl P { fn get(&self) -> i64 { return self.x.abs(); } "
+                        "fn bad() { return y; } } fn main() { get(); }");
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_TRUE(hasError(errors, "undeclared variable 'y'"));
+    EXPECT_TRUE(hasError(errors, "undeclared function 'get'"));
+}
+
+// ============================================================
+// Block values, if and match
+// ============================================================
+
+TEST(Semantic, TailValueIsTheReturnValue) {
+    EXPECT_TRUE(check("fn f(x: i64) -> i64 { let y = x; y + 1 } "
+                      "fn g(c: bool) -> i64 { if c { 1 } else { return 2; } }").empty());
+    EXPECT_TRUE(hasError(check("fn f() -> bool { 1 }"),
+                         "Mismatched return type: expected bool, found integer"));
+}
+
+TEST(Semantic, DeclaredReturnTypeNeedsAValueOnEveryPath) {
+    EXPECT_TRUE(hasError(check("fn f() -> i64 { return; }"),
+                         "Mismatched return type: expected integer, found ()"));
+    EXPECT_TRUE(hasError(check("fn f() -> i64 { let x = 1; }"),
+                         "Function 'f' must return integer but can reach the end of its body"));
+    EXPECT_TRUE(hasError(check("fn f(c: bool) -> i64 { if c { return 1; } }"),
+                         "Function 'f' must return integer but can reach the end of its body"));
+    EXPECT_TRUE(hasError(check("fn f() -> i64 { loop { break; } }"),
+                         "Function 'f' must return integer but can reach the end of its body"));
+    // Paths that never reach the end need no value.
+    EXPECT_TRUE(check("fn f(c: bool) -> i64 { if c { return 1; } else { return 2; } } "
+                      "fn g() -> i64 { loop { while true { break; } } } "
+                      "fn h() -> i64 { return 1; } fn k() { return; }").empty());
+}
+
+TEST(Semantic, IfBranchesMustAgree) {
+    EXPECT_TRUE(check("fn main() { let x: i64 = if true { 1 } else { 2 } * 3; }").empty());
+    EXPECT_TRUE(hasError(check("fn main() { let x = if true { 1 } else { false }; }"),
+                         "Mismatched types in if branches: integer and bool"));
+    EXPECT_TRUE(hasError(check("fn main() { let x = if true { 1 }; }"),
+                         "'if' without 'else' must be (), found integer"));
+    // The block's locals end with it.
+    EXPECT_TRUE(hasError(check("fn main() { let x = { let t = 1; t }; return t; }"),
+                         "undeclared variable 't'"));
+}
+
+TEST(Semantic, MatchChecks) {
+    EXPECT_TRUE(check("fn f(x: i64) -> i64 { match x { 1 | 2 => 10, -1 => { x } _ => 0 } }")
+                    .empty());
+    auto errors = check("fn main() { let x = match 1 { 1 => 2, 3 | 1 => 4 }; }");
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_EQ(errors[0].message, "Unreachable pattern 1: matched by an earlier arm");
+    EXPECT_EQ(errors[1].message, "Non-exhaustive match: integer patterns need a '_' arm");
+    EXPECT_TRUE(hasError(check("fn main() { match true { _ => 1 } }"),
+                         "Cannot match on bool: patterns are integers"));
+    EXPECT_TRUE(hasError(check("fn main() { match 1 { _ => 1, 2 => 3 } }"),
+                         "Unreachable match arm after '_'"));
+    EXPECT_TRUE(hasError(check("fn main() { match 1 { 0 => 1, _ => \"a\" } }"),
+                         "Mismatched types in match arms: expected integer, found str"));
+}
+
+// ============================================================
+// Scale
+// ============================================================
+
+TEST(Semantic, ManyLetsInOneFunction) {
+    std::string src = "fn big() {\n";
+    for (int i = 0; i < 20000; ++i) {
+        src += "    let v" + std::to_string(i) + " = " + (i ? "v" + std::to_string(i - 1) : "0") +
+               " + 1;\n";
+    }
+    src += "}\n";
+    auto errors = check(src);
+    EXPECT_TRUE(errors.empty());
+}
+
+// ============================================================
+// Parallel analysis
+// ============================================================
+
+static std::vector<SemanticError> checkParallel(const std::string& src, unsigned threads) {
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << "Unexpected parse error in: " << src;
+    ThreadPool pool(threads);
+    SemanticAnalyzer analyzer(prog.get());
+    analyzer.analyzeParallel(pool);
+    return analyzer.errors();
+}
+
+static void expectSameErrors(const std::vector<SemanticError>& a,
+                             const std::vector<SemanticError>& b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].message, b[i].message) << "error " << i;
+        EXPECT_EQ(a[i].line, b[i].line) << "error " << i;
+    }
+}
+
+TEST(SemanticParallel, MatchesSerialOnSmallPrograms) {
+    const char* programs[] = {
+        "fn f() { } fn f() { } fn main() { f(1); }",
+        "let x = 1; fn f() { x; } let x = 2; let f = 3; f();",
+        "fn main() { helper(); } fn helper() { let y = z; }",
+        "{ fn inner() { } inner(); } inner();",
+        "fn a(p: i32, p: bool) { p = 1; } let mut q = true; q = 1;",
+    };
+    for (const char* src : programs) {
+        expectSameErrors(checkParallel(src, 3), check(src));
+    }
+}
+
+TEST(SemanticParallel, ManyFunctionsMergedInSourceOrder) {
+    // Every fifth function has errors; the merged list must match a serial run.
+    std::string src;
+    for (int i = 0; i < 2000; ++i) {
+        std::string n = std::to_string(i);
+        src += "fn f" + n + "(a: i32) {\n";
+        src += "    let x = a + " + n + ";\n";
+        src += (i % 5 == 0) ? "    let y = undefined" + n + " + 1;\n    f" + n + "(1, 2);\n"
+                            : "    let y = f" + std::to_string((i + 1) % 2000) + "(x);\n";
+        src += "}\n";
+        if (i % 100 == 0) src += "let top" + n + " = f" + n + ";\n";
+    }
+    auto serial = check(src);
+    ASSERT_EQ(serial.size(), 2u * 400);
+    expectSameErrors(checkParallel(src, 4), serial);
+    expectSameErrors(checkParallel(src, 1), serial);
+}
@@ -0,0 +1,63 @@
+#include "client.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+bool sendRequest(const std::string& socketPath, const Request& request, Response& response,
+                 std::string& error) {
+    int fd = connectToServer(socketPath);
+    if (fd < 0) {
+        error = "could not connect to a server at '" + socketPath + "': " + std::strerror(errno);
+        return false;
+    }
+    std::string payload;
+    bool ok = writeFrame(fd, encodeRequest(request)) && readFrame(fd, payload) &&
+              decodeResponse(payload, response);
+    ::close(fd);
+    if (!ok) error = "connection to the server at '" + socketPath + "' failed";
+    return ok;
+}
+
+int runClient(const std::string& socketPath, const std::vector<std::string>& args,
+              std::ostream& out, std::ostream& err) {
+    Request request;
+    for (const std::string& arg : args) {
+        if (arg.compare(0, 9, "--client=") == 0) continue;
+        if (arg == "--shutdown") {
+            request.kind = RequestKind::SHUTDOWN;
+        } else if (arg == "-") {
+            request.args.push_back(arg);
+            request.hasSource = true;
+            request.source.assign(std::istreambuf_iterator<char>(std::cin),
+                                  std::istreambuf_iterator<char>());
+        } else if (!arg.empty() && arg[0] != '-') {
+            std::error_code ec;
+            fs::path absolute = fs::absolute(arg, ec);
+            request.args.push_back(ec ? arg : absolute.string());
+        } else {
+            request.args.push_back(arg);
+        }
+    }
+    if (request.kind == RequestKind::SHUTDOWN) {
+        request.args.clear();
+        request.hasSource = false;
+        request.source.clear();
+    }
+
+    Response response;
+    std::string error;
+    if (!sendRequest(socketPath, request, response, error)) {
+        err << "Error: " << error << std::endl;
+        return 1;
+    }
+    out.write(response.out.data(), static_cast<std::streamsize>(response.out.size()));
+    err.write(response.err.data(), static_cast<std::streamsize>(response.err.size()));
+    out.flush();
+    err.flush();
+    return response.status;
+}
@@ -0,0 +1,31 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include "protocol.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Client side of rustc --server
+// ============================================================
+//
+// Kept apart from the compiler: rustc_client links only this and the
+// protocol, so each invocation starts as fast as a process can.
+
+// Sends `request` to the server at `socketPath` and waits for the response.
+// False with a message in `error` if the server cannot be reached or the
+// connection fails.
+bool sendRequest(const std::string& socketPath, const Request& request, Response& response,
+                 std::string& error);
+
+// Forwards a rustc command line to the server at `socketPath` and writes the
+// response's output to `out` and `err`. `args` are rustc's arguments; a
+// `--client=...` among them is dropped, `--shutdown` sends a SHUTDOWN
+// request instead. The source path is made absolute (the server has its own
+// working directory); for "-" the contents of standard input are sent.
+// Returns the compilation's exit status, or 1 if the server is unreachable.
+int runClient(const std::string& socketPath, const std::vector<std::string>& args,
+              std::ostream& out, std::ostream& err);
+
+#endif // CLIENT_H
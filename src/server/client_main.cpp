@@ -0,0 +1,29 @@
+#include "client.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ============================================================
+// rustc_client — rustc's command line, run by a rustc --server
+// ============================================================
+//
+// The socket is taken from --client=SOCKET or, failing that, the
+// RUSTC_SERVER environment variable, so a build script can swap `rustc`
+// for `rustc_client` and keep its arguments.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string socketPath;
+    if (const char* env = std::getenv("RUSTC_SERVER")) socketPath = env;
+    for (const std::string& arg : args) {
+        if (arg.compare(0, 9, "--client=") == 0) socketPath = arg.substr(9);
+    }
+    if (socketPath.empty()) {
+        std::cerr << "Usage: rustc_client [--client=SOCKET] <rustc options> <source_file | ->\n"
+                     "       rustc_client [--client=SOCKET] --shutdown\n"
+                     "The socket defaults to $RUSTC_SERVER." << std::endl;
+        return 1;
+    }
+    return runClient(socketPath, args, std::cout, std::cerr);
+}
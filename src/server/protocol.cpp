@@ -0,0 +1,161 @@
+#include "protocol.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ============================================================
+// Encoding
+// ============================================================
+
+template <typename T>
+static void putInt(std::string& out, T v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putString(std::string& out, const std::string& s) {
+    putInt<uint64_t>(out, s.size());
+    out.append(s);
+}
+
+template <typename T>
+static bool getInt(const std::string& in, size_t& pos, T& v) {
+    if (in.size() - pos < sizeof(v)) return false;
+    std::memcpy(&v, in.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+static bool getString(const std::string& in, size_t& pos, std::string& s) {
+    uint64_t length = 0;
+    if (!getInt(in, pos, length) || in.size() - pos < length) return false;
+    s.assign(in, pos, length);
+    pos += length;
+    return true;
+}
+
+std::string encodeRequest(const Request& request) {
+    std::string out;
+    putInt<uint32_t>(out, static_cast<uint32_t>(request.kind));
+    putInt<uint32_t>(out, static_cast<uint32_t>(request.args.size()));
+    for (const std::string& arg : request.args) putString(out, arg);
+    putInt<uint8_t>(out, request.hasSource ? 1 : 0);
+    if (request.hasSource) putString(out, request.source);
+    return out;
+}
+
+std::string encodeResponse(const Response& response) {
+    std::string out;
+    putInt<int32_t>(out, response.status);
+    putString(out, response.out);
+    putString(out, response.err);
+    return out;
+}
+
+bool decodeRequest(const std::string& payload, Request& request) {
+    size_t pos = 0;
+    uint32_t kind = 0, argc = 0;
+    uint8_t hasSource = 0;
+    if (!getInt(payload, pos, kind) || kind > static_cast<uint32_t>(RequestKind::SHUTDOWN) ||
+        !getInt(payload, pos, argc)) {
+        return false;
+    }
+    Request result;
+    result.kind = static_cast<RequestKind>(kind);
+    for (uint32_t i = 0; i < argc; ++i) {
+        std::string arg;
+        if (!getString(payload, pos, arg)) return false;
+        result.args.push_back(std::move(arg));
+    }
+    if (!getInt(payload, pos, hasSource) || hasSource > 1) return false;
+    result.hasSource = hasSource == 1;
+    if (result.hasSource && !getString(payload, pos, result.source)) return false;
+    if (pos != payload.size()) return false;
+    request = std::move(result);
+    return true;
+}
+
+bool decodeResponse(const std::string& payload, Response& response) {
+    size_t pos = 0;
+    Response result;
+    if (!getInt(payload, pos, result.status) || !getString(payload, pos, result.out) ||
+        !getString(payload, pos, result.err) || pos != payload.size()) {
+        return false;
+    }
+    response = std::move(result);
+    return true;
+}
+
+// ============================================================
+// Sockets and frames
+// ============================================================
+
+bool socketAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    return true;
+}
+
+int connectToServer(const std::string& path) {
+    sockaddr_un addr;
+    if (!socketAddress(path, addr)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+static bool writeAll(int fd, const char* data, size_t n) {
+    while (n) {
+        // MSG_NOSIGNAL: a peer that went away is an error, not SIGPIPE.
+        ssize_t sent = ::send(fd, data, n, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        n -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static bool readAll(int fd, char* data, size_t n) {
+    while (n) {
+        ssize_t got = ::recv(fd, data, n, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (got == 0) return false;
+        data += got;
+        n -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool writeFrame(int fd, const std::string& payload) {
+    uint64_t length = payload.size();
+    if (length > MAX_FRAME_BYTES) return false;
+    return writeAll(fd, reinterpret_cast<const char*>(&length), sizeof(length)) &&
+           writeAll(fd, payload.data(), payload.size());
+}
+
+bool readFrame(int fd, std::string& payload) {
+    uint64_t length = 0;
+    if (!readAll(fd, reinterpret_cast<char*>(&length), sizeof(length)) ||
+        length > MAX_FRAME_BYTES) {
+        return false;
+    }
+    payload.resize(length);
+    return readAll(fd, &payload[0], length);
+}
@@ -0,0 +1,59 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <sys/un.h>
+#include <vector>
+
+// ============================================================
+// Wire format between `rustc --client` and `rustc --server`
+// ============================================================
+//
+// One request and one response per connection, each sent as a frame:
+// payload length (u64) followed by the payload. Integers are in host byte
+// order — both ends run on the same machine.
+//
+//   request  = kind u32 | argc u32 | (length u64, bytes)* | has source u8 | [length u64, bytes]
+//   response = status i32 | stdout (length u64, bytes) | stderr (length u64, bytes)
+enum class RequestKind : uint32_t {
+    COMPILE,   // run the command line in `args`
+    SHUTDOWN,  // stop accepting; the server exits once requests in flight finish
+};
+
+struct Request {
+    RequestKind kind = RequestKind::COMPILE;
+    std::vector<std::string> args;  // the rustc arguments, without --client
+    bool hasSource = false;         // `source` holds the file contents (client read stdin)
+    std::string source;
+};
+
+struct Response {
+    int32_t status = 0;  // the exit status rustc would have returned
+    std::string out;
+    std::string err;
+};
+
+// Frames larger than this are refused rather than allocated.
+static constexpr uint64_t MAX_FRAME_BYTES = 1ULL << 32;
+
+std::string encodeRequest(const Request& request);
+std::string encodeResponse(const Response& response);
+
+// False if `payload` is truncated or malformed.
+bool decodeRequest(const std::string& payload, Request& request);
+bool decodeResponse(const std::string& payload, Response& response);
+
+// Fills `addr` for the socket file `path`. False if the path is empty or
+// does not fit in a socket address.
+bool socketAddress(const std::string& path, sockaddr_un& addr);
+
+// A socket connected to the server listening at `path`, or -1 with errno set.
+int connectToServer(const std::string& path);
+
+// Blocking frame I/O on a connected socket. False on error, on end of
+// stream before a whole frame, or on a frame over MAX_FRAME_BYTES.
+bool writeFrame(int fd, const std::string& payload);
+bool readFrame(int fd, std::string& payload);
+
+#endif // PROTOCOL_H
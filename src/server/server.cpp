@@ -0,0 +1,154 @@
+#include "server.h"
+#include "../main/driver.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+// A client that stops sending mid-request is dropped after this long, so it
+// cannot hold a worker forever.
+static const int RECEIVE_TIMEOUT_SECONDS = 60;
+
+// ============================================================
+// Server
+// ============================================================
+
+CompileServer::CompileServer(unsigned workers, const std::string& cacheDir, uint64_t cacheSize)
+    : pool_(std::make_unique<ThreadPool>(workers)) {
+    if (!cacheDir.empty()) {
+        cache_ = std::make_unique<ParseCache>(cacheDir, cacheSize);
+        cache_->keepInMemory(MEMORY_CACHE_BYTES);
+    }
+}
+
+CompileServer::~CompileServer() {
+    pool_.reset();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+    }
+}
+
+bool CompileServer::listen(const std::string& socketPath, std::string& error) {
+    sockaddr_un addr;
+    if (!socketAddress(socketPath, addr)) {
+        error = "socket path '" + socketPath + "' is empty or too long";
+        return false;
+    }
+
+    // Only replace a socket file nobody is listening on.
+    struct stat st;
+    if (::lstat(socketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            error = "'" + socketPath + "' exists and is not a socket";
+            return false;
+        }
+        int probe = connectToServer(socketPath);
+        if (probe >= 0) {
+            ::close(probe);
+            error = "a server is already listening on '" + socketPath + "'";
+            return false;
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    // Created owner-only: the server runs whatever it is sent as this user.
+    mode_t oldMask = ::umask(0077);
+    int bound = ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    ::umask(oldMask);
+    if (bound < 0 || ::listen(fd, SOMAXCONN) < 0) {
+        error = "could not listen on '" + socketPath + "': " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    listenFd_ = fd;
+    socketPath_ = socketPath;
+    return true;
+}
+
+void CompileServer::serve() {
+    while (!stopping_) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;  // shut down by a SHUTDOWN request, or the socket failed
+        }
+        pool_->submit([this, fd] { serveConnection(fd); });
+    }
+}
+
+void CompileServer::serveConnection(int fd) {
+    timeval timeout{RECEIVE_TIMEOUT_SECONDS, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string payload;
+    Request request;
+    Response response;
+    if (!readFrame(fd, payload)) {
+        ::close(fd);
+        return;
+    }
+    if (decodeRequest(payload, request)) {
+        payload.clear();
+        response = handle(std::move(request));
+    } else {
+        response.status = 1;
+        response.err = "Error: malformed request\n";
+    }
+    writeFrame(fd, encodeResponse(response));
+    ::close(fd);
+}
+
+void CompileServer::setRequestFuel(uint64_t fuel) {
+    requestFuel_ = fuel;
+}
+
+Response CompileServer::handle(Request request) {
+    Response response;
+    if (request.kind == RequestKind::SHUTDOWN) {
+        // Wakes accept() in serve(); connections already accepted still run.
+        stopping_ = true;
+        if (listenFd_ >= 0) ::shutdown(listenFd_, SHUT_RDWR);
+        return response;
+    }
+
+    std::ostringstream out, err;
+    Options opts;
+    if (!parseArgs(request.args, opts) || !opts.server.empty() || !opts.client.empty()) {
+        printUsage(err);
+        response.status = 1;
+        response.err = err.str();
+        return response;
+    }
+    // Requests share the machine: --check and --emit=llvm get at most one
+    // thread per core, and programs run with bounded fuel. The JIT's native
+    // code cannot be stopped, so --run=jit runs on the VM instead.
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    if (opts.jobs == 0 || opts.jobs > cores) opts.jobs = cores;
+    opts.vmFuel = requestFuel_;
+    if (opts.run == "jit") opts.run = "vm";
+
+    std::string source;
+    if (request.hasSource) {
+        source = std::move(request.source);
+    } else if (opts.sourcePath == "-" || !readSource(opts.sourcePath, source)) {
+        response.status = 1;
+        response.err = "Error: could not open file '" + opts.sourcePath + "'\n";
+        return response;
+    }
+    response.status = compileSource(opts, std::move(source), cache_.get(), out, err);
+    response.out = out.str();
+    response.err = err.str();
+    return response;
+}
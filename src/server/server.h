@@ -0,0 +1,62 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "protocol.h"
+#include "../cache/parse_cache.h"
+#include "../util/thread_pool.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+// ============================================================
+// CompileServer — rustc --server
+// ============================================================
+//
+// Listens on a Unix domain socket and runs each request's command line
+// through compileSource() on a ThreadPool, so process start-up and static
+// initialization are paid once, and one ParseCache (with in-memory copies of
+// recent entries) stays warm across requests. A request's own --cache-dir and
+// --cache-size are ignored: the server's cache, if any, is used.
+class CompileServer {
+public:
+    // In-memory part of the shared parse cache.
+    static constexpr uint64_t MEMORY_CACHE_BYTES = 64ULL * 1024 * 1024;
+
+    // Jumps and calls a --run request may execute by default, so that a
+    // program that never ends cannot hold a worker forever.
+    static constexpr uint64_t DEFAULT_REQUEST_FUEL = 1000000000;
+
+    // `workers` = 0 uses one per core. An empty `cacheDir` runs without a cache.
+    CompileServer(unsigned workers, const std::string& cacheDir, uint64_t cacheSize);
+    // Waits for requests in flight, closes the socket and removes its file.
+    ~CompileServer();
+
+    CompileServer(const CompileServer&) = delete;
+    CompileServer& operator=(const CompileServer&) = delete;
+
+    // Binds `socketPath` (owner-only permissions). A stale socket file is
+    // replaced; one a live server is listening on is not. False with a
+    // message in `error` on failure.
+    bool listen(const std::string& socketPath, std::string& error);
+
+    // Accepts connections, one request each, until a SHUTDOWN request.
+    void serve();
+
+    // Runs one request — what serve() does per connection, without the socket.
+    Response handle(Request request);
+
+    // Fuel for the VM of later --run requests (not 0).
+    void setRequestFuel(uint64_t fuel);
+
+private:
+    std::unique_ptr<ParseCache> cache_;
+    std::string socketPath_;
+    int listenFd_ = -1;
+    std::atomic<bool> stopping_{false};
+    uint64_t requestFuel_ = DEFAULT_REQUEST_FUEL;
+    std::unique_ptr<ThreadPool> pool_;  // reset first in the destructor: tasks use the socket
+
+    void serveConnection(int fd);
+};
+
+#endif // SERVER_H
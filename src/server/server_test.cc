@@ -0,0 +1,251 @@
+#include "client.h"
+#include "server.h"
+#include "../main/driver.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static const char* PROGRAM =
+    "fn add(a: i32, b: i32) { return a + b; }\n"
+    "fn main() { let x = add(2, 3); return x * 4; }\n";
+
+// Fresh, empty directory unique to this test.
+static std::string tempDir(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() /
+                   ("rustc_server_test_" + std::to_string(getpid()) + "_" + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir.string();
+}
+
+static Request compileRequest(std::vector<std::string> args, const std::string& source) {
+    Request request;
+    request.args = std::move(args);
+    request.hasSource = true;
+    request.source = source;
+    return request;
+}
+
+// What a direct compileSource() call prints for the same command line.
+static Response direct(const std::vector<std::string>& args, const std::string& source) {
+    Options opts;
+    EXPECT_TRUE(parseArgs(args, opts));
+    std::ostringstream out, err;
+    Response r;
+    r.status = compileSource(opts, source, nullptr, out, err);
+    r.out = out.str();
+    r.err = err.str();
+    return r;
+}
+
+// ============================================================
+// Protocol
+// ============================================================
+
+TEST(Protocol, RequestRoundTrip) {
+    Request request = compileRequest({"--emit=tac", "-O", "-"}, std::string("fn\0main", 7));
+    Request decoded;
+    ASSERT_TRUE(decodeRequest(encodeRequest(request), decoded));
+    EXPECT_EQ(decoded.kind, RequestKind::COMPILE);
+    EXPECT_EQ(decoded.args, request.args);
+    EXPECT_TRUE(decoded.hasSource);
+    EXPECT_EQ(decoded.source, request.source);
+
+    Request shutdown;
+    shutdown.kind = RequestKind::SHUTDOWN;
+    ASSERT_TRUE(decodeRequest(encodeRequest(shutdown), decoded));
+    EXPECT_EQ(decoded.kind, RequestKind::SHUTDOWN);
+    EXPECT_TRUE(decoded.args.empty());
+    EXPECT_FALSE(decoded.hasSource);
+}
+
+TEST(Protocol, ResponseRoundTrip) {
+    Response response{-3, "out\n", std::string("e\0rr", 4)};
+    Response decoded;
+    ASSERT_TRUE(decodeResponse(encodeResponse(response), decoded));
+    EXPECT_EQ(decoded.status, -3);
+    EXPECT_EQ(decoded.out, response.out);
+    EXPECT_EQ(decoded.err, response.err);
+}
+
+TEST(Protocol, TruncatedOrTrailingBytesAreRejected) {
+    std::string payload = encodeRequest(compileRequest({"--check", "a.rs"}, "let x = 1;"));
+    Request decoded;
+    for (size_t n = 0; n < payload.size(); ++n) {
+        EXPECT_FALSE(decodeRequest(payload.substr(0, n), decoded)) << n;
+    }
+    EXPECT_FALSE(decodeRequest(payload + "x", decoded));
+
+    std::string bad = payload;
+    bad[0] = 7;  // unknown kind
+    EXPECT_FALSE(decodeRequest(bad, decoded));
+}
+
+// ============================================================
+// Requests, without the socket
+// ============================================================
+
+TEST(CompileServer, SameOutputAsADirectRun) {
+    CompileServer server(1, "", 0);
+    std::vector<std::vector<std::string>> commandLines = {
+        {"-"}, {"--emit=tac", "-O", "-"}, {"--run", "-"}, {"--emit=ast-json", "-"},
+        {"--check", "--stats", "-"}};
+    for (const std::vector<std::string>& args : commandLines) {
+        Response expected = direct(args, PROGRAM);
+        Response got = server.handle(compileRequest(args, PROGRAM));
+        EXPECT_EQ(got.status, expected.status);
+        EXPECT_EQ(got.out, expected.out);
+        EXPECT_EQ(got.err, expected.err);
+    }
+}
+
+TEST(CompileServer, ErrorsComeBackWithTheStatus) {
+    CompileServer server(1, "", 0);
+    Response parse = server.handle(compileRequest({"-"}, "let = 1;"));
+    EXPECT_EQ(parse.status, 1);
+    EXPECT_NE(parse.err.find("Parse error [line 1]"), std::string::npos);
+
+    Response usage = server.handle(compileRequest({"--emit=nope", "-"}, ""));
+    EXPECT_EQ(usage.status, 1);
+    EXPECT_NE(usage.err.find("Usage:"), std::string::npos);
+
+    Response nested = server.handle(compileRequest({"--server=/tmp/x"}, ""));
+    EXPECT_EQ(nested.status, 1);
+}
+
+TEST(CompileServer, RequestsShareTheMachine) {
+    CompileServer server(1, "", 0);
+    server.setRequestFuel(100000);
+    const char* spin = "fn main() { loop { } }";
+    for (const char* run : {"--run", "--run=jit"}) {
+        Response r = server.handle(compileRequest({run, "-"}, spin));
+        EXPECT_EQ(r.status, 1);
+        EXPECT_EQ(r.err, "Runtime error in 'main': out of fuel after 100000 jump(s) and call(s)\n");
+    }
+    // Far more threads than cores asked for: clamped, same result.
+    Response checked = server.handle(compileRequest({"--check", "--jobs=100000", "-"}, PROGRAM));
+    EXPECT_EQ(checked.status, 0);
+    EXPECT_EQ(checked.out, direct({"--check", "-"}, PROGRAM).out);
+}
+
+TEST(CompileServer, ReadsTheSourcePath) {
+    std::string dir = tempDir("path");
+    std::string path = dir + "/prog.rs";
+    std::ofstream(path) << PROGRAM;
+
+    CompileServer server(1, "", 0);
+    Request request;
+    request.args = {"--run", path};
+    Response r = server.handle(request);
+    EXPECT_EQ(r.status, 0);
+    EXPECT_EQ(r.out, "20\n");
+
+    request.args = {"--run", dir + "/missing.rs"};
+    r = server.handle(request);
+    EXPECT_EQ(r.status, 1);
+    EXPECT_NE(r.err.find("could not open file"), std::string::npos);
+
+    // "-" without contents would be the server's own standard input.
+    request.args = {"-"};
+    EXPECT_EQ(server.handle(request).status, 1);
+    fs::remove_all(dir);
+}
+
+TEST(CompileServer, CacheStaysWarmAcrossRequests) {
+    std::string dir = tempDir("cache");
+    CompileServer server(1, dir, ParseCache::DEFAULT_MAX_BYTES);
+    Response first = server.handle(compileRequest({"--stats", "-"}, PROGRAM));
+    Response second = server.handle(compileRequest({"--stats", "-"}, PROGRAM));
+    EXPECT_NE(first.err.find("[stats] cache: 0 hit(s), 1 miss(es)"), std::string::npos);
+    EXPECT_NE(second.err.find("[stats] cache: 1 hit(s), 1 miss(es)"), std::string::npos);
+    EXPECT_EQ(first.out, second.out);
+    fs::remove_all(dir);
+}
+
+// ============================================================
+// Over the socket
+// ============================================================
+
+TEST(CompileServer, ServesClientsUntilShutdown) {
+    std::string dir = tempDir("socket");
+    std::string socketPath = dir + "/rustc.sock";
+    std::string error;
+
+    CompileServer server(2, "", 0);
+    ASSERT_TRUE(server.listen(socketPath, error)) << error;
+    std::thread serving([&] { server.serve(); });
+
+    // A second server does not take over a live socket.
+    {
+        CompileServer other(1, "", 0);
+        EXPECT_FALSE(other.listen(socketPath, error));
+        EXPECT_NE(error.find("already listening"), std::string::npos);
+    }
+
+    std::vector<std::thread> clients;
+    std::vector<Response> responses(8);
+    for (size_t i = 0; i < responses.size(); ++i) {
+        clients.emplace_back([&, i] {
+            std::string e;
+            EXPECT_TRUE(sendRequest(socketPath, compileRequest({"--run", "-"}, PROGRAM),
+                                    responses[i], e))
+                << e;
+        });
+    }
+    for (std::thread& t : clients) t.join();
+    for (const Response& r : responses) {
+        EXPECT_EQ(r.status, 0);
+        EXPECT_EQ(r.out, "20\n");
+    }
+
+    Request shutdown;
+    shutdown.kind = RequestKind::SHUTDOWN;
+    Response r;
+    EXPECT_TRUE(sendRequest(socketPath, shutdown, r, error)) << error;
+    serving.join();
+    fs::remove_all(dir);
+}
+
+TEST(CompileServer, StaleSocketFileIsReplaced) {
+    std::string dir = tempDir("stale");
+    std::string socketPath = dir + "/rustc.sock";
+    std::string error;
+
+    // What a killed server leaves behind: a socket file nobody listens on.
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socketPath.data(), socketPath.size());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)), 0);
+    ::close(fd);
+    ASSERT_TRUE(fs::is_socket(socketPath));
+
+    {
+        CompileServer server(1, "", 0);
+        EXPECT_TRUE(server.listen(socketPath, error)) << error;
+    }
+    EXPECT_FALSE(fs::exists(socketPath));  // removed by the destructor
+
+    // Any other file is left alone.
+    std::ofstream(socketPath) << "not a socket";
+    CompileServer server(1, "", 0);
+    EXPECT_FALSE(server.listen(socketPath, error));
+
+    Response r;
+    EXPECT_FALSE(sendRequest(dir + "/nobody.sock", Request{}, r, error));
+    EXPECT_NE(error.find("could not connect"), std::string::npos);
+    fs::remove_all(dir);
+}
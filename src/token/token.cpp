@@ -3,49 +3,100 @@
 
 std::string tokenTypeToString(TokenType type) {
     switch (type) {
-        case TokenType::FN:        return "FN";
-        case TokenType::LET:       return "LET";
-        case TokenType::MUT:       return "MUT";
-        case TokenType::IF:        return "IF";
-        case TokenType::ELSE:      return "ELSE";
-        case TokenType::WHILE:     return "WHILE";
-        case TokenType::RETURN:    return "RETURN";
-        case TokenType::IDENT:     return "IDENT";
-        case TokenType::NUMBER:    return "NUMBER";
-        case TokenType::STRING:    return "STRING";
-        case TokenType::PLUS:      return "PLUS";
-        case TokenType::MINUS:     return "MINUS";
-        case TokenType::STAR:      return "STAR";
-        case TokenType::SLASH:     return "SLASH";
-        case TokenType::ASSIGN:    return "ASSIGN";
-        case TokenType::EQ:        return "EQ";
-        case TokenType::NEQ:       return "NEQ";
-        case TokenType::LT:        return "LT";
-        case TokenType::GT:        return "GT";
-        case TokenType::LTE:       return "LTE";
-        case TokenType::GTE:       return "GTE";
-        case TokenType::LPAREN:    return "LPAREN";
-        case TokenType::RPAREN:    return "RPAREN";
-        case TokenType::LBRACE:    return "LBRACE";
-        case TokenType::RBRACE:    return "RBRACE";
-        case TokenType::SEMICOLON: return "SEMICOLON";
-        case TokenType::COLON:     return "COLON";
-        case TokenType::COMMA:     return "COMMA";
-        case TokenType::EOF_TOKEN: return "EOF";
-        case TokenType::ILLEGAL:   return "ILLEGAL";
+        case TokenType::FN:             return "FN";
+        case TokenType::LET:            return "LET";
+        case TokenType::MUT:            return "MUT";
+        case TokenType::IF:             return "IF";
+        case TokenType::ELSE:           return "ELSE";
+        case TokenType::WHILE:          return "WHILE";
+        case TokenType::RETURN:         return "RETURN";
+        case TokenType::STRUCT:         return "STRUCT";
+        case TokenType::IMPL:           return "IMPL";
+        case TokenType::LOOP:           return "LOOP";
+        case TokenType::FOR:            return "FOR";
+        case TokenType::IN:             return "IN";
+        case TokenType::BREAK:          return "BREAK";
+        case TokenType::CONTINUE:       return "CONTINUE";
+        case TokenType::MATCH:          return "MATCH";
+        case TokenType::IDENT:          return "IDENT";
+        case TokenType::NUMBER:         return "NUMBER";
+        case TokenType::STRING:         return "STRING";
+        case TokenType::FLOAT:          return "FLOAT";
+        case TokenType::CHAR:           return "CHAR";
+        case TokenType::PLUS:           return "PLUS";
+        case TokenType::MINUS:          return "MINUS";
+        case TokenType::STAR:           return "STAR";
+        case TokenType::SLASH:          return "SLASH";
+        case TokenType::PERCENT:        return "PERCENT";
+        case TokenType::CARET:          return "CARET";
+        case TokenType::BANG:           return "BANG";
+        case TokenType::AMP:            return "AMP";
+        case TokenType::PIPE:           return "PIPE";
+        case TokenType::AND:            return "AND";
+        case TokenType::OR:             return "OR";
+        case TokenType::SHL:            return "SHL";
+        case TokenType::SHR:            return "SHR";
+        case TokenType::ASSIGN:         return "ASSIGN";
+        case TokenType::PLUS_ASSIGN:    return "PLUS_ASSIGN";
+        case TokenType::MINUS_ASSIGN:   return "MINUS_ASSIGN";
+        case TokenType::STAR_ASSIGN:    return "STAR_ASSIGN";
+        case TokenType::SLASH_ASSIGN:   return "SLASH_ASSIGN";
+        case TokenType::PERCENT_ASSIGN: return "PERCENT_ASSIGN";
+        case TokenType::CARET_ASSIGN:   return "CARET_ASSIGN";
+        case TokenType::AMP_ASSIGN:     return "AMP_ASSIGN";
+        case TokenType::PIPE_ASSIGN:    return "PIPE_ASSIGN";
+        case TokenType::SHL_ASSIGN:     return "SHL_ASSIGN";
+        case TokenType::SHR_ASSIGN:     return "SHR_ASSIGN";
+        case TokenType::EQ:             return "EQ";
+        case TokenType::NEQ:            return "NEQ";
+        case TokenType::LT:             return "LT";
+        case TokenType::GT:             return "GT";
+        case TokenType::LTE:            return "LTE";
+        case TokenType::GTE:            return "GTE";
+        case TokenType::LPAREN:         return "LPAREN";
+        case TokenType::RPAREN:         return "RPAREN";
+        case TokenType::LBRACE:         return "LBRACE";
+        case TokenType::RBRACE:         return "RBRACE";
+        case TokenType::LBRACKET:       return "LBRACKET";
+        case TokenType::RBRACKET:       return "RBRACKET";
+        case TokenType::SEMICOLON:      return "SEMICOLON";
+        case TokenType::COLON:          return "COLON";
+        case TokenType::COMMA:          return "COMMA";
+        case TokenType::DOT:            return "DOT";
+        case TokenType::DOT_DOT:        return "DOT_DOT";
+        case TokenType::DOT_DOT_EQ:     return "DOT_DOT_EQ";
+        case TokenType::ELLIPSIS:       return "ELLIPSIS";
+        case TokenType::COLON_COLON:    return "COLON_COLON";
+        case TokenType::ARROW:          return "ARROW";
+        case TokenType::FAT_ARROW:      return "FAT_ARROW";
+        case TokenType::POUND:          return "POUND";
+        case TokenType::DOLLAR:         return "DOLLAR";
+        case TokenType::QUESTION:       return "QUESTION";
+        case TokenType::TILDE:          return "TILDE";
+        case TokenType::AT:             return "AT";
+        case TokenType::EOF_TOKEN:      return "EOF";
+        case TokenType::ILLEGAL:        return "ILLEGAL";
     }
     return "UNKNOWN";
 }
 
 TokenType lookupKeyword(const std::string& ident) {
     static const std::unordered_map<std::string, TokenType> keywords = {
-        {"fn",     TokenType::FN},
-        {"let",    TokenType::LET},
-        {"mut",    TokenType::MUT},
-        {"if",     TokenType::IF},
-        {"else",   TokenType::ELSE},
-        {"while",  TokenType::WHILE},
-        {"return", TokenType::RETURN},
+        {"fn",       TokenType::FN},
+        {"let",      TokenType::LET},
+        {"mut",      TokenType::MUT},
+        {"if",       TokenType::IF},
+        {"else",     TokenType::ELSE},
+        {"while",    TokenType::WHILE},
+        {"return",   TokenType::RETURN},
+        {"struct",   TokenType::STRUCT},
+        {"impl",     TokenType::IMPL},
+        {"loop",     TokenType::LOOP},
+        {"for",      TokenType::FOR},
+        {"in",       TokenType::IN},
+        {"break",    TokenType::BREAK},
+        {"continue", TokenType::CONTINUE},
+        {"match",    TokenType::MATCH},
     };
 
     auto it = keywords.find(ident);
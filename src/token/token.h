@@ -1,34 +1,56 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 enum class TokenType {
     // Keywords
     FN, LET, MUT, IF, ELSE, WHILE, RETURN,
+    STRUCT, IMPL, LOOP, FOR, IN, BREAK, CONTINUE, MATCH,
 
     // Literals
-    IDENT, NUMBER, STRING,
+    IDENT, NUMBER, STRING, FLOAT, CHAR,
 
     // Operators
-    PLUS, MINUS, STAR, SLASH,
-    ASSIGN, EQ, NEQ,
+    PLUS, MINUS, STAR, SLASH, PERCENT,
+    CARET, BANG, AMP, PIPE, AND, OR, SHL, SHR,
+    ASSIGN, PLUS_ASSIGN, MINUS_ASSIGN, STAR_ASSIGN, SLASH_ASSIGN, PERCENT_ASSIGN,
+    CARET_ASSIGN, AMP_ASSIGN, PIPE_ASSIGN, SHL_ASSIGN, SHR_ASSIGN,
+    EQ, NEQ,
     LT, GT, LTE, GTE,
 
     // Punctuation
     LPAREN, RPAREN,
     LBRACE, RBRACE,
+    LBRACKET, RBRACKET,
     SEMICOLON, COLON, COMMA,
+    DOT, DOT_DOT, DOT_DOT_EQ, ELLIPSIS,
+    COLON_COLON, ARROW, FAT_ARROW,
+    POUND, DOLLAR, QUESTION, TILDE, AT,
 
     // Special
     EOF_TOKEN,
     ILLEGAL
 };
 
+// Token::flags bits. A literal whose flags are clear is on the fast path:
+// its lexeme is already its value (decimal digits, or string contents).
+enum TokenFlag : uint8_t {
+    TOKEN_ESCAPES = 1,  // STRING / CHAR: the lexeme has escape sequences; decode with decodeString()
+    TOKEN_COMPLEX = 2,  // NUMBER / FLOAT: base prefix, '_', exponent or suffix; decode to get the value
+    TOKEN_RAW = 4,      // STRING: r"..." or r#"..."#; the lexeme is the contents, backslashes and all
+    TOKEN_BAD_UTF8 = 8, // any token: invalid UTF-8 in it or in the trivia just before it
+};
+
 struct Token {
     TokenType type;
     std::string lexeme;
     int line;
+    uint8_t flags = 0;  // TokenFlag bits
+    size_t offset = 0;  // byte offset of the token's first character in the source
+    size_t length = 0;  // bytes of source text covered (includes quotes for strings)
 };
 
 std::string tokenTypeToString(TokenType type);
@@ -11,12 +11,19 @@ TEST(Token, TypeToStringKeywords) {
     EXPECT_EQ(tokenTypeToString(TokenType::ELSE), "ELSE");
     EXPECT_EQ(tokenTypeToString(TokenType::WHILE), "WHILE");
     EXPECT_EQ(tokenTypeToString(TokenType::RETURN), "RETURN");
+    EXPECT_EQ(tokenTypeToString(TokenType::STRUCT), "STRUCT");
+    EXPECT_EQ(tokenTypeToString(TokenType::IMPL), "IMPL");
+    EXPECT_EQ(tokenTypeToString(TokenType::FOR), "FOR");
+    EXPECT_EQ(tokenTypeToString(TokenType::CONTINUE), "CONTINUE");
+    EXPECT_EQ(tokenTypeToString(TokenType::MATCH), "MATCH");
 }
 
 TEST(Token, TypeToStringLiterals) {
     EXPECT_EQ(tokenTypeToString(TokenType::IDENT), "IDENT");
     EXPECT_EQ(tokenTypeToString(TokenType::NUMBER), "NUMBER");
     EXPECT_EQ(tokenTypeToString(TokenType::STRING), "STRING");
+    EXPECT_EQ(tokenTypeToString(TokenType::FLOAT), "FLOAT");
+    EXPECT_EQ(tokenTypeToString(TokenType::CHAR), "CHAR");
 }
 
 TEST(Token, TypeToStringOperators) {
@@ -31,6 +38,12 @@ TEST(Token, TypeToStringOperators) {
     EXPECT_EQ(tokenTypeToString(TokenType::GT), "GT");
     EXPECT_EQ(tokenTypeToString(TokenType::LTE), "LTE");
     EXPECT_EQ(tokenTypeToString(TokenType::GTE), "GTE");
+    EXPECT_EQ(tokenTypeToString(TokenType::PERCENT), "PERCENT");
+    EXPECT_EQ(tokenTypeToString(TokenType::BANG), "BANG");
+    EXPECT_EQ(tokenTypeToString(TokenType::AND), "AND");
+    EXPECT_EQ(tokenTypeToString(TokenType::OR), "OR");
+    EXPECT_EQ(tokenTypeToString(TokenType::SHL_ASSIGN), "SHL_ASSIGN");
+    EXPECT_EQ(tokenTypeToString(TokenType::PIPE_ASSIGN), "PIPE_ASSIGN");
 }
 
 TEST(Token, TypeToStringPunctuation) {
@@ -41,6 +54,11 @@ TEST(Token, TypeToStringPunctuation) {
     EXPECT_EQ(tokenTypeToString(TokenType::SEMICOLON), "SEMICOLON");
     EXPECT_EQ(tokenTypeToString(TokenType::COLON), "COLON");
     EXPECT_EQ(tokenTypeToString(TokenType::COMMA), "COMMA");
+    EXPECT_EQ(tokenTypeToString(TokenType::LBRACKET), "LBRACKET");
+    EXPECT_EQ(tokenTypeToString(TokenType::DOT_DOT_EQ), "DOT_DOT_EQ");
+    EXPECT_EQ(tokenTypeToString(TokenType::COLON_COLON), "COLON_COLON");
+    EXPECT_EQ(tokenTypeToString(TokenType::FAT_ARROW), "FAT_ARROW");
+    EXPECT_EQ(tokenTypeToString(TokenType::AT), "AT");
 }
 
 TEST(Token, TypeToStringSpecial) {
@@ -58,6 +76,16 @@ TEST(Token, LookupKeywordFindsKeywords) {
     EXPECT_EQ(lookupKeyword("else"), TokenType::ELSE);
     EXPECT_EQ(lookupKeyword("while"), TokenType::WHILE);
     EXPECT_EQ(lookupKeyword("return"), TokenType::RETURN);
+    EXPECT_EQ(lookupKeyword("struct"), TokenType::STRUCT);
+    EXPECT_EQ(lookupKeyword("impl"), TokenType::IMPL);
+    EXPECT_EQ(lookupKeyword("loop"), TokenType::LOOP);
+    EXPECT_EQ(lookupKeyword("for"), TokenType::FOR);
+    EXPECT_EQ(lookupKeyword("in"), TokenType::IN);
+    EXPECT_EQ(lookupKeyword("break"), TokenType::BREAK);
+    EXPECT_EQ(lookupKeyword("continue"), TokenType::CONTINUE);
+    EXPECT_EQ(lookupKeyword("match"), TokenType::MATCH);
+    EXPECT_EQ(lookupKeyword("self"), TokenType::IDENT);  // an ordinary parameter name
+    EXPECT_EQ(lookupKeyword("_"), TokenType::IDENT);     // the wildcard pattern
 }
 
 TEST(Token, LookupKeywordReturnsIdentForNonKeywords) {
@@ -0,0 +1,73 @@
+#include "thread_pool.h"
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(workers_.size());
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    ready_.notify_one();
+}
+
+// Runs queued tasks until the pool is destroyed; remaining tasks are drained first.
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n,
+                             const std::function<void(size_t index, unsigned worker)>& fn) {
+    if (n == 0) return;
+
+    // One task per worker slot; each pulls indices from a shared counter so
+    // uneven items balance out.
+    unsigned tasks = size() < n ? size() : static_cast<unsigned>(n);
+    std::atomic<size_t> next{0};
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    unsigned remaining = tasks;
+
+    for (unsigned w = 0; w < tasks; ++w) {
+        submit([&, w] {
+            for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+                fn(i, w);
+            }
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) doneCv.notify_one();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&] { return remaining == 0; });
+}
@@ -0,0 +1,45 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// ThreadPool — fixed set of worker threads and a FIFO task queue
+// ============================================================
+class ThreadPool {
+public:
+    // `threads` = 0 uses std::thread::hardware_concurrency().
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const;
+
+    // Queues `task` to run on some worker. Tasks must not throw.
+    void submit(std::function<void()> task);
+
+    // Calls fn(index, worker) for every index in [0, n) and returns once all
+    // calls have finished. Indices are handed out one at a time in increasing
+    // order; `worker` is in [0, size()) and no two concurrent calls share one,
+    // so it can select per-thread state without locking.
+    void parallelFor(size_t n, const std::function<void(size_t index, unsigned worker)>& fn);
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stopping_ = false;
+
+    void workerLoop();
+};
+
+#endif // THREAD_POOL_H
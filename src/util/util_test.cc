@@ -0,0 +1,43 @@
+#include "thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+// ============================================================
+// ThreadPool
+// ============================================================
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> seen(10000);
+    pool.parallelFor(seen.size(), [&](size_t i, unsigned) { seen[i]++; });
+    for (const auto& s : seen) ASSERT_EQ(s.load(), 1);
+}
+
+TEST(ThreadPool, WorkerIdsAreExclusive) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> active(pool.size());
+    std::atomic<bool> overlap{false};
+    pool.parallelFor(2000, [&](size_t, unsigned w) {
+        ASSERT_LT(w, pool.size());
+        if (active[w]++ != 0) overlap = true;
+        active[w]--;
+    });
+    EXPECT_FALSE(overlap.load());
+}
+
+TEST(ThreadPool, EmptyRangeReturnsImmediately) {
+    ThreadPool pool(2);
+    bool called = false;
+    pool.parallelFor(0, [&](size_t, unsigned) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(ThreadPool, SubmittedTasksRunBeforeDestruction) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(3);
+        for (int i = 0; i < 100; ++i) pool.submit([&] { count++; });
+    }
+    EXPECT_EQ(count.load(), 100);
+}
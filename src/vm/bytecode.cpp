@@ -0,0 +1,349 @@
+#include "bytecode.h"
+#include <cstdio>
+
+// ============================================================
+// Opcodes
+// ============================================================
+
+const char* bcOpToString(BcOp op) {
+    switch (op) {
+        case BcOp::LOADI: return "loadi";
+        case BcOp::LOADK: return "loadk";
+        case BcOp::MOV:   return "mov";
+        case BcOp::ADD:   return "add";
+        case BcOp::SUB:   return "sub";
+        case BcOp::MUL:   return "mul";
+        case BcOp::DIV:   return "div";
+        case BcOp::NEG:   return "neg";
+        case BcOp::EQ:    return "eq";
+        case BcOp::NE:    return "ne";
+        case BcOp::LT:    return "lt";
+        case BcOp::GT:    return "gt";
+        case BcOp::LE:    return "le";
+        case BcOp::GE:    return "ge";
+        case BcOp::ARG:   return "arg";
+        case BcOp::CALL:  return "call";
+        case BcOp::JMP:   return "jmp";
+        case BcOp::BRT:   return "brt";
+        case BcOp::BRF:   return "brf";
+        case BcOp::BEQ:   return "beq";
+        case BcOp::BNE:   return "bne";
+        case BcOp::BLT:   return "blt";
+        case BcOp::BGT:   return "bgt";
+        case BcOp::BLE:   return "ble";
+        case BcOp::BGE:   return "bge";
+        case BcOp::SWITCH: return "switch";
+        case BcOp::RET:   return "ret";
+        case BcOp::RETU:  return "retu";
+    }
+    return "unknown";
+}
+
+unsigned bcLength(BcOp op) {
+    switch (op) {
+        case BcOp::JMP:
+        case BcOp::RET:
+        case BcOp::RETU:
+            return 1;
+        case BcOp::ADD: case BcOp::SUB: case BcOp::MUL: case BcOp::DIV:
+        case BcOp::EQ: case BcOp::NE: case BcOp::LT: case BcOp::GT: case BcOp::LE: case BcOp::GE:
+        case BcOp::BEQ: case BcOp::BNE: case BcOp::BLT: case BcOp::BGT: case BcOp::BLE: case BcOp::BGE:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+uint32_t BcModule::find(const std::string& name) const {
+    for (uint32_t i = 0; i < functions.size(); ++i) {
+        if (functions[i].name == name) return i;
+    }
+    return IR_NONE;
+}
+
+// Fused branch for a comparison opcode, and the one taken when the
+// comparison is false.
+static BcOp branchFor(Opcode cmp) {
+    switch (cmp) {
+        case Opcode::EQ: return BcOp::BEQ;
+        case Opcode::NE: return BcOp::BNE;
+        case Opcode::LT: return BcOp::BLT;
+        case Opcode::GT: return BcOp::BGT;
+        case Opcode::LE: return BcOp::BLE;
+        default:         return BcOp::BGE;
+    }
+}
+
+static BcOp invertedBranchFor(Opcode cmp) {
+    switch (cmp) {
+        case Opcode::EQ: return BcOp::BNE;
+        case Opcode::NE: return BcOp::BEQ;
+        case Opcode::LT: return BcOp::BGE;
+        case Opcode::GT: return BcOp::BLE;
+        case Opcode::LE: return BcOp::BGT;
+        default:         return BcOp::BLT;
+    }
+}
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+BytecodeCompiler::BytecodeCompiler(const IrModule& module) : module_(module) {}
+
+BcModule BytecodeCompiler::compile() {
+    BcModule out;
+    out.strings = module_.strings;
+    out.functions.resize(module_.functions.size());
+    for (size_t i = 0; i < module_.functions.size(); ++i) {
+        compileFunction(module_.functions[i], out.functions[i]);
+    }
+    return out;
+}
+
+bool BytecodeCompiler::hasErrors() const {
+    return !errors_.empty();
+}
+
+const std::vector<VmError>& BytecodeCompiler::errors() const {
+    return errors_;
+}
+
+// ============================================================
+// Functions
+// ============================================================
+//
+// Blocks keep their layout order, so a jump to the next block is dropped
+// and a BR falls through to whichever target comes next. A comparison
+// whose only use is the BR right after it is fused into the branch.
+
+void BytecodeCompiler::compileFunction(const IrFunction& fn, BcFunction& out) {
+    out.name = fn.name;
+    out.numParams = fn.numParams;
+    out.numRegs = fn.numValues;
+
+    std::vector<uint32_t> uses(fn.numValues, 0);
+    for (const Instr& in : fn.instrs) {
+        if (in.op == Opcode::PHI) {
+            errors_.push_back({"PHI in input; leave SSA form first", fn.name});
+            return;
+        }
+        switch (in.op) {
+            case Opcode::CONST: case Opcode::STR: case Opcode::CALL: case Opcode::JMP:
+                break;
+            case Opcode::COPY: case Opcode::NEG: case Opcode::ARG: case Opcode::BR:
+            case Opcode::SWITCH:
+                uses[in.src1]++;
+                break;
+            case Opcode::RET:
+                if (in.src1 != IR_NONE) uses[in.src1]++;
+                break;
+            default:
+                uses[in.src1]++;
+                uses[in.src2]++;
+                break;
+        }
+    }
+
+    std::vector<uint32_t>& code = out.code;
+    std::vector<uint32_t> blockPc(fn.blocks.size(), 0);
+    std::vector<std::pair<size_t, uint32_t>> fixups;  // code index, target block
+    std::vector<std::pair<size_t, uint32_t>> tableFixups;  // index into out.tables, block
+    uint32_t argSlot = 0;
+    uint32_t maxArgs = 0;
+
+    auto emitA = [&](BcOp op, uint32_t a) { code.push_back(bcWord(op, a)); };
+    auto target = [&](uint32_t block) {
+        fixups.push_back({code.size(), block});
+        code.push_back(0);
+    };
+
+    for (uint32_t b = 0; b < fn.blocks.size(); ++b) {
+        blockPc[b] = static_cast<uint32_t>(code.size());
+        const IrBlock& range = fn.blocks[b];
+        const Instr& term = fn.instrs[range.end - 1];
+        uint32_t next = b + 1;
+
+        // A comparison directly before the BR that reads it, and nothing else.
+        bool fused = false;
+        if (term.op == Opcode::BR && range.end - range.begin >= 2) {
+            const Instr& prev = fn.instrs[range.end - 2];
+            fused = isComparison(prev.op) && prev.dest == term.src1 && uses[prev.dest] == 1;
+        }
+        uint32_t bodyEnd = range.end - (fused ? 2 : 1);
+
+        for (uint32_t i = range.begin; i < bodyEnd; ++i) {
+            const Instr& in = fn.instrs[i];
+            switch (in.op) {
+                case Opcode::CONST: {
+                    int64_t v = in.imm();
+                    if (v >= INT32_MIN && v <= INT32_MAX) {
+                        emitA(BcOp::LOADI, in.dest);
+                        code.push_back(static_cast<uint32_t>(static_cast<int32_t>(v)));
+                    } else {
+                        emitA(BcOp::LOADK, in.dest);
+                        code.push_back(static_cast<uint32_t>(out.constants.size()));
+                        out.constants.push_back(v);
+                    }
+                    break;
+                }
+                case Opcode::STR:
+                    emitA(BcOp::LOADI, in.dest);
+                    code.push_back(in.src1);
+                    break;
+                case Opcode::COPY:
+                    if (in.dest == in.src1) break;
+                    emitA(BcOp::MOV, in.dest);
+                    code.push_back(in.src1);
+                    break;
+                case Opcode::NEG:
+                    emitA(BcOp::NEG, in.dest);
+                    code.push_back(in.src1);
+                    break;
+                case Opcode::ARG:
+                    emitA(BcOp::ARG, argSlot++);
+                    code.push_back(in.src1);
+                    break;
+                case Opcode::CALL:
+                    emitA(BcOp::CALL, in.dest);
+                    code.push_back(in.src1);
+                    if (argSlot > maxArgs) maxArgs = argSlot;
+                    argSlot = 0;
+                    break;
+                default: {
+                    // ADD .. GE share their order with BcOp.
+                    auto op = static_cast<BcOp>(static_cast<unsigned>(BcOp::ADD) +
+                                                static_cast<unsigned>(in.op) -
+                                                static_cast<unsigned>(Opcode::ADD));
+                    emitA(op, in.dest);
+                    code.push_back(in.src1);
+                    code.push_back(in.src2);
+                    break;
+                }
+            }
+        }
+
+        switch (term.op) {
+            case Opcode::JMP:
+                if (term.src1 != next) {
+                    fixups.push_back({code.size(), term.src1});
+                    code.push_back(static_cast<uint32_t>(BcOp::JMP));
+                }
+                break;
+            case Opcode::BR: {
+                uint32_t thenBlock = term.src2, elseBlock = term.dest;
+                bool invert = thenBlock == next;
+                if (fused) {
+                    const Instr& cmp = fn.instrs[range.end - 2];
+                    emitA(invert ? invertedBranchFor(cmp.op) : branchFor(cmp.op), cmp.src1);
+                    code.push_back(cmp.src2);
+                } else {
+                    emitA(invert ? BcOp::BRF : BcOp::BRT, term.src1);
+                }
+                target(invert ? elseBlock : thenBlock);
+                if (!invert && elseBlock != next) {
+                    fixups.push_back({code.size(), elseBlock});
+                    code.push_back(static_cast<uint32_t>(BcOp::JMP));
+                }
+                break;
+            }
+            case Opcode::SWITCH:
+                emitA(BcOp::SWITCH, term.src1);
+                code.push_back(static_cast<uint32_t>(out.tables.size()));
+                out.tables.push_back(term.dest);
+                for (uint32_t k = 0; k <= term.dest; ++k) {
+                    tableFixups.push_back({out.tables.size(), fn.switchTargets[term.src2 + k]});
+                    out.tables.push_back(0);
+                }
+                break;
+            default:
+                if (term.src1 == IR_NONE) emitA(BcOp::RETU, 0);
+                else emitA(BcOp::RET, term.src1);
+                break;
+        }
+    }
+
+    out.frameSize = out.numRegs + maxArgs;
+    if (out.frameSize > BC_MAX_A || code.size() > BC_MAX_A) {
+        errors_.push_back({"function too large for bytecode operands", fn.name});
+        return;
+    }
+
+    // A JMP carries its target in operand A; every other branch in its own word.
+    for (const auto& fix : fixups) {
+        uint32_t pc = blockPc[fix.second];
+        if (code[fix.first] == static_cast<uint32_t>(BcOp::JMP)) code[fix.first] = bcWord(BcOp::JMP, pc);
+        else code[fix.first] = pc;
+    }
+    for (const auto& fix : tableFixups) out.tables[fix.first] = blockPc[fix.second];
+}
+
+// ============================================================
+// Disassembly
+// ============================================================
+
+std::string disassemble(const BcModule& module) {
+    std::string out;
+    char line[96];
+    for (const BcFunction& fn : module.functions) {
+        out += "fn " + fn.name + " (params " + std::to_string(fn.numParams) + ", registers " +
+               std::to_string(fn.numRegs) + "):\n";
+        for (size_t pc = 0; pc < fn.code.size();) {
+            BcOp op = static_cast<BcOp>(fn.code[pc] & 0xFF);
+            uint32_t a = fn.code[pc] >> 8;
+            const uint32_t* w = &fn.code[pc];
+            switch (op) {
+                case BcOp::LOADI:
+                    std::snprintf(line, sizeof(line), "r%u, %d", a, static_cast<int32_t>(w[1]));
+                    break;
+                case BcOp::LOADK:
+                    std::snprintf(line, sizeof(line), "r%u, %lld", a,
+                                  static_cast<long long>(fn.constants[w[1]]));
+                    break;
+                case BcOp::MOV: case BcOp::NEG:
+                    std::snprintf(line, sizeof(line), "r%u, r%u", a, w[1]);
+                    break;
+                case BcOp::ARG:
+                    std::snprintf(line, sizeof(line), "%u, r%u", a, w[1]);
+                    break;
+                case BcOp::CALL:
+                    std::snprintf(line, sizeof(line), "r%u, %s", a, module.functions[w[1]].name.c_str());
+                    break;
+                case BcOp::JMP:
+                    std::snprintf(line, sizeof(line), "%u", a);
+                    break;
+                case BcOp::BRT: case BcOp::BRF:
+                    std::snprintf(line, sizeof(line), "r%u, %u", a, w[1]);
+                    break;
+                case BcOp::BEQ: case BcOp::BNE: case BcOp::BLT:
+                case BcOp::BGT: case BcOp::BLE: case BcOp::BGE:
+                    std::snprintf(line, sizeof(line), "r%u, r%u, %u", a, w[1], w[2]);
+                    break;
+                case BcOp::SWITCH: {
+                    uint32_t n = fn.tables[w[1]];
+                    std::snprintf(line, sizeof(line), "r%u, %u entries, else %u", a, n,
+                                  fn.tables[w[1] + 1 + n]);
+                    break;
+                }
+                case BcOp::RET:
+                    std::snprintf(line, sizeof(line), "r%u", a);
+                    break;
+                case BcOp::RETU:
+                    line[0] = '\0';
+                    break;
+                default:
+                    std::snprintf(line, sizeof(line), "r%u, r%u, r%u", a, w[1], w[2]);
+                    break;
+            }
+            char prefix[32];
+            std::snprintf(prefix, sizeof(prefix), "%6zu  %-6s", pc, bcOpToString(op));
+            out += prefix;
+            if (line[0]) out += std::string(" ") + line;
+            // Trim the padding of operand-less instructions.
+            while (!out.empty() && out.back() == ' ') out.pop_back();
+            out += "\n";
+            pc += bcLength(op);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,132 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "../codegen/ir.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// BcOp — bytecode opcodes
+// ============================================================
+//
+// Code is a stream of 32-bit words. The first word of an instruction holds
+// the opcode in its low 8 bits and operand A in the upper 24; operands B
+// and C, when present, follow as whole words. Registers are frame-relative
+// (one per IR value), branch targets are word offsets into the function.
+//
+//   LOADI  A = int32 B                      2 words
+//   LOADK  A = constants[B]                 2 words
+//   MOV    A = B                            2 words
+//   ADD .. DIV, EQ .. GE   A = B <op> C     3 words
+//   NEG    A = -B                           2 words
+//   ARG    argument slot A of the next CALL = B      2 words
+//   CALL   A = functions[B](<arguments>)    2 words
+//   JMP    goto A                           1 word
+//   BRT    if A != 0 goto B                 2 words
+//   BRF    if A == 0 goto B                 2 words
+//   BEQ .. BGE   if A <cmp> B goto C        3 words (compare fused with branch)
+//   SWITCH goto tables[B + 1 + min(A, n)], n = tables[B] (A unsigned)   2 words
+//   RET    return A                         1 word
+//   RETU   return unit                      1 word
+enum class BcOp : uint8_t {
+    LOADI,
+    LOADK,
+    MOV,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    NEG,
+    EQ,
+    NE,
+    LT,
+    GT,
+    LE,
+    GE,
+    ARG,
+    CALL,
+    JMP,
+    BRT,
+    BRF,
+    BEQ,
+    BNE,
+    BLT,
+    BGT,
+    BLE,
+    BGE,
+    SWITCH,
+    RET,
+    RETU,
+};
+
+static constexpr unsigned BC_OP_COUNT = static_cast<unsigned>(BcOp::RETU) + 1;
+
+// Largest value operand A can hold.
+static constexpr uint32_t BC_MAX_A = (1u << 24) - 1;
+
+const char* bcOpToString(BcOp op);
+
+// Number of words an instruction with this opcode occupies.
+unsigned bcLength(BcOp op);
+
+inline uint32_t bcWord(BcOp op, uint32_t a) {
+    return static_cast<uint32_t>(op) | (a << 8);
+}
+
+// ============================================================
+// BcFunction / BcModule
+// ============================================================
+//
+// A call's arguments are written straight into the registers just past
+// the caller's (`numRegs` onwards), which become the callee's parameters.
+// `frameSize` covers the registers plus the widest call's argument slots.
+struct BcFunction {
+    std::string name;
+    uint32_t numParams = 0;
+    uint32_t numRegs = 0;
+    uint32_t frameSize = 0;
+    std::vector<uint32_t> code;
+    std::vector<int64_t> constants;  // LOADK operands that do not fit in 32 bits
+    std::vector<uint32_t> tables;    // SWITCH tables: n, then n targets and the default
+};
+
+struct BcModule {
+    std::vector<BcFunction> functions;
+    std::vector<std::string> strings;  // a string value is its index here
+
+    // Index of the function called `name`, or IR_NONE.
+    uint32_t find(const std::string& name) const;
+};
+
+// ============================================================
+// VmError — compile-time or run-time failure, tagged with its function
+// ============================================================
+struct VmError {
+    std::string message;
+    std::string function;
+};
+
+// ============================================================
+// BytecodeCompiler — IR (not in SSA form) to bytecode
+// ============================================================
+class BytecodeCompiler {
+public:
+    explicit BytecodeCompiler(const IrModule& module);
+
+    BcModule compile();
+
+    bool hasErrors() const;
+    const std::vector<VmError>& errors() const;
+
+private:
+    const IrModule& module_;
+    std::vector<VmError> errors_;
+
+    void compileFunction(const IrFunction& fn, BcFunction& out);
+};
+
+// Prints every function's code, one instruction per line with its offset.
+std::string disassemble(const BcModule& module);
+
+#endif // BYTECODE_H
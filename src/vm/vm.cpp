@@ -0,0 +1,249 @@
+#include "vm.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(VM_USE_SWITCH)
+#define VM_COMPUTED_GOTO 1
+#else
+#define VM_COMPUTED_GOTO 0
+#endif
+
+// ============================================================
+// Construction / public API
+// ============================================================
+
+Vm::Vm(const BcModule& module, size_t stackRegisters, size_t maxDepth)
+    : module_(module), stack_(stackRegisters), maxDepth_(maxDepth) {}
+
+bool Vm::call(uint32_t fn, const std::vector<int64_t>& args, int64_t& result) {
+    errors_.clear();
+    frames_.clear();
+    if (fn >= module_.functions.size()) {
+        errors_.push_back({"no such function", ""});
+        return false;
+    }
+    const BcFunction& callee = module_.functions[fn];
+    if (args.size() != callee.numParams) {
+        errors_.push_back({"expected " + std::to_string(callee.numParams) + " argument(s), got " +
+                               std::to_string(args.size()),
+                           callee.name});
+        return false;
+    }
+    if (callee.frameSize > stack_.size()) {
+        errors_.push_back({"stack overflow", callee.name});
+        return false;
+    }
+    for (size_t i = 0; i < args.size(); ++i) stack_[i] = args[i];
+    return execute(&callee, stack_.data(), result);
+}
+
+void Vm::setFuel(uint64_t fuel) {
+    fuel_ = fuel;
+}
+
+bool Vm::hasErrors() const {
+    return !errors_.empty();
+}
+
+const std::vector<VmError>& Vm::errors() const {
+    return errors_;
+}
+
+// ============================================================
+// Interpreter loop
+// ============================================================
+//
+// `pc` points at the current instruction's first word and `r` at the
+// current frame's registers. Each handler advances pc by its length and
+// dispatches the next instruction itself, so with computed goto every
+// handler ends in its own indirect jump.
+
+#define OPA (pc[0] >> 8)
+#define RA r[pc[0] >> 8]
+#define RB r[pc[1]]
+#define RC r[pc[2]]
+
+#if VM_COMPUTED_GOTO
+#define VM_CASE(name) L_##name:
+#define VM_NEXT() goto *labels[pc[0] & 0xFF]
+#else
+#define VM_CASE(name) case BcOp::name:
+#define VM_NEXT() goto dispatch
+#endif
+
+#define VM_BINARY(name, expr)          \
+    VM_CASE(name) {                    \
+        uint64_t x = static_cast<uint64_t>(RB), y = static_cast<uint64_t>(RC); \
+        RA = static_cast<int64_t>(expr); \
+        pc += 3;                       \
+        VM_NEXT();                     \
+    }
+
+#define VM_COMPARE(name, op)           \
+    VM_CASE(name) {                    \
+        RA = RB op RC;                 \
+        pc += 3;                       \
+        VM_NEXT();                     \
+    }
+
+// Every control transfer burns one unit of fuel; straight-line code
+// cannot run long without one.
+#define VM_SPEND()                     \
+    if (fuel-- == 0) goto out_of_fuel
+
+#define VM_BRANCH(name, op)            \
+    VM_CASE(name) {                    \
+        VM_SPEND();                    \
+        pc = RA op RB ? code + pc[2] : pc + 3; \
+        VM_NEXT();                     \
+    }
+
+bool Vm::execute(const BcFunction* fn, int64_t* base, int64_t& result) {
+    const int64_t* stackEnd = stack_.data() + stack_.size();
+    const uint32_t* code = fn->code.data();
+    const uint32_t* pc = code;
+    int64_t* r = base;
+    int64_t value = 0;
+    uint64_t fuel = fuel_ ? fuel_ : UINT64_MAX;
+
+#if VM_COMPUTED_GOTO
+    // Same order as BcOp.
+    static void* const labels[] = {
+        &&L_LOADI, &&L_LOADK, &&L_MOV, &&L_ADD, &&L_SUB, &&L_MUL, &&L_DIV,
+        &&L_NEG,   &&L_EQ,    &&L_NE,  &&L_LT,  &&L_GT,  &&L_LE,  &&L_GE,
+        &&L_ARG,   &&L_CALL,  &&L_JMP, &&L_BRT, &&L_BRF, &&L_BEQ, &&L_BNE,
+        &&L_BLT,   &&L_BGT,   &&L_BLE, &&L_BGE, &&L_SWITCH, &&L_RET, &&L_RETU,
+    };
+    static_assert(sizeof(labels) / sizeof(labels[0]) == BC_OP_COUNT, "one label per BcOp");
+    VM_NEXT();
+#else
+dispatch:
+    switch (static_cast<BcOp>(pc[0] & 0xFF)) {
+#endif
+
+    VM_CASE(LOADI) {
+        RA = static_cast<int32_t>(pc[1]);
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_CASE(LOADK) {
+        RA = fn->constants[pc[1]];
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_CASE(MOV) {
+        RA = RB;
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_BINARY(ADD, x + y)
+    VM_BINARY(SUB, x - y)
+    VM_BINARY(MUL, x * y)
+    VM_CASE(DIV) {
+        int64_t y = RC;
+        if (y == 0) {
+            errors_.push_back({"division by zero", fn->name});
+            return false;
+        }
+        // INT64_MIN / -1 wraps like the other operators.
+        RA = y == -1 ? static_cast<int64_t>(0 - static_cast<uint64_t>(RB)) : RB / y;
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(NEG) {
+        RA = static_cast<int64_t>(0 - static_cast<uint64_t>(RB));
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_COMPARE(EQ, ==)
+    VM_COMPARE(NE, !=)
+    VM_COMPARE(LT, <)
+    VM_COMPARE(GT, >)
+    VM_COMPARE(LE, <=)
+    VM_COMPARE(GE, >=)
+    VM_CASE(ARG) {
+        // Slot A of the callee's frame, which starts right after ours.
+        r[fn->numRegs + OPA] = RB;
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_CASE(CALL) {
+        VM_SPEND();
+        const BcFunction* callee = &module_.functions[pc[1]];
+        int64_t* calleeBase = r + fn->numRegs;
+        if (frames_.size() >= maxDepth_ || calleeBase + callee->frameSize > stackEnd) {
+            errors_.push_back({"stack overflow", callee->name});
+            return false;
+        }
+        frames_.push_back(Frame{fn, pc + 2, r, OPA});
+        fn = callee;
+        code = fn->code.data();
+        pc = code;
+        r = calleeBase;
+        VM_NEXT();
+    }
+    VM_CASE(JMP) {
+        VM_SPEND();
+        pc = code + OPA;
+        VM_NEXT();
+    }
+    VM_CASE(BRT) {
+        VM_SPEND();
+        pc = RA != 0 ? code + pc[1] : pc + 2;
+        VM_NEXT();
+    }
+    VM_CASE(BRF) {
+        VM_SPEND();
+        pc = RA == 0 ? code + pc[1] : pc + 2;
+        VM_NEXT();
+    }
+    VM_BRANCH(BEQ, ==)
+    VM_BRANCH(BNE, !=)
+    VM_BRANCH(BLT, <)
+    VM_BRANCH(BGT, >)
+    VM_BRANCH(BLE, <=)
+    VM_BRANCH(BGE, >=)
+    VM_CASE(SWITCH) {
+        VM_SPEND();
+        const uint32_t* table = fn->tables.data() + pc[1];
+        uint64_t index = static_cast<uint64_t>(RA);
+        pc = code + table[1 + (index < table[0] ? index : table[0])];
+        VM_NEXT();
+    }
+    VM_CASE(RET) {
+        value = RA;
+        goto do_return;
+    }
+    VM_CASE(RETU) {
+        value = 0;
+        goto do_return;
+    }
+
+#if !VM_COMPUTED_GOTO
+    }
+#endif
+
+do_return:
+    if (frames_.empty()) {
+        result = value;
+        return true;
+    }
+    {
+        Frame frame = frames_.back();
+        frames_.pop_back();
+        fn = frame.fn;
+        code = fn->code.data();
+        pc = frame.returnPc;
+        r = frame.base;
+        r[frame.dest] = value;
+    }
+    VM_NEXT();
+
+out_of_fuel:
+    errors_.push_back({"out of fuel after " + std::to_string(fuel_) + " jump(s) and call(s)",
+                       fn->name});
+    return false;
+}
+
+#undef OPA
+#undef RA
+#undef RB
+#undef RC
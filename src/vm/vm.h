@@ -0,0 +1,58 @@
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// Vm — register machine over a BcModule
+// ============================================================
+//
+// Integers are i64 and wrap; booleans are 0 / 1, unit is 0, a string is its
+// index in the module's pool. Calls do not recurse on the native stack:
+// frames live in one register array, each starting where its caller's
+// registers end. Division by zero, running out of registers or frames and
+// running out of fuel (see setFuel()) stop execution with an error.
+//
+// Dispatch uses computed goto where the compiler supports it (GCC, Clang);
+// define VM_USE_SWITCH to force the portable switch loop.
+class Vm {
+public:
+    static constexpr size_t DEFAULT_STACK_REGISTERS = 1u << 20;
+    static constexpr size_t DEFAULT_MAX_DEPTH = 100000;
+
+    explicit Vm(const BcModule& module, size_t stackRegisters = DEFAULT_STACK_REGISTERS,
+                size_t maxDepth = DEFAULT_MAX_DEPTH);
+
+    // Runs functions[fn] with `args` (one per parameter). Returns false, with
+    // the reason in errors(), if execution failed.
+    bool call(uint32_t fn, const std::vector<int64_t>& args, int64_t& result);
+
+    // Lets each call() execute at most `fuel` jumps, branches, switches and
+    // calls, which bounds every loop and recursion; 0 (the default) = no limit.
+    void setFuel(uint64_t fuel);
+
+    bool hasErrors() const;
+    const std::vector<VmError>& errors() const;
+
+private:
+    struct Frame {
+        const BcFunction* fn;
+        const uint32_t* returnPc;
+        int64_t* base;
+        uint32_t dest;  // caller register receiving the result
+    };
+
+    const BcModule& module_;
+    std::vector<int64_t> stack_;
+    std::vector<Frame> frames_;
+    size_t maxDepth_;
+    uint64_t fuel_ = 0;
+    std::vector<VmError> errors_;
+
+    bool execute(const BcFunction* fn, int64_t* base, int64_t& result);
+};
+
+#endif // VM_H
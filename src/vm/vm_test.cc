@@ -0,0 +1,277 @@
+#include "bytecode.h"
+#include "vm.h"
+#include "../codegen/codegen.h"
+#include "../codegen/ssa.h"
+#include "../parser/parser.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static IrModule lowerSource(const std::string& src, bool optimize) {
+    Parser parser(src);
+    auto prog = parser.parseProgram();
+    EXPECT_FALSE(parser.hasErrors()) << "Unexpected parse error in: " << src;
+    CodeGen gen(prog.get());
+    IrModule module = gen.lower();
+    EXPECT_FALSE(gen.hasErrors());
+    if (optimize) {
+        IrOptStats stats;
+        optimizeModule(module, stats);
+    }
+    return module;
+}
+
+static BcModule compileSource(const std::string& src, bool optimize = false) {
+    IrModule ir = lowerSource(src, optimize);
+    BytecodeCompiler compiler(ir);
+    BcModule module = compiler.compile();
+    EXPECT_FALSE(compiler.hasErrors());
+    return module;
+}
+
+// Runs main() with and without the IR optimizations; both must agree.
+static int64_t runMain(const std::string& src) {
+    int64_t results[2] = {0, 0};
+    for (bool optimize : {false, true}) {
+        BcModule module = compileSource(src, optimize);
+        Vm vm(module);
+        EXPECT_TRUE(vm.call(module.find("main"), {}, results[optimize]))
+            << (vm.hasErrors() ? vm.errors()[0].message : "");
+    }
+    EXPECT_EQ(results[0], results[1]) << "optimized IR disagrees";
+    return results[0];
+}
+
+// ============================================================
+// Statements and expressions
+// ============================================================
+
+TEST(Vm, LetAndArithmetic) {
+    EXPECT_EQ(runMain("fn main() { let x = 6; let y = x * 7; return y - 2 / 2 + -x; }"), 35);
+}
+
+TEST(Vm, AssignmentAndWhile) {
+    EXPECT_EQ(runMain(R"(
+fn main() {
+    let mut i = 0;
+    let mut sum = 0;
+    while i < 100 { sum = sum + i; i = i + 1; }
+    return sum;
+}
+)"), 4950);
+}
+
+TEST(Vm, IfElseChains) {
+    std::string src = R"(
+fn sign(x: i64) {
+    if x < 0 { return -1; } else if x == 0 { return 0; } else { return 1; }
+}
+fn main() { return sign(-5) * 100 + sign(0) * 10 + sign(7); }
+)";
+    EXPECT_EQ(runMain(src), -99);
+}
+
+TEST(Vm, ComparisonsAreZeroOrOne) {
+    EXPECT_EQ(runMain("fn main() { let a = 3 < 4; let b = 5 == 6; return a * 10 + b; }"), 10);
+    EXPECT_EQ(runMain("fn main() { if true { return 2; } return 3; }"), 2);
+}
+
+TEST(Vm, MissingReturnYieldsUnit) {
+    EXPECT_EQ(runMain("fn g() { let x = 1; } fn main() { g(); return 5; }"), 5);
+    BcModule m = compileSource("fn main() { }");
+    Vm vm(m);
+    int64_t result = -1;
+    ASSERT_TRUE(vm.call(0, {}, result));
+    EXPECT_EQ(result, 0);
+}
+
+TEST(Vm, TailValuesIfAndMatch) {
+    EXPECT_EQ(runMain(R"(
+fn grade(x: i64) -> i64 {
+    match x / 10 { 10 | 9 => 4, 8 => 3, 7 => 2, 6 => 1, -1000 => { -1 } _ => 0 }
+}
+fn main() -> i64 {
+    let mut s = 0;
+    for x in 55..101 { s = s + grade(x); }
+    let bonus = if s > 100 { s - 100 } else { 0 };
+    s * 1000 + bonus + grade(-10000)
+}
+)"), 104 * 1000 + 4 - 1);
+}
+
+TEST(Vm, DenseMatchDispatchesThroughATable) {
+    BcModule m = compileSource("fn f(x: i64) -> i64 { match x { 3 => 1, 4 | 5 => 2, 6 => 3, "
+                               "8 => 4, _ => 0 } } fn main() { }");
+    const BcFunction& f = m.functions[0];
+    ASSERT_EQ(f.tables.size(), 1u + 6 + 1);  // count, 3 ..= 8, default
+    EXPECT_NE(disassemble(m).find("switch"), std::string::npos);
+    EXPECT_EQ(runMain(R"(
+fn f(x: i64) -> i64 { match x { 3 => 1, 4 | 5 => 2, 6 => 3, 8 => 4, _ => 0 } }
+fn main() -> i64 {
+    let mut s = 0;
+    for x in 0..11 { s = s * 10 + f(x); }
+    s * 10 + f(-9223372036854775807 - 1)
+}
+)"), INT64_C(12230400) * 10);
+}
+
+TEST(Vm, ArithmeticWrapsAtSixtyFourBits) {
+    EXPECT_EQ(runMain("fn main() { let big = 9223372036854775807; return big + 1; }"), INT64_MIN);
+    EXPECT_EQ(runMain("fn f(a: i64, b: i64) { return a / b; } "
+                      "fn main() { return f(-9223372036854775807 - 1, -1); }"),
+              INT64_MIN);
+}
+
+// ============================================================
+// Calls
+// ============================================================
+
+TEST(Vm, ArgumentsBecomeCalleeParameters) {
+    EXPECT_EQ(runMain("fn sub(a: i64, b: i64) { return a - b; } "
+                      "fn main() { return sub(10, 3) * sub(sub(9, 1), 2); }"),
+              42);
+}
+
+TEST(Vm, Recursion) {
+    EXPECT_EQ(runMain(R"(
+fn fib(n: i64) {
+    if n < 2 { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+fn main() { return fib(20); }
+)"), 6765);
+}
+
+TEST(Vm, DeepRecursionStaysOffTheNativeStack) {
+    EXPECT_EQ(runMain(R"(
+fn down(n: i64) {
+    if n == 0 { return 0; }
+    return down(n - 1) + 1;
+}
+fn main() { return down(50000); }
+)"), 50000);
+}
+
+TEST(Vm, CallWithArguments) {
+    BcModule m = compileSource("fn add3(a: i64, b: i64, c: i64) { return a * 100 + b * 10 + c; }");
+    Vm vm(m);
+    int64_t result = 0;
+    ASSERT_TRUE(vm.call(m.find("add3"), {1, 2, 3}, result));
+    EXPECT_EQ(result, 123);
+    EXPECT_FALSE(vm.call(m.find("add3"), {1}, result));
+    EXPECT_EQ(m.find("missing"), IR_NONE);
+}
+
+// ============================================================
+// Runtime errors
+// ============================================================
+
+TEST(Vm, DivisionByZeroStopsExecution) {
+    BcModule m = compileSource("fn div(a: i64, b: i64) { return a / b; } fn main() { return div(1, 0); }");
+    Vm vm(m);
+    int64_t result = 0;
+    EXPECT_FALSE(vm.call(m.find("main"), {}, result));
+    ASSERT_EQ(vm.errors().size(), 1u);
+    EXPECT_EQ(vm.errors()[0].message, "division by zero");
+    EXPECT_EQ(vm.errors()[0].function, "div");
+}
+
+TEST(Vm, RunawayRecursionOverflows) {
+    BcModule m = compileSource("fn f(n: i64) { return f(n + 1); } fn main() { return f(0); }");
+    Vm vm(m, 4096);
+    int64_t result = 0;
+    EXPECT_FALSE(vm.call(m.find("main"), {}, result));
+    ASSERT_EQ(vm.errors().size(), 1u);
+    EXPECT_EQ(vm.errors()[0].message, "stack overflow");
+
+    // The VM is reusable after an error.
+    BcModule ok = compileSource("fn main() { return 1; }");
+    Vm again(ok, 4096);
+    EXPECT_TRUE(again.call(0, {}, result));
+}
+
+TEST(Vm, FuelBoundsLoopsAndRecursion) {
+    BcModule spin = compileSource("fn main() { loop { } }");
+    Vm vm(spin);
+    vm.setFuel(1000);
+    int64_t result = 0;
+    EXPECT_FALSE(vm.call(spin.find("main"), {}, result));
+    ASSERT_EQ(vm.errors().size(), 1u);
+    EXPECT_EQ(vm.errors()[0].message, "out of fuel after 1000 jump(s) and call(s)");
+    EXPECT_EQ(vm.errors()[0].function, "main");
+
+    BcModule deep = compileSource(
+        "fn f(n: i64) { if n == 0 { return 0; } return f(n - 1); } "
+        "fn main() { return f(5000); }");
+    Vm limited(deep);
+    limited.setFuel(1000);
+    EXPECT_FALSE(limited.call(deep.find("main"), {}, result));
+    EXPECT_EQ(limited.errors()[0].function, "f");
+
+    // Enough fuel runs to completion, every call afresh.
+    limited.setFuel(100000);
+    EXPECT_TRUE(limited.call(deep.find("main"), {}, result));
+    EXPECT_TRUE(limited.call(deep.find("main"), {}, result));
+    EXPECT_EQ(result, 0);
+}
+
+// ============================================================
+// Encoding
+// ============================================================
+
+TEST(Bytecode, ComparisonFusesWithBranch) {
+    BcModule m = compileSource("fn f(n: i64) { let mut i = 0; while i < n { i = i + 1; } return i; }", true);
+    std::string text = disassemble(m);
+    // The loop test falls through into the body, so it branches out on >=.
+    EXPECT_NE(text.find("bge"), std::string::npos) << text;
+    EXPECT_EQ(text.find(" lt "), std::string::npos) << text;
+}
+
+TEST(Bytecode, ComparisonUsedTwiceIsNotFused) {
+    BcModule m = compileSource("fn f(a: i64) { let c = a < 3; if c { return c; } return 7; }");
+    std::string text = disassemble(m);
+    EXPECT_NE(text.find(" lt "), std::string::npos) << text;
+    EXPECT_NE(text.find("brf"), std::string::npos) << text;
+}
+
+TEST(Bytecode, WideConstantsGoToThePool) {
+    BcModule m = compileSource("fn main() { return 4294967296 + 7; }");
+    ASSERT_EQ(m.functions[0].constants.size(), 1u);
+    EXPECT_EQ(m.functions[0].constants[0], 4294967296LL);
+}
+
+TEST(Bytecode, SmallerThanTheIr) {
+    std::string src = R"(
+fn gcd(a: i64, b: i64) {
+    let mut x = a;
+    let mut y = b;
+    while y != 0 { let t = y; y = x - x / y * y; x = t; }
+    return x;
+}
+fn main() { return gcd(1071, 462); }
+)";
+    IrModule ir = lowerSource(src, true);
+    size_t irBytes = 0;
+    for (const IrFunction& fn : ir.functions) irBytes += fn.instrs.size() * sizeof(Instr);
+    BytecodeCompiler compiler(ir);
+    BcModule m = compiler.compile();
+    size_t bcBytes = 0;
+    for (const BcFunction& fn : m.functions) bcBytes += fn.code.size() * sizeof(uint32_t);
+    EXPECT_LT(bcBytes * 2, irBytes);
+    Vm vm(m);
+    int64_t result = 0;
+    ASSERT_TRUE(vm.call(m.find("main"), {}, result));
+    EXPECT_EQ(result, 21);
+}
+
+TEST(Bytecode, SsaFormIsRejected) {
+    IrModule ir = lowerSource("fn f(n: i64) { let mut i = 0; while i < n { i = i + 1; } return i; }", false);
+    buildSsa(ir.functions[0]);
+    BytecodeCompiler compiler(ir);
+    compiler.compile();
+    ASSERT_TRUE(compiler.hasErrors());
+    EXPECT_EQ(compiler.errors()[0].function, "f");
+}
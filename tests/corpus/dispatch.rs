@@ -0,0 +1,40 @@
+// Opcode dispatch: a pseudo-random instruction stream run through a dense
+// match, with a sparse match classifying each step.
+fn step(op: i64, acc: i64) -> i64 {
+    match op {
+        0 => acc + 1,
+        1 => acc - 3,
+        2 => acc * 3,
+        3 => acc / 2,
+        4 | 5 => acc + op,
+        6 => if acc > 1000 { acc - 1000 } else { acc },
+        _ => -acc,
+    }
+}
+
+fn bucket(x: i64) -> i64 {
+    match x {
+        -300 => 1,
+        -100 | 100 => 2,
+        0 => 3,
+        400 => 4,
+        100000 => 5,
+        _ => 0,
+    }
+}
+
+fn main() {
+    let mut seed = 7;
+    let mut acc = 1;
+    let mut hits = 0;
+    let mut i = 0;
+    while i < 200000 {
+        let next = seed * 75 + 74;
+        seed = next - next / 65537 * 65537;
+        let op = seed - seed / 8 * 8;
+        acc = step(op, acc);
+        hits = hits + bucket((op - 3) * 100);
+        i = i + 1;
+    }
+    return hits * 1000000 + acc - acc / 1000000 * 1000000;
+}
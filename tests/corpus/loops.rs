@@ -0,0 +1,28 @@
+// Nested loops with redundant temporaries and reassignments.
+fn weight(i: i64, j: i64) {
+    let a = i * 3;
+    let b = a + 0;
+    let c = b;
+    let unused = c * j;
+    if c > j {
+        return c - j;
+    }
+    return j - c;
+}
+
+fn main() {
+    let mut sum = 0;
+    let mut i = 0;
+    while i < 200 {
+        let mut j = 0;
+        let mut row = 0;
+        while j < 200 {
+            let w = weight(i, j);
+            row = row + w;
+            j = j + 1;
+        }
+        sum = sum + row / 200;
+        i = i + 1;
+    }
+    return sum;
+}